@@ -47,6 +47,8 @@
  *		pbsnodes [-s server] -[F format]-v vnode vnode ...
  *		pbsnodes [-s server] -[F format]-H host host...
  *		pbsnodes [-s server] -[C comment]{o|r} host host ...
+ *		pbsnodes [-s server] -[C comment]{o|r} -E expr [-E expr ...] [host ...]
+ *		pbsnodes [-s server] -t[F format] [partition ...]
  *		pbsnodes [-s server] -a[v][F format]
  *		pbsnodes [-s server] -a[v][S[j][L]][F format]
  *		pbsnodes [-s server] -[S[j][L]][F format][H] host host ...
@@ -84,6 +86,11 @@
  *
  *	pbsnodes -r host1 host2		clear OFF_LINE from listed hosts
  *
+ *	pbsnodes -o -E expr		mark vnodes matching expr OFF_LINE
+ *
+ *	pbsnodes -t [partition...]	vnode counts by state and resource totals
+ *					of each partition, computed by the server
+ *
  *	pbsnodes -S host1 host2 ...	single line Node summary of specified nodes
  *	pbsnodes -Sj			single line Jobs summary of specified nodes
  *	pbsnodes -S[j]L			list expanded version of each field in the single line summary
@@ -129,7 +136,8 @@ typedef enum mgr_operation {
 	UPDATE_COMMENT, /* add comment to nodes */
 	ALL, /* List all nodes */
 	LISTSP, /* List specified nodes */
-	LISTSPNV /* List specified nodes and their associated vnodes*/
+	LISTSPNV, /* List specified nodes and their associated vnodes*/
+	TOTALS /* Summarize the vnodes of each partition */
 }mgr_operation_t;
 
 enum output_format_enum {
@@ -206,13 +214,15 @@ encode_to_json(struct batch_status *bstat)
 	if (add_json_node(JSON_OBJECT, JSON_NULL, JSON_NOVALUE, bstat->name, NULL) == NULL)
 		return 1;
 	for (pattr = bstat->attribs; pattr; pattr = pattr->next) {
-		if (strcmp(pattr->name, "resources_available") == 0) {
+		if ((strcmp(pattr->name, "resources_available") == 0) ||
+			(pattr->resource && strcmp(pattr->name, ATTR_NODE_state) == 0)) {
+			/* the state counts of a partition summary are listed alike */
 			if (add_json_node(JSON_OBJECT, JSON_NULL, JSON_NOVALUE, pattr->name, NULL) == NULL)
 				return 1;
 			for (next = pattr; next; ) {
 				if (add_json_node(JSON_VALUE, JSON_NULL, JSON_FULLESCAPE, next->resource, next->value) == NULL)
 					return 1;
-				if (next->next == NULL || strcmp(next->next->name, "resources_available")) {
+				if (next->next == NULL || strcmp(next->next->name, pattr->name)) {
 					/* Nothing left in resources_available, close object */
 					if (add_json_node(JSON_OBJECT_END, JSON_NULL, JSON_NOVALUE, NULL, NULL) == NULL)
 						return 1;
@@ -811,30 +821,27 @@ is_offline(struct batch_status *pbs)
 
 /**
  * @brief
- *	Mark the node with values sent as parameters
+ *	Build the attribute list to mark nodes with
  *
- * @param[in] con - value to test connected to server or not
- * @param[in] name - name of node
+ * @param[out] new - array of three entries to build the list in
+ * @param[out] Comment - buffer of 80 characters for the comment
  * @param[in] state1 - current state
  * @param[in] op1 - integer value corresponding to  state1
  * @param[in] state2 - transition to this state
  * @param[in] op2 - integere value corresponding to state2
+ * @param[in] comment - comment to set, may be NULL
  *
- * @return	int
- * @retval	0		success
- * @retval	pbse error	failure
+ * @return	struct attropl *
+ * @retval	the list, in new
  *
  */
-static int
-marknode(int con, char *name,
+static struct attropl *
+mark_attrs(struct attropl *new, char *Comment,
 	char *state1, enum batch_op op1,
 	char *state2, enum batch_op op2,
 	char *comment)
 {
-	char		Comment[80];
-	struct attropl	new[3];
 	int		i;
-	int		rc;
 
 	i = 0;
 	if (state1 != NULL) {
@@ -868,8 +875,37 @@ marknode(int con, char *name,
 		new[i].op = SET;
 		new[i].next = NULL;
 	}
+	return new;
+}
 
-	rc = pbs_manager(con, MGR_CMD_SET, MGR_OBJ_HOST, name, new, NULL);
+/**
+ * @brief
+ *	Mark the node with values sent as parameters
+ *
+ * @param[in] con - value to test connected to server or not
+ * @param[in] name - name of node
+ * @param[in] state1 - current state
+ * @param[in] op1 - integer value corresponding to  state1
+ * @param[in] state2 - transition to this state
+ * @param[in] op2 - integere value corresponding to state2
+ *
+ * @return	int
+ * @retval	0		success
+ * @retval	pbse error	failure
+ *
+ */
+static int
+marknode(int con, char *name,
+	char *state1, enum batch_op op1,
+	char *state2, enum batch_op op2,
+	char *comment)
+{
+	char		Comment[80];
+	struct attropl	new[3];
+	int		rc;
+
+	rc = pbs_manager(con, MGR_CMD_SET, MGR_OBJ_HOST, name,
+		mark_attrs(new, Comment, state1, op1, state2, op2, comment), NULL);
 	if (rc && !quiet) {
 		char *errmsg;
 
@@ -881,6 +917,149 @@ marknode(int con, char *name,
 	}
 	return (rc);
 }
+
+/**
+ * @brief
+ *	Mark many nodes with one request: the vnodes of the hosts listed, or
+ *	all vnodes, that match the selection.
+ *
+ * @par
+ *	A server which does not know the request is sent one request per
+ *	host, over a new connection, unless there is a selection.
+ *
+ * @param[in,out] con - connection to the server, replaced when reconnecting
+ * @param[in] server - server to reconnect to
+ * @param[in] hosts - NULL terminated list of hosts, none for all vnodes
+ * @param[in] selattr - selection, may be NULL
+ * @param[in] state1 - current state
+ * @param[in] op1 - integer value corresponding to  state1
+ * @param[in] state2 - transition to this state
+ * @param[in] op2 - integere value corresponding to state2
+ * @param[in] comment - comment to set, may be NULL
+ *
+ * @return	int
+ * @retval	0		success
+ * @retval	pbse error	failure
+ *
+ */
+static int
+marknodes(int *con, char *server, char **hosts, struct attropl *selattr,
+	char *state1, enum batch_op op1,
+	char *state2, enum batch_op op2,
+	char *comment)
+{
+	char		Comment[80];
+	struct attropl	new[3];
+	char		*list = NULL;
+	int		listsz = 0;
+	char		**pa;
+	char		*errmsg;
+	int		rc;
+	int		ret;
+
+	for (pa = hosts; *pa; pa++) {
+		if (**pa == '\0')
+			continue;
+		if ((list != NULL && pbs_strcat(&list, &listsz, ",") == NULL) ||
+			pbs_strcat(&list, &listsz, *pa) == NULL) {
+			fprintf(stderr, "pbsnodes: out of memory\n");
+			exit(1);
+		}
+	}
+	if (*hosts != NULL && list == NULL)
+		return 0;	/* only empty names */
+
+	rc = pbs_modifynodes(*con, list ? MGR_OBJ_HOST : MGR_OBJ_NODE, list, selattr,
+		mark_attrs(new, Comment, state1, op1, state2, op2, comment), NULL);
+	free(list);
+
+	if (rc == PBSE_UNKREQ && selattr == NULL && *hosts != NULL) {
+		/* older server, the rest of the request was not read */
+		(void)pbs_disconnect(*con);
+		*con = cnt2server(server);
+		if (*con <= 0) {
+			if (!quiet)
+				fprintf(stderr, "pbsnodes: cannot connect to server %s, error=%d\n",
+					server, pbs_errno);
+			exit(1);
+		}
+		rc = 0;
+		for (pa = hosts; *pa; pa++) {
+			if (**pa == '\0')
+				continue;
+			ret = marknode(*con, *pa, state1, op1, state2, op2, comment);
+			if (ret > 0)
+				rc = ret;
+		}
+		return (rc);
+	}
+
+	if (rc && !quiet) {
+		fprintf(stderr, "Error marking nodes - ");
+		if ((errmsg = pbs_geterrmsg(*con)) != NULL)
+			fprintf(stderr, "%s\n", errmsg);
+		else
+			fprintf(stderr, "error: %d\n", pbs_errno);
+	}
+	return (rc);
+}
+
+/**
+ * @brief
+ *	Print the vnode summary of each partition computed by the server
+ *
+ * @param[in] con - connection to the server
+ * @param[in] partitions - NULL terminated list of partitions, none for all
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	1	error
+ *
+ */
+static int
+prt_partition_totals(int con, char **partitions)
+{
+	struct batch_status *bstat_head;
+	struct batch_status *bstat;
+	char **pa;
+	char *all[] = {"", NULL};
+	char *name;
+	int rc = 0;
+
+	if (*partitions == NULL)
+		partitions = all;
+
+	for (pa = partitions; *pa; pa++) {
+		bstat_head = pbs_statnodesummary(con, *pa, NULL, NULL);
+		if (bstat_head == NULL) {
+			if (pbs_errno == PBSE_UNKREQ) {
+				if (!quiet)
+					fprintf(stderr, "pbsnodes: server does not support -t\n");
+				return 1;
+			}
+			if (pbs_errno != 0) {
+				if (!quiet)
+					fprintf(stderr, "Partition: %s,  Error: %s\n", *pa, pbs_geterrmsg(con));
+				rc = 1;
+			}
+			continue;
+		}
+		for (bstat = bstat_head; bstat; bstat = bstat->next) {
+			if (*bstat->name == '\0') {
+				/* vnodes in no partition */
+				if ((name = strdup("(none)")) == NULL) {
+					fprintf(stderr, "pbsnodes: out of memory\n");
+					exit(1);
+				}
+				free(bstat->name);
+				bstat->name = name;
+			}
+			prt_node(bstat);
+		}
+		pbs_statfree(bstat_head);
+	}
+	return rc;
+}
 /**
  * @brief
  *	The main function in C - entry point
@@ -917,6 +1096,7 @@ main(int argc, char *argv[])
 	int long_summary = 0;
 	int format = 0;
 	int prt_summary = 0;
+	struct attropl *selattr = NULL;
 
 	/*test for real deal or just version and exit*/
 
@@ -927,7 +1107,7 @@ main(int argc, char *argv[])
 
 	if (argc == 1)
 		errflg = 1;
-	while ((i = getopt(argc, argv, "acC:dD:F:HjlLoqrs:Sv")) != EOF)
+	while ((i = getopt(argc, argv, "acC:dD:E:F:HjlLoqrs:Stv")) != EOF)
 		switch (i) {
 
 			case 'a':
@@ -968,6 +1148,15 @@ main(int argc, char *argv[])
 					errflg = 1;
 				break;
 
+			case 'E':
+				rc = parse_sel_expr(optarg, &selattr);
+				if (rc == -1) {
+					fprintf(stderr, "pbsnodes: out of memory\n");
+					exit(1);
+				} else if (rc != 0)
+					errflg = 1;
+				break;
+
 			case 'F':
 				for (format = FORMAT_DEFAULT; format < FORMAT_MAX; format++) {
 					if (strcasecmp(optarg, output_format_names[format]) == 0) {
@@ -1036,6 +1225,13 @@ main(int argc, char *argv[])
 					errflg = 1;
 				break;
 
+			case 't':
+				if (oper == LISTSP)
+					oper = TOTALS;
+				else
+					errflg = 1;
+				break;
+
 			case 'v':
 				if (oper == LISTSP || oper == ALL)
 					do_vnodes = 1;
@@ -1052,22 +1248,25 @@ main(int argc, char *argv[])
 
 	if (errflg ||
 		(oper == LISTMRK && optind != argc) ||
-		(oper == CLEAR   && optind == argc) ||
-		(oper == OFFLINE && optind == argc) ||
-		(oper == RESET   && optind == argc) ||
+		(oper == CLEAR   && optind == argc && selattr == NULL) ||
+		(oper == OFFLINE && optind == argc && selattr == NULL) ||
+		(oper == RESET   && optind == argc && selattr == NULL) ||
 		(oper == LISTSPNV && optind == argc) ||
 		(oper == LISTSP && optind == argc) ||
-		(oper == UPDATE_COMMENT && optind == argc) ||
+		(oper == UPDATE_COMMENT && optind == argc && selattr == NULL) ||
+		(selattr && (oper != CLEAR && oper != OFFLINE && oper != RESET && oper != UPDATE_COMMENT)) ||
 		(prt_summary && (oper != LISTSP && oper != LISTSPNV && oper != ALL))) {
 		if (!quiet)
 			fprintf(stderr,
 				"usage:\t%s [-{o|r}][-C comment][-s server] host host ...\n"
+				"\t%s [-{o|r}][-C comment][-s server] -E expr [-E expr ...] [host ...]\n"
 				"\t%s -l [-s server]\n"
 				"\t%s [-s server] -v vnode vnode ...\n"
 				"\t%s -a[v][S[j][L]][-F format][-D delim][-s server]\n"
 				"\t%s -[H][S[j][L]][-F format][-D delim] host host ...\n"
+				"\t%s -t [-F format][-D delim][-s server] [partition ...]\n"
 				"\t%s --version\n\n",
-				argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
+				argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
 		exit(1);
 	}
 
@@ -1176,11 +1375,10 @@ main(int argc, char *argv[])
 
 			/* clear DOWN and OFF_LINE from specified nodes		*/
 
-			for (pa = argv+optind; *pa; pa++) {
-				ret = marknode(con, *pa, ND_offline, DECR, ND_down, DECR, comment);
-				if (ret > 0)
-					rc = ret;
-			}
+			ret = marknodes(&con, def_server, argv+optind, selattr,
+				ND_offline, DECR, ND_down, DECR, comment);
+			if (ret > 0)
+				rc = ret;
 
 			break;
 
@@ -1188,33 +1386,28 @@ main(int argc, char *argv[])
 
 			/* clear OFF_LINE from specified nodes			*/
 
-			for (pa = argv+optind; *pa; pa++) {
-				ret = marknode(con, *pa, ND_offline, DECR, NULL, DECR, comment);
-				if (ret > 0)
-					rc  = ret;
-			}
+			ret = marknodes(&con, def_server, argv+optind, selattr,
+				ND_offline, DECR, NULL, DECR, comment);
+			if (ret > 0)
+				rc  = ret;
 			break;
 
 		case OFFLINE:
 
 			/* set OFF_LINE on specified nodes			*/
-			for (pa = argv+optind; *pa; pa++) {
-				ret = marknode(con, *pa, ND_offline, INCR, NULL, INCR, comment);
-				if (ret > 0)
-					rc = ret;
-			}
+			ret = marknodes(&con, def_server, argv+optind, selattr,
+				ND_offline, INCR, NULL, INCR, comment);
+			if (ret > 0)
+				rc = ret;
 			break;
 
 		case UPDATE_COMMENT:
 
 			/*just add comment to specified nodes*/
-			for (pa = argv+optind; *pa; pa++) {
-				if (strcmp(*pa, "") == 0)
-					continue;
-				ret = marknode(con, *pa, NULL, INCR, NULL, INCR, comment);
-				if (ret > 0)
-					rc = ret;
-			}
+			ret = marknodes(&con, def_server, argv+optind, selattr,
+				NULL, INCR, NULL, INCR, comment);
+			if (ret > 0)
+				rc = ret;
 			break;
 
 		case ALL:
@@ -1240,6 +1433,20 @@ main(int argc, char *argv[])
 
 			break;
 
+		case TOTALS:
+
+			/* summary of the vnodes of each partition, by the server */
+			rc = prt_partition_totals(con, argv+optind);
+			if (output_format == FORMAT_JSON) {
+				if (add_json_node(JSON_OBJECT_END, JSON_NULL, JSON_NOVALUE, NULL, NULL) == NULL) {
+					fprintf(stderr, "pbsnodes: out of memory\n");
+					return 1;
+				}
+				generate_json(stdout);
+				free_json_node_list();
+			}
+			break;
+
 		case LISTMRK:
 
 			/* list any node that is marked DOWN or OFF_LINE	*/
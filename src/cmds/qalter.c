@@ -54,6 +54,7 @@
 
 #include "cmds.h"
 #include "pbs_ifl.h"
+#include "pbs_internal.h"
 #include <pbs_config.h>   /* the master config generated by configure */
 #include <pbs_version.h>
 #include "portability.h"
@@ -75,7 +76,8 @@ print_usage()
 	"\t[-h hold_list] [-j y|n] [-k keep] [-l resource_list]\n"
 	"\t[-m mail_options] [-M user_list] [-N jobname] [-o path] [-p priority]\n"
 	"\t[-R o|e|oe] [-r y|n] [-S path] [-u user_list] [-W dependency_list]\n"
-	"\t[-P project_name] job_identifier...\n";
+	"\t[-P project_name] job_identifier...\n"
+	"       qalter [options] -E expression [-E expression...]\n";
 	fprintf(stderr, "%s", usage);
 	fprintf(stderr, "%s", usag2);
 }
@@ -170,8 +172,11 @@ int
 main(int argc, char **argv, char **envp) /* qalter */
 {
 	int c;
+	int rc;
 	int errflg=0;
 	int any_failed=0;
+	struct attropl *selattr = NULL;
+	char **jobs;
 	char *pc;
 	int i;
 	struct attrl *attrib = NULL;
@@ -188,7 +193,7 @@ main(int argc, char **argv, char **envp) /* qalter */
 	char rmt_server[MAXSERVERNAME];
 	struct ecl_attribute_errors *err_list;
 
-#define GETOPT_ARGS "a:A:c:e:h:j:k:l:m:M:N:o:p:r:R:S:u:W:P:"
+#define GETOPT_ARGS "a:A:c:e:E:h:j:k:l:m:M:N:o:p:r:R:S:u:W:P:"
 
 	/*test for real deal or just version and exit*/
 
@@ -227,6 +232,15 @@ main(int argc, char **argv, char **envp) /* qalter */
 			case 'e':
 				set_attr_error_exit(&attrib, ATTR_e, optarg);
 				break;
+			case 'E':
+				if ((rc = parse_sel_expr(optarg, &selattr)) == -1) {
+					fprintf(stderr, "qalter: out of memory\n");
+					exit(2);
+				} else if (rc != 0) {
+					fprintf(stderr, "qalter: illegal -E value\n");
+					errflg++;
+				}
+				break;
 			case 'h':
 				while (isspace((int)*optarg)) optarg++;
 				set_attr_error_exit(&attrib, ATTR_h, optarg);
@@ -311,7 +325,8 @@ main(int argc, char **argv, char **envp) /* qalter */
 				break;
 		}
 
-	if (errflg || optind == argc) {
+	/* jobs are given either by identifier or by -E */
+	if (errflg || ((optind == argc) == (selattr == NULL))) {
 		print_usage();
 		exit(2);
 	}
@@ -323,12 +338,20 @@ main(int argc, char **argv, char **envp) /* qalter */
 		exit(1);
 	}
 
-	for (; optind < argc; optind++) {
+	if (selattr != NULL) {
+		any_failed = manage_selected_jobs("qalter", JOBLIST_ALTER, selattr, attrib, NULL);
+		CS_close_app();
+		exit(any_failed);
+	}
+
+	/* act on all jobs at once, the ones left are done one at a time */
+	jobs = manage_jobs("qalter", JOBLIST_ALTER, argv + optind, attrib, NULL, &any_failed);
+	for (; *jobs; jobs++) {
 		int connect;
 		int stat=0;
 		int located = FALSE;
 
-		pbs_strncpy(job_id, argv[optind], sizeof(job_id));
+		pbs_strncpy(job_id, *jobs, sizeof(job_id));
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qalter: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
@@ -54,6 +54,7 @@
 
 #include "cmds.h"
 #include "pbs_ifl.h"
+#include "pbs_internal.h"
 #include <pbs_config.h>   /* the master config generated by configure */
 #include <pbs_version.h>
 
@@ -70,7 +71,8 @@ print_usage()
 {
 	static char usag2[]="       qhold --version\n";
 	static char usage[]=
-		"usage: qhold [-h hold_list] job_identifier...\n";
+		"usage: qhold [-h hold_list] job_identifier...\n"
+		"       qhold [-h hold_list] -E expression [-E expression...]\n";
 
 	fprintf(stderr, "%s", usage);
 	fprintf(stderr, "%s", usag2);
@@ -115,8 +117,11 @@ int
 main(int argc, char **argv, char **envp) /* qhold */
 {
 	int c;
+	int rc;
 	int errflg=0;
 	int any_failed=0;
+	struct attropl *selattr = NULL;
+	char **jobs;
 	char job_id[PBS_MAXCLTJOBID];       /* from the command line */
 
 	char job_id_out[PBS_MAXCLTJOBID];
@@ -127,7 +132,7 @@ main(int argc, char **argv, char **envp) /* qhold */
 #define MAX_HOLD_TYPE_LEN 32
 	char hold_type[MAX_HOLD_TYPE_LEN+1];
 
-#define GETOPT_ARGS "h:-:"
+#define GETOPT_ARGS "E:h:-:"
 
 	/*test for real deal or just version and exit*/
 
@@ -140,6 +145,15 @@ main(int argc, char **argv, char **envp) /* qhold */
 
 	while ((c = getopt(argc, argv, GETOPT_ARGS)) != EOF)
 		switch (c) {
+			case 'E':
+				if ((rc = parse_sel_expr(optarg, &selattr)) == -1) {
+					fprintf(stderr, "qhold: out of memory\n");
+					exit(2);
+				} else if (rc != 0) {
+					fprintf(stderr, "qhold: illegal -E value\n");
+					errflg++;
+				}
+				break;
 			case 'h':
 				while (isspace((int)*optarg)) optarg++;
 				if (optarg[0] == '\0') {
@@ -153,7 +167,8 @@ main(int argc, char **argv, char **envp) /* qhold */
 				errflg++;
 		}
 
-	if (errflg || optind >= argc) {
+	/* jobs are given either by identifier or by -E */
+	if (errflg || ((optind >= argc) == (selattr == NULL))) {
 		print_usage();
 		exit(2);
 	}
@@ -165,12 +180,20 @@ main(int argc, char **argv, char **envp) /* qhold */
 		exit(2);
 	}
 
-	for (; optind < argc; optind++) {
+	if (selattr != NULL) {
+		any_failed = manage_selected_jobs("qhold", JOBLIST_HOLD, selattr, NULL, hold_type);
+		CS_close_app();
+		exit(any_failed);
+	}
+
+	/* act on all jobs at once, the ones left are done one at a time */
+	jobs = manage_jobs("qhold", JOBLIST_HOLD, argv + optind, NULL, hold_type, &any_failed);
+	for (; *jobs; jobs++) {
 		int connect;
 		int stat=0;
 		int located = FALSE;
 
-		pbs_strncpy(job_id, argv[optind], sizeof(job_id));
+		pbs_strncpy(job_id, *jobs, sizeof(job_id));
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qhold: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
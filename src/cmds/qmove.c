@@ -54,6 +54,7 @@
 
 #include "cmds.h"
 #include "pbs_ifl.h"
+#include "pbs_internal.h"
 #include <pbs_config.h>   /* the master config generated by configure */
 #include <pbs_version.h>
 
@@ -61,7 +62,12 @@
 int
 main(int argc, char **argv, char **envp) /* qmove */
 {
+	int c;
+	int rc;
+	int errflg=0;
 	int any_failed=0;
+	struct attropl *selattr = NULL;
+	char **jobs;
 
 	char job_id[PBS_MAXCLTJOBID];		/* from the command line */
 	char destination[PBS_MAXSERVERNAME];	/* from the command line */
@@ -78,15 +84,35 @@ main(int argc, char **argv, char **envp) /* qmove */
 	if (initsocketlib())
 		return 1;
 
-	if (argc < 3) {
-		static char usage[]="usage: qmove destination job_identifier...\n";
+#define GETOPT_ARGS "E:"
+
+	while ((c = getopt(argc, argv, GETOPT_ARGS)) != EOF)
+		switch (c) {
+			case 'E':
+				if ((rc = parse_sel_expr(optarg, &selattr)) == -1) {
+					fprintf(stderr, "qmove: out of memory\n");
+					exit(2);
+				} else if (rc != 0) {
+					fprintf(stderr, "qmove: illegal -E value\n");
+					errflg++;
+				}
+				break;
+			default :
+				errflg++;
+		}
+
+	/* a destination, then jobs given either by identifier or by -E */
+	if (errflg || optind >= argc ||
+		((optind + 1 >= argc) == (selattr == NULL))) {
+		static char usage[]="usage: qmove destination job_identifier...\n"
+			"       qmove -E expression [-E expression...] destination\n";
 		static char usag2[]="       qmove --version\n";
 		fprintf(stderr, "%s", usage);
 		fprintf(stderr, "%s", usag2);
 		exit(2);
 	}
 
-	pbs_strncpy(destination, argv[1], sizeof(destination));
+	pbs_strncpy(destination, argv[optind++], sizeof(destination));
 	if (parse_destination_id(destination, &q_n_out, &s_n_out)) {
 		fprintf(stderr, "qmove: illegally formed destination: %s\n", destination);
 		exit(2);
@@ -99,12 +125,20 @@ main(int argc, char **argv, char **envp) /* qmove */
 		exit(2);
 	}
 
-	for (optind = 2; optind < argc; optind++) {
+	if (selattr != NULL) {
+		any_failed = manage_selected_jobs("qmove", JOBLIST_MOVE, selattr, NULL, destination);
+		CS_close_app();
+		exit(any_failed);
+	}
+
+	/* act on all jobs at once, the ones left are done one at a time */
+	jobs = manage_jobs("qmove", JOBLIST_MOVE, argv + optind, NULL, destination, &any_failed);
+	for (; *jobs; jobs++) {
 		int connect;
 		int stat=0;
 		int located = FALSE;
 
-		pbs_strncpy(job_id, argv[optind], sizeof(job_id));
+		pbs_strncpy(job_id, *jobs, sizeof(job_id));
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qmove: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
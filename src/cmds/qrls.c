@@ -53,6 +53,7 @@
 
 #include "cmds.h"
 #include "pbs_ifl.h"
+#include "pbs_internal.h"
 #include <pbs_config.h>   /* the master config generated by configure */
 #include <pbs_version.h>
 
@@ -61,8 +62,11 @@ int
 main(int argc, char **argv, char **envp) /* qrls */
 {
 	int c;
+	int rc;
 	int errflg=0;
 	int any_failed=0;
+	struct attropl *selattr = NULL;
+	char **jobs;
 	int u_cnt, o_cnt, s_cnt, n_cnt, p_cnt;
 	char *pc;
 
@@ -75,7 +79,7 @@ main(int argc, char **argv, char **envp) /* qrls */
 #define MAX_HOLD_TYPE_LEN 32
 	char hold_type[MAX_HOLD_TYPE_LEN+1];
 
-#define GETOPT_ARGS "h:"
+#define GETOPT_ARGS "E:h:"
 
 	/*test for real deal or just version and exit*/
 
@@ -88,6 +92,15 @@ main(int argc, char **argv, char **envp) /* qrls */
 
 	while ((c = getopt(argc, argv, GETOPT_ARGS)) != EOF)
 		switch (c) {
+			case 'E':
+				if ((rc = parse_sel_expr(optarg, &selattr)) == -1) {
+					fprintf(stderr, "qrls: out of memory\n");
+					exit(2);
+				} else if (rc != 0) {
+					fprintf(stderr, "qrls: illegal -E value\n");
+					errflg++;
+				}
+				break;
 			case 'h':
 				while (isspace((int)*optarg)) optarg++;
 				if (strlen(optarg) == 0) {
@@ -126,8 +139,10 @@ main(int argc, char **argv, char **envp) /* qrls */
 				errflg++;
 		}
 
-	if (errflg || optind >= argc) {
-		static char usage[]="usage: qrls [-h hold_list] job_identifier...\n";
+	/* jobs are given either by identifier or by -E */
+	if (errflg || ((optind >= argc) == (selattr == NULL))) {
+		static char usage[]="usage: qrls [-h hold_list] job_identifier...\n"
+			"       qrls [-h hold_list] -E expression [-E expression...]\n";
 		static char usag2[]="       qrls --version\n";
 		fprintf(stderr, "%s", usage);
 		fprintf(stderr, "%s", usag2);
@@ -141,12 +156,20 @@ main(int argc, char **argv, char **envp) /* qrls */
 		exit(1);
 	}
 
-	for (; optind < argc; optind++) {
+	if (selattr != NULL) {
+		any_failed = manage_selected_jobs("qrls", JOBLIST_RELEASE, selattr, NULL, hold_type);
+		CS_close_app();
+		exit(any_failed);
+	}
+
+	/* act on all jobs at once, the ones left are done one at a time */
+	jobs = manage_jobs("qrls", JOBLIST_RELEASE, argv + optind, NULL, hold_type, &any_failed);
+	for (; *jobs; jobs++) {
 		int connect;
 		int stat=0;
 		int located = FALSE;
 
-		pbs_strncpy(job_id, argv[optind], sizeof(job_id));
+		pbs_strncpy(job_id, *jobs, sizeof(job_id));
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qrls: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
@@ -54,6 +54,7 @@
 
 #include "cmds.h"
 #include "pbs_ifl.h"
+#include "pbs_internal.h"
 #include <pbs_config.h>   /* the master config generated by configure */
 #include <pbs_version.h>
 
@@ -62,8 +63,11 @@ int
 main(int argc, char **argv, char **envp) /* qsig */
 {
 	int c;
+	int rc;
 	int errflg=0;
 	int any_failed=0;
+	struct attropl *selattr = NULL;
+	char **jobs;
 
 	char job_id[PBS_MAXCLTJOBID];       /* from the command line */
 
@@ -74,7 +78,7 @@ main(int argc, char **argv, char **envp) /* qsig */
 #define MAX_SIGNAL_TYPE_LEN 32
 	static char sig_string[MAX_SIGNAL_TYPE_LEN+1] = "SIGTERM";
 
-#define GETOPT_ARGS "s:"
+#define GETOPT_ARGS "E:s:"
 
 	/*test for real deal or just version and exit*/
 
@@ -85,6 +89,15 @@ main(int argc, char **argv, char **envp) /* qsig */
 
 	while ((c = getopt(argc, argv, GETOPT_ARGS)) != EOF)
 		switch (c) {
+			case 'E':
+				if ((rc = parse_sel_expr(optarg, &selattr)) == -1) {
+					fprintf(stderr, "qsig: out of memory\n");
+					exit(2);
+				} else if (rc != 0) {
+					fprintf(stderr, "qsig: illegal -E value\n");
+					errflg++;
+				}
+				break;
 			case 's':
 				pbs_strncpy(sig_string, optarg, sizeof(sig_string));
 				break;
@@ -92,8 +105,10 @@ main(int argc, char **argv, char **envp) /* qsig */
 				errflg++;
 		}
 
-	if (errflg || optind >= argc) {
-		static char usage[]="usage: qsig [-s signal] job_identifier...\n";
+	/* jobs are given either by identifier or by -E */
+	if (errflg || ((optind >= argc) == (selattr == NULL))) {
+		static char usage[]="usage: qsig [-s signal] job_identifier...\n"
+			"       qsig [-s signal] -E expression [-E expression...]\n";
 		static char usag2[]="       qsig --version\n";
 		fprintf(stderr, "%s", usage);
 		fprintf(stderr, "%s", usag2);
@@ -107,12 +122,20 @@ main(int argc, char **argv, char **envp) /* qsig */
 		exit(2);
 	}
 
-	for (; optind < argc; optind++) {
+	if (selattr != NULL) {
+		any_failed = manage_selected_jobs("qsig", JOBLIST_SIGNAL, selattr, NULL, sig_string);
+		CS_close_app();
+		exit(any_failed);
+	}
+
+	/* act on all jobs at once, the ones left are done one at a time */
+	jobs = manage_jobs("qsig", JOBLIST_SIGNAL, argv + optind, NULL, sig_string, &any_failed);
+	for (; *jobs; jobs++) {
 		int connect;
 		int stat=0;
 		int located = FALSE;
 
-		pbs_strncpy(job_id, argv[optind], sizeof(job_id));
+		pbs_strncpy(job_id, *jobs, sizeof(job_id));
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qsig: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
@@ -80,6 +80,7 @@ static void states();
 static char *	cvtResvstate(char *);
 static int cmp_est_time(struct batch_status *a, struct batch_status *b);
 char *cnvt_est_start_time(char *start_time, int shortform);
+extern struct batch_status *qstat_cache_stat(int, char *, char *, struct attropl *, struct attrl *, char *, unsigned int);
 
 
 #if !defined(PBS_NO_POSIX_VIOLATION)
@@ -150,6 +151,20 @@ static struct attrl alt_attribs[] = {
 		SET		}
 };
 
+/* server attributes shown in or used for the job display header */
+static struct attrl svrhdr_attribs[] = {
+	{	&svrhdr_attribs[1],
+		ATTR_comment,
+		NULL,
+		"",
+		SET		},
+	{	NULL,
+		ATTR_max_job_sequence_id,
+		NULL,
+		"",
+		SET		}
+};
+
 enum output_format_enum {
 	FORMAT_DEFAULT = 0,
 	FORMAT_DSV,
@@ -1213,6 +1228,19 @@ add_atropl(struct attropl **list, char *name, char *resc, char *value, enum batc
 	*list = patro;
 }
 
+/* make sure an attribute is in the list of attributes to status */
+
+static void
+need_attrib(struct attrl **list, char *name)
+{
+	struct attrl *pat;
+
+	for (pat = *list; pat; pat = pat->next)
+		if (strcmp(pat->name, name) == 0)
+			return;
+	add_atropl((struct attropl **)list, name, NULL, "", SET);
+}
+
 static long
 cvt_time_to_seconds(char *ts)
 {
@@ -2735,6 +2763,22 @@ main(int argc, char **argv, char **envp) /* qstat */
 			errflg++;
 		}
 	}
+
+	/*
+	 * Ask the server only for the attributes the display uses.  -f wants
+	 * all of them, whatever options came after it; the -W forms of the
+	 * display options do not adjust the list while being parsed.
+	 */
+	if (f_opt == 1)
+		display_attribs = NULL;
+	else if (display_attribs != NULL) {
+		if ((alt_opt & ~ALT_DISPLAY_w) != 0 && display_attribs == &basic_attribs[0])
+			display_attribs = &alt_attribs[0];
+		if (alt_opt & ALT_DISPLAY_n)
+			need_attrib(&display_attribs, ATTR_exechost);
+		if (alt_opt & ALT_DISPLAY_s)
+			need_attrib(&display_attribs, ATTR_comment);
+	}
 #endif /* PBS_NO_POSIX_VIOLATION */
 
 	if (errflg) {
@@ -2935,9 +2979,11 @@ job_no_args:
 				
 				if (strcmp(pbs_server, server_old) != 0) {
 					/* changing to a different server */
-					p_server = pbs_statserver(conn, NULL, NULL);
 #ifdef NAS /* localmod 071 */
+					p_server = pbs_statserver(conn, NULL, NULL);
 					p_rsvstat = pbs_statresv(conn, NULL, NULL, NULL);
+#else
+					p_server = pbs_statserver(conn, svrhdr_attribs, NULL);
 #endif /* localmod 071 */
 					pbs_strncpy(server_old, pbs_server, sizeof(server_old));
 				} else {
@@ -2965,10 +3011,16 @@ job_no_args:
 				if ((stat_single_job == 1) || (new_atropl == 0)) {
 					if (E_opt == 1)
 						p_status = pbs_statjob(conn, query_job_list, display_attribs, extend);
+					else if (stat_single_job == 0 && pbs_conf.pbs_qstat_cache_ttl > 0)
+						p_status = qstat_cache_stat(conn, pbs_server, job_id_out, NULL,
+							display_attribs, extend, pbs_conf.pbs_qstat_cache_ttl);
 					else
 						p_status = pbs_statjob(conn, job_id_out, display_attribs, extend);
+				} else if (pbs_conf.pbs_qstat_cache_ttl > 0) {
+					p_status = qstat_cache_stat(conn, pbs_server, NULL, new_atropl,
+						display_attribs, extend, pbs_conf.pbs_qstat_cache_ttl);
 				} else {
-					p_status = pbs_selstat(conn, new_atropl, NULL, extend);
+					p_status = pbs_selstat(conn, new_atropl, display_attribs, extend);
 				}
 
 				if (added_queue) {
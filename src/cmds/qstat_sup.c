@@ -0,0 +1,512 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	qstat_sup.c
+ * @brief
+ * 	qstat support: a local cache of job listings.
+ *
+ * When PBS_QSTAT_CACHE_TTL is set, listings of all jobs, of a queue or of a
+ * selection are kept in files under a directory private to the user, one
+ * file per distinct query.  A qstat finding a file younger than the TTL
+ * shows it instead of asking the server.  Otherwise the one qstat that gets
+ * the lock streams the reply from the server into a new file and renames it
+ * in place; qstats of the same user that arrive meanwhile wait for it rather
+ * than sending the same request.  The cache is per user because the server
+ * filters the jobs a user may see.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "pbs_ifl.h"
+#include "pbs_error.h"
+#include "libutil.h"
+
+#define QSTAT_CACHE_MAGIC	"PBS_QSTAT_CACHE 1\n"
+#define QSTAT_CACHE_PREFIX	"pbs_qstat_"
+#define QSTAT_CACHE_KEYSEP	"\037"	/* separates the fields of a key */
+#define QSTAT_CACHE_NULLSTR	UINT32_MAX	/* length recorded for a NULL string */
+#define QSTAT_CACHE_OBJ	'O'
+#define QSTAT_CACHE_ATTR	'A'
+#define QSTAT_CACHE_END	'E'
+
+/**
+ * @brief
+ *	Append the fields of a query to its cache key.
+ *
+ * @param[in,out] key - key being built
+ * @param[in,out] keysz - size of key
+ * @param[in] name - attribute name
+ * @param[in] resc - resource name, may be NULL
+ * @param[in] val - value, may be NULL
+ * @param[in] op - operator
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	out of memory
+ */
+static int
+key_add_attr(char **key, int *keysz, char *name, char *resc, char *val, int op)
+{
+	char opbuf[16];
+
+	snprintf(opbuf, sizeof(opbuf), "%d", op);
+	if (pbs_strcat(key, keysz, name) == NULL ||
+		pbs_strcat(key, keysz, ".") == NULL ||
+		pbs_strcat(key, keysz, resc ? resc : "") == NULL ||
+		pbs_strcat(key, keysz, QSTAT_CACHE_KEYSEP) == NULL ||
+		pbs_strcat(key, keysz, opbuf) == NULL ||
+		pbs_strcat(key, keysz, QSTAT_CACHE_KEYSEP) == NULL ||
+		pbs_strcat(key, keysz, val ? val : "") == NULL ||
+		pbs_strcat(key, keysz, QSTAT_CACHE_KEYSEP) == NULL)
+		return -1;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Build the key identifying a query: the server, the kind of request,
+ *	the job id or destination, the selection, the attributes asked for
+ *	and the extend string.
+ *
+ * @return	char *
+ * @retval	the key, to be freed by the caller	success
+ * @retval	NULL	out of memory
+ */
+static char *
+make_key(char *server, char *id, struct attropl *select, struct attrl *attribs, char *extend)
+{
+	char *key = NULL;
+	int keysz = 0;
+	struct attropl *pop;
+	struct attrl *pat;
+
+	if (pbs_strcat(&key, &keysz, server) == NULL ||
+		pbs_strcat(&key, &keysz, QSTAT_CACHE_KEYSEP) == NULL ||
+		pbs_strcat(&key, &keysz, select ? "S" : "J") == NULL ||
+		pbs_strcat(&key, &keysz, QSTAT_CACHE_KEYSEP) == NULL ||
+		pbs_strcat(&key, &keysz, id ? id : "") == NULL ||
+		pbs_strcat(&key, &keysz, QSTAT_CACHE_KEYSEP) == NULL)
+		goto err;
+	for (pop = select; pop; pop = pop->next)
+		if (key_add_attr(&key, &keysz, pop->name, pop->resource, pop->value, pop->op) != 0)
+			goto err;
+	if (pbs_strcat(&key, &keysz, QSTAT_CACHE_KEYSEP) == NULL)
+		goto err;
+	for (pat = attribs; pat; pat = pat->next)
+		if (key_add_attr(&key, &keysz, pat->name, pat->resource, NULL, pat->op) != 0)
+			goto err;
+	if (pbs_strcat(&key, &keysz, QSTAT_CACHE_KEYSEP) == NULL ||
+		pbs_strcat(&key, &keysz, extend ? extend : "") == NULL)
+		goto err;
+	return key;
+
+err:
+	free(key);
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Find, creating it if need be, the user's cache directory and form the
+ *	base path of the cache file for a key.
+ *
+ *	The directory is only used if it is owned by the user and not
+ *	accessible to anybody else.
+ *
+ * @param[in] key - query key
+ * @param[out] path - base path of the cache file
+ * @param[in] len - size of path
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	no usable directory
+ */
+static int
+cache_path(char *key, char *path, size_t len)
+{
+	char *tmpdir;
+	struct stat sb;
+	uint64_t hash = 14695981039346656037ULL;	/* FNV-1a */
+	unsigned char *p;
+	size_t dlen;
+	int n;
+
+	if ((tmpdir = getenv("TMPDIR")) == NULL || *tmpdir == '\0')
+		tmpdir = "/tmp";
+	n = snprintf(path, len, "%s/%s%ld", tmpdir, QSTAT_CACHE_PREFIX, (long) getuid());
+	if (n < 0 || (size_t) n >= len)
+		return -1;
+	if (mkdir(path, 0700) == -1 && errno != EEXIST)
+		return -1;
+	if (lstat(path, &sb) == -1 || !S_ISDIR(sb.st_mode) ||
+		sb.st_uid != getuid() || (sb.st_mode & (S_IRWXG | S_IRWXO)))
+		return -1;
+
+	for (p = (unsigned char *) key; *p; p++) {
+		hash ^= *p;
+		hash *= 1099511628211ULL;
+	}
+	dlen = n;
+	n = snprintf(path + dlen, len - dlen, "/%016llx", (unsigned long long) hash);
+	if (n < 0 || (size_t) n >= len - dlen)
+		return -1;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Write a string with its length.
+ *
+ * @param[in] fp - cache file
+ * @param[in] str - string, may be NULL
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	write error
+ */
+static int
+put_str(FILE *fp, char *str)
+{
+	uint32_t len;
+
+	len = (str == NULL) ? QSTAT_CACHE_NULLSTR : (uint32_t) strlen(str);
+	if (fwrite(&len, sizeof(len), 1, fp) != 1)
+		return -1;
+	if (str != NULL && len > 0 && fwrite(str, len, 1, fp) != 1)
+		return -1;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Read a string written by put_str().
+ *
+ * @param[in,out] pp - read position, advanced past the string
+ * @param[in] end - end of the data
+ * @param[out] str - malloc'ed copy of the string, NULL for a NULL string
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	data truncated or out of memory
+ */
+static int
+get_str(char **pp, char *end, char **str)
+{
+	uint32_t len;
+
+	*str = NULL;
+	if ((size_t) (end - *pp) < sizeof(len))
+		return -1;
+	memcpy(&len, *pp, sizeof(len));
+	*pp += sizeof(len);
+	if (len == QSTAT_CACHE_NULLSTR)
+		return 0;
+	if ((size_t) (end - *pp) < len)
+		return -1;
+	if ((*str = malloc(len + 1)) == NULL)
+		return -1;
+	memcpy(*str, *pp, len);
+	(*str)[len] = '\0';
+	*pp += len;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Load a cache file.
+ *
+ * @param[in] path - cache file
+ * @param[in] key - key of the query, must match the one in the file
+ * @param[in] ttl - maximum age in seconds, 0 to accept any age
+ * @param[out] bsp - the cached objects, NULL for an empty listing
+ *
+ * @return	int
+ * @retval	1	*bsp holds the cached listing
+ * @retval	0	no usable cache file
+ */
+static int
+read_cache(char *path, char *key, unsigned int ttl, struct batch_status **bsp)
+{
+	int fd;
+	struct stat sb;
+	char *buf = NULL;
+	char *p;
+	char *end;
+	char *fkey = NULL;
+	ssize_t n;
+	size_t got;
+	time_t now;
+	struct batch_status *head = NULL;
+	struct batch_status *bs = NULL;
+	struct attrl *at;
+	struct attrl *atlast = NULL;
+	int done = 0;
+
+	*bsp = NULL;
+	if ((fd = open(path, O_RDONLY | O_NOFOLLOW)) == -1)
+		return 0;
+	if (fstat(fd, &sb) == -1 || !S_ISREG(sb.st_mode) || sb.st_uid != getuid())
+		goto out;
+	now = time(NULL);
+	if (ttl > 0 && (now < sb.st_mtime || now - sb.st_mtime >= (time_t) ttl))
+		goto out;
+	if (sb.st_size < (off_t) sizeof(QSTAT_CACHE_MAGIC) ||
+		(buf = malloc(sb.st_size)) == NULL)
+		goto out;
+	for (got = 0; got < (size_t) sb.st_size; got += n) {
+		n = read(fd, buf + got, sb.st_size - got);
+		if (n <= 0)
+			goto out;
+	}
+	p = buf;
+	end = buf + sb.st_size;
+	if (memcmp(p, QSTAT_CACHE_MAGIC, sizeof(QSTAT_CACHE_MAGIC) - 1) != 0)
+		goto out;
+	p += sizeof(QSTAT_CACHE_MAGIC) - 1;
+	if (get_str(&p, end, &fkey) != 0 || fkey == NULL || strcmp(fkey, key) != 0)
+		goto out;
+
+	while (p < end && !done) {
+		switch (*p++) {
+			case QSTAT_CACHE_OBJ:
+				if (bs == NULL)
+					bs = head = calloc(1, sizeof(struct batch_status));
+				else
+					bs = bs->next = calloc(1, sizeof(struct batch_status));
+				if (bs == NULL ||
+					get_str(&p, end, &bs->name) != 0 ||
+					get_str(&p, end, &bs->text) != 0)
+					goto out;
+				atlast = NULL;
+				break;
+
+			case QSTAT_CACHE_ATTR:
+				if (bs == NULL || (at = calloc(1, sizeof(struct attrl))) == NULL)
+					goto out;
+				if (atlast == NULL)
+					bs->attribs = at;
+				else
+					atlast->next = at;
+				atlast = at;
+				at->op = SET;
+				if (get_str(&p, end, &at->name) != 0 ||
+					get_str(&p, end, &at->resource) != 0 ||
+					get_str(&p, end, &at->value) != 0)
+					goto out;
+				break;
+
+			case QSTAT_CACHE_END:
+				done = 1;
+				break;
+
+			default:
+				goto out;
+		}
+	}
+	if (done) {
+		*bsp = head;
+		head = NULL;
+	}
+
+out:
+	pbs_statfree(head);
+	free(fkey);
+	free(buf);
+	close(fd);
+	return done;
+}
+
+/**
+ * @brief
+ *	Stream a listing from the server into a new cache file and move it
+ *	into place.
+ *
+ * @param[in] c - connection handle
+ * @param[in] path - cache file
+ * @param[in] key - key of the query
+ * @param[in] id - job id or queue, for a status request
+ * @param[in] select - selection criteria, NULL for a status request
+ * @param[in] attribs - attributes to return
+ * @param[in] extend - extend string for the request
+ *
+ * @return	int
+ * @retval	0	the cache file was written
+ * @retval	-1	error; the server's error, if any, is in pbs_errno
+ */
+static int
+write_cache(int c, char *path, char *key, char *id, struct attropl *select,
+	struct attrl *attribs, char *extend)
+{
+	char tmp[MAXPATHLEN + 1];
+	struct pbs_statstream *ss;
+	struct batch_status *bs;
+	struct attrl *at;
+	FILE *fp;
+	int fd;
+	int err = 0;
+	int rc;
+
+	snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long) getpid());
+	if ((fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW, 0600)) == -1)
+		return -1;
+	if ((fp = fdopen(fd, "w")) == NULL) {
+		close(fd);
+		unlink(tmp);
+		return -1;
+	}
+
+	if (select != NULL)
+		ss = pbs_selstat_stream(c, select, attribs, extend);
+	else
+		ss = pbs_statjob_stream(c, id, attribs, extend);
+	if (ss == NULL) {
+		fclose(fp);
+		unlink(tmp);
+		return -1;
+	}
+
+	if (fputs(QSTAT_CACHE_MAGIC, fp) == EOF || put_str(fp, key) != 0)
+		err = 1;
+	while (!err && (bs = pbs_statstream_next(ss)) != NULL) {
+		if (fputc(QSTAT_CACHE_OBJ, fp) == EOF ||
+			put_str(fp, bs->name) != 0 || put_str(fp, bs->text) != 0)
+			err = 1;
+		for (at = bs->attribs; at && !err; at = at->next) {
+			if (fputc(QSTAT_CACHE_ATTR, fp) == EOF ||
+				put_str(fp, at->name) != 0 ||
+				put_str(fp, at->resource) != 0 ||
+				put_str(fp, at->value) != 0)
+				err = 1;
+		}
+	}
+	rc = pbs_statstream_close(ss);
+	if (fputc(QSTAT_CACHE_END, fp) == EOF)
+		err = 1;
+	if (fclose(fp) != 0)
+		err = 1;
+	if (err || rc != 0 || rename(tmp, path) == -1) {
+		unlink(tmp);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Status jobs through the local cache.
+ *
+ *	Returns what pbs_statjob() (select == NULL) or pbs_selstat() would
+ *	return for the same arguments.  The listing comes from a cache file
+ *	younger than ttl seconds if there is one.  Otherwise it is fetched and
+ *	cached, or, while another qstat fetches it, taken from that qstat once
+ *	it is done.  Whenever the cache cannot be used the request is simply
+ *	sent to the server; errors are never cached.
+ *
+ * @param[in] c - connection handle
+ * @param[in] server - name of the server connected to
+ * @param[in] id - job id or queue, for a status request
+ * @param[in] select - selection criteria, NULL for a status request
+ * @param[in] attribs - attributes to return
+ * @param[in] extend - extend string for the request
+ * @param[in] ttl - seconds a cached listing may be reused
+ *
+ * @return	struct batch_status *
+ * @retval	list of jobs	success
+ * @retval	NULL	no jobs or error, see pbs_errno
+ */
+struct batch_status *
+qstat_cache_stat(int c, char *server, char *id, struct attropl *select,
+	struct attrl *attribs, char *extend, unsigned int ttl)
+{
+	char path[MAXPATHLEN + 1];
+	char lock[MAXPATHLEN + 1];
+	char *key;
+	struct batch_status *bs = NULL;
+	int lfd = -1;
+	int hit = 0;
+
+	if ((key = make_key(server, id, select, attribs, extend)) == NULL)
+		goto direct;
+	if (cache_path(key, path, sizeof(path) - 16) != 0)
+		goto direct;
+	if ((hit = read_cache(path, key, ttl, &bs)) != 0)
+		goto done;
+
+	snprintf(lock, sizeof(lock), "%s.lock", path);
+	if ((lfd = open(lock, O_RDWR | O_CREAT | O_NOFOLLOW, 0600)) == -1)
+		goto direct;
+	if (flock(lfd, LOCK_EX | LOCK_NB) == 0) {
+		/* another qstat may have refreshed it before we got the lock */
+		if ((hit = read_cache(path, key, ttl, &bs)) != 0)
+			goto done;
+		if (write_cache(c, path, key, id, select, attribs, extend) == 0)
+			hit = read_cache(path, key, 0, &bs);
+	} else if (errno == EWOULDBLOCK && flock(lfd, LOCK_SH) == 0) {
+		/* a refresh was in progress and is now done */
+		hit = read_cache(path, key, ttl, &bs);
+	}
+
+done:
+	if (lfd != -1)
+		close(lfd);
+	if (hit) {
+		free(key);
+		pbs_errno = PBSE_NONE;
+		return bs;
+	}
+
+direct:
+	free(key);
+	if (select != NULL)
+		return pbs_selstat(c, select, attribs, extend);
+	return pbs_statjob(c, id, attribs, extend);
+}
@@ -205,6 +205,7 @@ char *basic_envlist = NULL; /* basic comma-separated environment variables list
 char *qsub_envlist = NULL; /* comma-separated variables list string */
 char *v_value = NULL; /* expanded variable list from v opt */
 static int no_background = 0; /* flag to disable backgrounding */
+static char *joblist_file = NULL; /* file listing jobs to submit, from --joblist */
 static char roptarg = 'y'; /* whether the job is rerunnable */
 static char *v_value_o = NULL; /* copy of v_value before set_job_env() */
 static int x11_disp = FALSE; /* whether DISPLAY environment variable is available */
@@ -702,7 +703,8 @@ strdup_esc_commas(char *str_to_dup)
 static void
 print_usage(void)
 {
-	static char usage2[]="       qsub --version\n";
+	static char usage2[]="       qsub [options] --joblist=file\n"
+		"       qsub --version\n";
 	extern char usage[];
 	fprintf(stderr, "%s", usage);
 	fprintf(stderr, "%s", usage2);
@@ -2832,6 +2834,187 @@ do_connect(char *server_out, char *retmsg)
 	return 0;
 }
 
+static struct attrl *dup_attrl(struct attrl *attrib);
+void qsub_free_attrl(struct attrl *attrib);
+
+/**
+ * @brief
+ *	Print the outcome of one Submit Job List request and free the jobs.
+ *
+ * @param[in]	jobs  - jobs that were sent
+ * @param[in]	njobs - number of jobs
+ * @param[in]	bss   - per job statuses returned by pbs_submitjoblist()
+ *
+ * @return int
+ * @retval number of jobs that were rejected
+ *
+ */
+static int
+report_joblist(struct batch_submit_job *jobs, int njobs, struct batch_submit_status *bss)
+{
+	struct batch_submit_status *pstat;
+	char *errmsg;
+	int nfail = 0;
+	int i;
+
+	for (i = 0, pstat = bss; i < njobs; i++) {
+		if ((pstat != NULL) && (pstat->jobid != NULL)) {
+			if (!z_opt)
+				printf("%s\n", pstat->jobid);
+		} else {
+			errmsg = NULL;
+			if (pstat != NULL)
+				errmsg = pstat->text ? pstat->text : pbse_to_txt(pstat->code);
+			if (errmsg != NULL)
+				fprintf(stderr, "qsub: %s: %s\n", jobs[i].script, errmsg);
+			else
+				fprintf(stderr, "qsub: %s: Error (%d) submitting job\n",
+					jobs[i].script, pstat ? pstat->code : pbs_errno);
+			nfail++;
+		}
+		if (pstat != NULL)
+			pstat = pstat->next;
+		qsub_free_attrl((struct attrl *) jobs[i].attrib);
+		free(jobs[i].script);
+	}
+	return nfail;
+}
+
+/**
+ * @brief
+ *	Submit the jobs listed in the --joblist file, up to
+ *	PBS_MAX_SUBMITJOBLIST jobs per request.
+ *
+ * @par
+ *	Each line of the file names a job script, optionally followed by
+ *	attribute assignments, name=value or name.resource=value, which
+ *	override the command line options for that job.  Blank lines and
+ *	lines starting with '#' are skipped.  Directives inside the listed
+ *	scripts are not read.  The id of each job is printed, or an error
+ *	for each job that was rejected.
+ *
+ * @param[out] retmsg - error message if the list could not be submitted
+ *
+ * @return int
+ * @retval 0 - every job was submitted
+ * @retval 1 - some jobs were rejected, already reported
+ * @retval 2 - bad list file, retmsg is set
+ * @retval pbs_errno - request failed, retmsg is set
+ *
+ */
+static int
+do_submit_joblist(char *retmsg)
+{
+	FILE *fp;
+	char *line = NULL;
+	int line_sz = 0;
+	int lineno = 0;
+	char *tok;
+	char *val;
+	char *resc;
+	char *bnp;
+	char *errmsg;
+	struct attrl *jattr;
+	struct batch_submit_job *jobs;
+	struct batch_submit_status *bss;
+	int njobs = 0;
+	int nsent = 0;
+	int nfail = 0;
+	int eof = 0;
+	int rc = 0;
+
+	if ((fp = fopen(joblist_file, "r")) == NULL) {
+		snprintf(retmsg, MAXPATHLEN, "qsub: cannot open job list %s\n", joblist_file);
+		return 2;
+	}
+	jobs = calloc(PBS_MAX_SUBMITJOBLIST, sizeof(struct batch_submit_job));
+	if (jobs == NULL) {
+		fclose(fp);
+		snprintf(retmsg, MAXPATHLEN, "qsub: out of memory\n");
+		return 2;
+	}
+
+	while (!eof) {
+		if (pbs_fgets(&line, &line_sz, fp) == NULL)
+			eof = 1;
+		else {
+			lineno++;
+			tok = strtok(line, " \t\n");
+			if ((tok == NULL) || (*tok == '#'))
+				continue;
+
+			jattr = dup_attrl(attrib);
+			if (!N_opt) {
+				if ((bnp = strrchr(tok, (int)'/')) != NULL)
+					bnp++;
+				else
+					bnp = tok;
+				set_attr_error_exit(&jattr, ATTR_N, bnp);
+			}
+			jobs[njobs].script = strdup(tok);
+			jobs[njobs].destination = destination;
+			while ((tok = strtok(NULL, " \t\n")) != NULL) {
+				if ((val = strchr(tok, '=')) == NULL) {
+					snprintf(retmsg, MAXPATHLEN, "qsub: %s line %d: bad attribute %s\n",
+						joblist_file, lineno, tok);
+					rc = 2;
+					break;
+				}
+				*val++ = '\0';
+				if ((resc = strchr(tok, '.')) != NULL) {
+					*resc++ = '\0';
+					set_attr_resc_error_exit(&jattr, tok, resc, val);
+				} else
+					set_attr_error_exit(&jattr, tok, val);
+			}
+			jobs[njobs++].attrib = (struct attropl *) jattr;
+			if (jobs[njobs - 1].script == NULL) {
+				snprintf(retmsg, MAXPATHLEN, "qsub: out of memory\n");
+				rc = 2;
+			}
+			if (rc != 0)
+				break;
+			if (njobs < PBS_MAX_SUBMITJOBLIST)
+				continue;
+		}
+		if (njobs == 0)
+			break;
+
+		pbs_errno = 0;
+		bss = pbs_submitjoblist(sd_svr, jobs, njobs, NULL);
+		if (bss == NULL) {
+			errmsg = pbs_geterrmsg(sd_svr);
+			if ((nsent == 0) && (errmsg != NULL) && (strcmp(errmsg, msg_force_qsub_update) == 0))
+				rc = PBSE_FORCE_QSUB_UPDATE;
+			else if (errmsg != NULL)
+				snprintf(retmsg, MAXPATHLEN, "qsub: %s\n", errmsg);
+			else
+				snprintf(retmsg, MAXPATHLEN, "qsub: Error (%d) submitting job list\n", pbs_errno);
+			if (rc == 0)
+				rc = pbs_errno ? pbs_errno : 1;
+			break;
+		}
+		nfail += report_joblist(jobs, njobs, bss);
+		pbs_submitstatfree(bss);
+		nsent += njobs;
+		njobs = 0;
+	}
+
+	/* jobs that were read but never sent */
+	while (njobs > 0) {
+		njobs--;
+		qsub_free_attrl((struct attrl *) jobs[njobs].attrib);
+		free(jobs[njobs].script);
+	}
+	free(jobs);
+	free(line);
+	fclose(fp);
+
+	if (rc != 0)
+		return rc;
+	return (nfail ? 1 : 0);
+}
+
 /**
  * @brief
  *	This functions does a job submission to the server using the global
@@ -2893,6 +3076,10 @@ do_submit(char *retmsg)
 		return 1;
 	}
 
+	/* Send the jobs of a --joblist file instead of the single job */
+	if (joblist_file != NULL)
+		return do_submit_joblist(retmsg);
+
 	/* Send submit request to the server. */
 	pbs_errno = 0;
 	if (cred_buf) {
@@ -3225,6 +3412,23 @@ main(int argc, char **argv, char **envp) /* qsub */
 	 */
 	PRINT_VERSION_AND_EXIT(argc, argv);
 
+	/* Pull out --joblist=file, which getopt would not accept */
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--") == 0)
+			break;
+		if (strncmp(argv[i], "--joblist=", 10) == 0) {
+			joblist_file = argv[i] + 10;
+			for (; i < argc; i++)
+				argv[i] = argv[i + 1];
+			argc--;
+			break;
+		}
+	}
+	if ((joblist_file != NULL) && (*joblist_file == '\0')) {
+		print_usage();
+		exit_qsub(2);
+	}
+
 	/*
 	 * Identify the configured tmpdir without calling pbs_loadconf().
 	 * We do not want to incur the cost of parsing the services DB.
@@ -3271,13 +3475,26 @@ main(int argc, char **argv, char **envp) /* qsub */
 		exit_qsub(2);
 	}
 	free(argv_cpy);
-	/* Process special arguments */
-	command_flag = process_special_args(argc, argv, script);
-	fix_path(script, 1);
+	if (joblist_file != NULL) {
+		/* the scripts are named in the job list, not on the command line */
+		if (optind < argc) {
+			print_usage();
+			exit_qsub(2);
+		}
+		if (Interact_opt || block_opt || cred_name[0]) {
+			fprintf(stderr, "qsub: --joblist cannot be used with -I, block or a credential\n");
+			exit_qsub(2);
+		}
+		no_background = 1;
+	} else {
+		/* Process special arguments */
+		command_flag = process_special_args(argc, argv, script);
+		fix_path(script, 1);
 
-	if (command_flag == 0)
-		/* Read the job script from a file or stdin */
-		read_job_script(script);
+		if (command_flag == 0)
+			/* Read the job script from a file or stdin */
+			read_job_script(script);
+	}
 
 	/* Enable X11 Forwarding or GUI if specified */
 	enable_gui();
@@ -3331,6 +3548,13 @@ main(int argc, char **argv, char **envp) /* qsub */
 	/* remove temporary job script file */
 	(void)unlink(script_tmp);
 
+	if (joblist_file != NULL) {
+		/* job ids and per job errors were already printed */
+		if (rc != 0)
+			fprintf(stderr, "%s", retmsg);
+		exit_qsub(rc);
+	}
+
 	if (rc == 0) { /* submit was successful */
 		new_jobname = retmsg;
 		if (!z_opt && Interact_opt == FALSE)
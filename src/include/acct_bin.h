@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#ifndef	_ACCT_BIN_H
+#define	_ACCT_BIN_H
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary accounting sidecar (PBS_ACCT_BINARY in pbs.conf).
+ *
+ * Next to each accounting file the server writes a file of the same name
+ * with ACCT_BIN_SUFFIX holding the same records in a compact form, read
+ * by pbs_acctread.  The file is a sequence of sections, one per time
+ * the server opened it.  A section starts with the ACCT_BIN_MAGIC_LEN
+ * bytes of ACCT_BIN_MAGIC and is followed by records:
+ *
+ *	byte	ACCT_BIN_REC
+ *	varint	length of the rest of the record
+ *	varint	time of the record, seconds since the epoch
+ *	byte	record type, as in acct.h
+ *	string	job, reservation or license id
+ *	varint	number of fields
+ *	fields
+ *
+ * A field is "key=value" of the text record.  Its key is a varint index
+ * into the keys of the section, 1 for the first; 0 means a new key
+ * follows as a string and is given the next index.  A word of the text
+ * with no '=' has the empty key.  Then comes a type byte and the value:
+ *
+ *	ACCT_BIN_STR	string
+ *	ACCT_BIN_INT	zigzag varint
+ *	ACCT_BIN_DUR	varint seconds of a [h]h:mm:ss value
+ *	ACCT_BIN_QSTR	quote character byte, then the unquoted string
+ *
+ * A varint is 7 bits per byte, low bits first, high bit set on all but
+ * the last byte.  A string is a varint length and that many bytes.
+ */
+#define ACCT_BIN_SUFFIX		".bin"
+#define ACCT_BIN_MAGIC		"PBSACB01"
+#define ACCT_BIN_MAGIC_LEN	8
+
+#define ACCT_BIN_REC		0x01
+
+#define ACCT_BIN_STR		0
+#define ACCT_BIN_INT		1
+#define ACCT_BIN_DUR		2
+#define ACCT_BIN_QSTR		3
+
+#ifdef	__cplusplus
+}
+#endif
+#endif	/* _ACCT_BIN_H */
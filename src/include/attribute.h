@@ -321,6 +321,8 @@ extern svrattrl *attrlist_alloc(int szname, int szresc, int szval);
 extern svrattrl *attrlist_create(char *aname, char *rname, int szval);
 extern void free_svrattrl(svrattrl *pal);
 extern void free_attrlist(pbs_list_head *attrhead);
+extern void attrlist_free(svrattrl *pal);
+extern int attrlist_pool_enable(int on);
 extern void free_svrcache(struct attribute *attr);
 extern int  attr_atomic_set(svrattrl *plist, attribute *old,
 	attribute *nattr, void *adef_idx, attribute_def *pdef, int limit,
@@ -56,6 +56,23 @@ struct rq_queuejob {
 	char rq_destin[PBS_MAXSVRRESVID + 1];
 	char rq_jid[PBS_MAXSVRJOBID + 1];
 	pbs_list_head rq_attr; /* svrattrlist */
+	char *rq_script;	/* script from a SubmitJobList, not owned */
+	size_t rq_scriptsz;
+};
+
+/* SubmitJobList - jobs queued and committed together */
+struct rq_quejoblist_job {
+	char rq_destin[PBS_MAXSVRRESVID + 1];
+	int rq_script;		/* index into rq_scripts, -1 if none */
+	pbs_list_head rq_attr;	/* svrattrlist */
+};
+
+struct rq_quejoblist {
+	int rq_nscripts;
+	char **rq_scripts;	/* each distinct script once */
+	size_t *rq_scriptsz;
+	int rq_count;
+	struct rq_quejoblist_job *rq_jobs;
 };
 
 /* JobCredential */
@@ -109,6 +126,17 @@ struct rq_deletejoblist {
 	char **rq_jobslist;
 };
 
+/* ManageJobList - hold, release, signal, alter or move many jobs */
+struct rq_managejoblist {
+	int rq_op;		/* JOBLIST_HOLD, ... */
+	int rq_count;		/* number of job ids */
+	char **rq_jobids;	/* job ids, or those selected by rq_selattr */
+	pbs_list_head rq_selattr;	/* svrattrlist, used if no job ids */
+	pbs_list_head rq_attr;	/* svrattrlist, hold types or attributes */
+	char *rq_arg;		/* signal name or destination */
+	int rq_next;		/* index of the next job to act on */
+};
+
 /* Management - used by PBS_BATCH_Manager requests */
 struct rq_management {
 	struct rq_manage rq_manager;
@@ -116,6 +144,14 @@ struct rq_management {
 	time_t rq_time;
 };
 
+/* ModifyNodes - alter many vnodes in one request */
+struct rq_modifynodes {
+	int rq_objtype;		/* MGR_OBJ_NODE or MGR_OBJ_HOST */
+	char *rq_nodes;		/* comma separated vnodes or hosts, may be empty */
+	pbs_list_head rq_selattr;	/* svrattrlist, vnodes must match all */
+	pbs_list_head rq_attr;	/* svrattrlist, attributes to alter */
+};
+
 /* ModifyVnode - used for node state changes */
 struct rq_modifyvnode {
 	struct pbsnode *rq_vnode_o; /* old/previous vnode state */
@@ -296,6 +332,7 @@ struct batch_request {
 		struct rq_auth rq_auth;
 		int rq_connect;
 		struct rq_queuejob rq_queuejob;
+		struct rq_quejoblist rq_quejoblist;
 		struct rq_jobcred rq_jobcred;
 		struct rq_jobfile rq_jobfile;
 		char rq_rdytocommit[PBS_MAXSVRJOBID + 1];
@@ -306,7 +343,9 @@ struct batch_request {
 		char rq_locate[PBS_MAXSVRJOBID + 1];
 		struct rq_manage rq_manager;
 		struct rq_management rq_management;
+		struct rq_managejoblist rq_managejoblist;
 		struct rq_modifyvnode rq_modifyvnode;
+		struct rq_modifynodes rq_modifynodes;
 		struct rq_message rq_message;
 		struct rq_relnodes rq_relnodes;
 		struct rq_py_spawn rq_py_spawn;
@@ -364,6 +403,8 @@ extern void req_connect(struct batch_request *);
 extern void req_defschedreply(struct batch_request *);
 extern void req_locatejob(struct batch_request *);
 extern void req_manager(struct batch_request *);
+extern void req_managejoblist(struct batch_request *);
+extern void req_modifynodes(struct batch_request *);
 extern void req_movejob(struct batch_request *);
 extern void req_register(struct batch_request *);
 extern void req_releasejob(struct batch_request *);
@@ -397,12 +438,15 @@ extern int decode_DIS_CopyHookFile(int, struct batch_request *);
 extern int decode_DIS_DelHookFile(int, struct batch_request *);
 extern int decode_DIS_JobObit(int, struct batch_request *);
 extern int decode_DIS_Manage(int, struct batch_request *);
+extern int decode_DIS_ManageJobList(int, struct batch_request *);
+extern int decode_DIS_ModifyNodes(int, struct batch_request *);
 extern int decode_DIS_DelJobList(int, struct batch_request *);
 extern int decode_DIS_MoveJob(int, struct batch_request *);
 extern int decode_DIS_MessageJob(int, struct batch_request *);
 extern int decode_DIS_ModifyResv(int, struct batch_request *);
 extern int decode_DIS_PySpawn(int, struct batch_request *);
 extern int decode_DIS_QueueJob(int, struct batch_request *);
+extern int decode_DIS_SubmitJobList(int, struct batch_request *);
 extern int decode_DIS_Register(int, struct batch_request *);
 extern int decode_DIS_RelnodesJob(int, struct batch_request *);
 extern int decode_DIS_ReqExtend(int, struct batch_request *);
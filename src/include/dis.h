@@ -126,6 +126,7 @@ signed char disrsc(int stream, int *retval);
 #endif
 
 char *disrcs(int stream, size_t *nchars, int *retval);
+int disrcsp(int stream, char **value, size_t *nchars);
 int disrfcs(int stream, size_t *nchars, size_t achars, char *value);
 char *disrst(int stream, int *retval);
 int disrfst(int stream, size_t achars, char *value);
@@ -202,6 +203,8 @@ extern const char *dis_emsg[];
 
 /* the following routines set/control DIS over tcp */
 extern void DIS_tcp_funcs();
+extern int DIS_tcp_prefetch(int);
+extern int DIS_tcp_pending(int);
 
 #define PBS_DIS_BUFSZ 8192
 
@@ -224,7 +227,11 @@ typedef struct pbs_tcp_auth_data {
 typedef struct pbs_tcp_chan {
 	pbs_dis_buf_t readbuf;
 	pbs_dis_buf_t writebuf;
+	pbs_dis_buf_t pendbuf; /* bytes read ahead from the socket by DIS_tcp_prefetch() */
 	int is_old_client; /* This is just for backward compatibility */
+	int dis_version; /* DIS_VERSION_2 once negotiated, else ASCII DIS */
+	void *dis2_rdict; /* DIS v2 string tokens of the pkt being read */
+	void *dis2_wdict; /* DIS v2 string tokens of the pkt being written */
 	pbs_tcp_auth_data_t auths[2];
 } pbs_tcp_chan_t;
 
@@ -237,6 +244,20 @@ int dis_puts(int, const char *, size_t);
 int dis_flush(int);
 void dis_setup_chan(int, pbs_tcp_chan_t * (*)(int));
 void dis_destroy_chan(int);
+int dis_pkt_complete(char *, size_t);
+int dis_fill_readbuf(int);
+
+/*
+ * Encodings of the dis* routines, chosen per channel.  Version 2 is a
+ * binary encoding a client offers in the extend of its Connect request
+ * (DIS_V2_OFFER) and uses once the server echoes the offer back.
+ */
+#define DIS_VERSION_1	1
+#define DIS_VERSION_2	2
+#define DIS_V2_OFFER	"dis_version=2"
+
+int dis_get_version(int);
+void dis_set_version(int, int);
 
 void transport_chan_set_ctx_status(int, int, int);
 int transport_chan_get_ctx_status(int, int);
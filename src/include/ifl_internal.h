@@ -80,6 +80,10 @@ char *__pbs_locjob(int, char *, char *);
 
 int __pbs_manager(int, int, int, char *, struct attropl *, char *);
 
+struct batch_deljob_status *__pbs_managejoblist(int, int, char **, int, struct attropl *, struct attrl *, char *, char *);
+
+int __pbs_modifynodes(int, int, char *, struct attropl *, struct attropl *, char *);
+
 int __pbs_movejob(int, char *, char *, char *);
 
 int __pbs_msgjob(int, char *, int, char *, char *);
@@ -100,12 +104,40 @@ void __pbs_statfree(struct batch_status *);
 
 void __pbs_delstatfree(struct batch_deljob_status *);
 
+void __pbs_submitstatfree(struct batch_submit_status *);
+
 struct batch_status *__pbs_statrsc(int, char *, struct attrl *, char *);
 
 struct batch_status *__pbs_statjob(int, char *, struct attrl *, char *);
 
 struct batch_status *__pbs_selstat(int, struct attropl *, struct attrl *, char *);
 
+struct pbs_statstream *__pbs_statjob_stream(int, char *, struct attrl *, char *);
+
+struct pbs_statstream *__pbs_selstat_stream(int, struct attropl *, struct attrl *, char *);
+
+struct batch_status *__pbs_statstream_next(struct pbs_statstream *);
+
+struct batch_status *__pbs_statstream_nextn(struct pbs_statstream *, int);
+
+int __pbs_statstream_close(struct pbs_statstream *);
+
+struct pbs_connpool *__pbs_connpool_create(char *, int, int);
+
+int __pbs_connpool_get(struct pbs_connpool *);
+
+int __pbs_connpool_put(struct pbs_connpool *, int);
+
+void __pbs_connpool_destroy(struct pbs_connpool *);
+
+int __pbs_pipe_stat(int, int, char *, struct attrl *, char *);
+
+int __pbs_pipe_selstat(int, struct attropl *, struct attrl *, char *);
+
+struct batch_status *__pbs_pipe_recv(int, int);
+
+int __pbs_pipe_pending(int);
+
 struct batch_status *__pbs_statque(int, char *, struct attrl *, char *);
 
 struct batch_status *__pbs_statserver(int, struct attrl *, char *);
@@ -118,6 +150,8 @@ struct batch_status *__pbs_statnode(int, char *, struct attrl *, char *);
 
 struct batch_status *__pbs_statvnode(int, char *, struct attrl *, char *);
 
+struct batch_status *__pbs_statnodesummary(int, char *, struct attrl *, char *);
+
 struct batch_status *__pbs_statresv(int, char *, struct attrl *, char *);
 
 struct batch_status *__pbs_stathook(int, char *, struct attrl *, char *);
@@ -126,6 +160,8 @@ struct ecl_attribute_errors * __pbs_get_attributes_in_error(int);
 
 char *__pbs_submit(int, struct attropl *, char *, char *, char *);
 
+struct batch_submit_status *__pbs_submitjoblist(int, struct batch_submit_job *, int, char *);
+
 char *__pbs_submit_resv(int, struct attropl *, char *);
 
 int __pbs_delresv(int, char *, char *);
@@ -337,14 +337,17 @@ typedef struct	noderes {
  * specific structures for Job Array attributes
  */
 
-/* individual entries in array job index table */
+/*
+ * individual entries in array job index table, kept small as there is one
+ * per subjob; the instantiated subjobs are found through tkm_subjobs,
+ * see get_subjob_ptr()
+ */
 struct ajtrk {
-	char trk_status;		 /* status */
+	char trk_status;	 /* status */
+	char trk_exitstat;	 /* if executed and exitstat set */
+	short trk_substate;	 /* sub state */
+	short trk_stgout;	 /* stageout status */
 	int trk_error;		 /* error code */
-	int trk_exitstat;	 /* if executed and exitstat set */
-	int trk_substate;	 /* sub state */
-	int trk_stgout;		 /* stageout status */
-	struct job *trk_psubjob; /* pointer to instantiated subjob */
 };
 
 /* subjob index table */
@@ -358,6 +361,7 @@ struct ajtrkhd {
 	int tkm_subjsct[PBS_NUMJOBSTATE]; /* count of subjobs in various states */
 	int tkm_dsubjsct;		  /* count of deleted subjobs */
 	range *trk_rlist;			/* pointer to range list */
+	void *tkm_subjobs;		  /* index of instantiated subjobs by table offset */
 	struct ajtrk tkm_tbl[1];	  /* ptr to array of individual entries */
 	/*
 	 * when table is malloced, room for the additional required number
@@ -384,6 +388,7 @@ struct jbdscrd {
 #define TKMFLG_NO_DELETE           0x01
 #define TKMFLG_REVAL_IND_REMAINING 0x02 /* Flag to re-evaluate "array_indices_remaining" */
 #define TKMFLG_CHK_ARRAY           0x04 /* chk_array_doneness() already in call stack*/
+#define TKMFLG_REVAL_STATE_CT      0x08 /* Flag to re-evaluate "array_state_count" */
 
 /* Structure for block job reply processing */
 struct block_job_reply {
@@ -450,6 +455,7 @@ struct job {
 	struct batch_request *ji_rerun_preq; /* outstanding rerun request */
 #ifdef PBS_MOM
 	void *ji_pending_ruu;			    /* pending last update */
+	void *ji_resc_used_sent;		    /* resources_used last sent to Server */
 	struct batch_request *ji_preq;		    /* outstanding request */
 	struct grpcache *ji_grpcache;		    /* cache of user's groups */
 	enum PBS_Chkpt_By ji_chkpttype;		    /* checkpoint type  */
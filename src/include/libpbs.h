@@ -121,6 +121,7 @@ typedef struct pbs_conn {
 	char *ch_errtxt;	  /* pointer to last server error text	*/
 	pthread_mutex_t ch_mutex; /* serialize connection between threads */
 	pbs_tcp_chan_t *ch_chan;  /* pointer tcp chan structure for this connection */
+	void *ch_pipe;		  /* pipelined status requests, see pbsD_pipeline.c */
 } pbs_conn_t;
 
 int destroy_connection(int);
@@ -131,6 +132,9 @@ int get_conn_errno(int);
 pbs_tcp_chan_t * get_conn_chan(int);
 int set_conn_chan(int, pbs_tcp_chan_t *);
 pthread_mutex_t * get_conn_mutex(int);
+void * get_conn_pipe(int);
+int set_conn_pipe(int, void *);
+void PBSD_pipe_free(void *);
 
 #define SVR_CONN_STATE_DOWN 0
 #define SVR_CONN_STATE_UP 1
@@ -198,6 +202,7 @@ typedef struct rq_preempt brp_preempt_jobs;
 #define BATCH_REPLY_CHOICE_RescQuery	9	/* Resource Query */
 #define BATCH_REPLY_CHOICE_PreemptJobs	10	/* Preempt Job */
 #define BATCH_REPLY_CHOICE_Delete		11  /* Delete Job status */
+#define BATCH_REPLY_CHOICE_SubmitList	12  /* Submit Job List status */
 
 /*
  * the following is the basic Batch Reply structure
@@ -221,6 +226,7 @@ struct batch_reply
 			int tot_arr_jobs;
 			struct batch_deljob_status *brp_delstatc;	
 		} brp_deletejoblist;
+		struct batch_submit_status *brp_substatc; /* submit job list replies */
 		struct {
 			int brp_txtlen;
 			char *brp_str;
@@ -231,6 +237,17 @@ struct batch_reply
 	} brp_un;
 };
 
+/*
+ * where decode_DIS_attrl_alloc() and decode_DIS_status_obj() take the
+ * attrl structures and strings they decode into from
+ */
+struct dis_attrl_alloc
+{
+	struct attrl *(*da_attrl)(void *ctx);		/* a zeroed attrl */
+	char *(*da_str)(int sock, void *ctx, int *rc);	/* a string read off sock */
+	void *da_ctx;
+};
+
 /*
  * The Batch Request ID numbers
  */
@@ -306,6 +323,16 @@ struct batch_reply
 #define PBS_BATCH_RegisterSched	98
 #define PBS_BATCH_ModifyVnode       99
 #define PBS_BATCH_DeleteJobList	100
+#define PBS_BATCH_SubmitJobList	101
+#define PBS_BATCH_StatusNodeSummary	102
+#define PBS_BATCH_ModifyNodes	103
+#define PBS_BATCH_ManageJobList	104
+
+/* most jobs a single Submit Job List request may carry */
+#define PBS_MAX_SUBMITJOBLIST	10000
+
+/* most job ids a single Manage Job List request may carry */
+#define PBS_MAX_MANAGEJOBLIST	100000
 
 #define PBS_BATCH_FileOpt_Default	0
 #define PBS_BATCH_FileOpt_OFlg		1
@@ -345,6 +372,7 @@ int PBSD_mgr_put(int, int, int, int, char *, struct attropl *, char *, int, char
 int PBSD_deljoblist_put(int, int, char **, int, char *, int, char **);
 int PBSD_manager(int, int, int, int, char *, struct attropl *, char *);
 struct batch_deljob_status *PBSD_deljoblist(int, int, char **, int, char *);
+int PBSD_submitjoblist_put(int, char **, size_t *, int, struct batch_submit_job *, int *, int, char *);
 int PBSD_msg_put(int, char *, int, char *, char *, int, char **);
 int PBSD_relnodes_put(int, char *, char *, char *, int, char **);
 int PBSD_py_spawn_put(int, char *, char **, char **, int, char **);
@@ -359,13 +387,18 @@ void PBSD_FreeReply(struct batch_reply *);
 struct batch_status *PBSD_status(int, int, char *, struct attrl *, char *);
 struct batch_status *PBSD_status_random(int c, int function, char *id, struct attrl *attrib, char *extend, int parent_object);
 struct batch_status *PBSD_status_aggregate(int c, int cmd, char *id, void *attrib, char *extend, int parent_object, struct attrl *);
+int PBSD_status_send(int c, int cmd, char *id, void *attrib, char *extend, int parent_object, struct attrl *rattrib, int *sent);
+void PBSD_status_merge(struct batch_status **ret, struct batch_status **last, struct batch_status *next, struct batch_status *next_last, int parent_object);
 extern int random_srv_conn(svr_conn_t *);
 preempt_job_info *PBSD_preempt_jobs(int, char **);
 struct batch_status *PBSD_status_get(int, struct batch_status **last);
 char *PBSD_queuejob(int, char *, char *, struct attropl *, char *, int, char **, int *);
 int decode_DIS_svrattrl(int, pbs_list_head *);
 int decode_DIS_attrl(int, struct attrl **);
+int decode_DIS_attrl_alloc(int, struct attrl **, struct dis_attrl_alloc *);
+int decode_DIS_status_obj(int, struct batch_status *, struct dis_attrl_alloc *);
 int decode_DIS_JobId(int, char *);
+int decode_DIS_replyHdr(int, struct batch_reply *);
 int decode_DIS_replyCmd(int, struct batch_reply *);
 int encode_DIS_JobCred(int, int, char *, int);
 int encode_DIS_UserCred(int, char *, int, char *, int);
@@ -392,6 +425,9 @@ int encode_DIS_attropl(int, struct attropl *);
 int encode_DIS_CopyHookFile(int, int, char *, int, char *);
 int encode_DIS_DelHookFile(int, char *);
 int encode_DIS_JobsList(int, char **, int);
+int encode_DIS_SubmitJobList(int, char **, size_t *, int, struct batch_submit_job *, int *, int);
+int encode_DIS_ModifyNodes(int, int, char *, struct attropl *, struct attropl *);
+int encode_DIS_ManageJobList(int, int, char **, int, struct attropl *, struct attropl *, char *);
 char *PBSD_submit_resv(int, char *, struct attropl *, char *);
 int DIS_reply_read(int, struct batch_reply *, int);
 int tcp_pre_process(conn_t *);
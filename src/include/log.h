@@ -123,6 +123,8 @@ extern void log_suspect_file(const char *func, const char *text, const char *fil
 extern int  log_open(char *name, char *directory);
 extern int  log_open_main(char *name, char *directory, int silent);
 extern void log_record(int type, int objclass, int severity, const char *objname, const char *text);
+extern int  log_async_start(unsigned int nslots);
+extern void log_async_flush(void);
 extern char log_buffer[LOG_BUF_SIZE];
 extern int log_level_2_etype(int level);
 
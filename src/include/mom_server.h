@@ -54,6 +54,17 @@ extern "C" {
  * These are from Mom to Server only and only via TPP
  */
 
+/*
+ * Numeric resources_used values are carried in binary form by IS_RESCUSED2
+ * instead of as encoded svrattrl strings, and are set directly by the Server.
+ */
+#define RUU_RESC_NAMELEN	64
+typedef struct ruu_num {
+	char rn_name[RUU_RESC_NAMELEN];	/* resource name */
+	int rn_type;			/* ATR_TYPE_LONG, ATR_TYPE_SIZE or ATR_TYPE_FLOAT */
+	union attr_val rn_val;		/* the value */
+} ruu_num;
+
 typedef struct resc_used_update ruu;
 struct resc_used_update {
 	ruu *ru_next;
@@ -62,6 +73,8 @@ struct resc_used_update {
 	int ru_status;			/* job exit status (or zero) */
 	int ru_hop;			/* hop/run count of job	*/
 	pbs_list_head ru_attr;		/* list of svrattrl */
+	int ru_nnum;			/* number of entries in ru_num */
+	ruu_num *ru_num;		/* binary numeric resources_used values */
 #ifdef PBS_MOM
 	time_t ru_created_at;		/* time in epoch at which this ruu was created */
 	job *ru_pjob;			/* pointer to job structure for this ruu */
@@ -79,6 +92,7 @@ do { \
 	} \
 	delete_link(&x->ru_pending); \
 	free_attrlist(&x->ru_attr); \
+	if (x->ru_num) free(x->ru_num); \
 	if (x->ru_pjobid) free(x->ru_pjobid); \
 	if (x->ru_comment) free(x->ru_comment); \
 	free(x); \
@@ -87,6 +101,7 @@ do { \
 #define FREE_RUU(x) \
 do { \
 	free_attrlist(&x->ru_attr); \
+	if (x->ru_num) free(x->ru_num); \
 	if (x->ru_pjobid) free(x->ru_pjobid); \
 	if (x->ru_comment) free(x->ru_comment); \
 	free(x); \
@@ -97,6 +112,9 @@ extern int job_obit(ruu *, int);
 extern int enqueue_update_for_send(job *, int);
 extern void send_resc_used(int cmd, int count, ruu *rud);
 extern void send_pending_updates(void);
+extern void reset_resc_used_delta(void);
+extern int resc_used_delta;
+extern int server_rescused2;
 extern char mom_short_name[];
 
 #ifdef _PBS_JOB_H
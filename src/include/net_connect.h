@@ -116,6 +116,14 @@ typedef unsigned long pbs_net_t;        /* for holding host addresses */
 #define IS_HOOK_CHECKSUMS               20 /* mom reports about hooks seen */
 #define IS_UPDATE_FROM_HOOK2            21 /* request to update vnodes from a hook running on a parent mom host or an allowed non-parent mom host */
 #define IS_HELLOSVR                     22 /* hello send to server from mom to initiate a hello sequence */
+#define IS_RESCUSED2                    23 /* resource usage update with binary numeric values */
+
+/*
+ * Feature bits the Server appends to IS_REPLYHELLO, after the cluster
+ * addresses.  Older Moms discard the trailing word with the rest of the
+ * message, and Moms treat a missing word as no features.
+ */
+#define IS_FEAT_RESCUSED2               0x1 /* Server accepts IS_RESCUSED2 */
 
 /* return codes for client_to_svr() */
 
@@ -198,6 +206,7 @@ void net_close(int);
 int  wait_request(float waittime, void *priority_context);
 extern void *priority_context;
 void net_add_close_func(int, void(*)(int));
+void net_set_pending_func(int (*)(int));
 extern  pbs_net_t  get_addr_of_nodebyname(char *name, unsigned int *port);
 
 conn_t *get_conn(int sock); /* gets the connection, for a given socket id */
@@ -218,6 +227,9 @@ struct connection {
 	void		(*cn_func)(int); /* read function when data rdy */
 	void		(*cn_oncl)(int); /* func to call on close */
 	unsigned short	cn_prio_flag;	/* flag for a priority socket */
+	unsigned short	cn_pending;	/* a whole request is buffered, see net_set_pending_func() */
+	unsigned short	cn_nserved;	/* requests served during wakeup cn_wakeup */
+	unsigned long	cn_wakeup;	/* wait_request() wakeup cn_nserved counts for */
 	pbs_list_link   cn_link;  /* link to the next connection in the linked list */
 	/* following attributes are for */
 	/* credential checking */
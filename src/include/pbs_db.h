@@ -76,6 +76,10 @@ extern "C" {
 
 #define PBS_MAX_DB_CONN_INIT_ERR  (MAXPATHLEN*2)
 
+/* how to end a transaction - see pbs_db_end_trx */
+#define PBS_DB_COMMIT	0
+#define PBS_DB_ROLLBACK	1
+
 /* type of saves bit wise flags - see savetype */
 #define OBJ_SAVE_NEW    1   /* object is new, so whole object should be saved */
 #define OBJ_SAVE_QS     2   /* quick save area modified, it should be saved */
@@ -403,6 +407,40 @@ int pbs_db_delete_attr_obj(void *conn, pbs_db_obj_info_t *obj, void *obj_id, pbs
  */
 int pbs_db_search(void *conn, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts, query_cb_t query_cb);
 
+/* time spent in the phases of pbs_db_search_parallel, in seconds */
+struct pbs_db_search_stats {
+	double ss_query;	/* running the query and fetching all rows */
+	double ss_wait;		/* caller waiting for rows to be decoded */
+	double ss_callback;	/* caller running the callback */
+	int ss_workers;		/* decode threads used */
+};
+typedef struct pbs_db_search_stats pbs_db_search_stats_t;
+
+/**
+ * @brief
+ *	Same as pbs_db_search, but rows are decoded into their attribute lists
+ *	by a pool of threads, while the callback is still called in row order
+ *	on the calling thread.
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	pbs_db_obj_info_t - The pointer to the wrapper object which
+ *				describes the PBS object (job/resv/node etc) that is wrapped
+ *				inside it.
+ * @param[in]	pbs_db_query_options_t - Pointer to the options object that can
+ *				contain the flags or timestamp which will effect the query.
+ * @param[in]	callback function which will process the result from the database
+ * 				and update the server strctures. It must free the attribute list.
+ * @param[in]	nworkers - number of decode threads to use
+ * @param[out]	stats - time spent per phase, may be NULL
+ *
+ * @return	int
+ * @retval	0	- Success but no rows found
+ * @retval	-1	- Failure
+ * @retval	>0	- Success and number of rows found
+ *
+ */
+int pbs_db_search_parallel(void *conn, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts, query_cb_t query_cb, int nworkers, pbs_db_search_stats_t *stats);
+
 /**
  * @brief
  *	Load a single existing object from the database
@@ -458,6 +496,46 @@ int pbs_start_db(char *pbs_ds_host, int pbs_ds_port);
  */
 int pbs_stop_db(char *pbs_ds_host, int pbs_ds_port);
 
+/**
+ * @brief
+ *	Start a (possibly nested) transaction on the connection
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return      Error code
+ * @retval	-1  - Failure
+ * @retval	 0  - Success
+ *
+ */
+int pbs_db_begin_trx(void *conn);
+
+/**
+ * @brief
+ *	End a transaction started with pbs_db_begin_trx
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	commit - PBS_DB_COMMIT or PBS_DB_ROLLBACK
+ *
+ * @return      Error code
+ * @retval	-1  - Failure, or the transaction was rolled back
+ * @retval	 0  - Success
+ *
+ */
+int pbs_db_end_trx(void *conn, int commit);
+
+/**
+ * @brief
+ *	Tell whether a transaction is open on the connection
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return      int
+ * @retval	1  - a transaction is open
+ * @retval	0  - no transaction is open
+ *
+ */
+int pbs_db_in_trx(void *conn);
+
 /**
  * @brief
  *	Translates the error code to an error message
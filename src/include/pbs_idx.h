@@ -45,6 +45,7 @@ extern "C" {
 
 #define PBS_IDX_DUPS_OK     0x01 /* duplicate key allowed in index */
 #define PBS_IDX_ICASE_CMP   0x02 /* set case-insensitive compare */
+#define PBS_IDX_HASH        0x04 /* hash table, faster lookups but unordered iteration */
 
 #define PBS_IDX_RET_OK    0 /* index op succeed */
 #define PBS_IDX_RET_FAIL -1 /* index op failed */
@@ -53,7 +54,8 @@ extern "C" {
  * @brief
  *	Create an empty index
  *
- * @param[in] - dups   - Whether duplicates are allowed or not in index
+ * @param[in] - flags  - PBS_IDX_* flags: duplicates allowed, case-insensitive
+ *                       compare, hash table instead of tree
  * @param[in] - keylen - length of key in index (can be 0 for default size)
  *
  * @return void *
@@ -138,6 +140,8 @@ extern int pbs_idx_delete_byctx(void *ctx);
  *
  * @note
  * 	ctx should be free'd after use, using pbs_idx_free_ctx()
+ *	Iteration over a PBS_IDX_HASH index is in no particular order,
+ *	and must not be mixed with inserts into the index.
  *
  */
 extern int pbs_idx_find(void *idx, void **key, void **data, void **ctx);
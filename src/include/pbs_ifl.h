@@ -445,6 +445,16 @@ enum mgr_obj {
 	MGR_OBJ_LAST		/* Last entry	*/
 };
 
+/* operations of a pbs_managejoblist() call */
+enum joblist_op {
+	JOBLIST_HOLD,		/* set holds, like pbs_holdjob()	*/
+	JOBLIST_RELEASE,	/* release holds, like pbs_rlsjob()	*/
+	JOBLIST_SIGNAL,		/* send a signal, like pbs_sigjob()	*/
+	JOBLIST_ALTER,		/* alter attributes, like pbs_alterjob() */
+	JOBLIST_MOVE,		/* move, like pbs_movejob()		*/
+	JOBLIST_LAST
+};
+
 #define	MGR_OBJ_SITE_HOOK	MGR_OBJ_HOOK
 #define	SITE_HOOK		"hook"
 #define	PBS_HOOK		"pbshook"
@@ -534,6 +544,27 @@ struct batch_deljob_status {
 	int	code;
 };
 
+/* one job of a pbs_submitjoblist() call */
+struct batch_submit_job {
+	struct attropl	*attrib;	/* job attributes */
+	char	*script;		/* path of job script, NULL if none */
+	char	*destination;		/* queue/server, NULL for default */
+};
+
+/* per job result of a pbs_submitjoblist() call, in submission order */
+struct batch_submit_status {
+	struct batch_submit_status *next;
+	char	*jobid;		/* new job id, NULL if the job was rejected */
+	int	code;		/* PBSE_NONE or the reason for the rejection */
+	char	*text;		/* error message, NULL if none */
+};
+
+/* an open pbs_statjob_stream()/pbs_selstat_stream() reply, opaque */
+struct pbs_statstream;
+
+/* a pool of server connections, see pbs_connpool_create(), opaque */
+struct pbs_connpool;
+
 /* structure to hold an attribute that failed verification at ECL
  * and the associated errcode and errmsg
  */
@@ -623,6 +654,10 @@ DECLDIR char *pbs_locjob(int, char *, char *);
 
 DECLDIR int pbs_manager(int, int, int, char *, struct attropl *, char *);
 
+DECLDIR struct batch_deljob_status *pbs_managejoblist(int, int, char **, int, struct attropl *, struct attrl *, char *, char *);
+
+DECLDIR int pbs_modifynodes(int, int, char *, struct attropl *, struct attropl *, char *);
+
 DECLDIR int pbs_movejob(int, char *, char *, char *);
 
 DECLDIR int pbs_msgjob(int, char *, int, char *, char *);
@@ -649,6 +684,32 @@ DECLDIR struct batch_status *pbs_statjob(int, char *, struct attrl *, char *);
 
 DECLDIR struct batch_status *pbs_selstat(int, struct attropl *, struct attrl *, char *);
 
+DECLDIR struct pbs_statstream *pbs_statjob_stream(int, char *, struct attrl *, char *);
+
+DECLDIR struct pbs_statstream *pbs_selstat_stream(int, struct attropl *, struct attrl *, char *);
+
+DECLDIR struct batch_status *pbs_statstream_next(struct pbs_statstream *);
+
+DECLDIR struct batch_status *pbs_statstream_nextn(struct pbs_statstream *, int);
+
+DECLDIR int pbs_statstream_close(struct pbs_statstream *);
+
+DECLDIR struct pbs_connpool *pbs_connpool_create(char *, int, int);
+
+DECLDIR int pbs_connpool_get(struct pbs_connpool *);
+
+DECLDIR int pbs_connpool_put(struct pbs_connpool *, int);
+
+DECLDIR void pbs_connpool_destroy(struct pbs_connpool *);
+
+DECLDIR int pbs_pipe_stat(int, int, char *, struct attrl *, char *);
+
+DECLDIR int pbs_pipe_selstat(int, struct attropl *, struct attrl *, char *);
+
+DECLDIR struct batch_status *pbs_pipe_recv(int, int);
+
+DECLDIR int pbs_pipe_pending(int);
+
 DECLDIR struct batch_status *pbs_statque(int, char *, struct attrl *, char *);
 
 DECLDIR struct batch_status *pbs_statserver(int, struct attrl *, char *);
@@ -661,6 +722,8 @@ DECLDIR struct batch_status *pbs_statnode(int, char *, struct attrl *, char *);
 
 DECLDIR struct batch_status *pbs_statvnode(int, char *, struct attrl *, char *);
 
+DECLDIR struct batch_status *pbs_statnodesummary(int, char *, struct attrl *, char *);
+
 DECLDIR struct batch_status *pbs_statresv(int, char *, struct attrl *, char *);
 
 DECLDIR struct batch_status *pbs_stathook(int , char *, struct attrl *, char *);
@@ -669,6 +732,10 @@ DECLDIR struct ecl_attribute_errors * pbs_get_attributes_in_error(int);
 
 DECLDIR char *pbs_submit(int, struct attropl *, char *, char *, char *);
 
+DECLDIR struct batch_submit_status *pbs_submitjoblist(int, struct batch_submit_job *, int, char *);
+
+DECLDIR void pbs_submitstatfree(struct batch_submit_status *);
+
 DECLDIR char *pbs_submit_resv(int, struct attropl *, char *);
 
 DECLDIR int pbs_delresv(int, char *, char *);
@@ -711,6 +778,10 @@ extern int pbs_disconnect(int);
 
 extern int pbs_manager(int, int, int, char *, struct attropl *, char *);
 
+extern struct batch_deljob_status *pbs_managejoblist(int, int, char **, int, struct attropl *, struct attrl *, char *, char *);
+
+extern int pbs_modifynodes(int, int, char *, struct attropl *, struct attropl *, char *);
+
 extern char *pbs_default(void);
 
 extern int pbs_deljob(int, char *, char *);
@@ -747,12 +818,40 @@ extern void pbs_statfree(struct batch_status *);
 
 extern void pbs_delstatfree(struct batch_deljob_status *);
 
+extern void pbs_submitstatfree(struct batch_submit_status *);
+
 extern struct batch_status *pbs_statrsc(int, char *, struct attrl *, char *);
 
 extern struct batch_status *pbs_statjob(int, char *, struct attrl *, char *);
 
 extern struct batch_status *pbs_selstat(int, struct attropl *, struct attrl *, char *);
 
+extern struct pbs_statstream *pbs_statjob_stream(int, char *, struct attrl *, char *);
+
+extern struct pbs_statstream *pbs_selstat_stream(int, struct attropl *, struct attrl *, char *);
+
+extern struct batch_status *pbs_statstream_next(struct pbs_statstream *);
+
+extern struct batch_status *pbs_statstream_nextn(struct pbs_statstream *, int);
+
+extern int pbs_statstream_close(struct pbs_statstream *);
+
+extern struct pbs_connpool *pbs_connpool_create(char *, int, int);
+
+extern int pbs_connpool_get(struct pbs_connpool *);
+
+extern int pbs_connpool_put(struct pbs_connpool *, int);
+
+extern void pbs_connpool_destroy(struct pbs_connpool *);
+
+extern int pbs_pipe_stat(int, int, char *, struct attrl *, char *);
+
+extern int pbs_pipe_selstat(int, struct attropl *, struct attrl *, char *);
+
+extern struct batch_status *pbs_pipe_recv(int, int);
+
+extern int pbs_pipe_pending(int);
+
 extern struct batch_status *pbs_statque(int, char *, struct attrl *, char *);
 
 extern struct batch_status *pbs_statserver(int, struct attrl *, char *);
@@ -765,6 +864,8 @@ extern struct batch_status *pbs_statnode(int, char *, struct attrl *, char *);
 
 extern struct batch_status *pbs_statvnode(int, char *, struct attrl *, char *);
 
+extern struct batch_status *pbs_statnodesummary(int, char *, struct attrl *, char *);
+
 extern struct batch_status *pbs_statresv(int, char *, struct attrl *, char *);
 
 extern struct batch_status *pbs_stathook(int, char *, struct attrl *, char *);
@@ -773,6 +874,8 @@ extern struct ecl_attribute_errors * pbs_get_attributes_in_error(int);
 
 extern char *pbs_submit(int, struct attropl *, char *, char *, char *);
 
+extern struct batch_submit_status *pbs_submitjoblist(int, struct batch_submit_job *, int, char *);
+
 extern char *pbs_submit_resv(int, struct attropl *, char *);
 
 extern int pbs_delresv(int, char *, char *);
@@ -801,6 +904,8 @@ extern int (*pfn_pbs_holdjob)(int, char *, char *, char *);
 extern int (*pfn_pbs_loadconf)(int);
 extern char *(*pfn_pbs_locjob)(int, char *, char *);
 extern int (*pfn_pbs_manager)(int, int, int, char *, struct attropl *, char *);
+extern struct batch_deljob_status *(*pfn_pbs_managejoblist)(int, int, char **, int, struct attropl *, struct attrl *, char *, char *);
+extern int (*pfn_pbs_modifynodes)(int, int, char *, struct attropl *, struct attropl *, char *);
 extern int (*pfn_pbs_movejob)(int, char *, char *, char *);
 extern int (*pfn_pbs_msgjob)(int, char *, int, char *, char *);
 extern int (*pfn_pbs_orderjob)(int, char *, char *, char *);
@@ -811,19 +916,35 @@ extern char **(*pfn_pbs_selectjob)(int, struct attropl *, char *);
 extern int (*pfn_pbs_sigjob)(int, char *, char *, char *);
 extern void (*pfn_pbs_statfree)(struct batch_status *);
 extern void (*pfn_pbs_delstatfree)(struct batch_deljob_status *);
+extern void (*pfn_pbs_submitstatfree)(struct batch_submit_status *);
 extern struct batch_status *(*pfn_pbs_statrsc)(int, char *, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_statjob)(int, char *, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_selstat)(int, struct attropl *, struct attrl *, char *);
+extern struct pbs_statstream *(*pfn_pbs_statjob_stream)(int, char *, struct attrl *, char *);
+extern struct pbs_statstream *(*pfn_pbs_selstat_stream)(int, struct attropl *, struct attrl *, char *);
+extern struct batch_status *(*pfn_pbs_statstream_next)(struct pbs_statstream *);
+extern struct batch_status *(*pfn_pbs_statstream_nextn)(struct pbs_statstream *, int);
+extern int (*pfn_pbs_statstream_close)(struct pbs_statstream *);
+extern struct pbs_connpool *(*pfn_pbs_connpool_create)(char *, int, int);
+extern int (*pfn_pbs_connpool_get)(struct pbs_connpool *);
+extern int (*pfn_pbs_connpool_put)(struct pbs_connpool *, int);
+extern void (*pfn_pbs_connpool_destroy)(struct pbs_connpool *);
+extern int (*pfn_pbs_pipe_stat)(int, int, char *, struct attrl *, char *);
+extern int (*pfn_pbs_pipe_selstat)(int, struct attropl *, struct attrl *, char *);
+extern struct batch_status *(*pfn_pbs_pipe_recv)(int, int);
+extern int (*pfn_pbs_pipe_pending)(int);
 extern struct batch_status *(*pfn_pbs_statque)(int, char *, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_statserver)(int, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_statsched)(int, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_stathost)(int, char *, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_statnode)(int, char *, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_statvnode)(int, char *, struct attrl *, char *);
+extern struct batch_status *(*pfn_pbs_statnodesummary)(int, char *, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_statresv)(int, char *, struct attrl *, char *);
 extern struct batch_status *(*pfn_pbs_stathook)(int, char *, struct attrl *, char *);
 extern struct ecl_attribute_errors * (*pfn_pbs_get_attributes_in_error)(int);
 extern char *(*pfn_pbs_submit)(int, struct attropl *, char *, char *, char *);
+extern struct batch_submit_status *(*pfn_pbs_submitjoblist)(int, struct batch_submit_job *, int, char *);
 extern char *(*pfn_pbs_submit_resv)(int, struct attropl *, char *);
 extern int (*pfn_pbs_delresv)(int, char *, char *);
 extern int (*pfn_pbs_terminate)(int, int, char *);
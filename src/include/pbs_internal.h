@@ -246,6 +246,10 @@ struct pbs_config
 	unsigned pbs_use_compression:1;	/* whether pbs should compress communication data */
 	unsigned pbs_use_mcast:1;		/* whether pbs should multicast communication */
 	unsigned pbs_use_ft:1;		/* whether pbs should force use fault tolerant communications */
+	unsigned pbs_tpp_compact_mcast:1;	/* whether to send mcast member lists in the compact format */
+	char *pbs_compression_algo;		/* compression algorithm for communication data (zlib, lz4, zstd) */
+	unsigned int pbs_compression_min_size;	/* messages smaller than this many bytes are not compressed */
+	unsigned pbs_compression_dict:1;	/* whether to use the preset dictionary when compressing */
 	char *pbs_leaf_name;			/* non-default name of this leaf in the communication network */
 	char *pbs_leaf_routers;		/* for this leaf, the optional list of routers to talk to */
 	char *pbs_comm_name;			/* non-default name of this router in the communication network */
@@ -255,7 +259,13 @@ struct pbs_config
 	char *pbs_mom_node_name;	/* mom short name used for natural node, default NULL */
 	char *pbs_lr_save_path;		/* path to store undo live recordings */
 	unsigned int pbs_log_highres_timestamp; /* high resolution logging */
+	unsigned int pbs_log_async;	/* records queued for the log writer thread, 0 to log synchronously */
 	unsigned int pbs_sched_threads;	/* number of threads for scheduler */
+	unsigned int pbs_dis_version;	/* highest DIS encoding offered/accepted on batch connections */
+	unsigned int pbs_stat_instance_timeout;	/* seconds a server instance has to start its status reply, 0 for no limit */
+	unsigned int pbs_qstat_cache_ttl;	/* seconds qstat may reuse a cached job status, 0 for no cache */
+	unsigned pbs_acct_async:1;	/* write accounting records from a background thread */
+	unsigned pbs_acct_binary:1;	/* also write accounting records to a binary sidecar file */
 	char *pbs_daemon_service_user; /* user the scheduler runs as */
 	char current_user[PBS_MAXUSER+1]; /* current running user */
 #ifdef WIN32
@@ -287,8 +297,12 @@ extern struct pbs_config pbs_conf;
 #define PBS_CONF_DATA_SERVICE_PORT           "PBS_DATA_SERVICE_PORT"
 #define PBS_CONF_DATA_SERVICE_HOST           "PBS_DATA_SERVICE_HOST"
 #define PBS_CONF_USE_COMPRESSION     	     "PBS_USE_COMPRESSION"
+#define PBS_CONF_COMPRESSION_ALGO	     "PBS_COMPRESSION_ALGORITHM"
+#define PBS_CONF_COMPRESSION_MIN_SIZE	     "PBS_COMPRESSION_MIN_SIZE"
+#define PBS_CONF_COMPRESSION_DICT	     "PBS_COMPRESSION_DICTIONARY"
 #define PBS_CONF_USE_MCAST		     "PBS_USE_MCAST"
 #define PBS_CONF_FORCE_FT_COMM		     "PBS_FORCE_FT_COMM"
+#define PBS_CONF_TPP_COMPACT_MCAST	     "PBS_TPP_COMPACT_MCAST"
 #define PBS_CONF_LEAF_NAME		     "PBS_LEAF_NAME"
 #define PBS_CONF_LEAF_ROUTERS		     "PBS_LEAF_ROUTERS"
 #define PBS_CONF_COMM_NAME		     "PBS_COMM_NAME"
@@ -322,7 +336,13 @@ extern struct pbs_config pbs_conf;
 #define PBS_CONF_MOM_NODE_NAME	"PBS_MOM_NODE_NAME"
 #define PBS_CONF_LR_SAVE_PATH	"PBS_LR_SAVE_PATH"
 #define PBS_CONF_LOG_HIGHRES_TIMESTAMP	"PBS_LOG_HIGHRES_TIMESTAMP"
+#define PBS_CONF_LOG_ASYNC	"PBS_LOG_ASYNC"
 #define PBS_CONF_SCHED_THREADS	"PBS_SCHED_THREADS"
+#define PBS_CONF_DIS_VERSION	"PBS_DIS_VERSION"
+#define PBS_CONF_STAT_INSTANCE_TIMEOUT	"PBS_STAT_INSTANCE_TIMEOUT"
+#define PBS_CONF_QSTAT_CACHE_TTL	"PBS_QSTAT_CACHE_TTL"
+#define PBS_CONF_ACCT_ASYNC	"PBS_ACCT_ASYNC"
+#define PBS_CONF_ACCT_BINARY	"PBS_ACCT_BINARY"
 #define PBS_CONF_DAEMON_SERVICE_USER "PBS_DAEMON_SERVICE_USER"
 #ifdef WIN32
 #define PBS_CONF_REMOTE_VIEWER "PBS_REMOTE_VIEWER"	/* Executable for remote viewer application alongwith its launch options, for PBS GUI jobs */
@@ -475,6 +495,9 @@ DECLDIR int      set_resources(struct attrl **, char *, int, char **);
 DECLDIR int      cnt2server(char *);
 DECLDIR int      cnt2server_extend(char *, char *);
 DECLDIR int      get_server(char *, char *, char *);
+DECLDIR int      parse_sel_expr(char *, struct attropl **);
+DECLDIR char   **manage_jobs(char *, int, char **, struct attrl *, char *, int *);
+DECLDIR int      manage_selected_jobs(char *, int, struct attropl *, struct attrl *, char *);
 DECLDIR int      PBSD_ucred(int, char *, int, char *, int);
 
 #else
@@ -555,6 +578,9 @@ extern int      set_resources(struct attrl **, char *, int, char **);
 extern int      cnt2server(char *server);
 extern int      cnt2server_extend(char *server, char *);
 extern int      get_server(char *, char *, char *);
+extern int      parse_sel_expr(char *, struct attropl **);
+extern char   **manage_jobs(char *, int, char **, struct attrl *, char *, int *);
+extern int      manage_selected_jobs(char *, int, struct attropl *, struct attrl *, char *);
 extern int      PBSD_ucred(int, char *, int, char *, int);
 extern char	*encode_xml_arg_list(int, int, char **);
 extern int	decode_xml_arg_list(char *, char *, char **, char ***);
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#ifndef _PBS_POOL_H
+#define _PBS_POOL_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/*
+ * Fixed size object pools.
+ *
+ * Objects are carved out of large aligned slabs and recycled through a
+ * free list, so frequently created and destroyed objects (jobs, batch
+ * requests, attribute lists...) neither pay for malloc nor fragment the
+ * heap.  Slabs are kept for reuse once allocated.  Pools are thread safe.
+ */
+
+#define PBS_POOL_SLAB_SIZE (256 * 1024) /* slab size and alignment */
+
+typedef struct pbs_pool pbs_pool_t;
+
+/* statistics of a pool, see pbs_pool_stats() */
+typedef struct pbs_pool_stats {
+	const char *name;	 /* name given at creation */
+	size_t objsize;		 /* size of each object */
+	long live;		 /* objects currently allocated */
+	long peak;		 /* highest number of live objects */
+	long nfree;		 /* objects on the free list */
+	long slabs;		 /* slabs allocated */
+	unsigned long allocs;	 /* objects handed out so far */
+} pbs_pool_stats_t;
+
+/**
+ * @brief
+ *	Create a pool of objects of the given size
+ *
+ * @param[in] - name    - name of the pool, for statistics
+ * @param[in] - objsize - size of each object, at most PBS_POOL_SLAB_SIZE / 4
+ *
+ * @return pbs_pool_t *
+ * @retval !NULL - success
+ * @retval NULL  - failure
+ */
+extern pbs_pool_t *pbs_pool_create(const char *name, size_t objsize);
+
+/**
+ * @brief
+ *	Allocate an object from a pool, contents are undefined
+ *
+ * @param[in] - pool - the pool
+ *
+ * @return void *
+ * @retval !NULL - the object
+ * @retval NULL  - out of memory
+ */
+extern void *pbs_pool_alloc(pbs_pool_t *pool);
+
+/**
+ * @brief
+ *	Return an object to the pool it was allocated from
+ *
+ * @param[in] - pool - the pool
+ * @param[in] - obj  - the object
+ *
+ * @return void
+ */
+extern void pbs_pool_free(pbs_pool_t *pool, void *obj);
+
+/**
+ * @brief
+ *	Find the pool an object was allocated from
+ *
+ * @param[in] - obj - any pointer
+ *
+ * @return pbs_pool_t *
+ * @retval !NULL - the pool owning obj
+ * @retval NULL  - obj does not come from a pool (e.g. it was malloc'ed)
+ */
+extern pbs_pool_t *pbs_pool_find(void *obj);
+
+/**
+ * @brief
+ *	Get the statistics of all pools
+ *
+ * @param[out] - stats - array to fill
+ * @param[in]  - max   - number of entries in stats
+ *
+ * @return int - number of entries filled
+ */
+extern int pbs_pool_stats(pbs_pool_stats_t *stats, int max);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _PBS_POOL_H */
@@ -83,6 +83,7 @@ extern void process_Areply(int);
 extern void process_Dreply(int);
 extern void process_DreplyTPP(int);
 extern void process_request(int);
+extern void log_req_stats(void);
 extern void process_dis_request(int);
 extern int save_flush(void);
 extern void save_setup(int);
@@ -146,6 +147,11 @@ extern long long get_next_svr_sequence_id(void);
 extern int compare_obj_hash(void *, int , void *);
 extern void panic_stop_db();
 extern void free_db_attr_list(pbs_db_attr_list_t *);
+extern int db_writer_start(void);
+extern void db_writer_stop(void);
+extern void db_writer_barrier(void);
+extern int db_writer_save(pbs_db_obj_info_t *, int);
+extern int db_writer_delete(pbs_db_obj_info_t *);
 
 #ifdef _PROVISION_H
 extern int find_prov_vnode_list(job *, exec_vnode_listtype *, char **);
@@ -195,6 +201,9 @@ extern char get_subjob_state(job *, int);
 extern int get_subjob_discarding(job *, int);
 extern char *mk_subjob_id(job *, int);
 extern void set_subjob_tblstate(job *, int, char);
+extern void set_subjob_tblstate_all(job *, char);
+extern job *get_subjob_ptr(job *, int);
+extern int set_subjob_ptr(job *, int, job *);
 extern void update_subjob_state(job *, char);
 extern void update_subjob_state_ct(job *);
 extern char *subst_array_index(job *, char *);
@@ -225,6 +234,7 @@ extern void eval_chkpnt(job *pjob, attribute *queckp);
 #ifdef _BATCH_REQUEST_H
 extern int svr_startjob(job *, struct batch_request *);
 extern int svr_authorize_jobreq(struct batch_request *, job *);
+extern int select_jobids(struct batch_request *, svrattrl *, char ***, int *, int *);
 extern void dup_br_for_subjob(struct batch_request *, job *, void (*)(struct batch_request *, job *));
 extern void set_old_nodes(job *);
 extern int send_job_exec_update_to_mom(job *, char *, int, struct batch_request *);
@@ -253,6 +263,7 @@ extern int user_read_password(char *, char **, size_t *);
 
 #ifdef _BATCH_REQUEST_H
 extern void req_quejob(struct batch_request *);
+extern void req_quejoblist(struct batch_request *);
 extern void req_jobcredential(struct batch_request *);
 extern void req_usercredential(struct batch_request *);
 extern void req_jobscript(struct batch_request *);
@@ -272,6 +283,7 @@ extern void req_shutdown(struct batch_request *);
 extern void req_signaljob(struct batch_request *);
 extern void req_mvjobfile(struct batch_request *);
 extern void req_stat_node(struct batch_request *);
+extern void req_stat_node_summary(struct batch_request *);
 extern void req_track(struct batch_request *);
 extern void req_stagein(struct batch_request *);
 extern void req_resvSub(struct batch_request *);
@@ -116,6 +116,10 @@ struct tpp_config {
 	int    numthreads;
 	char   *node_name; /* list of comma separated node names */
 	int    compress;
+	int    compress_algo; /* codec used to compress outgoing data, TPP_COMPR_xxx */
+	unsigned int compress_min_size; /* do not compress messages smaller than this */
+	int    compress_dict; /* prime the codec with the preset dictionary */
+	int    compact_mcast; /* send mcast member lists in the compact format */
 	int    tcp_keepalive; /* use keepalive? */
 	int    tcp_keep_idle;
 	int    tcp_keep_intvl;
@@ -142,6 +146,7 @@ extern void tpp_terminate(void);
 extern void tpp_shutdown(void);
 extern struct sockaddr_in *tpp_getaddr(int);
 extern void tpp_add_close_func(int, void (*func)(int));
+extern void tpp_stats_dump(void);
 extern void (*tpp_log_func)(int, const char *, char *);
 extern char *tpp_parse_hostname(char *, int *);
 extern int tpp_init_router(struct tpp_config *);
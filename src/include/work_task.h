@@ -88,6 +88,9 @@ struct work_task  {
 	void		*wt_parm3;	/* used to store reply for deferred cmds TPP */
 	int		 wt_aux;	/* optional info: e.g. child status */
 	int		 wt_aux2;	/* optional info 2: e.g. *real* child pid (windows), tpp msgid etc */
+	pbs_list_link	 wt_linkevent;	/* link in the event id table, or to completed tasks */
+	int		 wt_heap_idx;	/* index in the timed task heap, -1 if not there */
+	unsigned long	 wt_seq;	/* creation order, keeps equal timed tasks in order */
 };
 
 extern struct work_task *set_task(enum work_type, long event, void (*func)(), void *param);
@@ -97,6 +100,10 @@ extern void delete_task(struct work_task *);
 extern void delete_task_by_parm1_func(void *parm1, void (*func)(struct work_task *), enum wtask_delete_option option);
 extern int  has_task_by_parm1(void *parm1);
 extern time_t default_next_task(void);
+extern struct work_task *find_event_task(enum work_type type, long event);
+extern void complete_event_task(struct work_task *ptask, int aux);
+extern void remove_task_event(struct work_task *ptask);
+extern void set_task_time(struct work_task *ptask, long when);
 
 #ifdef	__cplusplus
 }
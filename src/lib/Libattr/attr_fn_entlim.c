@@ -516,7 +516,7 @@ encode_entlim_db(const attribute *attr, pbs_list_head *phead, char *atname, char
 				} else {
 					sprintf(pos, "[%c:%s=%s]", *key, etname, tmpsvl->al_atopl.value);
 				}
-				free(tmpsvl);
+				attrlist_free(tmpsvl);
 			}
 		}
 	}
@@ -677,7 +677,7 @@ encode_entlim(const attribute *attr, pbs_list_head *phead, char *atname, char *r
 				} else {
 					sprintf(pal->al_atopl.value, "[%c:%s=%s]", *key, etname, tmpsvl->al_atopl.value);
 				}
-				free(tmpsvl);
+				attrlist_free(tmpsvl);
 				pal->al_flags = attr->at_flags;
 				op = SET;
 
@@ -168,7 +168,7 @@ encode_l(const attribute *attr, pbs_list_head *phead, char *atname, char *rsname
 		*rtnl = pal;
 
 	if ((phead == NULL) && (rtnl == NULL))
-		free(pal);
+		attrlist_free(pal);
 
 	return (1);
 }
@@ -163,7 +163,7 @@ encode_size(const attribute *attr, pbs_list_head *phead, char *atname, char *rsn
 	if (rtnl)
 		*rtnl = pal;
 	if ((phead == NULL) && (rtnl == NULL))
-		free(pal);
+		attrlist_free(pal);
 
 	return (1);
 }
@@ -305,7 +305,7 @@ free_unkn(attribute *pattr)
 		while ((plist = (svrattrl *)GET_NEXT(pattr->at_val.at_list)) !=
 			NULL) {
 			delete_link(&plist->al_link);
-			(void)free(plist);
+			attrlist_free(plist);
 		}
 	}
 	free_null(pattr);
@@ -53,6 +53,7 @@
 #include "pbs_error.h"
 #include "libpbs.h"
 #include "pbs_idx.h"
+#include "pbs_pool.h"
 #include "pbs_entlim.h"
 #include "job.h"
 
@@ -63,6 +64,16 @@
  *
  */
 
+/*
+ * svrattrl entries built while pooling is enabled by the calling thread
+ * come from size class pools, see attrlist_pool_enable().
+ */
+#define ATTRLIST_POOL_MIN	64	/* smallest size class */
+#define ATTRLIST_NPOOLS		4	/* size classes 64, 128, 256, 512 */
+static pbs_pool_t *attrlist_pools[ATTRLIST_NPOOLS];
+static int attrlist_pooled = 0;	/* set once a pool exists */
+static __thread int attrlist_pooling = 0;
+
 /**
  * @brief
  * 	clear_attr - clear an attribute value structure and clear ATR_VFLAG_SET
@@ -175,7 +186,7 @@ free_svrcache(struct attribute *attr)
 		while (working) {
 			sister = working->al_sister;
 			delete_link(&working->al_link);
-			(void)free(working);
+			attrlist_free(working);
 			working = sister;
 		}
 	}
@@ -186,7 +197,7 @@ free_svrcache(struct attribute *attr)
 		while (working) {
 			sister = working->al_sister;
 			delete_link(&working->al_link);
-			(void)free(working);
+			attrlist_free(working);
 			working = sister;
 		}
 	}
@@ -298,7 +309,25 @@ attrlist_alloc(int szname, int szresc, int szval)
 	if (szname < 0 || szresc < 0 || szval < 0)
 		return NULL;
 	tsize = sizeof(svrattrl) + szname + szresc + szval;
-	pal = (svrattrl *)malloc(tsize);
+	pal = NULL;
+	if (attrlist_pooling) {
+		size_t csize = ATTRLIST_POOL_MIN;
+		int i;
+
+		for (i = 0; i < ATTRLIST_NPOOLS && csize < tsize; i++)
+			csize <<= 1;
+		if (i < ATTRLIST_NPOOLS) {
+			if (attrlist_pools[i] == NULL) {
+				attrlist_pools[i] = pbs_pool_create("svrattrl", csize);
+				if (attrlist_pools[i] != NULL)
+					attrlist_pooled = 1;
+			}
+			if (attrlist_pools[i] != NULL)
+				pal = (svrattrl *)pbs_pool_alloc(attrlist_pools[i]);
+		}
+	}
+	if (pal == NULL)
+		pal = (svrattrl *)malloc(tsize);
 	if (pal == NULL)
 		return NULL;
 #ifdef DEBUG
@@ -324,6 +353,53 @@ attrlist_alloc(int szname, int szresc, int szval)
 	return (pal);
 }
 
+/**
+ * @brief
+ * 	attrlist_free - free a single svrattrl structure entry, whether it
+ *	came from malloc or from one of the svrattrl pools
+ *
+ * @param[in] pal - the entry
+ *
+ * @return	Void
+ *
+ */
+
+void
+attrlist_free(svrattrl *pal)
+{
+	pbs_pool_t *pool;
+
+	if (attrlist_pooled && (pool = pbs_pool_find(pal)) != NULL)
+		pbs_pool_free(pool, pal);
+	else
+		free(pal);
+}
+
+/**
+ * @brief
+ * 	attrlist_pool_enable - enable or disable building svrattrl entries from
+ *	pools in the calling thread
+ *
+ *	Only lists which are released through free_svrattrl(), free_attrlist()
+ *	or attrlist_free() may be built with pooling enabled, e.g. the
+ *	encoded attributes of a status reply.
+ *
+ * @param[in] on - non-zero to enable, zero to disable
+ *
+ * @return	int
+ * @retval	previous setting, to be restored by the caller
+ *
+ */
+
+int
+attrlist_pool_enable(int on)
+{
+	int old = attrlist_pooling;
+
+	attrlist_pooling = on;
+	return old;
+}
+
 /**
  * @brief
  * 	attrlist_create - create an svrattrl structure entry
@@ -406,14 +482,14 @@ free_svrattrl(svrattrl *pal)
 			while (sister) {
 				nxpal = sister->al_sister;
 				delete_link(&sister->al_link);
-				(void)free(sister);
+				attrlist_free(sister);
 				sister = nxpal;
 			}
 		}
 		nxpal = (struct svrattrl *)GET_NEXT(pal->al_link);
 		delete_link(&pal->al_link);
 		if (pal->al_refct <= 0)
-			(void)free(pal);
+			attrlist_free(pal);
 		pal = nxpal;
 	}
 }
@@ -880,10 +956,10 @@ compare_svrattrl_list(pbs_list_head *l1, pbs_list_head *l2)
 				(strcmp(pal1->al_value, pal2->al_value) == 0)) {
 				found_match = 1;
 				delete_link(&pal2->al_link);
-				free(pal2);
+				attrlist_free(pal2);
 
 				delete_link(&pal1->al_link);
-				free(pal1);
+				attrlist_free(pal1);
 				break;
 			}
 
@@ -0,0 +1,407 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	manage_jobs.c
+ * @brief
+ *	Hold, release, signal, alter or move the jobs given to a command with
+ *	one Manage Job List request per server, and parse the selection
+ *	expressions of the commands that select jobs or vnodes by criteria.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+#include "cmds.h"
+
+/* the jobs of one server */
+struct svr_jobs {
+	char *server;		/* server name, "" for the default */
+	char **ids;		/* job ids as sent to the server */
+	char **orig;		/* job ids as given to the command */
+	int count;
+	int size;
+	struct svr_jobs *next;
+};
+
+/**
+ * @brief
+ *	Parse a selection expression of the form name[.resource]<op>value,
+ *	where <op> is one of =, !=, <, <=, > or >=, and add it to a selection.
+ *
+ * @param[in] expr - the expression, modified and referred to by the entry
+ * @param[in,out] psel - the selection
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	1	bad expression
+ * @retval	-1	out of memory
+ *
+ */
+int
+parse_sel_expr(char *expr, struct attropl **psel)
+{
+	struct attropl *pop;
+	char *pc;
+	char *dot;
+
+	pc = expr + strcspn(expr, "!<>=");
+	if (*pc == '\0' || pc == expr)
+		return 1;
+
+	if ((pop = calloc(1, sizeof(struct attropl))) == NULL)
+		return -1;
+	if (pc[0] == '=') {
+		pop->op = EQ;
+		pop->value = pc + 1;
+	} else if (pc[0] == '!' && pc[1] == '=') {
+		pop->op = NE;
+		pop->value = pc + 2;
+	} else if (pc[0] == '<') {
+		pop->op = (pc[1] == '=') ? LE : LT;
+		pop->value = pc + ((pc[1] == '=') ? 2 : 1);
+	} else if (pc[0] == '>') {
+		pop->op = (pc[1] == '=') ? GE : GT;
+		pop->value = pc + ((pc[1] == '=') ? 2 : 1);
+	} else {
+		free(pop);
+		return 1;
+	}
+	*pc = '\0';
+	pop->name = expr;
+	if ((dot = strchr(expr, '.')) != NULL) {
+		*dot = '\0';
+		pop->resource = dot + 1;
+	}
+	pop->next = *psel;
+	*psel = pop;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Act on one job with the single job request of an operation.
+ *
+ * @param[in] connect - connection to the server
+ * @param[in] op - JOBLIST_HOLD, JOBLIST_RELEASE, ...
+ * @param[in] jobid - job id
+ * @param[in] attrib - attributes, for JOBLIST_ALTER
+ * @param[in] arg - hold types, signal name or destination
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error, see pbs_errno
+ */
+static int
+manage_one_job(int connect, int op, char *jobid, struct attrl *attrib, char *arg)
+{
+	switch (op) {
+		case JOBLIST_HOLD:
+			return pbs_holdjob(connect, jobid, arg, NULL);
+		case JOBLIST_RELEASE:
+			return pbs_rlsjob(connect, jobid, arg, NULL);
+		case JOBLIST_SIGNAL:
+			return pbs_sigjob(connect, jobid, arg, NULL);
+		case JOBLIST_ALTER:
+			return pbs_alterjob(connect, jobid, attrib, NULL);
+		default:
+			return pbs_movejob(connect, jobid, arg, NULL);
+	}
+}
+
+/**
+ * @brief
+ *	Print the failure of a job reported in a Manage Job List reply.
+ *
+ * @param[in] cmd - command name
+ * @param[in] jobid - job id
+ * @param[in] code - error code
+ *
+ * @return	Void
+ */
+static void
+prt_joblist_err(char *cmd, char *jobid, int code)
+{
+	char *errtxt;
+
+	if ((errtxt = pbse_to_txt(code)) != NULL)
+		fprintf(stderr, "%s: %s %s\n", cmd, errtxt, jobid);
+	else
+		fprintf(stderr, "%s: Server returned error %d for job %s\n", cmd, code, jobid);
+}
+
+/**
+ * @brief
+ *	Compare two job id pointers of a server's jobs, for qsort()/bsearch().
+ */
+static int
+cmp_jobid(const void *a, const void *b)
+{
+	return strcmp(**(char ***)a, **(char ***)b);
+}
+
+/**
+ * @brief
+ *	Add a job to the jobs of its server.
+ *
+ * @param[in,out] phead - jobs of each server
+ * @param[in] server - server name
+ * @param[in] jobid - job id as sent to the server
+ * @param[in] orig - job id as given to the command
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	out of memory
+ */
+static int
+add_svr_job(struct svr_jobs **phead, char *server, char *jobid, char *orig)
+{
+	struct svr_jobs *psj;
+	char **tmp;
+
+	for (psj = *phead; psj; psj = psj->next)
+		if (strcmp(psj->server, server) == 0)
+			break;
+	if (psj == NULL) {
+		if ((psj = calloc(1, sizeof(struct svr_jobs))) == NULL)
+			return -1;
+		if ((psj->server = strdup(server)) == NULL) {
+			free(psj);
+			return -1;
+		}
+		psj->next = *phead;
+		*phead = psj;
+	}
+	if (psj->count == psj->size) {
+		psj->size = psj->size ? psj->size * 2 : 64;
+		if ((tmp = realloc(psj->ids, psj->size * sizeof(char *))) == NULL)
+			return -1;
+		psj->ids = tmp;
+		if ((tmp = realloc(psj->orig, psj->size * sizeof(char *))) == NULL)
+			return -1;
+		psj->orig = tmp;
+	}
+	if ((psj->ids[psj->count] = strdup(jobid)) == NULL)
+		return -1;
+	psj->orig[psj->count++] = orig;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Hold, release, signal, alter or move the jobs given to a command,
+ *	with one Manage Job List request to each of their servers.
+ *
+ * @par Functionality:
+ *	The failures the servers report are printed.  The jobs that must be
+ *	acted on one at a time are returned to the caller: all of them if
+ *	there is only one, those with malformed ids, those of servers that
+ *	cannot be reached or that do not support the request, and those the
+ *	server does not know (they may have moved to another server).
+ *
+ * @param[in] cmd - command name, for messages
+ * @param[in] op - JOBLIST_HOLD, JOBLIST_RELEASE, ...
+ * @param[in] jobids - NULL terminated job ids given to the command
+ * @param[in] attrib - attributes, for JOBLIST_ALTER
+ * @param[in] arg - hold types, signal name or destination
+ * @param[out] any_failed - set to the error code of a failed job
+ *
+ * @return	char **
+ * @retval	NULL terminated jobs left for the caller, pointers into jobids
+ * @retval	jobids	all are left (out of memory, or a single job)
+ */
+char **
+manage_jobs(char *cmd, int op, char **jobids, struct attrl *attrib, char *arg, int *any_failed)
+{
+	struct svr_jobs *head = NULL;
+	struct svr_jobs *psj;
+	struct batch_deljob_status *failed;
+	struct batch_deljob_status *pdel;
+	char job_id_out[PBS_MAXCLTJOBID];
+	char server_out[MAXSERVERNAME];
+	char ***sorted = NULL;
+	char ***found;
+	char **left;
+	char **pkey;
+	int nleft = 0;
+	int connect;
+	int njobs;
+	int i;
+
+	for (njobs = 0; jobids[njobs]; njobs++)
+		;
+	if ((njobs < 2) || ((left = calloc(njobs + 1, sizeof(char *))) == NULL))
+		return jobids;
+
+	for (i = 0; i < njobs; i++) {
+		if (get_server(jobids[i], job_id_out, server_out)) {
+			left[nleft++] = jobids[i];
+			continue;
+		}
+		if (add_svr_job(&head, server_out, job_id_out, jobids[i]) != 0) {
+			fprintf(stderr, "%s: out of memory\n", cmd);
+			exit(2);
+		}
+	}
+
+	for (psj = head; psj; psj = psj->next) {
+		connect = cnt2server(psj->server);
+		if (connect <= 0) {
+			for (i = 0; i < psj->count; i++)
+				left[nleft++] = psj->orig[i];
+			continue;
+		}
+
+		failed = pbs_managejoblist(connect, op, psj->ids, psj->count,
+			NULL, attrib, arg, NULL);
+		if ((failed == NULL) && (pbs_errno != PBSE_NONE)) {
+			/* not done as a whole, e.g. an older server */
+			for (i = 0; i < psj->count; i++)
+				left[nleft++] = psj->orig[i];
+			pbs_disconnect(connect);
+			continue;
+		}
+
+		/* look up the job ids reported, in the order given */
+		found = NULL;
+		if ((failed != NULL) &&
+			((sorted = malloc(psj->count * sizeof(char **))) != NULL)) {
+			for (i = 0; i < psj->count; i++)
+				sorted[i] = &psj->ids[i];
+			qsort(sorted, psj->count, sizeof(char **), cmp_jobid);
+		}
+		for (pdel = failed; pdel; pdel = pdel->next) {
+			pkey = &pdel->name;
+			if (sorted != NULL)
+				found = bsearch(&pkey, sorted, psj->count, sizeof(char **), cmp_jobid);
+			if (found == NULL) {
+				prt_joblist_err(cmd, pdel->name, pdel->code);
+				*any_failed = pdel->code;
+			} else if (pdel->code == PBSE_UNKJOBID) {
+				left[nleft++] = psj->orig[*found - psj->ids];
+			} else {
+				prt_joblist_err(cmd, psj->orig[*found - psj->ids], pdel->code);
+				*any_failed = pdel->code;
+			}
+		}
+		free(sorted);
+		sorted = NULL;
+		pbs_delstatfree(failed);
+		pbs_disconnect(connect);
+	}
+
+	while ((psj = head) != NULL) {
+		head = psj->next;
+		for (i = 0; i < psj->count; i++)
+			free(psj->ids[i]);
+		free(psj->ids);
+		free(psj->orig);
+		free(psj->server);
+		free(psj);
+	}
+	left[nleft] = NULL;
+	return left;
+}
+
+/**
+ * @brief
+ *	Hold, release, signal, alter or move the jobs of the default server
+ *	that match a selection, with one Manage Job List request.
+ *
+ * @par Functionality:
+ *	With an older server that does not support the request, the jobs
+ *	are selected with pbs_selectjob() and acted on one at a time.
+ *
+ * @param[in] cmd - command name, for messages
+ * @param[in] op - JOBLIST_HOLD, JOBLIST_RELEASE, ...
+ * @param[in] selattr - the selection, see parse_sel_expr()
+ * @param[in] attrib - attributes, for JOBLIST_ALTER
+ * @param[in] arg - hold types, signal name or destination
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error code of a failure
+ */
+int
+manage_selected_jobs(char *cmd, int op, struct attropl *selattr,
+	struct attrl *attrib, char *arg)
+{
+	struct batch_deljob_status *failed;
+	struct batch_deljob_status *pdel;
+	char **selected;
+	char *errmsg;
+	int any_failed = 0;
+	int connect;
+	int i = 0;
+
+	connect = cnt2server(NULL);
+	if (connect <= 0) {
+		fprintf(stderr, "%s: cannot connect to server %s (errno=%d)\n",
+			cmd, pbs_server, pbs_errno);
+		return pbs_errno;
+	}
+
+	failed = pbs_managejoblist(connect, op, NULL, 0, selattr, attrib, arg, NULL);
+	if ((failed == NULL) && (pbs_errno == PBSE_UNKREQ)) {
+		selected = pbs_selectjob(connect, selattr, NULL);
+		if ((selected == NULL) && (pbs_errno != PBSE_NONE))
+			any_failed = pbs_errno;
+		for (i = 0; selected && selected[i]; i++) {
+			if (manage_one_job(connect, op, selected[i], attrib, arg)) {
+				prt_job_err(cmd, connect, selected[i]);
+				any_failed = pbs_errno;
+			}
+		}
+		free(selected);
+	} else if ((failed == NULL) && (pbs_errno != PBSE_NONE))
+		any_failed = pbs_errno;
+
+	/* the request or the selection failed as a whole, not some jobs */
+	if ((any_failed != 0) && (failed == NULL) && (i == 0)) {
+		if ((errmsg = pbs_geterrmsg(connect)) != NULL)
+			fprintf(stderr, "%s: %s\n", cmd, errmsg);
+		else
+			fprintf(stderr, "%s: Error %d\n", cmd, any_failed);
+	}
+	for (pdel = failed; pdel; pdel = pdel->next) {
+		prt_joblist_err(cmd, pdel->name, pdel->code);
+		any_failed = pdel->code;
+	}
+	pbs_delstatfree(failed);
+	pbs_disconnect(connect);
+	return any_failed;
+}
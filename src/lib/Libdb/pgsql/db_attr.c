@@ -245,8 +245,8 @@ int
 attrlist_to_dbarray_ex(char **raw_array, pbs_db_attr_list_t *attr_list, int keys_only)
 {
 	/* use static variables to improve performance by not allocating memory for each object save */
-	static struct pg_array *array = NULL, *tmp;
-	static int len = sizeof(struct pg_array) + DBARRAY_BUF_LEN;
+	static __thread struct pg_array *array = NULL, *tmp;
+	static __thread int len = sizeof(struct pg_array) + DBARRAY_BUF_LEN;
 	struct str_data *val = NULL;
 	svrattrl *pal;
 	char *p;
@@ -324,3 +324,386 @@ attrlist_to_dbarray(char **raw_array, pbs_db_attr_list_t *attr_list)
 {
 	return attrlist_to_dbarray_ex(raw_array, attr_list, 0);
 }
+
+/*
+ * Binary attribute records
+ *
+ * The attrs_bin column of the job, node and reservation tables holds a
+ * sequence of records, each of them:
+ *
+ *	op	 1 byte	  DB_ATTR_SET or DB_ATTR_UNSET
+ *	flags	 2 bytes  attribute flags
+ *	namelen	 2 bytes  length of the attribute name
+ *	resclen	 2 bytes  length of the resource name, 0 if none
+ *	vallen	 4 bytes  length of the value, 0 if none
+ *	name, resource and value, each followed by a null byte
+ *
+ * Numbers are in network byte order. A save of changed attributes only
+ * appends records, so a later record replaces an earlier one of the same
+ * name and resource, and an unset record removes it. Once an object had
+ * DB_ATTR_COMPACT_UPDATES such appends, its records are folded into one
+ * record per attribute (see db_cmd_attrs).
+ */
+#define DB_ATTR_REC_HDR		11
+
+struct db_attr_rec {
+	int op;
+	int flags;
+	char *name;
+	char *resc;
+	char *value;
+	int dead;	/* replaced by a later record */
+};
+
+/**
+ * @brief
+ *	Converts a PBS link list of attributes to binary attribute records
+ *
+ * @param[out]  bin - the records, in a buffer owned by this function
+ * @param[in]	attr_list - List of pbs_db_attr_list_t objects
+ * @param[in]	op - DB_ATTR_SET to store the attributes, DB_ATTR_UNSET to
+ *		     remove them (only names and resources are used)
+ *
+ * @return      Length of the records
+ * @retval	-1 - On Error
+ *
+ */
+int
+attrlist_to_dbbin(char **bin, pbs_db_attr_list_t *attr_list, int op)
+{
+	/* reuse the buffer for each save, like attrlist_to_dbarray_ex */
+	static __thread unsigned char *buf = NULL;
+	static __thread int len = 0;
+	unsigned char *tmp;
+	unsigned char *p;
+	svrattrl *pal;
+	size_t nlen;
+	size_t rlen;
+	size_t vlen;
+	int used = 0;
+	int req;
+
+	if (!buf) {
+		if ((buf = malloc(DBARRAY_BUF_LEN)) == NULL)
+			return -1;
+		len = DBARRAY_BUF_LEN;
+	}
+
+	for (pal = (svrattrl *)GET_NEXT(attr_list->attrs); pal != NULL; pal = (svrattrl *)GET_NEXT(pal->al_link)) {
+		nlen = strlen(pal->al_atopl.name);
+		rlen = pal->al_atopl.resource ? strlen(pal->al_atopl.resource) : 0;
+		vlen = 0;
+		if (op == DB_ATTR_SET && pal->al_atopl.value)
+			vlen = strlen(pal->al_atopl.value);
+		if (nlen > 0xffff || rlen > 0xffff)
+			return -1;
+
+		req = DB_ATTR_REC_HDR + nlen + rlen + vlen + 3;
+		if (len - used < req) {
+			int newlen = len + ((req > DBARRAY_BUF_LEN) ? req : DBARRAY_BUF_LEN);
+			if ((tmp = realloc(buf, newlen)) == NULL)
+				return -1;
+			buf = tmp;
+			len = newlen;
+		}
+
+		p = buf + used;
+		*p++ = op;
+		*p++ = (pal->al_flags >> 8) & 0xff;
+		*p++ = pal->al_flags & 0xff;
+		*p++ = (nlen >> 8) & 0xff;
+		*p++ = nlen & 0xff;
+		*p++ = (rlen >> 8) & 0xff;
+		*p++ = rlen & 0xff;
+		*p++ = (vlen >> 24) & 0xff;
+		*p++ = (vlen >> 16) & 0xff;
+		*p++ = (vlen >> 8) & 0xff;
+		*p++ = vlen & 0xff;
+		memcpy(p, pal->al_atopl.name, nlen + 1);
+		p += nlen + 1;
+		if (rlen)
+			memcpy(p, pal->al_atopl.resource, rlen);
+		p[rlen] = '\0';
+		p += rlen + 1;
+		if (vlen)
+			memcpy(p, pal->al_atopl.value, vlen);
+		p[vlen] = '\0';
+		p += vlen + 1;
+
+		used = p - buf;
+	}
+	*bin = (char *) buf;
+
+	return used;
+}
+
+/**
+ * @brief
+ *	Hash the name and resource of an attribute
+ *
+ * @param[in]	name - attribute name
+ * @param[in]	resc - resource name or NULL
+ *
+ * @return	hash value
+ */
+static unsigned int
+db_attr_hash(char *name, char *resc)
+{
+	unsigned int h = 2166136261U;
+
+	while (*name)
+		h = (h ^ (unsigned char) *name++) * 16777619U;
+	h = (h ^ '.') * 16777619U;
+	if (resc) {
+		while (*resc)
+			h = (h ^ (unsigned char) *resc++) * 16777619U;
+	}
+	return h;
+}
+
+/**
+ * @brief
+ *	Tell whether two attributes have the same name and resource
+ *
+ * @return	int
+ * @retval	1 - same
+ * @retval	0 - not the same
+ */
+static int
+db_attr_same(char *name1, char *resc1, char *name2, char *resc2)
+{
+	if (strcmp(name1, name2) != 0)
+		return 0;
+	if (resc1 == NULL || resc2 == NULL)
+		return (resc1 == resc2);
+	return (strcmp(resc1, resc2) == 0);
+}
+
+/**
+ * @brief
+ *	Applies binary attribute records to a list of attributes. The list
+ *	may already hold attributes (from the hstore column of an object that
+ *	was not converted yet), records replace or remove those.
+ *
+ * @param[in]	bin - the records
+ * @param[in]	binlen - length of the records
+ * @param[in,out] attr_list - List of pbs_db_attr_list_t objects
+ *
+ * @return      Error code
+ * @retval	-1 - On Error
+ * @retval	 0 - On Success
+ *
+ */
+int
+dbbin_to_attrlist(char *bin, int binlen, pbs_db_attr_list_t *attr_list)
+{
+	unsigned char *p = (unsigned char *) bin;
+	unsigned char *end = p + binlen;
+	struct db_attr_rec *recs = NULL;
+	struct db_attr_rec *r;
+	int *table = NULL;
+	unsigned int mask;
+	unsigned int h;
+	size_t nlen;
+	size_t rlen;
+	size_t vlen;
+	svrattrl *pal;
+	svrattrl *next;
+	int nrecs = 0;
+	int maxrecs;
+	int rc = -1;
+	int i;
+
+	if (binlen <= 0)
+		return 0;
+
+	/* every record takes at least DB_ATTR_REC_HDR + 3 bytes */
+	maxrecs = binlen / (DB_ATTR_REC_HDR + 3) + 1;
+	if ((recs = malloc(maxrecs * sizeof(struct db_attr_rec))) == NULL)
+		return -1;
+
+	while (p < end) {
+		if (end - p < DB_ATTR_REC_HDR || nrecs >= maxrecs)
+			goto done;
+		r = &recs[nrecs];
+		r->op = p[0];
+		r->flags = (p[1] << 8) | p[2];
+		nlen = (p[3] << 8) | p[4];
+		rlen = (p[5] << 8) | p[6];
+		vlen = ((size_t) p[7] << 24) | (p[8] << 16) | (p[9] << 8) | p[10];
+		p += DB_ATTR_REC_HDR;
+		if ((size_t)(end - p) < nlen + rlen + vlen + 3)
+			goto done;
+		if (r->op != DB_ATTR_SET && r->op != DB_ATTR_UNSET)
+			goto done;
+		r->name = (char *) p;
+		p += nlen + 1;
+		r->resc = rlen ? (char *) p : NULL;
+		p += rlen + 1;
+		r->value = vlen ? (char *) p : NULL;
+		p += vlen + 1;
+		r->dead = 0;
+		nrecs++;
+	}
+
+	/* newest record of an attribute wins, walk back and mark older ones */
+	for (mask = 1; mask < (unsigned int) nrecs * 2; mask <<= 1)
+		;
+	if ((table = malloc(mask * sizeof(int))) == NULL)
+		goto done;
+	for (i = 0; i < (int) mask; i++)
+		table[i] = -1;
+	mask--;
+
+	for (i = nrecs - 1; i >= 0; i--) {
+		r = &recs[i];
+		for (h = db_attr_hash(r->name, r->resc) & mask; table[h] != -1; h = (h + 1) & mask) {
+			if (db_attr_same(recs[table[h]].name, recs[table[h]].resc, r->name, r->resc)) {
+				r->dead = 1;
+				break;
+			}
+		}
+		if (!r->dead)
+			table[h] = i;
+	}
+
+	/* drop what the records replace or remove from the existing list */
+	for (pal = (svrattrl *)GET_NEXT(attr_list->attrs); pal != NULL; pal = next) {
+		next = (svrattrl *)GET_NEXT(pal->al_link);
+		for (h = db_attr_hash(pal->al_name, pal->al_resc) & mask; table[h] != -1; h = (h + 1) & mask) {
+			if (db_attr_same(recs[table[h]].name, recs[table[h]].resc, pal->al_name, pal->al_resc)) {
+				delete_link(&pal->al_link);
+				free(pal);
+				attr_list->attr_count--;
+				break;
+			}
+		}
+	}
+
+	for (i = 0; i < nrecs; i++) {
+		r = &recs[i];
+		if (r->dead || r->op != DB_ATTR_SET)
+			continue;
+		if (!(pal = make_attr(r->name, r->resc, r->value, r->flags)))
+			goto done;
+		append_link(&(attr_list->attrs), &pal->al_link, pal);
+		attr_list->attr_count++;
+	}
+	rc = 0;
+
+done:
+	free(table);
+	free(recs);
+	return rc;
+}
+
+/**
+ * @brief
+ *	Free a list of attributes loaded from the database
+ *
+ * @param[in]	attr_list - the list
+ *
+ * @return void
+ */
+void
+db_free_attrlist(pbs_db_attr_list_t *attr_list)
+{
+	svrattrl *pal;
+
+	if (attr_list->attrs.ll_next == NULL)
+		return;	/* never set up */
+	while ((pal = (svrattrl *) GET_NEXT(attr_list->attrs)) != NULL) {
+		delete_link(&pal->al_link);
+		free(pal);
+	}
+	attr_list->attr_count = 0;
+}
+
+/**
+ * @brief
+ *	Loads the attributes of an object from a result row, from both the
+ *	binary records and the hstore column of objects not yet converted
+ *
+ * @param[in]	res - Resultset from an earlier query
+ * @param[in]	row - The current row to load within the resultset
+ * @param[in]	hstore_fnum - column of hstore_to_array(attributes)
+ * @param[in]	bin_fnum - column of attrs_bin
+ * @param[out]  attr_list - List of pbs_db_attr_list_t objects
+ *
+ * @return      Error code
+ * @retval	-1 - On Error
+ * @retval	 0 - On Success
+ *
+ */
+int
+db_load_attrs(const PGresult *res, int row, int hstore_fnum, int bin_fnum, pbs_db_attr_list_t *attr_list)
+{
+	char *raw_array;
+
+	GET_PARAM_BIN(res, row, raw_array, hstore_fnum);
+	if (dbarray_to_attrlist(raw_array, attr_list) != 0)
+		return -1;
+
+	return (dbbin_to_attrlist(PQgetvalue(res, row, bin_fnum), PQgetlength(res, row, bin_fnum), attr_list));
+}
+
+/**
+ * @brief
+ *	Execute a prepared statement that appends attribute records to an
+ *	object and returns its count of appends (attr_nupd). When that count
+ *	reaches DB_ATTR_COMPACT_UPDATES, the object's attributes are read back,
+ *	folded into one record each and written as a whole, which also moves
+ *	any attributes still in the old hstore column over.
+ *
+ * @param[in]	conn - The connnection handle
+ * @param[in]	stmt - Name of the statement (prepared previously)
+ * @param[in]	num_vars - The number of parameters in the sql ($1, $2 etc)
+ * @param[in]	select_stmt - statement reading back the attributes by id
+ * @param[in]	compact_stmt - statement writing the folded records by id
+ * @param[in]	id - id of the object
+ *
+ * @return      Error code
+ * @retval	-1 - Execution of prepared statement failed
+ * @retval	 0 - Success and > 0 rows were affected
+ * @retval	 1 - Execution succeeded but statement did not affect any rows
+ *
+ */
+int
+db_cmd_attrs(void *conn, char *stmt, int num_vars, char *select_stmt, char *compact_stmt, char *id)
+{
+	PGresult *res;
+	pbs_db_attr_list_t attr_list;
+	char *bin = NULL;
+	int nupd;
+	int len;
+	int rc;
+
+	if ((rc = db_query(conn, stmt, num_vars, &res)) != 0)
+		return rc;
+	nupd = ntohl(*((uint32_t *) PQgetvalue(res, 0, 0)));
+	PQclear(res);
+
+	if (nupd < DB_ATTR_COMPACT_UPDATES)
+		return 0;
+
+	SET_PARAM_STR(conn_data, id, 0);
+	if ((rc = db_query(conn, select_stmt, 1, &res)) != 0)
+		return rc;
+
+	CLEAR_HEAD(attr_list.attrs);
+	attr_list.attr_count = 0;
+	rc = db_load_attrs(res, 0, PQfnumber(res, "attributes"), PQfnumber(res, "attrs_bin"), &attr_list);
+	PQclear(res);
+	if (rc == 0) {
+		if ((len = attrlist_to_dbbin(&bin, &attr_list, DB_ATTR_SET)) < 0)
+			rc = -1;
+		else {
+			SET_PARAM_STR(conn_data, id, 0);
+			SET_PARAM_BIN(conn_data, bin, len, 1);
+			rc = db_cmd(conn, compact_stmt, 2);
+		}
+	}
+	db_free_attrlist(&attr_list);
+
+	return ((rc == -1) ? -1 : 0);
+}
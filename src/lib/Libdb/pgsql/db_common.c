@@ -57,15 +57,21 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <arpa/inet.h>
+#include <pthread.h>
+#include <time.h>
 #include "ticket.h"
 #include "log.h"
 #include "server_limits.h"
 
 #define IPV4_STR_LEN 15
 
-char *errmsg_cache = NULL;
-pg_conn_data_t *conn_data = NULL;
-pg_conn_trx_t *conn_trx = NULL;
+/*
+ * Per connection state is kept per thread, so that a thread other than the
+ * main one (see the server's datastore writer) can own a connection of its own.
+ */
+__thread char *errmsg_cache = NULL;
+__thread pg_conn_data_t *conn_data = NULL;
+__thread pg_conn_trx_t *conn_trx = NULL;
 static char pg_ctl[MAXPATHLEN + 1] = "";
 static char *pg_user = NULL;
 
@@ -247,6 +253,316 @@ pbs_db_search(void *conn, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts,
 	return totcount;
 }
 
+/* rows decoded ahead of the callback by pbs_db_search_parallel */
+#define DB_SEARCH_WINDOW	4096
+
+/*
+ * State shared between pbs_db_search_parallel and its decode threads.
+ * Row r is decoded into slot (r % DB_SEARCH_WINDOW), workers never get more
+ * than DB_SEARCH_WINDOW rows ahead of the callback.
+ */
+struct db_search_par {
+	db_query_state_t *state;
+	void *conn;
+	int obj_type;
+	pbs_db_obj_info_t *slots;
+	int *ready;		/* per slot: 0 - pending, 1 - decoded, -1 - decode failed */
+	int next_row;		/* next row for a worker to decode */
+	int consumed;		/* rows handed to the callback so far */
+	int stop;		/* callback side is done, workers should exit */
+	pthread_mutex_t lock;
+	pthread_cond_t cond_ready;	/* a slot got decoded */
+	pthread_cond_t cond_space;	/* a slot got consumed */
+};
+
+/**
+ * @brief
+ *	Return the size of the structure that holds a loaded object
+ *
+ * @param[in]	obj_type - PBS_DB_JOB etc
+ *
+ * @return	size_t
+ * @retval	0 - type can not be searched in parallel
+ */
+static size_t
+db_obj_size(int obj_type)
+{
+	switch (obj_type) {
+		case PBS_DB_SCHED:
+			return sizeof(pbs_db_sched_info_t);
+		case PBS_DB_QUEUE:
+			return sizeof(pbs_db_que_info_t);
+		case PBS_DB_NODE:
+			return sizeof(pbs_db_node_info_t);
+		case PBS_DB_JOB:
+			return sizeof(pbs_db_job_info_t);
+		case PBS_DB_RESV:
+			return sizeof(pbs_db_resv_info_t);
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Free the attribute list of a loaded object which was not passed on
+ *
+ * @param[in]	obj - the object
+ *
+ * @return void
+ */
+static void
+db_free_obj_attrs(pbs_db_obj_info_t *obj)
+{
+	pbs_db_attr_list_t *attr_list;
+
+	switch (obj->pbs_db_obj_type) {
+		case PBS_DB_SCHED:
+			attr_list = &obj->pbs_db_un.pbs_db_sched->db_attr_list;
+			break;
+		case PBS_DB_QUEUE:
+			attr_list = &obj->pbs_db_un.pbs_db_que->db_attr_list;
+			break;
+		case PBS_DB_NODE:
+			attr_list = &obj->pbs_db_un.pbs_db_node->db_attr_list;
+			break;
+		case PBS_DB_JOB:
+			attr_list = &obj->pbs_db_un.pbs_db_job->db_attr_list;
+			break;
+		case PBS_DB_RESV:
+			attr_list = &obj->pbs_db_un.pbs_db_resv->db_attr_list;
+			break;
+		default:
+			return;
+	}
+	db_free_attrlist(attr_list);
+}
+
+/**
+ * @brief
+ *	Decode thread of pbs_db_search_parallel. Takes the next row not yet
+ *	decoded and loads it into its slot, until all rows are taken or the
+ *	search is stopped.
+ *
+ * @param[in]	arg - the shared search state
+ *
+ * @return void *
+ */
+static void *
+db_search_worker(void *arg)
+{
+	struct db_search_par *par = arg;
+	db_query_state_t st = *par->state;	/* private cursor, shares the result */
+	int row;
+	int slot;
+	int ret;
+
+	pthread_mutex_lock(&par->lock);
+	for (;;) {
+		while (!par->stop && par->next_row < st.count &&
+			par->next_row >= par->consumed + DB_SEARCH_WINDOW)
+			pthread_cond_wait(&par->cond_space, &par->lock);
+		if (par->stop || par->next_row >= st.count)
+			break;
+		row = par->next_row++;
+		pthread_mutex_unlock(&par->lock);
+
+		slot = row % DB_SEARCH_WINDOW;
+		st.row = row;
+		ret = db_fn_arr[par->obj_type].pbs_db_next_obj(par->conn, &st, &par->slots[slot]);
+
+		pthread_mutex_lock(&par->lock);
+		par->ready[slot] = (ret == 0) ? 1 : -1;
+		pthread_cond_signal(&par->cond_ready);
+	}
+	pthread_mutex_unlock(&par->lock);
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Return the current time in seconds, for phase timings
+ *
+ * @return double
+ */
+static double
+db_time_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief
+ *	Search the database for existing objects and load the server structures,
+ *	decoding the rows on a pool of threads.
+ *
+ * @par
+ *	The load functions only read the result set and allocate the attribute
+ *	lists, so they can run on any thread. The callback, which links the
+ *	object into the server, is always run on the calling thread and in row
+ *	order, exactly like pbs_db_search does.
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	pbs_db_obj_info_t - The pointer to the wrapper object which
+ *		describes the PBS object (job/resv/node etc) that is wrapped
+ *		inside it.
+ * @param[in/out]	pbs_db_query_options_t - Pointer to the options object that can
+ *		contain the flags or timestamp which will effect the query.
+ * @param[in]	callback function which will process the result from the database
+ * 		and update the server strctures.
+ * @param[in]	nworkers - number of decode threads to use
+ * @param[out]	stats - time spent per phase, may be NULL
+ *
+ * @return	int
+ * @retval	0	- Success but no rows found
+ * @retval	-1	- Failure
+ * @retval	>0	- Success and number of rows found
+ *
+ */
+int
+pbs_db_search_parallel(void *conn, pbs_db_obj_info_t *obj, pbs_db_query_options_t *opts, query_cb_t query_cb, int nworkers, pbs_db_search_stats_t *stats)
+{
+	struct db_search_par par;
+	db_query_state_t *state;
+	pthread_t *tids = NULL;
+	char *objs = NULL;
+	size_t objsize;
+	double t0;
+	double t1;
+	int totcount = 0;
+	int refreshed;
+	int started = 0;
+	int slot;
+	int ret;
+	int row;
+	int i;
+
+	if (stats)
+		memset(stats, 0, sizeof(*stats));
+
+	objsize = db_obj_size(obj->pbs_db_obj_type);
+	if ((nworkers < 1) || (objsize == 0))
+		return pbs_db_search(conn, obj, opts, query_cb);
+
+	t0 = db_time_now();
+	state = db_initialize_state(conn, query_cb);
+	if (!state)
+		return -1;
+
+	if (db_fn_arr[obj->pbs_db_obj_type].pbs_db_find_obj(conn, state, obj, opts) == -1) {
+		db_destroy_state(state);
+		return -1;
+	}
+	t1 = db_time_now();
+	if (stats)
+		stats->ss_query = t1 - t0;
+
+	if (state->count <= 0) {
+		db_destroy_state(state);
+		return 0;
+	}
+
+	memset(&par, 0, sizeof(par));
+	par.slots = calloc(DB_SEARCH_WINDOW, sizeof(pbs_db_obj_info_t));
+	par.ready = calloc(DB_SEARCH_WINDOW, sizeof(int));
+	objs = calloc(DB_SEARCH_WINDOW, objsize);
+	tids = calloc(nworkers, sizeof(pthread_t));
+	if (!par.slots || !par.ready || !objs || !tids) {
+		free(par.slots);
+		free(par.ready);
+		free(objs);
+		free(tids);
+		db_destroy_state(state);
+		return -1;
+	}
+	for (i = 0; i < DB_SEARCH_WINDOW; i++) {
+		par.slots[i].pbs_db_obj_type = obj->pbs_db_obj_type;
+		par.slots[i].pbs_db_un.pbs_db_job = (pbs_db_job_info_t *)(objs + i * objsize);
+	}
+	par.state = state;
+	par.conn = conn;
+	par.obj_type = obj->pbs_db_obj_type;
+	pthread_mutex_init(&par.lock, NULL);
+	pthread_cond_init(&par.cond_ready, NULL);
+	pthread_cond_init(&par.cond_space, NULL);
+
+	/*
+	 * the load functions cache column numbers in statics on their first
+	 * call, so decode the first row here before any thread is started
+	 */
+	state->row = 0;
+	par.ready[0] = (db_fn_arr[par.obj_type].pbs_db_next_obj(conn, state, &par.slots[0]) == 0) ? 1 : -1;
+	par.next_row = 1;
+
+	for (i = 0; i < nworkers; i++) {
+		if (pthread_create(&tids[i], NULL, db_search_worker, &par) != 0)
+			break;
+		started++;
+	}
+	if (stats)
+		stats->ss_workers = started;
+
+	for (row = 0; row < state->count; row++) {
+		slot = row % DB_SEARCH_WINDOW;
+
+		if ((started == 0) && (par.ready[slot] == 0)) {
+			/* no thread could be started, decode here */
+			state->row = row;
+			par.ready[slot] = (db_fn_arr[par.obj_type].pbs_db_next_obj(conn, state, &par.slots[slot]) == 0) ? 1 : -1;
+		}
+
+		t0 = db_time_now();
+		pthread_mutex_lock(&par.lock);
+		while (par.ready[slot] == 0)
+			pthread_cond_wait(&par.cond_ready, &par.lock);
+		ret = par.ready[slot];
+		pthread_mutex_unlock(&par.lock);
+		t1 = db_time_now();
+		if (stats)
+			stats->ss_wait += t1 - t0;
+
+		if (ret != 1)
+			break;
+
+		query_cb(&par.slots[slot], &refreshed);
+		if (refreshed)
+			totcount++;
+		if (stats)
+			stats->ss_callback += db_time_now() - t1;
+
+		pthread_mutex_lock(&par.lock);
+		par.ready[slot] = 0;
+		par.consumed++;
+		pthread_cond_broadcast(&par.cond_space);
+		pthread_mutex_unlock(&par.lock);
+	}
+
+	pthread_mutex_lock(&par.lock);
+	par.stop = 1;
+	pthread_cond_broadcast(&par.cond_space);
+	pthread_mutex_unlock(&par.lock);
+	for (i = 0; i < started; i++)
+		pthread_join(tids[i], NULL);
+
+	/* rows decoded but never passed on, after a decode failure */
+	for (i = 0; i < DB_SEARCH_WINDOW; i++) {
+		if (par.ready[i] != 0)
+			db_free_obj_attrs(&par.slots[i]);
+	}
+
+	pthread_cond_destroy(&par.cond_space);
+	pthread_cond_destroy(&par.cond_ready);
+	pthread_mutex_destroy(&par.lock);
+	free(tids);
+	free(objs);
+	free(par.ready);
+	free(par.slots);
+	db_destroy_state(state);
+	return totcount;
+}
+
 /**
  * @brief
  *	Get the next row from the cursor. It also is used to get the first row
@@ -871,6 +1187,84 @@ pbs_db_disconnect(void *conn)
 	return 0;
 }
 
+/**
+ * @brief
+ *	Start a transaction. Transactions may be nested, only the outermost
+ *	begin and end are sent to the database.
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return      Error code
+ * @retval	-1  - Failure
+ * @retval	 0  - Success
+ *
+ */
+int
+pbs_db_begin_trx(void *conn)
+{
+	if (conn_trx->conn_trx_nest == 0) {
+		if (db_execute_str(conn, "BEGIN") == -1)
+			return -1;
+		conn_trx->conn_trx_rollback = 0;
+	}
+	conn_trx->conn_trx_nest++;
+	return 0;
+}
+
+/**
+ * @brief
+ *	End a transaction started with pbs_db_begin_trx. If any nested level
+ *	asked for a rollback, the whole transaction is rolled back.
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	commit - PBS_DB_COMMIT or PBS_DB_ROLLBACK
+ *
+ * @return      Error code
+ * @retval	-1  - Failure, or the transaction was rolled back
+ * @retval	 0  - Success
+ *
+ */
+int
+pbs_db_end_trx(void *conn, int commit)
+{
+	if (conn_trx->conn_trx_nest == 0)
+		return -1;
+
+	if (commit == PBS_DB_ROLLBACK)
+		conn_trx->conn_trx_rollback = 1;
+
+	if (--conn_trx->conn_trx_nest > 0)
+		return 0;
+
+	if (conn_trx->conn_trx_rollback) {
+		db_execute_str(conn, "ROLLBACK");
+		return -1;
+	}
+	if (db_execute_str(conn, "COMMIT") == -1) {
+		db_execute_str(conn, "ROLLBACK");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Tell whether a transaction started with pbs_db_begin_trx is open on
+ *	the connection of the calling thread
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return      int
+ * @retval	1  - a transaction is open
+ * @retval	0  - no transaction is open
+ *
+ */
+int
+pbs_db_in_trx(void *conn)
+{
+	return (conn_trx != NULL && conn_trx->conn_trx_nest > 0);
+}
+
 /**
  * @brief
  *	Saves a new object into the database
@@ -82,11 +82,11 @@ db_prepare_job_sqls(void *conn)
 		"ji_qrank,"
 		"ji_savetm,"
 		"ji_creattm,"
-		"attributes"
+		"attrs_bin"
 		") "
 		"values ($1, $2, $3, $4, $5, $6, $7, $8, $9, "
 		"$10, $11, $12, $13, $14, $15, $16, "
-		"localtimestamp, localtimestamp, hstore($17::text[]))");
+		"localtimestamp, localtimestamp, $17)");
 	if (db_prepare_stmt(conn, STMT_INSERT_JOB, conn_sql, 17) != 0)
 		return -1;
 
@@ -107,25 +107,46 @@ db_prepare_job_sqls(void *conn)
 		"ji_credtype = $15,"
 		"ji_qrank = $16,"
 		"ji_savetm = localtimestamp,"
-		"attributes = attributes || hstore($17::text[]) "
-		"where ji_jobid = $1");
+		"attrs_bin = attrs_bin || $17, "
+		"attr_nupd = attr_nupd + 1 "
+		"where ji_jobid = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_UPDATE_JOB, conn_sql, 17) != 0)
 		return -1;
 
 	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.job set "
 		"ji_savetm = localtimestamp,"
-		"attributes = attributes || hstore($2::text[]) "
-		"where ji_jobid = $1");
+		"attrs_bin = attrs_bin || $2, "
+		"attr_nupd = attr_nupd + 1 "
+		"where ji_jobid = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_UPDATE_JOB_ATTRSONLY, conn_sql, 2) != 0)
 		return -1;
 
 	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.job set "
 		"ji_savetm = localtimestamp,"
-		"attributes = attributes - hstore($2::text[]) "
-		"where ji_jobid = $1");
+		"attrs_bin = attrs_bin || $2, "
+		"attr_nupd = attr_nupd + 1 "
+		"where ji_jobid = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_REMOVE_JOBATTRS, conn_sql, 2) != 0)
 		return -1;
 
+	snprintf(conn_sql, MAX_SQL_LENGTH, "select "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
+		"from pbs.job where ji_jobid = $1");
+	if (db_prepare_stmt(conn, STMT_SELECT_JOB_ATTRS, conn_sql, 1) != 0)
+		return -1;
+
+	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.job set "
+		"attributes = '', "
+		"attrs_bin = $2, "
+		"attr_nupd = 0 "
+		"where ji_jobid = $1");
+	if (db_prepare_stmt(conn, STMT_COMPACT_JOB_ATTRS, conn_sql, 2) != 0)
+		return -1;
+
 	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.job set "
 		"ji_state = $2,"
 		"ji_substate = $3,"
@@ -164,7 +185,8 @@ db_prepare_job_sqls(void *conn)
 		"ji_jid,"
 		"ji_credtype,"
 		"ji_qrank,"
-		"hstore_to_array(attributes) as attributes "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
 		"from pbs.job where ji_jobid = $1");
 	if (db_prepare_stmt(conn, STMT_SELECT_JOB, conn_sql, 1) != 0)
 		return -1;
@@ -214,7 +236,8 @@ db_prepare_job_sqls(void *conn)
 		"ji_jid,"
 		"ji_credtype,"
 		"ji_qrank,"
-		"hstore_to_array(attributes) as attributes "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
 		"from pbs.job order by ji_qrank");
 	if (db_prepare_stmt(conn, STMT_FINDJOBS_ORDBY_QRANK, conn_sql, 0) != 0)
 		return -1;
@@ -236,7 +259,8 @@ db_prepare_job_sqls(void *conn)
 		"ji_jid,"
 		"ji_credtype,"
 		"ji_qrank,"
-		"hstore_to_array(attributes) as attributes "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
 		"from pbs.job where ji_queue = $1"
 		" order by ji_qrank");
 	if (db_prepare_stmt(conn, STMT_FINDJOBS_BYQUE_ORDBY_QRANK,
@@ -270,7 +294,6 @@ db_prepare_job_sqls(void *conn)
 static int
 load_job(const  PGresult *res, pbs_db_job_info_t *pj, int row)
 {
-	char *raw_array;
 	static int ji_jobid_fnum;
 	static int ji_state_fnum;
 	static int ji_substate_fnum;
@@ -288,6 +311,7 @@ load_job(const  PGresult *res, pbs_db_job_info_t *pj, int row)
 	static int ji_credtype_fnum;
 	static int ji_qrank_fnum;
 	static int attributes_fnum;
+	static int attrs_bin_fnum;
 	static int fnums_inited = 0;
 
 	if (fnums_inited == 0) {
@@ -309,6 +333,7 @@ load_job(const  PGresult *res, pbs_db_job_info_t *pj, int row)
 		ji_qrank_fnum = PQfnumber(res, "ji_qrank");
 		ji_credtype_fnum = PQfnumber(res, "ji_credtype");
 		attributes_fnum = PQfnumber(res, "attributes");
+		attrs_bin_fnum = PQfnumber(res, "attrs_bin");
 		fnums_inited = 1;
 	}
 
@@ -328,10 +353,8 @@ load_job(const  PGresult *res, pbs_db_job_info_t *pj, int row)
 	GET_PARAM_STR(res, row, pj->ji_jid, ji_jid_fnum);
 	GET_PARAM_INTEGER(res, row, pj->ji_credtype, ji_credtype_fnum);
 	GET_PARAM_BIGINT(res, row, pj->ji_qrank, ji_qrank_fnum);
-	GET_PARAM_BIN(res, row, raw_array, attributes_fnum);
 
-	/* convert attributes from postgres raw array format */
-	return (dbarray_to_attrlist(raw_array, &pj->db_attr_list));
+	return (db_load_attrs(res, row, attributes_fnum, attrs_bin_fnum, &pj->db_attr_list));
 }
 
 /**
@@ -382,9 +405,9 @@ pbs_db_save_job(void *conn, pbs_db_obj_info_t *obj, int savetype)
 
 	if ((pjob->db_attr_list.attr_count > 0) || (savetype & OBJ_SAVE_NEW)) {
 		int len = 0;
-		/* convert attributes to postgres raw array format */
+		/* convert attributes to binary attribute records */
 
-		if ((len = attrlist_to_dbarray(&raw_array, &pjob->db_attr_list)) <= 0)
+		if ((len = attrlist_to_dbbin(&raw_array, &pjob->db_attr_list, DB_ATTR_SET)) < 0)
 			return -1;
 
 		if (savetype & OBJ_SAVE_QS) {
@@ -399,9 +422,10 @@ pbs_db_save_job(void *conn, pbs_db_obj_info_t *obj, int savetype)
 	}
 
 	if (savetype & OBJ_SAVE_NEW)
-		stmt = STMT_INSERT_JOB;
-
-	if (stmt)
+		rc = db_cmd(conn, STMT_INSERT_JOB, params);
+	else if (raw_array)
+		rc = db_cmd_attrs(conn, stmt, params, STMT_SELECT_JOB_ATTRS, STMT_COMPACT_JOB_ATTRS, pjob->ji_jobid);
+	else if (stmt)
 		rc = db_cmd(conn, stmt, params);
 
 	return rc;
@@ -641,13 +665,13 @@ pbs_db_del_attr_job(void *conn, void *obj_id, pbs_db_attr_list_t *attr_list)
 	int len = 0;
 	int rc = 0;
 
-	if ((len = attrlist_to_dbarray_ex(&raw_array, attr_list, 1)) <= 0)
+	if ((len = attrlist_to_dbbin(&raw_array, attr_list, DB_ATTR_UNSET)) <= 0)
 		return -1;
 
 	SET_PARAM_STR(conn_data, obj_id, 0);
 	SET_PARAM_BIN(conn_data, raw_array, len, 1);
 
-	rc = db_cmd(conn, STMT_REMOVE_JOBATTRS, 2);
+	rc = db_cmd_attrs(conn, STMT_REMOVE_JOBATTRS, 2, STMT_SELECT_JOB_ATTRS, STMT_COMPACT_JOB_ATTRS, obj_id);
 
 	return rc;
 }
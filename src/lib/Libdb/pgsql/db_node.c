@@ -75,10 +75,10 @@ db_prepare_node_sqls(void *conn)
 		"nd_pque, "
 		"nd_savetm, "
 		"nd_creattm, "
-		"attributes "
+		"attrs_bin "
 		") "
 		"values "
-		"($1, $2, $3, $4, $5, $6, $7, localtimestamp, localtimestamp, hstore($8::text[]))");
+		"($1, $2, $3, $4, $5, $6, $7, localtimestamp, localtimestamp, $8)");
 	if (db_prepare_stmt(conn, STMT_INSERT_NODE, conn_sql, 8) != 0)
 		return -1;
 
@@ -91,8 +91,10 @@ db_prepare_node_sqls(void *conn)
 		"nd_ntype = $6, "
 		"nd_pque = $7, "
 		"nd_savetm = localtimestamp, "
-		"attributes = attributes || hstore($8::text[]) "
-		"where nd_name = $1");
+		"attrs_bin = attrs_bin || $8, "
+		"attr_nupd = attr_nupd + 1 "
+		"where nd_name = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_UPDATE_NODE, conn_sql, 8) != 0)
 		return -1;
 
@@ -110,18 +112,37 @@ db_prepare_node_sqls(void *conn)
 
 	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.node set "
 		"nd_savetm = localtimestamp,"
-		"attributes = attributes || hstore($2::text[]) "
-		"where nd_name = $1");
+		"attrs_bin = attrs_bin || $2, "
+		"attr_nupd = attr_nupd + 1 "
+		"where nd_name = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_UPDATE_NODE_ATTRSONLY, conn_sql, 2) != 0)
 		return -1;
 
 	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.node set "
 		"nd_savetm = localtimestamp,"
-		"attributes = attributes - $2::text[] "
-		"where nd_name = $1");
+		"attrs_bin = attrs_bin || $2, "
+		"attr_nupd = attr_nupd + 1 "
+		"where nd_name = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_REMOVE_NODEATTRS, conn_sql, 2) != 0)
 		return -1;
 
+	snprintf(conn_sql, MAX_SQL_LENGTH, "select "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
+		"from pbs.node where nd_name = $1");
+	if (db_prepare_stmt(conn, STMT_SELECT_NODE_ATTRS, conn_sql, 1) != 0)
+		return -1;
+
+	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.node set "
+		"attributes = '', "
+		"attrs_bin = $2, "
+		"attr_nupd = 0 "
+		"where nd_name = $1");
+	if (db_prepare_stmt(conn, STMT_COMPACT_NODE_ATTRS, conn_sql, 2) != 0)
+		return -1;
+
 	snprintf(conn_sql, MAX_SQL_LENGTH, "select "
 		"nd_name, "
 		"nd_index, "
@@ -130,7 +151,8 @@ db_prepare_node_sqls(void *conn)
 		"nd_state, "
 		"nd_ntype, "
 		"nd_pque, "
-		"hstore_to_array(attributes) as attributes "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
 		"from pbs.node "
 		"where nd_name = $1");
 	if (db_prepare_stmt(conn, STMT_SELECT_NODE, conn_sql, 1) != 0)
@@ -144,7 +166,8 @@ db_prepare_node_sqls(void *conn)
 		"nd_state, "
 		"nd_ntype, "
 		"nd_pque, "
-		"hstore_to_array(attributes) as attributes "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
 		"from pbs.node order by nd_creattm");
 	if (db_prepare_stmt(conn, STMT_FIND_NODES_ORDBY_CREATTM, conn_sql, 0) != 0)
 		return -1;
@@ -166,7 +189,8 @@ db_prepare_node_sqls(void *conn)
 		"nd_state, "
 		"nd_ntype, "
 		"nd_pque, "
-		"hstore_to_array(attributes) as attributes "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
 		"from pbs.node order by nd_index, nd_creattm");
 #endif /* localmod 079 */
 	if (db_prepare_stmt(conn, STMT_FIND_NODES_ORDBY_INDEX, conn_sql, 0) != 0)
@@ -217,7 +241,6 @@ db_prepare_node_sqls(void *conn)
 static int
 load_node(PGresult *res, pbs_db_node_info_t *pnd, int row)
 {
-	char *raw_array;
 	static int nd_name_fnum;
 	static int mom_modtime_fnum;
 	static int nd_hostname_fnum;
@@ -225,6 +248,7 @@ load_node(PGresult *res, pbs_db_node_info_t *pnd, int row)
 	static int nd_ntype_fnum;
 	static int nd_pque_fnum;
 	static int attributes_fnum;
+	static int attrs_bin_fnum;
 	static int fnums_inited = 0;
 
 	if (fnums_inited == 0) {
@@ -235,6 +259,7 @@ load_node(PGresult *res, pbs_db_node_info_t *pnd, int row)
 		nd_ntype_fnum = PQfnumber(res, "nd_ntype");
 		nd_pque_fnum = PQfnumber(res, "nd_pque");
 		attributes_fnum = PQfnumber(res, "attributes");
+		attrs_bin_fnum = PQfnumber(res, "attrs_bin");
 		fnums_inited = 1;
 	}
 
@@ -244,10 +269,8 @@ load_node(PGresult *res, pbs_db_node_info_t *pnd, int row)
 	GET_PARAM_INTEGER(res, row, pnd->nd_state, nd_state_fnum);
 	GET_PARAM_INTEGER(res, row, pnd->nd_ntype, nd_ntype_fnum);
 	GET_PARAM_STR(res, row, pnd->nd_pque, nd_pque_fnum);
-	GET_PARAM_BIN(res, row, raw_array, attributes_fnum);
 
-	/* convert attributes from postgres raw array format */
-	return (dbarray_to_attrlist(raw_array, &pnd->db_attr_list));
+	return (db_load_attrs(res, row, attributes_fnum, attrs_bin_fnum, &pnd->db_attr_list));
 }
 
 /**
@@ -286,8 +309,8 @@ pbs_db_save_node(void *conn, pbs_db_obj_info_t *obj, int savetype)
 
 	if ((pnd->db_attr_list.attr_count > 0) || (savetype & OBJ_SAVE_NEW)) {
 		int len = 0;
-		/* convert attributes to postgres raw array format */
-		if ((len = attrlist_to_dbarray(&raw_array, &pnd->db_attr_list)) <= 0)
+		/* convert attributes to binary attribute records */
+		if ((len = attrlist_to_dbbin(&raw_array, &pnd->db_attr_list, DB_ATTR_SET)) < 0)
 			return -1;
 
 		if (savetype & OBJ_SAVE_QS) {
@@ -302,9 +325,10 @@ pbs_db_save_node(void *conn, pbs_db_obj_info_t *obj, int savetype)
 	}
 
 	if (savetype & OBJ_SAVE_NEW)
-		stmt = STMT_INSERT_NODE;
-
-	if (stmt)
+		rc = db_cmd(conn, STMT_INSERT_NODE, params);
+	else if (raw_array)
+		rc = db_cmd_attrs(conn, stmt, params, STMT_SELECT_NODE_ATTRS, STMT_COMPACT_NODE_ATTRS, pnd->nd_name);
+	else if (stmt)
 		rc = db_cmd(conn, stmt, params);
 
 	return rc;
@@ -440,13 +464,13 @@ pbs_db_del_attr_node(void *conn, void *obj_id, pbs_db_attr_list_t *attr_list)
 	int len = 0;
 	int rc = 0;
 
-	if ((len = attrlist_to_dbarray_ex(&raw_array, attr_list, 1)) <= 0)
+	if ((len = attrlist_to_dbbin(&raw_array, attr_list, DB_ATTR_UNSET)) <= 0)
 		return -1;
 
 	SET_PARAM_STR(conn_data, obj_id, 0);
 	SET_PARAM_BIN(conn_data, raw_array, len, 1);
 
-	rc = db_cmd(conn, STMT_REMOVE_NODEATTRS, 2);
+	rc = db_cmd_attrs(conn, STMT_REMOVE_NODEATTRS, 2, STMT_SELECT_NODE_ATTRS, STMT_COMPACT_NODE_ATTRS, obj_id);
 
 	return rc;
 }
@@ -92,6 +92,8 @@ extern "C" {
 #define STMT_FINDJOBS_BYQUE_ORDBY_QRANK "findjobs_byque_ordby_qrank"
 #define STMT_DELETE_JOB "delete_job"
 #define STMT_REMOVE_JOBATTRS "remove_jobattrs"
+#define STMT_SELECT_JOB_ATTRS "select_job_attrs"
+#define STMT_COMPACT_JOB_ATTRS "compact_job_attrs"
 
 /* JOBSCR stands for job script */
 #define STMT_INSERT_JOBSCR "insert_jobscr"
@@ -106,6 +108,8 @@ extern "C" {
 #define STMT_SELECT_RESV "select_resv"
 #define STMT_DELETE_RESV "delete_resv"
 #define STMT_REMOVE_RESVATTRS "remove_resvattrs"
+#define STMT_SELECT_RESV_ATTRS "select_resv_attrs"
+#define STMT_COMPACT_RESV_ATTRS "compact_resv_attrs"
 
 /* creattm is the table field that holds the creation time */
 #define STMT_FINDRESVS_ORDBY_CREATTM "findresvs_ordby_creattm"
@@ -141,6 +145,8 @@ extern "C" {
 #define STMT_DELETE_NODE "delete_node"
 #define STMT_REMOVE_NODEATTRS "remove_nodeattrs"
 #define STMT_UPDATE_NODEATTRS "update_nodeattrs"
+#define STMT_SELECT_NODE_ATTRS "select_node_attrs"
+#define STMT_COMPACT_NODE_ATTRS "compact_node_attrs"
 #define STMT_FIND_NODES_ORDBY_CREATTM "find_nodes_ordby_creattm"
 #define STMT_FIND_NODES_ORDBY_INDEX "find_nodes_ordby_index"
 #define STMT_SELECT_MOMINFO_TIME "select_mominfo_time"
@@ -196,8 +202,8 @@ struct pg_conn_trx
 };
 typedef struct pg_conn_trx pg_conn_trx_t;
 
-extern pg_conn_data_t *conn_data;
-extern pg_conn_trx_t *conn_trx;
+extern __thread pg_conn_data_t *conn_data;
+extern __thread pg_conn_trx_t *conn_trx;
 
 /**
  * @brief
@@ -326,6 +332,13 @@ typedef struct postgres_db_fn pg_db_fn_t;
 
 #define FIND_JOBS_BY_QUE 1
 
+/* binary attribute record operations, see db_attr.c */
+#define DB_ATTR_SET	1
+#define DB_ATTR_UNSET	2
+
+/* appends of attribute records after which an object's records are folded */
+#define DB_ATTR_COMPACT_UPDATES 64
+
 /* common functions */
 int db_prepare_job_sqls(void *conn);
 int db_prepare_resv_sqls(void *conn);
@@ -342,6 +355,11 @@ unsigned long long db_ntohll(unsigned long long);
 int dbarray_to_attrlist(char *raw_array, pbs_db_attr_list_t *attr_list);
 int attrlist_to_dbarray(char **raw_array, pbs_db_attr_list_t *attr_list);
 int attrlist_to_dbarray_ex(char **raw_array, pbs_db_attr_list_t *attr_list, int keys_only);
+int attrlist_to_dbbin(char **bin, pbs_db_attr_list_t *attr_list, int op);
+int dbbin_to_attrlist(char *bin, int binlen, pbs_db_attr_list_t *attr_list);
+int db_load_attrs(const PGresult *res, int row, int hstore_fnum, int bin_fnum, pbs_db_attr_list_t *attr_list);
+int db_cmd_attrs(void *conn, char *stmt, int num_vars, char *select_stmt, char *compact_stmt, char *id);
+void db_free_attrlist(pbs_db_attr_list_t *attr_list);
 
 /* job functions */
 int pbs_db_save_job(void *conn, pbs_db_obj_info_t *obj, int savetype);
@@ -76,11 +76,11 @@ db_prepare_resv_sqls(void *conn)
 		"ri_svrflags, "
 		"ri_savetm, "
 		"ri_creattm, "
-		"attributes "
+		"attrs_bin "
 		") "
 		"values "
 		"($1, $2, $3, $4, $5, $6, $7, $8, $9, "
-		"localtimestamp, localtimestamp, hstore($10::text[]))");
+		"localtimestamp, localtimestamp, $10)");
 	if (db_prepare_stmt(conn, STMT_INSERT_RESV, conn_sql, 10) != 0)
 		return -1;
 
@@ -94,8 +94,10 @@ db_prepare_resv_sqls(void *conn)
 		"ri_tactive = $8, "
 		"ri_svrflags = $9, "
 		"ri_savetm = localtimestamp, "
-		"attributes = attributes || hstore($10::text[]) "
-		"where ri_resvID = $1");
+		"attrs_bin = attrs_bin || $10, "
+		"attr_nupd = attr_nupd + 1 "
+		"where ri_resvID = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_UPDATE_RESV, conn_sql, 10) != 0)
 		return -1;
 
@@ -115,18 +117,37 @@ db_prepare_resv_sqls(void *conn)
 
 	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.resv set "
 		"ri_savetm = localtimestamp, "
-		"attributes = attributes || hstore($2::text[]) "
-		"where ri_resvID = $1");
+		"attrs_bin = attrs_bin || $2, "
+		"attr_nupd = attr_nupd + 1 "
+		"where ri_resvID = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_UPDATE_RESV_ATTRSONLY, conn_sql, 2) != 0)
 		return -1;
 
 	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.resv set "
 		"ri_savetm = localtimestamp,"
-		"attributes = attributes - $2::text[] "
-		"where ri_resvID = $1");
+		"attrs_bin = attrs_bin || $2, "
+		"attr_nupd = attr_nupd + 1 "
+		"where ri_resvID = $1 "
+		"returning attr_nupd");
 	if (db_prepare_stmt(conn, STMT_REMOVE_RESVATTRS, conn_sql, 2) != 0)
 		return -1;
 
+	snprintf(conn_sql, MAX_SQL_LENGTH, "select "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
+		"from pbs.resv where ri_resvID = $1");
+	if (db_prepare_stmt(conn, STMT_SELECT_RESV_ATTRS, conn_sql, 1) != 0)
+		return -1;
+
+	snprintf(conn_sql, MAX_SQL_LENGTH, "update pbs.resv set "
+		"attributes = '', "
+		"attrs_bin = $2, "
+		"attr_nupd = 0 "
+		"where ri_resvID = $1");
+	if (db_prepare_stmt(conn, STMT_COMPACT_RESV_ATTRS, conn_sql, 2) != 0)
+		return -1;
+
 	snprintf(conn_sql, MAX_SQL_LENGTH, "select "
 		"ri_resvID, "
 		"ri_queue, "
@@ -137,7 +158,8 @@ db_prepare_resv_sqls(void *conn)
 		"ri_duration, "
 		"ri_tactive, "
 		"ri_svrflags, "
-		"hstore_to_array(attributes) as attributes "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
 		"from pbs.resv where ri_resvid = $1");
 	if (db_prepare_stmt(conn, STMT_SELECT_RESV, conn_sql, 1) != 0)
 		return -1;
@@ -152,7 +174,8 @@ db_prepare_resv_sqls(void *conn)
 		"ri_duration, "
 		"ri_tactive, "
 		"ri_svrflags, "
-		"hstore_to_array(attributes) as attributes "
+		"hstore_to_array(attributes) as attributes, "
+		"attrs_bin "
 		"from pbs.resv "
 		"order by ri_creattm");
 	if (db_prepare_stmt(conn, STMT_FINDRESVS_ORDBY_CREATTM,
@@ -182,7 +205,6 @@ db_prepare_resv_sqls(void *conn)
 static int
 load_resv(PGresult *res, pbs_db_resv_info_t *presv, int row)
 {
-	char *raw_array;
 	static int ri_resvid_fnum;
 	static int ri_queue_fnum;
 	static int ri_state_fnum;
@@ -193,6 +215,7 @@ load_resv(PGresult *res, pbs_db_resv_info_t *presv, int row)
 	static int ri_tactive_fnum;
 	static int ri_svrflags_fnum;
 	static int attributes_fnum;
+	static int attrs_bin_fnum;
 	static int fnums_inited = 0;
 
 	if (fnums_inited == 0) {
@@ -206,6 +229,7 @@ load_resv(PGresult *res, pbs_db_resv_info_t *presv, int row)
 		ri_tactive_fnum = PQfnumber(res, "ri_tactive");
 		ri_svrflags_fnum = PQfnumber(res, "ri_svrflags");
 		attributes_fnum = PQfnumber(res, "attributes");
+		attrs_bin_fnum = PQfnumber(res, "attrs_bin");
 		fnums_inited = 1;
 	}
 
@@ -218,10 +242,8 @@ load_resv(PGresult *res, pbs_db_resv_info_t *presv, int row)
 	GET_PARAM_BIGINT(res, row, presv->ri_duration, ri_duration_fnum);
 	GET_PARAM_INTEGER(res, row, presv->ri_tactive, ri_tactive_fnum);
 	GET_PARAM_INTEGER(res, row, presv->ri_svrflags, ri_svrflags_fnum);
-	GET_PARAM_BIN(res, row, raw_array, attributes_fnum);
 
-	/* convert attributes from postgres raw array format */
-	return (dbarray_to_attrlist(raw_array, &presv->db_attr_list));
+	return (db_load_attrs(res, row, attributes_fnum, attrs_bin_fnum, &presv->db_attr_list));
 }
 
 /**
@@ -262,8 +284,8 @@ pbs_db_save_resv(void *conn, pbs_db_obj_info_t *obj, int savetype)
 
 	if ((presv->db_attr_list.attr_count > 0) || (savetype & OBJ_SAVE_NEW)) {
 		int len = 0;
-		/* convert attributes to postgres raw array format */
-		if ((len = attrlist_to_dbarray(&raw_array, &presv->db_attr_list)) <= 0)
+		/* convert attributes to binary attribute records */
+		if ((len = attrlist_to_dbbin(&raw_array, &presv->db_attr_list, DB_ATTR_SET)) < 0)
 			return -1;
 
 		if (savetype & OBJ_SAVE_QS) {
@@ -278,9 +300,10 @@ pbs_db_save_resv(void *conn, pbs_db_obj_info_t *obj, int savetype)
 	}
 
 	if (savetype & OBJ_SAVE_NEW)
-		stmt = STMT_INSERT_RESV;
-
-	if (stmt)
+		rc = db_cmd(conn, STMT_INSERT_RESV, params);
+	else if (raw_array)
+		rc = db_cmd_attrs(conn, stmt, params, STMT_SELECT_RESV_ATTRS, STMT_COMPACT_RESV_ATTRS, presv->ri_resvid);
+	else if (stmt)
 		rc = db_cmd(conn, stmt, params);
 
 	return rc;
@@ -420,13 +443,13 @@ pbs_db_del_attr_resv(void *conn, void *obj_id, pbs_db_attr_list_t *attr_list)
 	int len = 0;
 	int rc = 0;
 
-	if ((len = attrlist_to_dbarray_ex(&raw_array, attr_list, 1)) <= 0)
+	if ((len = attrlist_to_dbbin(&raw_array, attr_list, DB_ATTR_UNSET)) <= 0)
 		return -1;
 
 	SET_PARAM_STR(conn_data, obj_id, 0);
 	SET_PARAM_BIN(conn_data, raw_array, len, 1);
 
-	rc = db_cmd(conn, STMT_REMOVE_RESVATTRS, 2);
+	rc = db_cmd_attrs(conn, STMT_REMOVE_RESVATTRS, 2, STMT_SELECT_RESV_ATTRS, STMT_COMPACT_RESV_ATTRS, obj_id);
 
 	return rc;
 }
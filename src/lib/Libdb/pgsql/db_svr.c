@@ -50,7 +50,7 @@
 #include <errno.h>
 #include "db_postgres.h"
 
-extern char *errmsg_cache;
+extern __thread char *errmsg_cache;
 static int pbs_db_truncate_all(void *conn);
 
 /**
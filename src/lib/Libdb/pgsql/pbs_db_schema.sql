@@ -56,7 +56,7 @@ CREATE TABLE pbs.info (
     pbs_schema_version TEXT    NOT NULL
 );
 
-INSERT INTO pbs.info values('1.5.0'); /* schema version */
+INSERT INTO pbs.info values('1.6.0'); /* schema version */
 
 ---------------------- SERVER ------------------------------
 
@@ -108,6 +108,8 @@ CREATE TABLE pbs.node (
     nd_savetm       TIMESTAMP   NOT NULL,
     nd_creattm      TIMESTAMP   NOT NULL,
     attributes      hstore      NOT NULL default '',
+    attrs_bin       BYTEA       NOT NULL default '',
+    attr_nupd       INTEGER     NOT NULL default 0,
     CONSTRAINT pbsnode_pk PRIMARY KEY (nd_name)
 );
 CREATE INDEX nd_idx_cr
@@ -150,6 +152,8 @@ CREATE TABLE pbs.resv (
     ri_savetm       TIMESTAMP   NOT NULL,
     ri_creattm      TIMESTAMP   NOT NULL,
     attributes      hstore      NOT NULL default '',
+    attrs_bin       BYTEA       NOT NULL default '',
+    attr_nupd       INTEGER     NOT NULL default 0,
     CONSTRAINT resv_pk PRIMARY KEY (ri_resvID)
 );
 
@@ -179,6 +183,8 @@ CREATE TABLE pbs.job (
     ji_savetm       TIMESTAMP   NOT NULL,
     ji_creattm      TIMESTAMP   NOT NULL,
     attributes      hstore      NOT NULL default '',
+    attrs_bin       BYTEA       NOT NULL default '',
+    attr_nupd       INTEGER     NOT NULL default 0,
     CONSTRAINT jobid_pk PRIMARY KEY (ji_jobid)
 );
 
@@ -0,0 +1,506 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	dis2.c
+ *
+ * @brief
+ *	Binary encoding (DIS version 2) behind the dis* routines.
+ *
+ * @par
+ *	Once a channel has been switched to DIS_VERSION_2 with
+ *	dis_set_version(), the public dis* routines hand their data to the
+ *	routines here instead of formatting it as ASCII digits.  Callers see
+ *	the same API and the same error codes.  Every datum starts with a tag
+ *	byte:
+ *
+ *	0x00-0x08  non-negative integer, the low nibble is the number of
+ *		   little-endian bytes of the value that follow
+ *	0x10-0x18  negative integer, the magnitude follows as above
+ *	0x20	   real, the 8 bytes of an IEEE 754 double, little-endian
+ *	0x30	   string, a 4 byte little-endian length then the characters
+ *	0x31	   string token, the 2 byte little-endian index of a string
+ *		   sent earlier in the same pkt
+ *
+ *	Strings of at most DIS2_TOKEN_MAXLEN characters are numbered in the
+ *	order they are sent, separately for each pkt, up to DIS2_MAX_TOKENS
+ *	per pkt, and later copies in the same pkt are sent as tokens.  This
+ *	turns the attribute and resource names repeated for every object of a
+ *	status reply into 3 byte tokens without any table shared between
+ *	versions of PBS.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dis.h"
+#include "dis_.h"
+
+#define DIS2_NEGINT		0x10
+#define DIS2_REAL		0x20
+#define DIS2_STR		0x30
+#define DIS2_TOKEN		0x31
+
+#define DIS2_TOKEN_MAXLEN	64
+#define DIS2_MAX_TOKENS		1024
+#define DIS2_HASH_SIZE		2048	/* power of 2, twice DIS2_MAX_TOKENS */
+
+/* tokens of the pkt being written, slots hash the strings to token numbers */
+typedef struct dis2_wdict {
+	unsigned int	gen;			/* generation of the slots in use */
+	int		ntok;
+	unsigned int	off[DIS2_MAX_TOKENS];	/* offset in the write buffer */
+	unsigned char	len[DIS2_MAX_TOKENS];
+	unsigned int	slot[DIS2_HASH_SIZE];	/* gen << 16 | (token + 1) */
+} dis2_wdict_t;
+
+/* tokens of the pkt being read, pointing into the read buffer */
+typedef struct dis2_rdict {
+	int		ntok;
+	char		*ptr[DIS2_MAX_TOKENS];
+	unsigned char	len[DIS2_MAX_TOKENS];
+} dis2_rdict_t;
+
+/**
+ * @brief
+ *	dis_get_version - get the DIS encoding used on a channel
+ *
+ * @param[in] fd - file descriptor
+ *
+ * @return int
+ * @retval DIS_VERSION_1 or DIS_VERSION_2
+ *
+ */
+int
+dis_get_version(int fd)
+{
+	pbs_tcp_chan_t *chan = transport_get_chan(fd);
+
+	if (chan == NULL || chan->dis_version != DIS_VERSION_2)
+		return DIS_VERSION_1;
+	return DIS_VERSION_2;
+}
+
+/**
+ * @brief
+ *	dis_set_version - switch the DIS encoding used on a channel, for both
+ *	directions.  Must be called between pkts, with nothing buffered.
+ *
+ * @param[in] fd - file descriptor
+ * @param[in] version - DIS_VERSION_1 or DIS_VERSION_2
+ *
+ * @return void
+ *
+ */
+void
+dis_set_version(int fd, int version)
+{
+	pbs_tcp_chan_t *chan = transport_get_chan(fd);
+
+	if (chan == NULL)
+		return;
+	if (version == DIS_VERSION_2) {
+		if (chan->dis2_rdict == NULL)
+			chan->dis2_rdict = calloc(1, sizeof(dis2_rdict_t));
+		if (chan->dis2_wdict == NULL) {
+			chan->dis2_wdict = calloc(1, sizeof(dis2_wdict_t));
+			if (chan->dis2_wdict != NULL)
+				((dis2_wdict_t *) chan->dis2_wdict)->gen = 1;
+		}
+		if (chan->dis2_rdict == NULL || chan->dis2_wdict == NULL)
+			return;	/* stay with ASCII DIS */
+	}
+	chan->dis_version = version;
+}
+
+/**
+ * @brief
+ *	dis2_new_wpkt - forget the string tokens of the last pkt written,
+ *	called by dis_puts() when it starts a new pkt
+ *
+ * @param[in] fd - file descriptor
+ *
+ * @return void
+ *
+ */
+void
+dis2_new_wpkt(int fd)
+{
+	pbs_tcp_chan_t *chan = transport_get_chan(fd);
+	dis2_wdict_t *wd;
+
+	if (chan == NULL || (wd = chan->dis2_wdict) == NULL)
+		return;
+	wd->ntok = 0;
+	wd->gen = (wd->gen + 1) & 0xffff;
+	if (wd->gen == 0) {
+		/* stale slots could now look current */
+		memset(wd->slot, 0, sizeof(wd->slot));
+		wd->gen = 1;
+	}
+}
+
+/**
+ * @brief
+ *	Take the next ct bytes of the pkt being read.
+ *
+ * @param[in] stream - file descriptor
+ * @param[in] chan - channel of stream
+ * @param[in] ct - number of bytes
+ * @param[out] data - set to the bytes, in the read buffer
+ *
+ * @return int
+ * @retval DIS_SUCCESS, DIS_EOD, DIS_EOF or DIS_PROTO
+ *
+ */
+static int
+dis2_take(int stream, pbs_tcp_chan_t *chan, size_t ct, char **data)
+{
+	int rc;
+
+	if ((rc = dis_fill_readbuf(stream)) < 0)
+		return (rc == -2 ? DIS_EOF : DIS_EOD);
+	if (rc == 1)
+		((dis2_rdict_t *) chan->dis2_rdict)->ntok = 0; /* new pkt */
+	if (chan->readbuf.tdis_len < ct)
+		return DIS_PROTO;	/* a datum never spans pkts */
+	*data = chan->readbuf.tdis_pos;
+	chan->readbuf.tdis_pos += ct;
+	chan->readbuf.tdis_len -= ct;
+	return DIS_SUCCESS;
+}
+
+/**
+ * @brief
+ *	Decode n little-endian bytes.
+ */
+static u_Long
+dis2_getle(const unsigned char *cp, int n)
+{
+	u_Long value = 0;
+
+	while (n-- > 0)
+		value = (value << 8) | cp[n];
+	return value;
+}
+
+/**
+ * @brief
+ *	dis2_wint - write an integer
+ *
+ * @param[in] stream - file descriptor
+ * @param[in] negate - non-zero if the value is negative
+ * @param[in] value - magnitude of the value
+ *
+ * @return int
+ * @retval DIS_SUCCESS or DIS_PROTO
+ *
+ */
+int
+dis2_wint(int stream, int negate, u_Long value)
+{
+	unsigned char buf[1 + sizeof(u_Long)];
+	int n = 0;
+
+	while (value != 0) {
+		buf[++n] = (unsigned char) (value & 0xff);
+		value >>= 8;
+	}
+	buf[0] = (negate ? DIS2_NEGINT : 0) | n;
+	return (dis_puts(stream, (char *) buf, n + 1) < 0 ? DIS_PROTO : DIS_SUCCESS);
+}
+
+/**
+ * @brief
+ *	dis2_rint - read an integer
+ *
+ * @param[in] stream - file descriptor
+ * @param[out] negate - set to non-zero if the value is negative
+ * @param[out] value - magnitude of the value, max on overflow
+ * @param[in] max - largest magnitude the caller can take
+ *
+ * @return int
+ * @retval DIS_SUCCESS or a DIS error code
+ *
+ */
+int
+dis2_rint(int stream, int *negate, u_Long *value, u_Long max)
+{
+	pbs_tcp_chan_t *chan = transport_get_chan(stream);
+	char *cp;
+	int tag;
+	int n;
+	int rc;
+
+	*negate = FALSE;
+	if (chan == NULL)
+		return DIS_PROTO;
+	if ((rc = dis2_take(stream, chan, 1, &cp)) != DIS_SUCCESS)
+		return rc;
+	tag = *(unsigned char *) cp;
+	n = tag & 0x0f;
+	if ((tag & ~0x0f) > DIS2_NEGINT || n > (int) sizeof(u_Long))
+		return DIS_NONDIGIT;
+	if (n > 0 && (rc = dis2_take(stream, chan, n, &cp)) != DIS_SUCCESS)
+		return rc;
+	*negate = (tag & DIS2_NEGINT) != 0;
+	*value = n > 0 ? dis2_getle((unsigned char *) cp, n) : 0;
+	if (*value > max) {
+		*value = max;
+		return DIS_OVERFLOW;
+	}
+	return DIS_SUCCESS;
+}
+
+/**
+ * @brief
+ *	dis2_wreal - write a real number
+ *
+ * @param[in] stream - file descriptor
+ * @param[in] value - value, long doubles are narrowed to double
+ *
+ * @return int
+ * @retval DIS_SUCCESS or DIS_PROTO
+ *
+ */
+int
+dis2_wreal(int stream, double value)
+{
+	unsigned char buf[1 + sizeof(u_Long)];
+	u_Long bits;
+	int i;
+
+	memcpy(&bits, &value, sizeof(bits));
+	buf[0] = DIS2_REAL;
+	for (i = 1; i <= (int) sizeof(u_Long); i++) {
+		buf[i] = (unsigned char) (bits & 0xff);
+		bits >>= 8;
+	}
+	return (dis_puts(stream, (char *) buf, sizeof(buf)) < 0 ? DIS_PROTO : DIS_SUCCESS);
+}
+
+/**
+ * @brief
+ *	dis2_rreal - read a real number, integers are accepted too
+ *
+ * @param[in] stream - file descriptor
+ * @param[out] value - value
+ *
+ * @return int
+ * @retval DIS_SUCCESS or a DIS error code
+ *
+ */
+int
+dis2_rreal(int stream, double *value)
+{
+	pbs_tcp_chan_t *chan = transport_get_chan(stream);
+	u_Long bits;
+	char *cp;
+	int tag;
+	int n;
+	int rc;
+
+	*value = 0.0;
+	if (chan == NULL)
+		return DIS_PROTO;
+	if ((rc = dis2_take(stream, chan, 1, &cp)) != DIS_SUCCESS)
+		return rc;
+	tag = *(unsigned char *) cp;
+	if (tag == DIS2_REAL) {
+		if ((rc = dis2_take(stream, chan, sizeof(u_Long), &cp)) != DIS_SUCCESS)
+			return rc;
+		bits = dis2_getle((unsigned char *) cp, sizeof(u_Long));
+		memcpy(value, &bits, sizeof(bits));
+		return DIS_SUCCESS;
+	}
+	n = tag & 0x0f;
+	if ((tag & ~0x0f) > DIS2_NEGINT || n > (int) sizeof(u_Long))
+		return DIS_NONDIGIT;
+	if (n > 0 && (rc = dis2_take(stream, chan, n, &cp)) != DIS_SUCCESS)
+		return rc;
+	bits = n > 0 ? dis2_getle((unsigned char *) cp, n) : 0;
+	*value = (tag & DIS2_NEGINT) ? -(double) bits : (double) bits;
+	return DIS_SUCCESS;
+}
+
+/**
+ * @brief
+ *	Hash of a short string for the write token table.
+ */
+static unsigned int
+dis2_hash(const char *value, size_t nchars)
+{
+	unsigned int h = 2166136261U;
+
+	while (nchars-- > 0)
+		h = (h ^ (unsigned char) *value++) * 16777619U;
+	return h;
+}
+
+/**
+ * @brief
+ *	dis2_wcs - write a counted string, as a token if the same string was
+ *	already sent in this pkt
+ *
+ * @param[in] stream - file descriptor
+ * @param[in] value - characters
+ * @param[in] nchars - number of characters
+ *
+ * @return int
+ * @retval DIS_SUCCESS or DIS_PROTO
+ *
+ */
+int
+dis2_wcs(int stream, const char *value, size_t nchars)
+{
+	pbs_tcp_chan_t *chan = transport_get_chan(stream);
+	dis2_wdict_t *wd;
+	unsigned char buf[5];
+	unsigned int h = 0;
+	unsigned int s;
+	int tok;
+
+	if (chan == NULL || (wd = chan->dis2_wdict) == NULL)
+		return DIS_PROTO;
+
+	if (nchars <= DIS2_TOKEN_MAXLEN)
+		h = dis2_hash(value, nchars);
+	if (nchars <= DIS2_TOKEN_MAXLEN && chan->writebuf.tdis_len > 0) {
+		/* tokens only refer to strings of the pkt being written */
+		for (s = h & (DIS2_HASH_SIZE - 1); (wd->slot[s] >> 16) == wd->gen; s = (s + 1) & (DIS2_HASH_SIZE - 1)) {
+			tok = (wd->slot[s] & 0xffff) - 1;
+			if (wd->len[tok] == nchars &&
+				memcmp(chan->writebuf.tdis_data + wd->off[tok], value, nchars) == 0) {
+				buf[0] = DIS2_TOKEN;
+				buf[1] = tok & 0xff;
+				buf[2] = (tok >> 8) & 0xff;
+				return (dis_puts(stream, (char *) buf, 3) < 0 ? DIS_PROTO : DIS_SUCCESS);
+			}
+		}
+	}
+
+	buf[0] = DIS2_STR;
+	buf[1] = nchars & 0xff;
+	buf[2] = (nchars >> 8) & 0xff;
+	buf[3] = (nchars >> 16) & 0xff;
+	buf[4] = (nchars >> 24) & 0xff;
+	if (dis_puts(stream, (char *) buf, 5) < 0)
+		return DIS_PROTO;
+	if (nchars <= DIS2_TOKEN_MAXLEN && wd->ntok < DIS2_MAX_TOKENS) {
+		/* same rule as dis2_rcs(), the numbering must match */
+		tok = wd->ntok++;
+		wd->off[tok] = chan->writebuf.tdis_pos - chan->writebuf.tdis_data;
+		wd->len[tok] = nchars;
+		for (s = h & (DIS2_HASH_SIZE - 1); (wd->slot[s] >> 16) == wd->gen; s = (s + 1) & (DIS2_HASH_SIZE - 1))
+			;
+		wd->slot[s] = (wd->gen << 16) | (tok + 1);
+	}
+	if (nchars > 0 && dis_puts(stream, value, nchars) != nchars)
+		return DIS_PROTO;
+	return DIS_SUCCESS;
+}
+
+/**
+ * @brief
+ *	dis2_rcs - read a counted string
+ *
+ * @param[in] stream - file descriptor
+ * @param[out] value - set to the characters, in the read buffer and not
+ *		       NUL terminated; valid until the next read on stream
+ * @param[out] nchars - number of characters
+ *
+ * @return int
+ * @retval DIS_SUCCESS or a DIS error code
+ *
+ */
+int
+dis2_rcs(int stream, char **value, size_t *nchars)
+{
+	pbs_tcp_chan_t *chan = transport_get_chan(stream);
+	dis2_rdict_t *rd;
+	unsigned char *ucp;
+	char *cp;
+	int tok;
+	int rc;
+
+	*value = NULL;
+	*nchars = 0;
+	if (chan == NULL || (rd = chan->dis2_rdict) == NULL)
+		return DIS_PROTO;
+	if ((rc = dis2_take(stream, chan, 1, &cp)) != DIS_SUCCESS)
+		return rc;
+
+	switch (*(unsigned char *) cp) {
+		case DIS2_TOKEN:
+			if ((rc = dis2_take(stream, chan, 2, &cp)) != DIS_SUCCESS)
+				return rc;
+			ucp = (unsigned char *) cp;
+			tok = ucp[0] | (ucp[1] << 8);
+			if (tok >= rd->ntok)
+				return DIS_PROTO;
+			*value = rd->ptr[tok];
+			*nchars = rd->len[tok];
+			return DIS_SUCCESS;
+
+		case DIS2_STR:
+			if ((rc = dis2_take(stream, chan, 4, &cp)) != DIS_SUCCESS)
+				return rc;
+			*nchars = (size_t) dis2_getle((unsigned char *) cp, 4);
+			if (*nchars > 0 && (rc = dis2_take(stream, chan, *nchars, value)) != DIS_SUCCESS) {
+				*nchars = 0;
+				return rc;
+			}
+			if (*nchars <= DIS2_TOKEN_MAXLEN && rd->ntok < DIS2_MAX_TOKENS) {
+				rd->ptr[rd->ntok] = *value;
+				rd->len[rd->ntok++] = *nchars;
+			}
+			if (*value == NULL)
+				*value = cp;	/* empty string */
+			return DIS_SUCCESS;
+
+		case DIS2_NEGINT:
+			return DIS_BADSIGN;
+
+		default:
+			return DIS_NONDIGIT;
+	}
+}
@@ -66,6 +66,16 @@ disrsl_(int stream, int *negate, unsigned long *value,
 	unsigned long count, int recursv);
 int disrsll_(int stream,  int  *negate,  u_Long *value, unsigned long count, int recursv);
 int diswui_(int stream, unsigned value);
+int disrfast_(int stream, int *negate, u_Long *value, u_Long max);
+
+/* DIS version 2 encoding, see dis2.c */
+int dis2_wint(int stream, int negate, u_Long value);
+int dis2_rint(int stream, int *negate, u_Long *value, u_Long max);
+int dis2_wreal(int stream, double value);
+int dis2_rreal(int stream, double *value);
+int dis2_wcs(int stream, const char *value, size_t nchars);
+int dis2_rcs(int stream, char **value, size_t *nchars);
+void dis2_new_wpkt(int stream);
 
 extern unsigned dis_dmx10;
 extern double *dis_dp10;
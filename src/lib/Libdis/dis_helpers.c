@@ -40,9 +40,11 @@
 #include <arpa/inet.h>
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdlib.h>
 #include "auth.h"
 #include "dis.h"
+#include "dis_.h"
 #include "pbs_error.h"
 #include "pbs_internal.h"
 
@@ -430,6 +432,44 @@ __recv_pkt(int fd, int *type, pbs_dis_buf_t *tp)
 	return datasz;
 }
 
+/**
+ * @brief
+ * 	dis_pkt_complete - check whether the data starts with a whole pkt
+ *
+ * @param[in] data - data received so far
+ * @param[in] len - length of data
+ *
+ * @return int
+ *
+ * @retval >0 - size of the first pkt, header included
+ * @retval 0 - more data is needed
+ * @retval -1 - data does not start with a pkt header
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ *
+ */
+int
+dis_pkt_complete(char *data, size_t len)
+{
+	int i;
+	size_t datasz;
+
+	if (len < PKT_HDR_SZ)
+		return (strncmp(data, PKT_MAGIC, len < PKT_MAGIC_SZ ? len : PKT_MAGIC_SZ) == 0 ? 0 : -1);
+	if (strncmp(data, PKT_MAGIC, PKT_MAGIC_SZ) != 0)
+		return -1;
+	memcpy(&i, (void *) (data + PKT_HDR_SZ - sizeof(int)), sizeof(int));
+	datasz = ntohl(i);
+	if (datasz <= 0 || datasz > INT_MAX - PKT_HDR_SZ)
+		return -1;
+	if (len < datasz + PKT_HDR_SZ)
+		return 0;
+	return (int) (datasz + PKT_HDR_SZ);
+}
+
 /**
  * @brief
  * 	transport_recv_pkt - receive pkt over network.
@@ -681,6 +721,45 @@ dis_getc(int fd)
 	return c;
 }
 
+/**
+ * @brief
+ * 	dis_fill_readbuf - make sure the read buffer holds data, receiving
+ *	the next pkt if all of the current one has been consumed
+ *
+ * @param[in] fd - file descriptor
+ *
+ * @return	int
+ *
+ * @retval	1	a new pkt was received
+ * @retval	0	the read buffer still had data
+ * @retval	-1 	if EOD or error
+ * @retval	-2 	if EOF (stream closed)
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ *
+ */
+int
+dis_fill_readbuf(int fd)
+{
+	pbs_dis_buf_t *tp = dis_get_readbuf(fd);
+	int unused;
+	int c;
+
+	if (tp == NULL)
+		return -1;
+	if (tp->tdis_len > 0)
+		return 0;
+	dis_clear_buf(tp);
+	if ((c = __recv_pkt(fd, &unused, tp)) <= 0) {
+		dis_clear_buf(tp);
+		return (c < 0 ? c : -1);
+	}
+	return 1;
+}
+
 /**
  * @brief
  * 	dis_gets - dis support routine to get a string from read buffer
@@ -764,6 +843,7 @@ dis_puts(int fd, const char *str, size_t ct)
 		strcpy(tp->tdis_data, PKT_MAGIC);
 		tp->tdis_pos = tp->tdis_data + PKT_HDR_SZ;
 		tp->tdis_len = PKT_HDR_SZ;
+		dis2_new_wpkt(fd);
 	} else {
 		if (dis_resize_buf(tp, ct) != 0)
 			return -1;
@@ -856,6 +936,12 @@ dis_destroy_chan(int fd)
 			free(chan->writebuf.tdis_data);
 			chan->writebuf.tdis_data = NULL;
 		}
+		if (chan->pendbuf.tdis_data) {
+			free(chan->pendbuf.tdis_data);
+			chan->pendbuf.tdis_data = NULL;
+		}
+		free(chan->dis2_rdict);
+		free(chan->dis2_wdict);
 		free(chan);
 		transport_set_chan(fd, NULL);
 	}
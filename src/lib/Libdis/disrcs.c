@@ -64,6 +64,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "dis.h"
 #include "dis_.h"
@@ -96,6 +97,22 @@ disrcs(int stream, size_t *nchars, int *retval)
 	assert(nchars != NULL);
 	assert(retval != NULL);
 
+	if (dis_get_version(stream) == DIS_VERSION_2) {
+		char	*cp;
+		size_t	n;
+
+		if ((locret = dis2_rcs(stream, &cp, &n)) == DIS_SUCCESS) {
+			if ((value = (char *)malloc(n + 1)) == NULL)
+				locret = DIS_NOMALLOC;
+			else {
+				memcpy(value, cp, n);
+				value[n] = '\0';
+			}
+		}
+		*nchars = value != NULL ? n : 0;
+		*retval = locret;
+		return (value);
+	}
 	locret = disrsi_(stream, &negate, &count, 1, 0);
 	locret = negate ? DIS_BADSIGN : locret;
 	if (locret == DIS_SUCCESS) {
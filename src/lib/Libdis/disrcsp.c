@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "dis.h"
+#include "dis_.h"
+
+/**
+ * @file	disrcsp.c
+ */
+/**
+ * @brief
+ *	-Gets a Data-is-Strings character string from <stream> without copying
+ *	it.  The string is left in the read buffer of <stream>; *<value> is
+ *	set to point at it there and *<nchars> to its length.  The string is
+ *	not NUL terminated and is only valid until the next read on <stream>.
+ *
+ *	*<retval> gets DIS_SUCCESS if everything works well.  It gets an error
+ *	code otherwise.  In case of an error, *<value> is set to NULL and
+ *	*<nchars> to 0.
+ *
+ * @param[in] stream - socket descriptor
+ * @param[out] value - set to the characters
+ * @param[out] nchars - set to the number of characters
+ *
+ * @return	int
+ * @retval	DIS_SUCCESS	success
+ * @retval	error code	error
+ *
+ */
+int
+disrcsp(int stream, char **value, size_t *nchars)
+{
+	int		locret;
+	int		negate;
+	unsigned	count = 0;
+	pbs_tcp_chan_t	*chan;
+
+	assert(value != NULL);
+	assert(nchars != NULL);
+
+	*value = NULL;
+	*nchars = 0;
+	if (dis_get_version(stream) == DIS_VERSION_2)
+		return (dis2_rcs(stream, value, nchars));
+
+	locret = disrsi_(stream, &negate, &count, 1, 0);
+	if (locret != DIS_SUCCESS)
+		return (locret);
+	if (negate)
+		return (DIS_BADSIGN);
+	if ((chan = transport_get_chan(stream)) == NULL ||
+		chan->readbuf.tdis_len < count)
+		return (DIS_PROTO);
+	*value = chan->readbuf.tdis_pos;
+	*nchars = count;
+	chan->readbuf.tdis_pos += count;
+	chan->readbuf.tdis_len -= count;
+	return (DIS_SUCCESS);
+}
@@ -209,6 +209,15 @@ disrf(int stream, int *retval)
 	assert(retval != NULL);
 	assert(stream >= 0);
 
+	if (dis_get_version(stream) == DIS_VERSION_2) {
+		if ((locret = dis2_rreal(stream, &dval)) == DIS_SUCCESS &&
+			(dval > FLT_MAX || dval < -FLT_MAX)) {
+			dval = dval < 0.0 ? -HUGE_VAL : HUGE_VAL;
+			locret = DIS_OVERFLOW;
+		}
+		*retval = locret;
+		return (dval);
+	}
 	dval = 0.0;
 	if ((locret = disrd_(stream, 1, &ndigs, &nskips, &dval, 0)) == DIS_SUCCESS) {
 		locret = disrsi_(stream, &negate, &uexpon, 1, 0);
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dis.h"
+#include "dis_.h"
+
+/**
+ * @file	disrfast_.c
+ */
+
+/* the largest number of digits that always fits in a u_Long */
+#define DIS_FAST_MAXDIGS	19
+
+/**
+ * @brief
+ *	Convert 8 ASCII digits to their value, 8 bytes at a time.
+ *
+ * @param[in] cp - the digits, most significant first
+ * @param[out] value - the value
+ *
+ * @return int
+ * @retval 1 - converted
+ * @retval 0 - a byte was not a digit
+ *
+ */
+static int
+dis_swar8(const unsigned char *cp, uint64_t *value)
+{
+	uint64_t v;
+
+	/* little-endian load whatever the host, compiles to a single load */
+	v = (uint64_t) cp[0] | (uint64_t) cp[1] << 8 |
+		(uint64_t) cp[2] << 16 | (uint64_t) cp[3] << 24 |
+		(uint64_t) cp[4] << 32 | (uint64_t) cp[5] << 40 |
+		(uint64_t) cp[6] << 48 | (uint64_t) cp[7] << 56;
+
+	/* every byte between '0' and '9' */
+	if (((v & 0xF0F0F0F0F0F0F0F0ULL) |
+		((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4) !=
+		0x3333333333333333ULL)
+		return 0;
+
+	/* combine the digits into pairs, the pairs into quads, then the quads */
+	v -= 0x3030303030303030ULL;
+	v = (v * 10) + (v >> 8);
+	v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+		(((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+	*value = v;
+	return 1;
+}
+
+/**
+ * @brief
+ *	Convert count ASCII digits to their value.
+ *
+ * @param[in] cp - the digits, most significant first
+ * @param[in] count - number of digits, at most DIS_FAST_MAXDIGS
+ * @param[out] value - the value
+ *
+ * @return int
+ * @retval 1 - converted
+ * @retval 0 - a byte was not a digit
+ *
+ */
+static int
+dis_atoul(const unsigned char *cp, size_t count, u_Long *value)
+{
+	u_Long locval = 0;
+	uint64_t part;
+
+	for (; count >= 8; count -= 8, cp += 8) {
+		if (!dis_swar8(cp, &part))
+			return 0;
+		locval = locval * 100000000 + part;
+	}
+	for (; count > 0; count--, cp++) {
+		if (*cp < '0' || *cp > '9')
+			return 0;
+		locval = 10 * locval + (*cp - '0');
+	}
+	*value = locval;
+	return 1;
+}
+
+/**
+ * @brief
+ *	-Fast path for the disrs*_() routines: decodes a whole
+ *	Data-is-Strings integer, with all its counts, straight from the read
+ *	buffer of <stream>, looking the buffer up and checking its bounds once.
+ *
+ * @par
+ *	Only the common case is handled here: well formed data that fits
+ *	in max.  For anything else nothing is consumed and -1 is returned so
+ *	the caller decodes the datum byte by byte and reports the error or
+ *	overflow exactly as before.
+ *
+ * @param[in] stream - file descriptor
+ * @param[out] negate - set to non-zero if the value is negative
+ * @param[out] value - magnitude of the value
+ * @param[in] max - largest magnitude the caller can take
+ *
+ * @return int
+ * @retval DIS_SUCCESS - decoded
+ * @retval DIS_EOD or DIS_EOF - no more data
+ * @retval -1 - use the byte by byte decoder
+ *
+ */
+int
+disrfast_(int stream, int *negate, u_Long *value, u_Long max)
+{
+	pbs_tcp_chan_t *chan;
+	const unsigned char *cp;
+	const unsigned char *end;
+	u_Long count = 1;
+	u_Long locval;
+	int rc;
+
+	if ((rc = dis_fill_readbuf(stream)) < 0)
+		return (rc == -2 ? DIS_EOF : DIS_EOD);
+	if ((chan = transport_get_chan(stream)) == NULL)
+		return -1;
+	cp = (unsigned char *) chan->readbuf.tdis_pos;
+	end = cp + chan->readbuf.tdis_len;
+
+	/* follow the counts down to the signed digit string */
+	while (cp < end && *cp != '+' && *cp != '-') {
+		if (*cp == '0' || count > DIS_FAST_MAXDIGS ||
+			(size_t) (end - cp) < count ||
+			!dis_atoul(cp, count, &locval))
+			return -1;
+		cp += count;
+		count = locval;
+	}
+	if (cp >= end || count > DIS_FAST_MAXDIGS || (size_t) (end - cp - 1) < count)
+		return -1;
+	if (!dis_atoul(cp + 1, count, &locval) || locval > max)
+		return -1;
+
+	*negate = (*cp == '-');
+	*value = locval;
+	cp += 1 + count;
+	chan->readbuf.tdis_len -= (char *) cp - chan->readbuf.tdis_pos;
+	chan->readbuf.tdis_pos = (char *) cp;
+	return DIS_SUCCESS;
+}
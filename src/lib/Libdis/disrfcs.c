@@ -59,6 +59,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "dis.h"
 #include "dis_.h"
@@ -90,6 +91,19 @@ disrfcs(int stream, size_t *nchars, size_t achars, char *value)
 	assert(nchars != NULL);
 	assert(value != NULL);
 
+	if (dis_get_version(stream) == DIS_VERSION_2) {
+		char	*cp;
+
+		if ((locret = dis2_rcs(stream, &cp, nchars)) == DIS_SUCCESS) {
+			if (*nchars > achars)
+				locret = DIS_OVERFLOW;
+			else
+				memcpy(value, cp, *nchars);
+		}
+		if (locret != DIS_SUCCESS)
+			*nchars = 0;
+		return (locret);
+	}
 	locret = disrsi_(stream, &negate, &count, 1, 0);
 	if (locret == DIS_SUCCESS) {
 		if (negate)
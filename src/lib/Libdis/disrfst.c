@@ -60,10 +60,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdlib.h>
-
-#ifndef NDEBUG
 #include <string.h>
-#endif
 
 #include "dis.h"
 #include "dis_.h"
@@ -94,6 +91,26 @@ disrfst(int stream, size_t achars, char *value)
 
 	assert(value != NULL);
 
+	if (dis_get_version(stream) == DIS_VERSION_2) {
+		char	*cp;
+		size_t	n;
+
+		if ((locret = dis2_rcs(stream, &cp, &n)) == DIS_SUCCESS) {
+			if (n > achars)
+				locret = DIS_OVERFLOW;
+#ifndef NDEBUG
+			else if (memchr(cp, 0, n))
+				locret = DIS_NULLSTR;
+#endif
+			else {
+				memcpy(value, cp, n);
+				value[n] = '\0';
+			}
+		}
+		if (locret != DIS_SUCCESS)
+			*value = '\0';
+		return (locret);
+	}
 	locret = disrsi_(stream, &negate, &count, 1, 0);
 	if (locret == DIS_SUCCESS) {
 		if (negate)
@@ -97,6 +97,12 @@ disrl(int stream, int *retval)
 
 	assert(retval != NULL);
 
+	if (dis_get_version(stream) == DIS_VERSION_2) {
+		double	dval;
+
+		*retval = dis2_rreal(stream, &dval);
+		return (dval);
+	}
 	ldval = 0.0L;
 	locret = disrl_(stream, &ldval, &ndigs, &nskips, LDBL_DIG, 1, 0);
 	if (locret == DIS_SUCCESS) {
@@ -73,6 +73,19 @@ disrsi_(int stream, int *negate, unsigned *value, unsigned count, int recursv)
 	assert(count);
 	assert(stream >= 0);
 
+	if (recursv == 0) {
+		u_Long	ulval = 0;
+		int	rc;
+
+		if (dis_get_version(stream) == DIS_VERSION_2)
+			rc = dis2_rint(stream, negate, &ulval, UINT_MAX);
+		else
+			rc = disrfast_(stream, negate, &ulval, UINT_MAX);
+		if (rc != -1) {
+			*value = (unsigned) ulval;
+			return (rc);
+		}
+	}
 	if (++recursv > DIS_RECURSIVE_LIMIT)
 		return (DIS_PROTO);
 	/* dis_umaxd would be initialized by prior call to dis_init_tables */
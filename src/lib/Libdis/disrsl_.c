@@ -75,6 +75,19 @@ disrsl_(int stream, int *negate, unsigned long *value, unsigned long count, int
 	assert(count);
 	assert(stream >= 0);
 
+	if (recursv == 0) {
+		u_Long	ulval = 0;
+		int	rc;
+
+		if (dis_get_version(stream) == DIS_VERSION_2)
+			rc = dis2_rint(stream, negate, &ulval, ULONG_MAX);
+		else
+			rc = disrfast_(stream, negate, &ulval, ULONG_MAX);
+		if (rc != -1) {
+			*value = (unsigned long) ulval;
+			return (rc);
+		}
+	}
 	if (++recursv > DIS_RECURSIVE_LIMIT)
 		return (DIS_PROTO);
 
@@ -92,6 +92,14 @@ disrsll_(int stream, int *negate, u_Long *value, unsigned long count, int recurs
 	assert(count);
 	assert(stream >= 0);
 
+	if (recursv == 0) {
+		int	rc;
+
+		if (dis_get_version(stream) == DIS_VERSION_2)
+			return (dis2_rint(stream, negate, value, UlONG_MAX));
+		if ((rc = disrfast_(stream, negate, value, UlONG_MAX)) != -1)
+			return (rc);
+	}
 	if (++recursv > DIS_RECURSIVE_LIMIT)
 		return (DIS_PROTO);
 
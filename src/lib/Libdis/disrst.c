@@ -59,10 +59,7 @@
 #include <assert.h>
 #include <stddef.h>
 #include <stdlib.h>
-
-#ifndef NDEBUG
 #include <string.h>
-#endif
 
 #include "dis.h"
 #include "dis_.h"
@@ -91,6 +88,26 @@ disrst(int stream, int *retval)
 
 	assert(retval != NULL);
 
+	if (dis_get_version(stream) == DIS_VERSION_2) {
+		char	*cp;
+		size_t	n;
+
+		if ((locret = dis2_rcs(stream, &cp, &n)) == DIS_SUCCESS) {
+#ifndef NDEBUG
+			if (memchr(cp, 0, n))
+				locret = DIS_NULLSTR;
+			else
+#endif
+			if ((value = (char *)malloc(n + 1)) == NULL)
+				locret = DIS_NOMALLOC;
+			else {
+				memcpy(value, cp, n);
+				value[n] = '\0';
+			}
+		}
+		*retval = locret;
+		return (value);
+	}
 	locret = disrsi_(stream, &negate, &count, 1, 0);
 	if (locret == DIS_SUCCESS) {
 		if (negate)
@@ -82,6 +82,8 @@ diswcs(int stream, const char *value, size_t nchars)
 
 	assert(nchars <= UINT_MAX);
 
+	if (dis_get_version(stream) == DIS_VERSION_2)
+		return dis2_wcs(stream, value, nchars);
 	retval = diswui_(stream, (unsigned)nchars);
 	if (retval == DIS_SUCCESS && nchars > 0 &&
 		dis_puts(stream, value, nchars) != nchars)
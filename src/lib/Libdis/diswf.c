@@ -91,6 +91,11 @@ diswf(int stream, double value)
 
 	assert(stream >= 0);
 
+	if (dis_get_version(stream) == DIS_VERSION_2) {
+		if (value > FLT_MAX || value < -FLT_MAX)
+			return (DIS_HUGEVAL);
+		return (dis2_wreal(stream, value));
+	}
 	/* Make zero a special case.  If we don't it will blow exponent		*/
 	/* calculation.								*/
 	if (value == 0.0) {
@@ -94,6 +94,12 @@ diswl_(int stream, dis_long_double_t value, unsigned ndigs)
 	assert(ndigs > 0 && ndigs <= LDBL_DIG);
 	assert(stream >= 0);
 
+	if (dis_get_version(stream) == DIS_VERSION_2) {
+		/* sent as a double */
+		if (value > DBL_MAX || value < -DBL_MAX)
+			return (DIS_HUGEVAL);
+		return (dis2_wreal(stream, (double)value));
+	}
 	/* Make zero a special case.  If we don't it will blow exponent		*/
 	/* calculation.								*/
 	if (value == 0.0L) {
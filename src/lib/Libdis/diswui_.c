@@ -68,6 +68,8 @@ diswui_(int stream, unsigned value)
 	char		*cp;
 
 	assert(stream >= 0);
+	if (dis_get_version(stream) == DIS_VERSION_2)
+		return dis2_wint(stream, FALSE, value);
 
 	cp = discui_(&dis_buffer[DIS_BUFSIZ], value, &ndigs);
 	*--cp = '+';
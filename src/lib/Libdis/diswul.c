@@ -93,6 +93,8 @@ diswul(int stream, unsigned long value)
 	char		*cp;
 
 	assert(stream >= 0);
+	if (dis_get_version(stream) == DIS_VERSION_2)
+		return dis2_wint(stream, FALSE, value);
 	cp = discul_(&dis_buffer[DIS_BUFSIZ], value, &ndigs);
 	*--cp = '+';
 	while (ndigs > 1)
@@ -95,6 +95,8 @@ diswull(int stream, u_Long value)
 	char		*cp;
 
 	assert(stream >= 0);
+	if (dis_get_version(stream) == DIS_VERSION_2)
+		return dis2_wint(stream, FALSE, value);
 
 
 	cp = discull_(&dis_buffer[DIS_BUFSIZ], value, &ndigs);
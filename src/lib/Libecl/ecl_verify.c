@@ -315,6 +315,7 @@ verify_an_attribute(int batch_request, int parent_object, int cmd,
 			batch_request == PBS_BATCH_StatusQue ||
 			batch_request == PBS_BATCH_StatusSvr ||
 			batch_request == PBS_BATCH_StatusNode ||
+			batch_request == PBS_BATCH_StatusNodeSummary ||
 			batch_request == PBS_BATCH_StatusRsc ||
 			batch_request == PBS_BATCH_StatusHook ||
 			batch_request == PBS_BATCH_StatusResv ||
@@ -134,6 +134,8 @@ add_connection(int fd)
 			free(connection[fd]->ch_errtxt);
 		connection[fd]->ch_errtxt = NULL;
 		connection[fd]->ch_errno = 0;
+		PBSD_pipe_free(connection[fd]->ch_pipe);
+		connection[fd]->ch_pipe = NULL;
 	}
 
 	return 0;
@@ -160,6 +162,7 @@ _destroy_connection(int fd)
 	if (connection[fd]) {
 		if (connection[fd]->ch_errtxt)
 			free(connection[fd]->ch_errtxt);
+		PBSD_pipe_free(connection[fd]->ch_pipe);
 		pthread_mutex_destroy(&(connection[fd]->ch_mutex));
 		/*
 		 * DON'T free connection[i]->ch_chan
@@ -523,3 +526,75 @@ get_conn_mutex(int fd)
 	UNLOCK_TABLE(NULL);
 	return mutex;
 }
+
+/**
+ * @brief
+ * 	set_conn_pipe - set pipelined request state of connection synchronously
+ *
+ * @param[in] fd - socket number
+ * @param[in] pstate - pipelined request state to set on connection
+ *
+ * @return int
+ * @retval 0 - success
+ * @retval -1 - error
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ */
+int
+set_conn_pipe(int fd, void *pstate)
+{
+	pbs_conn_t *p = NULL;
+
+	if (INVALID_SOCK(fd))
+		return -1;
+
+	LOCK_TABLE(-1);
+	p = get_connection(fd);
+	if (p == NULL) {
+		errno = ENOTCONN;
+		UNLOCK_TABLE(-1);
+		return -1;
+	}
+	p->ch_pipe = pstate;
+	UNLOCK_TABLE(-1);
+	return 0;
+}
+
+/**
+ * @brief
+ * 	get_conn_pipe - get pipelined request state of connection synchronously
+ *
+ * @param[in] fd - socket number
+ *
+ * @return void *
+ * @retval !NULL - success
+ * @retval NULL - error, or no request was pipelined on the connection
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: Yes
+ */
+void *
+get_conn_pipe(int fd)
+{
+	pbs_conn_t *p = NULL;
+	void *pstate = NULL;
+
+	if (INVALID_SOCK(fd))
+		return NULL;
+
+	LOCK_TABLE(NULL);
+	p = get_connection(fd);
+	if (p == NULL) {
+		errno = ENOTCONN;
+		UNLOCK_TABLE(NULL);
+		return NULL;
+	}
+	pstate = p->ch_pipe;
+	UNLOCK_TABLE(NULL);
+	return pstate;
+}
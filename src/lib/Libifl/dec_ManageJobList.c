@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	dec_ManageJobList.c
+ * @brief
+ * 	decode_DIS_ManageJobList() - decode a Manage Job List Batch Request
+ *
+ * @par Data items are:
+ *			unsigned int	operation (enum joblist_op)
+ *			unsigned int	count of job ids, may be zero
+ *			string array	job ids
+ *			list of		selection criteria
+ *			list of		hold types or attributes to alter
+ *			string		signal name or destination, may be empty
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <sys/types.h>
+#include <stdlib.h>
+#include "libpbs.h"
+#include "list_link.h"
+#include "server_limits.h"
+#include "attribute.h"
+#include "credential.h"
+#include "batch_request.h"
+#include "dis.h"
+
+/**
+ * @brief -
+ *	decode a Manage Job List Batch Request
+ *
+ * @par	Functionality:
+ *		The job ids and the argument are allocated here and freed with
+ *		the request.
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+decode_DIS_ManageJobList(int sock, struct batch_request *preq)
+{
+	struct rq_managejoblist *pml = &preq->rq_ind.rq_managejoblist;
+	int count;
+	int rc;
+
+	CLEAR_HEAD(pml->rq_selattr);
+	CLEAR_HEAD(pml->rq_attr);
+	pml->rq_jobids = NULL;
+	pml->rq_count = 0;
+	pml->rq_arg = NULL;
+	pml->rq_next = 0;
+
+	pml->rq_op = disrui(sock, &rc);
+	if (rc)
+		return rc;
+	count = disrui(sock, &rc);
+	if (rc)
+		return rc;
+	if ((count < 0) || (count > PBS_MAX_MANAGEJOBLIST))
+		return DIS_PROTO;
+
+	if ((pml->rq_jobids = calloc(count + 1, sizeof(char *))) == NULL)
+		return DIS_NOMALLOC;
+	for (; pml->rq_count < count; pml->rq_count++) {
+		pml->rq_jobids[pml->rq_count] = disrst(sock, &rc);
+		if (rc)
+			return rc;
+	}
+
+	if ((rc = decode_DIS_svrattrl(sock, &pml->rq_selattr)) ||
+		(rc = decode_DIS_svrattrl(sock, &pml->rq_attr)))
+		return rc;
+	pml->rq_arg = disrst(sock, &rc);
+	return rc;
+}
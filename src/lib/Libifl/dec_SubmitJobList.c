@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+
+
+/**
+ * @file	dec_SubmitJobList.c
+ * @brief
+ * 	decode_DIS_SubmitJobList() - decode a Submit Job List Batch Request
+ *
+ * @par Data items are:
+ *			unsigned int	number of scripts
+ *			counted string	script, repeated
+ *			unsigned int	number of jobs
+ *			string		destination	\
+ *			signed int	script index	 > repeated per job
+ *			list of		attributes	/
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <sys/types.h>
+#include <stdlib.h>
+#include "libpbs.h"
+#include "list_link.h"
+#include "server_limits.h"
+#include "attribute.h"
+#include "credential.h"
+#include "batch_request.h"
+#include "dis.h"
+
+/**
+ * @brief -
+ *	decode a Submit Job List Batch Request
+ *
+ * @par	Functionality:
+ *		The scripts and jobs arrays are allocated here and freed with
+ *		the request.  A job's script index is checked against the
+ *		number of scripts received.
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+decode_DIS_SubmitJobList(int sock, struct batch_request *preq)
+{
+	struct rq_quejoblist *pql = &preq->rq_ind.rq_quejoblist;
+	struct rq_quejoblist_job *pjob;
+	unsigned int count;
+	int rc;
+	int i;
+
+	pql->rq_nscripts = 0;
+	pql->rq_count = 0;
+	pql->rq_scripts = NULL;
+	pql->rq_scriptsz = NULL;
+	pql->rq_jobs = NULL;
+
+	count = disrui(sock, &rc);
+	if (rc)
+		return rc;
+	if (count > PBS_MAX_SUBMITJOBLIST)
+		return DIS_PROTO;
+	if (count > 0) {
+		pql->rq_scripts = calloc(count, sizeof(char *));
+		pql->rq_scriptsz = calloc(count, sizeof(size_t));
+		if ((pql->rq_scripts == NULL) || (pql->rq_scriptsz == NULL))
+			return DIS_NOMALLOC;
+	}
+	for (i = 0; i < (int) count; i++) {
+		pql->rq_scripts[i] = disrcs(sock, &pql->rq_scriptsz[i], &rc);
+		if (rc)
+			return rc;
+		pql->rq_nscripts++;
+	}
+
+	count = disrui(sock, &rc);
+	if (rc)
+		return rc;
+	if ((count == 0) || (count > PBS_MAX_SUBMITJOBLIST))
+		return DIS_PROTO;
+	pql->rq_jobs = calloc(count, sizeof(struct rq_quejoblist_job));
+	if (pql->rq_jobs == NULL)
+		return DIS_NOMALLOC;
+	for (i = 0; i < (int) count; i++) {
+		pjob = &pql->rq_jobs[i];
+		CLEAR_HEAD(pjob->rq_attr);
+		pql->rq_count++;
+		rc = disrfst(sock, PBS_MAXSVRRESVID + 1, pjob->rq_destin);
+		if (rc)
+			return rc;
+		pjob->rq_script = disrsi(sock, &rc);
+		if (rc)
+			return rc;
+		if ((pjob->rq_script < -1) || (pjob->rq_script >= pql->rq_nscripts))
+			return DIS_PROTO;
+		if ((rc = decode_DIS_svrattrl(sock, &pjob->rq_attr)) != 0)
+			return rc;
+	}
+	return DIS_SUCCESS;
+}
@@ -84,6 +84,30 @@
 
 int
 decode_DIS_attrl(int sock, struct attrl **ppatt)
+{
+	return (decode_DIS_attrl_alloc(sock, ppatt, NULL));
+}
+
+/**
+ * @brief
+ *	decode into a list of PBS API "attrl" structures, taking the
+ *	structures and strings from the allocators in <da>
+ *
+ *	See decode_DIS_attrl() for the encoding.  With the default
+ *	allocators, the entry being decoded when an error occurs is freed;
+ *	with the caller's, whatever was handed out is left to the caller.
+ *
+ * @param[in]   sock - socket descriptor
+ * @param[in]   ppatt - pointer to list of attributes
+ * @param[in]   da - allocators, NULL for new_attrl() and disrst()
+ *
+ * @return int
+ * @retval 0 on SUCCESS
+ * @retval >0 on failure
+ */
+
+int
+decode_DIS_attrl_alloc(int sock, struct attrl **ppatt, struct dis_attrl_alloc *da)
 {
 	int		 hasresc;
 	int		 i;
@@ -101,21 +125,21 @@ decode_DIS_attrl(int sock, struct attrl **ppatt)
 		(void) disrui(sock, &rc);
 		if (rc) break;
 
-		pat = new_attrl();
+		pat = da ? da->da_attrl(da->da_ctx) : new_attrl();
 		if (pat == 0)
 			return DIS_NOMALLOC;
 
-		pat->name = disrst(sock, &rc);
+		pat->name = da ? da->da_str(sock, da->da_ctx, &rc) : disrst(sock, &rc);
 		if (rc)	break;
 
 		hasresc = disrui(sock, &rc);
 		if (rc) break;
 		if (hasresc) {
-			pat->resource = disrst(sock, &rc);
+			pat->resource = da ? da->da_str(sock, da->da_ctx, &rc) : disrst(sock, &rc);
 			if (rc) break;
 		}
 
-		pat->value = disrst(sock, &rc);
+		pat->value = da ? da->da_str(sock, da->da_ctx, &rc) : disrst(sock, &rc);
 		if (rc) break;
 
 		pat->op = (enum batch_op) disrui(sock, &rc);
@@ -130,7 +154,43 @@ decode_DIS_attrl(int sock, struct attrl **ppatt)
 		patprior = pat;
 	}
 
-	if (rc)
+	if (rc && da == NULL)
 		PBS_free_aopl((struct attropl *)pat);
 	return rc;
 }
+
+/**
+ * @brief
+ *	decode one object of a status reply: its type, its name and its
+ *	list of attributes
+ *
+ *	Used for the Status choice of decode_DIS_replyCmd() and by the
+ *	streaming status API, which decodes one object at a time.
+ *
+ * @param[in]   sock - socket descriptor
+ * @param[out]  pstat - the object, its name and attributes are set
+ * @param[in]   da - allocators, NULL for new_attrl() and disrst()
+ *
+ * @return int
+ * @retval 0 on SUCCESS
+ * @retval >0 on failure, pstat may hold part of the object
+ */
+
+int
+decode_DIS_status_obj(int sock, struct batch_status *pstat, struct dis_attrl_alloc *da)
+{
+	int	rc;
+
+	pstat->next = NULL;
+	pstat->name = NULL;
+	pstat->attribs = NULL;
+	pstat->text = NULL;
+
+	(void) disrui(sock, &rc); /* read and discard brp_objtype */
+	if (rc)
+		return rc;
+	pstat->name = da ? da->da_str(sock, da->da_ctx, &rc) : disrst(sock, &rc);
+	if (rc)
+		return rc;
+	return (decode_DIS_attrl_alloc(sock, &pstat->attribs, da));
+}
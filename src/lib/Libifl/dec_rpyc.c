@@ -61,43 +61,28 @@
 #include "dis.h"
 
 /**
- * @brief-
- *	decode a Batch Protocol Reply Structure for a Command
- *
- * @par	Functionality:
- *		This routine decodes a batch reply into the form used by commands.
- *      	The only difference between this and the server version is on status
- *      	replies.  For commands, the attributes are decoded into a list of
- *      	attrl structure rather than the server's svrattrl.
- *
- * Note: batch_reply structure defined in libpbs.h, it must be allocated
- *       by the caller.
+ * @brief
+ *	decode the header of a Batch Protocol Reply: protocol type and
+ *	version, then code, auxcode, choice (union type identifier) and
+ *	whether another part of the reply follows
  *
  * @param[in] sock - socket descriptor
- * @param[in] reply - pointer to batch_reply structure
+ * @param[out] reply - brp_code, brp_auxcode, brp_choice and brp_is_part
+ *		       are set
  *
  * @return	int
- * @retval	-1	error
  * @retval	0	Success
+ * @retval	>0	DIS error code
  *
  */
 
 int
-decode_DIS_replyCmd(int sock, struct batch_reply *reply)
+decode_DIS_replyHdr(int sock, struct batch_reply *reply)
 {
-	int ct;
 	int i;
-	struct brp_select *psel;
-	struct brp_select **pselx;
-	struct batch_status *pstcmd = NULL;
-	struct batch_status **pstcx = NULL;
-	struct batch_deljob_status *pdel;
 	int rc = 0;
-	size_t txtlen;
-	preempt_job_info *ppj = NULL;
 
 	/* first decode "header" consisting of protocol type and version */
-again:
 	i = disrui(sock, &rc);
 	if (rc != 0)
 		return rc;
@@ -121,7 +106,49 @@ again:
 	if (rc)
 		return rc;
 	reply->brp_is_part = disrui(sock, &rc);
-	if (rc)
+	return rc;
+}
+
+/**
+ * @brief-
+ *	decode a Batch Protocol Reply Structure for a Command
+ *
+ * @par	Functionality:
+ *		This routine decodes a batch reply into the form used by commands.
+ *      	The only difference between this and the server version is on status
+ *      	replies.  For commands, the attributes are decoded into a list of
+ *      	attrl structure rather than the server's svrattrl.
+ *
+ * Note: batch_reply structure defined in libpbs.h, it must be allocated
+ *       by the caller.
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] reply - pointer to batch_reply structure
+ *
+ * @return	int
+ * @retval	-1	error
+ * @retval	0	Success
+ *
+ */
+
+int
+decode_DIS_replyCmd(int sock, struct batch_reply *reply)
+{
+	int ct;
+	int i;
+	struct brp_select *psel;
+	struct brp_select **pselx;
+	struct batch_status *pstcmd = NULL;
+	struct batch_status **pstcx = NULL;
+	struct batch_deljob_status *pdel;
+	struct batch_submit_status *psub;
+	struct batch_submit_status **psubx;
+	int rc = 0;
+	size_t txtlen;
+	preempt_job_info *ppj = NULL;
+
+again:
+	if ((rc = decode_DIS_replyHdr(sock, reply)) != 0)
 		return rc;
 
 	switch (reply->brp_choice) {
@@ -181,18 +208,8 @@ again:
 				pstcmd = (struct batch_status *) malloc(sizeof(struct batch_status));
 				if (pstcmd == 0)
 					return DIS_NOMALLOC;
-				pstcmd->next = NULL;
-				pstcmd->text = NULL;
-				pstcmd->attribs = NULL;
 
-				i = disrui(sock, &rc); /* read and discard brp_objtype */
-				if (rc == 0)
-					pstcmd->name = disrst(sock, &rc);
-				if (rc) {
-					pbs_statfree(pstcmd);
-					return rc;
-				}
-				rc = decode_DIS_attrl(sock, &pstcmd->attribs);
+				rc = decode_DIS_status_obj(sock, pstcmd, NULL);
 				if (rc) {
 					pbs_statfree(pstcmd);
 					return rc;
@@ -240,6 +257,42 @@ again:
 
 			break;
 
+		case BATCH_REPLY_CHOICE_SubmitList:
+
+			/* one status per submitted job, kept in submission order */
+
+			reply->brp_un.brp_substatc = NULL;
+			reply->brp_count = disrui(sock, &rc);
+			if (rc)
+				return rc;
+
+			psubx = &reply->brp_un.brp_substatc;
+			for (ct = reply->brp_count; ct > 0; ct--) {
+				psub = (struct batch_submit_status *) calloc(1, sizeof(struct batch_submit_status));
+				if (psub == NULL)
+					return DIS_NOMALLOC;
+				*psubx = psub;
+				psubx = &psub->next;
+				psub->jobid = disrst(sock, &rc);
+				if (rc)
+					return rc;
+				psub->code = disrsi(sock, &rc);
+				if (rc)
+					return rc;
+				psub->text = disrst(sock, &rc);
+				if (rc)
+					return rc;
+				if (*psub->jobid == '\0') {
+					free(psub->jobid);
+					psub->jobid = NULL;
+				}
+				if (*psub->text == '\0') {
+					free(psub->text);
+					psub->text = NULL;
+				}
+			}
+			break;
+
 		case BATCH_REPLY_CHOICE_Text:
 
 			/* text reply */
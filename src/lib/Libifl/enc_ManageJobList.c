@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	enc_ManageJobList.c
+ * @brief
+ * encode_DIS_ManageJobList() - encode a Manage Job List Batch Request
+ *
+ *	This request holds, releases, signals, alters or moves many jobs at
+ *	once.  The jobs are given by id, or by criteria they must match.
+ *
+ * @par Data items are:
+ *			unsigned int	operation (enum joblist_op)
+ *			unsigned int	count of job ids, may be zero
+ *			string array	job ids
+ *			list of		selection criteria
+ *			list of		hold types or attributes to alter
+ *			string		signal name or destination, may be empty
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include "libpbs.h"
+#include "pbs_error.h"
+#include "dis.h"
+
+/**
+ * @brief
+ *	-encode a Manage Job List Batch Request
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] op - JOBLIST_HOLD, JOBLIST_RELEASE, ...
+ * @param[in] jobids - job identifiers, may be NULL
+ * @param[in] numofjobs - number of job identifiers
+ * @param[in] selattr - criteria the jobs must match, may be NULL
+ * @param[in] attrib - hold types or attributes to alter, may be NULL
+ * @param[in] arg - signal name or destination, may be NULL
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+encode_DIS_ManageJobList(int sock, int op, char **jobids, int numofjobs,
+	struct attropl *selattr, struct attropl *attrib, char *arg)
+{
+	int rc;
+
+	if ((rc = diswui(sock, op)) ||
+		(rc = encode_DIS_JobsList(sock, jobids, jobids ? numofjobs : 0)) ||
+		(rc = encode_DIS_attropl(sock, selattr)) ||
+		(rc = encode_DIS_attropl(sock, attrib)))
+		return rc;
+
+	return (diswst(sock, arg ? arg : ""));
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+
+
+/**
+ * @file	enc_SubmitJobList.c
+ * @brief
+ * encode_DIS_SubmitJobList() - encode a Submit Job List Batch Request
+ *
+ *	This request carries a number of jobs, each queued and committed
+ *	as if by a Queue Job request with its script attached.
+ *
+ * @par Data items are:
+ *			unsigned int	number of scripts
+ *			counted string	script, repeated
+ *			unsigned int	number of jobs
+ *			string		destination	\
+ *			signed int	script index	 > repeated per job
+ *			list of		attributes	/
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include "libpbs.h"
+#include "pbs_error.h"
+#include "dis.h"
+
+/**
+ * @brief
+ *	-encode a Submit Job List Batch Request
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] scripts - distinct job scripts
+ * @param[in] scriptsz - size of each script
+ * @param[in] nscripts - number of scripts
+ * @param[in] jobs - jobs to submit
+ * @param[in] jobscr - index into scripts of each job, -1 for none
+ * @param[in] njobs - number of jobs
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+encode_DIS_SubmitJobList(int sock, char **scripts, size_t *scriptsz, int nscripts,
+	struct batch_submit_job *jobs, int *jobscr, int njobs)
+{
+	int rc;
+	int i;
+
+	if ((rc = diswui(sock, nscripts)) != 0)
+		return rc;
+	for (i = 0; i < nscripts; i++) {
+		if ((rc = diswcs(sock, scripts[i], scriptsz[i])) != 0)
+			return rc;
+	}
+
+	if ((rc = diswui(sock, njobs)) != 0)
+		return rc;
+	for (i = 0; i < njobs; i++) {
+		if ((rc = diswst(sock, jobs[i].destination ? jobs[i].destination : "")) ||
+			(rc = diswsi(sock, jobscr[i])) ||
+			(rc = encode_DIS_attropl(sock, jobs[i].attrib)))
+			return rc;
+	}
+	return DIS_SUCCESS;
+}
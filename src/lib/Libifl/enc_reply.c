@@ -83,6 +83,7 @@ encode_DIS_reply_inner(int sock, struct batch_reply *reply)
 	struct brp_select *psel;
 	struct brp_status *pstat;
 	struct batch_deljob_status *pdelstat;
+	struct batch_submit_status *psubstat;
 	svrattrl *psvrl;
 	preempt_job_info *ppj;
 
@@ -165,6 +166,20 @@ encode_DIS_reply_inner(int sock, struct batch_reply *reply)
 			}
 			break;
 
+		case BATCH_REPLY_CHOICE_SubmitList:
+
+			/* count, then job id, code and text of each job in order */
+
+			if ((rc = diswui(sock, reply->brp_count)) != 0)
+				return rc;
+			for (psubstat = reply->brp_un.brp_substatc; psubstat; psubstat = psubstat->next) {
+				if ((rc = diswst(sock, psubstat->jobid ? psubstat->jobid : "")) ||
+					(rc = diswsi(sock, psubstat->code)) ||
+					(rc = diswst(sock, psubstat->text ? psubstat->text : "")))
+					return rc;
+			}
+			break;
+
 		case BATCH_REPLY_CHOICE_Text:
 
 			/* text reply */
@@ -366,6 +366,54 @@ pbs_manager(int c, int command, int objtype, char *objname,
 		attrib, extend);
 }
 
+/**
+ * @brief
+ *	-Pass-through call to hold, release, signal, alter or move many jobs
+ *	in one request
+ *
+ * @param[in] c - connection handle
+ * @param[in] op - JOBLIST_HOLD, JOBLIST_RELEASE, ...
+ * @param[in] jobids - job identifiers
+ * @param[in] numofjobs - number of job identifiers
+ * @param[in] selattr - criteria the jobs must match if no job ids given
+ * @param[in] attrib - attributes to alter
+ * @param[in] arg - hold types, signal name or destination
+ * @param[in] extend - extend string to encode req
+ *
+ * @return	struct batch_deljob_status *
+ * @retval	list of the jobs that failed
+ * @retval	NULL	all succeeded, or error (see pbs_errno)
+ *
+ */
+struct batch_deljob_status *
+pbs_managejoblist(int c, int op, char **jobids, int numofjobs,
+		struct attropl *selattr, struct attrl *attrib, char *arg, char *extend) {
+	return (*pfn_pbs_managejoblist)(c, op, jobids, numofjobs, selattr,
+		attrib, arg, extend);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to alter many vnodes in one request
+ *
+ * @param[in] c - connection handle
+ * @param[in] objtype - MGR_OBJ_NODE or MGR_OBJ_HOST
+ * @param[in] nodes - comma separated vnode or host names
+ * @param[in] selattr - criteria the vnodes must match
+ * @param[in] attrib - attributes to alter
+ * @param[in] extend - extend string to encode req
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+pbs_modifynodes(int c, int objtype, char *nodes, struct attropl *selattr,
+		struct attropl *attrib, char *extend) {
+	return (*pfn_pbs_modifynodes)(c, objtype, nodes, selattr, attrib, extend);
+}
+
 /**
  * @brief
  *	Pass-through call to send move job request
@@ -564,6 +612,20 @@ pbs_delstatfree(struct batch_deljob_status *bdsp) {
 	(*pfn_pbs_delstatfree)(bdsp);
 }
 
+/**
+ * @brief
+ *	-Pass-through call to deallocates a "batch_submit_status" structure
+ *
+ * @param[in] bssp - pointer to the status list
+ *
+ * @return	Void
+ *
+ */
+void
+pbs_submitstatfree(struct batch_submit_status *bssp) {
+	(*pfn_pbs_submitstatfree)(bssp);
+}
+
 
 /**
  * @brief
@@ -622,6 +684,230 @@ pbs_selstat(int c, struct attropl *attrib, struct attrl   *rattrib, char *extend
 	return (*pfn_pbs_selstat)(c, attrib, rattrib, extend);
 }
 
+/**
+ * @brief
+ *	-Pass-through call to open a stream over the status of jobs
+ *
+ * @param[in] c - communication handle
+ * @param[in] id - job id, NULL for all jobs
+ * @param[in] attrib - pointer to attribute list
+ * @param[in] extend - extend string for req
+ *
+ * @return	struct pbs_statstream *
+ * @retval	the stream	success
+ * @retval	NULL		error
+ *
+ */
+struct pbs_statstream *
+pbs_statjob_stream(int c, char *id, struct attrl *attrib, char *extend) {
+	return (*pfn_pbs_statjob_stream)(c, id, attrib, extend);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to open a stream over the status of selected jobs
+ *
+ * @param[in] c - communication handle
+ * @param[in] attrib - pointer to attropl structure(selection criteria)
+ * @param[in] rattrib - attributes to return
+ * @param[in] extend - extend string to encode req
+ *
+ * @return	struct pbs_statstream *
+ * @retval	the stream	success
+ * @retval	NULL		error
+ *
+ */
+struct pbs_statstream *
+pbs_selstat_stream(int c, struct attropl *attrib, struct attrl *rattrib, char *extend) {
+	return (*pfn_pbs_selstat_stream)(c, attrib, rattrib, extend);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to get the next object of a status stream
+ *
+ * @param[in] ss - the stream
+ *
+ * @return	struct batch_status *
+ * @retval	object owned by the stream	success
+ * @retval	NULL		end of stream or error
+ *
+ */
+struct batch_status *
+pbs_statstream_next(struct pbs_statstream *ss) {
+	return (*pfn_pbs_statstream_next)(ss);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to get the next objects of a status stream
+ *
+ * @param[in] ss - the stream
+ * @param[in] max - maximum number of objects, <= 0 for all
+ *
+ * @return	struct batch_status *
+ * @retval	list to free with pbs_statfree()	success
+ * @retval	NULL		end of stream or error
+ *
+ */
+struct batch_status *
+pbs_statstream_nextn(struct pbs_statstream *ss, int max) {
+	return (*pfn_pbs_statstream_nextn)(ss, max);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to close a status stream
+ *
+ * @param[in] ss - the stream
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error code
+ *
+ */
+int
+pbs_statstream_close(struct pbs_statstream *ss) {
+	return (*pfn_pbs_statstream_close)(ss);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to create a pool of server connections
+ *
+ * @param[in] server - server to connect to, NULL for the default server
+ * @param[in] max_conns - most connections open at once, 0 for no limit
+ * @param[in] idle_secs - close connections idle this long, 0 for the default
+ *
+ * @return	struct pbs_connpool *
+ * @retval	the pool	success
+ * @retval	NULL		error
+ *
+ */
+struct pbs_connpool *
+pbs_connpool_create(char *server, int max_conns, int idle_secs) {
+	return (*pfn_pbs_connpool_create)(server, max_conns, idle_secs);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to take a connection from a pool
+ *
+ * @param[in] pool - the pool
+ *
+ * @return	int
+ * @retval	>=0	connection handle
+ * @retval	-1	error
+ *
+ */
+int
+pbs_connpool_get(struct pbs_connpool *pool) {
+	return (*pfn_pbs_connpool_get)(pool);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to hand a connection back to a pool
+ *
+ * @param[in] pool - the pool
+ * @param[in] c - connection handle
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+pbs_connpool_put(struct pbs_connpool *pool, int c) {
+	return (*pfn_pbs_connpool_put)(pool, c);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to free a pool of server connections
+ *
+ * @param[in] pool - the pool
+ *
+ * @return	void
+ *
+ */
+void
+pbs_connpool_destroy(struct pbs_connpool *pool) {
+	(*pfn_pbs_connpool_destroy)(pool);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to send a status request without waiting for the reply
+ *
+ * @param[in] c - communication handle
+ * @param[in] obj_type - type of the objects
+ * @param[in] id - object id
+ * @param[in] attrib - pointer to attribute list
+ * @param[in] extend - extend string for req
+ *
+ * @return	int
+ * @retval	>0	sequence number of the request
+ * @retval	-1	error
+ *
+ */
+int
+pbs_pipe_stat(int c, int obj_type, char *id, struct attrl *attrib, char *extend) {
+	return (*pfn_pbs_pipe_stat)(c, obj_type, id, attrib, extend);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to send a select status request without waiting
+ *	for the reply
+ *
+ * @param[in] c - communication handle
+ * @param[in] attrib - selection criteria
+ * @param[in] rattrib - attributes to return
+ * @param[in] extend - extend string for req
+ *
+ * @return	int
+ * @retval	>0	sequence number of the request
+ * @retval	-1	error
+ *
+ */
+int
+pbs_pipe_selstat(int c, struct attropl *attrib, struct attrl *rattrib, char *extend) {
+	return (*pfn_pbs_pipe_selstat)(c, attrib, rattrib, extend);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to get the reply to a pipelined status request
+ *
+ * @param[in] c - communication handle
+ * @param[in] seq - sequence number of the request
+ *
+ * @return	structure handle
+ * @retval	pointer to batch_status struct		Success
+ * @retval	NULL					error
+ *
+ */
+struct batch_status *
+pbs_pipe_recv(int c, int seq) {
+	return (*pfn_pbs_pipe_recv)(c, seq);
+}
+
+/**
+ * @brief
+ *	-Pass-through call to count the pipelined requests outstanding
+ *
+ * @param[in] c - communication handle
+ *
+ * @return	int
+ * @retval	number of requests whose reply has not been received
+ *
+ */
+int
+pbs_pipe_pending(int c) {
+	return (*pfn_pbs_pipe_pending)(c);
+}
+
 /**
  * @brief
  *	-Pass-through call to get status of a queue.
@@ -735,6 +1021,25 @@ pbs_statvnode(int c, char *id, struct attrl *attrib, char *extend) {
 	return (*pfn_pbs_statvnode)(c, id, attrib, extend);
 }
 
+/**
+ * @brief
+ * 	-Pass-through call to get a summary of the vnodes by partition
+ *
+ * @param[in] c - communication handle
+ * @param[in] partition - partition to summarize, NULL for all
+ * @param[in] resources - resources to total
+ * @param[in] extend - extend string for encoding req
+ *
+ * @return	structure handle
+ * @retval	pointer to batch_status struct		Success
+ * @retval	NULL					error
+ *
+ */
+struct batch_status *
+pbs_statnodesummary(int c, char *partition, struct attrl *resources, char *extend) {
+	return (*pfn_pbs_statnodesummary)(c, partition, resources, extend);
+}
+
 
 /**
  * @brief
@@ -811,6 +1116,25 @@ pbs_submit(int c, struct attropl  *attrib, char *script, char *destination, char
 	return (*pfn_pbs_submit)(c, attrib, script, destination, extend);
 }
 
+/**
+ * @brief
+ *	-Pass-through call to submit a list of jobs in one request
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobs - array of jobs to submit
+ * @param[in] njobs - number of entries in jobs
+ * @param[in] extend - extend string for the request
+ *
+ * @return	struct batch_submit_status *
+ * @retval	list of per job results	success
+ * @retval	NULL	error, see pbs_errno
+ *
+ */
+struct batch_submit_status *
+pbs_submitjoblist(int c, struct batch_submit_job *jobs, int njobs, char *extend) {
+	return (*pfn_pbs_submitjoblist)(c, jobs, njobs, extend);
+}
+
 /**
  * @brief
  *	Pass-through call to submit reservation request
@@ -59,6 +59,8 @@ int (*pfn_pbs_holdjob)(int, char *, char *, char *) = __pbs_holdjob;
 int (*pfn_pbs_loadconf)(int) = __pbs_loadconf;
 char *(*pfn_pbs_locjob)(int, char *, char *) = __pbs_locjob;
 int (*pfn_pbs_manager)(int, int, int, char *, struct attropl *, char *) = __pbs_manager;
+struct batch_deljob_status *(*pfn_pbs_managejoblist)(int, int, char **, int, struct attropl *, struct attrl *, char *, char *) = __pbs_managejoblist;
+int (*pfn_pbs_modifynodes)(int, int, char *, struct attropl *, struct attropl *, char *) = __pbs_modifynodes;
 int (*pfn_pbs_movejob)(int, char *, char *, char *) = __pbs_movejob;
 int (*pfn_pbs_msgjob)(int, char *, int, char *, char *) = __pbs_msgjob;
 int (*pfn_pbs_orderjob)(int, char *, char *, char *) = __pbs_orderjob;
@@ -69,19 +71,35 @@ char **(*pfn_pbs_selectjob)(int, struct attropl *, char *) = __pbs_selectjob;
 int (*pfn_pbs_sigjob)(int, char *, char *, char *) = __pbs_sigjob;
 void (*pfn_pbs_statfree)(struct batch_status *) = __pbs_statfree;
 void (*pfn_pbs_delstatfree)(struct batch_deljob_status *) = __pbs_delstatfree;
+void (*pfn_pbs_submitstatfree)(struct batch_submit_status *) = __pbs_submitstatfree;
 struct batch_status *(*pfn_pbs_statrsc)(int, char *, struct attrl *, char *) = __pbs_statrsc;
 struct batch_status *(*pfn_pbs_statjob)(int, char *, struct attrl *, char *) = __pbs_statjob;
 struct batch_status *(*pfn_pbs_selstat)(int, struct attropl *, struct attrl *, char *) = __pbs_selstat;
+struct pbs_statstream *(*pfn_pbs_statjob_stream)(int, char *, struct attrl *, char *) = __pbs_statjob_stream;
+struct pbs_statstream *(*pfn_pbs_selstat_stream)(int, struct attropl *, struct attrl *, char *) = __pbs_selstat_stream;
+struct batch_status *(*pfn_pbs_statstream_next)(struct pbs_statstream *) = __pbs_statstream_next;
+struct batch_status *(*pfn_pbs_statstream_nextn)(struct pbs_statstream *, int) = __pbs_statstream_nextn;
+int (*pfn_pbs_statstream_close)(struct pbs_statstream *) = __pbs_statstream_close;
+struct pbs_connpool *(*pfn_pbs_connpool_create)(char *, int, int) = __pbs_connpool_create;
+int (*pfn_pbs_connpool_get)(struct pbs_connpool *) = __pbs_connpool_get;
+int (*pfn_pbs_connpool_put)(struct pbs_connpool *, int) = __pbs_connpool_put;
+void (*pfn_pbs_connpool_destroy)(struct pbs_connpool *) = __pbs_connpool_destroy;
+int (*pfn_pbs_pipe_stat)(int, int, char *, struct attrl *, char *) = __pbs_pipe_stat;
+int (*pfn_pbs_pipe_selstat)(int, struct attropl *, struct attrl *, char *) = __pbs_pipe_selstat;
+struct batch_status *(*pfn_pbs_pipe_recv)(int, int) = __pbs_pipe_recv;
+int (*pfn_pbs_pipe_pending)(int) = __pbs_pipe_pending;
 struct batch_status *(*pfn_pbs_statque)(int, char *, struct attrl *, char *) = __pbs_statque;
 struct batch_status *(*pfn_pbs_statserver)(int, struct attrl *, char *) = __pbs_statserver;
 struct batch_status *(*pfn_pbs_statsched)(int, struct attrl *, char *) = __pbs_statsched;
 struct batch_status *(*pfn_pbs_stathost)(int, char *, struct attrl *, char *) = __pbs_stathost;
 struct batch_status *(*pfn_pbs_statnode)(int, char *, struct attrl *, char *) = __pbs_statnode;
 struct batch_status *(*pfn_pbs_statvnode)(int, char *, struct attrl *, char *) = __pbs_statvnode;
+struct batch_status *(*pfn_pbs_statnodesummary)(int, char *, struct attrl *, char *) = __pbs_statnodesummary;
 struct batch_status *(*pfn_pbs_statresv)(int, char *, struct attrl *, char *) = __pbs_statresv;
 struct batch_status *(*pfn_pbs_stathook)(int, char *, struct attrl *, char *) = __pbs_stathook;
 struct ecl_attribute_errors * (*pfn_pbs_get_attributes_in_error)(int) = __pbs_get_attributes_in_error;
 char *(*pfn_pbs_submit)(int, struct attropl *, char *, char *, char *) = __pbs_submit;
+struct batch_submit_status *(*pfn_pbs_submitjoblist)(int, struct batch_submit_job *, int, char *) = __pbs_submitjoblist;
 char *(*pfn_pbs_submit_resv)(int, struct attropl *, char *) = __pbs_submit_resv;
 int (*pfn_pbs_delresv)(int, char *, char *) = __pbs_delresv;
 int (*pfn_pbs_terminate)(int, int, char *) = __pbs_terminate;
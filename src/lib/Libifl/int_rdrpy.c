@@ -187,6 +187,10 @@ PBSD_FreeReply(struct batch_reply *reply)
 	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_Delete) {
 		if (reply->brp_un.brp_deletejoblist.brp_delstatc)
 			pbs_delstatfree(reply->brp_un.brp_deletejoblist.brp_delstatc);
+
+	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_SubmitList) {
+		if (reply->brp_un.brp_substatc)
+			pbs_submitstatfree(reply->brp_un.brp_substatc);
 	
 	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_RescQuery) {
 		free(reply->brp_un.brp_rescq.brq_avail);
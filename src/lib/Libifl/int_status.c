@@ -47,6 +47,12 @@
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#ifndef WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#endif
 #include "libpbs.h"
 #include "pbs_ecl.h"
 #include "libutil.h"
@@ -512,33 +518,117 @@ aggregate_svr(struct batch_status *sv1, struct batch_status *sv2)
 	aggr_resc_ct(sv1, sv2);
 }
 
+/* the status reply of one server instance, see read_instance_reply() */
+struct instance_reply {
+	int sd;				/* connection to the instance */
+	int threaded;			/* read by a thread of its own */
+	pthread_t tid;
+	int done;			/* the reply has been read or given up on */
+	int timedout;			/* instance did not start to reply in time */
+	int errcode;			/* pbs_errno after reading the reply */
+	struct batch_status *bs;	/* the reply */
+	struct batch_status *last;	/* last element of bs */
+};
+
 /**
  * @brief
- *	wrapper function for PBSD_status
- *	gets aggregated value for all servers.
+ *	Wait until a server instance starts to reply, for at most
+ *	PBS_STAT_INSTANCE_TIMEOUT seconds.
+ *
+ * @param[in] sd - connection to the instance
+ *
+ * @return int
+ * @retval 1	reply data is available, or no limit is set
+ * @retval 0	timed out
+ */
+static int
+wait_instance_reply(int sd)
+{
+	int tmout = pbs_conf.pbs_stat_instance_timeout;
+	int rc;
+#ifdef WIN32
+	fd_set readset;
+	struct timeval tv;
+
+	if (tmout == 0)
+		return 1;
+	FD_ZERO(&readset);
+	FD_SET((unsigned int)sd, &readset);
+	tv.tv_sec = tmout;
+	tv.tv_usec = 0;
+	rc = select(FD_SETSIZE, &readset, NULL, NULL, &tv);
+#else
+	struct pollfd pfd;
+
+	if (tmout == 0)
+		return 1;
+	pfd.fd = sd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	while ((rc = poll(&pfd, 1, tmout * 1000)) == -1 && errno == EINTR)
+		;
+#endif
+	/* let an error surface from the read that follows */
+	return (rc != 0);
+}
+
+/**
+ * @brief
+ *	Read and decode the status reply of one server instance.  Runs in a
+ *	thread of its own when several instances reply, so that the replies
+ *	are received and decoded concurrently.
+ *
+ * @param[in,out] arg - struct instance_reply of the instance
+ *
+ * @return void *
+ * @retval NULL always
+ */
+static void *
+read_instance_reply(void *arg)
+{
+	struct instance_reply *ir = arg;
+
+	/* without a thread context, leave the reply to the calling thread */
+	if (ir->threaded && pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+	if (!wait_instance_reply(ir->sd)) {
+		ir->timedout = 1;
+		ir->errcode = PBSE_NOSERVER;
+	} else {
+		ir->bs = PBSD_status_get(ir->sd, &ir->last);
+		ir->errcode = pbs_errno;
+	}
+	ir->done = 1;
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Send a status request to the server instances that are to answer it:
+ *	the instance owning the job for a job id, every instance otherwise.
+ *	The caller holds the connection lock.
  *
  * @param[in] c - communication handle
- * @param[in] id - job id
+ * @param[in] cmd - command
+ * @param[in] id - object id
  * @param[in] attrib - pointer to attribute list
  * @param[in] extend - extend string for req
- * @param[in] cmd - command
- *
- * @return	structure handle
- * @retval	pointer to batch_status struct		success
- * @retval	NULL					error
+ * @param[in] parent_object - object type
+ * @param[in] rattrib - attributes to return, for PBS_BATCH_SelStat
+ * @param[out] sent - set to 1 for each instance the request was sent to,
+ *		      sized for get_num_servers() instances
  *
+ * @return int
+ * @retval 0	the request went to every instance that was to answer it
+ * @retval !0	error code of the last instance that could not be sent to
  */
-struct batch_status *
-PBSD_status_aggregate(int c, int cmd, char *id, void *attrib, char *extend, int parent_object, struct attrl *rattrib)
+int
+PBSD_status_send(int c, int cmd, char *id, void *attrib, char *extend, int parent_object, struct attrl *rattrib, int *sent)
 {
 	int i;
 	int rc = 0;
-	struct batch_status *ret = NULL;
-	struct batch_status *next = NULL;
-	struct batch_status *cur = NULL;
 	svr_conn_t *svr_connections = get_conn_svr_instances(c);
 	int num_cfg_svrs = get_num_servers();
-	int *failed_conn;
 	char server_out[PBS_MAXSERVERNAME + 1];
 	char server_name[PBS_MAXSERVERNAME + 1];
 	int single_itr = 0;
@@ -546,18 +636,9 @@ PBSD_status_aggregate(int c, int cmd, char *id, void *attrib, char *extend, int
 	uint server_port;
 	int start = 0;
 	int ct;
-	struct batch_status *last = NULL;
 
 	if (!svr_connections)
-		return NULL;
-
-	failed_conn = calloc(num_cfg_svrs, sizeof(int));
-
-	if (pbs_client_thread_init_thread_context() != 0)
-		return NULL;
-
-	if (pbs_verify_attributes(random_srv_conn(svr_connections), cmd, parent_object, MGR_CMD_NONE, (struct attropl *) attrib) != 0)
-		return NULL;
+		return PBSE_NOSERVER;
 
 	if ((parent_object == MGR_OBJ_JOB) && (get_server(id, job_id_out, server_out) == 0)) {
 		if (PBS_get_server(server_out, server_name, &server_port)) {
@@ -571,9 +652,7 @@ PBSD_status_aggregate(int c, int cmd, char *id, void *attrib, char *extend, int
 		}
 	}
 
-	if (pbs_client_thread_lock_connection(c) != 0)
-		return NULL;
-
+	memset(sent, 0, num_cfg_svrs * sizeof(int));
 	for (i = start, ct = 0; ct < num_cfg_svrs; i = (i + 1) % num_cfg_svrs, ct++) {
 		if (svr_connections[i].state != SVR_CONN_STATE_UP) {
 			rc = PBSE_NOSERVER;
@@ -589,44 +668,160 @@ PBSD_status_aggregate(int c, int cmd, char *id, void *attrib, char *extend, int
 			rc = PBSD_status_put(svr_connections[i].sd, cmd, id, (struct attrl *) attrib, extend, PROT_TCP, NULL);
 		}
 
-		if (rc) {
-			failed_conn[i] = 1;
+		if (rc)
 			continue;
-		} else if (single_itr)
+		sent[i] = 1;
+		if (single_itr)
 			break;
 	}
 
-	for (i = start, ct = 0; ct < num_cfg_svrs; i = (i + 1) % num_cfg_svrs, ct++) {
+	return rc;
+}
+
+/**
+ * @brief
+ *	Merge the status reply of one server instance into the replies of
+ *	the instances before it: servers and queues are aggregated by name,
+ *	other objects are appended.
+ *
+ * @param[in,out] ret - merged list, NULL before the first reply
+ * @param[in,out] last - last element of *ret
+ * @param[in] next - reply of the instance, consumed
+ * @param[in] next_last - last element of next
+ * @param[in] parent_object - object type
+ *
+ * @return void
+ */
+void
+PBSD_status_merge(struct batch_status **ret, struct batch_status **last,
+	struct batch_status *next, struct batch_status *next_last, int parent_object)
+{
+	if (next == NULL)
+		return;
 
-		if (svr_connections[i].state != SVR_CONN_STATE_UP || failed_conn[i])
+	if (*ret == NULL) {
+		*ret = next;
+		*last = next_last;
+		return;
+	}
+
+	switch (parent_object) {
+	case MGR_OBJ_SERVER:
+		aggregate_svr(*ret, next);
+		pbs_statfree(next);
+		break;
+	case MGR_OBJ_QUEUE:
+		aggregate_queue(*ret, &next);
+		pbs_statfree(next);
+		break;
+	default:
+		(*last)->next = next;
+		*last = next_last;
+	}
+}
+
+/**
+ * @brief
+ *	wrapper function for PBSD_status
+ *	gets aggregated value for all servers.
+ *
+ * @param[in] c - communication handle
+ * @param[in] id - job id
+ * @param[in] attrib - pointer to attribute list
+ * @param[in] extend - extend string for req
+ * @param[in] cmd - command
+ *
+ * @return	structure handle
+ * @retval	pointer to batch_status struct		success
+ * @retval	NULL					error
+ *
+ */
+struct batch_status *
+PBSD_status_aggregate(int c, int cmd, char *id, void *attrib, char *extend, int parent_object, struct attrl *rattrib)
+{
+	int i;
+	int rc = 0;
+	struct batch_status *ret = NULL;
+	svr_conn_t *svr_connections = get_conn_svr_instances(c);
+	int num_cfg_svrs = get_num_servers();
+	int *sent;
+	struct instance_reply *replies;
+	int nreplies = 0;
+	int ct;
+	struct batch_status *last = NULL;
+
+	if (!svr_connections)
+		return NULL;
+
+	if (pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+
+	if (pbs_verify_attributes(random_srv_conn(svr_connections), cmd, parent_object, MGR_CMD_NONE, (struct attropl *) attrib) != 0)
+		return NULL;
+
+	sent = calloc(num_cfg_svrs, sizeof(int));
+	replies = calloc(num_cfg_svrs, sizeof(struct instance_reply));
+	if (sent == NULL || replies == NULL) {
+		free(sent);
+		free(replies);
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+
+	if (pbs_client_thread_lock_connection(c) != 0) {
+		free(sent);
+		free(replies);
+		return NULL;
+	}
+
+	rc = PBSD_status_send(c, cmd, id, attrib, extend, parent_object, rattrib, sent);
+
+	/*
+	 * Read the replies of all instances concurrently, each in a thread of
+	 * its own but the first, and merge them in instance order as they are
+	 * done, so the result is the same as when read one after the other.
+	 */
+	for (i = 0; i < num_cfg_svrs; i++) {
+		if (!sent[i])
 			continue;
+		replies[nreplies].sd = svr_connections[i].sd;
+		nreplies++;
+	}
+	for (ct = 1; ct < nreplies; ct++) {
+		if (pthread_create(&replies[ct].tid, NULL, read_instance_reply, &replies[ct]) == 0)
+			replies[ct].threaded = 1;
+	}
 
-		if ((next = PBSD_status_get(svr_connections[i].sd, &last))) {
-			if (!ret) {
-				ret = next;
-				cur = last;
-			} else {
-				switch (parent_object) {
-				case MGR_OBJ_SERVER:
-					aggregate_svr(ret, next);
-					pbs_statfree(next);
-					next = NULL;
-					break;
-				case MGR_OBJ_QUEUE:
-					aggregate_queue(ret, &next);
-					pbs_statfree(next);
-					next = NULL;
-					break;
-				default:
-					cur->next = next;
-					cur = last;
-				}
-			}
+	for (ct = 0; ct < nreplies; ct++) {
+		struct instance_reply *ir = &replies[ct];
+
+		if (ir->threaded)
+			pthread_join(ir->tid, NULL);
+		if (!ir->done) {
+			ir->threaded = 0;
+			read_instance_reply(ir);
+		}
+		pbs_errno = ir->errcode;
+
+		if (ir->timedout) {
+			/* a late reply would be taken for the reply to a later request */
+			for (i = 0; i < num_cfg_svrs && svr_connections[i].sd != ir->sd; i++)
+				;
+			if (i < num_cfg_svrs)
+				svr_connections[i].state = SVR_CONN_STATE_DOWN;
+#ifdef WIN32
+			shutdown(ir->sd, SD_BOTH);
+#else
+			shutdown(ir->sd, SHUT_RDWR);
+#endif
+			rc = PBSE_NOSERVER;
+			continue;
 		}
 
-		if (single_itr)
-			break;
+		PBSD_status_merge(&ret, &last, ir->bs, ir->last, parent_object);
 	}
+	free(replies);
+	free(sent);
 
 	/* unlock the thread lock and update the thread context data */
 	if (pbs_client_thread_unlock_connection(c) != 0)
@@ -635,7 +830,6 @@ PBSD_status_aggregate(int c, int cmd, char *id, void *attrib, char *extend, int
 	if (rc)
 		pbs_errno = rc;
 
-	free(failed_conn);
 	return ret;
 }
 
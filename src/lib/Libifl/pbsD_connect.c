@@ -215,6 +215,26 @@ get_hostsockaddr(char *host, struct sockaddr_in *sap)
 	return -1;
 }
 
+/**
+ * @brief
+ *	Switch a new connection to the binary DIS encoding if the server
+ *	echoed the DIS_V2_OFFER sent in the extend of the Connect request.
+ *
+ * @param[in]	sd - socket of the connection
+ * @param[in]	reply - reply to the Connect request
+ *
+ * @return void
+ */
+static void
+accept_dis_version(int sd, struct batch_reply *reply)
+{
+	if (reply != NULL && reply->brp_code == 0 &&
+		reply->brp_choice == BATCH_REPLY_CHOICE_Text &&
+		reply->brp_un.brp_txt.brp_str != NULL &&
+		strcmp(reply->brp_un.brp_txt.brp_str, DIS_V2_OFFER) == 0)
+		dis_set_version(sd, DIS_VERSION_2);
+}
+
 /**
  * @brief	This function establishes a network connection to the given server.
  *
@@ -298,7 +318,11 @@ tcp_connect(char *hostname, int server_port, char *extend_data)
 	 * a message to complete the process.  For IFF authentication there is
 	 * no leading authentication message needing to be sent on the client
 	 * socket, so will send a "dummy" message and discard the replyback.
+	 * Unless told otherwise, the message offers the binary DIS encoding,
+	 * servers which do not know it ignore the offer.
 	 */
+	if (extend_data == NULL && pbs_conf.pbs_dis_version >= DIS_VERSION_2)
+		extend_data = DIS_V2_OFFER;
 	if ((i = encode_DIS_ReqHdr(sd, PBS_BATCH_Connect, pbs_current_user)) ||
 		(i = encode_DIS_ReqExtend(sd, extend_data))) {
 		closesocket(sd);
@@ -313,6 +337,7 @@ tcp_connect(char *hostname, int server_port, char *extend_data)
 
 	pbs_errno = PBSE_NONE;
 	reply = PBSD_rdrpy(sd);
+	accept_dis_version(sd, reply);
 	PBSD_FreeReply(reply);
 	if (pbs_errno != PBSE_NONE) {
 		closesocket(sd);
@@ -966,7 +991,7 @@ err:
 	 * socket, so will send a "dummy" message and discard the replyback.
 	 */
 	if ((i = encode_DIS_ReqHdr(sock, PBS_BATCH_Connect, pbs_current_user)) ||
-		(i = encode_DIS_ReqExtend(sock, NULL))) {
+		(i = encode_DIS_ReqExtend(sock, pbs_conf.pbs_dis_version >= DIS_VERSION_2 ? DIS_V2_OFFER : NULL))) {
 		pbs_errno = PBSE_SYSTEM;
 		return -1;
 	}
@@ -975,6 +1000,7 @@ err:
 		return -1;
 	}
 	reply = PBSD_rdrpy(sock);
+	accept_dis_version(sock, reply);
 	PBSD_FreeReply(reply);
 
 	if (engage_client_auth(sock, server, server_port, errbuf, sizeof(errbuf)) != 0) {
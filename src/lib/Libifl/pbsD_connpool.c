@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbsD_connpool.c
+ * @brief
+ * Pool of server connections.
+ *
+ * A client that issues many short requests, possibly from several threads,
+ * takes a connection from a pool with pbs_connpool_get() and hands it back with
+ * pbs_connpool_put() rather than calling pbs_connect() and pbs_disconnect()
+ * around each request.  A connection handed back is kept open and given
+ * out again, so the cost of connecting and authenticating is paid once per
+ * connection rather than once per request.
+ *
+ * The pool opens at most max_conns connections; pbs_connpool_get() waits for a
+ * connection to be handed back when they are all in use.  Idle connections
+ * are closed after idle_secs, well before the server drops idle clients,
+ * and a connection the server has closed is noticed and replaced before it
+ * is given out.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#ifndef WIN32
+#include <poll.h>
+#endif
+#include "libpbs.h"
+#include "net_connect.h"
+
+
+/* an idle connection of the pool */
+struct pool_conn {
+	int c;				/* connection handle */
+	time_t since;			/* when it was handed back */
+	struct pool_conn *next;
+};
+
+struct pbs_connpool {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;		/* signalled when a connection frees up */
+	char *server;			/* server to connect to, NULL for default */
+	int max_conns;			/* most connections open at once, 0 for no limit */
+	int idle_secs;			/* close connections idle this long */
+	int nopen;			/* connections open, idle or in use */
+	struct pool_conn *idle;		/* idle connections, last handed back first */
+};
+
+
+/**
+ * @brief
+ *	Check that the server has not closed a pooled connection.  The server
+ *	sends nothing unasked, so a connection that can be read from while
+ *	idle was closed or is out of step.
+ *
+ * @param[in] c - connection handle
+ *
+ * @return int
+ * @retval 1	the connection can be used
+ * @retval 0	the connection is to be discarded
+ */
+static int
+pool_conn_alive(int c)
+{
+	svr_conn_t *svr_connections = get_conn_svr_instances(c);
+	int num_cfg_svrs = get_num_servers();
+	int nup = 0;
+	int i;
+	int rc;
+
+	if (svr_connections == NULL)
+		return 0;
+
+	for (i = 0; i < num_cfg_svrs; i++) {
+		if (svr_connections[i].state != SVR_CONN_STATE_UP)
+			continue;
+#ifdef WIN32
+		{
+			fd_set readset;
+			struct timeval tv = {0, 0};
+
+			FD_ZERO(&readset);
+			FD_SET((unsigned int)svr_connections[i].sd, &readset);
+			rc = select(FD_SETSIZE, &readset, NULL, NULL, &tv);
+		}
+#else
+		{
+			struct pollfd pfd;
+
+			pfd.fd = svr_connections[i].sd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			while ((rc = poll(&pfd, 1, 0)) == -1 && errno == EINTR)
+				;
+		}
+#endif
+		if (rc != 0)
+			return 0;
+		nup++;
+	}
+
+	return (nup > 0);
+}
+
+/**
+ * @brief
+ *	Create a pool of connections to a server.  No connection is opened
+ *	until one is asked for.
+ *
+ * @param[in] server - server to connect to, NULL for the default server
+ * @param[in] max_conns - most connections to have open at once, 0 for no limit
+ * @param[in] idle_secs - close connections idle for this many seconds,
+ *			  0 for half of the server's idle client timeout
+ *
+ * @return	struct pbs_connpool *
+ * @retval	the pool	success
+ * @retval	NULL		error, pbs_errno is set
+ */
+struct pbs_connpool *
+__pbs_connpool_create(char *server, int max_conns, int idle_secs)
+{
+	struct pbs_connpool *pool;
+
+	if (max_conns < 0 || idle_secs < 0) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+
+	if ((pool = calloc(1, sizeof(struct pbs_connpool))) == NULL) {
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+	if (server != NULL && (pool->server = strdup(server)) == NULL) {
+		free(pool);
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+	if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+		free(pool->server);
+		free(pool);
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+	if (pthread_cond_init(&pool->cond, NULL) != 0) {
+		pthread_mutex_destroy(&pool->mutex);
+		free(pool->server);
+		free(pool);
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+	pool->max_conns = max_conns;
+	pool->idle_secs = idle_secs ? idle_secs : PBS_NET_MAXCONNECTIDLE / 2;
+
+	return pool;
+}
+
+/**
+ * @brief
+ *	Take a connection from the pool: an idle one if there is one that is
+ *	still good, a new one otherwise.  Waits for a connection to be handed
+ *	back when max_conns connections are in use.
+ *
+ * @param[in] pool - the pool
+ *
+ * @return int
+ * @retval >=0	connection handle, to be handed back with pbs_connpool_put()
+ * @retval -1	error, pbs_errno is set
+ */
+int
+__pbs_connpool_get(struct pbs_connpool *pool)
+{
+	struct pool_conn *pc;
+	struct pool_conn *stale = NULL;
+	struct pool_conn **pnext;
+	time_t now;
+	int c;
+
+	if (pool == NULL) {
+		pbs_errno = PBSE_IVALREQ;
+		return -1;
+	}
+
+	for (;;) {
+		pthread_mutex_lock(&pool->mutex);
+
+		/* everything below an idle connection has been idle longer */
+		now = time(NULL);
+		for (pnext = &pool->idle; *pnext; pnext = &(*pnext)->next) {
+			if (now - (*pnext)->since >= pool->idle_secs) {
+				stale = *pnext;
+				*pnext = NULL;
+				for (pc = stale; pc; pc = pc->next)
+					pool->nopen--;
+				break;
+			}
+		}
+
+		while (pool->idle == NULL && pool->max_conns > 0 && pool->nopen >= pool->max_conns)
+			pthread_cond_wait(&pool->cond, &pool->mutex);
+
+		if ((pc = pool->idle) != NULL)
+			pool->idle = pc->next;
+		else
+			pool->nopen++;
+		pthread_mutex_unlock(&pool->mutex);
+
+		/* close connections outside the pool lock */
+		while (stale) {
+			struct pool_conn *next = stale->next;
+
+			pbs_disconnect(stale->c);
+			free(stale);
+			stale = next;
+		}
+
+		if (pc == NULL)
+			break;
+
+		c = pc->c;
+		free(pc);
+		if (pool_conn_alive(c))
+			return c;
+
+		pbs_disconnect(c);
+		pthread_mutex_lock(&pool->mutex);
+		pool->nopen--;
+		pthread_cond_signal(&pool->cond);
+		pthread_mutex_unlock(&pool->mutex);
+	}
+
+	/* no idle connection, a slot was taken for a new one */
+	if ((c = pbs_connect(pool->server)) < 0) {
+		pthread_mutex_lock(&pool->mutex);
+		pool->nopen--;
+		pthread_cond_signal(&pool->cond);
+		pthread_mutex_unlock(&pool->mutex);
+		return -1;
+	}
+
+	return c;
+}
+
+/**
+ * @brief
+ *	Hand a connection back to the pool.  A connection that has pipelined
+ *	requests outstanding or whose last request failed at the protocol
+ *	level is closed rather than kept.
+ *
+ * @param[in] pool - the pool
+ * @param[in] c - connection handle taken with pbs_connpool_get()
+ *
+ * @return int
+ * @retval 0	success
+ * @retval !0	error, pbs_errno is set
+ */
+int
+__pbs_connpool_put(struct pbs_connpool *pool, int c)
+{
+	struct pool_conn *pc = NULL;
+
+	if (pool == NULL || c < 0)
+		return (pbs_errno = PBSE_IVALREQ);
+
+	if (pbs_pipe_pending(c) == 0 && get_conn_errno(c) != PBSE_PROTOCOL) {
+		if ((pc = malloc(sizeof(struct pool_conn))) != NULL) {
+			pc->c = c;
+			pc->since = time(NULL);
+		}
+	}
+
+	pthread_mutex_lock(&pool->mutex);
+	if (pc) {
+		pc->next = pool->idle;
+		pool->idle = pc;
+	} else
+		pool->nopen--;
+	pthread_cond_signal(&pool->cond);
+	pthread_mutex_unlock(&pool->mutex);
+
+	if (pc == NULL)
+		pbs_disconnect(c);
+
+	return 0;
+}
+
+/**
+ * @brief
+ *	Close the idle connections of a pool and free it.  Connections still
+ *	in use are left to their holders to pbs_disconnect().
+ *
+ * @param[in] pool - the pool
+ *
+ * @return void
+ */
+void
+__pbs_connpool_destroy(struct pbs_connpool *pool)
+{
+	struct pool_conn *pc;
+	struct pool_conn *idle;
+
+	if (pool == NULL)
+		return;
+
+	pthread_mutex_lock(&pool->mutex);
+	idle = pool->idle;
+	pool->idle = NULL;
+	pthread_mutex_unlock(&pool->mutex);
+
+	while ((pc = idle) != NULL) {
+		idle = pc->next;
+		pbs_disconnect(pc->c);
+		free(pc);
+	}
+
+	pthread_cond_destroy(&pool->cond);
+	pthread_mutex_destroy(&pool->mutex);
+	free(pool->server);
+	free(pool);
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbsD_managejoblist.c
+ * @brief
+ * Send the Manage Job List request to the server.
+ *
+ * The request holds, releases, signals, alters or moves every job that is
+ * named, or that matches the selection criteria, and is answered with a
+ * single reply that lists the jobs the operation failed for.  Each server
+ * instance acts on the jobs it manages.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libpbs.h"
+#include "pbs_ecl.h"
+#include "dis.h"
+
+
+/**
+ * @brief
+ *	-compare two job statuses by job id
+ *
+ * @param[in] a - pointer to a struct batch_deljob_status pointer
+ * @param[in] b - pointer to a struct batch_deljob_status pointer
+ *
+ * @return	int
+ * @retval	<0, 0, >0 as for strcmp()
+ */
+static int
+cmp_joblist_status(const void *a, const void *b)
+{
+	const struct batch_deljob_status *pa = *(struct batch_deljob_status * const *)a;
+	const struct batch_deljob_status *pb = *(struct batch_deljob_status * const *)b;
+
+	return strcmp(pa->name, pb->name);
+}
+
+/**
+ * @brief
+ *	-merge the failures reported by several server instances
+ *
+ * @par Functionality:
+ *	A job id is sent to every instance, so the instances that do not
+ *	manage the job report it as unknown.  A job is reported unknown only
+ *	if every instance did so, otherwise the real failure (if any) is kept.
+ *
+ * @param[in] list - failures of all instances, consumed
+ * @param[in] nsvrs - number of instances that replied
+ *
+ * @return	struct batch_deljob_status *
+ * @retval	merged list
+ */
+static struct batch_deljob_status *
+merge_joblist_status(struct batch_deljob_status *list, int nsvrs)
+{
+	struct batch_deljob_status **tbl;
+	struct batch_deljob_status *pdel;
+	struct batch_deljob_status *merged = NULL;
+	int ct = 0;
+	int i;
+	int j;
+
+	if (nsvrs <= 1)
+		return list;
+
+	for (pdel = list; pdel; pdel = pdel->next)
+		ct++;
+	if ((tbl = malloc(ct * sizeof(*tbl))) == NULL)
+		return list;
+	for (i = 0, pdel = list; pdel; pdel = pdel->next)
+		tbl[i++] = pdel;
+	qsort(tbl, ct, sizeof(*tbl), cmp_joblist_status);
+
+	for (i = 0; i < ct; i = j) {
+		/* entries of a job id are adjacent, keep a real failure if any */
+		pdel = tbl[i];
+		for (j = i + 1; (j < ct) && (strcmp(tbl[i]->name, tbl[j]->name) == 0); j++) {
+			if (pdel->code == PBSE_UNKJOBID)
+				pdel = tbl[j];
+		}
+		if ((pdel->code == PBSE_UNKJOBID) && (j - i < nsvrs))
+			pdel = NULL;
+		for (; i < j; i++) {
+			if (tbl[i] == pdel) {
+				pdel->next = merged;
+				merged = pdel;
+			} else {
+				tbl[i]->next = NULL;
+				pbs_delstatfree(tbl[i]);
+			}
+		}
+	}
+	free(tbl);
+	return merged;
+}
+
+/**
+ * @brief
+ *	-send one Manage Job List request on a server connection and read
+ *	the reply.
+ *
+ * @param[in] sd - server connection
+ * @param[in] op - JOBLIST_HOLD, JOBLIST_RELEASE, ...
+ * @param[in] jobids - job identifiers, may be NULL
+ * @param[in] numofjobs - number of job identifiers
+ * @param[in] selattr - criteria the jobs must match
+ * @param[in] aopl - hold types or attributes to alter
+ * @param[in] arg - signal name or destination
+ * @param[in] extend - extend string for req
+ * @param[out] failed - failures reported are appended here
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	pbs error code
+ */
+static int
+PBSD_managejoblist(int sd, int op, char **jobids, int numofjobs,
+	struct attropl *selattr, struct attropl *aopl, char *arg, char *extend,
+	struct batch_deljob_status **failed)
+{
+	struct batch_reply *reply;
+	struct batch_deljob_status *pdel;
+	int rc;
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(sd) != 0)
+		return pbs_errno;
+
+	DIS_tcp_funcs();
+	if ((rc = encode_DIS_ReqHdr(sd, PBS_BATCH_ManageJobList, pbs_current_user)) ||
+		(rc = encode_DIS_ManageJobList(sd, op, jobids, numofjobs, selattr, aopl, arg)) ||
+		(rc = encode_DIS_ReqExtend(sd, extend))) {
+		if (set_conn_errtxt(sd, dis_emsg[rc]) != 0)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		(void)pbs_client_thread_unlock_connection(sd);
+		return pbs_errno;
+	}
+	if (dis_flush(sd)) {
+		pbs_errno = PBSE_PROTOCOL;
+		(void)pbs_client_thread_unlock_connection(sd);
+		return pbs_errno;
+	}
+
+	/* read reply from stream into presentation element */
+	reply = PBSD_rdrpy(sd);
+	if (reply == NULL) {
+		if (pbs_errno == PBSE_NONE)
+			pbs_errno = PBSE_PROTOCOL;
+		rc = pbs_errno;
+	} else {
+		if ((reply->brp_choice == BATCH_REPLY_CHOICE_Delete) &&
+			((pdel = reply->brp_un.brp_deletejoblist.brp_delstatc) != NULL)) {
+			while (pdel->next)
+				pdel = pdel->next;
+			pdel->next = *failed;
+			*failed = reply->brp_un.brp_deletejoblist.brp_delstatc;
+			reply->brp_un.brp_deletejoblist.brp_delstatc = NULL;
+		}
+		PBSD_FreeReply(reply);
+		rc = get_conn_errno(sd);
+	}
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(sd) != 0)
+		return pbs_errno;
+
+	return rc;
+}
+
+/**
+ * @brief
+ *	-hold, release, signal, alter or move many jobs in one request to each
+ *	server instance.
+ *
+ * @par Functionality:
+ *	The jobs are those of jobids, or if there are none, the jobs that
+ *	match selattr and that the user may act on.  Job ids beyond
+ *	PBS_MAX_MANAGEJOBLIST are sent in further requests.
+ *
+ * @param[in] c - communication handle
+ * @param[in] op - JOBLIST_HOLD, JOBLIST_RELEASE, JOBLIST_SIGNAL,
+ *			JOBLIST_ALTER or JOBLIST_MOVE
+ * @param[in] jobids - job identifiers, may be NULL
+ * @param[in] numofjobs - number of job identifiers
+ * @param[in] selattr - criteria the jobs must match, as for
+ *			pbs_selectjob(), used if numofjobs is 0
+ * @param[in] attrib - attributes to alter, for JOBLIST_ALTER
+ * @param[in] arg - hold types for JOBLIST_HOLD and JOBLIST_RELEASE (default
+ *			"u"), signal name for JOBLIST_SIGNAL, destination for
+ *			JOBLIST_MOVE
+ * @param[in] extend - extend string for req
+ *
+ * @return	struct batch_deljob_status *
+ * @retval	list of the jobs the operation failed for, with the reason
+ * @retval	NULL	no job failed, or the request failed as a whole
+ *			(pbs_errno is set)
+ *
+ */
+struct batch_deljob_status *
+__pbs_managejoblist(int c, int op, char **jobids, int numofjobs,
+	struct attropl *selattr, struct attrl *attrib, char *arg, char *extend)
+{
+	int i;
+	int j;
+	int n;
+	int rc = 0;
+	int agg_rc = 0;
+	int nsvrs = 0;
+	int verify_type;
+	struct attropl hold;
+	struct attropl *aopl = NULL;
+	struct attropl *palter = NULL;
+	struct attrl *pattr;
+	struct batch_deljob_status *failed = NULL;
+	svr_conn_t *svr_connections = get_conn_svr_instances(c);
+	int num_cfg_svrs = get_num_servers();
+
+	if (!svr_connections) {
+		pbs_errno = PBSE_NOSERVER;
+		return NULL;
+	}
+
+	if ((op < 0) || (op >= JOBLIST_LAST) ||
+		((jobids == NULL || numofjobs <= 0) && (selattr == NULL))) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+	if (jobids == NULL)
+		numofjobs = 0;
+
+	switch (op) {
+		case JOBLIST_HOLD:
+		case JOBLIST_RELEASE:
+			hold.name = ATTR_h;
+			hold.resource = NULL;
+			hold.value = ((arg == NULL) || (*arg == '\0')) ? "u" : arg;
+			hold.op = SET;
+			hold.next = NULL;
+			aopl = &hold;
+			arg = NULL;
+			verify_type = (op == JOBLIST_HOLD) ? PBS_BATCH_HoldJob : PBS_BATCH_ReleaseJob;
+			break;
+		case JOBLIST_ALTER:
+			/* the attributes go as an attropl list, as for pbs_alterjob() */
+			for (n = 0, pattr = attrib; pattr; pattr = pattr->next)
+				n++;
+			if ((n == 0) || ((palter = calloc(n, sizeof(struct attropl))) == NULL)) {
+				pbs_errno = (n == 0) ? PBSE_IVALREQ : PBSE_SYSTEM;
+				return NULL;
+			}
+			for (i = 0, pattr = attrib; pattr; pattr = pattr->next, i++) {
+				palter[i].name = pattr->name;
+				palter[i].resource = pattr->resource;
+				palter[i].value = pattr->value;
+				palter[i].op = SET;
+				palter[i].next = (i + 1 < n) ? &palter[i + 1] : NULL;
+			}
+			aopl = palter;
+			arg = NULL;
+			verify_type = PBS_BATCH_ModifyJob;
+			break;
+		case JOBLIST_SIGNAL:
+			if ((arg == NULL) || (*arg == '\0')) {
+				pbs_errno = PBSE_IVALREQ;
+				return NULL;
+			}
+			verify_type = PBS_BATCH_SignalJob;
+			break;
+		default:
+			verify_type = PBS_BATCH_MoveJob;
+			break;
+	}
+
+	/* initialize the thread context data, if not initialized */
+	if (pbs_client_thread_init_thread_context() != 0) {
+		free(palter);
+		return NULL;
+	}
+
+	/* verify the attributes, if verification is enabled */
+	if ((selattr != NULL) && (numofjobs == 0) &&
+		pbs_verify_attributes(random_srv_conn(svr_connections), PBS_BATCH_SelectJobs,
+		MGR_OBJ_JOB, MGR_CMD_NONE, selattr)) {
+		free(palter);
+		return NULL;
+	}
+	if ((aopl != NULL) && pbs_verify_attributes(random_srv_conn(svr_connections),
+		verify_type, MGR_OBJ_JOB, MGR_CMD_SET, aopl)) {
+		free(palter);
+		return NULL;
+	}
+
+	for (i = 0; i < num_cfg_svrs; i++) {
+		if (svr_connections[i].state != SVR_CONN_STATE_UP) {
+			agg_rc = PBSE_NOSERVER;
+			continue;
+		}
+
+		j = 0;
+		do {
+			n = numofjobs - j;
+			if (n > PBS_MAX_MANAGEJOBLIST)
+				n = PBS_MAX_MANAGEJOBLIST;
+			rc = PBSD_managejoblist(svr_connections[i].sd, op,
+				numofjobs ? jobids + j : NULL, n,
+				numofjobs ? NULL : selattr, aopl, arg, extend, &failed);
+			j += n;
+		} while ((rc == 0) && (j < numofjobs));
+
+		if (rc != 0)
+			agg_rc = rc;
+		else
+			nsvrs++;
+	}
+	free(palter);
+
+	if (numofjobs > 0)
+		failed = merge_joblist_status(failed, nsvrs);
+
+	pbs_errno = agg_rc;
+	return failed;
+}
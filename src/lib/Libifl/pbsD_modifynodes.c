@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbsD_modifynodes.c
+ * @brief
+ * Send the Modify Nodes request to the server.
+ *
+ * The request alters the attributes of every vnode that is named, or that
+ * belongs to a named host, and/or that matches the selection criteria, and
+ * is answered with a single reply.  Each server instance alters the vnodes
+ * it manages.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include "libpbs.h"
+#include "pbs_ecl.h"
+#include "dis.h"
+
+
+/**
+ * @brief
+ *	-send a Modify Nodes request to each server instance and read the
+ *	replies.
+ *
+ * @param[in] c - communication handle
+ * @param[in] objtype - MGR_OBJ_NODE for vnode names, MGR_OBJ_HOST for
+ *			host names
+ * @param[in] nodes - comma separated names, NULL or "" for all vnodes
+ * @param[in] selattr - criteria the vnodes must match, may be NULL
+ * @param[in] attrib - attributes to alter, as for pbs_manager()
+ * @param[in] extend - extend string for req
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error, the reply text (see pbs_geterrmsg()) lists the
+ *			vnodes that could not be altered
+ *
+ */
+int
+__pbs_modifynodes(int c, int objtype, char *nodes, struct attropl *selattr,
+	struct attropl *attrib, char *extend)
+{
+	int i;
+	int rc = 0;
+	int agg_rc = 0;
+	struct batch_reply *reply;
+	svr_conn_t *svr_connections = get_conn_svr_instances(c);
+	int num_cfg_svrs = get_num_servers();
+
+	if (!svr_connections)
+		return (pbs_errno = PBSE_NOSERVER);
+
+	if ((objtype != MGR_OBJ_NODE && objtype != MGR_OBJ_HOST) || attrib == NULL)
+		return (pbs_errno = PBSE_IVALREQ);
+
+	/* initialize the thread context data, if not initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return pbs_errno;
+
+	/* verify the attributes, if verification is enabled */
+	if (pbs_verify_attributes(random_srv_conn(svr_connections), PBS_BATCH_Manager,
+		MGR_OBJ_NODE, MGR_CMD_SET, attrib))
+		return pbs_errno;
+
+	for (i = 0; i < num_cfg_svrs; i++) {
+		if (svr_connections[i].state != SVR_CONN_STATE_UP) {
+			agg_rc = PBSE_NOSERVER;
+			continue;
+		}
+
+		c = svr_connections[i].sd;
+
+		/* lock pthread mutex here for this connection */
+		/* blocking call, waits for mutex release */
+		if (pbs_client_thread_lock_connection(c) != 0)
+			return pbs_errno;
+
+		DIS_tcp_funcs();
+		if ((rc = encode_DIS_ReqHdr(c, PBS_BATCH_ModifyNodes, pbs_current_user)) ||
+			(rc = encode_DIS_ModifyNodes(c, objtype, nodes, selattr, attrib)) ||
+			(rc = encode_DIS_ReqExtend(c, extend))) {
+			if (set_conn_errtxt(c, dis_emsg[rc]) != 0)
+				pbs_errno = PBSE_SYSTEM;
+			else
+				pbs_errno = PBSE_PROTOCOL;
+			(void)pbs_client_thread_unlock_connection(c);
+			return pbs_errno;
+		}
+		if (dis_flush(c)) {
+			pbs_errno = PBSE_PROTOCOL;
+			(void)pbs_client_thread_unlock_connection(c);
+			return pbs_errno;
+		}
+
+		/* read reply from stream into presentation element */
+		reply = PBSD_rdrpy(c);
+		PBSD_FreeReply(reply);
+
+		rc = get_conn_errno(c);
+		if (rc != 0)
+			agg_rc = rc;
+
+		/* unlock the thread lock and update the thread context data */
+		if (pbs_client_thread_unlock_connection(c) != 0)
+			return pbs_errno;
+	}
+
+	return (pbs_errno = agg_rc);
+}
@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbsD_pipeline.c
+ * @brief
+ * Pipelined status requests.
+ *
+ * pbs_pipe_stat() and pbs_pipe_selstat() send a status request and return
+ * at once with a sequence number, without waiting for the reply, so that a
+ * client may have several status requests outstanding on one connection.
+ * pbs_pipe_recv() returns the reply to a given sequence number, aggregated
+ * over the server instances as pbs_statjob() and friends do.
+ *
+ * The server answers the status requests of a connection in the order it
+ * received them, so the replies of each instance are matched to their
+ * requests by position: when the reply to a later request is wanted, the
+ * replies to the earlier ones still outstanding are read and kept until
+ * they are asked for.  Only status requests are pipelined, as the server
+ * may defer the reply to other requests.  While requests are outstanding,
+ * the connection must not be used for a request that waits for a reply.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <string.h>
+#include <stdlib.h>
+#include "libpbs.h"
+#include "pbs_ecl.h"
+
+
+#define PIPE_UNSENT	0	/* instance was not sent the request */
+#define PIPE_OWED	1	/* instance owes the reply */
+#define PIPE_READ	2	/* reply of instance was read */
+
+/* an outstanding pipelined request */
+struct pipe_req {
+	int seq;			/* sequence number handed to the caller */
+	int parent_object;		/* object type, for aggregation */
+	int rc;				/* error sending the request */
+	int *state;			/* PIPE_* of each server instance */
+	int *codes;			/* pbs_errno after reading each reply */
+	struct batch_status **bs;	/* reply of each instance */
+	struct batch_status **last;	/* last element of each bs */
+	struct pipe_req *next;
+};
+
+/* pipelined request state of a connection, see get_conn_pipe() */
+struct pbs_pipe {
+	int next_seq;			/* sequence number of the next request */
+	int nsvrs;			/* server instances of the connection */
+	struct pipe_req *head;		/* outstanding requests, oldest first */
+	struct pipe_req *tail;
+};
+
+
+/**
+ * @brief
+ *	Free a pipelined request along with any reply read for it.
+ *
+ * @param[in] pp - pipelined request state the request belongs to
+ * @param[in] req - the request
+ *
+ * @return void
+ */
+static void
+pipe_req_free(struct pbs_pipe *pp, struct pipe_req *req)
+{
+	int i;
+
+	for (i = 0; i < pp->nsvrs; i++)
+		pbs_statfree(req->bs[i]);
+	free(req->state);
+	free(req->codes);
+	free(req->bs);
+	free(req->last);
+	free(req);
+}
+
+/**
+ * @brief
+ *	Free the pipelined request state of a connection.  Called when the
+ *	connection is removed from the connection table.
+ *
+ * @param[in] pstate - the state, may be NULL
+ *
+ * @return void
+ */
+void
+PBSD_pipe_free(void *pstate)
+{
+	struct pbs_pipe *pp = pstate;
+	struct pipe_req *req;
+
+	if (pp == NULL)
+		return;
+	while ((req = pp->head) != NULL) {
+		pp->head = req->next;
+		pipe_req_free(pp, req);
+	}
+	free(pp);
+}
+
+/**
+ * @brief
+ *	Send a status request and queue it on the pipelined request state
+ *	of the connection.
+ *
+ * @param[in] c - communication handle
+ * @param[in] cmd - command
+ * @param[in] id - object id
+ * @param[in] attrib - pointer to attribute list
+ * @param[in] extend - extend string for req
+ * @param[in] parent_object - object type
+ * @param[in] rattrib - attributes to return, for PBS_BATCH_SelStat
+ *
+ * @return int
+ * @retval >0	sequence number of the request
+ * @retval -1	error, pbs_errno is set
+ */
+static int
+pipe_send(int c, int cmd, char *id, void *attrib, char *extend, int parent_object, struct attrl *rattrib)
+{
+	svr_conn_t *svr_connections = get_conn_svr_instances(c);
+	int num_cfg_svrs = get_num_servers();
+	struct pbs_pipe *pp;
+	struct pipe_req *req;
+	int i;
+	int nsent = 0;
+	int seq;
+
+	if (!svr_connections)
+		return -1;
+
+	if (pbs_client_thread_init_thread_context() != 0)
+		return -1;
+
+	if (pbs_verify_attributes(random_srv_conn(svr_connections), cmd, parent_object, MGR_CMD_NONE, (struct attropl *) attrib) != 0)
+		return -1;
+
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return -1;
+
+	if ((pp = get_conn_pipe(c)) == NULL) {
+		if ((pp = calloc(1, sizeof(struct pbs_pipe))) == NULL)
+			goto err;
+		pp->next_seq = 1;
+		pp->nsvrs = num_cfg_svrs;
+		if (set_conn_pipe(c, pp) != 0) {
+			free(pp);
+			goto err;
+		}
+	}
+
+	if ((req = calloc(1, sizeof(struct pipe_req))) == NULL)
+		goto err;
+	req->state = calloc(pp->nsvrs, sizeof(int));
+	req->codes = calloc(pp->nsvrs, sizeof(int));
+	req->bs = calloc(pp->nsvrs, sizeof(struct batch_status *));
+	req->last = calloc(pp->nsvrs, sizeof(struct batch_status *));
+	if (req->state == NULL || req->codes == NULL || req->bs == NULL || req->last == NULL) {
+		pipe_req_free(pp, req);
+		goto err;
+	}
+
+	req->parent_object = parent_object;
+	req->rc = PBSD_status_send(c, cmd, id, attrib, extend, parent_object, rattrib, req->state);
+	for (i = 0; i < pp->nsvrs; i++)
+		nsent += req->state[i];
+	if (nsent == 0) {
+		/* nothing is owed, so there is nothing to pipeline */
+		pbs_errno = req->rc;
+		pipe_req_free(pp, req);
+		(void)pbs_client_thread_unlock_connection(c);
+		return -1;
+	}
+
+	req->seq = seq = pp->next_seq++;
+	if (pp->next_seq <= 0)
+		pp->next_seq = 1;
+	if (pp->tail)
+		pp->tail->next = req;
+	else
+		pp->head = req;
+	pp->tail = req;
+
+	if (pbs_client_thread_unlock_connection(c) != 0)
+		return -1;
+	return seq;
+
+err:
+	pbs_errno = PBSE_SYSTEM;
+	(void)pbs_client_thread_unlock_connection(c);
+	return -1;
+}
+
+/**
+ * @brief
+ *	Send a status request for objects of a given type without waiting
+ *	for the reply.
+ *
+ * @param[in] c - communication handle
+ * @param[in] obj_type - MGR_OBJ_JOB, MGR_OBJ_QUEUE, MGR_OBJ_SERVER,
+ *			 MGR_OBJ_NODE or MGR_OBJ_RESV
+ * @param[in] id - object id, NULL or "" for all objects
+ * @param[in] attrib - pointer to attribute list
+ * @param[in] extend - extend string for req
+ *
+ * @return int
+ * @retval >0	sequence number to pass to pbs_pipe_recv()
+ * @retval -1	error, pbs_errno is set
+ */
+int
+__pbs_pipe_stat(int c, int obj_type, char *id, struct attrl *attrib, char *extend)
+{
+	int cmd;
+
+	switch (obj_type) {
+	case MGR_OBJ_JOB:
+		cmd = PBS_BATCH_StatusJob;
+		break;
+	case MGR_OBJ_QUEUE:
+		cmd = PBS_BATCH_StatusQue;
+		break;
+	case MGR_OBJ_SERVER:
+		cmd = PBS_BATCH_StatusSvr;
+		id = "";
+		break;
+	case MGR_OBJ_NODE:
+		cmd = PBS_BATCH_StatusNode;
+		break;
+	case MGR_OBJ_RESV:
+		cmd = PBS_BATCH_StatusResv;
+		break;
+	default:
+		pbs_errno = PBSE_IVALREQ;
+		return -1;
+	}
+
+	return pipe_send(c, cmd, id, attrib, extend, obj_type, NULL);
+}
+
+/**
+ * @brief
+ *	Send a select status request for jobs without waiting for the reply.
+ *
+ * @param[in] c - communication handle
+ * @param[in] attrib - selection criteria, as for pbs_selstat()
+ * @param[in] rattrib - attributes to return
+ * @param[in] extend - extend string for req
+ *
+ * @return int
+ * @retval >0	sequence number to pass to pbs_pipe_recv()
+ * @retval -1	error, pbs_errno is set
+ */
+int
+__pbs_pipe_selstat(int c, struct attropl *attrib, struct attrl *rattrib, char *extend)
+{
+	return pipe_send(c, PBS_BATCH_SelStat, NULL, attrib, extend, MGR_OBJ_JOB, rattrib);
+}
+
+/**
+ * @brief
+ *	Read the reply of one server instance to every outstanding request
+ *	up to and including a given one, in the order the requests were sent.
+ *
+ * @param[in] pp - pipelined request state of the connection
+ * @param[in] upto - the last request to read the reply to
+ * @param[in] i - index of the server instance
+ * @param[in] svr - the server instance
+ *
+ * @return void
+ */
+static void
+pipe_read_instance(struct pbs_pipe *pp, struct pipe_req *upto, int i, svr_conn_t *svr)
+{
+	struct pipe_req *req;
+	int lost = 0;
+
+	for (req = pp->head; req; req = req->next) {
+		if (req->state[i] == PIPE_OWED) {
+			if (lost || svr->state != SVR_CONN_STATE_UP) {
+				req->codes[i] = lost ? PBSE_PROTOCOL : PBSE_NOSERVER;
+			} else {
+				req->bs[i] = PBSD_status_get(svr->sd, &req->last[i]);
+				req->codes[i] = pbs_errno;
+				/* replies still owed can no longer be told apart */
+				if (pbs_errno == PBSE_PROTOCOL)
+					lost = 1;
+			}
+			req->state[i] = PIPE_READ;
+		}
+		if (req == upto && !lost)
+			break;
+	}
+}
+
+/**
+ * @brief
+ *	Wait for the reply to a pipelined status request.  Replies to earlier
+ *	requests still outstanding are read first and kept for a later call.
+ *
+ * @param[in] c - communication handle
+ * @param[in] seq - sequence number returned by pbs_pipe_stat() or
+ *		    pbs_pipe_selstat()
+ *
+ * @return	structure handle
+ * @retval	pointer to batch_status struct		success
+ * @retval	NULL					error, or no object matched
+ *
+ */
+struct batch_status *
+__pbs_pipe_recv(int c, int seq)
+{
+	svr_conn_t *svr_connections = get_conn_svr_instances(c);
+	struct pbs_pipe *pp;
+	struct pipe_req *req;
+	struct pipe_req *prev = NULL;
+	struct batch_status *ret = NULL;
+	struct batch_status *last = NULL;
+	int i;
+
+	if (!svr_connections)
+		return NULL;
+
+	if (pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return NULL;
+
+	pp = get_conn_pipe(c);
+	for (req = pp ? pp->head : NULL; req && req->seq != seq; prev = req, req = req->next)
+		;
+	if (req == NULL) {
+		(void)pbs_client_thread_unlock_connection(c);
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+
+	for (i = 0; i < pp->nsvrs; i++) {
+		if (req->state[i] == PIPE_OWED)
+			pipe_read_instance(pp, req, i, &svr_connections[i]);
+	}
+
+	/* merge in instance order, as PBSD_status_aggregate() does */
+	for (i = 0; i < pp->nsvrs; i++) {
+		if (req->state[i] != PIPE_READ)
+			continue;
+		pbs_errno = req->codes[i];
+		PBSD_status_merge(&ret, &last, req->bs[i], req->last[i], req->parent_object);
+		req->bs[i] = NULL;
+	}
+	if (req->rc)
+		pbs_errno = req->rc;
+
+	if (prev)
+		prev->next = req->next;
+	else
+		pp->head = req->next;
+	if (pp->tail == req)
+		pp->tail = prev;
+	pipe_req_free(pp, req);
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0) {
+		pbs_statfree(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+/**
+ * @brief
+ *	Tell the number of pipelined requests still outstanding on a connection.
+ *
+ * @param[in] c - communication handle
+ *
+ * @return int
+ * @retval number of requests whose reply has not been received
+ */
+int
+__pbs_pipe_pending(int c)
+{
+	struct pbs_pipe *pp;
+	struct pipe_req *req;
+	int n = 0;
+
+	if (pbs_client_thread_init_thread_context() != 0)
+		return 0;
+
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return 0;
+	if ((pp = get_conn_pipe(c)) != NULL) {
+		for (req = pp->head; req; req = req->next)
+			n++;
+	}
+	(void)pbs_client_thread_unlock_connection(c);
+	return n;
+}
@@ -38,13 +38,17 @@
  */
 
 /**
- * @file	pbs_statnode.c - contains pbs_statnode() and pbs_statvnode()
+ * @file	pbs_statnode.c - contains pbs_statnode(), pbs_statvnode() and
+ *		pbs_statnodesummary()
  * @brief
- * Return the status of host(s) or vnodes.
+ * Return the status of host(s) or vnodes, or a summary of the vnodes.
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "libpbs.h"
 #include "pbs_ecl.h"
 
@@ -89,3 +93,153 @@ __pbs_statvnode(int c, char *id, struct attrl *attrib, char *extend)
 {
 	return PBSD_status_aggregate(c, PBS_BATCH_StatusNode, id, attrib, extend, MGR_OBJ_NODE, NULL);
 }
+
+/**
+ * @brief
+ *	-add a value of a node summary to the same value from another server
+ *	instance.
+ *
+ * @par
+ *	Counts and totals of long resources are integers, totals of size
+ *	resources are integers in kb, totals of float resources have a
+ *	decimal point.
+ *
+ * @param[in,out] pat - attribute holding the sum
+ * @param[in] val - value to add
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	out of memory
+ *
+ */
+static int
+add_summary_value(struct attrl *pat, char *val)
+{
+	char buf[64];
+	char *unit;
+	char *newval;
+	long long sum;
+
+	if (strchr(pat->value, '.') != NULL || strchr(val, '.') != NULL)
+		snprintf(buf, sizeof(buf), "%.2f", strtod(pat->value, NULL) + strtod(val, NULL));
+	else {
+		sum = strtoll(pat->value, &unit, 10) + strtoll(val, NULL, 10);
+		snprintf(buf, sizeof(buf), "%lld%s", sum, unit);
+	}
+	if ((newval = strdup(buf)) == NULL)
+		return -1;
+	free(pat->value);
+	pat->value = newval;
+	return 0;
+}
+
+/**
+ * @brief
+ *	-merge the summaries of the same partition sent by different server
+ *	instances.
+ *
+ * @param[in,out] bs - summaries as received, merged in place
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	-1	out of memory
+ *
+ */
+static int
+merge_node_summary(struct batch_status *bs)
+{
+	struct batch_status *pbs;
+	struct batch_status *prev;
+	struct batch_status *dup;
+	struct attrl *pat;
+	struct attrl *nxt;
+	struct attrl *to;
+	struct attrl *after;
+
+	for (pbs = bs; pbs; pbs = pbs->next) {
+		prev = pbs;
+		while ((dup = prev->next) != NULL) {
+			if (strcmp(dup->name, pbs->name) != 0) {
+				prev = dup;
+				continue;
+			}
+			for (pat = dup->attribs; pat; pat = nxt) {
+				nxt = pat->next;
+				after = NULL;
+				for (to = pbs->attribs; to; to = to->next) {
+					if (strcmp(to->name, pat->name) != 0) {
+						if (to->next == NULL && after == NULL)
+							after = to;
+						continue;
+					}
+					if (strcmp(to->resource ? to->resource : "",
+						pat->resource ? pat->resource : "") == 0)
+						break;
+					after = to;
+				}
+				if (to == NULL) {
+					/* move it over, after the others of the same name */
+					if (after == NULL) {
+						pat->next = pbs->attribs;
+						pbs->attribs = pat;
+					} else {
+						pat->next = after->next;
+						after->next = pat;
+					}
+					continue;
+				}
+				if (add_summary_value(to, pat->value) != 0) {
+					dup->attribs = pat;
+					return -1;
+				}
+				free(pat->name);
+				free(pat->resource);
+				free(pat->value);
+				free(pat);
+			}
+			dup->attribs = NULL;
+			prev->next = dup->next;
+			dup->next = NULL;
+			pbs_statfree(dup);
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	-__pbs_statnodesummary() - returns a summary of the vnodes, computed
+ *	by the server, with one object per partition
+ *
+ * @par
+ *	The objects are named after the partition, "" for vnodes in no
+ *	partition.  Each has a "state" attribute per vnode state seen, with
+ *	the state as resource and the number of vnodes as value, and
+ *	"resources_available" and "resources_assigned" attributes with the
+ *	totals of the requested resources.
+ *
+ * @param[in] c - communication handle
+ * @param[in] partition - summarize this partition only, NULL or "" for all
+ * @param[in] resources - resources_available entries naming the resources
+ *			to total, NULL for ncpus, mem and ngpus
+ * @param[in] extend - extend string for encoding req
+ *
+ * @return	structure handle
+ * @retval	pointer to batch_status struct		Success
+ * @retval	NULL					error, PBSE_UNKREQ
+ *							from an older server
+ *
+ */
+struct batch_status *
+__pbs_statnodesummary(int c, char *partition, struct attrl *resources, char *extend)
+{
+	struct batch_status *bs;
+
+	bs = PBSD_status_aggregate(c, PBS_BATCH_StatusNodeSummary, partition, resources, extend, MGR_OBJ_NODE, NULL);
+	if (bs != NULL && get_num_servers() > 1 && merge_node_summary(bs) != 0) {
+		pbs_statfree(bs);
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+	return bs;
+}
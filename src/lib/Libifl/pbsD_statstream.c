@@ -0,0 +1,650 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbsD_statstream.c
+ * @brief
+ * Streaming job status.
+ *
+ * pbs_statjob_stream() and pbs_selstat_stream() send the same request as
+ * pbs_statjob() and pbs_selstat(), but rather than decoding the whole reply
+ * into a list they hand the objects to the caller one at a time as they are
+ * read off the connection.  Each object is decoded by the same routine as
+ * decode_DIS_replyCmd() uses, into memory owned by the stream and reused for
+ * the next object, so a caller walking a reply of many thousand jobs neither
+ * allocates per attribute nor holds the whole reply in memory.  The caller
+ * may stop early; pbs_statstream_close() discards what is left of the reply.
+ *
+ * The connection lock is only held while a request is sent or a piece of
+ * the reply is read.  Until the stream is closed, nothing else may be sent
+ * on the connection, not even requests which do not wait for a reply like
+ * pbs_asyalterjob(): the server does not read them while it is writing the
+ * reply, and once both sides fill their socket buffers neither moves on.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include "libpbs.h"
+#include "pbs_ecl.h"
+#include "attribute.h"
+#include "dis.h"
+#include "pbs_internal.h"
+
+
+extern char * PBS_get_server(char *, char *, uint *);
+
+/* round a size up so that what follows it in a block is aligned */
+#define SS_ALIGN(n)	(((n) + sizeof(double) - 1) & ~(sizeof(double) - 1))
+
+/* a block of the memory an object is decoded into */
+struct ss_blk {
+	struct ss_blk *next;
+	size_t size;		/* bytes of data */
+	size_t used;
+	double data[1];		/* aligned start of the data */
+};
+
+struct pbs_statstream {
+	int c;			/* connection handle the stream was opened on */
+	svr_conn_t *svrs;	/* server instances of c */
+	int nsvrs;
+	int *pending;		/* pending[i] is set while server i owes a reply */
+	int cur;		/* server whose reply is being read, -1 if none */
+	int nleft;		/* objects left in the current reply part */
+	int is_part;		/* another reply part follows from cur */
+	int code;		/* last non-zero reply code */
+	int failed;		/* the reply could not be decoded */
+	struct batch_status bs;	/* the object handed to the caller */
+	struct ss_blk *blks;	/* memory of bs, newest block first */
+	struct dis_attrl_alloc da; /* hands out memory from blks */
+};
+
+
+/**
+ * @brief
+ *	Allocate n bytes for the current object of the stream.  What has
+ *	been handed out stays put until the stream moves to the next object.
+ *
+ * @param[in] ss - the stream
+ * @param[in] n - number of bytes
+ *
+ * @return	void *
+ * @retval	the memory	success
+ * @retval	NULL	malloc failure
+ *
+ */
+static void *
+ss_alloc(struct pbs_statstream *ss, size_t n)
+{
+	struct ss_blk *b = ss->blks;
+	void *p;
+
+	n = SS_ALIGN(n);
+	if (b == NULL || b->size - b->used < n) {
+		size_t sz = b ? b->size * 2 : PBS_DIS_BUFSZ;
+
+		while (sz < n)
+			sz *= 2;
+		if ((b = malloc(offsetof(struct ss_blk, data) + sz)) == NULL)
+			return NULL;
+		b->size = sz;
+		b->used = 0;
+		b->next = ss->blks;
+		ss->blks = b;
+	}
+	p = (char *) b->data + b->used;
+	b->used += n;
+	return p;
+}
+
+/**
+ * @brief
+ *	Make the memory of the stream free for the next object.  If the last
+ *	object took more than one block, the blocks are replaced by one as
+ *	big as all of them.
+ *
+ * @param[in] ss - the stream
+ *
+ * @return void
+ *
+ */
+static void
+ss_reset(struct pbs_statstream *ss)
+{
+	struct ss_blk *b;
+	size_t total = 0;
+
+	if (ss->blks == NULL)
+		return;
+	if (ss->blks->next == NULL) {
+		ss->blks->used = 0;
+		return;
+	}
+	while ((b = ss->blks) != NULL) {
+		total += b->size;
+		ss->blks = b->next;
+		free(b);
+	}
+	if ((b = malloc(offsetof(struct ss_blk, data) + total)) != NULL) {
+		b->size = total;
+		b->used = 0;
+		b->next = NULL;
+		ss->blks = b;
+	}
+}
+
+/**
+ * @brief
+ *	Attribute allocator of the stream for decode_DIS_status_obj().
+ *
+ * @param[in] ctx - the stream
+ *
+ * @return	struct attrl *
+ * @retval	a zeroed attrl	success
+ * @retval	NULL	malloc failure
+ *
+ */
+static struct attrl *
+ss_attrl(void *ctx)
+{
+	struct attrl *pat;
+
+	if ((pat = ss_alloc((struct pbs_statstream *) ctx, sizeof(struct attrl))) != NULL)
+		memset(pat, 0, sizeof(struct attrl));
+	return pat;
+}
+
+/**
+ * @brief
+ *	String reader of the stream for decode_DIS_status_obj(): the string
+ *	is copied from the read buffer into the memory of the stream.
+ *
+ * @param[in] sd - socket to read from
+ * @param[in] ctx - the stream
+ * @param[out] rc - DIS_SUCCESS or DIS error code
+ *
+ * @return	char *
+ * @retval	null terminated string	success
+ * @retval	NULL	error, see rc
+ *
+ */
+static char *
+ss_str(int sd, void *ctx, int *rc)
+{
+	char *s;
+	char *copy;
+	size_t n;
+
+	if ((*rc = disrcsp(sd, &s, &n)) != DIS_SUCCESS)
+		return NULL;
+	if ((copy = ss_alloc((struct pbs_statstream *) ctx, n + 1)) == NULL) {
+		*rc = DIS_NOMALLOC;
+		return NULL;
+	}
+	memcpy(copy, s, n);
+	copy[n] = '\0';
+	return copy;
+}
+
+/**
+ * @brief
+ *	Read a reply header from the current server and take in whatever
+ *	precedes the status objects.
+ *
+ * @param[in] ss - the stream
+ *
+ * @return	int
+ * @retval	DIS_SUCCESS	success
+ * @retval	!DIS_SUCCESS	DIS error code
+ *
+ */
+static int
+ss_read_hdr(struct pbs_statstream *ss)
+{
+	int sd = ss->svrs[ss->cur].sd;
+	struct batch_reply hdr;
+	int rc;
+	char *txt;
+	size_t txtlen;
+
+	if ((rc = decode_DIS_replyHdr(sd, &hdr)) != DIS_SUCCESS)
+		return rc;
+	ss->is_part = hdr.brp_is_part;
+
+	if (hdr.brp_code != PBSE_NONE)
+		ss->code = hdr.brp_code;
+	if (set_conn_errno(sd, hdr.brp_code) != 0)
+		return DIS_NOMALLOC;
+
+	ss->nleft = 0;
+	switch (hdr.brp_choice) {
+		case BATCH_REPLY_CHOICE_Status:
+			ss->nleft = disrui(sd, &rc);
+			break;
+
+		case BATCH_REPLY_CHOICE_Text:
+			ss->is_part = 0;
+			if ((txt = disrcs(sd, &txtlen, &rc)) != NULL) {
+				if (set_conn_errtxt(sd, txt) != 0)
+					rc = DIS_NOMALLOC;
+				free(txt);
+			}
+			break;
+
+		case BATCH_REPLY_CHOICE_NULL:
+			ss->is_part = 0;
+			break;
+
+		default:
+			rc = DIS_PROTO;
+	}
+	return rc;
+}
+
+/**
+ * @brief
+ *	Move the stream to its next status object.
+ *
+ * @par MT-safe: No, the caller holds the connection lock.
+ *
+ * @param[in] ss - the stream
+ *
+ * @return	int
+ * @retval	1	ss->bs holds the next object
+ * @retval	0	no object is left
+ * @retval	-1	error, the stream is marked failed
+ *
+ */
+static int
+ss_advance(struct pbs_statstream *ss)
+{
+	int rc = DIS_SUCCESS;
+	int i;
+
+	while (!ss->failed) {
+		if (ss->nleft > 0) {
+			ss->nleft--;
+			ss_reset(ss);
+			if ((rc = decode_DIS_status_obj(ss->svrs[ss->cur].sd, &ss->bs, &ss->da)) != DIS_SUCCESS)
+				break;
+			return 1;
+		}
+		if (ss->cur >= 0) {
+			if (ss->is_part) {
+				if ((rc = ss_read_hdr(ss)) != DIS_SUCCESS)
+					break;
+				continue;
+			}
+			dis_reset_buf(ss->svrs[ss->cur].sd, DIS_READ_BUF);
+			ss->pending[ss->cur] = 0;
+			ss->cur = -1;
+		}
+		for (i = 0; i < ss->nsvrs && !ss->pending[i]; i++)
+			;
+		if (i == ss->nsvrs)
+			return 0;
+		ss->cur = i;
+		if (set_conn_errtxt(ss->svrs[i].sd, NULL) != 0) {
+			rc = DIS_NOMALLOC;
+			break;
+		}
+		if ((rc = ss_read_hdr(ss)) != DIS_SUCCESS)
+			break;
+	}
+
+	if (!ss->failed) {
+		int sd = ss->svrs[ss->cur].sd;
+
+		ss->failed = 1;
+		ss->code = PBSE_PROTOCOL;
+		(void) set_conn_errno(sd, PBSE_PROTOCOL);
+		(void) set_conn_errtxt(sd, dis_emsg[rc]);
+		dis_reset_buf(sd, DIS_READ_BUF);
+	}
+	return -1;
+}
+
+/**
+ * @brief
+ *	Run ss_advance() up to max times with the connection locked.
+ *
+ * @param[in] ss - the stream
+ * @param[in] max - number of objects wanted
+ * @param[in] keep - if set, copies of the objects are returned
+ *
+ * @return	struct batch_status *
+ * @retval	list of copied objects, or &ss->bs if !keep	object(s) read
+ * @retval	NULL	end of the reply or error, see pbs_errno
+ *
+ */
+static struct batch_status *
+ss_read(struct pbs_statstream *ss, int max, int keep)
+{
+	struct batch_status *head = NULL;
+	struct batch_status **tail = &head;
+	struct batch_status *bs;
+	time_t old_timeout;
+	int n;
+	int rc = 0;
+
+	if (pbs_client_thread_lock_connection(ss->c) != 0)
+		return NULL;
+
+	DIS_tcp_funcs();
+	old_timeout = pbs_tcp_timeout;
+	if (pbs_tcp_timeout < PBS_DIS_TCP_TIMEOUT_LONG)
+		pbs_tcp_timeout = PBS_DIS_TCP_TIMEOUT_LONG;
+
+	for (n = 0; max <= 0 || n < max; n++) {
+		if ((rc = ss_advance(ss)) != 1)
+			break;
+		if (!keep) {
+			head = &ss->bs;
+			break;
+		}
+		if ((bs = calloc(1, sizeof(struct batch_status))) == NULL ||
+			(bs->name = strdup(ss->bs.name)) == NULL) {
+			free(bs);
+			rc = -1;
+			break;
+		}
+		bs->attribs = dup_attrl_list(ss->bs.attribs);
+		*tail = bs;
+		tail = &bs->next;
+		if (ss->bs.attribs != NULL && bs->attribs == NULL) {
+			rc = -1;
+			break;
+		}
+	}
+	pbs_tcp_timeout = old_timeout;
+
+	if (rc == -1) {
+		if (keep)
+			pbs_statfree(head);
+		head = NULL;
+		pbs_errno = ss->failed ? ss->code : PBSE_SYSTEM;
+	} else if (head == NULL)
+		pbs_errno = ss->code;
+
+	if (pbs_client_thread_unlock_connection(ss->c) != 0)
+		return NULL;
+	return head;
+}
+
+/**
+ * @brief
+ *	Send a job status request to the servers of connection c and set up
+ *	a stream to read the reply.  Mirrors the sending half of
+ *	PBSD_status_aggregate().
+ *
+ * @param[in] c - communication handle
+ * @param[in] cmd - PBS_BATCH_StatusJob or PBS_BATCH_SelStat
+ * @param[in] id - job id, NULL for all jobs
+ * @param[in] attrib - attrl to status or attropl to select on
+ * @param[in] rattrib - attributes to return for a select
+ * @param[in] extend - extend string for req
+ *
+ * @return	struct pbs_statstream *
+ * @retval	the stream	success
+ * @retval	NULL	error, see pbs_errno
+ *
+ */
+static struct pbs_statstream *
+ss_open(int c, int cmd, char *id, void *attrib, struct attrl *rattrib, char *extend)
+{
+	struct pbs_statstream *ss;
+	svr_conn_t *svr_connections = get_conn_svr_instances(c);
+	int num_cfg_svrs = get_num_servers();
+	char server_out[PBS_MAXSERVERNAME + 1];
+	char server_name[PBS_MAXSERVERNAME + 1];
+	char job_id_out[PBS_MAXCLTJOBID];
+	uint server_port;
+	int single_itr = 0;
+	int start = 0;
+	int nsent = 0;
+	int rc = 0;
+	int i;
+	int ct;
+
+	if (!svr_connections)
+		return NULL;
+
+	if (pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+
+	if (pbs_verify_attributes(random_srv_conn(svr_connections), cmd, MGR_OBJ_JOB, MGR_CMD_NONE, (struct attropl *) attrib) != 0)
+		return NULL;
+
+	if ((ss = calloc(1, sizeof(struct pbs_statstream))) == NULL ||
+		(ss->pending = calloc(num_cfg_svrs, sizeof(int))) == NULL) {
+		free(ss);
+		pbs_errno = PBSE_SYSTEM;
+		return NULL;
+	}
+	ss->c = c;
+	ss->svrs = svr_connections;
+	ss->nsvrs = num_cfg_svrs;
+	ss->cur = -1;
+	ss->da.da_attrl = ss_attrl;
+	ss->da.da_str = ss_str;
+	ss->da.da_ctx = ss;
+
+	if (id != NULL && get_server(id, job_id_out, server_out) == 0) {
+		if (PBS_get_server(server_out, server_name, &server_port)) {
+			single_itr = 1;
+			for (i = 0; i < num_cfg_svrs; i++) {
+				if (!strcmp(server_name, pbs_conf.psi[i].name) && (server_port == pbs_conf.psi[i].port)) {
+					start = i;
+					break;
+				}
+			}
+		}
+	}
+
+	if (pbs_client_thread_lock_connection(c) != 0) {
+		free(ss->pending);
+		free(ss);
+		return NULL;
+	}
+
+	for (i = start, ct = 0; ct < num_cfg_svrs; i = (i + 1) % num_cfg_svrs, ct++) {
+		if (svr_connections[i].state != SVR_CONN_STATE_UP) {
+			rc = PBSE_NOSERVER;
+			continue;
+		}
+
+		if (cmd == PBS_BATCH_SelStat)
+			rc = PBSD_select_put(svr_connections[i].sd, PBS_BATCH_SelStat, (struct attropl *) attrib, rattrib, extend);
+		else
+			rc = PBSD_status_put(svr_connections[i].sd, cmd, id ? id : "", (struct attrl *) attrib, extend, PROT_TCP, NULL);
+
+		if (rc == 0) {
+			ss->pending[i] = 1;
+			nsent++;
+			if (single_itr)
+				break;
+		}
+	}
+
+	if (pbs_client_thread_unlock_connection(c) != 0 || nsent == 0) {
+		if (rc)
+			pbs_errno = rc;
+		free(ss->pending);
+		free(ss);
+		return NULL;
+	}
+
+	if (rc)
+		ss->code = rc;
+	return ss;
+}
+
+/**
+ * @brief
+ *	-Open a stream over the status of a job, or of all jobs.
+ *
+ * @param[in] c - communication handle
+ * @param[in] id - job id, NULL or "" for all jobs
+ * @param[in] attrib - pointer to attribute list
+ * @param[in] extend - extend string for req
+ *
+ * @return	struct pbs_statstream *
+ * @retval	the stream	success
+ * @retval	NULL	error, see pbs_errno
+ *
+ */
+struct pbs_statstream *
+__pbs_statjob_stream(int c, char *id, struct attrl *attrib, char *extend)
+{
+	return ss_open(c, PBS_BATCH_StatusJob, (id && *id) ? id : NULL, attrib, NULL, extend);
+}
+
+/**
+ * @brief
+ *	-Open a stream over the status of the jobs matching a selection.
+ *
+ * @param[in] c - communication handle
+ * @param[in] attrib - selection criteria
+ * @param[in] rattrib - attributes to return
+ * @param[in] extend - extend string for req
+ *
+ * @return	struct pbs_statstream *
+ * @retval	the stream	success
+ * @retval	NULL	error, see pbs_errno
+ *
+ */
+struct pbs_statstream *
+__pbs_selstat_stream(int c, struct attropl *attrib, struct attrl *rattrib, char *extend)
+{
+	return ss_open(c, PBS_BATCH_SelStat, NULL, attrib, rattrib, extend);
+}
+
+/**
+ * @brief
+ *	-Return the next object of a status stream.
+ *
+ *	The object and its attributes live in the stream; they stay valid
+ *	until the next call on the stream and must not be freed.
+ *
+ * @param[in] ss - the stream
+ *
+ * @return	struct batch_status *
+ * @retval	the next object	success
+ * @retval	NULL	end of the reply (pbs_errno is the last error code
+ *			the servers returned, if any) or error
+ *
+ */
+struct batch_status *
+__pbs_statstream_next(struct pbs_statstream *ss)
+{
+	if (ss == NULL) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+	return ss_read(ss, 1, 0);
+}
+
+/**
+ * @brief
+ *	-Return up to max further objects of a status stream as a list the
+ *	caller owns and frees with pbs_statfree().
+ *
+ * @param[in] ss - the stream
+ * @param[in] max - maximum number of objects, <= 0 for the rest
+ *
+ * @return	struct batch_status *
+ * @retval	list of objects	success
+ * @retval	NULL	end of the reply or error, see pbs_statstream_next()
+ *
+ */
+struct batch_status *
+__pbs_statstream_nextn(struct pbs_statstream *ss, int max)
+{
+	if (ss == NULL) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+	return ss_read(ss, max, 1);
+}
+
+/**
+ * @brief
+ *	-Close a status stream, discarding whatever is left of the reply.
+ *
+ * @param[in] ss - the stream
+ *
+ * @return	int
+ * @retval	0	every server replied without error
+ * @retval	!0	the last error code returned, or PBSE_PROTOCOL
+ *
+ */
+int
+__pbs_statstream_close(struct pbs_statstream *ss)
+{
+	struct ss_blk *blk;
+	int rc;
+
+	if (ss == NULL)
+		return (pbs_errno = PBSE_IVALREQ);
+
+	if (!ss->failed && pbs_client_thread_lock_connection(ss->c) == 0) {
+		time_t old_timeout;
+
+		DIS_tcp_funcs();
+		old_timeout = pbs_tcp_timeout;
+		if (pbs_tcp_timeout < PBS_DIS_TCP_TIMEOUT_LONG)
+			pbs_tcp_timeout = PBS_DIS_TCP_TIMEOUT_LONG;
+		while (ss_advance(ss) == 1)
+			;
+		pbs_tcp_timeout = old_timeout;
+		(void) pbs_client_thread_unlock_connection(ss->c);
+	}
+
+	rc = ss->code;
+	free(ss->pending);
+	while ((blk = ss->blks) != NULL) {
+		ss->blks = blk->next;
+		free(blk);
+	}
+	free(ss);
+	return (pbs_errno = rc);
+}
@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbsD_submitjoblist.c
+ * @brief
+ * Send a list of jobs to the server in a single Submit Job List request.
+ *
+ * Each distinct job script is carried only once in the request; jobs that
+ * use the same script refer to it by index.  The server queues and commits
+ * every job of the list in one pass and replies with a status per job.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "libpbs.h"
+#include "pbs_ecl.h"
+#include "pbs_idx.h"
+#include "dis.h"
+#include "net_connect.h"
+#include "tpp.h"
+
+#define SCRIPT_NONE	-1	/* job has no script */
+#define SCRIPT_REJECT	-2	/* job was rejected before sending */
+
+
+/**
+ * @brief
+ *	Read a whole job script into memory.
+ *
+ * @param[in]  path - path of the script file
+ * @param[out] len  - number of bytes read
+ *
+ * @return	char *
+ * @retval	malloc-ed, null terminated script	success
+ * @retval	NULL	error
+ *
+ */
+static char *
+read_script(char *path, size_t *len)
+{
+	int fd;
+	struct stat sb;
+	char *buf;
+	ssize_t n;
+	size_t got = 0;
+
+	if ((fd = open(path, O_RDONLY, 0)) < 0)
+		return NULL;
+	if ((fstat(fd, &sb) != 0) || ((buf = malloc(sb.st_size + 1)) == NULL)) {
+		close(fd);
+		return NULL;
+	}
+	while (got < (size_t) sb.st_size) {
+		n = read(fd, buf + got, sb.st_size - got);
+		if (n <= 0)
+			break;
+		got += n;
+	}
+	close(fd);
+	if (got != (size_t) sb.st_size) {
+		free(buf);
+		return NULL;
+	}
+	buf[got] = '\0';
+	*len = got;
+	return buf;
+}
+
+/**
+ * @brief
+ *	Fill in the status of a job rejected before it was sent.
+ *
+ * @param[in] psub - status of the job
+ * @param[in] code - error code
+ * @param[in] text - error text, may be NULL
+ *
+ */
+static void
+reject_local(struct batch_submit_status *psub, int code, char *text)
+{
+	psub->code = code;
+	if (text == NULL)
+		text = pbse_to_txt(code);
+	if (text != NULL)
+		psub->text = strdup(text);
+}
+
+/**
+ * @brief
+ *	Submit a list of jobs in one request.
+ *
+ * @par Functionality:
+ *	Attributes of each job are verified and its script is read here.
+ *	A job that fails either step is not sent and gets its error in the
+ *	returned list.  Identical scripts are sent once.  The returned list
+ *	has one entry per job, in the order of the jobs array.
+ *
+ * @param[in] c - communication handle
+ * @param[in] jobs - array of jobs to submit
+ * @param[in] njobs - number of entries in jobs
+ * @param[in] extend - extend string for the request
+ *
+ * @return	struct batch_submit_status *
+ * @retval	list of per job results, free with pbs_submitstatfree()
+ * @retval	NULL	the request as a whole failed, see pbs_errno
+ *
+ */
+struct batch_submit_status *
+__pbs_submitjoblist(int c, struct batch_submit_job *jobs, int njobs, char *extend)
+{
+	struct batch_submit_status **res = NULL;
+	struct batch_submit_status *head = NULL;
+	struct batch_submit_status *psub;
+	struct batch_submit_job *sendjobs = NULL;
+	struct batch_reply *reply;
+	struct attropl *pal;
+	struct ecl_attribute_errors *err_list;
+	void *path_idx = NULL;
+	void *text_idx = NULL;
+	void *data;
+	char *key;
+	char **scripts = NULL;
+	size_t *scriptsz = NULL;
+	int *jobscr = NULL;
+	int *sendscr = NULL;
+	int nscripts = 0;
+	int nsend = 0;
+	int i;
+	svr_conn_t *svr_connections = get_conn_svr_instances(c);
+	c = random_srv_conn(svr_connections);
+
+	if ((jobs == NULL) || (njobs <= 0) || (njobs > PBS_MAX_SUBMITJOBLIST)) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+
+	/* initialize the thread context data, if not already initialized */
+	if ((pbs_errno = pbs_client_thread_init_thread_context()) != 0)
+		return NULL;
+
+	res = calloc(njobs, sizeof(struct batch_submit_status *));
+	jobscr = calloc(njobs, sizeof(int));
+	sendscr = calloc(njobs, sizeof(int));
+	sendjobs = calloc(njobs, sizeof(struct batch_submit_job));
+	scripts = calloc(njobs, sizeof(char *));
+	scriptsz = calloc(njobs, sizeof(size_t));
+	path_idx = pbs_idx_create(PBS_IDX_HASH, 0);
+	text_idx = pbs_idx_create(PBS_IDX_HASH, 0);
+	if (!res || !jobscr || !sendscr || !sendjobs || !scripts || !scriptsz || !path_idx || !text_idx) {
+		pbs_errno = PBSE_SYSTEM;
+		goto done;
+	}
+
+	for (i = 0; i < njobs; i++) {
+		if ((res[i] = calloc(1, sizeof(struct batch_submit_status))) == NULL) {
+			pbs_errno = PBSE_SYSTEM;
+			goto done;
+		}
+		jobscr[i] = SCRIPT_NONE;
+
+		/* first verify the attributes, if verification is enabled */
+		if (pbs_verify_attributes(c, PBS_BATCH_QueueJob, MGR_OBJ_JOB, MGR_CMD_NONE, jobs[i].attrib) != 0) {
+			err_list = pbs_get_attributes_in_error(c);
+			reject_local(res[i], pbs_errno,
+				(err_list && err_list->ecl_numerrors > 0) ? err_list->ecl_attrerr[0].ecl_errmsg : NULL);
+			jobscr[i] = SCRIPT_REJECT;
+			continue;
+		}
+		for (pal = jobs[i].attrib; pal; pal = pal->next)
+			pal->op = SET;		/* force operator to SET */
+
+		if ((jobs[i].script == NULL) || (*jobs[i].script == '\0'))
+			continue;
+
+		/* same file as an earlier job, reuse its script */
+		key = jobs[i].script;
+		data = NULL;
+		if (pbs_idx_find(path_idx, (void **) &key, &data, NULL) == PBS_IDX_RET_OK) {
+			jobscr[i] = *(int *) data;
+			continue;
+		}
+
+		scripts[nscripts] = read_script(jobs[i].script, &scriptsz[nscripts]);
+		if (scripts[nscripts] == NULL) {
+			reject_local(res[i], PBSE_BADSCRIPT, "cannot access script file");
+			jobscr[i] = SCRIPT_REJECT;
+			continue;
+		}
+
+		/*
+		 * same contents as an earlier script; a script with an
+		 * embedded null cannot be keyed by its text, always send it
+		 */
+		key = scripts[nscripts];
+		data = NULL;
+		if ((strlen(key) == scriptsz[nscripts]) &&
+			(pbs_idx_find(text_idx, (void **) &key, &data, NULL) == PBS_IDX_RET_OK)) {
+			free(scripts[nscripts]);
+			scripts[nscripts] = NULL;
+			jobscr[i] = *(int *) data;
+		} else {
+			jobscr[i] = nscripts++;
+			if (strlen(scripts[jobscr[i]]) == scriptsz[jobscr[i]])
+				(void) pbs_idx_insert(text_idx, scripts[jobscr[i]], &jobscr[i]);
+		}
+		(void) pbs_idx_insert(path_idx, jobs[i].script, &jobscr[i]);
+	}
+
+	for (i = 0; i < njobs; i++) {
+		if (jobscr[i] == SCRIPT_REJECT)
+			continue;
+		sendjobs[nsend] = jobs[i];
+		sendscr[nsend++] = jobscr[i];
+	}
+
+	if (nsend > 0) {
+		/* lock pthread mutex here for this connection */
+		/* blocking call, waits for mutex release */
+		if (pbs_client_thread_lock_connection(c) != 0)
+			goto done;
+
+		if (PBSD_submitjoblist_put(c, scripts, scriptsz, nscripts, sendjobs, sendscr, nsend, extend) != 0) {
+			pbs_client_thread_unlock_connection(c);
+			goto done;
+		}
+
+		/* read reply from stream into presentation element */
+		reply = PBSD_rdrpy(c);
+		if (reply == NULL) {
+			if (pbs_errno == PBSE_NONE)
+				pbs_errno = PBSE_PROTOCOL;
+		} else if (reply->brp_choice == BATCH_REPLY_CHOICE_SubmitList) {
+			/* hand the server's statuses to the jobs that were sent */
+			psub = reply->brp_un.brp_substatc;
+			for (i = 0; i < njobs; i++) {
+				if (jobscr[i] == SCRIPT_REJECT)
+					continue;
+				if (psub == NULL) {
+					reject_local(res[i], PBSE_PROTOCOL, NULL);
+					continue;
+				}
+				res[i]->jobid = psub->jobid;
+				res[i]->code = psub->code;
+				res[i]->text = psub->text;
+				psub->jobid = NULL;
+				psub->text = NULL;
+				psub = psub->next;
+			}
+			pbs_errno = PBSE_NONE;
+		} else if (reply->brp_code == 0) {
+			pbs_errno = PBSE_PROTOCOL;
+		}
+		PBSD_FreeReply(reply);
+
+		/* unlock the thread lock and update the thread context data */
+		if (pbs_client_thread_unlock_connection(c) != 0)
+			goto done;
+		if (pbs_errno != PBSE_NONE)
+			goto done;
+	} else
+		pbs_errno = PBSE_NONE;
+
+	/* link the statuses in the order of the jobs array */
+	for (i = njobs - 1; i >= 0; i--) {
+		res[i]->next = head;
+		head = res[i];
+		res[i] = NULL;
+	}
+
+done:
+	if (res != NULL) {
+		for (i = 0; i < njobs; i++) {
+			if (res[i] != NULL)
+				pbs_submitstatfree(res[i]);
+		}
+	}
+	for (i = 0; i < nscripts; i++)
+		free(scripts[i]);
+	pbs_idx_destroy(path_idx);
+	pbs_idx_destroy(text_idx);
+	free(res);
+	free(jobscr);
+	free(sendscr);
+	free(sendjobs);
+	free(scripts);
+	free(scriptsz);
+	return head;
+}
+
+/**
+ * @brief
+ *	-encode and send a Submit Job List Batch Request
+ *
+ * @param[in] c - socket descriptor
+ * @param[in] scripts - distinct job scripts
+ * @param[in] scriptsz - size of each script
+ * @param[in] nscripts - number of scripts
+ * @param[in] jobs - jobs to submit
+ * @param[in] jobscr - index into scripts of each job, -1 for none
+ * @param[in] njobs - number of jobs
+ * @param[in] extend - extend string for the request
+ *
+ * @return      int
+ * @retval      0	success
+ * @retval      !0	error, pbs_errno set
+ *
+ */
+int
+PBSD_submitjoblist_put(int c, char **scripts, size_t *scriptsz, int nscripts,
+	struct batch_submit_job *jobs, int *jobscr, int njobs, char *extend)
+{
+	int rc;
+
+	DIS_tcp_funcs();
+
+	if ((rc = encode_DIS_ReqHdr(c, PBS_BATCH_SubmitJobList, pbs_current_user)) ||
+		(rc = encode_DIS_SubmitJobList(c, scripts, scriptsz, nscripts, jobs, jobscr, njobs)) ||
+		(rc = encode_DIS_ReqExtend(c, extend))) {
+		if (set_conn_errtxt(c, dis_emsg[rc]) != 0)
+			return (pbs_errno = PBSE_SYSTEM);
+		return (pbs_errno = PBSE_PROTOCOL);
+	}
+
+	if (dis_flush(c))
+		return (pbs_errno = PBSE_PROTOCOL);
+	return 0;
+}
+
+/**
+ * @brief
+ *	-The function that deallocates a "batch_submit_status" list
+ *
+ * @param[in] bssp - pointer to the first status of the list
+ *
+ * @return	Void
+ *
+ */
+void
+__pbs_submitstatfree(struct batch_submit_status *bssp)
+{
+	struct batch_submit_status *bssnxt;
+
+	while (bssp != NULL) {
+		free(bssp->jobid);
+		free(bssp->text);
+		bssnxt = bssp->next;
+		free(bssp);
+		bssp = bssnxt;
+	}
+}
@@ -124,6 +124,10 @@ struct pbs_config pbs_conf = {
 	1, 					/* use compression by default with TCP */
 	1,					/* use mcast by default with TCP */
 	0,					/* force fault tolerant comm disabled by default */
+	0,					/* compact mcast member lists disabled by default */
+	NULL,					/* compression algorithm, zlib if not set */
+	8192,					/* minimum message size to compress */
+	0,					/* preset compression dictionary disabled by default */
 	NULL,					/* default leaf name */
 	NULL,					/* for leaf, default communication routers list */
 	NULL,					/* default router name */
@@ -133,7 +137,13 @@ struct pbs_config pbs_conf = {
 	NULL,					/* mom short name override */
 	NULL,					/* pbs_lr_save_path */
 	0,					/* high resolution timestamp logging */
+	0,					/* asynchronous logging disabled */
 	0,					/* number of scheduler threads */
+	2,					/* binary DIS (version 2) allowed */
+	0,					/* no per instance status timeout */
+	0,					/* qstat status cache disabled */
+	0,					/* accounting records written synchronously */
+	0,					/* binary accounting sidecar disabled */
 	NULL,					/* default scheduler user */
 	{'\0'}					/* current running user */
 #ifdef WIN32
@@ -529,6 +539,18 @@ __pbs_loadconf(int reload)
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_use_compression = ((uvalue > 0) ? 1 : 0);
 			}
+			else if (!strcmp(conf_name, PBS_CONF_COMPRESSION_ALGO)) {
+				free(pbs_conf.pbs_compression_algo);
+				pbs_conf.pbs_compression_algo = strdup(conf_value);
+			}
+			else if (!strcmp(conf_name, PBS_CONF_COMPRESSION_MIN_SIZE)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_compression_min_size = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_COMPRESSION_DICT)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_compression_dict = ((uvalue > 0) ? 1 : 0);
+			}
 			else if (!strcmp(conf_name, PBS_CONF_USE_MCAST)) {
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_use_mcast = ((uvalue > 0) ? 1 : 0);
@@ -537,6 +559,10 @@ __pbs_loadconf(int reload)
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_use_ft = ((uvalue > 0) ? 1 : 0);
 			}
+			else if (!strcmp(conf_name, PBS_CONF_TPP_COMPACT_MCAST)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_tpp_compact_mcast = ((uvalue > 0) ? 1 : 0);
+			}
 			else if (!strcmp(conf_name, PBS_CONF_LEAF_NAME)) {
 				if (pbs_conf.pbs_leaf_name)
 					free(pbs_conf.pbs_leaf_name);
@@ -657,10 +683,34 @@ __pbs_loadconf(int reload)
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_log_highres_timestamp = ((uvalue > 0) ? 1 : 0);
 			}
+			else if (!strcmp(conf_name, PBS_CONF_LOG_ASYNC)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_log_async = uvalue;
+			}
 			else if (!strcmp(conf_name, PBS_CONF_SCHED_THREADS)) {
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_sched_threads = uvalue;
 			}
+			else if (!strcmp(conf_name, PBS_CONF_DIS_VERSION)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_dis_version = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_STAT_INSTANCE_TIMEOUT)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_stat_instance_timeout = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_QSTAT_CACHE_TTL)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_qstat_cache_ttl = uvalue;
+			}
+			else if (!strcmp(conf_name, PBS_CONF_ACCT_ASYNC)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_acct_async = ((uvalue > 0) ? 1 : 0);
+			}
+			else if (!strcmp(conf_name, PBS_CONF_ACCT_BINARY)) {
+				if (sscanf(conf_value, "%u", &uvalue) == 1)
+					pbs_conf.pbs_acct_binary = ((uvalue > 0) ? 1 : 0);
+			}
 #ifdef WIN32
 			else if (!strcmp(conf_name, PBS_CONF_REMOTE_VIEWER)) {
 				free(pbs_conf.pbs_conf_remote_viewer);
@@ -831,6 +881,18 @@ __pbs_loadconf(int reload)
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_use_compression = ((uvalue > 0) ? 1 : 0);
 	}
+	if ((gvalue = getenv(PBS_CONF_COMPRESSION_ALGO)) != NULL) {
+		free(pbs_conf.pbs_compression_algo);
+		pbs_conf.pbs_compression_algo = strdup(gvalue);
+	}
+	if ((gvalue = getenv(PBS_CONF_COMPRESSION_MIN_SIZE)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_compression_min_size = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_COMPRESSION_DICT)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_compression_dict = ((uvalue > 0) ? 1 : 0);
+	}
 	if ((gvalue = getenv(PBS_CONF_USE_MCAST)) != NULL) {
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_use_mcast = ((uvalue > 0) ? 1 : 0);
@@ -839,6 +901,10 @@ __pbs_loadconf(int reload)
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_use_ft = ((uvalue > 0) ? 1 : 0);
 	}
+	if ((gvalue = getenv(PBS_CONF_TPP_COMPACT_MCAST)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_tpp_compact_mcast = ((uvalue > 0) ? 1 : 0);
+	}
 	if ((gvalue = getenv(PBS_CONF_LEAF_NAME)) != NULL) {
 		if (pbs_conf.pbs_leaf_name)
 			free(pbs_conf.pbs_leaf_name);
@@ -909,10 +975,34 @@ __pbs_loadconf(int reload)
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_log_highres_timestamp = ((uvalue > 0) ? 1 : 0);
 	}
+	if ((gvalue = getenv(PBS_CONF_LOG_ASYNC)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_log_async = uvalue;
+	}
 	if ((gvalue = getenv(PBS_CONF_SCHED_THREADS)) != NULL) {
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_sched_threads = uvalue;
 	}
+	if ((gvalue = getenv(PBS_CONF_DIS_VERSION)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_dis_version = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_STAT_INSTANCE_TIMEOUT)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_stat_instance_timeout = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_QSTAT_CACHE_TTL)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_qstat_cache_ttl = uvalue;
+	}
+	if ((gvalue = getenv(PBS_CONF_ACCT_ASYNC)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_acct_async = ((uvalue > 0) ? 1 : 0);
+	}
+	if ((gvalue = getenv(PBS_CONF_ACCT_BINARY)) != NULL) {
+		if (sscanf(gvalue, "%u", &uvalue) == 1)
+			pbs_conf.pbs_acct_binary = ((uvalue > 0) ? 1 : 0);
+	}
 
 	if ((gvalue = getenv(PBS_CONF_DAEMON_SERVICE_USER)) != NULL) {
 		free(pbs_conf.pbs_daemon_service_user);
@@ -106,6 +106,7 @@ tcp_recv(int fd, void *data, int len)
 	int torecv = len;
 	char *pb = (char *)data;
 	int amt = 0;
+	pbs_tcp_chan_t *chan;
 #ifdef WIN32
 	fd_set readset;
 	struct timeval timeout;
@@ -124,6 +125,19 @@ tcp_recv(int fd, void *data, int len)
 	pollfds[0].revents = 0;
 #endif
 
+	/* hand out what DIS_tcp_prefetch() already read from the socket */
+	chan = get_conn_chan(fd);
+	if ((chan != NULL) && (chan->pendbuf.tdis_len > 0)) {
+		amt = (chan->pendbuf.tdis_len < torecv) ? chan->pendbuf.tdis_len : torecv;
+		memcpy(pb, chan->pendbuf.tdis_pos, amt);
+		chan->pendbuf.tdis_pos += amt;
+		chan->pendbuf.tdis_len -= amt;
+		if (chan->pendbuf.tdis_len == 0)
+			dis_clear_buf(&chan->pendbuf);
+		torecv -= amt;
+		pb += amt;
+	}
+
 	while (torecv > 0) {
 		/*
 		 * we don't want to be locked out by an attack on the port to
@@ -266,6 +280,108 @@ tcp_send(int fd, void *data, int len)
 	return len;
 }
 
+/**
+ * @brief
+ *	Read whatever the socket has available, without blocking, into the
+ *	read-ahead buffer of the channel until it holds a whole packet.
+ *
+ * @par
+ *	A daemon calls this before handing a connection to its request
+ *	reader, so that a client which sends a request slowly or in pieces
+ *	never makes the daemon wait in tcp_recv().  Buffered bytes are
+ *	consumed by tcp_recv() before it reads the socket again.
+ *
+ * @param[in] fd - socket descriptor
+ *
+ * @return	int
+ * @retval	1	a whole packet is buffered, or the data is not a packet
+ *			and should be left to the request reader to reject
+ * @retval	0	more data is needed, the socket has nothing more for now
+ * @retval	-1	read error
+ * @retval	-2	EOF (stream closed)
+ */
+int
+DIS_tcp_prefetch(int fd)
+{
+#ifdef WIN32
+	return 1;
+#else
+	pbs_tcp_chan_t *chan = tcp_get_chan(fd);
+	pbs_dis_buf_t *tp;
+	struct pollfd pollfds[1];
+	size_t newsize;
+	char *tmpcp;
+	int i;
+
+	if (chan == NULL)
+		return -1;
+	tp = &chan->pendbuf;
+
+	for (;;) {
+		if (tp->tdis_len > 0 && dis_pkt_complete(tp->tdis_pos, tp->tdis_len) != 0)
+			return 1;
+
+		/* move unread bytes to the front and make room to read more */
+		if (tp->tdis_pos != tp->tdis_data) {
+			memmove(tp->tdis_data, tp->tdis_pos, tp->tdis_len);
+			tp->tdis_pos = tp->tdis_data;
+		}
+		if (tp->tdis_bufsize - tp->tdis_len < PBS_DIS_BUFSZ / 2) {
+			newsize = tp->tdis_bufsize ? tp->tdis_bufsize * 2 : PBS_DIS_BUFSZ;
+			if ((tmpcp = realloc(tp->tdis_data, newsize)) == NULL)
+				return -1;
+			tp->tdis_data = tmpcp;
+			tp->tdis_pos = tmpcp;
+			tp->tdis_bufsize = newsize;
+		}
+
+		pollfds[0].fd = fd;
+		pollfds[0].events = POLLIN;
+		pollfds[0].revents = 0;
+		do {
+			i = poll(pollfds, 1, 0);
+		} while (i == -1 && errno == EINTR);
+		if (i < 0)
+			return -1;
+		if (i == 0)
+			return 0;
+
+		i = CS_read(fd, tp->tdis_data + tp->tdis_len, tp->tdis_bufsize - tp->tdis_len);
+		if (i == 0)
+			return -2;
+		if (i < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return 0;
+			return -1;
+		}
+		tp->tdis_len += i;
+	}
+#endif
+}
+
+/**
+ * @brief
+ *	Check, without any system call, whether the read-ahead buffer of a
+ *	channel already holds a whole packet.
+ *
+ * @param[in] fd - socket descriptor
+ *
+ * @return	int
+ * @retval	1	a whole packet is buffered
+ * @retval	0	otherwise
+ */
+int
+DIS_tcp_pending(int fd)
+{
+	pbs_tcp_chan_t *chan = get_conn_chan(fd);
+
+	if ((chan == NULL) || (chan->pendbuf.tdis_len == 0))
+		return 0;
+	return (dis_pkt_complete(chan->pendbuf.tdis_pos, chan->pendbuf.tdis_len) > 0);
+}
+
 /**
  * @brief
  *	sets tcp related functions.
@@ -52,6 +52,8 @@
  *	log_close()
  *	log_add_debug_info()
  *	log_add_if_info()
+ *	log_async_start()
+ *	log_async_flush()
  */
 
 
@@ -113,6 +115,53 @@ static volatile int  log_opened = 0;
 static int	     syslogopen = 0;
 #endif	/* SYSLOG */
 
+#ifndef WIN32
+/*
+ * Asynchronous logging (PBS_LOG_ASYNC in pbs.conf).
+ *
+ * log_record() formats the record into a slot of a bounded ring and
+ * returns; a writer thread copies batches of records into one buffer and
+ * writes and flushes the log file once per batch.  Producers claim slots
+ * with a compare-and-swap on log_async_head and publish them by setting
+ * the slot sequence, so they never take a lock.  Only one consumer (the
+ * writer thread, or log_async_flush()) drains at a time, under
+ * log_async_cons_mutex.  When the ring is full, producers wait for the
+ * writer, so memory stays bounded and no record is dropped.
+ */
+#define LOG_ASYNC_RECSIZE	(LOG_BUF_SIZE + 512)
+#define LOG_ASYNC_MIN_SLOTS	64
+#define LOG_ASYNC_MAX_SLOTS	65536
+#define LOG_ASYNC_BATCH		65536
+#define LOG_ASYNC_INTERVAL_MS	50
+#define LOG_ASYNC_FLUSH_TRIES	200
+
+struct log_async_slot {
+	volatile unsigned long	seq;	/* slot state, see log_async_put() */
+	int			yday;	/* day of year of the record */
+	int			len;
+	char			rec[LOG_ASYNC_RECSIZE];
+};
+
+static struct log_async_slot *log_async_ring = NULL;
+static unsigned long log_async_nslots = 0;
+static volatile unsigned long log_async_head = 0;	/* next slot to claim */
+static volatile unsigned long log_async_tail = 0;	/* next slot to write */
+static volatile int log_async_on = 0;
+static pthread_t log_async_tid;
+static pthread_mutex_t log_async_cons_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t log_async_wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_async_wake_cond = PTHREAD_COND_INITIALIZER;
+static char log_async_batch[LOG_ASYNC_BATCH];
+static __thread int log_async_writer = 0;	/* set in the writer thread */
+
+/* per thread cache of the formatted timestamp, redone once a second */
+static __thread struct {
+	time_t	sec;
+	int	yday;
+	char	str[24];
+} log_ts_cache;
+#endif	/* WIN32 */
+
 /*
  * the order of these names MUST match the defintions of
  * PBS_EVENTCLASS_* in log.h
@@ -382,6 +431,199 @@ void
 log_atfork_child()
 {
 	log_mutex_unlock();
+	/*
+	 * The writer thread does not exist in the child, and the records
+	 * still in the ring belong to the parent; the child logs synchronously.
+	 */
+	log_async_on = 0;
+}
+
+/**
+ * @brief
+ *	Return the "mm/dd/yyyy hh:mm:ss" timestamp for 'now', formatting it
+ *	only when the second changes.
+ *
+ * @param[in]	now	- current time
+ * @param[out]	yday	- day of the year of 'now'
+ *
+ * @return	char *	- the timestamp, valid until the next call in this thread
+ */
+static char *
+log_timestamp(time_t now, int *yday)
+{
+	struct tm ltm;
+
+	if (log_ts_cache.sec != now || log_ts_cache.str[0] == '\0') {
+		localtime_r(&now, &ltm);
+		snprintf(log_ts_cache.str, sizeof(log_ts_cache.str),
+			"%02d/%02d/%04d %02d:%02d:%02d",
+			ltm.tm_mon + 1, ltm.tm_mday, ltm.tm_year + 1900,
+			ltm.tm_hour, ltm.tm_min, ltm.tm_sec);
+		log_ts_cache.yday = ltm.tm_yday;
+		log_ts_cache.sec = now;
+	}
+	*yday = log_ts_cache.yday;
+	return log_ts_cache.str;
+}
+
+/**
+ * @brief
+ *	Write the records gathered in log_async_batch to the log file.
+ *	Called with the log mutex held.
+ *
+ * @param[in]	len	- number of bytes in log_async_batch
+ */
+static void
+log_async_write(size_t len)
+{
+	FILE *savlog;
+	int rc;
+
+	if (len == 0 || log_opened < 1)
+		return;
+
+	if (fwrite(log_async_batch, 1, len, logfile) != len || fflush(logfile) != 0) {
+		rc = errno;
+		clearerr(logfile);
+		savlog = logfile;
+		logfile = fopen("/dev/console", "w");
+		if (logfile != NULL) {
+			log_err(rc, "log_async_write", "PBS cannot write to its log");
+			fclose(logfile);
+		}
+		logfile = savlog;
+	}
+}
+
+/**
+ * @brief
+ *	Write out every published record in the ring.
+ *	The caller must hold log_async_cons_mutex.
+ */
+static void
+log_async_drain(void)
+{
+	struct log_async_slot *slot;
+	size_t len = 0;
+
+	if (log_mutex_lock() != 0)
+		return;
+
+	for (;;) {
+		slot = &log_async_ring[log_async_tail & (log_async_nslots - 1)];
+		if (slot->seq != log_async_tail + 1)
+			break;		/* empty, or not yet published */
+
+		/* Do we need to switch the log? */
+		if (log_auto_switch && (slot->yday != log_open_day)) {
+			log_async_write(len);
+			len = 0;
+			log_close(1);
+			log_open(NULL, log_directory);
+		}
+		if (len + slot->len > sizeof(log_async_batch)) {
+			log_async_write(len);
+			len = 0;
+		}
+		memcpy(log_async_batch + len, slot->rec, slot->len);
+		len += slot->len;
+
+		__sync_synchronize();
+		slot->seq = log_async_tail + log_async_nslots;	/* free for reuse */
+		log_async_tail++;
+	}
+	log_async_write(len);
+
+	log_mutex_unlock();
+}
+
+/**
+ * @brief
+ *	Main loop of the log writer thread.
+ */
+static void *
+log_async_main(void *arg)
+{
+	sigset_t block_mask;
+	struct timespec ts;
+
+	/* leave the daemon's signals to its other threads */
+	sigfillset(&block_mask);
+	pthread_sigmask(SIG_BLOCK, &block_mask, NULL);
+	log_async_writer = 1;
+
+	for (;;) {
+		pthread_mutex_lock(&log_async_wake_mutex);
+		if (log_async_head == log_async_tail) {
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_nsec += LOG_ASYNC_INTERVAL_MS * 1000000L;
+			if (ts.tv_nsec >= 1000000000L) {
+				ts.tv_sec++;
+				ts.tv_nsec -= 1000000000L;
+			}
+			pthread_cond_timedwait(&log_async_wake_cond, &log_async_wake_mutex, &ts);
+		}
+		pthread_mutex_unlock(&log_async_wake_mutex);
+
+		pthread_mutex_lock(&log_async_cons_mutex);
+		log_async_drain();
+		pthread_mutex_unlock(&log_async_cons_mutex);
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Format a record into the next free slot of the ring.  Waits for the
+ *	writer if the ring is full.
+ *
+ * @param[in]	ts	- formatted timestamp
+ * @param[in]	usec	- microseconds suffix, may be empty
+ * @param[in]	yday	- day of year of the record
+ * @param[in]	eventtype, objclass, objname, text - as for log_record()
+ */
+static void
+log_async_put(const char *ts, const char *usec, int yday, int eventtype,
+	int objclass, const char *objname, const char *text)
+{
+	struct log_async_slot *slot;
+	unsigned long pos;
+	long diff;
+	int len;
+
+	pos = log_async_head;
+	for (;;) {
+		slot = &log_async_ring[pos & (log_async_nslots - 1)];
+		diff = (long) (slot->seq - pos);
+		if (diff == 0) {
+			if (__sync_bool_compare_and_swap(&log_async_head, pos, pos + 1))
+				break;
+		} else if (diff < 0) {
+			/* ring is full, let the writer catch up */
+			pthread_cond_signal(&log_async_wake_cond);
+			sched_yield();
+		}
+		pos = log_async_head;
+	}
+
+	len = snprintf(slot->rec, LOG_ASYNC_RECSIZE, "%s%s;%04x;%s;%s;%s;%s\n",
+		ts, usec, eventtype & ~PBSEVENT_FORCE, msg_daemonname,
+		class_names[objclass], objname, text);
+	if (len < 0)
+		len = 0;
+	if (len >= LOG_ASYNC_RECSIZE) {
+		/* truncated, keep the record on one line */
+		len = LOG_ASYNC_RECSIZE - 1;
+		slot->rec[len - 1] = '\n';
+	}
+	slot->len = len;
+	slot->yday = yday;
+
+	__sync_synchronize();
+	slot->seq = pos + 1;	/* publish */
+
+	if (pos - log_async_tail >= log_async_nslots / 2)
+		pthread_cond_signal(&log_async_wake_cond);
 }
 #endif
 
@@ -945,14 +1187,16 @@ void
 log_record(int eventtype, int objclass, int sev, const char *objname, const char *text)
 {
 	time_t now = 0;
-	struct tm *ptm;
 	int    rc = 0;
 	FILE  *savlog;
 	char slogbuf[LOG_BUF_SIZE];
 	struct timeval tp;
 	char microsec_buf[8] = {0};
-#ifndef WIN32
-	struct tm ltm;
+#ifdef WIN32
+	struct tm *ptm;
+#else
+	char *tstamp;
+	int yday;
 	sigset_t block_mask;
 	sigset_t old_mask;
 
@@ -989,7 +1233,12 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 #ifdef WIN32
 	ptm = localtime(&now);
 #else
-	ptm = localtime_r(&now, &ltm);
+	tstamp = log_timestamp(now, &yday);
+
+	if (log_async_on && !log_async_writer && (locallog != 0 || syslogfac == 0)) {
+		log_async_put(tstamp, microsec_buf, yday, eventtype, objclass, objname, text);
+		goto sigunblock;
+	}
 #endif
 
 	/* lock the log mutex */
@@ -997,7 +1246,11 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 		goto sigunblock;
 
 	/* Do we need to switch the log? */
+#ifdef WIN32
 	if (log_auto_switch && (ptm->tm_yday != log_open_day)) {
+#else
+	if (log_auto_switch && (yday != log_open_day)) {
+#endif
 		log_close(1);
 		log_open(NULL, log_directory);
 	}
@@ -1014,12 +1267,19 @@ log_record(int eventtype, int objclass, int sev, const char *objname, const char
 	}
 
 	if (locallog != 0 || syslogfac == 0) {
+#ifdef WIN32
 		rc = fprintf(logfile,
 			     "%02d/%02d/%04d %02d:%02d:%02d%s;%04x;%s;%s;%s;%s\n",
 			     ptm->tm_mon + 1, ptm->tm_mday, ptm->tm_year + 1900,
 			     ptm->tm_hour, ptm->tm_min, ptm->tm_sec, microsec_buf,
 			     eventtype & ~PBSEVENT_FORCE, msg_daemonname,
 			     class_names[objclass], objname, text);
+#else
+		rc = fprintf(logfile, "%s%s;%04x;%s;%s;%s;%s\n",
+			     tstamp, microsec_buf,
+			     eventtype & ~PBSEVENT_FORCE, msg_daemonname,
+			     class_names[objclass], objname, text);
+#endif
 
 		(void)fflush(logfile);
 		if (rc < 0) {
@@ -1077,6 +1337,7 @@ log_close(int msg)
 			log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER,
 				LOG_INFO, "Log", "Log closed");
 		}
+		log_async_flush();	/* write out what is queued */
 		(void)fclose(logfile);
 		log_opened = 0;
 	}
@@ -1114,3 +1375,97 @@ log_level_2_etype(int level)
 
 	return etype;
 }
+
+/**
+ * @brief
+ *	Switch this process to asynchronous logging: records are queued in a
+ *	ring of 'nslots' entries and written by a background thread.
+ *
+ * @par
+ *	Must be called after the daemon has forked into the background, as
+ *	the writer thread does not survive fork(); children of the daemon
+ *	log synchronously.
+ *
+ * @param[in]	nslots	- number of records the ring holds (0 disables),
+ *			  rounded up to a power of two
+ *
+ * @return int
+ * @retval 0	- success, or asynchronous logging not requested
+ * @retval -1	- failure, logging stays synchronous
+ */
+int
+log_async_start(unsigned int nslots)
+{
+#ifdef WIN32
+	return (nslots == 0) ? 0 : -1;
+#else
+	unsigned long n;
+	unsigned long i;
+	pthread_attr_t attr;
+
+	if (nslots == 0 || log_async_on)
+		return 0;
+
+	for (n = LOG_ASYNC_MIN_SLOTS; n < nslots && n < LOG_ASYNC_MAX_SLOTS; n <<= 1)
+		;
+
+	if (log_async_ring == NULL) {
+		log_async_ring = malloc(n * sizeof(struct log_async_slot));
+		if (log_async_ring == NULL) {
+			log_err(errno, __func__, "could not allocate log ring");
+			return -1;
+		}
+		log_async_nslots = n;
+	}
+	for (i = 0; i < log_async_nslots; i++)
+		log_async_ring[i].seq = i;
+	log_async_head = 0;
+	log_async_tail = 0;
+
+	if (pthread_attr_init(&attr) != 0)
+		return -1;
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	if (pthread_create(&log_async_tid, &attr, log_async_main, NULL) != 0) {
+		pthread_attr_destroy(&attr);
+		log_err(errno, __func__, "could not start log writer thread");
+		return -1;
+	}
+	pthread_attr_destroy(&attr);
+
+	log_async_on = 1;
+	log_eventf(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER, LOG_INFO,
+		msg_daemonname, "Asynchronous logging enabled, %lu records", log_async_nslots);
+	return 0;
+#endif
+}
+
+/**
+ * @brief
+ *	Synchronously write out everything queued for the writer thread.
+ *	Called on shutdown (from log_close()) and on crash paths before the
+ *	process goes away.
+ *
+ * @par
+ *	If the writer is busy for too long, for example because it crashed
+ *	while holding the ring, gives up rather than hang the caller.
+ */
+void
+log_async_flush(void)
+{
+#ifndef WIN32
+	int i;
+	struct timespec ts = {0, 5000000L};
+
+	if (!log_async_on || log_async_writer)
+		return;
+
+	for (i = 0; i < LOG_ASYNC_FLUSH_TRIES; i++) {
+		if (pthread_mutex_trylock(&log_async_cons_mutex) == 0) {
+			log_async_drain();
+			pthread_mutex_unlock(&log_async_cons_mutex);
+			return;
+		}
+		nanosleep(&ts, NULL);
+	}
+#endif
+}
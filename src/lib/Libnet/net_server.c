@@ -99,13 +99,30 @@ void 	*priority_context;
 static int      init_poll_context();  /* Initialize the tpp context */
 static void	(*read_func[2])(int);
 static int	(*ready_read_func)(conn_t *);
+static int	(*pending_func)(int);	/* does the socket hold a whole buffered request */
 static char	logbuf[256];
 
+/*
+ * Fairness of wait_request(): a connection is served at most
+ * CONN_REQ_QUOTA requests per wakeup, and the priority connections are
+ * polled again after every PRIO_POLL_INTERVAL ordinary requests.
+ */
+#define CONN_REQ_QUOTA		4
+#define PRIO_POLL_INTERVAL	16
+
+static unsigned long	wakeup_count = 0;	/* number of wait_request() wakeups */
+static int	*pending_socks = NULL;	/* sockets with a buffered request */
+static int	num_pending_socks = 0;
+static int	pending_socks_size = 0;
+
 /* Private function within this file */
 static int 	conn_find_usable_index(int);
 static int 	conn_find_actual_index(int);
 static void 	accept_conn();
 static void 	cleanup_conn(int);
+static int	serve_socket(int);
+static int	serve_priority_socks(void);
+static void	serve_pending_socks(void);
 
 /**
  * @brief
@@ -512,6 +529,155 @@ process_socket(int sock)
 	return 0;
 }
 
+/**
+ * @brief
+ *	Install the function that tells whether a connection already holds a
+ *	whole request in user space, which poll() cannot report.
+ *
+ * @param[in] func - function taking the socket, returning non-zero if a
+ *		     request can be read from it without waiting
+ *
+ * @return void
+ */
+void
+net_set_pending_func(int (*func)(int))
+{
+	pending_func = func;
+}
+
+/**
+ * @brief
+ *	Process one request on a socket, and remember the socket if it still
+ *	holds a whole buffered request afterwards.
+ *
+ * @param[in] sock - socket fd to process
+ *
+ * @retval	-1 for failure
+ * @retval	0  for success
+ *
+ */
+static int
+serve_socket(int sock)
+{
+	int idx;
+	int *tmp;
+	int ret;
+
+	idx = conn_find_actual_index(sock);
+	if (idx < 0)
+		return -1;
+	if (svr_conn[idx]->cn_wakeup != wakeup_count) {
+		svr_conn[idx]->cn_wakeup = wakeup_count;
+		svr_conn[idx]->cn_nserved = 0;
+	}
+	svr_conn[idx]->cn_nserved++;
+
+	ret = process_socket(sock);
+
+	if ((pending_func == NULL) || ((idx = conn_find_actual_index(sock)) < 0))
+		return ret;
+	if (svr_conn[idx]->cn_pending || (svr_conn[idx]->cn_ready_func == NULL))
+		return ret;
+	if (pending_func(sock) == 0)
+		return ret;
+
+	if (num_pending_socks == pending_socks_size) {
+		tmp = realloc(pending_socks, (pending_socks_size + CONNS_ARRAY_INCREMENT) * sizeof(int));
+		if (tmp == NULL) {
+			log_err(errno, __func__, "could not queue a buffered request");
+			return ret;
+		}
+		pending_socks = tmp;
+		pending_socks_size += CONNS_ARRAY_INCREMENT;
+	}
+	pending_socks[num_pending_socks++] = sock;
+	svr_conn[idx]->cn_pending = 1;
+	return ret;
+}
+
+/**
+ * @brief
+ *	Poll the priority connections, without waiting, and process those
+ *	that are ready.
+ *
+ * @return int
+ * @retval number of priority sockets processed
+ *
+ */
+static int
+serve_priority_socks(void)
+{
+	em_event_t *pevents;
+	int pnfds;
+	int i;
+	int nserved = 0;
+#ifndef WIN32
+	sigset_t emptyset;
+
+	/* wait after unblocking signals in an atomic call */
+	sigemptyset(&emptyset);
+	pnfds = tpp_em_pwait(priority_context, &pevents, 0, &emptyset);
+#else
+	pnfds = tpp_em_wait(priority_context, &pevents, 0);
+#endif /* WIN32 */
+	for (i = 0; i < pnfds; i++) {
+		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SERVER,
+			LOG_DEBUG, __func__, "processing priority socket");
+		if (serve_socket(EM_GET_FD(pevents, i)) == -1)
+			log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER,
+				LOG_DEBUG, __func__, "process priority socket failed");
+		else
+			nserved++;
+	}
+	return nserved;
+}
+
+/**
+ * @brief
+ *	Process the connections which hold a whole buffered request, round
+ *	robin one request at a time, until each is drained or has used its
+ *	quota for this wakeup.  Connections over quota stay queued for the
+ *	next wakeup.
+ *
+ * @return void
+ *
+ */
+static void
+serve_pending_socks(void)
+{
+	int i;
+	int j;
+	int n;
+	int idx;
+	int sock;
+	int pass;
+
+	for (pass = 0; (pass < CONN_REQ_QUOTA) && (num_pending_socks > 0); pass++) {
+		n = num_pending_socks;
+		for (i = 0; i < n; i++) {
+			sock = pending_socks[i];
+			idx = conn_find_actual_index(sock);
+			if ((idx < 0) || (svr_conn[idx]->cn_pending == 0)) {
+				pending_socks[i] = -1; /* closed while queued */
+				continue;
+			}
+			if ((svr_conn[idx]->cn_wakeup == wakeup_count) &&
+				(svr_conn[idx]->cn_nserved >= CONN_REQ_QUOTA))
+				continue;
+			pending_socks[i] = -1;
+			svr_conn[idx]->cn_pending = 0;
+			if (serve_socket(sock) == -1)
+				log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER,
+					LOG_DEBUG, __func__, "process socket failed");
+		}
+		for (i = 0, j = 0; i < num_pending_socks; i++) {
+			if (pending_socks[i] != -1)
+				pending_socks[j++] = pending_socks[i];
+		}
+		num_pending_socks = j;
+	}
+}
+
 /**
  * @brief
  *	Waits for events on a set of sockets and calls processing function
@@ -521,8 +687,12 @@ process_socket(int sock)
  * wait_request - wait for a request (socket with data to read)
  *	This routine does a tpp_em_wait - which internally does poll()/epoll()/select()
  *	based on the platform on the socket fds.
- *	It loops through the socket fds which has events on them and the processing
- *	routine associated with the socket is invoked.
+ *	It serves the priority sockets first, then loops through the socket fds
+ *	which have events on them and the processing routine associated with the
+ *	socket is invoked, polling the priority sockets again every
+ *	PRIO_POLL_INTERVAL requests.  Last, connections that still hold whole
+ *	buffered requests are served round robin, up to CONN_REQ_QUOTA requests
+ *	per connection per wakeup; leftovers make the next wait not block.
  *
  * @param[in] waittime - Timeout for tpp_em_wait (poll)
  * @param[in] priority_context - context consists of high priority socket connections
@@ -541,16 +711,20 @@ int
 wait_request(float waittime, void *priority_context)
 {
 	int nfds;
-	int pnfds;
 	int i;
 	em_event_t *events;
 	int err;
 	int prio_sock_processed;
 	int em_fd;
-	int em_pfd;
+	int nserved;
 	int timeout = (int) (waittime * 1000); /* milli seconds */
 	/* Platform specific declarations */
 
+	/* buffered requests are waiting, do not sleep */
+	if (num_pending_socks > 0)
+		timeout = 0;
+	wakeup_count++;
+
 #ifndef WIN32
 	sigset_t pendingsigs;
 	sigset_t emptyset;
@@ -573,31 +747,10 @@ wait_request(float waittime, void *priority_context)
 		}
 	} else {
 		prio_sock_processed = 0;
-		if (priority_context) {
-			em_event_t *pevents;
-			timeout = 0;
-#ifndef WIN32
-        		/* wait after unblocking signals in an atomic call */
-        		sigemptyset(&emptyset);
-        		pnfds = tpp_em_pwait(priority_context, &pevents, timeout, &emptyset);
-        		err = errno;
-#else
-        		pnfds = tpp_em_wait(priority_context, &pevents, timeout);
-        		err = errno;
-#endif /* WIN32 */
-                	for (i = 0; i < pnfds; i++) {
-                        	em_pfd = EM_GET_FD(pevents, i);
-				log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SERVER,
-                                        LOG_DEBUG, __func__, "processing priority socket");
-				if (process_socket(em_pfd) == -1) {
-                                	log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER,
-                                        	LOG_DEBUG, __func__, "process priority socket failed");
-                        	} else {
-					prio_sock_processed = 1;
-				}
-			}
-		}
+		if (priority_context)
+			prio_sock_processed = serve_priority_socks();
 
+		nserved = 0;
 		for (i = 0; i < nfds; i++) {
 			em_fd = EM_GET_FD(events, i);
 #ifndef WIN32
@@ -624,11 +777,16 @@ wait_request(float waittime, void *priority_context)
 				if (svr_conn[idx]->cn_prio_flag == 1)
 					continue;
 			}
-			if (process_socket(em_fd) == -1) {
+			if (serve_socket(em_fd) == -1) {
 				log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER,
 					LOG_DEBUG, __func__, "process socket failed");
 			}
+			/* do not let a burst of client requests hold up the priority lane */
+			if (priority_context && (++nserved % PRIO_POLL_INTERVAL) == 0)
+				prio_sock_processed += serve_priority_socks();
 		}
+
+		serve_pending_socks();
 	}
 
 #ifndef WIN32
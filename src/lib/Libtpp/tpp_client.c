@@ -266,6 +266,10 @@ typedef struct {
 	void (*close_func)(int); /* close function to be called when this stream is closed */
 
 	tpp_que_elem_t *timeout_node; /* pointer to myself in the timeout streams queue */
+
+	tpp_strm_stats_t stats;   /* transport statistics, lock free */
+	unsigned int lat_seq[TPP_STATS_RING];  /* seq numbers of packets in flight */
+	unsigned long lat_sent[TPP_STATS_RING]; /* and the times they were sent, in ms */
 } stream_t;
 
 /*
@@ -351,6 +355,9 @@ static int queue_ack(stream_t *strm, unsigned char type, unsigned int seq_no_rec
 static int send_ack_packet(ack_info_t *ack);
 static int send_retry_packet(tpp_packet_t *pkt);
 static int unshelve_pkt(stream_t *strm, int seq_no_acked);
+static void strm_stats_sent(stream_t *strm, unsigned int seq_no);
+static void strm_stats_acked(stream_t *strm, unsigned int seq_no_acked);
+static void strm_stats_dump(void);
 static void *add_part_packet(stream_t *strm, void *data, int sz);
 static int send_pkt_to_app(stream_t *strm, unsigned char type, void *data, int sz);
 static stream_t *find_stream_with_dest(tpp_addr_t *dest_addr, unsigned int dest_sd, unsigned int dest_magic);
@@ -788,6 +795,8 @@ tpp_init(struct tpp_config *cnf)
 		return -1;
 	}
 
+	tpp_strm_stats_func = strm_stats_dump;
+
 	/* get the addresses associated with this leaf */
 	leaf_addrs = tpp_get_addresses(tpp_conf->node_name, &leaf_addr_count);
 	if (!leaf_addrs) {
@@ -1142,28 +1151,46 @@ tpp_send(int sd, void *data, int len)
 	void *p;
 	unsigned int cmprsd_len = 0;
 	tpp_packet_t *pkt = NULL;
+	stream_t *strm;
 
-	if (!get_strm(sd)) {
+	if ((strm = get_strm(sd)) == NULL) {
 		TPP_DBPRT(("Bad sd %d", sd));
 		return -1;
 	}
 
 	TPP_DBPRT(("Sending: sd=%d, len=%d", sd, len));
 
-	if ((tpp_conf->compress == 1) && (len > TPP_COMPR_SIZE)) {
+	if ((tpp_conf->compress == 1) && (len > 0) && ((unsigned int) len >= tpp_conf->compress_min_size)) {
 		void *outbuf;
 
-		outbuf = tpp_deflate(data, len, &cmprsd_len);
+		outbuf = tpp_compress(tpp_conf->compress_algo, tpp_conf->compress_dict, data, len, &cmprsd_len);
 		if (outbuf == NULL) {
-			tpp_log_func(LOG_CRIT, __func__, "tpp deflate failed");
+			tpp_log_func(LOG_CRIT, __func__, "tpp compress failed");
 			return -1;
 		}
-		pkt = tpp_cr_pkt(outbuf, cmprsd_len, 0);
-		if (pkt == NULL) {
+		TPP_STAT_ADD(strm->stats.raw_bytes, len);
+		TPP_STAT_ADD(tpp_strm_totals.raw_bytes, len);
+		if (cmprsd_len >= (unsigned int) len) {
+			/*
+			 * data did not shrink, send it as is; this also keeps
+			 * the receiver from treating it as uncompressed data
+			 * when both lengths happen to be equal
+			 */
 			free(outbuf);
-			return -1;
+			TPP_STAT_ADD(strm->stats.cmpr_bytes, len);
+			TPP_STAT_ADD(tpp_strm_totals.cmpr_bytes, len);
+		} else {
+			TPP_STAT_ADD(strm->stats.cmpr_bytes, cmprsd_len);
+			TPP_STAT_ADD(tpp_strm_totals.cmpr_bytes, cmprsd_len);
+			pkt = tpp_cr_pkt(outbuf, cmprsd_len, 0);
+			if (pkt == NULL) {
+				free(outbuf);
+				return -1;
+			}
 		}
+	}
 
+	if (pkt) {
 		p = pkt->data;
 		to_send = cmprsd_len;
 	} else {
@@ -1236,6 +1263,7 @@ tpp_send_inner(int sd, void *data, int len, int full_len, int cmprsd_len)
 	dhdr.dest_sd = htonl(strm->dest_sd);
 
 	dhdr.seq_no = htonl(strm->send_seq_no);
+	strm_stats_sent(strm, strm->send_seq_no);
 	strm->send_seq_no = get_next_seq(strm->send_seq_no);
 
 	dhdr.ack_seq = htonl(UNINITIALIZED_INT);
@@ -2196,8 +2224,10 @@ tpp_mcast_send(int mtfd, void *data, unsigned int len, unsigned int full_len, un
 	int i, totlen = 0;
 	tpp_chunk_t chunks[3];
 	tpp_mcast_pkt_hdr_t mhdr;
-	tpp_mcast_pkt_info_t *minfo;
 	tpp_mcast_pkt_info_t tmp_minfo;
+	tpp_mcast_pkt_info_t prev_minfo;
+	char enc_minfo[TPP_MINFO_MAX_LEN];
+	int enc_len;
 	unsigned int cmpr_len = 0;
 	void *minfo_buf = NULL;
 	int minfo_len;
@@ -2232,26 +2262,30 @@ tpp_mcast_send(int mtfd, void *data, unsigned int len, unsigned int full_len, un
 	mhdr.totlen = htonl(full_len);
 	memcpy(&mhdr.src_addr, &mstrm->src_addr, sizeof(tpp_addr_t));
 	mhdr.num_streams = htonl(d->num_fds);
-	mhdr.info_len = htonl(minfo_len);
+	mhdr.info_fmt = tpp_conf->compact_mcast ? TPP_MINFO_FMT_COMPACT : TPP_MINFO_FMT_FULL;
 
 	chunks[0].data = &mhdr;
 	chunks[0].len = sizeof(tpp_mcast_pkt_hdr_t);
 	totlen = chunks[0].len;
 
-	if (tpp_conf->compress == 1 && minfo_len > TPP_COMPR_SIZE) {
+	if (tpp_conf->compress == 1 && (unsigned int) minfo_len >= tpp_conf->compress_min_size) {
 		def_ctx = tpp_multi_deflate_init(minfo_len);
 		if (def_ctx == NULL)
 			goto err;
 	} else {
-		minfo_buf = malloc(minfo_len);
+		minfo_buf = malloc(TPP_MINFO_MAX_LEN * d->num_fds);
 		if (!minfo_buf) {
 			snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ,
-				"Out of memory allocating mcast buffer of %d bytes", minfo_len);
+				"Out of memory allocating mcast buffer of %lu bytes", (unsigned long) (TPP_MINFO_MAX_LEN * d->num_fds));
 			tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
 			goto err;
 		}
 	}
 
+	/* members are sent in the compact format if enabled, see tpp_minfo_encode */
+	memset(&prev_minfo, 0, sizeof(tpp_mcast_pkt_info_t));
+	memset(&tmp_minfo, 0, sizeof(tpp_mcast_pkt_info_t)); /* only to satisfy valgrind */
+	minfo_len = 0;
 	for (i = 0; i < d->num_fds; i++) {
 		strm = get_strm_atomic(d->strms[i]);
 		if (!strm) {
@@ -2266,23 +2300,31 @@ tpp_mcast_send(int mtfd, void *data, unsigned int len, unsigned int full_len, un
 		tmp_minfo.dest_sd = htonl(strm->dest_sd);
 		tmp_minfo.seq_no = htonl(strm->send_seq_no);
 		d->seqs[i] = strm->send_seq_no; /* store seq in packet for retry case */
+		strm_stats_sent(strm, strm->send_seq_no);
 
 		TPP_DBPRT(("*** src_sd=%u, dest_sd=%u, seq_no_sent=%u", strm->sd, strm->dest_sd, strm->send_seq_no));
 
 		strm->send_seq_no = get_next_seq(strm->send_seq_no);
 		memcpy(&tmp_minfo.dest_addr, &strm->dest_addr, sizeof(tpp_addr_t));
 
+		if (tpp_conf->compact_mcast)
+			enc_len = tpp_minfo_encode(&prev_minfo, &tmp_minfo, enc_minfo);
+		else {
+			memcpy(enc_minfo, &tmp_minfo, sizeof(tpp_mcast_pkt_info_t));
+			enc_len = sizeof(tpp_mcast_pkt_info_t);
+		}
 		if (def_ctx == NULL) { /* no compression */
-			minfo = (tpp_mcast_pkt_info_t *)((char *) minfo_buf + (i * sizeof(tpp_mcast_pkt_info_t)));
-			memcpy(minfo, &tmp_minfo, sizeof(tpp_mcast_pkt_info_t));
+			memcpy((char *) minfo_buf + minfo_len, enc_minfo, enc_len);
 		} else {
 			finish = (i == (d->num_fds - 1)) ? 1 : 0;
 
-			ret = tpp_multi_deflate_do(def_ctx, finish, &tmp_minfo, sizeof(tpp_mcast_pkt_info_t));
+			ret = tpp_multi_deflate_do(def_ctx, finish, enc_minfo, enc_len);
 			if (ret != 0)
 				goto err;
 		}
+		minfo_len += enc_len;
 	}
+	mhdr.info_len = htonl(minfo_len);
 
 	if (def_ctx != NULL) {
 		minfo_buf = tpp_multi_deflate_done(def_ctx, &cmpr_len);
@@ -2774,6 +2816,8 @@ shelve_pkt(tpp_packet_t *pkt, tpp_packet_t *data_pkt, time_t retry_time)
 	rt->acked = 0;
 	rt->retry_time = retry_time;
 	rt->retry_count = 0;
+	TPP_STAT_INC(strm->stats.shelved);
+	TPP_STAT_INC(tpp_strm_totals.shelved);
 	rt->sent_to_transport = 0;
 	pkt->extra_data = rt;
 
@@ -3050,6 +3094,8 @@ send_retry_packet(tpp_packet_t *pkt)
 	 */
 	rt->retry_count++;
 	rt->sent_to_transport = 1;
+	TPP_STAT_INC(strm->stats.retries);
+	TPP_STAT_INC(tpp_strm_totals.retries);
 
 	if (tpp_transport_send_raw(routers[active_router]->conn_fd, pkt) != 0) {
 		tpp_log_func(LOG_ERR, __func__, "tpp_transport_send_raw failed");
@@ -3443,6 +3489,86 @@ leaf_next_event_expiry(time_t now)
 	return res;
 }
 
+/**
+ * @brief
+ *	Account a data packet sent on a stream, and remember when it was sent
+ *	so that the ack latency can be measured.
+ *
+ * @param[in] strm - The stream
+ * @param[in] seq_no - Sequence number of the packet sent
+ *
+ * @par MT-safe: No
+ *
+ */
+static void
+strm_stats_sent(stream_t *strm, unsigned int seq_no)
+{
+	int i = seq_no % TPP_STATS_RING;
+
+	TPP_STAT_INC(strm->stats.pkts_sent);
+	TPP_STAT_INC(tpp_strm_totals.pkts_sent);
+
+	strm->lat_seq[i] = seq_no;
+	strm->lat_sent[i] = tpp_stats_now_ms();
+}
+
+/**
+ * @brief
+ *	Account an ack received on a stream. If the acked packet is still
+ *	tracked in the ring of packets in flight, record its ack latency.
+ *
+ * @param[in] strm - The stream
+ * @param[in] seq_no_acked - Sequence number acked
+ *
+ * @par MT-safe: No
+ *
+ */
+static void
+strm_stats_acked(stream_t *strm, unsigned int seq_no_acked)
+{
+	int i = seq_no_acked % TPP_STATS_RING;
+	unsigned long sent = strm->lat_sent[i];
+	unsigned long now;
+
+	if (sent == 0 || strm->lat_seq[i] != seq_no_acked)
+		return;
+
+	strm->lat_sent[i] = 0;
+	now = tpp_stats_now_ms();
+	tpp_stats_ack_latency(&strm->stats, (now > sent) ? now - sent : 0);
+}
+
+/**
+ * @brief
+ *	Log the statistics of each open stream that carried any traffic
+ *
+ * @par MT-safe: Yes
+ *
+ */
+static void
+strm_stats_dump(void)
+{
+	unsigned int i;
+	stream_t *strm;
+	char buf[TPP_LOGBUF_SZ];
+	char dest[TPP_MAXADDRLEN + 1];
+
+	tpp_lock(&strmarray_lock);
+	for (i = 0; i < max_strms; i++) {
+		if (strmarray[i].slot_state != TPP_SLOT_BUSY || (strm = strmarray[i].strm) == NULL)
+			continue;
+		if (strm->stats.pkts_sent == 0 && strm->stats.pkts_recvd == 0)
+			continue;
+
+		snprintf(dest, sizeof(dest), "%s", tpp_netaddr(&strm->dest_addr));
+		tpp_stats_strm_str(&strm->stats, buf, sizeof(buf));
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Stream sd=%u to %s: unacked=%d %s",
+			strm->sd, dest, strm->num_unacked_pkts, buf);
+		tpp_log_func(LOG_INFO, NULL, tpp_get_logbuf());
+	}
+	tpp_unlock(&strmarray_lock);
+}
+
 /**
  * @brief
  *	When a prior sent data packet is acked, this function is called to
@@ -3576,7 +3702,7 @@ add_part_packet(stream_t *strm, void *data, int sz)
 			tpp_packet_t *tmp = obj;
 			void *uncmpr_data;
 
-			if ((uncmpr_data = tpp_inflate(tmp->data, cmprsd_len, totlen))) {
+			if ((uncmpr_data = tpp_decompress(tmp->data, cmprsd_len, totlen))) {
 				obj = tpp_cr_pkt(uncmpr_data, totlen, 0);
 				if (!obj)
 					free(uncmpr_data);
@@ -4558,6 +4684,7 @@ leaf_pkt_handler(int tfd, void *data, int len, void *ctx, void *extra)
 			sd = strm->sd;
 
 			if (seq_no_acked != UNINITIALIZED_INT) {
+				strm_stats_acked(strm, seq_no_acked);
 				unshelve_pkt(strm, seq_no_acked);
 				/*
 				 * if app u_state == TPP_STRM_STATE_CLOSE means an CLOSE packet was sent out
@@ -4576,6 +4703,9 @@ leaf_pkt_handler(int tfd, void *data, int len, void *ctx, void *extra)
 				return 0; /* it is an ack packet, everything is done by now */
 			}
 
+			TPP_STAT_INC(strm->stats.pkts_recvd);
+			TPP_STAT_INC(tpp_strm_totals.pkts_recvd);
+
 			/* always ack data packets, even if duplicate */
 			queue_ack(strm, type, seq_no_recvd);
 
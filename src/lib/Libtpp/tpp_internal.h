@@ -147,6 +147,43 @@ typedef struct {
 	int ref_count;	/* number of accessors */
 } tpp_packet_t;
 
+/*
+ * Transport statistics, kept per physical connection and per stream.
+ *
+ * The counters are only ever incremented, using atomic adds, by the IO
+ * threads and the APP thread, so they need no locks. A dump reads them
+ * without locking, so a dump may be slightly inconsistent across counters.
+ *
+ * Ack latencies are recorded in a histogram, where bucket i counts the acks
+ * that arrived within 2^i milliseconds (but not within 2^(i-1)), and the
+ * last bucket counts all the slower ones.
+ */
+#define TPP_STATS_BUCKETS	12
+#define TPP_STATS_RING		8 /* in-flight packets per stream tracked for latency */
+
+typedef struct {
+	unsigned long pkts_sent;	/* packets written to the socket */
+	unsigned long pkts_recvd;	/* packets read from the socket */
+	unsigned long bytes_sent;
+	unsigned long bytes_recvd;
+	unsigned long sendq_max;	/* high water mark of bytes queued to send */
+	unsigned long send_blocked;	/* times the socket could not take more data */
+} tpp_conn_stats_t;
+
+typedef struct {
+	unsigned long pkts_sent;	/* data packets sent */
+	unsigned long pkts_recvd;	/* data packets received */
+	unsigned long shelved;		/* packets shelved for a possible retry */
+	unsigned long retries;		/* packets resent */
+	unsigned long acks;		/* acks received */
+	unsigned long ack_lat[TPP_STATS_BUCKETS];	/* ack latency histogram */
+	unsigned long raw_bytes;	/* bytes handed to compression */
+	unsigned long cmpr_bytes;	/* bytes after compression */
+} tpp_strm_stats_t;
+
+#define TPP_STAT_ADD(c, n)	((void) __sync_fetch_and_add(&(c), (unsigned long) (n)))
+#define TPP_STAT_INC(c)		TPP_STAT_ADD(c, 1)
+
 /*
  * Structure used to describe chunks of data to be sent to a gather-and-send
  * api "tpp_transport_vsend". Each chunk has this structure.
@@ -230,6 +267,7 @@ typedef struct {
 typedef struct {
 	unsigned char type;       /* type of packet - TPP_MCAST_DATA */
 	unsigned char hop;        /* hop count */
+	unsigned char info_fmt;   /* format of member info, TPP_MINFO_FMT_XXX */
 	unsigned int num_streams; /* number of member streams */
 	unsigned int info_len;    /* total length of info */
 	unsigned int info_cmprsd_len; /* compressed length of info */
@@ -251,6 +289,27 @@ typedef struct {
 	tpp_addr_t dest_addr;	/* dest host address of member */
 } tpp_mcast_pkt_info_t;
 
+/*
+ * Formats of the member info of a mcast packet. In the compact format each
+ * member is encoded as a one byte bitmap of the fields that follow, fields
+ * not present are derived from the previous member in the list. Members of
+ * a broadcast mostly share the magic, dest_sd, port and family, and usually
+ * have consecutive src_sd, so most members reduce to a few bytes.
+ */
+#define TPP_MINFO_FMT_FULL	0 /* array of tpp_mcast_pkt_info_t */
+#define TPP_MINFO_FMT_COMPACT	1 /* bitmap encoded members */
+
+#define TPP_MINFO_SRC_SD	0x01 /* src_sd follows, else previous + 1 */
+#define TPP_MINFO_SRC_MAGIC	0x02 /* src_magic follows, else previous */
+#define TPP_MINFO_DEST_SD	0x04 /* dest_sd follows, else previous */
+#define TPP_MINFO_SEQ_NO	0x08 /* seq_no follows, else previous */
+#define TPP_MINFO_IP		0x10 /* ip[0] follows, else previous */
+#define TPP_MINFO_IP6		0x20 /* ip[1] to ip[3] follow, else previous */
+#define TPP_MINFO_PORT		0x40 /* port follows, else previous */
+#define TPP_MINFO_FAMILY	0x80 /* family follows, else previous */
+
+#define TPP_MINFO_MAX_LEN	(1 + 8 * sizeof(int) + sizeof(short) + sizeof(char))
+
 #define SLOT_INC                1000
 
 #define TPP_SLOT_FREE           0
@@ -284,7 +343,21 @@ enum TPP_MSG_TYPES {
 #define TPP_STRM_TIMEOUT        600
 #define TPP_MIN_WAIT            2
 #define TPP_SEND_SIZE           8192
-#define TPP_COMPR_SIZE          8192
+
+/*
+ * Compression codecs usable for TPP data. zlib streams are sent as is (their
+ * first byte always carries Z_DEFLATED in the low nibble), while data
+ * compressed by the other codecs is prefixed by a one byte tag, so that the
+ * receiving end can identify the codec without any per stream negotiation.
+ */
+#define TPP_COMPR_NONE          0
+#define TPP_COMPR_ZLIB          1
+#define TPP_COMPR_LZ4           2
+#define TPP_COMPR_ZSTD          3
+
+#define TPP_COMPR_TAG_LZ4       0xC1
+#define TPP_COMPR_TAG_ZSTD      0xC2
+#define TPP_COMPR_TAG_DICT      0x10 /* or'ed into the tag if the preset dictionary was used */
 
 /* tpp cmds used internally by the layer to notify messages between threads */
 #define TPP_CMD_SEND            1
@@ -403,6 +476,9 @@ typedef struct {
 	void *td;
 	char tpplogbuf[TPP_LOGBUF_SZ];
 	char tppstaticbuf[TPP_LOGBUF_SZ];
+	void *lz4_stream;	/* per-thread lz4 compression stream */
+	void *zstd_cctx;	/* per-thread zstd compression context */
+	void *zstd_dctx;	/* per-thread zstd decompression context */
 } tpp_tls_t;
 
 typedef struct {
@@ -491,11 +567,25 @@ int tpp_send_ctl_msg(int, int, tpp_addr_t *, tpp_addr_t *, unsigned int, char, c
 int tpp_cr_thrd(void *(*start_routine)(void*), pthread_t *, void *);
 int tpp_set_keep_alive(int, struct tpp_config *);
 
-void *tpp_deflate(void *, unsigned int, unsigned int *);
+void *tpp_deflate(void *, unsigned int, unsigned int *, int);
 void *tpp_inflate(void *, unsigned int, unsigned int);
+void *tpp_compress(int, int, void *, unsigned int, unsigned int *);
+void *tpp_decompress(void *, unsigned int, unsigned int);
+int tpp_compr_algo_from_name(char *);
+char *tpp_compr_algo_name(int);
 void *tpp_multi_deflate_init(int);
 int tpp_multi_deflate_do(void *, int, void *, unsigned int);
 void *tpp_multi_deflate_done(void *, unsigned int *);
+int tpp_minfo_encode(tpp_mcast_pkt_info_t *, tpp_mcast_pkt_info_t *, char *);
+
+extern tpp_strm_stats_t tpp_strm_totals;
+extern void (*tpp_strm_stats_func)(void);
+void tpp_stat_max(unsigned long *, unsigned long);
+unsigned long tpp_stats_now_ms(void);
+void tpp_stats_ack_latency(tpp_strm_stats_t *, unsigned long);
+char *tpp_stats_strm_str(tpp_strm_stats_t *, char *, size_t);
+void tpp_transport_stats_dump(void);
+tpp_mcast_pkt_info_t *tpp_minfo_decode(void *, unsigned int, unsigned int);
 
 int tpp_add_fd(int, int, int);
 int tpp_del_fd(int, int);
@@ -87,14 +87,33 @@
 
 struct tpp_config *tpp_conf; /* copy of the global tpp_config */
 
-/*pthread_rwlock_t router_lock;*/ /* rw lock for router indexes */
-pthread_mutex_t router_lock; /* for now only a write only lock, since our indexes are not mt-safe */
+pthread_mutex_t router_lock; /* serializes changes to the routing state */
 
 /* index of routers connected to this router */
 void *routers_idx = NULL;
 
-/* index of all leaves in the cluster */
-void *cluster_leaves_idx = NULL;
+/*
+ * Index of all leaves in the cluster, the primary "routing table".
+ *
+ * The index is split into shards by a hash of the leaf address, each shard
+ * guarded by its own rw lock. The IO threads look up the destination of every
+ * data packet, and take only the read lock of the shard holding that
+ * destination, so lookups from different threads proceed in parallel and
+ * lookups of different destinations do not even share a lock.
+ *
+ * Anything that changes the routing state (leaves joining or leaving, routers
+ * connecting or dropping) holds router_lock, which serializes such writers,
+ * along with the write locks of all the shards, see route_wrlock(). These
+ * changes are rare compared to the data traffic.
+ */
+#define TPP_LEAF_SHARDS 64
+
+typedef struct {
+	pthread_rwlock_t lock;
+	void *idx;
+} leaf_shard_t;
+
+static leaf_shard_t cluster_leaves[TPP_LEAF_SHARDS];
 
 /* index of special routers who need to be notified for join updates */
 void *my_leaves_notify_idx = NULL;
@@ -117,6 +136,119 @@ static int router_post_connect_handler(int tfd, void *data, void *c, void *extra
 /* structure identifying this router */
 static tpp_router_t *this_router = NULL;
 
+/**
+ * @brief
+ *	Find the shard of the cluster leaves index that holds a leaf address
+ *
+ * @param[in] addr - The leaf address
+ *
+ * @return - the shard
+ *
+ * @par MT-safe: Yes
+ */
+static leaf_shard_t *
+leaf_shard(tpp_addr_t *addr)
+{
+	unsigned int h;
+
+	h = (unsigned int) (addr->ip[0] ^ addr->ip[1] ^ addr->ip[2] ^ addr->ip[3]);
+	h ^= (unsigned short) addr->port;
+	h *= 2654435761U; /* Knuth's multiplicative hash, spreads similar addresses */
+
+	return &cluster_leaves[(h >> 16) % TPP_LEAF_SHARDS];
+}
+
+/**
+ * @brief
+ *	Acquire the locks required to change the routing state, i.e., the
+ *	router_lock and the write locks of all the cluster leaves shards.
+ *
+ * @par MT-safe: Yes
+ */
+static void
+route_wrlock(void)
+{
+	int i;
+
+	tpp_lock(&router_lock);
+	for (i = 0; i < TPP_LEAF_SHARDS; i++)
+		tpp_wrlock_rwlock(&cluster_leaves[i].lock);
+}
+
+/**
+ * @brief
+ *	Release the locks acquired by route_wrlock
+ *
+ * @par MT-safe: Yes
+ */
+static void
+route_wrunlock(void)
+{
+	int i;
+
+	for (i = TPP_LEAF_SHARDS - 1; i >= 0; i--)
+		tpp_unlock_rwlock(&cluster_leaves[i].lock);
+	tpp_unlock(&router_lock);
+}
+
+/**
+ * @brief
+ *	Find a leaf in the cluster leaves index.
+ *	Caller must hold route_wrlock.
+ *
+ * @param[in] addr - Any of the addresses of the leaf
+ *
+ * @return - the leaf
+ * @retval NULL - leaf not found
+ *
+ * @par MT-safe: No
+ */
+static tpp_leaf_t *
+find_cluster_leaf(tpp_addr_t *addr)
+{
+	tpp_leaf_t *l = NULL;
+	void *paddr = addr;
+
+	pbs_idx_find(leaf_shard(addr)->idx, &paddr, (void **)&l, NULL);
+	return l;
+}
+
+/**
+ * @brief
+ *	Find the route to a leaf, used for each packet routed by this router.
+ *	Takes only the read lock of the shard holding the leaf.
+ *
+ * @param[in] addr - Address of the leaf
+ * @param[out] found - Set to 1 if the leaf is known, 0 otherwise
+ * @param[out] fd - fd of the chosen router
+ *
+ * @return - Router to be used
+ * @retval NULL - leaf not found, or no connected router to reach it
+ *
+ * @par MT-safe: Yes
+ */
+static tpp_router_t *
+route_to_leaf(tpp_addr_t *addr, int *found, int *fd)
+{
+	leaf_shard_t *shard = leaf_shard(addr);
+	tpp_leaf_t *l = NULL;
+	tpp_router_t *r = NULL;
+	void *paddr = addr;
+
+	*found = 0;
+	*fd = -1;
+
+	tpp_rdlock_rwlock(&shard->lock);
+	pbs_idx_find(shard->idx, &paddr, (void **)&l, NULL);
+	if (l) {
+		*found = 1;
+		r = get_preferred_router(l, this_router, fd);
+	}
+	tpp_unlock_rwlock(&shard->lock);
+
+	return r;
+}
+
 static tpp_router_t *
 alloc_router(char *name, tpp_addr_t *address)
 {
@@ -209,8 +341,8 @@ log_noroute(tpp_addr_t *src_host, tpp_addr_t *dest_host, int src_sd, char *msg)
  * @retval  0 - Success
  *
  * @par Side Effects:
- *	This routine expects to be called with the "router_lock" and
- *	will unlock the router_lock before exiting.
+ *	This routine expects to be called with route_wrlock() held and
+ *	will release it before exiting.
  *
  * @par MT-safe: Yes
  *
@@ -265,7 +397,7 @@ send_leaves_to_router(tpp_router_t *parent, tpp_router_t *target)
 		}
 	}
 
-	tpp_unlock(&router_lock);
+	route_wrunlock();
 
 	chunks[0].len = sizeof(tpp_join_pkt_hdr_t);
 	while ((lf_data = (struct leaf_data *) tpp_deque(&ctl_hdr_queue))) {
@@ -286,7 +418,7 @@ send_leaves_to_router(tpp_router_t *parent, tpp_router_t *target)
 	return 0;
 
 err:
-	tpp_unlock(&router_lock);
+	route_wrunlock();
 	if (idx_ctx)
 		pbs_idx_free_ctx(idx_ctx);
 	if (lf_data) {
@@ -315,8 +447,8 @@ err:
  * @retval  0 - Success
  *
  * @par Side Effects:
- *	This routine expects to be called with the "router_lock" locked and
- *	will unlock the router_lock before exiting.
+ *	This routine expects to be called with route_wrlock() held and
+ *	will release it before exiting.
  *
  * @par MT-safe: No
  *
@@ -339,7 +471,7 @@ broadcast_to_my_routers(tpp_chunk_t *chunks, int count, int origin_tfd)
 	}
 	pbs_idx_free_ctx(idx_ctx);
 
-	tpp_unlock(&router_lock);
+	route_wrunlock();
 
 	for (i = 0; i < max_cons; i++) {
 		if (tpp_transport_vsend(list[i], chunks, count) != 0) {
@@ -462,7 +594,7 @@ router_send_ctl_join(int tfd, void *data, void *c)
 		chunks[0].len = sizeof(tpp_join_pkt_hdr_t);
 		rc = tpp_transport_vsend(r->conn_fd, chunks, 1);
 		if (rc == 0) {
-			tpp_lock(&router_lock);
+			route_wrlock();
 
 			r->state = TPP_ROUTER_STATE_CONNECTED;
 
@@ -652,20 +784,20 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 			 * broadcast leave pkt to other routers,
 			 * except from where it came from
 			 */
-			tpp_lock(&router_lock); /* below routine expects to be called under lock */
+			route_wrlock(); /* below routine expects to be called under lock */
 			broadcast_to_my_routers(chunks, 2, tfd); /* this routine unlocks the lock */
 
 			snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "tfd=%d, Connection from leaf %s down", tfd, tpp_netaddr(&l->leaf_addrs[0]));
 			tpp_log_func(LOG_CRIT, NULL, tpp_get_logbuf());
 		}
 
-		tpp_lock(&router_lock);
+		route_wrlock();
 
 		if ((r = del_router_from_leaf(l, tfd)) == NULL) {
 			snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "tfd=%d, Failed to clear pbs_comm from leaf %s's list",
 						tfd, tpp_netaddr(&l->leaf_addrs[0]));
 			tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-			tpp_unlock(&router_lock);
+			route_wrunlock();
 			return -1;
 		}
 
@@ -675,7 +807,7 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 				"tfd=%d, Failed to delete address from my_leaves %s",
 				tfd, tpp_netaddr(&l->leaf_addrs[0]));
 			tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-			tpp_unlock(&router_lock);
+			route_wrunlock();
 			return -1;
 		}
 
@@ -685,7 +817,7 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 
 		if (l->num_routers > 0) {
 			TPP_DBPRT(("tfd=%d, Other pbs_comms for leaf %s present", tfd, tpp_netaddr(&l->leaf_addrs[0])));
-			tpp_unlock(&router_lock);
+			route_wrunlock();
 			return 0;
 		}
 
@@ -693,10 +825,10 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 
 		/* delete all of this leaf's addresses from the search tree */
 		for (i = 0; i < l->num_addrs; i++) {
-			if (pbs_idx_delete(cluster_leaves_idx, &l->leaf_addrs[i]) != PBS_IDX_RET_OK) {
+			if (pbs_idx_delete(leaf_shard(&l->leaf_addrs[i])->idx, &l->leaf_addrs[i]) != PBS_IDX_RET_OK) {
 				snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "tfd=%d, Failed to delete address %s from cluster leaves", tfd, tpp_netaddr(&l->leaf_addrs[i]));
 				tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-				tpp_unlock(&router_lock);
+				route_wrunlock();
 				return -1;
 			}
 		}
@@ -709,7 +841,7 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 			pbs_idx_delete(my_leaves_notify_idx, &l->leaf_addrs[0]);
 		}
 
-		tpp_unlock(&router_lock);
+		route_wrunlock();
 
 		/* broadcast to all self connected leaves */
 		/*
@@ -742,7 +874,7 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 				"tfd=%d, Connection %s pbs_comm %s down", tfd, (r->initiator == 1) ? "to" : "from", r->router_name);
 			tpp_log_func(LOG_CRIT, NULL, tpp_get_logbuf());
 
-			tpp_lock(&router_lock);
+			route_wrlock();
 			TPP_QUE_CLEAR(&deleted_leaves);
 
 			while (pbs_idx_find(r->my_leaves_idx, NULL, (void **)&l, &idx_ctx) == PBS_IDX_RET_OK) {
@@ -756,7 +888,7 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 						TPP_DBPRT(("All routers to leaf %s down, deleting leaf", tpp_netaddr(&l->leaf_addrs[0])));
 
 						if (tpp_enque(&deleted_leaves, l) == NULL) {
-							tpp_unlock(&router_lock);
+							route_wrunlock();
 							tpp_log_func(LOG_CRIT, __func__, "Out of memory enqueuing deleted leaves");
 							return -1;
 						}
@@ -776,12 +908,12 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 				}
 
 				for (i = 0; i < l->num_addrs; i++) {
-					if (pbs_idx_delete(cluster_leaves_idx, &l->leaf_addrs[i]) != PBS_IDX_RET_OK) {
+					if (pbs_idx_delete(leaf_shard(&l->leaf_addrs[i])->idx, &l->leaf_addrs[i]) != PBS_IDX_RET_OK) {
 						snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ,
 							"tfd=%d, Failed to delete address %s",
 							tfd, tpp_netaddr(&l->leaf_addrs[i]));
 						tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-						tpp_unlock(&router_lock);
+						route_wrunlock();
 
 						return -1;
 					}
@@ -800,7 +932,7 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 				if (r->my_leaves_idx == NULL) {
 					tpp_log_func(LOG_CRIT, __func__, "Failed to create index for my leaves");
 					free_router(r);
-					tpp_unlock(&router_lock);
+					route_wrunlock();
 					return -1;
 				}
 			}
@@ -813,7 +945,7 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 			r->conn_fd = -1;
 			r->state = TPP_ROUTER_STATE_DISCONNECTED;
 
-			tpp_unlock(&router_lock);
+			route_wrunlock();
 
 			chunks[0].data = &hdr;
 			chunks[0].len = sizeof(tpp_leave_pkt_hdr_t);
@@ -882,9 +1014,9 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 			 * remove this router from our list of registered routers
 			 * ie, remove from routers_idx tree
 			 **/
-			tpp_lock(&router_lock);
+			route_wrlock();
 			pbs_idx_delete(routers_idx, &r->router_addr);
-			tpp_unlock(&router_lock);
+			route_wrunlock();
 
 			/*
 			 * context will be freed and deleted by router_close_handler
@@ -1130,6 +1262,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 	tpp_chunk_t chunks[2];
 	tpp_router_t *target_router = NULL;
 	int target_fd = -1;
+	int leaf_found = 0;
 	tpp_addr_t connected_host;
 	tpp_addr_t *addr = tpp_get_connected_host(tfd);
 	void *data_out = NULL;
@@ -1323,7 +1456,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 
 				TPP_DBPRT(("Recvd TPP_CTL_JOIN from pbs_comm node %s", tpp_netaddr(&connected_host)));
 
-				tpp_lock(&router_lock);
+				route_wrlock();
 
 				/* find associated router */
 				pbs_idx_find(routers_idx, &pconn_host, (void **)&r, NULL);
@@ -1338,7 +1471,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 							 tfd, r->router_name, r->conn_fd);
 						tpp_log_func(LOG_CRIT, NULL, tpp_get_logbuf());
 						tpp_transport_close(r->conn_fd);
-						tpp_unlock(&router_lock);
+						route_wrunlock();
 						if (data_out)
 							free(data_out);
 						return -1;
@@ -1346,7 +1479,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				} else {
 					r = alloc_router(strdup(tpp_netaddr(&connected_host)), &connected_host);
 					if (!r) {
-						tpp_unlock(&router_lock);
+						route_wrunlock();
 						if (data_out)
 							free(data_out);
 						return -1;
@@ -1362,7 +1495,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				if (ctx == NULL) {
 					if ((ctx = (tpp_context_t *) malloc(sizeof(tpp_context_t))) == NULL) {
 						tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating tpp context");
-						tpp_unlock(&router_lock);
+						route_wrunlock();
 						if (data_out)
 							free(data_out);
 						return -1;
@@ -1378,7 +1511,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				tpp_transport_set_conn_ctx(tfd, ctx);
 
 				/* now send new router info about all leaves I have */
-				send_leaves_to_router(this_router, r); /* this call will unlock the router_lock */
+				send_leaves_to_router(this_router, r); /* this call will release the route locks */
 
 				if (data_out)
 					free(data_out);
@@ -1391,7 +1524,6 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				int i;
 				int index = (int) hdr->index;
 				tpp_addr_t *addrs;
-				void *paddr;
 
 				if (hdr->num_addrs == 0) {
 					/* error, must have atleast one address associated */
@@ -1403,7 +1535,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				}
 				addrs = (tpp_addr_t *) (((char *) data) + sizeof(tpp_join_pkt_hdr_t));
 
-				tpp_lock(&router_lock);
+				route_wrlock();
 
 				if (ctx == NULL || ctx->ptr == NULL) {
 					/* router is myself */
@@ -1421,7 +1553,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 						snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "tfd=%d, Failed to find pbs_comm %s in join for leaf %s",
 									tfd, rname, tpp_netaddr(&addrs[0]));
 						tpp_log_func(LOG_CRIT, NULL, tpp_get_logbuf());
-						tpp_unlock(&router_lock);
+						route_wrunlock();
 						if (data_out)
 							free(data_out);
 						return -1;
@@ -1430,8 +1562,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 
 				/* find the leaf */
 				found = 1;
-				paddr = &addrs[0];
-				pbs_idx_find(cluster_leaves_idx, &paddr, (void **)&l, NULL);
+				l = find_cluster_leaf(&addrs[0]);
 				if (!l) {
 					found = 0;
 					l = (tpp_leaf_t *) calloc(1, sizeof(tpp_leaf_t));
@@ -1441,7 +1572,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 					if (!l || !l->leaf_addrs) {
 						free_leaf(l);
 						tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating leaf");
-						tpp_unlock(&router_lock);
+						route_wrunlock();
 						if (data_out)
 							free(data_out);
 						return -1;
@@ -1471,7 +1602,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 							 tfd, tpp_netaddr(&l->leaf_addrs[0]), l->conn_fd);
 						tpp_log_func(LOG_CRIT, NULL, tpp_get_logbuf());
 						tpp_transport_close(l->conn_fd);
-						tpp_unlock(&router_lock);
+						route_wrunlock();
 						if (data_out)
 							free(data_out);
 						return -1;
@@ -1507,7 +1638,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				if (i == -1) {
 					snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "tfd=%d, Leaf %s exists!", tfd, tpp_netaddr(&l->leaf_addrs[0]));
 					tpp_log_func(LOG_CRIT, NULL, tpp_get_logbuf());
-					tpp_unlock(&router_lock);
+					route_wrunlock();
 					if (data_out)
 						free(data_out);
 					return 0;
@@ -1517,7 +1648,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 					sprintf(tpp_get_logbuf(), "tfd=%d, Failed to add address %s to index of my leaves", tfd,
 							tpp_netaddr(&l->leaf_addrs[0]));
 					tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-					tpp_unlock(&router_lock);
+					route_wrunlock();
 					if (data_out)
 						free(data_out);
 					return -1;
@@ -1525,14 +1656,12 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 
 				if (found == 0) {
 					int fatal = 0;
-					/* add each address to the cluster_leaves_idx tree
+					/* add each address to the cluster leaves index
 					 * since this is the primary "routing table"
 					 */
 					for (i = 0; i < l->num_addrs; i++) {
-						if (pbs_idx_insert(cluster_leaves_idx, &l->leaf_addrs[i], l) != PBS_IDX_RET_OK) {
-							void *unused;
-							void *pleaf_addr = &l->leaf_addrs[i];
-							if (pbs_idx_find(cluster_leaves_idx, &pleaf_addr, &unused, NULL) == PBS_IDX_RET_OK) {
+						if (pbs_idx_insert(leaf_shard(&l->leaf_addrs[i])->idx, &l->leaf_addrs[i], l) != PBS_IDX_RET_OK) {
+							if (find_cluster_leaf(&l->leaf_addrs[i]) != NULL) {
 								int k;
 								sprintf(tpp_get_logbuf(), "tfd=%d, Failed to add address %s to cluster-leaves index "
 										"since address already exists, dropping duplicate",
@@ -1557,7 +1686,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 								"tfd=%d, Leaf %s had %s problem adding addresses, rejecting connection",
 								 tfd, tpp_netaddr(&l->leaf_addrs[0]), (fatal > 0)? "fatal" : "all duplicates");
 						tpp_log_func(LOG_CRIT, NULL, tpp_get_logbuf());
-						tpp_unlock(&router_lock);
+						route_wrunlock();
 						if (data_out)
 							free(data_out);
 						return -1;
@@ -1570,7 +1699,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 							sprintf(tpp_get_logbuf(), "tfd=%d, Failed to add address %s to notify-leaves index",
 									tfd, tpp_netaddr(&l->leaf_addrs[0]));
 							tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-							tpp_unlock(&router_lock);
+							route_wrunlock();
 							if (data_out)
 								free(data_out);
 							return -1;
@@ -1604,9 +1733,9 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 					 * broadcast JOIN pkt to other routers,
 					 * except from where it came from
 					 */
-					broadcast_to_my_routers(chunks, 1, tfd); /* this call will unlock the router_lock */
+					broadcast_to_my_routers(chunks, 1, tfd); /* this call will release the route locks */
 				} else {
-					tpp_unlock(&router_lock); /* unlock router_lock explicitly */
+					route_wrunlock(); /* release the route locks explicitly */
 				}
 				if (data_out)
 					free(data_out);
@@ -1650,19 +1779,19 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				tpp_leaf_t *l = NULL;
 				tpp_addr_t *src_addr = (tpp_addr_t *) (((char *) data) + sizeof(tpp_leave_pkt_hdr_t));
 
-				tpp_lock(&router_lock);
+				route_wrlock();
 
 				/* find the leaf context to pass to close handler */
-				pbs_idx_find(cluster_leaves_idx, (void **)&src_addr, (void **)&l, NULL);
+				l = find_cluster_leaf(src_addr);
 				if (!l) {
 					TPP_DBPRT(("No leaf %s found", tpp_netaddr(src_addr)));
-					tpp_unlock(&router_lock);
+					route_wrunlock();
 					if (data_out)
 						free(data_out);
 					return 0;
 				}
 
-				tpp_unlock(&router_lock);
+				route_wrunlock();
 
 				if ((ctx = (tpp_context_t *) malloc(sizeof(tpp_context_t))) == NULL) {
 					tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating tpp context");
@@ -1693,6 +1822,8 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				char *router_name;
 				void *cmpr_ctx;
 				void *minfo_buf; /* allocate size for total members */
+				unsigned int minfo_len; /* length of encoded members */
+				tpp_mcast_pkt_info_t prev; /* last member encoded */
 			} target_comm_struct_t;
 
 			target_comm_struct_t *rlist = NULL;
@@ -1706,6 +1837,9 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 			unsigned char orig_hop;
 			tpp_mcast_pkt_info_t *minfo;
 			void *minfo_base = NULL;
+			void *minfo_alloc = NULL;
+			char enc_minfo[TPP_MINFO_MAX_LEN];
+			int enc_len;
 			void *info_start = (char *) data + sizeof(tpp_mcast_pkt_hdr_t);
 			tpp_data_pkt_hdr_t shdr;
 			unsigned int payload_len;
@@ -1754,6 +1888,25 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				}
 			}
 #endif
+			if (cmprsd_len > 0)
+				minfo_alloc = minfo_base; /* allocated, to be freed */
+
+			if (mhdr->info_fmt == TPP_MINFO_FMT_COMPACT) {
+				minfo_base = tpp_minfo_decode(minfo_base, info_len, num_streams);
+				free(minfo_alloc);
+				minfo_alloc = minfo_base;
+				if (minfo_base == NULL) {
+					if (data_out)
+						free(data_out);
+					return -1;
+				}
+			} else if (info_len < num_streams * sizeof(tpp_mcast_pkt_info_t)) {
+				tpp_log_func(LOG_CRIT, __func__, "Corrupt mcast member info");
+				free(minfo_alloc);
+				if (data_out)
+					free(data_out);
+				return -1;
+			}
 
 			mhdr->hop = 1; /* set hop=1 to forward, use orig_hop for checking */
 
@@ -1767,7 +1920,6 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 			for (k = num_streams - 1; k >= 0; k--) {
 				tpp_addr_t *dest_host;
 				unsigned int src_sd;
-				tpp_leaf_t *l = NULL;
 
 				minfo = (tpp_mcast_pkt_info_t *)(((char *) minfo_base) + k * sizeof(tpp_mcast_pkt_info_t));
 
@@ -1776,21 +1928,16 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 
 				TPP_DBPRT(("MCAST data on fd=%u", src_sd));
 
-				tpp_lock(&router_lock);
-				pbs_idx_find(cluster_leaves_idx, (void **)&dest_host, (void **)&l, NULL);
-				if (l == NULL) {
+				/* find a router that is still connected */
+				target_router = route_to_leaf(dest_host, &leaf_found, &target_fd);
+				if (!leaf_found) {
 					char msg[TPP_LOGBUF_SZ];
-					tpp_unlock(&router_lock);
 					snprintf(msg, TPP_LOGBUF_SZ, "pbs_comm:%s: Dest not found at pbs_comm", tpp_netaddr(&this_router->router_addr));
 					log_noroute(src_host, dest_host, src_sd, msg);
 					tpp_send_ctl_msg(tfd, TPP_MSG_NOROUTE, src_host, dest_host, src_sd, 0, msg);
 					continue;
 				}
 
-				/* find a router that is still connected */
-				target_router = get_preferred_router(l, this_router, &target_fd);
-				tpp_unlock(&router_lock);
-
 				if (target_router == NULL) {
 					char msg[TPP_LOGBUF_SZ];
 					snprintf(msg, TPP_LOGBUF_SZ, "pbs_comm:%s: No target pbs_comm found", tpp_netaddr(&this_router->router_addr));
@@ -1816,8 +1963,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 						tpp_transport_close(target_fd);
 						if (rlist)
 							free(rlist);
-						if (cmprsd_len > 0)
-							free(minfo_base);
+						free(minfo_alloc);
 						if (data_out)
 							free(data_out);
 						return 0;
@@ -1860,11 +2006,12 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 
 						/* allocate minfo_buf for this target comm */
 						c_minfo_len = sizeof(tpp_mcast_pkt_info_t) * num_streams;
-						if (tpp_conf->compress == 1 && c_minfo_len > TPP_COMPR_SIZE) {
+						if (tpp_conf->compress == 1 && (unsigned int) c_minfo_len >= tpp_conf->compress_min_size) {
 							rlist[found].cmpr_ctx = tpp_multi_deflate_init(c_minfo_len);
 							if (rlist[found].cmpr_ctx == NULL)
 								goto mcast_err;
 						} else {
+							c_minfo_len = TPP_MINFO_MAX_LEN * num_streams;
 							rlist[found].minfo_buf = malloc(c_minfo_len);
 							if (!rlist[found].minfo_buf) {
 								snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating mcast buffer of %d bytes", c_minfo_len);
@@ -1875,16 +2022,21 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 					} /* if entry not found */
 
 					/* at this point to have the entry particular target comm */
-					/* copy (or compress) the minfo for the target leaf */
+					/* encode (and compress) the minfo for the target leaf */
+					if (tpp_conf->compact_mcast)
+						enc_len = tpp_minfo_encode(&rlist[found].prev, minfo, enc_minfo);
+					else {
+						memcpy(enc_minfo, minfo, sizeof(tpp_mcast_pkt_info_t));
+						enc_len = sizeof(tpp_mcast_pkt_info_t);
+					}
 					if (rlist[found].cmpr_ctx == NULL) { /* no compression */
-						tpp_mcast_pkt_info_t *c_minfo =
-							(tpp_mcast_pkt_info_t *)((char *) rlist[found].minfo_buf + (rlist[found].num_streams * sizeof(tpp_mcast_pkt_info_t)));
-						memcpy(c_minfo, minfo, sizeof(tpp_mcast_pkt_info_t));
+						memcpy((char *) rlist[found].minfo_buf + rlist[found].minfo_len, enc_minfo, enc_len);
 					} else {
-						if (tpp_multi_deflate_do(rlist[found].cmpr_ctx, 0, minfo, sizeof(tpp_mcast_pkt_info_t)) != 0)
+						if (tpp_multi_deflate_do(rlist[found].cmpr_ctx, 0, enc_minfo, enc_len) != 0)
 							goto mcast_err;
 					}
 
+					rlist[found].minfo_len += enc_len;
 					rlist[found].num_streams++;
 				}
 			} /* for k streams */
@@ -1894,6 +2046,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				/* header data */
 				memcpy(&t_mhdr, mhdr, sizeof(tpp_mcast_pkt_hdr_t)); /* only to satisfy valgrind */
 				t_mhdr.hop = 1;
+				t_mhdr.info_fmt = tpp_conf->compact_mcast ? TPP_MINFO_FMT_COMPACT : TPP_MINFO_FMT_FULL;
 
 				/* set the header chunk and data chunk one time for all target comms */
 				mchunks[0].data = &t_mhdr;
@@ -1911,7 +2064,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 					unsigned int t_minfo_len = 0;
 
 					t_mhdr.num_streams = htonl(rlist[k].num_streams);
-					t_minfo_len = rlist[k].num_streams * sizeof(tpp_mcast_pkt_info_t);
+					t_minfo_len = rlist[k].minfo_len;
 					t_mhdr.info_len = htonl(t_minfo_len);
 
 					/* the router information has been collected in rlist[k] */
@@ -1940,8 +2093,7 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				}
 			}
 mcast_err:
-			if (cmprsd_len > 0)
-				free(minfo_base);
+			free(minfo_alloc);
 
 			if (rlist) {
 				for (k = 0; k < csize; k++)
@@ -1960,7 +2112,6 @@ mcast_err:
 
 		case TPP_DATA:
 		case TPP_CLOSE_STRM: {
-			tpp_leaf_t *l = NULL;
 			tpp_addr_t *src_host, *dest_host;
 			unsigned int src_sd;
 			tpp_data_pkt_hdr_t *dhdr = (tpp_data_pkt_hdr_t *) data;
@@ -1969,12 +2120,10 @@ mcast_err:
 			dest_host = &dhdr->dest_addr;
 			src_sd = ntohl(dhdr->src_sd);
 
-			tpp_lock(&router_lock);
-
-			pbs_idx_find(cluster_leaves_idx, (void **)&dest_host, (void **)&l, NULL);
-			if (l == NULL) {
+			/* find a router that is still connected */
+			target_router = route_to_leaf(dest_host, &leaf_found, &target_fd);
+			if (!leaf_found) {
 				char msg[TPP_LOGBUF_SZ];
-				tpp_unlock(&router_lock);
 
 				snprintf(msg, TPP_LOGBUF_SZ, "tfd=%d, pbs_comm:%s: Dest not found", tfd, tpp_netaddr(&this_router->router_addr));
 				log_noroute(src_host, dest_host, src_sd, msg);
@@ -1984,10 +2133,6 @@ mcast_err:
 				return 0;
 			}
 
-			/* find a router that is still connected */
-			target_router = get_preferred_router(l, this_router, &target_fd);
-
-			tpp_unlock(&router_lock);
 			if (target_router == NULL) {
 				char msg[TPP_LOGBUF_SZ];
 				snprintf(msg, TPP_LOGBUF_SZ, "tfd=%d, pbs_comm:%s: No target pbs_comm found", tfd, tpp_netaddr(&this_router->router_addr));
@@ -2026,7 +2171,6 @@ mcast_err:
 
 		case TPP_CTL_MSG: {
 			tpp_ctl_pkt_hdr_t *ehdr = (tpp_ctl_pkt_hdr_t *) data;
-			tpp_leaf_t *l = NULL;
 			int subtype = ehdr->code;
 
 			if (subtype == TPP_MSG_NOROUTE) {
@@ -2040,19 +2184,12 @@ mcast_err:
 				tpp_log_func(LOG_WARNING, __func__, tpp_get_logbuf());
 
 				/* find the fd to forward to via the associated router */
-				tpp_lock(&router_lock);
-
-				pbs_idx_find(cluster_leaves_idx, (void **)&dest_host, (void **)&l, NULL);
-				if (l == NULL) {
-					tpp_unlock(&router_lock);
+				target_router = route_to_leaf(dest_host, &leaf_found, &target_fd);
+				if (!leaf_found) {
 					if (data_out)
 						free(data_out);
 					return 0;
 				}
-				/* find a router that is still connected */
-				target_router = get_preferred_router(l, this_router, &target_fd);
-
-				tpp_unlock(&router_lock);
 				if (target_router == NULL) {
 					snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "tfd=%d, No connections to send TPP_CTL_NOROUTE", tfd);
 					tpp_log_func(LOG_WARNING, NULL, tpp_get_logbuf());
@@ -2326,10 +2463,14 @@ tpp_init_router(struct tpp_config *cnf)
 		return -1;
 	}
 
-	cluster_leaves_idx = pbs_idx_create(0, sizeof(tpp_addr_t));
-	if (cluster_leaves_idx == NULL) {
-		tpp_log_func(LOG_CRIT, __func__, "Failed to create index for cluster leaves");
-		return -1;
+	for (j = 0; j < TPP_LEAF_SHARDS; j++) {
+		if (tpp_init_rwlock(&cluster_leaves[j].lock) != 0)
+			return -1;
+		cluster_leaves[j].idx = pbs_idx_create(0, sizeof(tpp_addr_t));
+		if (cluster_leaves[j].idx == NULL) {
+			tpp_log_func(LOG_CRIT, __func__, "Failed to create index for cluster leaves");
+			return -1;
+		}
 	}
 
 	my_leaves_notify_idx = pbs_idx_create(0, sizeof(tpp_addr_t));
@@ -2352,20 +2493,20 @@ tpp_init_router(struct tpp_config *cnf)
 
 	/* initiate connections to sister routers */
 	j = 0;
-	tpp_lock(&router_lock);
+	route_wrlock();
 	while (tpp_conf->routers && tpp_conf->routers[j]) {
 		/* add to connection table */
 
 		r = alloc_router(tpp_conf->routers[j], NULL);
 		if (!r) {
-			tpp_unlock(&router_lock);
+			route_wrunlock();
 			return -1; /* error already logged */
 		}
 		r->initiator = 1;
 
 		/* since we connected we should add a context */
 		if ((ctx = (tpp_context_t *) malloc(sizeof(tpp_context_t))) == NULL) {
-			tpp_unlock(&router_lock);
+			route_wrunlock();
 			tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating tpp context");
 			return -1;
 		}
@@ -2376,13 +2517,13 @@ tpp_init_router(struct tpp_config *cnf)
 		tpp_log_func(LOG_INFO, NULL, tpp_get_logbuf());
 
 		if (tpp_transport_connect(tpp_conf->routers[j], 0, ctx, &r->conn_fd) == -1) {
-			tpp_unlock(&router_lock);
+			route_wrunlock();
 			return -1;
 		}
 
 		j++;
 	}
-	tpp_unlock(&router_lock);
+	route_wrunlock();
 
 	sleep(1);
 	return 0;
@@ -192,6 +192,8 @@ typedef struct {
 	tpp_context_t *ctx;        /* upper layers context information */
 
 	void *extra;               /* extra data structure */
+
+	tpp_conn_stats_t stats;    /* transport statistics, lock free */
 } phy_conn_t;
 
 /* structure for holding an array of physical connection structures */
@@ -1495,6 +1497,7 @@ handle_cmd(thrd_data_t *td, int tfd, int cmd, void *data)
 			return;
 		}
 		conn->send_queue_size += pkt->len;
+		tpp_stat_max(&conn->stats.sendq_max, conn->send_queue_size);
 
 		/* handle socket add calls */
 		send_data(conn);
@@ -1993,6 +1996,7 @@ handle_incoming_data(phy_conn_t *conn)
 			torecv -= rc;
 			amt += rc;
 			conn->scratch.pos += rc;
+			TPP_STAT_ADD(conn->stats.bytes_recvd, rc);
 		}
 		rc = add_pkts(conn);
 		if (rc == -1) {
@@ -2057,6 +2061,7 @@ add_pkts(phy_conn_t *conn)
 			break;
 
 		data = pkt_start + sizeof(int);
+		TPP_STAT_INC(conn->stats.pkts_recvd);
 		if (the_pkt_handler) {
 			if ((rc = the_pkt_handler(conn->sock_fd, data, data_len, conn->ctx, conn->extra)) != 0) {
 				/* upper layer rejected data, disconnect */
@@ -2303,6 +2308,7 @@ send_data(phy_conn_t *conn)
 
 					/* set to cannot send data any more */
 					conn->can_send = 0;
+					TPP_STAT_INC(conn->stats.send_blocked);
 				} else {
 					handle_disconnect(conn);
 					return;
@@ -2313,10 +2319,12 @@ send_data(phy_conn_t *conn)
 			TPP_DBPRT(("tfd=%d, sending out %d bytes", conn->sock_fd, rc));
 			p->pos += rc;
 			tosend -= rc;
+			TPP_STAT_ADD(conn->stats.bytes_sent, rc);
 		}
 
 		if (tosend == 0) {
 			conn->send_queue_size -= p->len;
+			TPP_STAT_INC(conn->stats.pkts_sent);
 
 			if (the_pkt_postsend_handler)
 				the_pkt_postsend_handler(conn->sock_fd, p, conn->extra);
@@ -2500,6 +2508,54 @@ tpp_transport_get_conn_hostname(int tfd)
 	return NULL;
 }
 
+/**
+ * @brief
+ *	Log the statistics of each open physical connection
+ *
+ * @par Functionality:
+ *	The connections array is walked under cons_array_lock, so that no
+ *	connection is freed while it is being read. The counters themselves
+ *	are read without any lock.
+ *
+ * @par MT-safe: Yes
+ *
+ */
+void
+tpp_transport_stats_dump(void)
+{
+	int i;
+	phy_conn_t *conn;
+	tpp_addr_t *addr;
+	char host[TPP_MAXADDRLEN + 1];
+
+	if (tpp_lock(&cons_array_lock))
+		return;
+
+	for (i = 0; i < conns_array_size; i++) {
+		if (conns_array[i].slot_state != TPP_SLOT_BUSY || (conn = conns_array[i].conn) == NULL)
+			continue;
+
+		if ((addr = tpp_get_connected_host(conn->sock_fd)) != NULL) {
+			snprintf(host, sizeof(host), "%s", tpp_netaddr(addr));
+			free(addr);
+		} else if (conn->conn_params && conn->conn_params->hostname)
+			snprintf(host, sizeof(host), "%s", conn->conn_params->hostname);
+		else
+			strcpy(host, "unknown");
+
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ,
+			"Connection tfd=%d to %s: thread=%d sendq=%lu sendq_max=%lu send_blocked=%lu "
+			"pkts_sent=%lu pkts_recvd=%lu bytes_sent=%lu bytes_recvd=%lu",
+			conn->sock_fd, host, conn->td ? conn->td->thrd_index : -1,
+			conn->send_queue_size, conn->stats.sendq_max, conn->stats.send_blocked,
+			conn->stats.pkts_sent, conn->stats.pkts_recvd,
+			conn->stats.bytes_sent, conn->stats.bytes_recvd);
+		tpp_log_func(LOG_INFO, NULL, tpp_get_logbuf());
+	}
+
+	tpp_unlock(&cons_array_lock);
+}
+
 /**
  * @brief
  *	Function associates some extra structure with physical connection
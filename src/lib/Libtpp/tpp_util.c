@@ -61,6 +61,7 @@
 #include <netdb.h>
 #include <pthread.h>
 #include <sys/types.h>
+#include <sys/time.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -72,6 +73,15 @@
 #ifdef PBS_COMPRESSION_ENABLED
 #include <zlib.h>
 #endif
+#ifdef PBS_COMPRESSION_LZ4
+#include <lz4.h>
+#endif
+#ifdef PBS_COMPRESSION_ZSTD
+#include <zstd.h>
+#ifndef ZSTD_CLEVEL_DEFAULT
+#define ZSTD_CLEVEL_DEFAULT 3
+#endif
+#endif
 
 /*
  *	Global Variables
@@ -362,6 +372,31 @@ set_tpp_config(void (*log_fn)(int, const char *, char *), struct pbs_config *pbs
 #else
 	tpp_conf->compress = 0;
 #endif
+	tpp_conf->compress_algo = TPP_COMPR_ZLIB;
+	tpp_conf->compress_min_size = pbs_conf->pbs_compression_min_size;
+	tpp_conf->compress_dict = pbs_conf->pbs_compression_dict;
+	if (tpp_conf->compress && pbs_conf->pbs_compression_algo) {
+		int algo = tpp_compr_algo_from_name(pbs_conf->pbs_compression_algo);
+
+		if (algo == -1) {
+			snprintf(log_buffer, TPP_LOGBUF_SZ, "Compression algorithm %s is not supported, using %s",
+				pbs_conf->pbs_compression_algo, tpp_compr_algo_name(TPP_COMPR_ZLIB));
+			tpp_log_func(LOG_WARNING, NULL, log_buffer);
+		} else if (algo == TPP_COMPR_NONE)
+			tpp_conf->compress = 0;
+		else
+			tpp_conf->compress_algo = algo;
+	}
+	if (tpp_conf->compress) {
+		snprintf(log_buffer, TPP_LOGBUF_SZ, "TPP compression = %s, min size = %u bytes%s",
+			tpp_compr_algo_name(tpp_conf->compress_algo), tpp_conf->compress_min_size,
+			tpp_conf->compress_dict ? ", preset dictionary" : "");
+		tpp_log_func(LOG_INFO, NULL, log_buffer);
+	}
+
+	tpp_conf->compact_mcast = pbs_conf->pbs_tpp_compact_mcast;
+	if (tpp_conf->compact_mcast)
+		tpp_log_func(LOG_INFO, NULL, "TPP compact mcast member lists enabled");
 
 	/* set default parameters for keepalive */
 	tpp_conf->tcp_keepalive = 1;
@@ -1588,10 +1623,88 @@ tpp_get_logbuf()
 	return ptr->tpplogbuf;
 }
 
+static struct {
+	int algo;
+	char *name;
+} tpp_compr_algos[] = {
+	{TPP_COMPR_NONE, "none"},
+	{TPP_COMPR_ZLIB, "zlib"},
+#ifdef PBS_COMPRESSION_LZ4
+	{TPP_COMPR_LZ4, "lz4"},
+#endif
+#ifdef PBS_COMPRESSION_ZSTD
+	{TPP_COMPR_ZSTD, "zstd"},
+#endif
+	{-1, NULL}
+};
+
+/**
+ * @brief
+ *	Map the name of a compression algorithm to its TPP_COMPR_xxx code
+ *
+ * @param[in] name - name of the algorithm (none, zlib, lz4, zstd)
+ *
+ * @return - the algorithm code
+ * @retval -1 - unknown name, or support for the algorithm not compiled in
+ *
+ * @par MT-safe: Yes
+ */
+int
+tpp_compr_algo_from_name(char *name)
+{
+	int i;
+
+	for (i = 0; tpp_compr_algos[i].name; i++) {
+		if (strcasecmp(tpp_compr_algos[i].name, name) == 0)
+			return tpp_compr_algos[i].algo;
+	}
+	return -1;
+}
+
+/**
+ * @brief
+ *	Return the name of a compression algorithm, for logging
+ *
+ * @param[in] algo - TPP_COMPR_xxx code
+ *
+ * @return - name of the algorithm
+ *
+ * @par MT-safe: Yes
+ */
+char *
+tpp_compr_algo_name(int algo)
+{
+	int i;
+
+	for (i = 0; tpp_compr_algos[i].name; i++) {
+		if (tpp_compr_algos[i].algo == algo)
+			return tpp_compr_algos[i].name;
+	}
+	return "unknown";
+}
+
 #ifdef PBS_COMPRESSION_ENABLED
 
 #define COMPR_LEVEL Z_DEFAULT_COMPRESSION
 
+/*
+ * Preset dictionary used to prime the compressors when
+ * PBS_COMPRESSION_DICTIONARY is set. It holds strings that show up in almost
+ * every status and job update exchanged over TPP, the most frequent ones are
+ * kept towards the end since the codecs favor closer matches.
+ * Changing this breaks compatibility with daemons using the older dictionary.
+ */
+static const char tpp_compr_dict[] =
+	"Job_Name Job_Owner job_state queue server Checkpoint Error_Path Output_Path "
+	"Hold_Types Join_Path Keep_Files Mail_Points Priority Rerunable Variable_List "
+	"PBS_O_HOME PBS_O_LANG PBS_O_LOGNAME PBS_O_PATH PBS_O_SHELL PBS_O_WORKDIR "
+	"PBS_O_HOST PBS_O_SYSTEM PBS_O_QUEUE euser egroup session_id Exit_status "
+	"run_count substate ctime mtime qtime etime stime project "
+	"resources_available resources_assigned sharing default_shared ntype PBS "
+	"state free job-busy job-exclusive offline down pcpus arch linux host vnode "
+	"jobs exec_host exec_vnode Resource_List nodect place select "
+	"resources_used cpupercent cput mem vmem walltime ncpus ";
+
 struct def_ctx {
 	z_stream cmpr_strm;
 	void *cmpr_buf;
@@ -1757,6 +1870,7 @@ tpp_multi_deflate_done(void *c, unsigned int *cmpr_len)
  * @param[in] inbuf   - Ptr to buffer to compress
  * @param[in] inlen   - The size of input buffer
  * @param[out] outlen - The size of the compressed data
+ * @param[in] use_dict - Prime the stream with the preset dictionary
  *
  * @return      - Ptr to the compressed data buffer
  * @retval  !NULL - Success
@@ -1765,7 +1879,7 @@ tpp_multi_deflate_done(void *c, unsigned int *cmpr_len)
  * @par MT-safe: No
  **/
 void *
-tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
+tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen, int use_dict)
 {
 	z_stream strm;
 	int ret;
@@ -1785,6 +1899,11 @@ tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
 		tpp_log_func(LOG_CRIT, __func__, "Compression failed");
 		return NULL;
 	}
+	if (use_dict && deflateSetDictionary(&strm, (const Bytef *) tpp_compr_dict, sizeof(tpp_compr_dict) - 1) != Z_OK) {
+		deflateEnd(&strm);
+		tpp_log_func(LOG_CRIT, __func__, "Setting compression dictionary failed");
+		return NULL;
+	}
 
 	/* set input data to be compressed */
 	len = inlen;
@@ -1903,6 +2022,12 @@ tpp_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
 	strm.avail_out = totlen;
 	strm.next_out = outbuf;
 	ret = inflate(&strm, Z_FINISH);
+	if (ret == Z_NEED_DICT) {
+		/* sender primed the stream with the preset dictionary */
+		ret = inflateSetDictionary(&strm, (const Bytef *) tpp_compr_dict, sizeof(tpp_compr_dict) - 1);
+		if (ret == Z_OK)
+			ret = inflate(&strm, Z_FINISH);
+	}
 	inflateEnd(&strm);
 	if (ret != Z_STREAM_END) {
 		free(outbuf);
@@ -1912,6 +2037,282 @@ tpp_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
 	}
 	return outbuf;
 }
+
+#ifdef PBS_COMPRESSION_LZ4
+static LZ4_stream_t tpp_lz4_dict_stream;	/* stream primed with tpp_compr_dict */
+static pthread_once_t tpp_lz4_dict_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Prime the process wide lz4 dictionary stream, called once
+ **/
+static void
+tpp_lz4_dict_init(void)
+{
+	LZ4_resetStream(&tpp_lz4_dict_stream);
+	LZ4_loadDict(&tpp_lz4_dict_stream, tpp_compr_dict, sizeof(tpp_compr_dict) - 1);
+}
+
+/**
+ * @brief LZ4 compress data, the result is prefixed by the LZ4 tag byte
+ *
+ * @par Functionality:
+ *	The lz4 stream lives in the thread's TLS and is reused for every
+ *	message. When the dictionary is used, the stream is reset by copying
+ *	the primed dictionary stream over it, which is cheaper than hashing
+ *	the dictionary again with LZ4_loadDict.
+ *
+ * @param[in] inbuf   - Ptr to buffer to compress
+ * @param[in] inlen   - The size of input buffer
+ * @param[out] outlen - The size of the compressed data, including the tag
+ * @param[in] use_dict - Use the preset dictionary
+ *
+ * @return      - Ptr to the compressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: Yes
+ **/
+static void *
+tpp_lz4_compress(void *inbuf, unsigned int inlen, unsigned int *outlen, int use_dict)
+{
+	char *data;
+	int bound;
+	int ret;
+	tpp_tls_t *tls;
+
+	if ((tls = tpp_get_tls()) == NULL) {
+		tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating tls");
+		return NULL;
+	}
+	if (tls->lz4_stream == NULL && (tls->lz4_stream = LZ4_createStream()) == NULL) {
+		tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating lz4 stream");
+		return NULL;
+	}
+
+	bound = LZ4_compressBound(inlen);
+	if (bound <= 0 || (data = malloc(bound + 1)) == NULL) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating lz4 buffer %d bytes", bound + 1);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	if (use_dict) {
+		pthread_once(&tpp_lz4_dict_once, tpp_lz4_dict_init);
+		memcpy(tls->lz4_stream, &tpp_lz4_dict_stream, sizeof(LZ4_stream_t));
+		ret = LZ4_compress_fast_continue(tls->lz4_stream, inbuf, data + 1, inlen, bound, 1);
+		data[0] = (char) (TPP_COMPR_TAG_LZ4 | TPP_COMPR_TAG_DICT);
+	} else {
+		ret = LZ4_compress_fast_extState(tls->lz4_stream, inbuf, data + 1, inlen, bound, 1);
+		data[0] = (char) TPP_COMPR_TAG_LZ4;
+	}
+	if (ret <= 0) {
+		free(data);
+		tpp_log_func(LOG_CRIT, __func__, "lz4 compression failed");
+		return NULL;
+	}
+	*outlen = ret + 1;
+	return data;
+}
+#endif
+
+#ifdef PBS_COMPRESSION_ZSTD
+static ZSTD_CDict *tpp_zstd_cdict;	/* digested tpp_compr_dict for compression */
+static ZSTD_DDict *tpp_zstd_ddict;	/* digested tpp_compr_dict for decompression */
+static pthread_once_t tpp_zstd_dict_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Digest the preset dictionary for zstd, called once
+ **/
+static void
+tpp_zstd_dict_init(void)
+{
+	tpp_zstd_cdict = ZSTD_createCDict(tpp_compr_dict, sizeof(tpp_compr_dict) - 1, ZSTD_CLEVEL_DEFAULT);
+	tpp_zstd_ddict = ZSTD_createDDict(tpp_compr_dict, sizeof(tpp_compr_dict) - 1);
+}
+
+/**
+ * @brief zstd compress data, the result is prefixed by the zstd tag byte
+ *
+ * @param[in] inbuf   - Ptr to buffer to compress
+ * @param[in] inlen   - The size of input buffer
+ * @param[out] outlen - The size of the compressed data, including the tag
+ * @param[in] use_dict - Use the preset dictionary
+ *
+ * @return      - Ptr to the compressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: Yes
+ **/
+static void *
+tpp_zstd_compress(void *inbuf, unsigned int inlen, unsigned int *outlen, int use_dict)
+{
+	char *data;
+	size_t bound;
+	size_t ret;
+	tpp_tls_t *tls;
+
+	if ((tls = tpp_get_tls()) == NULL) {
+		tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating tls");
+		return NULL;
+	}
+	if (tls->zstd_cctx == NULL && (tls->zstd_cctx = ZSTD_createCCtx()) == NULL) {
+		tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating zstd context");
+		return NULL;
+	}
+	if (use_dict) {
+		pthread_once(&tpp_zstd_dict_once, tpp_zstd_dict_init);
+		if (tpp_zstd_cdict == NULL) {
+			tpp_log_func(LOG_CRIT, __func__, "Out of memory allocating zstd dictionary");
+			return NULL;
+		}
+	}
+
+	bound = ZSTD_compressBound(inlen);
+	if ((data = malloc(bound + 1)) == NULL) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating zstd buffer %lu bytes", (unsigned long) bound + 1);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	if (use_dict) {
+		ret = ZSTD_compress_usingCDict(tls->zstd_cctx, data + 1, bound, inbuf, inlen, tpp_zstd_cdict);
+		data[0] = (char) (TPP_COMPR_TAG_ZSTD | TPP_COMPR_TAG_DICT);
+	} else {
+		ret = ZSTD_compressCCtx(tls->zstd_cctx, data + 1, bound, inbuf, inlen, ZSTD_CLEVEL_DEFAULT);
+		data[0] = (char) TPP_COMPR_TAG_ZSTD;
+	}
+	if (ZSTD_isError(ret)) {
+		free(data);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "zstd compression failed, %s", ZSTD_getErrorName(ret));
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+	*outlen = ret + 1;
+	return data;
+}
+#endif
+
+/**
+ * @brief Compress data with the given codec
+ *
+ * @par Functionality:
+ *	The caller is expected to compare outlen with inlen and send the data
+ *	uncompressed if the codec did not manage to shrink it.
+ *
+ * @param[in] algo    - TPP_COMPR_xxx codec to use
+ * @param[in] use_dict - Prime the codec with the preset dictionary
+ * @param[in] inbuf   - Ptr to buffer to compress
+ * @param[in] inlen   - The size of input buffer
+ * @param[out] outlen - The size of the compressed data
+ *
+ * @return      - Ptr to the compressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: No
+ **/
+void *
+tpp_compress(int algo, int use_dict, void *inbuf, unsigned int inlen, unsigned int *outlen)
+{
+	*outlen = 0;
+	switch (algo) {
+#ifdef PBS_COMPRESSION_LZ4
+		case TPP_COMPR_LZ4:
+			return tpp_lz4_compress(inbuf, inlen, outlen, use_dict);
+#endif
+#ifdef PBS_COMPRESSION_ZSTD
+		case TPP_COMPR_ZSTD:
+			return tpp_zstd_compress(inbuf, inlen, outlen, use_dict);
+#endif
+		default:
+			return tpp_deflate(inbuf, inlen, outlen, use_dict);
+	}
+}
+
+/**
+ * @brief Decompress data compressed by tpp_compress
+ *
+ * @par Functionality:
+ *	Identifies the codec from the first byte of the data. A zlib stream
+ *	always has Z_DEFLATED in the low nibble of its first byte, which none
+ *	of the tags of the other codecs have.
+ *
+ * @param[in] inbuf  - Ptr to compress data buffer
+ * @param[in] inlen  - The size of input buffer
+ * @param[in] totlen - The total size of the uncompress data
+ *
+ * @return      - Ptr to the uncompressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: No
+ **/
+void *
+tpp_decompress(void *inbuf, unsigned int inlen, unsigned int totlen)
+{
+	unsigned char tag;
+	char *outbuf;
+
+	if (inlen == 0)
+		return NULL;
+
+	tag = *((unsigned char *) inbuf);
+	if ((tag & 0x0f) == Z_DEFLATED)
+		return tpp_inflate(inbuf, inlen, totlen);
+
+	if ((outbuf = malloc(totlen)) == NULL) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating inflate buffer %d bytes", totlen);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	switch (tag & ~TPP_COMPR_TAG_DICT) {
+#ifdef PBS_COMPRESSION_LZ4
+		case TPP_COMPR_TAG_LZ4: {
+			int ret;
+
+			if (tag & TPP_COMPR_TAG_DICT)
+				ret = LZ4_decompress_safe_usingDict((char *) inbuf + 1, outbuf, inlen - 1, totlen,
+					tpp_compr_dict, sizeof(tpp_compr_dict) - 1);
+			else
+				ret = LZ4_decompress_safe((char *) inbuf + 1, outbuf, inlen - 1, totlen);
+			if (ret == (int) totlen)
+				return outbuf;
+			break;
+		}
+#endif
+#ifdef PBS_COMPRESSION_ZSTD
+		case TPP_COMPR_TAG_ZSTD: {
+			size_t ret;
+			tpp_tls_t *tls;
+
+			if ((tls = tpp_get_tls()) == NULL)
+				break;
+			if (tls->zstd_dctx == NULL && (tls->zstd_dctx = ZSTD_createDCtx()) == NULL)
+				break;
+			if (tag & TPP_COMPR_TAG_DICT) {
+				pthread_once(&tpp_zstd_dict_once, tpp_zstd_dict_init);
+				if (tpp_zstd_ddict == NULL)
+					break;
+				ret = ZSTD_decompress_usingDDict(tls->zstd_dctx, outbuf, totlen, (char *) inbuf + 1, inlen - 1,
+					tpp_zstd_ddict);
+			} else
+				ret = ZSTD_decompressDCtx(tls->zstd_dctx, outbuf, totlen, (char *) inbuf + 1, inlen - 1);
+			if (!ZSTD_isError(ret) && ret == totlen)
+				return outbuf;
+			break;
+		}
+#endif
+		default:
+			break;
+	}
+
+	free(outbuf);
+	snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Decompression failed, codec tag 0x%x", tag);
+	tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+	return NULL;
+}
 #else
 void *
 tpp_multi_deflate_init(int initial_len)
@@ -1935,7 +2336,21 @@ tpp_multi_deflate_done(void *c, unsigned int *cmpr_len)
 }
 
 void *
-tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
+tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen, int use_dict)
+{
+	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
+	return NULL;
+}
+
+void *
+tpp_compress(int algo, int use_dict, void *inbuf, unsigned int inlen, unsigned int *outlen)
+{
+	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
+	return NULL;
+}
+
+void *
+tpp_decompress(void *inbuf, unsigned int inlen, unsigned int totlen)
 {
 	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
 	return NULL;
@@ -2177,6 +2592,292 @@ tpp_get_connected_host(int sock)
 	return taddr;
 }
 
+/* totals of the stream statistics of this process, including closed streams */
+tpp_strm_stats_t tpp_strm_totals;
+
+/* set by the leaf library, to dump the statistics of each open stream */
+void (*tpp_strm_stats_func)(void) = NULL;
+
+/**
+ * @brief
+ *	Raise a statistics high water mark, without a lock
+ *
+ * @param[in,out] c - The high water mark counter
+ * @param[in] val - The current value
+ *
+ * @par MT-safe: Yes
+ */
+void
+tpp_stat_max(unsigned long *c, unsigned long val)
+{
+	unsigned long old;
+
+	while ((old = *c) < val) {
+		if (__sync_bool_compare_and_swap(c, old, val))
+			break;
+	}
+}
+
+/**
+ * @brief
+ *	Current time in milliseconds, for latency measurements
+ *
+ * @return - milliseconds since the epoch
+ *
+ * @par MT-safe: Yes
+ */
+unsigned long
+tpp_stats_now_ms(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return ((unsigned long) tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+/**
+ * @brief
+ *	Record an ack latency in the stream histogram and in the totals
+ *
+ * @param[in] st - The stream statistics
+ * @param[in] ms - The latency in milliseconds
+ *
+ * @par MT-safe: Yes
+ */
+void
+tpp_stats_ack_latency(tpp_strm_stats_t *st, unsigned long ms)
+{
+	int i = 0;
+
+	while (i < TPP_STATS_BUCKETS - 1 && ms >= (1UL << i))
+		i++;
+
+	TPP_STAT_INC(st->acks);
+	TPP_STAT_INC(st->ack_lat[i]);
+	TPP_STAT_INC(tpp_strm_totals.acks);
+	TPP_STAT_INC(tpp_strm_totals.ack_lat[i]);
+}
+
+/**
+ * @brief
+ *	Format stream statistics for logging
+ *
+ * @param[in] st - The stream statistics
+ * @param[out] buf - Buffer to format into
+ * @param[in] len - Size of buf
+ *
+ * @return - buf
+ *
+ * @par MT-safe: Yes
+ */
+char *
+tpp_stats_strm_str(tpp_strm_stats_t *st, char *buf, size_t len)
+{
+	int i;
+	size_t n;
+
+	n = snprintf(buf, len, "sent=%lu recvd=%lu shelved=%lu retries=%lu acks=%lu",
+		st->pkts_sent, st->pkts_recvd, st->shelved, st->retries, st->acks);
+	if (st->raw_bytes > 0 && n < len)
+		n += snprintf(buf + n, len - n, " compression=%lu/%lu (%.1f%%)",
+			st->cmpr_bytes, st->raw_bytes, 100.0 * st->cmpr_bytes / st->raw_bytes);
+	if (st->acks > 0) {
+		for (i = 0; i < TPP_STATS_BUCKETS && n < len; i++) {
+			if (i < TPP_STATS_BUCKETS - 1)
+				n += snprintf(buf + n, len - n, "%s<%lums:%lu", (i == 0) ? " ack_latency " : ",",
+					1UL << i, st->ack_lat[i]);
+			else
+				n += snprintf(buf + n, len - n, ",more:%lu", st->ack_lat[i]);
+		}
+	}
+	return buf;
+}
+
+/**
+ * @brief
+ *	Log the transport statistics of this process: per physical connection,
+ *	and for a leaf the totals and per stream statistics as well.
+ *
+ * @par MT-safe: Yes
+ */
+void
+tpp_stats_dump(void)
+{
+	char buf[TPP_LOGBUF_SZ];
+
+	tpp_transport_stats_dump();
+
+	if (tpp_strm_stats_func) {
+		tpp_stats_strm_str(&tpp_strm_totals, buf, sizeof(buf));
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Stream totals: %s", buf);
+		tpp_log_func(LOG_INFO, NULL, tpp_get_logbuf());
+		tpp_strm_stats_func();
+	}
+}
+
+/**
+ * @brief
+ *	Encode the info of a mcast member in the compact format, with only
+ *	the fields that differ from the previous member.
+ *
+ * @param[in,out] prev - The previous member, updated to the current one
+ * @param[in] cur - The member to encode
+ * @param[out] buf - Buffer of at least TPP_MINFO_MAX_LEN bytes
+ *
+ * @return - Number of bytes written to buf
+ *
+ * @par MT-safe: Yes
+ */
+int
+tpp_minfo_encode(tpp_mcast_pkt_info_t *prev, tpp_mcast_pkt_info_t *cur, char *buf)
+{
+	unsigned char flags = 0;
+	char *p = buf + 1;
+
+	if (ntohl(cur->src_sd) != ntohl(prev->src_sd) + 1) {
+		flags |= TPP_MINFO_SRC_SD;
+		memcpy(p, &cur->src_sd, sizeof(int));
+		p += sizeof(int);
+	}
+	if (cur->src_magic != prev->src_magic) {
+		flags |= TPP_MINFO_SRC_MAGIC;
+		memcpy(p, &cur->src_magic, sizeof(int));
+		p += sizeof(int);
+	}
+	if (cur->dest_sd != prev->dest_sd) {
+		flags |= TPP_MINFO_DEST_SD;
+		memcpy(p, &cur->dest_sd, sizeof(int));
+		p += sizeof(int);
+	}
+	if (cur->seq_no != prev->seq_no) {
+		flags |= TPP_MINFO_SEQ_NO;
+		memcpy(p, &cur->seq_no, sizeof(int));
+		p += sizeof(int);
+	}
+	if (cur->dest_addr.ip[0] != prev->dest_addr.ip[0]) {
+		flags |= TPP_MINFO_IP;
+		memcpy(p, &cur->dest_addr.ip[0], sizeof(int));
+		p += sizeof(int);
+	}
+	if (memcmp(&cur->dest_addr.ip[1], &prev->dest_addr.ip[1], 3 * sizeof(int)) != 0) {
+		flags |= TPP_MINFO_IP6;
+		memcpy(p, &cur->dest_addr.ip[1], 3 * sizeof(int));
+		p += 3 * sizeof(int);
+	}
+	if (cur->dest_addr.port != prev->dest_addr.port) {
+		flags |= TPP_MINFO_PORT;
+		memcpy(p, &cur->dest_addr.port, sizeof(short));
+		p += sizeof(short);
+	}
+	if (cur->dest_addr.family != prev->dest_addr.family) {
+		flags |= TPP_MINFO_FAMILY;
+		*p++ = cur->dest_addr.family;
+	}
+	*buf = (char) flags;
+
+	memcpy(prev, cur, sizeof(tpp_mcast_pkt_info_t));
+	return (p - buf);
+}
+
+/**
+ * @brief
+ *	Decode the compact format member info of a mcast packet
+ *
+ * @param[in] buf - The encoded member info
+ * @param[in] len - Length of the encoded member info
+ * @param[in] num - Number of members encoded
+ *
+ * @return - Array of num member info structures, to be freed by caller
+ * @retval NULL - Failure (corrupt member info or out of memory)
+ *
+ * @par MT-safe: Yes
+ */
+tpp_mcast_pkt_info_t *
+tpp_minfo_decode(void *buf, unsigned int len, unsigned int num)
+{
+	tpp_mcast_pkt_info_t *minfo;
+	tpp_mcast_pkt_info_t prev;
+	unsigned char *p = buf;
+	unsigned char *end = p + len;
+	unsigned char flags;
+	unsigned int need;
+	unsigned int i;
+
+	if ((minfo = malloc(num * sizeof(tpp_mcast_pkt_info_t) + 1)) == NULL) {
+		tpp_log_func(LOG_CRIT, __func__, "Out of memory decoding mcast member info");
+		return NULL;
+	}
+
+	memset(&prev, 0, sizeof(prev));
+	for (i = 0; i < num; i++) {
+		if (p >= end)
+			goto err;
+		flags = *p++;
+
+		/* check the length up front, so the fields below need no checks */
+		need = 0;
+		if (flags & TPP_MINFO_SRC_SD)
+			need += sizeof(int);
+		if (flags & TPP_MINFO_SRC_MAGIC)
+			need += sizeof(int);
+		if (flags & TPP_MINFO_DEST_SD)
+			need += sizeof(int);
+		if (flags & TPP_MINFO_SEQ_NO)
+			need += sizeof(int);
+		if (flags & TPP_MINFO_IP)
+			need += sizeof(int);
+		if (flags & TPP_MINFO_IP6)
+			need += 3 * sizeof(int);
+		if (flags & TPP_MINFO_PORT)
+			need += sizeof(short);
+		if (flags & TPP_MINFO_FAMILY)
+			need += sizeof(char);
+		if ((unsigned int) (end - p) < need)
+			goto err;
+
+		if (flags & TPP_MINFO_SRC_SD) {
+			memcpy(&prev.src_sd, p, sizeof(int));
+			p += sizeof(int);
+		} else
+			prev.src_sd = htonl(ntohl(prev.src_sd) + 1);
+		if (flags & TPP_MINFO_SRC_MAGIC) {
+			memcpy(&prev.src_magic, p, sizeof(int));
+			p += sizeof(int);
+		}
+		if (flags & TPP_MINFO_DEST_SD) {
+			memcpy(&prev.dest_sd, p, sizeof(int));
+			p += sizeof(int);
+		}
+		if (flags & TPP_MINFO_SEQ_NO) {
+			memcpy(&prev.seq_no, p, sizeof(int));
+			p += sizeof(int);
+		}
+		if (flags & TPP_MINFO_IP) {
+			memcpy(&prev.dest_addr.ip[0], p, sizeof(int));
+			p += sizeof(int);
+		}
+		if (flags & TPP_MINFO_IP6) {
+			memcpy(&prev.dest_addr.ip[1], p, 3 * sizeof(int));
+			p += 3 * sizeof(int);
+		}
+		if (flags & TPP_MINFO_PORT) {
+			memcpy(&prev.dest_addr.port, p, sizeof(short));
+			p += sizeof(short);
+		}
+		if (flags & TPP_MINFO_FAMILY)
+			prev.dest_addr.family = (char) *p++;
+
+		memcpy(&minfo[i], &prev, sizeof(tpp_mcast_pkt_info_t));
+	}
+	if (p == end)
+		return minfo;
+
+err:
+	free(minfo);
+	tpp_log_func(LOG_CRIT, __func__, "Corrupt mcast member info");
+	return NULL;
+}
+
 /**
  * @brief return a human readable string representation of an address
  *        for either an ipv4 or ipv6 address
@@ -39,16 +39,284 @@
 
 #include "pbs_idx.h"
 #include "avltree.h"
+#include <ctype.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ * Hash backend (PBS_IDX_HASH): open addressing with linear probing over
+ * an array of slots, each keeping the key's full hash so that probing
+ * only dereferences a key when the hashes already match.  Deleted slots
+ * become tombstones (so deleting while iterating is safe) and are
+ * dropped the next time the table is rebuilt on insert.
+ */
+#define HASH_IDX_MIN_SIZE 64
+
+typedef struct _hash_slot {
+	size_t hash;	/* full hash of key */
+	void *key;	/* copy of key, NULL if empty, hash_tomb if deleted */
+	void *data;
+} hash_slot;
+
+typedef struct _hash_idx {
+	hash_slot *slots;
+	size_t size;	/* number of slots, a power of 2 */
+	size_t count;	/* live entries */
+	size_t tombs;	/* deleted entries still occupying slots */
+} hash_idx;
+
+/* index descriptor, avl must stay first as the index is passed to avl_* */
+typedef struct _pbs_idx {
+	AVL_IX_DESC avl;
+	hash_idx *hash;	/* non-NULL for PBS_IDX_HASH indexes */
+} pbs_idx;
+
+static char hash_tomb[1];
+
 /* iteration context structure, opaque to application */
 typedef struct _iter_ctx {
 	AVL_IX_DESC *idx; /* pointer to idx */
 	AVL_IX_REC *pkey; /* pointer to key used while iteration */
+	size_t pos;	  /* current slot, for hash indexes */
 } iter_ctx;
 
+/**
+ * @brief
+ *	Hash a key of the given index (FNV-1a)
+ *
+ * @param[in] - idx - pointer to index
+ * @param[in] - key - key to hash
+ *
+ * @return size_t - hash of key
+ */
+static size_t
+hash_idx_hash(pbs_idx *idx, const void *key)
+{
+	const unsigned char *p = key;
+	size_t h = 14695981039346656037ULL;
+	int i;
+
+	if (idx->avl.keylength) {
+		for (i = 0; i < idx->avl.keylength; i++) {
+			h ^= p[i];
+			h *= 1099511628211ULL;
+		}
+	} else if (idx->avl.flags & PBS_IDX_ICASE_CMP) {
+		for (; *p; p++) {
+			h ^= (unsigned char) tolower(*p);
+			h *= 1099511628211ULL;
+		}
+	} else {
+		for (; *p; p++) {
+			h ^= *p;
+			h *= 1099511628211ULL;
+		}
+	}
+	return h;
+}
+
+/**
+ * @brief
+ *	Compare two keys of the given index
+ *
+ * @return int - 0 if equal
+ */
+static int
+hash_idx_keycmp(pbs_idx *idx, const void *k1, const void *k2)
+{
+	if (idx->avl.keylength)
+		return memcmp(k1, k2, idx->avl.keylength);
+	if (idx->avl.flags & PBS_IDX_ICASE_CMP)
+		return strcasecmp(k1, k2);
+	return strcmp(k1, k2);
+}
+
+/**
+ * @brief
+ *	Find the slot holding key in a hash index
+ *
+ * @return hash_slot * - the slot, or NULL if key is not in index
+ */
+static hash_slot *
+hash_idx_lookup(pbs_idx *idx, const void *key)
+{
+	hash_idx *ht = idx->hash;
+	size_t h = hash_idx_hash(idx, key);
+	size_t mask = ht->size - 1;
+	size_t i;
+	hash_slot *slot;
+
+	for (i = h & mask;; i = (i + 1) & mask) {
+		slot = &ht->slots[i];
+		if (slot->key == NULL)
+			return NULL;
+		if (slot->key != hash_tomb && slot->hash == h &&
+				hash_idx_keycmp(idx, slot->key, key) == 0)
+			return slot;
+	}
+}
+
+/**
+ * @brief
+ *	Rebuild a hash index into a table of the given size, dropping tombstones
+ *
+ * @return int
+ * @retval  0 - success
+ * @retval -1 - out of memory
+ */
+static int
+hash_idx_resize(hash_idx *ht, size_t size)
+{
+	hash_slot *slots;
+	size_t mask = size - 1;
+	size_t i;
+	size_t j;
+
+	slots = calloc(size, sizeof(hash_slot));
+	if (slots == NULL)
+		return -1;
+
+	for (i = 0; i < ht->size; i++) {
+		if (ht->slots[i].key == NULL || ht->slots[i].key == hash_tomb)
+			continue;
+		for (j = ht->slots[i].hash & mask; slots[j].key != NULL; j = (j + 1) & mask)
+			;
+		slots[j] = ht->slots[i];
+	}
+	free(ht->slots);
+	ht->slots = slots;
+	ht->size = size;
+	ht->tombs = 0;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Add an entry to a hash index
+ *
+ * @return int
+ * @retval PBS_IDX_RET_OK   - success
+ * @retval PBS_IDX_RET_FAIL - duplicate key or out of memory
+ */
+static int
+hash_idx_insert(pbs_idx *idx, void *key, void *data)
+{
+	hash_idx *ht = idx->hash;
+	size_t h;
+	size_t mask;
+	size_t i;
+	size_t size;
+	size_t klen;
+	void *kcopy;
+
+	if (hash_idx_lookup(idx, key) != NULL)
+		return PBS_IDX_RET_FAIL;
+
+	/* keep the table at most 3/4 full, counting tombstones */
+	if ((ht->count + ht->tombs + 1) * 4 > ht->size * 3) {
+		for (size = ht->size; (ht->count + 1) * 2 > size; size <<= 1)
+			;
+		if (hash_idx_resize(ht, size) != 0)
+			return PBS_IDX_RET_FAIL;
+	}
+
+	klen = idx->avl.keylength ? (size_t) idx->avl.keylength : strlen(key) + 1;
+	if ((kcopy = malloc(klen)) == NULL)
+		return PBS_IDX_RET_FAIL;
+	memcpy(kcopy, key, klen);
+
+	h = hash_idx_hash(idx, key);
+	mask = ht->size - 1;
+	for (i = h & mask; ht->slots[i].key != NULL && ht->slots[i].key != hash_tomb; i = (i + 1) & mask)
+		;
+	if (ht->slots[i].key == hash_tomb)
+		ht->tombs--;
+	ht->slots[i].hash = h;
+	ht->slots[i].key = kcopy;
+	ht->slots[i].data = data;
+	ht->count++;
+	return PBS_IDX_RET_OK;
+}
+
+/**
+ * @brief
+ *	Remove the entry in the given slot of a hash index
+ */
+static void
+hash_idx_remove(hash_idx *ht, hash_slot *slot)
+{
+	free(slot->key);
+	slot->key = hash_tomb;
+	slot->data = NULL;
+	ht->count--;
+	ht->tombs++;
+}
+
+/**
+ * @brief
+ *	Return the first live slot at or after pos in a hash index
+ *
+ * @return size_t - slot number, or ht->size if there is none
+ */
+static size_t
+hash_idx_next(hash_idx *ht, size_t pos)
+{
+	for (; pos < ht->size; pos++) {
+		if (ht->slots[pos].key != NULL && ht->slots[pos].key != hash_tomb)
+			break;
+	}
+	return pos;
+}
+
+/**
+ * @brief
+ *	pbs_idx_find() for a hash index
+ */
+static int
+hash_idx_find(pbs_idx *idx, void **key, void **data, void **ctx)
+{
+	hash_idx *ht = idx->hash;
+	hash_slot *slot;
+	iter_ctx *pctx;
+	size_t pos;
+
+	*data = NULL;
+
+	if (ctx != NULL && *ctx != NULL) {
+		pctx = (iter_ctx *) *ctx;
+		if (key)
+			*key = NULL;
+		if (pctx->idx != &idx->avl)
+			return PBS_IDX_RET_FAIL;
+		pos = hash_idx_next(ht, pctx->pos + 1);
+	} else if (key != NULL && *key != NULL) {
+		if ((slot = hash_idx_lookup(idx, *key)) == NULL)
+			return PBS_IDX_RET_FAIL;
+		pos = slot - ht->slots;
+	} else
+		pos = hash_idx_next(ht, 0);
+
+	if (pos >= ht->size)
+		return PBS_IDX_RET_FAIL;
+
+	*data = ht->slots[pos].data;
+	if (key != NULL && *key == NULL)
+		*key = ht->slots[pos].key;
+
+	if (ctx != NULL) {
+		if (*ctx == NULL) {
+			if ((pctx = malloc(sizeof(iter_ctx))) == NULL)
+				return PBS_IDX_RET_FAIL;
+			pctx->idx = &idx->avl;
+			pctx->pkey = NULL;
+			*ctx = (void *) pctx;
+		}
+		((iter_ctx *) *ctx)->pos = pos;
+	}
+	return PBS_IDX_RET_OK;
+}
+
 /**
  * @brief
  *	Create an empty index
@@ -60,21 +328,38 @@ typedef struct _iter_ctx {
  * @retval !NULL - success
  * @retval NULL  - failure
  *
+ * @note
+ *	PBS_IDX_HASH is ignored together with PBS_IDX_DUPS_OK, such an
+ *	index is always a tree.
+ *
  */
 void *
 pbs_idx_create(int flags, int keylen)
 {
-	void *idx = NULL;
+	pbs_idx *idx = NULL;
 
-	idx = malloc(sizeof(AVL_IX_DESC));
+	idx = malloc(sizeof(pbs_idx));
 	if (idx == NULL)
 		return NULL;
+	idx->hash = NULL;
 
-	if (avl_create_index(idx, flags, keylen)) {
+	if (avl_create_index(&idx->avl, flags & (PBS_IDX_DUPS_OK | PBS_IDX_ICASE_CMP), keylen)) {
 		free(idx);
 		return NULL;
 	}
 
+	if ((flags & PBS_IDX_HASH) && !(flags & PBS_IDX_DUPS_OK)) {
+		idx->hash = calloc(1, sizeof(hash_idx));
+		if (idx->hash == NULL ||
+				(idx->hash->slots = calloc(HASH_IDX_MIN_SIZE, sizeof(hash_slot))) == NULL) {
+			free(idx->hash);
+			avl_destroy_index(&idx->avl);
+			free(idx);
+			return NULL;
+		}
+		idx->hash->size = HASH_IDX_MIN_SIZE;
+	}
+
 	return idx;
 }
 
@@ -90,9 +375,20 @@ pbs_idx_create(int flags, int keylen)
 void
 pbs_idx_destroy(void *idx)
 {
-	if (idx != NULL) {
-		avl_destroy_index(idx);
-		free(idx);
+	pbs_idx *pidx = (pbs_idx *) idx;
+	size_t i;
+
+	if (pidx != NULL) {
+		if (pidx->hash != NULL) {
+			for (i = 0; i < pidx->hash->size; i++) {
+				if (pidx->hash->slots[i].key != hash_tomb)
+					free(pidx->hash->slots[i].key);
+			}
+			free(pidx->hash->slots);
+			free(pidx->hash);
+		}
+		avl_destroy_index(&pidx->avl);
+		free(pidx);
 		idx = NULL;
 	}
 }
@@ -118,6 +414,9 @@ pbs_idx_insert(void *idx, void *key, void *data)
 	if (idx == NULL || key == NULL)
 		return PBS_IDX_RET_FAIL;
 
+	if (((pbs_idx *) idx)->hash != NULL)
+		return hash_idx_insert(idx, key, data);
+
 	pkey = avlkey_create(idx, key);
 	if (pkey == NULL)
 		return PBS_IDX_RET_FAIL;
@@ -151,6 +450,14 @@ pbs_idx_delete(void *idx, void *key)
 	if (idx == NULL || key == NULL)
 		return PBS_IDX_RET_FAIL;
 
+	if (((pbs_idx *) idx)->hash != NULL) {
+		hash_slot *slot = hash_idx_lookup(idx, key);
+
+		if (slot != NULL)
+			hash_idx_remove(((pbs_idx *) idx)->hash, slot);
+		return PBS_IDX_RET_OK;
+	}
+
 	pkey = avlkey_create(idx, key);
 	if (pkey == NULL)
 		return PBS_IDX_RET_FAIL;
@@ -177,8 +484,20 @@ int
 pbs_idx_delete_byctx(void *ctx)
 {
 	iter_ctx *pctx = (iter_ctx *) ctx;
+	hash_idx *ht;
 
-	if (pctx == NULL || pctx->idx == NULL || pctx->pkey == NULL)
+	if (pctx == NULL || pctx->idx == NULL)
+		return PBS_IDX_RET_FAIL;
+
+	if ((ht = ((pbs_idx *) pctx->idx)->hash) != NULL) {
+		if (pctx->pos >= ht->size || ht->slots[pctx->pos].key == NULL ||
+				ht->slots[pctx->pos].key == hash_tomb)
+			return PBS_IDX_RET_FAIL;
+		hash_idx_remove(ht, &ht->slots[pctx->pos]);
+		return PBS_IDX_RET_OK;
+	}
+
+	if (pctx->pkey == NULL)
 		return PBS_IDX_RET_FAIL;
 
 	avl_delete_key(pctx->pkey, pctx->idx);
@@ -206,6 +525,8 @@ pbs_idx_delete_byctx(void *ctx)
  *
  * @note
  * 	ctx should be free'd after use, using pbs_idx_free_ctx()
+ *	Iteration over a PBS_IDX_HASH index is in no particular order,
+ *	and must not be mixed with inserts into the index.
  *
  */
 int
@@ -218,6 +539,9 @@ pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 	if (idx == NULL || data == NULL)
 		return PBS_IDX_RET_FAIL;
 
+	if (((pbs_idx *) idx)->hash != NULL)
+		return hash_idx_find(idx, key, data, ctx);
+
 	if (ctx != NULL && *ctx != NULL) {
 		pctx = (iter_ctx *) *ctx;
 
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_pool.c
+ * @brief
+ *	Fixed size object pools, see pbs_pool.h
+ */
+
+#include <pbs_config.h>
+
+#include "pbs_pool.h"
+#include "pbs_idx.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PBS_POOL_MAX 32 /* pools a process may create */
+
+struct pbs_pool {
+	char name[32];
+	size_t objsize;
+	void *freelist;		/* free objects, linked through their first word */
+	long live;
+	long peak;
+	long nfree;
+	long slabs;
+	unsigned long allocs;
+	pthread_mutex_t lock;
+};
+
+static pbs_pool_t *pools[PBS_POOL_MAX];
+static int npools = 0;
+static void *slab_idx = NULL;	/* slab address -> owning pool */
+static pthread_mutex_t pools_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief
+ *	Create a pool of objects of the given size
+ *
+ * @param[in] - name    - name of the pool, for statistics
+ * @param[in] - objsize - size of each object, at most PBS_POOL_SLAB_SIZE / 4
+ *
+ * @return pbs_pool_t *
+ * @retval !NULL - success
+ * @retval NULL  - failure
+ */
+pbs_pool_t *
+pbs_pool_create(const char *name, size_t objsize)
+{
+	pbs_pool_t *pool;
+
+	/* keep objects pointer aligned and able to hold the free list link */
+	objsize = (objsize + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+	if (objsize == 0 || objsize > PBS_POOL_SLAB_SIZE / 4)
+		return NULL;
+
+	if ((pool = calloc(1, sizeof(pbs_pool_t))) == NULL)
+		return NULL;
+	strncpy(pool->name, name, sizeof(pool->name) - 1);
+	pool->objsize = objsize;
+	pthread_mutex_init(&pool->lock, NULL);
+
+	pthread_mutex_lock(&pools_lock);
+	if (npools == PBS_POOL_MAX ||
+			(slab_idx == NULL && (slab_idx = pbs_idx_create(PBS_IDX_HASH, sizeof(uintptr_t))) == NULL)) {
+		pthread_mutex_unlock(&pools_lock);
+		pthread_mutex_destroy(&pool->lock);
+		free(pool);
+		return NULL;
+	}
+	pools[npools++] = pool;
+	pthread_mutex_unlock(&pools_lock);
+
+	return pool;
+}
+
+/**
+ * @brief
+ *	Add a slab of objects to the free list of a pool.
+ *	Called with the pool locked.
+ *
+ * @return int
+ * @retval  0 - success
+ * @retval -1 - out of memory
+ */
+static int
+pbs_pool_grow(pbs_pool_t *pool)
+{
+	void *slab;
+	uintptr_t key;
+	char *obj;
+	size_t n;
+	size_t i;
+
+	if (posix_memalign(&slab, PBS_POOL_SLAB_SIZE, PBS_POOL_SLAB_SIZE) != 0)
+		return -1;
+
+	key = (uintptr_t) slab;
+	pthread_mutex_lock(&pools_lock);
+	if (pbs_idx_insert(slab_idx, &key, pool) != PBS_IDX_RET_OK) {
+		pthread_mutex_unlock(&pools_lock);
+		free(slab);
+		return -1;
+	}
+	pthread_mutex_unlock(&pools_lock);
+
+	n = PBS_POOL_SLAB_SIZE / pool->objsize;
+	for (i = n; i > 0; i--) {
+		obj = (char *) slab + (i - 1) * pool->objsize;
+		*(void **) obj = pool->freelist;
+		pool->freelist = obj;
+	}
+	pool->nfree += n;
+	pool->slabs++;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Allocate an object from a pool, contents are undefined
+ *
+ * @param[in] - pool - the pool
+ *
+ * @return void *
+ * @retval !NULL - the object
+ * @retval NULL  - out of memory
+ */
+void *
+pbs_pool_alloc(pbs_pool_t *pool)
+{
+	void *obj;
+
+	pthread_mutex_lock(&pool->lock);
+	if (pool->freelist == NULL && pbs_pool_grow(pool) != 0) {
+		pthread_mutex_unlock(&pool->lock);
+		return NULL;
+	}
+	obj = pool->freelist;
+	pool->freelist = *(void **) obj;
+	pool->nfree--;
+	pool->allocs++;
+	if (++pool->live > pool->peak)
+		pool->peak = pool->live;
+	pthread_mutex_unlock(&pool->lock);
+
+	return obj;
+}
+
+/**
+ * @brief
+ *	Return an object to the pool it was allocated from
+ *
+ * @param[in] - pool - the pool
+ * @param[in] - obj  - the object
+ *
+ * @return void
+ */
+void
+pbs_pool_free(pbs_pool_t *pool, void *obj)
+{
+	if (obj == NULL)
+		return;
+
+	pthread_mutex_lock(&pool->lock);
+	*(void **) obj = pool->freelist;
+	pool->freelist = obj;
+	pool->nfree++;
+	pool->live--;
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief
+ *	Find the pool an object was allocated from
+ *
+ * @param[in] - obj - any pointer
+ *
+ * @return pbs_pool_t *
+ * @retval !NULL - the pool owning obj
+ * @retval NULL  - obj does not come from a pool (e.g. it was malloc'ed)
+ */
+pbs_pool_t *
+pbs_pool_find(void *obj)
+{
+	uintptr_t key = (uintptr_t) obj & ~((uintptr_t) PBS_POOL_SLAB_SIZE - 1);
+	void *pkey = &key;
+	void *pool = NULL;
+
+	if (slab_idx == NULL)
+		return NULL;
+
+	pthread_mutex_lock(&pools_lock);
+	if (pbs_idx_find(slab_idx, &pkey, &pool, NULL) != PBS_IDX_RET_OK)
+		pool = NULL;
+	pthread_mutex_unlock(&pools_lock);
+
+	return pool;
+}
+
+/**
+ * @brief
+ *	Get the statistics of all pools
+ *
+ * @param[out] - stats - array to fill
+ * @param[in]  - max   - number of entries in stats
+ *
+ * @return int - number of entries filled
+ */
+int
+pbs_pool_stats(pbs_pool_stats_t *stats, int max)
+{
+	pbs_pool_t *pool;
+	int n;
+	int i;
+
+	/* pools are never destroyed, only take pools_lock to read the list */
+	pthread_mutex_lock(&pools_lock);
+	n = npools < max ? npools : max;
+	pthread_mutex_unlock(&pools_lock);
+
+	for (i = 0; i < n; i++) {
+		pool = pools[i];
+		pthread_mutex_lock(&pool->lock);
+		stats[i].name = pool->name;
+		stats[i].objsize = pool->objsize;
+		stats[i].live = pool->live;
+		stats[i].peak = pool->peak;
+		stats[i].nfree = pool->nfree;
+		stats[i].slabs = pool->slabs;
+		stats[i].allocs = pool->allocs;
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	return n;
+}
@@ -402,68 +402,57 @@ range_remove_value(range **r, int val)
 {
 	range *cur;
 	range *prev = NULL;
-	int done = 0;
 
 	if (r == NULL || *r == NULL)
 		return 0;
 
-	if (!range_contains(*r, val))
+	/* find the sub-range holding the value, in a single walk of the list */
+	for (cur = *r; cur != NULL; prev = cur, cur = cur->next) {
+		if (range_contains_single(cur, val))
+			break;
+	}
+	if (cur == NULL)
 		return 0;
 
-	cur = *r;
-	while (cur != NULL && !done) {
-		if (cur->start == val && cur->end == val) {
-			if (prev == NULL)  /* we're removing the first range struct in the list */
-				*r = (*r)->next;
-			else 
-				prev->next = cur->next;
-			free_range(cur);
-			return 1;
-		} else if (cur->start == val) {
-			cur->start += cur->step;
-			cur->count--;
-			done = 1;
-		} else if (cur->end == val) {
-			cur->end -= cur->step;
-			cur->count--;
-			done = 1;
-		} else if ((val > cur->start) && (val < cur->end)) {
-			range *next_range = NULL;
-			if ((next_range = new_range(0, 0, 1, 0, NULL)) == NULL)
-				return 0;
-				
-			next_range->count = (cur->end - val)/cur->step;
-			next_range->step = cur->step;
-			next_range->start = val + cur->step;
-			next_range->end = cur->end;
-			next_range->next = cur->next;
-
-			cur->count = (val - cur->start)/cur->step;
-			cur->end = val - cur->step;
-			cur->next = next_range;			
-			return 1;	
-		}
+	if (cur->start == val && cur->end == val) {
+		if (prev == NULL)  /* we're removing the first range struct in the list */
+			*r = (*r)->next;
+		else 
+			prev->next = cur->next;
+		free_range(cur);
+		return 1;
+	} else if (cur->start == val) {
+		cur->start += cur->step;
+		cur->count--;
+	} else if (cur->end == val) {
+		cur->end -= cur->step;
+		cur->count--;
+	} else {
+		range *next_range = NULL;
+		if ((next_range = new_range(0, 0, 1, 0, NULL)) == NULL)
+			return 0;
 
-		if (!done) {
-			prev = cur;
-			cur = cur->next;
-		}
-	}
+		next_range->count = (cur->end - val)/cur->step;
+		next_range->step = cur->step;
+		next_range->start = val + cur->step;
+		next_range->end = cur->end;
+		next_range->next = cur->next;
 
-	if (done) {
-		/* we removed the last value from this section of the range */
-		if (cur->start > cur->end) {
-			if (prev == NULL)   /* we're removing the first range struct in the list */
-				*r = (*r)->next;
-			else 
-				prev->next = cur->next;
-			free_range(cur);
-		}
-		return 1;
+		cur->count = (val - cur->start)/cur->step;
+		cur->end = val - cur->step;
+		cur->next = next_range;			
+		return 1;	
 	}
 
-	/* we didn't remove it */
-	return 0;
+	/* we removed the last value from this section of the range */
+	if (cur->start > cur->end) {
+		if (prev == NULL)   /* we're removing the first range struct in the list */
+			*r = (*r)->next;
+		else 
+			prev->next = cur->next;
+		free_range(cur);
+	}
+	return 1;
 }
 
 /**
@@ -721,8 +710,9 @@ range_to_str(range *r)
 	static char *range_str = NULL;
 	static int size = 0;
 	range *cur_r = NULL;
-	char numbuf[128];
-	int len;
+	char *tmp;
+	int len = 0;
+	int n;
 
 	if (r == NULL)
 		return "";
@@ -736,28 +726,27 @@ range_to_str(range *r)
 	}
 	range_str[0] = '\0';
 
+	/* append at the known end of the string, lists can be very long */
 	for (cur_r = r; cur_r != NULL; cur_r = cur_r->next) {
-		if (cur_r->count > 1)
-			sprintf(numbuf, "%d-%d", cur_r->start, cur_r->end);
-		else
-			sprintf(numbuf, "%d", cur_r->start);
-
-		if (cur_r->step > 1 && cur_r->count > 1 ) {
-			if (pbs_strcat(&range_str, &size, numbuf) == NULL)
-				return "";
-			sprintf(numbuf, ":%d", cur_r->step);
-			if (pbs_strcat(&range_str, &size, numbuf) == NULL)
+		/* room for ",start-end:step" */
+		if (size - len < 40) {
+			if ((tmp = realloc(range_str, size * 2 + 1)) == NULL) {
+				log_err(errno, __func__, RANGE_MEM_ERR_MSG);
 				return "";
+			}
+			range_str = tmp;
+			size *= 2;
 		}
-		else
-			if (pbs_strcat(&range_str, &size, numbuf) == NULL)
-				return "";
 
-		if (pbs_strcat(&range_str, &size, ",") == NULL)
-			return "";
+		if (cur_r->count > 1 && cur_r->step > 1)
+			n = sprintf(range_str + len, "%d-%d:%d,", cur_r->start, cur_r->end, cur_r->step);
+		else if (cur_r->count > 1)
+			n = sprintf(range_str + len, "%d-%d,", cur_r->start, cur_r->end);
+		else
+			n = sprintf(range_str + len, "%d,", cur_r->start);
+		len += n;
 	}
-	len = strlen(range_str);
-	if (range_str[len-1] == ',')
+	if (len > 0 && range_str[len-1] == ',')
 		range_str[len-1] = '\0';
 
 	return range_str;
@@ -63,6 +63,150 @@ extern pbs_list_head task_list_event; /* list of tasks responding to an event */
 extern int svr_delay_entry;
 extern time_t	time_now;
 
+/*
+ * Timed tasks are kept on task_list_timed (unordered, for the parm1 scans)
+ * and in a binary min-heap ordered by (wt_event, wt_seq), so adding,
+ * cancelling and expiring a timed task is O(log n) instead of a list walk.
+ *
+ * Event tasks are also chained by wt_linkevent into a table hashed on
+ * wt_event, so a reply or child exit finds its task without walking every
+ * pending event.  Completed (WORK_Deferred_Cmp) tasks are moved from the
+ * table to task_list_cmp, which next_task() drains.
+ */
+#define WT_EVENT_TBL_SIZE	1024
+#define WT_HEAP_INCR		256
+
+static struct work_task **timed_heap = NULL;
+static int timed_heap_cnt = 0;
+static int timed_heap_max = 0;
+static unsigned long task_seq = 0;
+
+static pbs_list_head task_event_tbl[WT_EVENT_TBL_SIZE];
+static pbs_list_head task_list_cmp;
+static int task_event_tbl_init = 0;
+
+/**
+ * @brief
+ *	Return the event table bucket for an event id, initializing the
+ *	table on first use.
+ *
+ * @param[in]	event	- event id (socket, pid, stream...)
+ *
+ * @return	pbs_list_head *
+ */
+static pbs_list_head *
+task_event_bucket(long event)
+{
+	int i;
+
+	if (!task_event_tbl_init) {
+		for (i = 0; i < WT_EVENT_TBL_SIZE; i++)
+			CLEAR_HEAD(task_event_tbl[i]);
+		CLEAR_HEAD(task_list_cmp);
+		task_event_tbl_init = 1;
+	}
+	return &task_event_tbl[(unsigned long) event % WT_EVENT_TBL_SIZE];
+}
+
+/**
+ * @brief
+ *	Heap ordering: earlier time first, creation order among equal times.
+ */
+static int
+timed_before(struct work_task *a, struct work_task *b)
+{
+	if (a->wt_event != b->wt_event)
+		return (a->wt_event < b->wt_event);
+	return (a->wt_seq < b->wt_seq);
+}
+
+static void
+timed_heap_set(int i, struct work_task *ptask)
+{
+	timed_heap[i] = ptask;
+	ptask->wt_heap_idx = i;
+}
+
+static void
+timed_heap_up(int i)
+{
+	struct work_task *ptask = timed_heap[i];
+	int parent;
+
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (!timed_before(ptask, timed_heap[parent]))
+			break;
+		timed_heap_set(i, timed_heap[parent]);
+		i = parent;
+	}
+	timed_heap_set(i, ptask);
+}
+
+static void
+timed_heap_down(int i)
+{
+	struct work_task *ptask = timed_heap[i];
+	int child;
+
+	while ((child = 2 * i + 1) < timed_heap_cnt) {
+		if ((child + 1 < timed_heap_cnt) &&
+			timed_before(timed_heap[child + 1], timed_heap[child]))
+			child++;
+		if (!timed_before(timed_heap[child], ptask))
+			break;
+		timed_heap_set(i, timed_heap[child]);
+		i = child;
+	}
+	timed_heap_set(i, ptask);
+}
+
+/**
+ * @brief
+ *	Add a timed task to the heap.
+ *
+ * @return int
+ * @retval 0	- success
+ * @retval -1	- out of memory
+ */
+static int
+timed_heap_insert(struct work_task *ptask)
+{
+	struct work_task **tmp;
+
+	if (timed_heap_cnt == timed_heap_max) {
+		tmp = realloc(timed_heap, (timed_heap_max + WT_HEAP_INCR) * sizeof(struct work_task *));
+		if (tmp == NULL)
+			return -1;
+		timed_heap = tmp;
+		timed_heap_max += WT_HEAP_INCR;
+	}
+	timed_heap_set(timed_heap_cnt++, ptask);
+	timed_heap_up(ptask->wt_heap_idx);
+	return 0;
+}
+
+/**
+ * @brief
+ *	Remove a task from the heap, if it is there.
+ */
+static void
+timed_heap_remove(struct work_task *ptask)
+{
+	int i = ptask->wt_heap_idx;
+
+	if (i < 0 || i >= timed_heap_cnt || timed_heap[i] != ptask)
+		return;
+	ptask->wt_heap_idx = -1;
+	if (--timed_heap_cnt == i)
+		return;
+	timed_heap_set(i, timed_heap[timed_heap_cnt]);
+	if (i > 0 && timed_before(timed_heap[i], timed_heap[(i - 1) / 2]))
+		timed_heap_up(i);
+	else
+		timed_heap_down(i);
+}
+
 /**
  *
  * @brief
@@ -84,7 +228,7 @@ extern time_t	time_now;
 struct work_task *set_task(enum work_type type, long event_id, void (*func)(struct work_task *) , void *parm)
 {
 	struct work_task *pnew;
-	struct work_task *pold;
+	pbs_list_head *bucket;
 
 	pnew = (struct work_task *)malloc(sizeof(struct work_task));
 	if (pnew == NULL)
@@ -92,6 +236,7 @@ struct work_task *set_task(enum work_type type, long event_id, void (*func)(stru
 	CLEAR_LINK(pnew->wt_linkall);
 	CLEAR_LINK(pnew->wt_linkobj);
 	CLEAR_LINK(pnew->wt_linkobj2);
+	CLEAR_LINK(pnew->wt_linkevent);
 	pnew->wt_event = event_id;
 	pnew->wt_event2 = NULL;
 	pnew->wt_type  = type;
@@ -101,23 +246,25 @@ struct work_task *set_task(enum work_type type, long event_id, void (*func)(stru
 	pnew->wt_parm3 = NULL;
 	pnew->wt_aux   = 0;
 	pnew->wt_aux2  = 0;
+	pnew->wt_heap_idx = -1;
+	pnew->wt_seq = task_seq++;
 
 	if (type == WORK_Immed)
 		append_link(&task_list_immed, &pnew->wt_linkall, pnew);
 	else if (type == WORK_Timed) {
-		pold = (struct work_task *)GET_NEXT(task_list_timed);
-		while (pold) {
-			if (pold->wt_event > pnew->wt_event)
-				break;
-			pold = (struct work_task *)GET_NEXT(pold->wt_linkall);
+		if (timed_heap_insert(pnew) == -1) {
+			free(pnew);
+			return NULL;
 		}
-		if (pold)
-			insert_link(&pold->wt_linkall, &pnew->wt_linkall, pnew,
-				LINK_INSET_BEFORE);
-		else
-			append_link(&task_list_timed, &pnew->wt_linkall, pnew);
-	} else
+		append_link(&task_list_timed, &pnew->wt_linkall, pnew);
+	} else {
+		bucket = task_event_bucket(event_id);
 		append_link(&task_list_event, &pnew->wt_linkall, pnew);
+		if (type == WORK_Deferred_Cmp)
+			append_link(&task_list_cmp, &pnew->wt_linkevent, pnew);
+		else
+			append_link(bucket, &pnew->wt_linkevent, pnew);
+	}
 	return (pnew);
 }
 
@@ -137,7 +284,9 @@ struct work_task *set_task(enum work_type type, long event_id, void (*func)(stru
 void
 dispatch_task(struct work_task *ptask)
 {
+	timed_heap_remove(ptask);
 	delete_link(&ptask->wt_linkall);
+	delete_link(&ptask->wt_linkevent);
 	delete_link(&ptask->wt_linkobj);
 	delete_link(&ptask->wt_linkobj2);
 	if (ptask->wt_func)
@@ -156,12 +305,89 @@ dispatch_task(struct work_task *ptask)
 void
 delete_task(struct work_task *ptask)
 {
+	timed_heap_remove(ptask);
 	delete_link(&ptask->wt_linkobj);
 	delete_link(&ptask->wt_linkobj2);
 	delete_link(&ptask->wt_linkall);
+	delete_link(&ptask->wt_linkevent);
 	(void)free(ptask);
 }
 
+/**
+ * @brief
+ *	Find a pending event task of the given type waiting on 'event'.
+ *
+ * @param[in]	type	- task type (WORK_Deferred_Reply, WORK_Deferred_Child...)
+ * @param[in]	event	- event id (socket, pid...) the task waits on
+ *
+ * @return struct work_task *
+ * @retval	the oldest matching task
+ * @retval	NULL if there is none
+ */
+struct work_task *
+find_event_task(enum work_type type, long event)
+{
+	struct work_task *ptask;
+
+	ptask = (struct work_task *)GET_NEXT(*task_event_bucket(event));
+	while (ptask) {
+		if ((ptask->wt_type == type) && (ptask->wt_event == event))
+			return ptask;
+		ptask = (struct work_task *)GET_NEXT(ptask->wt_linkevent);
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Mark an event task as completed, to be dispatched by next_task().
+ *	The task no longer matches find_event_task().
+ *
+ * @param[in]	ptask	- the event task
+ * @param[in]	aux	- value saved in wt_aux (e.g. child exit status)
+ */
+void
+complete_event_task(struct work_task *ptask, int aux)
+{
+	delete_link(&ptask->wt_linkevent);
+	ptask->wt_type = WORK_Deferred_Cmp;
+	ptask->wt_aux = aux;
+	(void)task_event_bucket(0);
+	append_link(&task_list_cmp, &ptask->wt_linkevent, ptask);
+	svr_delay_entry++;	/* see next_task() */
+}
+
+/**
+ * @brief
+ *	Take an event task off task_list_event and the event table, leaving
+ *	it on its object lists; the caller takes over tracking it.
+ *
+ * @param[in]	ptask	- the event task
+ */
+void
+remove_task_event(struct work_task *ptask)
+{
+	delete_link(&ptask->wt_linkall);
+	delete_link(&ptask->wt_linkevent);
+}
+
+/**
+ * @brief
+ *	Change the time a timed task is due.
+ *
+ * @param[in]	ptask	- the task
+ * @param[in]	when	- new due time
+ */
+void
+set_task_time(struct work_task *ptask, long when)
+{
+	ptask->wt_event = when;
+	if (ptask->wt_heap_idx >= 0) {
+		timed_heap_up(ptask->wt_heap_idx);
+		timed_heap_down(ptask->wt_heap_idx);
+	}
+}
+
 /**
  *
  * @brief
@@ -252,8 +478,8 @@ has_task_by_parm1(void *parm1)
 /**
  * @brief
  *	Looks for the next work task to perform:
- *	1. If svr_delay_entry is set, then a delayed task in the
- *	   task_list_event is ready so find and process it.
+ *	1. If svr_delay_entry is set, then completed event tasks are
+ *	   ready, so process them.
  *	2. All items on the immediate list, then
  *	3. All items on the timed task list which have expired times
  *
@@ -265,7 +491,6 @@ time_t
 default_next_task(void)
 {
 	time_t		   delay;
-	struct work_task  *nxt;
 	struct work_task  *ptask;
 	/*
 	 * tilwhen is the basic "idle" time if there is nothing pending sooner
@@ -279,20 +504,17 @@ default_next_task(void)
 	time_now = time(NULL);
 
 	if (svr_delay_entry) {
-		ptask = (struct work_task *)GET_NEXT(task_list_event);
-		while (ptask) {
-			nxt = (struct work_task *)GET_NEXT(ptask->wt_linkall);
-			if (ptask->wt_type == WORK_Deferred_Cmp)
-				dispatch_task(ptask);
-			ptask = nxt;
-		}
+		(void)task_event_bucket(0);
+		while ((ptask = (struct work_task *)GET_NEXT(task_list_cmp)) != NULL)
+			dispatch_task(ptask);
 		svr_delay_entry = 0;
 	}
 
 	while ((ptask=(struct work_task *)GET_NEXT(task_list_immed)) != NULL)
 		dispatch_task(ptask);
 
-	while ((ptask=(struct work_task *)GET_NEXT(task_list_timed))!=NULL) {
+	while (timed_heap_cnt > 0) {
+		ptask = timed_heap[0];
 		if ((delay = ptask->wt_event - time_now) > 0) {
 			if (tilwhen > delay)
 				tilwhen = delay;
@@ -897,6 +897,7 @@ send_hellosvr(int stream)
 		goto err;
 
 	server_stream = stream;
+	reset_resc_used_delta();
 
 	if (svr)
 		sprintf(log_buffer, "HELLO sent to server at %s:%d", svr, port);
@@ -304,7 +304,8 @@ catch_USR2(int sig)
 /**
  * @brief
  *	Cause useful information to be logged.  This function is called from
- *	MoM's main loop after catching a SIGUSR2.
+ *	MoM's main loop after catching a SIGUSR2.  Besides the CPU and vnode
+ *	reports, the TPP transport statistics are logged.
  *
  * @return Void
  *
@@ -314,9 +315,15 @@ void
 debug_report(void)
 {
 extern void	mom_CPUs_report(void);
+	long old_mask = *log_event_mask;
 
 	mom_CPUs_report();
 	mom_vnlp_report(vnlp, NULL);
+
+	/* transport statistics are logged as debug events, make sure they show */
+	*log_event_mask |= PBSEVENT_DEBUG;
+	tpp_stats_dump();
+	*log_event_mask = old_mask;
 	do_debug_report = 0;
 }
 
@@ -124,9 +124,7 @@ extern	pbs_list_head	svr_alljobs;
 extern	int		termin_child;
 extern	int		num_acpus;
 extern	int		num_pcpus;
-extern	int		svr_delay_entry;
 
-extern	pbs_list_head	task_list_event;
 
 #if	MOM_ALPS
 extern	char		*path_jobs;
@@ -683,16 +681,8 @@ scan_for_terminated(void)
 
 
 		/* Check for other task lists */
-		wtask = (struct work_task *)GET_NEXT(task_list_event);
-		while (wtask) {
-			if ((wtask->wt_type == WORK_Deferred_Child) &&
-				(wtask->wt_event == pid)) {
-				wtask->wt_type = WORK_Deferred_Cmp;
-				wtask->wt_aux = (int)exiteval; /* exit status */
-				svr_delay_entry++;	/* see next_task() */
-			}
-			wtask = (struct work_task *)GET_NEXT(wtask->wt_linkall);
-		}
+		while ((wtask = find_event_task(WORK_Deferred_Child, pid)) != NULL)
+			complete_event_task(wtask, (int)exiteval); /* exit status */
 
 		pjob = (job *)GET_NEXT(svr_alljobs);
 		while (pjob) {
@@ -197,6 +197,8 @@ char mom_short_name[PBS_MAXHOSTNAME + 1];
 int next_sample_time = MAX_CHECK_POLL_TIME;
 int max_check_poll = MAX_CHECK_POLL_TIME;
 int min_check_poll = MIN_CHECK_POLL_TIME;
+int resc_used_delta = 0;	/* percent change before resources_used is resent */
+int server_rescused2 = 0;	/* Server advertised IS_FEAT_RESCUSED2 in its last IS_REPLYHELLO */
 int inc_check_poll = 20;
 int num_acpus = 1;
 int num_pcpus = 1;
@@ -480,6 +482,7 @@ static handler_ret_t set_vnode_additive(char *);
 static handler_ret_t setidealload(char *);
 static handler_ret_t setlogevent(char *);
 static handler_ret_t set_reject_root_scripts(char *);
+static handler_ret_t set_resc_used_delta(char *);
 static handler_ret_t set_report_hook_checksums(char *);
 static handler_ret_t setmaxload(char *);
 static handler_ret_t set_max_poll_downtime(char *);
@@ -533,6 +536,7 @@ static struct	specials {
 #endif
 	{ "port",			set_momport },
 	{ "prologalarm",		prologalarm },
+	{ "resc_used_delta",		set_resc_used_delta },
 	{ "sister_join_job_alarm",	set_joinjob_alarm },
 	{ "job_launch_delay",		set_job_launch_delay },
 	{ "restart_background",		set_restart_background },
@@ -3363,6 +3367,27 @@ set_min_check_poll(char *value)
 	return (set_int(id, value, &min_check_poll));
 }
 
+/**
+ * @brief
+ *      sets the percentage a numeric resources_used value must change
+ *      by before it is sent again in a periodic update to the Server
+ *
+ * @param[in] value - percentage
+ *
+ * @return      handler_ret_t
+ * @retval      HANDLER_SUCCESS         success
+ * @retval      HANDLER_FAIL            Failure
+ *
+ */
+
+static handler_ret_t
+set_resc_used_delta(char *value)
+{
+	static	char	id[] = "resc_used_delta";
+
+	return (set_int(id, value, &resc_used_delta));
+}
+
 /**
  * @brief
  *      sets alien to be attached
@@ -7787,6 +7812,9 @@ main(int argc, char *argv[])
 	ftruncate(lockfds, 0);
 	write(lockfds, log_buffer, strlen(log_buffer));
 
+	/* the log writer thread must be started after forking */
+	(void)log_async_start(pbs_conf.pbs_log_async);
+
 #ifndef	WIN32 /* ------------------------------------------------------------*/
 
 	daemon_protect(0, PBS_DAEMON_PROTECT_ON);
@@ -7863,7 +7891,7 @@ main(int argc, char *argv[])
 
 	/* initialize variables */
 
-	if ((jobs_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((jobs_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating jobs index failed!");
 		fprintf(stderr, "Creating jobs index failed!\n");
 		return (-1);
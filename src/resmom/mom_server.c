@@ -839,6 +839,18 @@ is_request(int stream, int version)
 			if (ret != 0 && ret != DIS_EOD)
 				goto err;
 
+			/* servers which predate the feature word do not send it */
+			server_rescused2 = 0;
+			if (ret == 0) {
+				unsigned int features;
+
+				features = disrui(stream, &ret);
+				if (ret == DIS_SUCCESS)
+					server_rescused2 = (features & IS_FEAT_RESCUSED2) ? 1 : 0;
+				else if (ret != DIS_EOD)
+					goto err;
+			}
+
 			 /* return a IS_REGISTERMOM followed by an UPDATE or UPDATE2 */
 
 			next_sample_time = min_check_poll;
@@ -57,11 +57,31 @@ extern int resc_access_perm;
 extern int server_stream;
 extern time_t time_now;
 
+/*
+ * All numeric resources_used values of a job are resent at least this often,
+ * even when none has changed by more than resc_used_delta percent.
+ */
+#define RESC_USED_FULL_INTERVAL 600
+
+/*
+ * The numeric resources_used values last sent to the Server for a job,
+ * hung off of pjob->ji_resc_used_sent.
+ */
+struct resc_used_sent {
+	int rs_epoch;		/* resc_used_epoch when sent */
+	time_t rs_full_at;	/* time all values were last sent */
+	int rs_nnum;		/* number of entries in rs_num */
+	ruu_num rs_num[];	/* values last sent */
+};
+
+/* bumped whenever the stream to the Server is (re)opened */
+static int resc_used_epoch = 0;
+
 static void bundle_ruu(int *r_cnt, ruu **prused, int *rh_cnt, ruu **prhused, int *o_cnt, ruu **obits);
-static ruu *get_job_update(job *pjob);
+static ruu *get_job_update(job *pjob, int binary);
 static PyObject *json_loads(char *value, char *msg, size_t msg_len);
 static char *json_dumps(PyObject *py_val, char *msg, size_t msg_len);
-static void encode_used(job *pjob, pbs_list_head *phead);
+static void encode_used(job *pjob, pbs_list_head *phead, ruu *prused);
 
 static PyObject *py_json_name = NULL;
 static PyObject *py_json_module = NULL;
@@ -315,18 +335,60 @@ json_dumps_fail:
 }
 #endif
 
+/**
+ * @brief
+ * 	add a numeric resources_used value to the binary part of an update
+ *
+ * @param[in] prused - update to add the value to
+ * @param[in] rd     - resource definition
+ * @param[in] val    - value of the resource
+ *
+ * @return int
+ * @retval 0 - value added
+ * @retval 1 - value cannot be sent in binary form, encode it instead
+ *
+ */
+static int
+add_ruu_num(ruu *prused, resource_def *rd, attribute *val)
+{
+	ruu_num *pnum;
+
+	if ((val->at_flags & ATR_VFLAG_SET) == 0)
+		return 1;
+	if (val->at_type != ATR_TYPE_LONG &&
+	    val->at_type != ATR_TYPE_SIZE &&
+	    val->at_type != ATR_TYPE_FLOAT)
+		return 1;
+	if (strlen(rd->rs_name) >= RUU_RESC_NAMELEN)
+		return 1;
+
+	if ((prused->ru_nnum % 8) == 0) {
+		pnum = realloc(prused->ru_num, (prused->ru_nnum + 8) * sizeof(ruu_num));
+		if (pnum == NULL)
+			return 1;
+		prused->ru_num = pnum;
+	}
+	pnum = &prused->ru_num[prused->ru_nnum++];
+	strcpy(pnum->rn_name, rd->rs_name);
+	pnum->rn_type = val->at_type;
+	pnum->rn_val = val->at_val;
+	return 0;
+}
+
 /**
  * @brief
  * 	 encode_used - encode resources used by a job to be returned to the server
  *
  * @param[in] pjob - pointer to job structure
  * @param[in] phead - pointer to pbs_list_head structure
+ * @param[in] prused - if not NULL, numeric resources_used values are added
+ *		       to its binary list instead of being encoded into phead
  *
  * @return Void
  *
  */
 static void
-encode_used(job *pjob, pbs_list_head *phead)
+encode_used(job *pjob, pbs_list_head *phead, ruu *prused)
 {
 	attribute *at;
 	attribute_def *ad;
@@ -645,8 +707,10 @@ encode_used(job *pjob, pbs_list_head *phead)
 				}
 			}
 
-			if (rd->rs_encode(&val, phead, ad->at_name, rd->rs_name, ATR_ENCODE_CLIENT, NULL) < 0)
-				goto encode_used_exit;
+			if (prused == NULL || add_ruu_num(prused, rd, &val) != 0) {
+				if (rd->rs_encode(&val, phead, ad->at_name, rd->rs_name, ATR_ENCODE_CLIENT, NULL) < 0)
+					goto encode_used_exit;
+			}
 
 			if (include_resc_used_update) {
 				if (rd->rs_encode(&val3, phead, ad3->at_name, rd->rs_name, ATR_ENCODE_CLIENT, NULL) < 0)
@@ -668,6 +732,8 @@ encode_used_exit:
  * 	generate new resc used update based on given job information
  *
  * @param[in] pjob - pointer to job
+ * @param[in] binary - if set, numeric resources_used values are put in
+ *		       ru_num for IS_RESCUSED2 instead of ru_attr
  *
  * @return ruu *
  *
@@ -678,7 +744,7 @@ encode_used_exit:
  * 	retuned pointer should be free'd using FREE_RUU() when not needed
  */
 static ruu *
-get_job_update(job *pjob)
+get_job_update(job *pjob, int binary)
 {
 	/*
 	 * the following is a list of attributes to be returned to the server
@@ -749,7 +815,7 @@ get_job_update(job *pjob)
 				job_attr_def[JOB_ATR_substate].at_name, NULL, ATR_ENCODE_CLIENT, NULL);
 	}
 
-	encode_used(pjob, &prused->ru_attr);
+	encode_used(pjob, &prused->ru_attr, binary ? prused : NULL);
 
 	/* Now add certain others as required for updating at the Server */
 	for (i = 0; mom_rtn_list[i] != JOB_ATR_LAST; ++i) {
@@ -786,7 +852,15 @@ get_job_update(job *pjob)
 int
 enqueue_update_for_send(job *pjob, int cmd)
 {
-	ruu *prused = get_job_update(pjob);
+	ruu *prused;
+
+	/*
+	 * Periodic updates from Mother Superior carry numeric resources_used
+	 * in binary form so they can be sent as deltas, see send_resc_used(),
+	 * if the Server has told us it accepts them
+	 */
+	prused = get_job_update(pjob, (cmd == IS_RESCUSED) && server_rescused2 &&
+		(pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE));
 	if (prused == NULL)
 		return 1; /* get_job_update has done error logging */
 
@@ -866,12 +940,225 @@ bundle_ruu(int *r_cnt, ruu **prused, int *rh_cnt, ruu **prhused, int *obits_cnt,
 	}
 }
 
+/**
+ * @brief
+ * 	start sending all numeric resources_used values again, called
+ * 	whenever the stream to the Server is (re)opened since the Server
+ * 	may not have seen what was sent on the previous stream
+ *
+ * @return void
+ *
+ */
+void
+reset_resc_used_delta(void)
+{
+	resc_used_epoch++;
+}
+
+/**
+ * @brief
+ * 	check whether all numeric resources_used values of a job are due
+ * 	to be sent to the Server
+ *
+ * @param[in] sent - values last sent for the job, may be NULL
+ *
+ * @return int
+ * @retval 1 - send all values
+ * @retval 0 - send only the values that have changed
+ *
+ */
+static int
+resc_used_full_due(struct resc_used_sent *sent)
+{
+	return ((sent == NULL) ||
+		(sent->rs_epoch != resc_used_epoch) ||
+		(time_now >= sent->rs_full_at + RESC_USED_FULL_INTERVAL));
+}
+
+/**
+ * @brief
+ * 	return a numeric resources_used value as a double for comparison
+ *
+ * @param[in] pnum - the value
+ *
+ * @return double
+ *
+ */
+static double
+ruu_num_value(ruu_num *pnum)
+{
+	switch (pnum->rn_type) {
+		case ATR_TYPE_LONG:
+			return (double) pnum->rn_val.at_long;
+		case ATR_TYPE_SIZE:
+			return (double) pnum->rn_val.at_size.atsv_num *
+				(double) (1ULL << pnum->rn_val.at_size.atsv_shift);
+		case ATR_TYPE_FLOAT:
+			return (double) pnum->rn_val.at_float;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ * 	check whether a numeric resources_used value has changed by more
+ * 	than resc_used_delta percent since it was last sent
+ *
+ * @param[in] old - value last sent
+ * @param[in] new - current value
+ *
+ * @return int
+ * @retval 1 - value should be sent
+ * @retval 0 - value may be left out of the update
+ *
+ */
+static int
+ruu_num_changed(ruu_num *old, ruu_num *new)
+{
+	double o;
+	double n;
+	double d;
+
+	if (old->rn_type != new->rn_type)
+		return 1;
+	if ((new->rn_type == ATR_TYPE_SIZE) &&
+	    (old->rn_val.at_size.atsv_units != new->rn_val.at_size.atsv_units))
+		return 1;
+
+	o = ruu_num_value(old);
+	n = ruu_num_value(new);
+	if (o == n)
+		return 0;
+	if (resc_used_delta <= 0)
+		return 1;
+
+	d = (n > o) ? (n - o) : (o - n);
+	if (o < 0)
+		o = -o;
+	return (d * 100.0 > o * resc_used_delta);
+}
+
+/**
+ * @brief
+ * 	drop the numeric resources_used values of an update which have not
+ * 	changed enough since they were last sent to the Server
+ *
+ * @param[in,out] rud - the update
+ *
+ * @return void
+ *
+ */
+static void
+filter_resc_used(ruu *rud)
+{
+	struct resc_used_sent *sent;
+	int i;
+	int j;
+	int k;
+
+	if (rud->ru_pjob == NULL || rud->ru_nnum == 0)
+		return;
+	sent = (struct resc_used_sent *) rud->ru_pjob->ji_resc_used_sent;
+	if (resc_used_full_due(sent))
+		return;
+
+	for (i = 0, k = 0; i < rud->ru_nnum; i++) {
+		for (j = 0; j < sent->rs_nnum; j++) {
+			if (strcmp(sent->rs_num[j].rn_name, rud->ru_num[i].rn_name) == 0)
+				break;
+		}
+		if ((j < sent->rs_nnum) && !ruu_num_changed(&sent->rs_num[j], &rud->ru_num[i]))
+			continue;
+		if (k != i)
+			rud->ru_num[k] = rud->ru_num[i];
+		k++;
+	}
+	rud->ru_nnum = k;
+}
+
+/**
+ * @brief
+ * 	record the numeric resources_used values of an update as sent
+ *
+ * @param[in] rud - the update which has been sent to the Server
+ *
+ * @return void
+ *
+ */
+static void
+commit_resc_used(ruu *rud)
+{
+	struct resc_used_sent *sent;
+	struct resc_used_sent *nsent;
+	job *pjob;
+	int i;
+	int j;
+	int n;
+
+	if ((pjob = rud->ru_pjob) == NULL || rud->ru_num == NULL)
+		return;
+	sent = (struct resc_used_sent *) pjob->ji_resc_used_sent;
+
+	if (resc_used_full_due(sent)) {
+		/* every value was sent, replace what was recorded */
+		nsent = malloc(sizeof(struct resc_used_sent) + rud->ru_nnum * sizeof(ruu_num));
+		if (nsent == NULL)
+			return;
+		nsent->rs_epoch = resc_used_epoch;
+		nsent->rs_full_at = time_now;
+		nsent->rs_nnum = rud->ru_nnum;
+		memcpy(nsent->rs_num, rud->ru_num, rud->ru_nnum * sizeof(ruu_num));
+		free(sent);
+		pjob->ji_resc_used_sent = nsent;
+		return;
+	}
+
+	/* count the values the Server has not seen before */
+	n = sent->rs_nnum;
+	for (i = 0; i < rud->ru_nnum; i++) {
+		for (j = 0; j < sent->rs_nnum; j++) {
+			if (strcmp(sent->rs_num[j].rn_name, rud->ru_num[i].rn_name) == 0)
+				break;
+		}
+		if (j == sent->rs_nnum)
+			n++;
+	}
+	if (n != sent->rs_nnum) {
+		nsent = realloc(sent, sizeof(struct resc_used_sent) + n * sizeof(ruu_num));
+		if (nsent == NULL) {
+			/* forget it all, everything is sent next time */
+			free(sent);
+			pjob->ji_resc_used_sent = NULL;
+			return;
+		}
+		pjob->ji_resc_used_sent = sent = nsent;
+	}
+
+	for (i = 0; i < rud->ru_nnum; i++) {
+		for (j = 0; j < sent->rs_nnum; j++) {
+			if (strcmp(sent->rs_num[j].rn_name, rud->ru_num[i].rn_name) == 0)
+				break;
+		}
+		sent->rs_num[j] = rud->ru_num[i];
+		if (j == sent->rs_nnum)
+			sent->rs_nnum++;
+	}
+}
+
 /**
  * @brief
  * 	Send the amount of resources used by jobs to the server
  * 	This function used to encode and send the data for IS_RESCUSED,
  * 	IS_JOBOBIT, IS_RESCUSED_FROM_HOOK.
  *
+ * 	IS_RESCUSED updates are sent as IS_RESCUSED2 if the Server advertised
+ * 	IS_FEAT_RESCUSED2 in its IS_REPLYHELLO: after the hop count of each
+ * 	job comes the number of numeric resources_used values followed by the
+ * 	name, type and value of each, and only those values which have changed
+ * 	by more than resc_used_delta percent since last sent are included.
+ * 	The remaining attributes follow as a svrattrl list.  Older Servers
+ * 	get plain IS_RESCUSED with every value in the svrattrl list.
+ *
  * @param[in] cmd   - communication command to use
  * @param[in] count - number of  jobs to update.
  * @param[in] rud   - input structure containing info about the jobs, resources used, etc...
@@ -890,12 +1177,22 @@ void
 send_resc_used(int cmd, int count, ruu *rud)
 {
 	int ret;
+	int i;
+	ruu *head = rud;
+	ruu_num *pnum;
+	int binary;
 
 	if (count == 0 || rud == NULL || server_stream < 0)
 		return;
 	DBPRT(("send_resc_used update to server on stream %d\n", server_stream))
 
-	ret = is_compose(server_stream, cmd);
+	/*
+	 * An update queued in binary form while talking to a Server which
+	 * has since been replaced by an older one loses its numeric values,
+	 * the next update carries them all in the svrattrl list.
+	 */
+	binary = (cmd == IS_RESCUSED) && server_rescused2;
+	ret = is_compose(server_stream, binary ? IS_RESCUSED2 : cmd);
 	if (ret != DIS_SUCCESS)
 		goto err;
 
@@ -930,6 +1227,39 @@ send_resc_used(int cmd, int count, ruu *rud)
 		if (ret != DIS_SUCCESS)
 			goto err;
 
+		if (binary) {
+			filter_resc_used(rud);
+			ret = diswui(server_stream, rud->ru_nnum);
+			if (ret != DIS_SUCCESS)
+				goto err;
+			for (i = 0; i < rud->ru_nnum; i++) {
+				pnum = &rud->ru_num[i];
+				ret = diswst(server_stream, pnum->rn_name);
+				if (ret != DIS_SUCCESS)
+					goto err;
+				ret = diswui(server_stream, pnum->rn_type);
+				if (ret != DIS_SUCCESS)
+					goto err;
+				switch (pnum->rn_type) {
+					case ATR_TYPE_LONG:
+						ret = diswsl(server_stream, pnum->rn_val.at_long);
+						break;
+					case ATR_TYPE_SIZE:
+						ret = diswull(server_stream, pnum->rn_val.at_size.atsv_num);
+						if (ret == DIS_SUCCESS)
+							ret = diswui(server_stream, pnum->rn_val.at_size.atsv_shift);
+						if (ret == DIS_SUCCESS)
+							ret = diswui(server_stream, pnum->rn_val.at_size.atsv_units);
+						break;
+					default:
+						ret = diswf(server_stream, pnum->rn_val.at_float);
+						break;
+				}
+				if (ret != DIS_SUCCESS)
+					goto err;
+			}
+		}
+
 		ret = encode_DIS_svrattrl(server_stream, (svrattrl *) GET_NEXT(rud->ru_attr));
 		if (ret != DIS_SUCCESS)
 			goto err;
@@ -940,6 +1270,10 @@ send_resc_used(int cmd, int count, ruu *rud)
 	if (dis_flush(server_stream) != 0)
 		goto err;
 
+	if (binary) {
+		for (rud = head; rud != NULL; rud = rud->ru_next)
+			commit_resc_used(rud);
+	}
 	return;
 
 err:
@@ -236,9 +236,11 @@ struct th_data_query_jinfo
 {
 	unsigned int error:1;
 	struct batch_status *jobs;
+	struct pbs_statstream *stream;	/* if set, jobs are read from here */
 	server_info *sinfo;
 	queue_info *qinfo;
 	resource_resv **oarr;
+	schd_error **oerrs;		/* errors of the jobs in oarr which can not run */
 	status *policy;
 	int pbs_sd;
 	int sidx;
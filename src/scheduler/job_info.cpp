@@ -501,9 +501,56 @@ static struct fc_translation_table fctt[] = {
 #define	ERR2INFO(code)		(fctt[(code) - RET_BASE].fc_info)
 
 
+/**
+ * @brief	return the job to query after cur_job in query_jobs_chunk()
+ *
+ * @param[in]	data - th_data_query_jinfo object for the querying
+ * @param[in]	cur_job - the job just queried, NULL for the first job
+ *
+ * @return struct batch_status *
+ * @retval next job
+ * @retval NULL if there are no more jobs
+ */
+static inline struct batch_status *
+next_chunk_job(th_data_query_jinfo *data, struct batch_status *cur_job)
+{
+	if (data->stream != NULL)
+		return pbs_statstream_next(data->stream);
+	if (cur_job == NULL)
+		return data->jobs;
+	return cur_job->next;
+}
+
+/**
+ * @brief	free the errors query_jobs_chunk() kept for a chunk of jobs
+ *
+ * @param[in]	errs - errors, indexed as jobs, NULL for jobs without one
+ * @param[in]	jobs - the jobs of the chunk
+ *
+ * @return void
+ */
+static void
+free_job_errs(schd_error **errs, resource_resv **jobs)
+{
+	int i;
+
+	if (errs == NULL)
+		return;
+	for (i = 0; jobs != NULL && jobs[i] != NULL; i++)
+		free_schd_error(errs[i]);
+	free(errs);
+}
+
 /**
  * @brief	pthread routine for querying a chunk of jobs
  *
+ * @par	If data->stream is set, the jobs are read from the stream until it
+ *	is exhausted and sidx/eidx are ignored.
+ *
+ * @par	The reply may still be coming off pbs_sd, so nothing is sent to the
+ *	server from here.  Jobs which can not run are given their error in
+ *	data->oerrs and updated by query_jobs() once the reply has been read.
+ *
  * @param[in,out]	data - th_data_query_jinfo object for the querying
  *
  * @return void
@@ -511,8 +558,8 @@ static struct fc_translation_table fctt[] = {
 void
 query_jobs_chunk(th_data_query_jinfo *data)
 {
-	struct batch_status *jobs;
 	resource_resv **resresv_arr;
+	schd_error **err_arr;
 	server_info *sinfo;
 	queue_info *qinfo;
 	int sidx;
@@ -526,14 +573,16 @@ query_jobs_chunk(th_data_query_jinfo *data)
 	int pbs_sd;
 	status *policy;
 
-	jobs = data->jobs;
 	sinfo = data->sinfo;
 	qinfo = data->qinfo;
 	pbs_sd = data->pbs_sd;
 	policy = data->policy;
 	sidx = data->sidx;
 	eidx = data->eidx;
-	num_jobs_chunk = eidx - sidx + 1;
+	if (data->stream != NULL)
+		num_jobs_chunk = MT_CHUNK_SIZE_MIN;
+	else
+		num_jobs_chunk = eidx - sidx + 1;
 
 	err = new_schd_error();
 	if(err == NULL) {
@@ -543,9 +592,13 @@ query_jobs_chunk(th_data_query_jinfo *data)
 	}
 
 	resresv_arr = static_cast<resource_resv **>(malloc(sizeof(resource_resv *) * (num_jobs_chunk + 1)));
-	if (resresv_arr == NULL) {
+	err_arr = static_cast<schd_error **>(calloc(num_jobs_chunk + 1, sizeof(schd_error *)));
+	if (resresv_arr == NULL || err_arr == NULL) {
 		log_err(errno, __func__, MEM_ERR_MSG);
 		data->error = 1;
+		free_schd_error(err);
+		free(resresv_arr);
+		free(err_arr);
 		return;
 	}
 	resresv_arr[0] = NULL;
@@ -553,10 +606,14 @@ query_jobs_chunk(th_data_query_jinfo *data)
 	server_time = sinfo->server_time;
 
 	/* Move to the linked list item corresponding to the 'start' index */
-	for (cur_job = jobs, i = 0; i < sidx && cur_job != NULL; cur_job = cur_job->next, i++)
-		;
+	cur_job = next_chunk_job(data, NULL);
+	if (data->stream == NULL) {
+		for (i = 0; i < sidx && cur_job != NULL; cur_job = cur_job->next, i++)
+			;
+	}
 
-	for (i = sidx, jidx = 0; i <= eidx && cur_job != NULL; cur_job = cur_job->next, i++) {
+	for (i = sidx, jidx = 0; (data->stream != NULL || i <= eidx) && cur_job != NULL;
+			cur_job = next_chunk_job(data, cur_job), i++) {
 		char *selectspec = NULL;
 		resource_resv *resresv;
 		resource_req *req;
@@ -567,10 +624,12 @@ query_jobs_chunk(th_data_query_jinfo *data)
 		time_t start;
 		time_t end;
 		long starve_num;
+		schd_error *job_err = NULL;
 
 		if ((resresv = query_job(cur_job, sinfo, err)) == NULL) {
 			data->error = 1;
 			free_schd_error(err);
+			free_job_errs(err_arr, resresv_arr);
 			free_resource_resv_array(resresv_arr);
 			return;
 		}
@@ -731,7 +790,7 @@ query_jobs_chunk(th_data_query_jinfo *data)
 					if (duration > soft_walltime_req->amount) {
 						char timebuf[128];
 						convert_duration_to_str(duration, timebuf, 128);
-						update_job_attr(pbs_sd, resresv, ATTR_estimated, "soft_walltime", timebuf, NULL, UPDATE_NOW);
+						update_job_attr(pbs_sd, resresv, ATTR_estimated, "soft_walltime", timebuf, NULL, UPDATE_LATER);
 					}
 				} else
 					/* Job has exceeded its walltime.  It'll soon be killed and be put into the exiting state.
@@ -833,14 +892,50 @@ query_jobs_chunk(th_data_query_jinfo *data)
 #endif
 
 		if (err->error_code != SUCCESS) {
-			update_job_can_not_run(pbs_sd, resresv, err);
+			resresv->can_not_run = 1;
+			job_err = dup_schd_error(err);
 			clear_schd_error(err);
+			if (job_err == NULL) {
+				log_err(errno, __func__, MEM_ERR_MSG);
+				data->error = 1;
+				free_schd_error(err);
+				free_resource_resv(resresv);
+				free_job_errs(err_arr, resresv_arr);
+				free_resource_resv_array(resresv_arr);
+				return;
+			}
 		}
+		if (jidx == num_jobs_chunk) {
+			/* only a stream can hold more jobs than we made room for */
+			resource_resv **tmp_arr;
+			schd_error **tmp_errs;
+
+			tmp_arr = static_cast<resource_resv **>(realloc(resresv_arr, sizeof(resource_resv *) * (2 * num_jobs_chunk + 1)));
+			if (tmp_arr != NULL)
+				resresv_arr = tmp_arr;
+			tmp_errs = static_cast<schd_error **>(realloc(err_arr, sizeof(schd_error *) * (2 * num_jobs_chunk + 1)));
+			if (tmp_errs != NULL)
+				err_arr = tmp_errs;
+			if (tmp_arr == NULL || tmp_errs == NULL) {
+				log_err(errno, __func__, MEM_ERR_MSG);
+				data->error = 1;
+				free_schd_error(err);
+				free_schd_error(job_err);
+				free_resource_resv(resresv);
+				free_job_errs(err_arr, resresv_arr);
+				free_resource_resv_array(resresv_arr);
+				return;
+			}
+			num_jobs_chunk *= 2;
+		}
+		err_arr[jidx] = job_err;
 		resresv_arr[jidx++] = resresv;
+		resresv_arr[jidx] = NULL;
 	}
 
 	resresv_arr[jidx] = NULL;
 	data->oarr = resresv_arr;
+	data->oerrs = err_arr;
 
 	free_schd_error(err);
 }
@@ -851,6 +946,7 @@ query_jobs_chunk(th_data_query_jinfo *data)
  * @param[in]	policy	-	policy info
  * @param[in]	pbs_sd	-	connection to pbs_server
  * @param[in]	jobs	-	batch_status of jobs
+ * @param[in]	stream	-	stream to read the jobs from instead of jobs
  * @param[in]	qinfo	-	queue to get jobs from
  * @param[in]	sidx	-	start index for the jobs list for the thread
  * @param[in]	eidx	-	end index for the jobs list for the thread
@@ -860,8 +956,8 @@ query_jobs_chunk(th_data_query_jinfo *data)
  * @retval NULL for malloc error
  */
 static inline th_data_query_jinfo *
-alloc_tdata_jquery(status *policy, int pbs_sd, struct batch_status *jobs, queue_info *qinfo,
-		int sidx, int eidx)
+alloc_tdata_jquery(status *policy, int pbs_sd, struct batch_status *jobs,
+		struct pbs_statstream *stream, queue_info *qinfo, int sidx, int eidx)
 {
 	th_data_query_jinfo *tdata = NULL;
 
@@ -872,7 +968,9 @@ alloc_tdata_jquery(status *policy, int pbs_sd, struct batch_status *jobs, queue_
 	}
 	tdata->error = 0;
 	tdata->jobs = jobs;
+	tdata->stream = stream;
 	tdata->oarr = NULL; /* Will be filled by the thread routine */
+	tdata->oerrs = NULL;
 	tdata->sinfo = qinfo->server;
 	tdata->qinfo = qinfo;
 	tdata->pbs_sd = pbs_sd;
@@ -914,7 +1012,10 @@ query_jobs(status *policy, int pbs_sd, queue_info *qinfo, resource_resv **pjobs,
 	static struct attrl *attrib = NULL;
 	int i;
 
-	/* linked list of jobs returned from pbs_selstat() */
+	/* stream of jobs returned from pbs_selstat_stream() */
+	struct pbs_statstream *stream;
+
+	/* a chunk of jobs read off the stream */
 	struct batch_status *jobs;
 
 	/* current job in jobs linked list */
@@ -941,6 +1042,7 @@ query_jobs(status *policy, int pbs_sd, queue_info *qinfo, resource_resv **pjobs,
 	int num_tasks;
 	int th_err = 0;
 	resource_resv ***jinfo_arrs_tasks;
+	schd_error ***jinfo_errs_tasks;
 	int tid;
 
 	const char *jobattrs[] = {
@@ -1003,8 +1105,8 @@ query_jobs(status *policy, int pbs_sd, queue_info *qinfo, resource_resv **pjobs,
 		}
 	}
 
-	/* get jobs from PBS server */
-	if ((jobs = pbs_selstat(pbs_sd, &opl, attrib, const_cast<char *>("S"))) == NULL) {
+	/* get jobs from PBS server; they are queried as they come off the stream */
+	if ((stream = pbs_selstat_stream(pbs_sd, &opl, attrib, const_cast<char *>("S"))) == NULL) {
 		if (pbs_errno > 0) {
 			errmsg = pbs_geterrmsg(pbs_sd);
 			if (errmsg == NULL)
@@ -1015,64 +1117,46 @@ query_jobs(status *policy, int pbs_sd, queue_info *qinfo, resource_resv **pjobs,
 		return pjobs;
 	}
 
-	/* count the number of new jobs */
-	cur_job = jobs;
-	while (cur_job != NULL) {
-		num_jobs++;
-		cur_job = cur_job->next;
-	}
-	num_new_jobs = num_jobs;
-
-	/* if there are previous jobs, count those too */
-	num_prev_jobs = count_array(pjobs);
-	num_jobs += num_prev_jobs;
-
-
-	/* allocate enough space for all the jobs and the NULL sentinal */
-	resresv_arr = static_cast<resource_resv **>(realloc(pjobs, sizeof(resource_resv*) * (num_jobs + 1)));
-
-	if (resresv_arr == NULL) {
-		log_err(errno, __func__, MEM_ERR_MSG);
-		pbs_statfree(jobs);
-		return NULL;
-	}
-	resresv_arr[num_prev_jobs] = NULL;
-
 	tid = *((int *) pthread_getspecific(th_id_key));
 	if (tid != 0 || num_threads <= 1) {
 		/* don't use multi-threading if I am a worker thread or num_threads is 1 */
-		tdata = alloc_tdata_jquery(policy, pbs_sd, jobs, qinfo, 0, num_new_jobs - 1);
-		if (tdata == NULL) {
-			pbs_statfree(jobs);
+		num_tasks = 1;
+		jinfo_arrs_tasks = static_cast<resource_resv ***>(calloc(num_tasks, sizeof(resource_resv**)));
+		jinfo_errs_tasks = static_cast<schd_error ***>(calloc(num_tasks, sizeof(schd_error**)));
+		tdata = alloc_tdata_jquery(policy, pbs_sd, NULL, stream, qinfo, 0, 0);
+		if (jinfo_arrs_tasks == NULL || jinfo_errs_tasks == NULL || tdata == NULL) {
+			if (jinfo_arrs_tasks == NULL || jinfo_errs_tasks == NULL)
+				log_err(errno, __func__, MEM_ERR_MSG);
+			free(tdata);
+			free(jinfo_arrs_tasks);
+			free(jinfo_errs_tasks);
+			pbs_statstream_close(stream);
 			return NULL;
 		}
 		query_jobs_chunk(tdata);
 
-		if (tdata->error || tdata->oarr == NULL) {
-			pbs_statfree(jobs);
-			return NULL;
-		}
-
-		for (j = 0, jidx = num_prev_jobs; tdata->oarr[j] != NULL; j++) {
-			resresv_arr[jidx++] = tdata->oarr[j];
-		}
-		free(tdata->oarr);
+		if (tdata->error || tdata->oarr == NULL)
+			th_err = 1;
+		jinfo_arrs_tasks[0] = tdata->oarr;
+		jinfo_errs_tasks[0] = tdata->oerrs;
 		free(tdata);
-		resresv_arr[jidx] = NULL;
 	} else {
-		chunk_size = num_new_jobs / num_threads;
-		chunk_size = (chunk_size > MT_CHUNK_SIZE_MIN) ? chunk_size : MT_CHUNK_SIZE_MIN;
-		chunk_size = (chunk_size < MT_CHUNK_SIZE_MAX) ? chunk_size : MT_CHUNK_SIZE_MAX;
-		for (j = 0, num_tasks = 0; num_new_jobs > 0;
-				num_tasks++, j += chunk_size, num_new_jobs -= chunk_size) {
-			tdata = alloc_tdata_jquery(policy, pbs_sd, jobs, qinfo, j, j + chunk_size - 1);
+		/* hand the jobs to the worker threads a chunk at a time while the
+		 * rest of the reply is still being read
+		 */
+		for (num_tasks = 0; (jobs = pbs_statstream_nextn(stream, MT_CHUNK_SIZE_MIN)) != NULL; num_tasks++) {
+			for (cur_job = jobs, chunk_size = 0; cur_job != NULL; cur_job = cur_job->next)
+				chunk_size++;
+			tdata = alloc_tdata_jquery(policy, pbs_sd, jobs, NULL, qinfo, 0, chunk_size - 1);
 			if (tdata == NULL) {
+				pbs_statfree(jobs);
 				th_err = 1;
 				break;
 			}
 			task = static_cast<th_task_info *>(malloc(sizeof(th_task_info)));
 			if (task == NULL) {
 				free(tdata);
+				pbs_statfree(jobs);
 				log_err(errno, __func__, MEM_ERR_MSG);
 				th_err = 1;
 				break;
@@ -1086,9 +1170,14 @@ query_jobs(status *policy, int pbs_sd, queue_info *qinfo, resource_resv **pjobs,
 			pthread_cond_signal(&work_cond);
 			pthread_mutex_unlock(&work_lock);
 		}
-		jinfo_arrs_tasks = static_cast<resource_resv ***>(malloc(num_tasks * sizeof(resource_resv**)));
-		if (jinfo_arrs_tasks == NULL) {
+		jinfo_arrs_tasks = static_cast<resource_resv ***>(calloc(num_tasks + 1, sizeof(resource_resv**)));
+		jinfo_errs_tasks = static_cast<schd_error ***>(calloc(num_tasks + 1, sizeof(schd_error**)));
+		if (jinfo_arrs_tasks == NULL || jinfo_errs_tasks == NULL) {
 			log_err(errno, __func__, MEM_ERR_MSG);
+			free(jinfo_arrs_tasks);
+			free(jinfo_errs_tasks);
+			jinfo_arrs_tasks = NULL;
+			jinfo_errs_tasks = NULL;
 			th_err = 1;
 		}
 		/* Get results from worker threads */
@@ -1101,32 +1190,84 @@ query_jobs(status *policy, int pbs_sd, queue_info *qinfo, resource_resv **pjobs,
 				tdata = (th_data_query_jinfo*) task->thread_data;
 				if (tdata->error)
 					th_err = 1;
-				jinfo_arrs_tasks[task->task_id] = tdata->oarr;
+				if (jinfo_arrs_tasks != NULL) {
+					jinfo_arrs_tasks[task->task_id] = tdata->oarr;
+					jinfo_errs_tasks[task->task_id] = tdata->oerrs;
+				} else {
+					free_job_errs(tdata->oerrs, tdata->oarr);
+					free_resource_resv_array(tdata->oarr);
+				}
+				pbs_statfree(tdata->jobs);
 				free(tdata);
 				free(task);
 				i++;
 			}
 			pthread_mutex_unlock(&result_lock);
 		}
-		if (th_err) {
-			pbs_statfree(jobs);
-			free_resource_resv_array(resresv_arr);
-			return NULL;
+	}
+
+	if (pbs_statstream_close(stream) == PBSE_PROTOCOL) {
+		/* the reply was cut short, so the list of jobs is incomplete */
+		errmsg = pbs_geterrmsg(pbs_sd);
+		if (errmsg == NULL)
+			errmsg = "";
+		log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, LOG_NOTICE, "job_info",
+				"pbs_selstat failed: %s (%d)", errmsg, PBSE_PROTOCOL);
+		th_err = 1;
+	}
+
+	/* count the number of new jobs */
+	num_new_jobs = 0;
+	for (i = 0; jinfo_arrs_tasks != NULL && i < num_tasks; i++)
+		num_new_jobs += count_array(jinfo_arrs_tasks[i]);
+
+	/* if there are previous jobs, count those too */
+	num_prev_jobs = count_array(pjobs);
+	num_jobs = num_prev_jobs + num_new_jobs;
+
+	/* allocate enough space for all the jobs and the NULL sentinal */
+	resresv_arr = NULL;
+	if (!th_err) {
+		resresv_arr = static_cast<resource_resv **>(realloc(pjobs, sizeof(resource_resv*) * (num_jobs + 1)));
+		if (resresv_arr == NULL) {
+			log_err(errno, __func__, MEM_ERR_MSG);
+			th_err = 1;
 		}
-		/* Assemble job info objects from various threads into the resresv_arr */
-		for (i = 0, jidx = num_prev_jobs; i < num_tasks; i++) {
-			if (jinfo_arrs_tasks[i] != NULL) {
-				for (j = 0; jinfo_arrs_tasks[i][j] != NULL; j++) {
-					resresv_arr[jidx++] = jinfo_arrs_tasks[i][j];
-				}
-				free(jinfo_arrs_tasks[i]);
-			}
+	}
+
+	if (th_err) {
+		for (i = 0; jinfo_arrs_tasks != NULL && i < num_tasks; i++) {
+			free_job_errs(jinfo_errs_tasks[i], jinfo_arrs_tasks[i]);
+			free_resource_resv_array(jinfo_arrs_tasks[i]);
 		}
-		resresv_arr[jidx] = NULL;
 		free(jinfo_arrs_tasks);
+		free(jinfo_errs_tasks);
+		free_resource_resv_array(pjobs);
+		return NULL;
 	}
 
-	pbs_statfree(jobs);
+	/* Assemble job info objects from various threads into the resresv_arr.
+	 * The whole reply has been read, so the updates the jobs picked up while
+	 * being queried can now be sent.
+	 */
+	for (i = 0, jidx = num_prev_jobs; i < num_tasks; i++) {
+		if (jinfo_arrs_tasks[i] != NULL) {
+			for (j = 0; jinfo_arrs_tasks[i][j] != NULL; j++) {
+				resource_resv *resresv = jinfo_arrs_tasks[i][j];
+
+				if (jinfo_errs_tasks[i] != NULL && jinfo_errs_tasks[i][j] != NULL)
+					update_job_can_not_run(pbs_sd, resresv, jinfo_errs_tasks[i][j]);
+				else if (resresv->job->attr_updates != NULL)
+					send_job_updates(pbs_sd, resresv);
+				resresv_arr[jidx++] = resresv;
+			}
+			free_job_errs(jinfo_errs_tasks[i], jinfo_arrs_tasks[i]);
+			free(jinfo_arrs_tasks[i]);
+		}
+	}
+	resresv_arr[jidx] = NULL;
+	free(jinfo_arrs_tasks);
+	free(jinfo_errs_tasks);
 
 	return resresv_arr;
 }
@@ -155,6 +155,7 @@ on_segv(int sig)
 	if ((segv_last_time - segv_start_time) < 300) {
 		log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__,
 			   "received a sigsegv within 5 minutes of start: aborting.");
+		log_async_flush();
 
 		/* Not unlocking mutex on purpose, we need to hold on to it until the process is killed */
 		abort();
@@ -162,6 +163,7 @@ on_segv(int sig)
 
 	log_record(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__,
 		   "received segv and restarting");
+	log_async_flush();
 
 	if (fork() > 0) {  /* the parent rexec's itself */
 		sleep(10); /* allow the child to die */
@@ -1073,6 +1075,9 @@ sched_main(int argc, char *argv[], schedule_func sched_ptr)
 	daemon_protect(0, PBS_DAEMON_PROTECT_ON);
 	freopen("/dev/null", "r", stdin);
 
+	/* the log writer thread must be started after forking */
+	(void) log_async_start(pbs_conf.pbs_log_async);
+
 	/* write schedulers pid into lockfile */
 	(void) ftruncate(lockfds, (off_t) 0);
 	(void) sprintf(log_buffer, "%ld\n", (long) pid);
@@ -48,6 +48,7 @@
  *	acct_open()
  *	acct_record()
  *	acct_close()
+ *	acct_async_start()
  */
 
 
@@ -62,6 +63,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <pthread.h>
+#include <signal.h>
 #include "list_link.h"
 #include "attribute.h"
 #include "resource.h"
@@ -72,7 +75,9 @@
 #include "pbs_nodes.h"
 #include "log.h"
 #include "acct.h"
+#include "acct_bin.h"
 #include "pbs_license.h"
+#include "pbs_internal.h"
 #include "server.h"
 #include "svrfunc.h"
 #include "libutil.h"
@@ -80,6 +85,7 @@
 /* Local Data */
 
 static FILE *acctfile;		/* open stream for log file */
+static FILE *acctbinfile = NULL;	/* binary sidecar of acctfile, if any */
 static volatile int acct_opened = 0;
 static int acct_opened_day;
 static int acct_auto_switch = 0;
@@ -87,9 +93,76 @@ static char *acct_buf = 0;
 static int acct_bufsize = PBS_ACCT_MAX_RCD;
 static const char *do_not_emit_alter[] = {ATTR_estimated, ATTR_used, NULL};
 
+/*
+ * Records are appended to acct_q by write_account_record() and written out
+ * by acct_flush(), which swaps acct_q with acct_wq and writes the whole
+ * batch with one fwrite() and fflush(), and appends its binary form to the
+ * sidecar.  Without the writer thread (PBS_ACCT_ASYNC) acct_flush() is
+ * called for each record.  With it, the thread flushes every
+ * ACCT_ASYNC_INTERVAL_MS, or sooner once half of ACCT_ASYNC_MAX is queued;
+ * a full queue makes write_account_record() wait for the thread.
+ *
+ * acct_io_mutex serializes acct_flush() with opening and closing the files,
+ * acct_q_mutex protects acct_q.  acct_io_mutex is always taken first.
+ */
+#define ACCT_ASYNC_MAX		(16 * 1024 * 1024)
+#define ACCT_ASYNC_INTERVAL_MS	100
+#define ACCT_BIN_NKEYS		8192	/* slots in the key table of a sidecar section */
+#define ACCT_BIN_MAXKEYS	(ACCT_BIN_NKEYS / 4)	/* keys before a new section is started */
+#define ACCT_BIN_MAXKEYLEN	256
+
+struct acct_qrec {
+	time_t	qr_time;	/* time of the record */
+	size_t	qr_off;		/* offset of the record in qb_buf */
+	size_t	qr_len;		/* length of the record, with its newline */
+};
+
+struct acct_qbuf {
+	char			*qb_buf;	/* records, as written to the file */
+	size_t			qb_len;
+	size_t			qb_size;
+	struct acct_qrec	*qb_recs;	/* where each record is in qb_buf */
+	int			qb_nrec;
+	int			qb_maxrec;
+};
+
+struct acct_bbuf {
+	char	*bb_buf;
+	size_t	bb_len;
+	size_t	bb_size;
+};
+
+static struct acct_qbuf acct_q;		/* records being queued */
+static struct acct_qbuf acct_wq;	/* records being written */
+static volatile int acct_async_on = 0;
+static pthread_t acct_async_tid;
+static pthread_mutex_t acct_io_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t acct_q_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t acct_q_cond = PTHREAD_COND_INITIALIZER;	/* records queued */
+static pthread_cond_t acct_space_cond = PTHREAD_COND_INITIALIZER;	/* acct_q emptied */
+static int acct_write_failed = 0;	/* a write failed and was logged */
+static volatile sig_atomic_t acct_reopen_pending = 0;	/* set by acct_reopen() */
+
+/* cached timestamp of write_account_record(), redone once a second */
+static time_t acct_ts_sec = -1;
+static int acct_ts_yday;
+static char acct_ts[24];
+
+/* keys of the current sidecar section, see acct_bin.h */
+static struct {
+	char		*key;
+	unsigned int	idx;
+} acct_bin_keys[ACCT_BIN_NKEYS];
+static unsigned int acct_bin_nkeys = 0;		/* keys in acct_bin_keys */
+static unsigned int acct_bin_nextidx = 1;	/* index of the next new key */
+static struct acct_bbuf acct_bin_out;	/* binary form of a batch */
+static struct acct_bbuf acct_bin_fld;	/* fields of one record */
+static struct acct_bbuf acct_bin_hdr;	/* header of one record */
+
 /* Global Data */
 
 extern char *acctlog_spacechar;
+extern char *acct_file;
 extern attribute_def job_attr_def[];
 extern char *path_acct;
 extern int resc_access_perm;
@@ -911,12 +984,625 @@ acct_resv(resc_resv *presv, char *buf, int len)
 	return (pb);
 }
 
+/**
+ * @brief
+ *	Make room for 'need' more bytes in a buffer that holds 'len' bytes.
+ *
+ * @param[in,out]	pbuf - the buffer, may be reallocated
+ * @param[in,out]	psize - size of the buffer
+ * @param[in]	len - bytes used in the buffer
+ * @param[in]	need - bytes to add
+ *
+ * @return	int
+ * @retval	 0 - there is room
+ * @retval	-1 - out of memory
+ */
+static int
+acct_grow(char **pbuf, size_t *psize, size_t len, size_t need)
+{
+	size_t sz;
+	char *new;
+
+	if (len + need <= *psize)
+		return 0;
+	sz = (*psize == 0) ? 65536 : *psize;
+	while (sz < len + need)
+		sz *= 2;
+	if ((new = realloc(*pbuf, sz)) == NULL)
+		return -1;
+	*pbuf = new;
+	*psize = sz;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Make room in a record queue for one more record of 'need' bytes.
+ *
+ * @param[in,out]	qb - the queue
+ * @param[in]	need - length of the record
+ *
+ * @return	int
+ * @retval	 0 - there is room
+ * @retval	-1 - out of memory
+ */
+static int
+acct_qbuf_reserve(struct acct_qbuf *qb, size_t need)
+{
+	struct acct_qrec *recs;
+	int n;
+
+	if (acct_grow(&qb->qb_buf, &qb->qb_size, qb->qb_len, need) != 0)
+		return -1;
+	if (qb->qb_nrec == qb->qb_maxrec) {
+		n = (qb->qb_maxrec == 0) ? 1024 : qb->qb_maxrec * 2;
+		if ((recs = realloc(qb->qb_recs, n * sizeof(struct acct_qrec))) == NULL)
+			return -1;
+		qb->qb_recs = recs;
+		qb->qb_maxrec = n;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Append bytes to a binary buffer.
+ *
+ * @param[in,out]	bb - the buffer
+ * @param[in]	data - bytes to append
+ * @param[in]	len - number of bytes
+ *
+ * @return	int
+ * @retval	 0 - success
+ * @retval	-1 - out of memory
+ */
+static int
+acct_bin_put(struct acct_bbuf *bb, const void *data, size_t len)
+{
+	if (acct_grow(&bb->bb_buf, &bb->bb_size, bb->bb_len, len) != 0)
+		return -1;
+	memcpy(bb->bb_buf + bb->bb_len, data, len);
+	bb->bb_len += len;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Append a varint to a binary buffer.
+ *
+ * @param[in,out]	bb - the buffer
+ * @param[in]	v - the value
+ *
+ * @return	int
+ * @retval	 0 - success
+ * @retval	-1 - out of memory
+ */
+static int
+acct_bin_varint(struct acct_bbuf *bb, unsigned long long v)
+{
+	unsigned char b[10];
+	int n = 0;
+
+	do {
+		b[n] = v & 0x7f;
+		v >>= 7;
+		if (v)
+			b[n] |= 0x80;
+		n++;
+	} while (v);
+	return acct_bin_put(bb, b, n);
+}
+
+/**
+ * @brief
+ *	Append a string, its length first, to a binary buffer.
+ *
+ * @param[in,out]	bb - the buffer
+ * @param[in]	str - the string, not necessarily null terminated
+ * @param[in]	len - its length
+ *
+ * @return	int
+ * @retval	 0 - success
+ * @retval	-1 - out of memory
+ */
+static int
+acct_bin_str(struct acct_bbuf *bb, const char *str, size_t len)
+{
+	if (acct_bin_varint(bb, len) != 0)
+		return -1;
+	return acct_bin_put(bb, str, len);
+}
+
+/**
+ * @brief
+ *	Forget the keys of the current sidecar section.
+ *
+ * @return	void
+ */
+static void
+acct_bin_reset(void)
+{
+	int i;
+
+	for (i = 0; i < ACCT_BIN_NKEYS; i++) {
+		free(acct_bin_keys[i].key);
+		acct_bin_keys[i].key = NULL;
+	}
+	acct_bin_nkeys = 0;
+	acct_bin_nextidx = 1;
+}
+
+/**
+ * @brief
+ *	Append the reference to a key to acct_bin_fld: its index if the key
+ *	is known in the section, else 0 and the key, which gets the next index.
+ *
+ * @param[in]	key - the key, not null terminated
+ * @param[in]	len - its length
+ *
+ * @return	int
+ * @retval	 0 - success
+ * @retval	-1 - out of memory
+ */
+static int
+acct_bin_key(const char *key, size_t len)
+{
+	unsigned int h = 2166136261u;
+	unsigned int slot;
+	size_t i;
+	char *pk;
+
+	for (i = 0; i < len; i++)
+		h = (h ^ (unsigned char) key[i]) * 16777619u;
+
+	for (slot = h & (ACCT_BIN_NKEYS - 1); acct_bin_keys[slot].key != NULL;
+		slot = (slot + 1) & (ACCT_BIN_NKEYS - 1)) {
+		pk = acct_bin_keys[slot].key;
+		if ((strncmp(pk, key, len) == 0) && (pk[len] == '\0'))
+			return acct_bin_varint(&acct_bin_fld, acct_bin_keys[slot].idx);
+	}
+
+	/* a key that does not fit in the table is sent again each time */
+	if ((acct_bin_nkeys < ACCT_BIN_NKEYS / 2) && ((pk = malloc(len + 1)) != NULL)) {
+		memcpy(pk, key, len);
+		pk[len] = '\0';
+		acct_bin_keys[slot].key = pk;
+		acct_bin_keys[slot].idx = acct_bin_nextidx;
+		acct_bin_nkeys++;
+	}
+	acct_bin_nextidx++;
+
+	if (acct_bin_varint(&acct_bin_fld, 0) != 0)
+		return -1;
+	return acct_bin_str(&acct_bin_fld, key, len);
+}
+
+/**
+ * @brief
+ *	Check whether a value is a decimal integer that prints back the same.
+ *
+ * @param[in]	val - the value, not null terminated
+ * @param[in]	len - its length
+ * @param[out]	pn - the integer
+ *
+ * @return	int
+ * @retval	1 - it is
+ * @retval	0 - it is not
+ */
+static int
+acct_bin_isint(const char *val, size_t len, long long *pn)
+{
+	size_t i = 0;
+	long long n = 0;
+
+	if ((len > 0) && (val[0] == '-'))
+		i = 1;
+	if ((len == i) || (len - i > 18))
+		return 0;
+	if ((val[i] == '0') && (len > 1))
+		return 0;	/* leading zero, or -0 */
+	for (; i < len; i++) {
+		if (val[i] < '0' || val[i] > '9')
+			return 0;
+		n = n * 10 + (val[i] - '0');
+	}
+	*pn = (val[0] == '-') ? -n : n;
+	return 1;
+}
+
+/**
+ * @brief
+ *	Check whether a value is a hh:mm:ss duration that prints back the
+ *	same with "%02lld:%02d:%02d".
+ *
+ * @param[in]	val - the value, not null terminated
+ * @param[in]	len - its length
+ * @param[out]	pn - the duration in seconds
+ *
+ * @return	int
+ * @retval	1 - it is
+ * @retval	0 - it is not
+ */
+static int
+acct_bin_isdur(const char *val, size_t len, long long *pn)
+{
+	size_t hl;
+	size_t i;
+	long long h = 0;
+	int m;
+	int s;
+
+	if ((len < 8) || (len > 20))
+		return 0;
+	hl = len - 6;
+	if ((val[hl] != ':') || (val[hl + 3] != ':') || ((hl > 2) && (val[0] == '0')))
+		return 0;
+	for (i = 0; i < len; i++) {
+		if ((i == hl) || (i == hl + 3))
+			continue;
+		if (val[i] < '0' || val[i] > '9')
+			return 0;
+		if (i < hl)
+			h = h * 10 + (val[i] - '0');
+	}
+	m = (val[hl + 1] - '0') * 10 + (val[hl + 2] - '0');
+	s = (val[hl + 4] - '0') * 10 + (val[hl + 5] - '0');
+	if ((m > 59) || (s > 59))
+		return 0;
+	*pn = h * 3600 + m * 60 + s;
+	return 1;
+}
+
+/**
+ * @brief
+ *	Append the type and the value of a field to acct_bin_fld.
+ *
+ * @param[in]	val - the value, without its quotes, not null terminated
+ * @param[in]	len - its length
+ * @param[in]	quote - the quote character around the value, or 0
+ *
+ * @return	int
+ * @retval	 0 - success
+ * @retval	-1 - out of memory
+ */
+static int
+acct_bin_value(const char *val, size_t len, char quote)
+{
+	unsigned char t[2];
+	long long n;
+
+	if (quote) {
+		t[0] = ACCT_BIN_QSTR;
+		t[1] = quote;
+		if (acct_bin_put(&acct_bin_fld, t, 2) != 0)
+			return -1;
+	} else if (acct_bin_isint(val, len, &n)) {
+		t[0] = ACCT_BIN_INT;
+		if (acct_bin_put(&acct_bin_fld, t, 1) != 0)
+			return -1;
+		return acct_bin_varint(&acct_bin_fld,
+			((unsigned long long) n << 1) ^ (unsigned long long) (n >> 63));
+	} else if (acct_bin_isdur(val, len, &n)) {
+		t[0] = ACCT_BIN_DUR;
+		if (acct_bin_put(&acct_bin_fld, t, 1) != 0)
+			return -1;
+		return acct_bin_varint(&acct_bin_fld, n);
+	} else {
+		t[0] = ACCT_BIN_STR;
+		if (acct_bin_put(&acct_bin_fld, t, 1) != 0)
+			return -1;
+	}
+	return acct_bin_str(&acct_bin_fld, val, len);
+}
+
+/**
+ * @brief
+ *	Append the binary form of a text accounting record to acct_bin_out.
+ *
+ * @param[in]	line - the record, "date time;type;id;text\n"
+ * @param[in]	len - its length
+ * @param[in]	t - time of the record
+ *
+ * @return	int
+ * @retval	 0 - success, or the record is not in the expected form
+ * @retval	-1 - out of memory, acct_bin_out is unchanged
+ */
+static int
+acct_bin_record(const char *line, size_t len, time_t t)
+{
+	const char *end = line + len - 1;	/* the newline */
+	const char *id;
+	const char *idend;
+	const char *p;
+	const char *q;
+	const char *key;
+	const char *val;
+	const char *vend;
+	size_t klen;
+	size_t outlen = acct_bin_out.bb_len;
+	char quote;
+	unsigned char b;
+	unsigned long long nfields = 0;
+
+	if (((p = memchr(line, ';', end - line)) == NULL) || (end - p < 4) || (p[2] != ';'))
+		return 0;
+	b = p[1];	/* record type */
+	id = p + 3;
+	if ((idend = memchr(id, ';', end - id)) == NULL)
+		return 0;
+
+	/* each word of the text is a field, "key=value" or a bare value */
+	acct_bin_fld.bb_len = 0;
+	for (p = idend + 1; p < end;) {
+		if (*p == ' ') {
+			p++;
+			continue;
+		}
+		for (q = p; (q < end) && (*q != '=') && (*q != ' ') && (*q != '"') && (*q != '\''); q++)
+			;
+		if ((q < end) && (*q == '=') && (q > p) && (q - p <= ACCT_BIN_MAXKEYLEN)) {
+			key = p;
+			klen = q - p;
+			val = q + 1;
+		} else {
+			key = "";
+			klen = 0;
+			val = p;
+		}
+
+		/* a quoted value runs to its closing quote, see cpy_quote_value() */
+		quote = 0;
+		vend = NULL;
+		if ((val < end) && ((*val == '"') || (*val == '\''))) {
+			vend = memchr(val + 1, *val, end - val - 1);
+			if ((vend != NULL) && ((vend + 1 == end) || (vend[1] == ' '))) {
+				quote = *val;
+				val++;
+				p = vend + 1;
+			} else
+				vend = NULL;
+		}
+		if (vend == NULL) {
+			if ((vend = memchr(val, ' ', end - val)) == NULL)
+				vend = end;
+			p = vend;
+		}
+
+		if ((acct_bin_key(key, klen) != 0) || (acct_bin_value(val, vend - val, quote) != 0))
+			return -1;
+		nfields++;
+	}
+
+	acct_bin_hdr.bb_len = 0;
+	if ((acct_bin_varint(&acct_bin_hdr, (unsigned long long) t) != 0) ||
+		(acct_bin_put(&acct_bin_hdr, &b, 1) != 0) ||
+		(acct_bin_str(&acct_bin_hdr, id, idend - id) != 0) ||
+		(acct_bin_varint(&acct_bin_hdr, nfields) != 0))
+		return -1;
+
+	b = ACCT_BIN_REC;
+	if ((acct_bin_put(&acct_bin_out, &b, 1) != 0) ||
+		(acct_bin_varint(&acct_bin_out, acct_bin_hdr.bb_len + acct_bin_fld.bb_len) != 0) ||
+		(acct_bin_put(&acct_bin_out, acct_bin_hdr.bb_buf, acct_bin_hdr.bb_len) != 0) ||
+		(acct_bin_put(&acct_bin_out, acct_bin_fld.bb_buf, acct_bin_fld.bb_len) != 0)) {
+		acct_bin_out.bb_len = outlen;
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Append the binary form of a batch of records to the sidecar file.
+ *	Called with acct_io_mutex held.
+ *
+ * @param[in]	qb - the records
+ *
+ * @return	void
+ */
+static void
+acct_bin_write(struct acct_qbuf *qb)
+{
+	struct acct_qrec *pr;
+	int i;
+
+	acct_bin_out.bb_len = 0;
+	for (i = 0; i < qb->qb_nrec; i++) {
+		pr = &qb->qb_recs[i];
+
+		/* start a new section before the key table gets crowded */
+		if (acct_bin_nkeys >= ACCT_BIN_MAXKEYS) {
+			acct_bin_reset();
+			if (acct_bin_put(&acct_bin_out, ACCT_BIN_MAGIC, ACCT_BIN_MAGIC_LEN) != 0)
+				break;
+		}
+		if (acct_bin_record(qb->qb_buf + pr->qr_off, pr->qr_len, pr->qr_time) != 0) {
+			/* keys of the lost record may be half known, start over */
+			log_err(ENOMEM, __func__, "record left out of the binary accounting file");
+			acct_bin_nkeys = ACCT_BIN_MAXKEYS;
+		}
+	}
+
+	if (acct_bin_out.bb_len == 0)
+		return;
+	if ((fwrite(acct_bin_out.bb_buf, 1, acct_bin_out.bb_len, acctbinfile) != acct_bin_out.bb_len) ||
+		(fflush(acctbinfile) != 0)) {
+		/* a partial record would garble the rest of the section */
+		log_err(errno, __func__, "cannot write to the binary accounting file, closing it");
+		(void)fclose(acctbinfile);
+		acctbinfile = NULL;
+	}
+}
+
+/**
+ * @brief
+ *	Write out every queued record.
+ *
+ * @return	void
+ */
+static void
+acct_flush(void)
+{
+	struct acct_qbuf tmp;
+	int rc;
+
+	pthread_mutex_lock(&acct_io_mutex);
+
+	pthread_mutex_lock(&acct_q_mutex);
+	tmp = acct_wq;
+	acct_wq = acct_q;
+	acct_q = tmp;
+	acct_q.qb_len = 0;
+	acct_q.qb_nrec = 0;
+	pthread_cond_broadcast(&acct_space_cond);
+	pthread_mutex_unlock(&acct_q_mutex);
+
+	if ((acct_wq.qb_len > 0) && (acct_opened == 1)) {
+		if ((fwrite(acct_wq.qb_buf, 1, acct_wq.qb_len, acctfile) != acct_wq.qb_len) ||
+			(fflush(acctfile) != 0)) {
+			rc = errno;
+			clearerr(acctfile);
+			if (!acct_write_failed)
+				log_err(rc, __func__, "cannot write to the accounting file");
+			acct_write_failed = 1;
+		} else
+			acct_write_failed = 0;
+
+		if (acctbinfile != NULL)
+			acct_bin_write(&acct_wq);
+	}
+	acct_wq.qb_len = 0;
+	acct_wq.qb_nrec = 0;
+
+	pthread_mutex_unlock(&acct_io_mutex);
+}
+
+/**
+ * @brief
+ *	Main loop of the accounting writer thread.
+ *
+ * @param[in]	arg - unused
+ *
+ * @return	void *
+ */
+static void *
+acct_async_main(void *arg)
+{
+	sigset_t block_mask;
+	struct timespec ts;
+
+	/* leave the server's signals to the main thread */
+	sigfillset(&block_mask);
+	pthread_sigmask(SIG_BLOCK, &block_mask, NULL);
+
+	for (;;) {
+		pthread_mutex_lock(&acct_q_mutex);
+		while (acct_q.qb_len == 0)
+			pthread_cond_wait(&acct_q_cond, &acct_q_mutex);
+		if (acct_q.qb_len < ACCT_ASYNC_MAX / 2) {
+			/* let a batch gather */
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_nsec += ACCT_ASYNC_INTERVAL_MS * 1000000L;
+			if (ts.tv_nsec >= 1000000000L) {
+				ts.tv_sec++;
+				ts.tv_nsec -= 1000000000L;
+			}
+			pthread_cond_timedwait(&acct_q_cond, &acct_q_mutex, &ts);
+		}
+		pthread_mutex_unlock(&acct_q_mutex);
+
+		acct_flush();
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	pthread_atfork() handlers, so a child of the server finds the
+ *	accounting mutexes free.  The child has no writer thread and does not
+ *	write the records queued by the server.
+ */
+static void
+acct_atfork_prepare(void)
+{
+	pthread_mutex_lock(&acct_io_mutex);
+	pthread_mutex_lock(&acct_q_mutex);
+}
+
+static void
+acct_atfork_parent(void)
+{
+	pthread_mutex_unlock(&acct_q_mutex);
+	pthread_mutex_unlock(&acct_io_mutex);
+}
+
+static void
+acct_atfork_child(void)
+{
+	acct_q.qb_len = 0;
+	acct_q.qb_nrec = 0;
+	acct_async_on = 0;
+	pthread_mutex_unlock(&acct_q_mutex);
+	pthread_mutex_unlock(&acct_io_mutex);
+}
+
+/**
+ * @brief
+ *	Start the accounting writer thread, after which accounting records
+ *	are written in batches in the background.
+ *
+ * @par
+ *	Must be called after the server has forked into the background, as
+ *	the thread does not survive fork().
+ *
+ * @param[in]	on - 0 to keep writing each record synchronously
+ *
+ * @return	int
+ * @retval	 0 - success, or the writer is not wanted
+ * @retval	-1 - failure, records stay synchronous
+ */
+int
+acct_async_start(int on)
+{
+	if (!on || acct_async_on)
+		return 0;
+
+	if (pthread_atfork(acct_atfork_prepare, acct_atfork_parent, acct_atfork_child) != 0) {
+		log_err(-1, __func__, "accounting atfork handler failed");
+		return -1;
+	}
+	acct_async_on = 1;
+	if (pthread_create(&acct_async_tid, NULL, acct_async_main, NULL) != 0) {
+		log_err(errno, __func__, "Failed to create accounting writer thread");
+		acct_async_on = 0;
+		return -1;
+	}
+
+	log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER, LOG_INFO,
+		msg_daemonname, "Accounting writer started");
+	return 0;
+}
+
+/**
+ * @brief
+ *	Close and reopen the accounting file before the next record is
+ *	written.  Safe to call from a signal handler.
+ *
+ * @return	void
+ */
+void
+acct_reopen(void)
+{
+	acct_reopen_pending = 1;
+}
+
 /**
  * @brief
  * acct_open() - open the acct file for append.
  * Opens a (new) acct file.
  * If a acct file is already open, and the new file is successfully opened,
  * the old file is closed.  Otherwise the old file is left open.
+ * With PBS_ACCT_BINARY, the binary sidecar of the file is opened as well.
  *
  * @param[in]	filename - abs pathname or NULL
  *
@@ -928,8 +1614,10 @@ int
 acct_open(char *filename)
 {
     char  filen[_POSIX_PATH_MAX];
+	char  binfilen[_POSIX_PATH_MAX + sizeof(ACCT_BIN_SUFFIX)];
 	char  logmsg[_POSIX_PATH_MAX+80];
 	FILE *newacct;
+	FILE *newbin = NULL;
 	time_t now;
 	struct tm *ptm;
 
@@ -958,13 +1646,37 @@ acct_open(char *filename)
 		return (-1);
 	}
 
-	(void)setvbuf(newacct, NULL, _IOLBF, 0); /* set line buffering */
+	if (pbs_conf.pbs_acct_binary) {
+		(void)snprintf(binfilen, sizeof(binfilen), "%s%s", filename, ACCT_BIN_SUFFIX);
+		if ((newbin = fopen(binfilen, "a")) == NULL)
+			log_err(errno, "acct_open", binfilen);
+	}
 
-	if (acct_opened > 0) 		/* if acct was open, close it */
+	/* records are written a batch at a time, see acct_flush() */
+	acct_flush();
+	pthread_mutex_lock(&acct_io_mutex);
+	if (acct_opened > 0) { 		/* if acct was open, close it */
 		(void)fclose(acctfile);
+		if (acctbinfile != NULL)
+			(void)fclose(acctbinfile);
+	}
 
 	acctfile = newacct;
+	acctbinfile = newbin;
+	if (acctbinfile != NULL) {
+		/* each opening starts a section with keys of its own */
+		acct_bin_reset();
+		if ((fwrite(ACCT_BIN_MAGIC, 1, ACCT_BIN_MAGIC_LEN, acctbinfile) != ACCT_BIN_MAGIC_LEN) ||
+			(fflush(acctbinfile) != 0)) {
+			log_err(errno, "acct_open", binfilen);
+			(void)fclose(acctbinfile);
+			acctbinfile = NULL;
+		}
+	}
+	acct_write_failed = 0;
 	acct_opened = 1;			/* note that file is open */
+	pthread_mutex_unlock(&acct_io_mutex);
+
 	(void)sprintf(logmsg, "Account file %s opened", filename);
 	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO,
 		"Act", logmsg);
@@ -975,22 +1687,34 @@ acct_open(char *filename)
 /**
  * @brief
  * acct_close - close the current open log file
+ *	after writing out the records queued for it
  *
  * @return	void
  */
 void
 acct_close()
 {
+	acct_flush();
+	pthread_mutex_lock(&acct_io_mutex);
 	if (acct_opened == 1) {
 		(void)fclose(acctfile);
+		if (acctbinfile != NULL) {
+			(void)fclose(acctbinfile);
+			acctbinfile = NULL;
+		}
 		acct_opened = 0;
 	}
+	pthread_mutex_unlock(&acct_io_mutex);
 }
 
 /**
  * @brief
  * write_account_record - write basic accounting record
  *
+ * @par
+ *	The record is queued and, unless the accounting writer thread is
+ *	running, written out at once.
+ *
  * @param[in]	acctype - accounting record type
  * @param[in]	id - accounting record id
  * @param[in,out]	text - text to log, may be null
@@ -1000,27 +1724,86 @@ acct_close()
 void
 write_account_record(int acctype, const char *id, char *text)
 {
-	struct tm *ptm;
+	struct tm ltm;
+	struct acct_qrec *pr;
+	size_t need;
+	size_t tslen;
+	size_t idlen;
+	size_t textlen;
+	int wake = 0;
+	char *pb;
+
+	if (acct_reopen_pending) {	/* SIGHUP, see acct_reopen() */
+		acct_reopen_pending = 0;
+		acct_close();
+		(void)acct_open(acct_file);
+	}
 
 	if (acct_opened == 0)
 		return;		/* file not open, don't bother */
 
-	ptm = localtime(&time_now);
+	if (time_now != acct_ts_sec) {
+		localtime_r(&time_now, &ltm);
+		(void)snprintf(acct_ts, sizeof(acct_ts), "%02d/%02d/%04d %02d:%02d:%02d",
+			ltm.tm_mon+1, ltm.tm_mday, ltm.tm_year+1900,
+			ltm.tm_hour, ltm.tm_min, ltm.tm_sec);
+		acct_ts_yday = ltm.tm_yday;
+		acct_ts_sec = time_now;
+	}
 
 	/* Do we need to switch files */
 
-	if (acct_auto_switch && (acct_opened_day != ptm->tm_yday)) {
+	if (acct_auto_switch && (acct_opened_day != acct_ts_yday)) {
 		acct_close();
 		acct_open(NULL);
 	}
 	if (text == NULL)
 		text = "";
 
-	(void)fprintf(acctfile,
-		"%02d/%02d/%04d %02d:%02d:%02d;%c;%s;%s\n",
-		ptm->tm_mon+1, ptm->tm_mday, ptm->tm_year+1900,
-		ptm->tm_hour, ptm->tm_min, ptm->tm_sec,
-		(char)acctype, id, text);
+	/* "date time;type;id;text\n" */
+	tslen = strlen(acct_ts);
+	idlen = strlen(id);
+	textlen = strlen(text);
+	need = tslen + 3 + idlen + 1 + textlen + 1;
+
+	pthread_mutex_lock(&acct_q_mutex);
+	while (acct_async_on && (acct_q.qb_len > 0) && (acct_q.qb_len + need > ACCT_ASYNC_MAX)) {
+		/* queue is full, let the writer catch up */
+		pthread_cond_signal(&acct_q_cond);
+		pthread_cond_wait(&acct_space_cond, &acct_q_mutex);
+	}
+	if (acct_qbuf_reserve(&acct_q, need) != 0) {
+		pthread_mutex_unlock(&acct_q_mutex);
+		log_err(errno, __func__, "accounting record lost, out of memory");
+		return;
+	}
+	pb = acct_q.qb_buf + acct_q.qb_len;
+	memcpy(pb, acct_ts, tslen);
+	pb += tslen;
+	*pb++ = ';';
+	*pb++ = (char)acctype;
+	*pb++ = ';';
+	memcpy(pb, id, idlen);
+	pb += idlen;
+	*pb++ = ';';
+	memcpy(pb, text, textlen);
+	pb += textlen;
+	*pb = '\n';
+
+	pr = &acct_q.qb_recs[acct_q.qb_nrec++];
+	pr->qr_time = time_now;
+	pr->qr_off = acct_q.qb_len;
+	pr->qr_len = need;
+	if ((acct_q.qb_len == 0) ||
+		((acct_q.qb_len < ACCT_ASYNC_MAX / 2) && (acct_q.qb_len + need >= ACCT_ASYNC_MAX / 2)))
+		wake = 1;
+	acct_q.qb_len += need;
+	pthread_mutex_unlock(&acct_q_mutex);
+
+	if (!acct_async_on)
+		acct_flush();
+	else if (wake)
+		pthread_cond_signal(&acct_q_cond);
 }
 
 /**
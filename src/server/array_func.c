@@ -68,6 +68,7 @@
 #include "acct.h"
 #include <sys/time.h>
 #include "range.h"
+#include "pbs_idx.h"
 
 
 /* External data */
@@ -370,14 +371,134 @@ set_subjob_tblstate(job *parent, int offset, char newstate)
 	if (nstatenum != -1)
 		ptbl->tkm_subjsct[nstatenum]++;
 
-	if (oldstate == JOB_STATE_LTR_QUEUED)
+	/* the remaining indices only change when entering or leaving queued */
+	if (oldstate == JOB_STATE_LTR_QUEUED) {
 		range_remove_value(&ptbl->trk_rlist , SJ_TBLIDX_2_IDX(parent, offset));
-	else if (newstate == JOB_STATE_LTR_QUEUED)
+		ptbl->tkm_flags |= TKMFLG_REVAL_IND_REMAINING;
+	} else if (newstate == JOB_STATE_LTR_QUEUED) {
 		range_add_value(&ptbl->trk_rlist, SJ_TBLIDX_2_IDX(parent, offset), ptbl->tkm_step);
+		ptbl->tkm_flags |= TKMFLG_REVAL_IND_REMAINING;
+	}
 
 	/* set flags in attribute so stat_job will update the attr string */
-	ptbl->tkm_flags |= TKMFLG_REVAL_IND_REMAINING;
+	ptbl->tkm_flags |= TKMFLG_REVAL_STATE_CT;
+
+}
+/**
+ * @brief
+ * 		set_subjob_tblstate_all - set the subjob tracking table state field
+ *		of every entry to the same state
+ *
+ * @par	Functionality:
+ *		Same as calling set_subjob_tblstate() for each entry, but the state
+ *		counts and the range list of queued indices are reset once instead
+ *		of being updated one entry at a time.
+ *
+ * @param[in]	parent - pointer to parent job.
+ * @param[in]	newstate - newstate of the sub jobs.
+ *
+ *	@return	void
+ */
+void
+set_subjob_tblstate_all(job *parent, char newstate)
+{
+	struct ajtrkhd	*ptbl;
+	int i;
+	int nstatenum;
+
+	if (parent == NULL)
+		return;
 
+	ptbl = parent->ji_ajtrk;
+	if (ptbl == NULL)
+		return;
+
+	for (i = 0; i < ptbl->tkm_ct; i++)
+		ptbl->tkm_tbl[i].trk_status = newstate;
+
+	for (i = 0; i < PBS_NUMJOBSTATE; i++)
+		ptbl->tkm_subjsct[i] = 0;
+	nstatenum = state_char2int(newstate);
+	if (nstatenum != -1)
+		ptbl->tkm_subjsct[nstatenum] = ptbl->tkm_ct;
+
+	free_range_list(ptbl->trk_rlist);
+	ptbl->trk_rlist = NULL;
+	if (newstate == JOB_STATE_LTR_QUEUED)
+		ptbl->trk_rlist = new_range(ptbl->tkm_start, SJ_TBLIDX_2_IDX(parent, ptbl->tkm_ct - 1),
+					    ptbl->tkm_step, ptbl->tkm_ct, NULL);
+
+	ptbl->tkm_flags |= (TKMFLG_REVAL_IND_REMAINING | TKMFLG_REVAL_STATE_CT);
+}
+/**
+ * @brief
+ * 		get_subjob_ptr - return the instantiated subjob at an offset of the
+ *		tracking table of an Array Job
+ *
+ * @param[in]	parent - pointer to parent job.
+ * @param[in]	offset - sub job index.
+ *
+ *	@return	job *
+ *	@retval	NULL	- subjob is not instantiated
+ */
+job *
+get_subjob_ptr(job *parent, int offset)
+{
+	struct ajtrkhd	*ptbl;
+	void *pkey = &offset;
+	void *psubjob = NULL;
+
+	if ((parent == NULL) || (offset < 0))
+		return NULL;
+
+	ptbl = parent->ji_ajtrk;
+	if ((ptbl == NULL) || (ptbl->tkm_subjobs == NULL))
+		return NULL;
+
+	if (pbs_idx_find(ptbl->tkm_subjobs, &pkey, &psubjob, NULL) != PBS_IDX_RET_OK)
+		return NULL;
+	return ((job *)psubjob);
+}
+/**
+ * @brief
+ * 		set_subjob_ptr - record, or forget if psubjob is NULL, the
+ *		instantiated subjob at an offset of the tracking table
+ *
+ * @par	Functionality:
+ *		Only instantiated subjobs are kept, in an index hanging off the
+ *		tracking table, so the table itself holds no pointer per entry.
+ *
+ * @param[in]	parent - pointer to parent job.
+ * @param[in]	offset - sub job index.
+ * @param[in]	psubjob - the subjob or NULL
+ *
+ *	@return	int
+ *	@retval	0	- success
+ *	@retval	-1	- failure
+ */
+int
+set_subjob_ptr(job *parent, int offset, job *psubjob)
+{
+	struct ajtrkhd	*ptbl;
+
+	if (parent == NULL)
+		return -1;
+
+	ptbl = parent->ji_ajtrk;
+	if ((ptbl == NULL) || (offset < 0) || (offset >= ptbl->tkm_ct))
+		return -1;
+
+	if (ptbl->tkm_subjobs == NULL) {
+		if (psubjob == NULL)
+			return 0;
+		if ((ptbl->tkm_subjobs = pbs_idx_create(PBS_IDX_HASH, sizeof(int))) == NULL)
+			return -1;
+	}
+
+	(void)pbs_idx_delete(ptbl->tkm_subjobs, &offset);
+	if ((psubjob != NULL) && (pbs_idx_insert(ptbl->tkm_subjobs, &offset, psubjob) != PBS_IDX_RET_OK))
+		return -1;
+	return 0;
 }
 /**
  * @brief
@@ -400,9 +521,11 @@ update_array_indices_remaining_attr(job *parent)
 
 		free_jattr(parent, JOB_ATR_array_indices_remaining);
 		set_jattr_generic(parent, JOB_ATR_array_indices_remaining, pnewstr, NULL, INTERNAL);
+	}
+	if (ptbl->tkm_flags & (TKMFLG_REVAL_IND_REMAINING | TKMFLG_REVAL_STATE_CT)) {
 		/* also update value of attribute "array_state_count" */
 		update_subjob_state_ct(parent);
-		ptbl->tkm_flags &= ~TKMFLG_REVAL_IND_REMAINING;
+		ptbl->tkm_flags &= ~(TKMFLG_REVAL_IND_REMAINING | TKMFLG_REVAL_STATE_CT);
 	}
 }
 /**
@@ -533,10 +656,12 @@ update_subjob_state(job *pjob, char newstate)
 int
 get_subjob_discarding(job *parent, int iindx)
 {
+	job *psubjob;
+
 	if (iindx == -1)
 		return -1;
-	if (parent->ji_ajtrk->tkm_tbl[iindx].trk_psubjob)
-		return (parent->ji_ajtrk->tkm_tbl[iindx].trk_psubjob->ji_discarding);
+	if ((psubjob = get_subjob_ptr(parent, iindx)) != NULL)
+		return (psubjob->ji_discarding);
 	return 0;
 }
 /**
@@ -681,6 +806,8 @@ mk_subjob_index_tbl(char *range, char initalstate, int *pbserror, int mode)
 		trktbl->tkm_subjsct[i] = 0;
 	trktbl->tkm_subjsct[JOB_STATE_QUEUED] = count;
 	trktbl->tkm_dsubjsct = 0;
+	trktbl->trk_rlist = NULL;
+	trktbl->tkm_subjobs = NULL;
 	j = 0;
 	for (i = start; i <= end; i += step, j++) {
 		trktbl->tkm_tbl[j].trk_status = initalstate;
@@ -688,7 +815,6 @@ mk_subjob_index_tbl(char *range, char initalstate, int *pbserror, int mode)
 		trktbl->tkm_tbl[j].trk_substate = JOB_SUBSTATE_FINISHED;
 		trktbl->tkm_tbl[j].trk_stgout = -1;
 		trktbl->tkm_tbl[j].trk_exitstat = 0;
-		trktbl->tkm_tbl[j].trk_psubjob = NULL;
 	}
 	return trktbl;
 }
@@ -717,8 +843,11 @@ setup_arrayjob_attrs(attribute *pattr, void *pobj, int mode)
 
 	if ((mode == ATR_ACTION_NEW) || (mode == ATR_ACTION_RECOV)) {
 		int pbs_error = PBSE_BADATVAL;
-		if (pjob->ji_ajtrk)
+		if (pjob->ji_ajtrk) {
+			free_range_list(pjob->ji_ajtrk->trk_rlist);
+			pbs_idx_destroy(pjob->ji_ajtrk->tkm_subjobs);
 			free(pjob->ji_ajtrk);
+		}
 		if ((pjob->ji_ajtrk = mk_subjob_index_tbl(get_jattr_str(pjob, JOB_ATR_array_indices_submitted),
 			                                      JOB_STATE_LTR_QUEUED, &pbs_error, mode)) == NULL)
 			return pbs_error;
@@ -730,7 +859,7 @@ setup_arrayjob_attrs(attribute *pattr, void *pobj, int mode)
 
 	if (mode == ATR_ACTION_RECOV) {
 		/* set flags in attribute so stat_job will update the attr string */
-		pjob->ji_ajtrk->tkm_flags |= TKMFLG_REVAL_IND_REMAINING;
+		pjob->ji_ajtrk->tkm_flags |= (TKMFLG_REVAL_IND_REMAINING | TKMFLG_REVAL_STATE_CT);
 
 		return (PBSE_NONE);
 	}
@@ -868,8 +997,12 @@ create_subjob(job *parent, char *newjid, int *rc)
 		*rc = PBSE_SYSTEM;
 		return NULL;
 	}
+	if (set_subjob_ptr(parent, indx, subj) != 0) {
+		job_free(subj);
+		*rc = PBSE_SYSTEM;
+		return NULL;
+	}
 	subj->ji_qs = parent->ji_qs;	/* copy the fixed save area */
-	parent->ji_ajtrk->tkm_tbl[indx].trk_psubjob = subj;
 	subj->ji_qhdr     = parent->ji_qhdr;
 	subj->ji_myResv   = parent->ji_myResv;
 	subj->ji_parentaj = parent;
@@ -1014,8 +1147,8 @@ dup_br_for_subjob(struct batch_request *opreq, job *pjob, void (*func)(struct ba
 				pjob->ji_qs.ji_jobid);
 			break;
 		default:
-			delete_link(&npreq->rq_link);
-			free(npreq);
+			npreq->rq_extend = NULL;	/* belongs to opreq */
+			free_br(npreq);
 			return;
 	}
 
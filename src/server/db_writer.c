@@ -0,0 +1,600 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file    db_writer.c
+ *
+ * @brief
+ *	Asynchronous datastore writer of the server.
+ *
+ *	Saves and deletes of jobs, reservations, nodes and queues are handed
+ *	to a dedicated thread which owns a database connection of its own.
+ *	Pending saves of the same object are coalesced into one, and everything
+ *	pending is written in a single transaction (group commit).
+ *
+ *	Anything that must be on disk before the server goes on, like a reply
+ *	to a client or a synchronous database operation done on the main
+ *	connection, calls db_writer_barrier() first.
+ *
+ *	If the writer cannot be started, or has not been started yet (server
+ *	recovery), every operation is done synchronously by the caller as before.
+ *	So is every operation made while a transaction is open on the main
+ *	connection (Submit Job List, Manage Job List), which must commit or
+ *	fail together with the rest of that transaction.
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <sys/types.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pbs_ifl.h"
+#include "libpbs.h"
+#include "pbs_internal.h"
+#include "pbs_error.h"
+#include "log.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "server_limits.h"
+#include "job.h"
+#include "reservation.h"
+#include "queue.h"
+#include "pbs_nodes.h"
+#include "pbs_db.h"
+#include "pbs_idx.h"
+#include "svrfunc.h"
+
+#define DBW_SAVE	1	/* item saves the object */
+#define DBW_DELETE	2	/* item deletes the object */
+
+#define DBW_MAX_BATCH	1000	/* max objects written in one transaction */
+#define DBW_KEYLEN	(PBS_MAXSVRJOBID + PBS_MAXSERVERNAME + 8)
+
+/* states of the writer */
+#define DBW_STOPPED	0	/* not running, callers write synchronously */
+#define DBW_STARTING	1	/* thread is connecting to the database */
+#define DBW_RUNNING	2
+#define DBW_FAILED	3	/* a write failed, the server must stop */
+
+typedef struct dbw_item {
+	pbs_list_link		di_link;	/* link in dbw_queue */
+	int			di_op;		/* DBW_SAVE or DBW_DELETE */
+	int			di_savetype;	/* savetype for DBW_SAVE */
+	long long		di_seq;		/* dbw_enq_seq when created */
+	char			di_key[DBW_KEYLEN]; /* key in dbw_pending_idx */
+	pbs_db_obj_info_t	di_obj;		/* owns its object structure */
+} dbw_item_t;
+
+extern char conn_db_host[];
+extern void *svr_db_conn;
+
+static pthread_t dbw_tid;
+static pthread_mutex_t dbw_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dbw_work_cond = PTHREAD_COND_INITIALIZER;	/* queue not empty */
+static pthread_cond_t dbw_done_cond = PTHREAD_COND_INITIALIZER;	/* batch written */
+static int dbw_state = DBW_STOPPED;
+static int dbw_stopping = 0;
+static pbs_list_head dbw_queue;		/* items not yet taken by the writer */
+static void *dbw_pending_idx = NULL;	/* dbw_queue indexed by object */
+static long long dbw_enq_seq = 0;	/* seq of the last queued operation */
+static long long dbw_done_seq = 0;	/* all operations up to this seq are written */
+
+/**
+ * @brief
+ *	Return the id of a database object, its size and its attribute list
+ *
+ * @param[in]	obj - the object
+ * @param[out]	size - size of the object structure
+ * @param[out]	attrs - the object's attribute list
+ *
+ * @return	char *
+ * @retval	id of the object
+ * @retval	NULL - object type is not handled by the writer
+ */
+static char *
+dbw_obj_info(pbs_db_obj_info_t *obj, size_t *size, pbs_db_attr_list_t **attrs)
+{
+	switch (obj->pbs_db_obj_type) {
+		case PBS_DB_JOB:
+			*size = sizeof(pbs_db_job_info_t);
+			*attrs = &obj->pbs_db_un.pbs_db_job->db_attr_list;
+			return obj->pbs_db_un.pbs_db_job->ji_jobid;
+		case PBS_DB_RESV:
+			*size = sizeof(pbs_db_resv_info_t);
+			*attrs = &obj->pbs_db_un.pbs_db_resv->db_attr_list;
+			return obj->pbs_db_un.pbs_db_resv->ri_resvid;
+		case PBS_DB_NODE:
+			*size = sizeof(pbs_db_node_info_t);
+			*attrs = &obj->pbs_db_un.pbs_db_node->db_attr_list;
+			return obj->pbs_db_un.pbs_db_node->nd_name;
+		case PBS_DB_QUEUE:
+			*size = sizeof(pbs_db_que_info_t);
+			*attrs = &obj->pbs_db_un.pbs_db_que->db_attr_list;
+			return obj->pbs_db_un.pbs_db_que->qu_name;
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Move the attributes of one list into another, replacing any attribute
+ *	of the same name and resource already there
+ *
+ * @param[in,out] to - list to merge into
+ * @param[in,out] from - list to merge from, left empty
+ *
+ * @return	void
+ */
+static void
+dbw_merge_attrs(pbs_db_attr_list_t *to, pbs_db_attr_list_t *from)
+{
+	svrattrl *pal;
+	svrattrl *old;
+	svrattrl *next;
+
+	while ((pal = (svrattrl *) GET_NEXT(from->attrs)) != NULL) {
+		for (old = (svrattrl *) GET_NEXT(to->attrs); old != NULL; old = next) {
+			next = (svrattrl *) GET_NEXT(old->al_link);
+			if (strcmp(old->al_name, pal->al_name) != 0)
+				continue;
+			if ((old->al_resc == NULL) != (pal->al_resc == NULL))
+				continue;
+			if (old->al_resc && strcmp(old->al_resc, pal->al_resc) != 0)
+				continue;
+			delete_link(&old->al_link);
+			free(old);
+			to->attr_count--;
+		}
+		delete_link(&pal->al_link);
+		append_link(&to->attrs, &pal->al_link, pal);
+		to->attr_count++;
+	}
+	from->attr_count = 0;
+}
+
+/**
+ * @brief
+ *	Free a queued item and the object it owns
+ *
+ * @param[in]	pitem - the item
+ *
+ * @return	void
+ */
+static void
+dbw_free_item(dbw_item_t *pitem)
+{
+	size_t size;
+	pbs_db_attr_list_t *attrs;
+
+	if (dbw_obj_info(&pitem->di_obj, &size, &attrs) != NULL)
+		free_db_attr_list(attrs);
+	free(pitem->di_obj.pbs_db_un.pbs_db_job);
+	free(pitem);
+}
+
+/**
+ * @brief
+ *	Queue an operation for the writer, coalescing it with an operation
+ *	already pending on the same object.
+ *
+ * @param[in]	op - DBW_SAVE or DBW_DELETE
+ * @param[in]	obj - the object, its attribute list is taken over
+ * @param[in]	savetype - savetype for DBW_SAVE
+ *
+ * @return	int
+ * @retval	0 - queued
+ * @retval	1 - writer not running, or a transaction is open on the main
+ *		    connection, caller must do it synchronously
+ */
+static int
+dbw_enqueue(int op, pbs_db_obj_info_t *obj, int savetype)
+{
+	dbw_item_t *pitem = NULL;
+	pbs_db_attr_list_t *attrs;
+	pbs_db_attr_list_t *pattrs;
+	pbs_list_head save_head;
+	size_t size;
+	char key[DBW_KEYLEN];
+	char *id;
+	void *pkey;
+	void *data;
+	int save_count;
+
+	if (dbw_state == DBW_FAILED)
+		db_writer_barrier(); /* does not return */
+	if (dbw_state != DBW_RUNNING)
+		return 1;
+	if (pbs_db_in_trx(svr_db_conn))
+		return 1;	/* belongs to the caller's transaction */
+	if ((id = dbw_obj_info(obj, &size, &attrs)) == NULL)
+		return 1;
+	snprintf(key, sizeof(key), "%d:%s", obj->pbs_db_obj_type, id);
+
+	pthread_mutex_lock(&dbw_lock);
+	dbw_enq_seq++;
+
+	pkey = key;
+	if (pbs_idx_find(dbw_pending_idx, &pkey, &data, NULL) == PBS_IDX_RET_OK) {
+		pitem = (dbw_item_t *) data;
+		dbw_obj_info(&pitem->di_obj, &size, &pattrs);
+		if (op == DBW_DELETE) {
+			/* nothing pending matters any more */
+			free_db_attr_list(pattrs);
+			pitem->di_op = DBW_DELETE;
+			pitem->di_savetype = 0;
+		} else if (pitem->di_op == DBW_DELETE) {
+			/* save after delete, keep both in order */
+			pbs_idx_delete(dbw_pending_idx, key);
+			pitem = NULL;
+		} else {
+			dbw_merge_attrs(pattrs, attrs);
+			if (savetype & OBJ_SAVE_QS) {
+				/* newer quick save area wins, keep the merged list */
+				save_head = pattrs->attrs;
+				save_count = pattrs->attr_count;
+				memcpy(pitem->di_obj.pbs_db_un.pbs_db_job, obj->pbs_db_un.pbs_db_job, size);
+				pattrs->attrs = save_head;
+				pattrs->attr_count = save_count;
+			}
+			pitem->di_savetype |= savetype;
+		}
+		if (pitem != NULL) {
+			pthread_mutex_unlock(&dbw_lock);
+			return 0;
+		}
+	}
+
+	if ((pitem = calloc(1, sizeof(dbw_item_t))) == NULL ||
+	    (pitem->di_obj.pbs_db_un.pbs_db_job = malloc(size)) == NULL) {
+		pthread_mutex_unlock(&dbw_lock);
+		free(pitem);
+		log_err(errno, __func__, "Out of memory");
+		db_writer_barrier();
+		return 1;
+	}
+	CLEAR_LINK(pitem->di_link);
+	pitem->di_op = op;
+	pitem->di_savetype = savetype;
+	pitem->di_seq = dbw_enq_seq;
+	strcpy(pitem->di_key, key);
+	pitem->di_obj.pbs_db_obj_type = obj->pbs_db_obj_type;
+	memcpy(pitem->di_obj.pbs_db_un.pbs_db_job, obj->pbs_db_un.pbs_db_job, size);
+	dbw_obj_info(&pitem->di_obj, &size, &pattrs);
+	list_move(&attrs->attrs, &pattrs->attrs);
+	attrs->attr_count = 0;
+
+	if (pbs_idx_insert(dbw_pending_idx, pitem->di_key, pitem) != PBS_IDX_RET_OK) {
+		pthread_mutex_unlock(&dbw_lock);
+		list_move(&pattrs->attrs, &attrs->attrs);
+		attrs->attr_count = pattrs->attr_count;
+		free(pitem->di_obj.pbs_db_un.pbs_db_job);
+		free(pitem);
+		log_err(-1, __func__, "Failed to index datastore write");
+		db_writer_barrier();
+		return 1;
+	}
+	append_link(&dbw_queue, &pitem->di_link, pitem);
+	pthread_cond_signal(&dbw_work_cond);
+	pthread_mutex_unlock(&dbw_lock);
+
+	return 0;
+}
+
+/**
+ * @brief
+ *	Write one queued item on the writer's connection
+ *
+ * @param[in]	conn - the writer's database connection
+ * @param[in]	pitem - the item
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	-1 - failure
+ */
+static int
+dbw_write_item(void *conn, dbw_item_t *pitem)
+{
+	int rc;
+
+	if (pitem->di_op == DBW_DELETE)
+		return ((pbs_db_delete_obj(conn, &pitem->di_obj) == -1) ? -1 : 0);
+
+	rc = pbs_db_save_obj(conn, &pitem->di_obj, pitem->di_savetype);
+	if ((rc == 1) && (pitem->di_obj.pbs_db_obj_type == PBS_DB_NODE)) {
+		/* node not in the database yet, see node_save_db */
+		rc = pbs_db_save_obj(conn, &pitem->di_obj, pitem->di_savetype | OBJ_SAVE_NEW | OBJ_SAVE_QS);
+	}
+	if (rc == 1)
+		rc = 0; /* object was deleted meanwhile, nothing to update */
+	return rc;
+}
+
+/**
+ * @brief
+ *	Write a batch of items in a single transaction and free them
+ *
+ * @param[in]	conn - the writer's database connection
+ * @param[in]	batch - the items
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	-1 - failure, the transaction was rolled back
+ */
+static int
+dbw_write_batch(void *conn, pbs_list_head *batch)
+{
+	dbw_item_t *pitem;
+	char *conn_db_err = NULL;
+	int rc;
+
+	rc = pbs_db_begin_trx(conn);
+	while ((pitem = (dbw_item_t *) GET_NEXT(*batch)) != NULL) {
+		delete_link(&pitem->di_link);
+		if (rc == 0 && (rc = dbw_write_item(conn, pitem)) != 0)
+			log_errf(PBSE_INTERNAL, __func__, "Failed to write %s", pitem->di_key);
+		dbw_free_item(pitem);
+	}
+	if (pbs_db_end_trx(conn, (rc == 0) ? PBS_DB_COMMIT : PBS_DB_ROLLBACK) != 0)
+		rc = -1;
+
+	if (rc != 0) {
+		pbs_db_get_errmsg(PBS_DB_ERR, &conn_db_err);
+		log_errf(PBSE_INTERNAL, __func__, "Failed to commit to the datastore %s", conn_db_err ? conn_db_err : "");
+		free(conn_db_err);
+	}
+	return rc;
+}
+
+/**
+ * @brief
+ *	The writer thread. Connects to the database, then repeatedly takes
+ *	everything queued (up to DBW_MAX_BATCH objects) and writes it in one
+ *	transaction, until stopped and drained or until a write fails.
+ *
+ * @param[in]	arg - unused
+ *
+ * @return	void *
+ */
+static void *
+dbw_thread(void *arg)
+{
+	void *conn = NULL;
+	char *conn_db_err = NULL;
+	pbs_list_head batch;
+	dbw_item_t *pitem;
+	long long seq;
+	int failcode;
+	int n;
+
+	failcode = pbs_db_connect(&conn, conn_db_host, pbs_conf.pbs_data_service_port, PBS_DB_CNT_TIMEOUT_NORMAL);
+	if (conn == NULL) {
+		pbs_db_get_errmsg(failcode, &conn_db_err);
+		log_errf(-1, __func__, "Datastore writer failed to connect %s", conn_db_err ? conn_db_err : "");
+		free(conn_db_err);
+	}
+
+	pthread_mutex_lock(&dbw_lock);
+	dbw_state = (conn != NULL) ? DBW_RUNNING : DBW_STOPPED;
+	pthread_cond_broadcast(&dbw_done_cond);
+	pthread_mutex_unlock(&dbw_lock);
+	if (conn == NULL)
+		return NULL;
+
+	CLEAR_HEAD(batch);
+	for (;;) {
+		pthread_mutex_lock(&dbw_lock);
+		while ((GET_NEXT(dbw_queue) == NULL) && !dbw_stopping)
+			pthread_cond_wait(&dbw_work_cond, &dbw_lock);
+		if (GET_NEXT(dbw_queue) == NULL) {
+			pthread_mutex_unlock(&dbw_lock);
+			break;
+		}
+
+		for (n = 0; n < DBW_MAX_BATCH; n++) {
+			if ((pitem = (dbw_item_t *) GET_NEXT(dbw_queue)) == NULL)
+				break;
+			pbs_idx_delete(dbw_pending_idx, pitem->di_key);
+			delete_link(&pitem->di_link);
+			append_link(&batch, &pitem->di_link, pitem);
+			seq = pitem->di_seq;
+		}
+		/* if all is taken, coalesced operations newer than the last item are covered too */
+		if (GET_NEXT(dbw_queue) == NULL)
+			seq = dbw_enq_seq;
+		pthread_mutex_unlock(&dbw_lock);
+
+		if (dbw_write_batch(conn, &batch) != 0) {
+			pthread_mutex_lock(&dbw_lock);
+			dbw_state = DBW_FAILED;
+			pthread_cond_broadcast(&dbw_done_cond);
+			pthread_mutex_unlock(&dbw_lock);
+			break;
+		}
+
+		pthread_mutex_lock(&dbw_lock);
+		dbw_done_seq = seq;
+		pthread_cond_broadcast(&dbw_done_cond);
+		pthread_mutex_unlock(&dbw_lock);
+	}
+
+	pbs_db_disconnect(conn);
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Start the datastore writer thread.
+ *
+ * @return	int
+ * @retval	0 - writer running
+ * @retval	-1 - writer could not be started, saves stay synchronous
+ */
+int
+db_writer_start(void)
+{
+	if (dbw_state != DBW_STOPPED)
+		return 0;
+
+	CLEAR_HEAD(dbw_queue);
+	if (dbw_pending_idx == NULL && (dbw_pending_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
+		log_err(-1, __func__, "Creating datastore writer index failed");
+		return -1;
+	}
+
+	dbw_stopping = 0;
+	dbw_state = DBW_STARTING;
+	if (pthread_create(&dbw_tid, NULL, dbw_thread, NULL) != 0) {
+		log_err(errno, __func__, "Failed to create datastore writer thread");
+		dbw_state = DBW_STOPPED;
+		return -1;
+	}
+
+	pthread_mutex_lock(&dbw_lock);
+	while (dbw_state == DBW_STARTING)
+		pthread_cond_wait(&dbw_done_cond, &dbw_lock);
+	pthread_mutex_unlock(&dbw_lock);
+
+	if (dbw_state != DBW_RUNNING) {
+		pthread_join(dbw_tid, NULL);
+		return -1;
+	}
+
+	log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER, LOG_INFO,
+		msg_daemonname, "Datastore writer started");
+	return 0;
+}
+
+/**
+ * @brief
+ *	Stop the datastore writer thread after everything queued is written.
+ *
+ * @return	void
+ */
+void
+db_writer_stop(void)
+{
+	if (dbw_state == DBW_STOPPED)
+		return;
+
+	pthread_mutex_lock(&dbw_lock);
+	dbw_stopping = 1;
+	pthread_cond_signal(&dbw_work_cond);
+	pthread_mutex_unlock(&dbw_lock);
+
+	pthread_join(dbw_tid, NULL);
+	dbw_state = DBW_STOPPED;
+}
+
+/**
+ * @brief
+ *	Wait until every operation queued so far is in the datastore.
+ *	Called before replying to a client and before any synchronous
+ *	database operation on the main connection.
+ *
+ * @par
+ *	If the writer failed to write, this shuts the server down just like
+ *	a failed synchronous save does.
+ *
+ * @return	void
+ */
+void
+db_writer_barrier(void)
+{
+	long long target;
+
+	if (dbw_state == DBW_STOPPED)
+		return;
+
+	pthread_mutex_lock(&dbw_lock);
+	target = dbw_enq_seq;
+	while ((dbw_done_seq < target) && (dbw_state == DBW_RUNNING))
+		pthread_cond_wait(&dbw_done_cond, &dbw_lock);
+	pthread_mutex_unlock(&dbw_lock);
+
+	if (dbw_state == DBW_FAILED)
+		panic_stop_db();
+}
+
+/**
+ * @brief
+ *	Queue a save of a job, reservation, node or queue for the writer.
+ *
+ * @param[in]	obj - the object, its attribute list is taken over on success
+ * @param[in]	savetype - OBJ_SAVE_QS or 0, new objects are never queued
+ *
+ * @return	int
+ * @retval	0 - queued
+ * @retval	1 - not queued, caller must save synchronously after
+ *		    calling db_writer_barrier()
+ */
+int
+db_writer_save(pbs_db_obj_info_t *obj, int savetype)
+{
+	if (savetype & OBJ_SAVE_NEW)
+		return 1; /* caller needs the result, e.g. to detect a jobid clash */
+	return dbw_enqueue(DBW_SAVE, obj, savetype);
+}
+
+/**
+ * @brief
+ *	Queue a delete of a job, reservation, node or queue for the writer.
+ *
+ * @param[in]	obj - the object, only its id is used
+ *
+ * @return	int
+ * @retval	0 - queued
+ * @retval	1 - not queued, caller must delete synchronously after
+ *		    calling db_writer_barrier()
+ */
+int
+db_writer_delete(pbs_db_obj_info_t *obj)
+{
+	pbs_db_attr_list_t *attrs;
+	size_t size;
+
+	if (dbw_obj_info(obj, &size, &attrs) == NULL)
+		return 1;
+	attrs->attr_count = 0;
+	CLEAR_HEAD(attrs->attrs);
+	return dbw_enqueue(DBW_DELETE, obj, 0);
+}
@@ -512,6 +512,10 @@ dis_request_read(int sfds, struct batch_request *request)
 			rc = decode_DIS_QueueJob(sfds, request);
 			break;
 
+		case PBS_BATCH_SubmitJobList:
+			rc = decode_DIS_SubmitJobList(sfds, request);
+			break;
+
 		case PBS_BATCH_JobCred:
 			rc = decode_DIS_JobCred(sfds, request);
 			break;
@@ -587,6 +591,14 @@ dis_request_read(int sfds, struct batch_request *request)
 			rc = decode_DIS_Manage(sfds, request);
 			break;
 
+		case PBS_BATCH_ModifyNodes:
+			rc = decode_DIS_ModifyNodes(sfds, request);
+			break;
+
+		case PBS_BATCH_ManageJobList:
+			rc = decode_DIS_ManageJobList(sfds, request);
+			break;
+
 		case PBS_BATCH_MoveJob:
 		case PBS_BATCH_OrderJob:
 			rc = decode_DIS_MoveJob(sfds, request);
@@ -624,6 +636,7 @@ dis_request_read(int sfds, struct batch_request *request)
 			break;
 
 		case PBS_BATCH_StatusNode:
+		case PBS_BATCH_StatusNodeSummary:
 		case PBS_BATCH_StatusResv:
 		case PBS_BATCH_StatusQue:
 		case PBS_BATCH_StatusSvr:
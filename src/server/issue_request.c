@@ -81,7 +81,6 @@
 
 
 /* Global Data Items: */
-extern pbs_list_head task_list_event;
 extern time_t	time_now;
 extern char	*msg_issuebad;
 extern char     *msg_norelytomom;
@@ -349,7 +348,7 @@ add_mom_deferred_list(int stream, mominfo_t *minfo, void (*func)(), char *msgid,
 	/* remove this task from the event list, as we will be adding to deferred list anyway
 	 * and there is no child process whose exit needs to be reaped
 	 */
-	delete_link(&ptask->wt_linkall);
+	remove_task_event(ptask);
 
 	/* append to the moms deferred command list */
 	append_link(&(((mom_svrinfo_t *) (minfo->mi_data))->msr_deferred_cmds), &ptask->wt_linkobj2, ptask);
@@ -720,7 +719,7 @@ issue_Drequest(int conn, struct batch_request *request, void (*func)(), struct w
 			 * remove it from the task_event list
 			 * caller will add to moms deferred cmd list
 			 */
-			delete_link(&ptask->wt_linkall);
+			remove_task_event(ptask);
 		}
 		ptask->wt_aux2 = prot;
 		*ppwt = ptask;
@@ -746,12 +745,7 @@ process_Dreply(int sock)
 	struct batch_request	*request;
 
 	/* find the work task for the socket, it will point us to the request */
-	ptask = (struct work_task *)GET_NEXT(task_list_event);
-	while (ptask) {
-		if ((ptask->wt_type == WORK_Deferred_Reply) && (ptask->wt_event == sock))
-			break;
-		ptask = (struct work_task *)GET_NEXT(ptask->wt_linkall);
-	}
+	ptask = find_event_task(WORK_Deferred_Reply, sock);
 	if (!ptask) {
 		close_conn(sock);
 		return;
@@ -76,6 +76,7 @@
 #include "batch_request.h"
 #include "pbs_entlim.h"
 #include "libutil.h"
+#include "pbs_pool.h"
 
 #ifndef PBS_MOM
 #include "pbs_idx.h"
@@ -127,6 +128,11 @@ extern pbs_list_head svr_newjobs;
 extern pbs_list_head svr_alljobs;
 extern char *msg_err_purgejob;
 
+static pbs_pool_t *job_pool = NULL;	/* job structures */
+#ifndef PBS_MOM
+static pbs_pool_t *resv_pool = NULL;	/* reservation structures */
+#endif
+
 #ifdef PBS_MOM
 extern void rmtmpdir(char *);
 void nodes_free(job *);
@@ -300,7 +306,9 @@ job_alloc(void)
 	char *svr_inst_id;
 #endif
 
-	pj = (job *)malloc(sizeof(job));
+	if (job_pool == NULL)
+		job_pool = pbs_pool_create("job", sizeof(job));
+	pj = job_pool ? (job *)pbs_pool_alloc(job_pool) : NULL;
 	if (pj == NULL) {
 		log_err(errno, __func__, "no memory");
 		return NULL;
@@ -525,13 +533,17 @@ job_free(job *pj)
 	}
 	if (pj->ji_qs.ji_svrflags & JOB_SVFLG_SubJob) {
 		if ((pj->ji_parentaj) && (pj->ji_parentaj->ji_ajtrk))
-			pj->ji_parentaj->ji_ajtrk->tkm_tbl[pj->ji_subjindx].trk_psubjob = NULL;
+			(void)set_subjob_ptr(pj->ji_parentaj, pj->ji_subjindx, NULL);
 	} else if (pj->ji_ajtrk) {
 		/* if Arrayjob, free the tracking table structure */
-		for (i = 0; i < pj->ji_ajtrk->tkm_ct; i++) {
-			job *psubj = pj->ji_ajtrk->tkm_tbl[i].trk_psubjob;
-			if (psubj)
-				psubj->ji_parentaj = NULL;
+		if (pj->ji_ajtrk->tkm_subjobs) {
+			void *idx_ctx = NULL;
+			void *psubj;
+
+			while (pbs_idx_find(pj->ji_ajtrk->tkm_subjobs, NULL, &psubj, &idx_ctx) == PBS_IDX_RET_OK)
+				((job *)psubj)->ji_parentaj = NULL;
+			pbs_idx_free_ctx(idx_ctx);
+			pbs_idx_destroy(pj->ji_ajtrk->tkm_subjobs);
 		}
 		free_range_list(pj->ji_ajtrk->trk_rlist);
 		free(pj->ji_ajtrk);
@@ -611,7 +623,7 @@ job_free(job *pj)
 	/* They will be freed when the parent is removed           */
 
 	pj->ji_qs.ji_jobid[0] = 'X';	/* as a "freed" marker */
-	free(pj);	/* now free the main structure */
+	pbs_pool_free(job_pool, pj);	/* now free the main structure */
 }
 
 /**
@@ -1051,6 +1063,8 @@ job_purge(job *pjob)
 		send_resc_used(x->ru_cmd, 1, x);
 		FREE_RUU(x);
 	}
+	free(pjob->ji_resc_used_sent);
+	pjob->ji_resc_used_sent = NULL;
 	delete_link(&pjob->ji_jobque);
 	delete_link(&pjob->ji_alljobs);
 	delete_link(&pjob->ji_unlicjobs);
@@ -1222,9 +1236,12 @@ job_purge(job *pjob)
 	obj.pbs_db_obj_type = PBS_DB_JOB;
 	obj.pbs_db_un.pbs_db_job = &dbjob;
 	strcpy(dbjob.ji_jobid, pjob->ji_qs.ji_jobid);
-	if (pbs_db_delete_obj(conn, &obj) == -1) {
-		log_joberr(-1, __func__, msg_err_purgejob_db,
-			pjob->ji_qs.ji_jobid);
+	if (db_writer_delete(&obj) != 0) {
+		db_writer_barrier();
+		if (pbs_db_delete_obj(conn, &obj) == -1) {
+			log_joberr(-1, __func__, msg_err_purgejob_db,
+				pjob->ji_qs.ji_jobid);
+		}
 	}
 
 	if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_HasNodes)
@@ -1691,11 +1708,14 @@ resv_alloc(char *resvid)
 	resc_resv *resvp;
 	char *dot = NULL;
 
-	resvp = (resc_resv *) calloc(1, sizeof(resc_resv));
+	if (resv_pool == NULL)
+		resv_pool = pbs_pool_create("resv", sizeof(resc_resv));
+	resvp = resv_pool ? (resc_resv *) pbs_pool_alloc(resv_pool) : NULL;
 	if (resvp == NULL) {
 		log_err(errno, __func__, "no memory");
 		return NULL;
 	}
+	memset(resvp, 0, sizeof(resc_resv));
 
 	CLEAR_LINK(resvp->ri_allresvs);
 	CLEAR_HEAD(resvp->ri_svrtask);
@@ -1719,7 +1739,7 @@ resv_alloc(char *resvid)
 	if (pbs_idx_insert(resvs_idx, (void *)(resvid + 1), (void *)resvp) != PBS_IDX_RET_OK) {
 		*dot = '.';
 		log_errf(-1, __func__, "Failed to add resv %s into index", resvid);
-		free(resvp);
+		pbs_pool_free(resv_pool, resvp);
 		return NULL;
 	}
 	if (dot)
@@ -1789,7 +1809,7 @@ resv_free(resc_resv *presv)
 		*dot = '.';
 
 	/* now free the main structure */
-	free(presv);
+	pbs_pool_free(resv_pool, presv);
 }
 
 
@@ -1909,8 +1929,11 @@ resv_purge(resc_resv *presv)
 	strcpy(dbresv.ri_resvid, presv->ri_qs.ri_resvID);
 	obj.pbs_db_obj_type = PBS_DB_RESV;
 	obj.pbs_db_un.pbs_db_resv = &dbresv;
-	if (pbs_db_delete_obj(svr_db_conn, &obj) == -1)
-		log_err(errno, __func__, msg_purgeResvDb);
+	if (db_writer_delete(&obj) != 0) {
+		db_writer_barrier();
+		if (pbs_db_delete_obj(svr_db_conn, &obj) == -1)
+			log_err(errno, __func__, msg_purgeResvDb);
+	}
 
 	/* Free resc_resv struct, any hanging substructs, any attached *work_task structs */
 	resv_free(presv);
@@ -249,7 +249,11 @@ job_save_db(job *pjob)
 
 	/* update mtime before save, so the same value gets to the DB as well */
 	set_jattr_l_slim(pjob, JOB_ATR_mtime, time_now, SET);
-	if ((rc = pbs_db_save_obj(conn, &obj, savetype)) == 0)
+	if ((rc = db_writer_save(&obj, savetype)) != 0) {
+		db_writer_barrier();
+		rc = pbs_db_save_obj(conn, &obj, savetype);
+	}
+	if (rc == 0)
 		pjob->newobj = 0;
 
 done:
@@ -333,6 +337,7 @@ job_recov_db(char *jid, job *pjob)
 	
 	strcpy(dbjob.ji_jobid, jid);
 
+	db_writer_barrier();
 	rc = pbs_db_load_obj(conn, &obj);
 	if (rc == -2)
 		return pjob; /* no change in job, return the same job */
@@ -465,7 +470,11 @@ resv_save_db(resc_resv *presv)
 	/* update mtime before save, so the same value gets to the DB as well */
 	presv->ri_wattr[RESV_ATR_mtime].at_val.at_long = time_now;
 	presv->ri_wattr[RESV_ATR_mtime].at_flags |= ATR_SET_MOD_MCACHE;
-	if ((rc = pbs_db_save_obj(conn, &obj, savetype)) == 0)
+	if ((rc = db_writer_save(&obj, savetype)) != 0) {
+		db_writer_barrier();
+		rc = pbs_db_save_obj(conn, &obj, savetype);
+	}
+	if (rc == 0)
 		presv->newobj = 0;
 
 done:
@@ -524,6 +533,7 @@ resv_recov_db(char *resvid, resc_resv *presv)
 	obj.pbs_db_obj_type = PBS_DB_RESV;
 	obj.pbs_db_un.pbs_db_resv = &dbresv;
 
+	db_writer_barrier();
 	rc = pbs_db_load_obj(conn, &obj);
 	if (rc == -2)
 		return presv; /* no change in resv */
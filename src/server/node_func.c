@@ -197,9 +197,13 @@ status_nodeattrib(svrattrl *pal, struct pbsnode *pnode, int limit, int priv, pbs
 	int   index;
 	int   nth;		/*tracks list position (ordinal tacker)   */
 	attribute_def *padef = node_attr_def;
+	int   pooling;
 
 	priv &= ATR_DFLAG_RDACC;  		/* user-client privilege      */
 
+	/* the encoded list is freed with the reply, build it from pools */
+	pooling = attrlist_pool_enable(1);
+
 	if (pal) {   /*caller has requested status on specific node-attributes*/
 		nth = 0;
 		while (pal) {
@@ -244,6 +248,7 @@ status_nodeattrib(svrattrl *pal, struct pbsnode *pnode, int limit, int priv, pbs
 		}
 	}
 
+	attrlist_pool_enable(pooling);
 	return (rc);
 }
 
@@ -850,6 +855,7 @@ save_nodes_db(int changemodtime, void *p)
 	obj.pbs_db_obj_type = PBS_DB_MOMINFO_TIME;
 	obj.pbs_db_un.pbs_db_mominfo_tm = &mom_tm;
 
+	db_writer_barrier();
 	if (pbs_db_save_obj(svr_db_conn, &obj, OBJ_SAVE_QS) == 1) {/* no row updated */
 		if (pbs_db_save_obj(svr_db_conn, &obj, OBJ_SAVE_NEW) != 0) /* insert also failed */
 			goto db_err;
@@ -1013,6 +1019,7 @@ setup_nodes()
 	/* Load  the mominfo_time from the db */
 	obj.pbs_db_obj_type = PBS_DB_MOMINFO_TIME;
 	obj.pbs_db_un.pbs_db_mominfo_tm = &mom_tm;
+	db_writer_barrier();
 	if (pbs_db_load_obj(svr_db_conn, &obj) == -1) {
 		log_errf(-1, __func__, "Could not load momtime info");
 		return (-1);
@@ -355,7 +355,8 @@ send_ip_addrs_to_mom(int stream, int combine_msg)
 /**
  * @brief Reply to IS_HELLOSVR
  * Sending all the information mom needs from the server.
- * including need inventory, rpp value and mom ip addresses.
+ * including need inventory, rpp value, mom ip addresses and the
+ * IS_FEAT_xxx bits of the features this server supports.
  *
  * @param[in] stream - the open stream to the Mom
  * @param[in] need_inv - whether the server needs inventory of the mom.
@@ -383,11 +384,13 @@ reply_hellosvr(int stream, int need_inv)
 		return ret;
 
 	if (msvr_mode()) {
-		/* In multi-server mode, server will not send clusteraddr */
-		return dis_flush(stream);
-	}
+		/* In multi-server mode, server sends an empty clusteraddr list */
+		if ((ret = diswui(stream, 0)) != DIS_SUCCESS)
+			return ret;
+	} else if ((ret = send_ip_addrs_to_mom(stream, 1)) != DIS_SUCCESS)
+		return ret;
 
-	if ((ret = send_ip_addrs_to_mom(stream, 1)) != DIS_SUCCESS)
+	if ((ret = diswui(stream, IS_FEAT_RESCUSED2)) != DIS_SUCCESS)
 		return ret;
 
 	return dis_flush(stream);
@@ -1994,6 +1997,75 @@ find_vnode_in_execvnode(char *big, char *little)
 	return 0;
 }
 
+/**
+ * @brief
+ * 		decode the binary numeric resources_used values of an IS_RESCUSED2
+ *		update into prused->ru_num
+ *
+ * @param[in]	stream	-	TPP stream open from Mom on which to read the msg
+ * @param[out]	prused	-	Job Resource Usage request
+ *
+ * @return	int
+ * @return	return code
+ */
+static int
+decode_ruu_num(int stream, ruu *prused)
+{
+	int		 i;
+	int		 rc;
+	unsigned int	 n;
+	ruu_num		*pnum;
+
+	n = disrui(stream, &rc);
+	if (rc)
+		return rc;
+	if (n == 0)
+		return 0;
+	if (n > (unsigned int)svr_resc_size)
+		return DIS_PROTO;
+
+	prused->ru_num = (ruu_num *)calloc(n, sizeof(ruu_num));
+	if (prused->ru_num == NULL)
+		return DIS_NOMALLOC;
+	prused->ru_nnum = n;
+
+	for (i = 0; i < prused->ru_nnum; i++) {
+		pnum = &prused->ru_num[i];
+		rc = disrfst(stream, RUU_RESC_NAMELEN - 1, pnum->rn_name);
+		if (rc)
+			break;
+		pnum->rn_type = disrui(stream, &rc);
+		if (rc)
+			break;
+		switch (pnum->rn_type) {
+			case ATR_TYPE_LONG:
+				pnum->rn_val.at_long = disrsl(stream, &rc);
+				break;
+			case ATR_TYPE_SIZE:
+				pnum->rn_val.at_size.atsv_num = disrull(stream, &rc);
+				if (rc == 0)
+					pnum->rn_val.at_size.atsv_shift = disrui(stream, &rc);
+				if (rc == 0)
+					pnum->rn_val.at_size.atsv_units = disrui(stream, &rc);
+				break;
+			case ATR_TYPE_FLOAT:
+				pnum->rn_val.at_float = disrf(stream, &rc);
+				break;
+			default:
+				rc = DIS_PROTO;
+				break;
+		}
+		if (rc)
+			break;
+	}
+	if (rc) {
+		free(prused->ru_num);
+		prused->ru_num = NULL;
+		prused->ru_nnum = 0;
+	}
+	return rc;
+}
+
 /**
  * @brief
  * 		decode_stat_update - decodes body of status update request from MOM
@@ -2003,13 +2075,15 @@ find_vnode_in_execvnode(char *big, char *little)
  *
  * @param[in]	stream	-	TPP stream open from Mom on which to read the msg
  * @param[out]	prused	-	Job Resource Usage requests
+ * @param[in]	binary	-	set if the update is IS_RESCUSED2 and carries
+ *				binary numeric resources_used values
  *
  * @return	int
  * @return	return code
  */
 
 static int
-decode_stat_update(int stream, ruu *prused)
+decode_stat_update(int stream, ruu *prused, int binary)
 {
 	int		 hc;
 	int		 rc;
@@ -2036,14 +2110,73 @@ decode_stat_update(int stream, ruu *prused)
 	if (rc)
 		return rc;
 
+	prused->ru_nnum = 0;
+	prused->ru_num = NULL;
+	if (binary) {
+		rc = decode_ruu_num(stream, prused);
+		if (rc)
+			return rc;
+	}
+
 	CLEAR_HEAD(prused->ru_attr);
 	rc = decode_DIS_svrattrl(stream, &prused->ru_attr);
 	if (rc) {
 		free_attrlist(&prused->ru_attr);
+		free(prused->ru_num);
+		prused->ru_num = NULL;
+		prused->ru_nnum = 0;
 	}
 	return rc;
 }
 
+/**
+ * @brief
+ *		Set the binary numeric resources_used values of an update directly
+ *		into the job's resources_used attribute.  Values not in the update
+ *		are left as they are since Mom leaves out those that have not
+ *		changed.
+ *
+ * @param[in]	pjob	-	the job
+ * @param[in]	prused	-	Job Resource Usage request
+ *
+ * @return	void
+ */
+static void
+set_resc_used_num(job *pjob, ruu *prused)
+{
+	int		 i;
+	attribute	*pattr;
+	resource	*presc;
+	resource_def	*prdef;
+	ruu_num		*pnum;
+
+	if (prused->ru_nnum == 0)
+		return;
+
+	pattr = &pjob->ji_wattr[(int)JOB_ATR_resc_used];
+	for (i = 0; i < prused->ru_nnum; i++) {
+		pnum = &prused->ru_num[i];
+		prdef = find_resc_def(svr_resc_def, pnum->rn_name);
+		if ((prdef == NULL) || (prdef->rs_type != pnum->rn_type)) {
+			log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_JOB, LOG_DEBUG,
+				pjob->ji_qs.ji_jobid,
+				"ignoring update of resources_used.%s", pnum->rn_name);
+			continue;
+		}
+		presc = find_resc_entry(pattr, prdef);
+		if (presc == NULL) {
+			presc = add_resource_entry(pattr, prdef);
+			if (presc == NULL) {
+				log_err(PBSE_SYSTEM, __func__, "Unable to malloc space");
+				return;
+			}
+		}
+		presc->rs_value.at_val = pnum->rn_val;
+		presc->rs_value.at_flags |= ATR_SET_MOD_MCACHE;
+	}
+	pattr->at_flags |= ATR_SET_MOD_MCACHE;
+}
+
 
 /**
  * @brief
@@ -2059,11 +2192,13 @@ decode_stat_update(int stream, ruu *prused)
  * 		is_request
  *
  * @param[in] stream - TPP stream open from Mom on which to read the msg
+ * @param[in] binary - set for IS_RESCUSED2, whose numeric resources_used
+ *		       values are set without being decoded from strings
  *
  * @return	void
  */
 static void
-stat_update(int stream)
+stat_update(int stream, int binary)
 {
 	int			 bad;
 	int			 num;
@@ -2084,7 +2219,7 @@ stat_update(int stream)
 	while (njobs--) {
 
 		rused.ru_pjobid = NULL;
-		if (decode_stat_update(stream, &rused) != 0) {
+		if (decode_stat_update(stream, &rused, binary) != 0) {
 
 			if ((mp = tfind2((u_long)stream, 0, &streams)) != NULL) {
 
@@ -2188,6 +2323,7 @@ stat_update(int stream)
 			}
 			if (is_jattr_set(pjob, JOB_ATR_session_id))
 				old_sid = get_jattr_long(pjob, JOB_ATR_session_id);
+			set_resc_used_num(pjob, &rused);
 			/* update all the attributes sent from Mom */
 			sattrl = (svrattrl *)GET_NEXT(rused.ru_attr);
 			if(sattrl != NULL) {
@@ -2252,6 +2388,9 @@ stat_update(int stream)
 		rused.ru_comment = NULL;
 		(void)free(rused.ru_pjobid);
 		rused.ru_pjobid = NULL;
+		(void)free(rused.ru_num);
+		rused.ru_num = NULL;
+		rused.ru_nnum = 0;
 		free_attrlist(&rused.ru_attr);
 	}
 }
@@ -2303,7 +2442,7 @@ recv_job_obit(int stream)
 		rused.ru_next = NULL;
 		rused.ru_pjobid = NULL;
 
-		if (decode_stat_update(stream, &rused) == 0) {
+		if (decode_stat_update(stream, &rused, 0) == 0) {
 			int is_reject = 0;
 
 			DBPRT(("recv_job_obit: decoded obit for %s\n", rused.ru_pjobid))
@@ -4875,15 +5014,18 @@ found:
 			break;
 
 		case IS_RESCUSED:
+		case IS_RESCUSED2:
 		case IS_RESCUSED_FROM_HOOK:
 
 			if (command == IS_RESCUSED) {
 				DBPRT(("%s: IS_RESCUSED\n", __func__))
+			} else if (command == IS_RESCUSED2) {
+				DBPRT(("%s: IS_RESCUSED2\n", __func__))
 			} else {
 				DBPRT(("%s: IS_RESCUSED_FROM_HOOK\n", __func__))
 			}
 
-			stat_update(stream);
+			stat_update(stream, command == IS_RESCUSED2);
 			break;
 
 		case IS_JOBOBIT:
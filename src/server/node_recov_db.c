@@ -170,6 +170,7 @@ node_recov_db(char *nd_name, struct pbsnode *pnode)
 	obj.pbs_db_obj_type = PBS_DB_NODE;
 	obj.pbs_db_un.pbs_db_node = &dbnode;
 
+	db_writer_barrier();
 	rc = pbs_db_load_obj(conn, &obj);
 	if (rc == -2)
 		return pnode; /* no change in node, return the same pnode */
@@ -339,9 +340,12 @@ node_save_db(struct pbsnode *pnode)
 	obj.pbs_db_obj_type = PBS_DB_NODE;
 	obj.pbs_db_un.pbs_db_node = &dbnode;
 
-	if ((rc = pbs_db_save_obj(conn, &obj, savetype)) != 0) {
-		savetype |= (OBJ_SAVE_NEW | OBJ_SAVE_QS);
-		rc = pbs_db_save_obj(conn, &obj, savetype);
+	if ((rc = db_writer_save(&obj, savetype)) != 0) {
+		db_writer_barrier();
+		if ((rc = pbs_db_save_obj(conn, &obj, savetype)) != 0) {
+			savetype |= (OBJ_SAVE_NEW | OBJ_SAVE_QS);
+			rc = pbs_db_save_obj(conn, &obj, savetype);
+		}
 	}
 
 	if (rc == 0)
@@ -384,6 +388,7 @@ node_delete_db(struct pbsnode *pnode)
 	obj.pbs_db_obj_type = PBS_DB_NODE;
 	obj.pbs_db_un.pbs_db_node = &dbnode;
 
+	db_writer_barrier();
 	if (pbs_db_delete_obj(conn, &obj) == -1) {
 		log_errf(PBSE_INTERNAL, __func__, "Failed to delete node %s %s", pnode->nd_name, conn_db_err? conn_db_err : "");
 		return (-1);
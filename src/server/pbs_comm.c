@@ -90,6 +90,7 @@ char	        primary_host[PBS_MAXHOSTNAME+1];   /* host_name of primary */
 static int stalone = 0;	/* is program running not as a service ? */
 static int get_out = 0;
 static int hupped = 0;
+static int dump_stats = 0;
 
 /*
  * Server failover role
@@ -204,6 +205,22 @@ hup_me(int sig)
 	log_err(-1, __func__, buf);
 }
 
+/**
+ * @brief
+ * 		USR2 handler for the pbs_comm daemon
+ *
+ * 		Sets a global variable to log the transport statistics
+ *
+ * @param[in]	sig	- name of signal caught
+ *
+ * @return	void
+ */
+static void
+stats_me(int sig)
+{
+	dump_stats = 1;
+}
+
 /**
  * @brief
  * 		lock out the lockfile for this daemon
@@ -516,6 +533,9 @@ main(int argc, char **argv)
 	if (already_forked == 0)
 		lock_out(lockfds, F_WRLCK);
 
+	/* the log writer thread must be started after forking */
+	(void) log_async_start(pbs_conf.pbs_log_async);
+
 	/* go_to_backgroud call creates a forked process,
 	 * thus print/log pid only after go_to_background()
 	 * has been called
@@ -561,10 +581,12 @@ main(int argc, char **argv)
 		log_err(errno, __func__, "sigaction for PIPE");
 		return (2);
 	}
+	act.sa_handler = stats_me;
 	if (sigaction(SIGUSR2, &act, &oact) != 0) {
 		log_err(errno, __func__, "sigaction for USR2");
 		return (2);
 	}
+	act.sa_handler = SIG_IGN;
 #ifdef PBS_UNDOLR_ENABLED
 	act.sa_handler = catch_sigusr1;
 #endif
@@ -622,6 +644,15 @@ main(int argc, char **argv)
 		if (sigusr1_flag)
 			undolr();
 #endif
+		if (dump_stats == 1) {
+			int old_logevent = pbs_conf.pbs_comm_log_events;
+
+			/* statistics are logged as debug events, make sure they show */
+			dump_stats = 0;
+			pbs_conf.pbs_comm_log_events |= PBSEVENT_DEBUG;
+			tpp_stats_dump();
+			pbs_conf.pbs_comm_log_events = old_logevent;
+		}
 
 		sleep(3);
 	}
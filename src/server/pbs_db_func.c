@@ -169,6 +169,8 @@ stop_db()
 {
 	char *db_err = NULL;
 	int db_delay = 0;
+
+	db_writer_stop();
 	pbs_db_disconnect(svr_db_conn);
 	svr_db_conn = NULL;
 
@@ -106,6 +106,8 @@
 #include <signal.h>
 #endif
 
+/* upper limit of threads decoding job rows during recovery */
+#define RECOV_MAX_DECODE_THREADS 8
 
 /* global Data Items */
 
@@ -182,6 +184,7 @@ static void  need_y_response(int, char *);
 static int   pbsd_init_reque(job *job, int change_state);
 static void  resume_net_move(struct work_task *);
 static void  stop_me(int);
+static void  catch_usr2(int);
 static int   Rmv_if_resv_not_possible(job *);
 static int   attach_queue_to_reservation(resc_resv *);
 static void  call_log_license(struct work_task *);
@@ -330,6 +333,8 @@ pbsd_init(int type)
 	pbs_db_que_info_t	dbque = {{0}};
 	pbs_db_sched_info_t	dbsched = {{0}};
 	pbs_db_obj_info_t	obj = {0};
+	pbs_db_search_stats_t	recov_stats;
+	int	nworkers;
 	void	*conn = (void *) svr_db_conn;
 	char *buf = NULL;
 	int buf_len = 0;
@@ -474,10 +479,12 @@ pbsd_init(int type)
 		log_err(errno, __func__, "sigaction for PIPE");
 		return (2);
 	}
+	act.sa_handler = catch_usr2;
 	if (sigaction(SIGUSR2, &act, &oact) != 0) {
 		log_err(errno, __func__, "sigaction for USR2");
 		return (2);
 	}
+	act.sa_handler = SIG_IGN;
 
 #ifdef PBS_UNDOLR_ENABLED
 	act.sa_handler = catch_sigusr1;
@@ -666,7 +673,7 @@ pbsd_init(int type)
 	 * 8A. If not a "create" initialization, recover queues.
 	 *    If a create, remove any queues that might be there.
 	 */
-	if ((queues_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((queues_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating queue index failed!");
 		return (-1);
 	}
@@ -708,7 +715,7 @@ pbsd_init(int type)
 	set_ical_zoneinfo(zone_dir);
 
 	/* load reservations */
-	if ((resvs_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((resvs_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating reservations index failed!");
 		return (-1);
 	}
@@ -730,7 +737,7 @@ pbsd_init(int type)
 	 *    If a create or clean recovery, delete any jobs.
 	 *    Before job creation/recovery, create the jobs index.
 	 */
-	if ((jobs_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((jobs_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating jobs index failed!");
 		return (-1);
 	}
@@ -740,7 +747,14 @@ pbsd_init(int type)
 	/* get jobs from DB */
 	obj.pbs_db_obj_type = PBS_DB_JOB;
 	obj.pbs_db_un.pbs_db_job = &dbjob;
-	rc = pbs_db_search(conn, &obj, NULL, (query_cb_t)&recov_job_cb);
+	nworkers = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+	if (nworkers > RECOV_MAX_DECODE_THREADS)
+		nworkers = RECOV_MAX_DECODE_THREADS;
+	rc = pbs_db_search_parallel(conn, &obj, NULL, (query_cb_t)&recov_job_cb, nworkers, &recov_stats);
+	if (rc >= 0)
+		log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, msg_daemonname,
+			"Job recovery: %d jobs, query %.2fs, waiting for decode %.2fs, enqueue %.2fs, %d decode threads",
+			rc, recov_stats.ss_query, recov_stats.ss_wait, recov_stats.ss_callback, recov_stats.ss_workers);
 	if (rc == -1) {
 		pbs_db_get_errmsg(PBS_DB_ERR, &conn_db_err);
 		if (conn_db_err != NULL) {
@@ -1328,7 +1342,10 @@ pbsd_init_job(job *pjob, int type)
 			}
 
 			pjob->ji_subjindx = subjob_index_to_offset(pjob->ji_parentaj, get_index_from_jid(pjob->ji_qs.ji_jobid));
-			pjob->ji_parentaj->ji_ajtrk->tkm_tbl[pjob->ji_subjindx].trk_psubjob = pjob;
+			if (set_subjob_ptr(pjob->ji_parentaj, pjob->ji_subjindx, pjob) != 0) {
+				init_abt_job(pjob);
+				return -1;
+			}
 			/* update the tracking table */
 			set_subjob_tblstate(pjob->ji_parentaj, pjob->ji_subjindx, get_job_state(pjob));
 		}
@@ -1694,6 +1711,23 @@ catch_child(int sig)
 	reap_child_flag = 1;
 }
 
+/**
+ * @brief
+ * 		catch_usr2 - signal handler for SIGUSR2
+ *		Asks the main loop to log the request latency statistics.
+ *
+ * @param[in]	sig	- not used in fun.
+ *
+ * @return	void
+ */
+static void
+catch_usr2(int sig)
+{
+	extern int req_stats_flag;
+
+	req_stats_flag = 1;
+}
+
 /**
  * @brief
  * 		change_logs - signal handler for SIGHUP
@@ -1707,10 +1741,10 @@ catch_child(int sig)
 static void
 change_logs(int sig)
 {
-	acct_close();
+	/* the accounting file is reopened before its next record is written */
+	acct_reopen();
 	log_close(1);
 	log_open(log_file, path_log);
-	(void)acct_open(acct_file);
 }
 
 /**
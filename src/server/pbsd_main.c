@@ -163,6 +163,7 @@ unsigned int	pbs_rm_port;
 pbs_net_t	pbs_server_addr;
 unsigned int	pbs_server_port_dis;
 int		reap_child_flag = 0;
+int		req_stats_flag = 0;
 time_t		secondary_delay = 30;
 pbs_sched	*dflt_scheduler = NULL; /* the default scheduler */
 int		shutdown_who;		/* see req_shutdown() */
@@ -500,16 +501,8 @@ reap_child(void)
 			reap_child_flag = 0;
 			return;
 		}
-		ptask = (struct work_task *)GET_NEXT(task_list_event);
-		while (ptask) {
-			if ((ptask->wt_type == WORK_Deferred_Child) &&
-				(ptask->wt_event == pid)) {
-				ptask->wt_type = WORK_Deferred_Cmp;
-				ptask->wt_aux = (int)statloc;	/* exit status */
-				svr_delay_entry++;	/* see next_task() */
-			}
-			ptask = (struct work_task *)GET_NEXT(ptask->wt_linkall);
-		}
+		while ((ptask = find_event_task(WORK_Deferred_Child, pid)) != NULL)
+			complete_event_task(ptask, (int)statloc);	/* exit status */
 	}
 }
 
@@ -573,6 +566,13 @@ tcp_pre_process(conn_t *conn)
 		return rc;
 	}
 
+	/*
+	 * read what the client has sent so far without blocking, and hold
+	 * off process_request() until a whole request is buffered
+	 */
+	if (DIS_tcp_prefetch(conn->cn_sock) == 0)
+		return 0;
+
 	return 1;
 }
 
@@ -1128,6 +1128,10 @@ main(int argc, char **argv)
 	(void)setvbuf(stderr, NULL, _IOLBF, 0);
 #endif	/* end the ifndef DEBUG */
 
+	/* the log writer thread must be started after forking */
+	(void)log_async_start(pbs_conf.pbs_log_async);
+	(void)acct_async_start(pbs_conf.pbs_acct_async);
+
 	/* Protect from being killed by kernel */
 	daemon_protect(0, PBS_DAEMON_PROTECT_ON);
 
@@ -1212,7 +1216,10 @@ main(int argc, char **argv)
 		return (3);
 	}
 
-	(void)add_conn(tppfd, TppComm, (pbs_net_t)0, 0, NULL, tpp_request);
+	/* MoM traffic shares the priority lane with the scheduler */
+	if (!set_conn_as_priority(add_conn(tppfd, TppComm, (pbs_net_t)0, 0, NULL, tpp_request)))
+		log_err(-1, msg_daemonname, "could not make the TPP connection a priority connection");
+	net_set_pending_func(DIS_tcp_pending);
 
 	/* record the fact that the Secondary is up and active (running) */
 
@@ -1314,6 +1321,11 @@ main(int argc, char **argv)
 	}
 	process_hooks(periodic_req, hook_msg, sizeof(hook_msg), pbs_python_set_interrupt);
 
+	/* from here on datastore writes go through the writer thread */
+	if (db_writer_start() != 0)
+		log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER, LOG_WARNING,
+			msg_daemonname, "Datastore writer not started, saving synchronously");
+
 	/*
 	 * main loop of server
 	 * stays in this loop until server's state is either
@@ -1422,6 +1434,18 @@ main(int argc, char **argv)
 		if (reap_child_flag)	/* check again incase signal arrived */
 			reap_child();	/* before they were blocked          */
 
+		if (req_stats_flag) {
+			long old_mask = *log_event_mask;
+
+			req_stats_flag = 0;
+			log_req_stats();
+
+			/* transport statistics are logged as debug events, make sure they show */
+			*log_event_mask |= PBSEVENT_DEBUG;
+			tpp_stats_dump();
+			*log_event_mask = old_mask;
+		}
+
 #ifdef PBS_UNDOLR_ENABLED
 		if (sigusr1_flag)
 			undolr();
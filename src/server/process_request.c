@@ -55,6 +55,7 @@
  * Functions included are:
  *	pbs_crypt_des()
  *	get_credential()
+ *	log_req_stats()
  *	process_request()
  *	set_to_non_blocking()
  *	clear_non_blocking()
@@ -110,10 +111,26 @@
 #include <libutil.h>
 #include "pbs_sched.h"
 #include "auth.h"
+#include "pbs_pool.h"
 
 /* global data items */
 
 pbs_list_head svr_requests;
+static pbs_pool_t *br_pool = NULL;	/* batch_request structures */
+
+/*
+ * Latency of each request type, from the start of process_request()
+ * until the handler returns, see log_req_stats().  The histogram has
+ * power of two millisecond buckets: <1ms, <2ms, <4ms ... and the rest.
+ */
+#define REQ_STATS_TYPES		128
+#define REQ_STATS_BUCKETS	12
+static struct req_stat {
+	unsigned long	rs_count;
+	long long	rs_total_us;
+	long long	rs_max_us;
+	unsigned long	rs_hist[REQ_STATS_BUCKETS];
+} req_stats[REQ_STATS_TYPES];
 
 
 extern struct server server;
@@ -360,6 +377,72 @@ rerr:
 }
 #endif
 
+/**
+ * @brief
+ *		Add one handled request to the latency statistics of its type.
+ *
+ * @param[in]	type	- request type
+ * @param[in]	start	- time the request started to be read
+ *
+ * @return	void
+ */
+static void
+req_stats_add(int type, struct timeval *start)
+{
+	struct timeval now;
+	struct req_stat *prs;
+	long long us;
+	int b;
+
+	if ((type < 0) || (type >= REQ_STATS_TYPES))
+		return;
+	gettimeofday(&now, NULL);
+	us = (now.tv_sec - start->tv_sec) * 1000000LL + (now.tv_usec - start->tv_usec);
+	if (us < 0)
+		us = 0;
+
+	prs = &req_stats[type];
+	prs->rs_count++;
+	prs->rs_total_us += us;
+	if (us > prs->rs_max_us)
+		prs->rs_max_us = us;
+	for (b = 0; (b < REQ_STATS_BUCKETS - 1) && (us >= (1000LL << b)); b++)
+		;
+	prs->rs_hist[b]++;
+}
+
+/**
+ * @brief
+ *		Log the latency statistics of every request type seen so far.
+ *		Called from the main loop when the server gets SIGUSR2.
+ *
+ * @return	void
+ */
+void
+log_req_stats(void)
+{
+	char buf[LOG_BUF_SIZE];
+	struct req_stat *prs;
+	int len;
+	int t;
+	int b;
+
+	for (t = 0; t < REQ_STATS_TYPES; t++) {
+		prs = &req_stats[t];
+		if (prs->rs_count == 0)
+			continue;
+		len = snprintf(buf, sizeof(buf), "request type %d: count=%lu avg=%lldus max=%lldus hist(ms)",
+			t, prs->rs_count, prs->rs_total_us / (long long) prs->rs_count, prs->rs_max_us);
+		for (b = 0; (b < REQ_STATS_BUCKETS) && (len < (int) sizeof(buf)); b++) {
+			if (b < REQ_STATS_BUCKETS - 1)
+				len += snprintf(buf + len, sizeof(buf) - len, " <%d:%lu", 1 << b, prs->rs_hist[b]);
+			else
+				len += snprintf(buf + len, sizeof(buf) - len, " >=%d:%lu", 1 << (b - 1), prs->rs_hist[b]);
+		}
+		log_event(PBSEVENT_SYSTEM | PBSEVENT_FORCE, PBS_EVENTCLASS_SERVER, LOG_INFO, __func__, buf);
+	}
+}
+
 /*
 * @brief
  * 		process_request - process an request from the network:
@@ -377,12 +460,15 @@ process_request(int sfds)
 	int		      rc;
 	struct batch_request *request;
 	conn_t		     *conn;
+	struct timeval	      start;
+	int		      type;
 #ifndef PBS_MOM
 	int		     access_by_krb;
 #endif
 
 
-	time_now = time(NULL);
+	gettimeofday(&start, NULL);
+	time_now = start.tv_sec;
 
 	conn = get_conn(sfds);
 
@@ -648,6 +734,7 @@ process_request(int sfds)
 			case PBS_BATCH_UserCred:
 			case PBS_BATCH_MoveJob:
 			case PBS_BATCH_QueueJob:
+			case PBS_BATCH_SubmitJobList:
 			case PBS_BATCH_RunJob:
 			case PBS_BATCH_StageIn:
 			case PBS_BATCH_jobscript:
@@ -685,7 +772,9 @@ process_request(int sfds)
 	 * the request struture.
 	 */
 
+	type = request->rq_type;
 	dispatch_request(sfds, request);
+	req_stats_add(type, &start);
 	return;
 }
 
@@ -796,6 +885,12 @@ dispatch_request(int sfds, struct batch_request *request)
 			req_quejob(request);
 			break;
 
+#ifndef PBS_MOM
+		case PBS_BATCH_SubmitJobList:
+			req_quejoblist(request);
+			break;
+#endif
+
 		case PBS_BATCH_JobCred:
 			if (prot == PROT_TPP)
 				request->tpp_ack = 0;
@@ -891,6 +986,16 @@ dispatch_request(int sfds, struct batch_request *request)
 			req_manager(request);
 			break;
 
+		case PBS_BATCH_ModifyNodes:
+			req_modifynodes(request);
+			break;
+
+		case PBS_BATCH_ManageJobList:
+			if (sfds != PBS_LOCAL_CONNECTION && prot == PROT_TCP)
+				conn->cn_authen |= PBS_NET_CONN_NOTIMEOUT;
+			req_managejoblist(request);
+			break;
+
 		case PBS_BATCH_RelnodesJob:
 			req_relnodesjob(request);
 			break;
@@ -1009,6 +1114,16 @@ dispatch_request(int sfds, struct batch_request *request)
 			clear_non_blocking(get_conn(sfds));
 			break;
 
+		case PBS_BATCH_StatusNodeSummary:
+			if (set_to_non_blocking(conn) == -1) {
+				req_reject(PBSE_SYSTEM, 0, request);
+				close_client(sfds);
+				return;
+			}
+			req_stat_node_summary(request);
+			clear_non_blocking(get_conn(sfds));
+			break;
+
 		case PBS_BATCH_StatusResv:
 			if (set_to_non_blocking(conn) == -1) {
 				req_reject(PBSE_SYSTEM, 0, request);
@@ -1173,7 +1288,9 @@ struct batch_request *alloc_br(int type)
 {
 	struct batch_request *req;
 
-	req= (struct batch_request *)malloc(sizeof(struct batch_request));
+	if (br_pool == NULL)
+		br_pool = pbs_pool_create("batch_request", sizeof(struct batch_request));
+	req = br_pool ? (struct batch_request *)pbs_pool_alloc(br_pool) : NULL;
 	if (req== NULL)
 		log_err(errno, "alloc_br", msg_err_malloc);
 	else {
@@ -1417,6 +1534,8 @@ decode_DIS_RelnodesJob(int sock, struct batch_request *preq)
 void
 free_br(struct batch_request *preq)
 {
+	int i;
+
 	delete_link(&preq->rq_link);
 	reply_free(&preq->rq_reply);
 
@@ -1428,6 +1547,20 @@ free_br(struct batch_request *preq)
 		 * goes to zero,  reply_send() it
 		 */
 		struct batch_reply *preply = &preq->rq_parentbr->rq_reply;
+
+		/* a job of a Submit Job List owns the attributes handed to it */
+		if (preq->rq_parentbr->rq_type == PBS_BATCH_SubmitJobList)
+			free_attrlist(&preq->rq_ind.rq_queuejob.rq_attr);
+		/* as does a job of a Manage Job List, for its copy of the attributes */
+		else if (preq->rq_parentbr->rq_type == PBS_BATCH_ManageJobList) {
+			if (preq->rq_type == PBS_BATCH_HoldJob)
+				freebr_manage(&preq->rq_ind.rq_hold.rq_orig);
+			else if (preq->rq_type == PBS_BATCH_ReleaseJob)
+				freebr_manage(&preq->rq_ind.rq_release);
+			else if (preq->rq_type == PBS_BATCH_ModifyJob)
+				freebr_manage(&preq->rq_ind.rq_modify);
+		}
+
 		if (preq->rq_parentbr->rq_refct > 0) {
 			if (--preq->rq_parentbr->rq_refct == 0) {
 				if (preq->rq_parentbr->rq_type == PBS_BATCH_DeleteJobList) {
@@ -1442,7 +1575,7 @@ free_br(struct batch_request *preq)
 		if (preq->tppcmd_msgid)
 			free(preq->tppcmd_msgid);
 
-		(void)free(preq);
+		pbs_pool_free(br_pool, preq);
 		return;
 	}
 
@@ -1458,6 +1591,15 @@ free_br(struct batch_request *preq)
 		case PBS_BATCH_QueueJob:
 			free_attrlist(&preq->rq_ind.rq_queuejob.rq_attr);
 			break;
+		case PBS_BATCH_SubmitJobList:
+			for (i = 0; i < preq->rq_ind.rq_quejoblist.rq_nscripts; i++)
+				free(preq->rq_ind.rq_quejoblist.rq_scripts[i]);
+			for (i = 0; i < preq->rq_ind.rq_quejoblist.rq_count; i++)
+				free_attrlist(&preq->rq_ind.rq_quejoblist.rq_jobs[i].rq_attr);
+			free(preq->rq_ind.rq_quejoblist.rq_scripts);
+			free(preq->rq_ind.rq_quejoblist.rq_scriptsz);
+			free(preq->rq_ind.rq_quejoblist.rq_jobs);
+			break;
 		case PBS_BATCH_JobCred:
 			if (preq->rq_ind.rq_jobcred.rq_data)
 				(void)free(preq->rq_ind.rq_jobcred.rq_data);
@@ -1506,6 +1648,7 @@ free_br(struct batch_request *preq)
 		case PBS_BATCH_StatusJob:
 		case PBS_BATCH_StatusQue:
 		case PBS_BATCH_StatusNode:
+		case PBS_BATCH_StatusNodeSummary:
 		case PBS_BATCH_StatusSvr:
 		case PBS_BATCH_StatusSched:
 		case PBS_BATCH_StatusHook:
@@ -1549,6 +1692,17 @@ free_br(struct batch_request *preq)
 		case PBS_BATCH_ReleaseJob:
 			freebr_manage(&preq->rq_ind.rq_release);
 			break;
+		case PBS_BATCH_ModifyNodes:
+			free(preq->rq_ind.rq_modifynodes.rq_nodes);
+			free_attrlist(&preq->rq_ind.rq_modifynodes.rq_selattr);
+			free_attrlist(&preq->rq_ind.rq_modifynodes.rq_attr);
+			break;
+		case PBS_BATCH_ManageJobList:
+			arrayfree(preq->rq_ind.rq_managejoblist.rq_jobids);
+			free_attrlist(&preq->rq_ind.rq_managejoblist.rq_selattr);
+			free_attrlist(&preq->rq_ind.rq_managejoblist.rq_attr);
+			free(preq->rq_ind.rq_managejoblist.rq_arg);
+			break;
 		case PBS_BATCH_Rescq:
 		case PBS_BATCH_ReserveResc:
 		case PBS_BATCH_ReleaseResc:
@@ -1571,7 +1725,7 @@ free_br(struct batch_request *preq)
 	}
 	if (preq->tppcmd_msgid)
 		free(preq->tppcmd_msgid);
-	(void)free(preq);
+	pbs_pool_free(br_pool, preq);
 }
 /**
  * @brief
@@ -80,6 +80,7 @@
 #include "pbs_nodes.h"
 #include "pbs_sched.h"
 #include "pbs_idx.h"
+#include "svrfunc.h"
 
 /* Global Data */
 
@@ -262,6 +263,7 @@ que_purge(pbs_queue *pque)
 	strcpy(dbque.qu_name, pque->qu_qs.qu_name);
 	obj.pbs_db_obj_type = PBS_DB_QUEUE;
 	obj.pbs_db_un.pbs_db_que = &dbque;
+	db_writer_barrier();
 	if (pbs_db_delete_obj(conn, &obj) != 0) {
 		(void)sprintf(log_buffer,
 			"delete of que %s from datastore failed",
@@ -163,7 +163,11 @@ que_save_db(pbs_queue *pque)
 	obj.pbs_db_obj_type = PBS_DB_QUEUE;
 	obj.pbs_db_un.pbs_db_que = &dbque;
 
-	if ((rc = pbs_db_save_obj(conn, &obj, savetype)) == 0)
+	if ((rc = db_writer_save(&obj, savetype)) != 0) {
+		db_writer_barrier();
+		rc = pbs_db_save_obj(conn, &obj, savetype);
+	}
+	if (rc == 0)
 		pque->newobj = 0;
 
 done:
@@ -212,6 +216,7 @@ que_recov_db(char *qname, pbs_queue *pq)
 	obj.pbs_db_obj_type = PBS_DB_QUEUE;
 	obj.pbs_db_un.pbs_db_que = &dbque;
 
+	db_writer_barrier();
 	rc = pbs_db_load_obj(conn, &obj);
 	if (rc == -2)
 		return pq; /* no change in que, return the same pq */
@@ -260,6 +260,9 @@ reply_send_status_part(struct batch_request *preq)
 	if (preq->rq_conn >= 0) {
 		struct batch_reply *preply = &preq->rq_reply;
 		preply->brp_is_part = 1;
+#ifndef PBS_MOM
+		db_writer_barrier();
+#endif	/* PBS_MOM */
 		rc = dis_reply_write(preq->rq_conn, preq);
 		if (rc != PBSE_NONE)
 			return rc;
@@ -271,6 +274,83 @@ reply_send_status_part(struct batch_request *preq)
 	return rc;
 }
 
+/**
+ * @brief
+ *		Record the outcome of one job of a Submit Job List request in the
+ *		status its parent request set aside for it (in rq_extra).
+ *
+ * @param[in]	preq	- the Queue Job request made for the job
+ */
+static void
+set_submit_status(struct batch_request *preq)
+{
+	struct batch_submit_status *psub = preq->rq_extra;
+	struct batch_reply *preply = &preq->rq_reply;
+
+	if (psub == NULL)
+		return;
+	preq->rq_extra = NULL;
+
+	psub->code = preply->brp_code;
+	if (preply->brp_code == PBSE_NONE) {
+		if (preply->brp_choice != BATCH_REPLY_CHOICE_Commit)
+			psub->code = PBSE_INTERNAL;
+		else if ((psub->jobid = strdup(preply->brp_un.brp_jid)) == NULL)
+			psub->code = PBSE_SYSTEM;
+	} else if ((preply->brp_choice == BATCH_REPLY_CHOICE_Text) &&
+		(preply->brp_un.brp_txt.brp_str != NULL))
+		psub->text = strdup(preply->brp_un.brp_txt.brp_str);
+}
+
+/**
+ * @brief
+ *		Record the outcome of one job of a Manage Job List request in its
+ *		parent's reply.  Only the jobs that failed are listed.
+ *
+ * @param[in]	preq	- the request made for the job
+ */
+static void
+set_joblist_status(struct batch_request *preq)
+{
+	struct batch_reply *preply = &preq->rq_parentbr->rq_reply;
+	struct batch_deljob_status *pdelstat;
+	char *jid;
+
+	if (preq->rq_reply.brp_code == PBSE_NONE)
+		return;
+
+	switch (preq->rq_type) {
+		case PBS_BATCH_HoldJob:
+			jid = preq->rq_ind.rq_hold.rq_orig.rq_objname;
+			break;
+		case PBS_BATCH_ReleaseJob:
+			jid = preq->rq_ind.rq_release.rq_objname;
+			break;
+		case PBS_BATCH_ModifyJob:
+			jid = preq->rq_ind.rq_modify.rq_objname;
+			break;
+		case PBS_BATCH_SignalJob:
+			jid = preq->rq_ind.rq_signal.rq_jid;
+			break;
+		case PBS_BATCH_MoveJob:
+			jid = preq->rq_ind.rq_move.rq_jid;
+			break;
+		default:
+			return;
+	}
+
+	if ((pdelstat = malloc(sizeof(struct batch_deljob_status))) == NULL)
+		return;
+	if ((pdelstat->name = strdup(jid)) == NULL) {
+		free(pdelstat);
+		return;
+	}
+	pdelstat->code = preq->rq_reply.brp_code;
+	pdelstat->next = preply->brp_un.brp_deletejoblist.brp_delstatc;
+	preply->brp_un.brp_deletejoblist.brp_delstatc = pdelstat;
+	preply->brp_count++;
+}
+
 /**
  * @brief
  * 		Send a reply to a batch request, reply either goes to a
@@ -310,7 +390,11 @@ reply_send(struct batch_request *request)
 
 	/* if this is a child request, just move the error to the parent */
 	if (request->rq_parentbr) {
-		if ((request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_NULL) && (request->rq_parentbr->rq_reply.brp_code == 0)) {
+		if (request->rq_parentbr->rq_type == PBS_BATCH_SubmitJobList) {
+			set_submit_status(request);
+		} else if (request->rq_parentbr->rq_type == PBS_BATCH_ManageJobList) {
+			set_joblist_status(request);
+		} else if ((request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_NULL) && (request->rq_parentbr->rq_reply.brp_code == 0)) {
 			request->rq_parentbr->rq_reply.brp_code = request->rq_reply.brp_code;
 			request->rq_parentbr->rq_reply.brp_auxcode = request->rq_reply.brp_auxcode;
 			if (request->rq_reply.brp_choice == BATCH_REPLY_CHOICE_Text) {
@@ -346,7 +430,7 @@ reply_send(struct batch_request *request)
 		while (ptask) {
 			if ((ptask->wt_type == WORK_Deferred_Local) &&
 				(ptask->wt_parm1 == (void *)request)) {
-				delete_link(&ptask->wt_linkall);
+				remove_task_event(ptask);
 				append_link(&task_list_immed,
 					&ptask->wt_linkall, ptask);
 				return (0);
@@ -366,6 +450,10 @@ reply_send(struct batch_request *request)
 		 * Otherwise, the reply is to be sent to a remote client
 		 */
 		if (rc == PBSE_NONE) {
+#ifndef PBS_MOM
+			/* what the client is told must be on disk first */
+			db_writer_barrier();
+#endif	/* PBS_MOM */
 			rc = dis_reply_write(sfds, request);
 		}
 	}
@@ -429,6 +517,7 @@ reply_free(struct batch_reply *prep)
 	struct brp_select  *pselx;
 	struct batch_deljob_status *pdelstat;
 	struct batch_deljob_status *pdelstatx;
+	struct batch_submit_status *psubstat;
 
 	if (prep->brp_choice == BATCH_REPLY_CHOICE_Text) {
 		if (prep->brp_un.brp_txt.brp_str) {
@@ -458,10 +547,19 @@ reply_free(struct batch_reply *prep)
 		pdelstat = prep->brp_un.brp_deletejoblist.brp_delstatc;
 		while (pdelstat) {
 			pdelstatx = pdelstat->next;
+			free(pdelstat->name);
 			free(pdelstat);
 			pdelstat = pdelstatx;
 	}
 		
+	} else if (prep->brp_choice == BATCH_REPLY_CHOICE_SubmitList) {
+		while ((psubstat = prep->brp_un.brp_substatc) != NULL) {
+			prep->brp_un.brp_substatc = psubstat->next;
+			free(psubstat->jobid);
+			free(psubstat->text);
+			free(psubstat);
+		}
+
 	} else if (prep->brp_choice == BATCH_REPLY_CHOICE_RescQuery) {
 		(void)free(prep->brp_un.brp_rescq.brq_avail);
 		(void)free(prep->brp_un.brp_rescq.brq_alloc);
@@ -258,7 +258,7 @@ check_deletehistoryjob(struct batch_request * preq, char * jid)
 					char *sjid = mk_subjob_id(histpjob, i);
 					job  *psjob;
 
-					if ((psjob = histpjob->ji_ajtrk->tkm_tbl[i].trk_psubjob)) {
+					if ((psjob = get_subjob_ptr(histpjob, i))) {
 						snprintf(log_buffer, sizeof(log_buffer),
 							msg_job_history_delete, preq->rq_user,
 							preq->rq_host);
@@ -499,7 +499,7 @@ req_deletejob(struct batch_request *preq)
 					return;
 				} else
 					continue;
-			} else if ((pjob = parent->ji_ajtrk->tkm_tbl[offset].trk_psubjob)) {
+			} else if ((pjob = get_subjob_ptr(parent, offset))) {
 				/*
 				 * If the request is to also purge the history of the sub job then set ji_deletehistory to 1
 				 */
@@ -542,7 +542,7 @@ req_deletejob(struct batch_request *preq)
 				sjst = get_subjob_state(parent, i);
 				if ((sjst == JOB_STATE_LTR_EXITING) && !forcedel)
 					continue;
-				if ((pjob = parent->ji_ajtrk->tkm_tbl[i].trk_psubjob)) {
+				if ((pjob = get_subjob_ptr(parent, i))) {
 					if (delhist)
 						pjob->ji_deletehistory = 1;
 					if (check_job_state(pjob, JOB_STATE_LTR_EXPIRED)) {
@@ -641,7 +641,7 @@ req_deletejob(struct batch_request *preq)
 				if ((sjst == JOB_STATE_LTR_EXITING) && !forcedel)
 					continue;
 
-				if ((pjob = parent->ji_ajtrk->tkm_tbl[idx].trk_psubjob)) {
+				if ((pjob = get_subjob_ptr(parent, idx))) {
 					if (delhist)
 						pjob->ji_deletehistory = 1;
 					if (check_job_state(pjob, JOB_STATE_LTR_EXPIRED)) {
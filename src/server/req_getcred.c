@@ -49,6 +49,8 @@
 #include <sys/types.h>
 #include <string.h>
 #include "libpbs.h"
+#include "dis.h"
+#include "pbs_internal.h"
 #include "server_limits.h"
 #include "list_link.h"
 #include "attribute.h"
@@ -61,7 +63,9 @@
 /**
  * @brief
  * 		req_connect - process a Connection Request
- * 		Almost does nothing.
+ * 		Almost does nothing.  If the client offers the binary DIS
+ * 		encoding in the extend and it is allowed, the offer is echoed
+ * 		back and the connection switches to it after the reply.
  *
  * @param[in]	preq	- Connection Request
  */
@@ -69,7 +73,8 @@
 void
 req_connect(struct batch_request *preq)
 {
-	conn_t *conn = get_conn(preq->rq_conn);
+	int sock = preq->rq_conn;
+	conn_t *conn = get_conn(sock);
 
 	if (!conn) {
 		req_reject(PBSE_SYSTEM, 0, preq);
@@ -79,6 +84,12 @@ req_connect(struct batch_request *preq)
 	if (preq->rq_extend != NULL) {
 		if (strcmp(preq->rq_extend, QSUB_DAEMON) == 0)
 			conn->cn_authen |= PBS_NET_CONN_FROM_QSUB_DAEMON;
+		else if (strcmp(preq->rq_extend, DIS_V2_OFFER) == 0 &&
+			pbs_conf.pbs_dis_version >= DIS_VERSION_2) {
+			if (reply_text(preq, PBSE_NONE, DIS_V2_OFFER) == 0)
+				dis_set_version(sock, DIS_VERSION_2);
+			return;
+		}
 	}
 
 	reply_ack(preq);
@@ -328,7 +328,7 @@ req_releasejob(struct batch_request *preq)
 	if ((jt == IS_ARRAY_ArrayJob) && (pjob->ji_ajtrk)) {
 		int i;
 		for(i = 0 ; i < pjob->ji_ajtrk->tkm_ct ; i++) {
-			job *psubjob = pjob->ji_ajtrk->tkm_tbl[i].trk_psubjob;
+			job *psubjob = get_subjob_ptr(pjob, i);
 			if (psubjob && (check_job_state(psubjob, JOB_STATE_LTR_HELD))) {
 #ifndef NAS
 				old_hold = get_jattr_long(psubjob, JOB_ATR_hold);
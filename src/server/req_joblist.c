@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	req_joblist.c
+ *
+ * @brief
+ * 	Functions relating to the Manage Job List Batch Request, which holds,
+ * 	releases, signals, alters or moves many jobs in one request.
+ *
+ * Included funtions are:
+ *	req_managejoblist()
+ *	joblist_save_failed()
+ *	joblist_batch()
+ *	joblist_next_batch()
+ *
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include "libpbs.h"
+#include "server_limits.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "server.h"
+#include "credential.h"
+#include "batch_request.h"
+#include "net_connect.h"
+#include "job.h"
+#include "work_task.h"
+#include "pbs_error.h"
+#include "log.h"
+#include "pbs_nodes.h"
+#include "svrfunc.h"
+#include "pbs_db.h"
+
+/* jobs acted on per datastore transaction before yielding to other work */
+#define JOBLIST_BATCH	1000
+
+/* Global Data Items: */
+
+extern struct server server;
+extern void *svr_db_conn;
+
+/* Private Functions Local to this file */
+
+static void joblist_batch(struct batch_request *);
+static void joblist_next_batch(struct work_task *);
+
+/**
+ * @brief
+ * 		joblist_rqtype - the request type a job of a Manage Job List is
+ *		acted on with
+ *
+ * @param[in]	op	- JOBLIST_HOLD, JOBLIST_RELEASE, ...
+ *
+ * @return	int
+ * @retval	request type
+ * @retval	-1	: unknown operation
+ */
+static int
+joblist_rqtype(int op)
+{
+	switch (op) {
+		case JOBLIST_HOLD:
+			return PBS_BATCH_HoldJob;
+		case JOBLIST_RELEASE:
+			return PBS_BATCH_ReleaseJob;
+		case JOBLIST_SIGNAL:
+			return PBS_BATCH_SignalJob;
+		case JOBLIST_ALTER:
+			return PBS_BATCH_ModifyJob;
+		case JOBLIST_MOVE:
+			return PBS_BATCH_MoveJob;
+		default:
+			return -1;
+	}
+}
+
+/**
+ * @brief
+ * 		joblist_set_manage - fill in the manage part of a job's request,
+ *		with its own copy of the attributes
+ *
+ * @param[out]	pmgr	- manage part of the request
+ * @param[in]	jid	- job id
+ * @param[in]	pattrs	- attributes of the Manage Job List
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+joblist_set_manage(struct rq_manage *pmgr, char *jid, pbs_list_head *pattrs)
+{
+	pmgr->rq_cmd = MGR_CMD_SET;
+	pmgr->rq_objtype = MGR_OBJ_JOB;
+	snprintf(pmgr->rq_objname, sizeof(pmgr->rq_objname), "%s", jid);
+	return (copy_svrattrl_list(pattrs, &pmgr->rq_attr));
+}
+
+/**
+ * @brief
+ * 		req_managejoblist - service the Manage Job List Request
+ *
+ *		The jobs are the ones named in the request or, if none are, the
+ *		ones that match its selection criteria and that the requester
+ *		may act on.  Each job is handed to the service routine of the
+ *		single job request (req_holdjob(), ...) as a child request, in
+ *		batches of JOBLIST_BATCH jobs that are saved in one datastore
+ *		transaction.  The reply lists the jobs that failed.
+ *
+ * @param[in,out]	preq	- Manage Job List Request
+ */
+void
+req_managejoblist(struct batch_request *preq)
+{
+	struct rq_managejoblist *pml = &preq->rq_ind.rq_managejoblist;
+	svrattrl *plist;
+	int bad = 0;
+	int rc;
+
+	if (joblist_rqtype(pml->rq_op) == -1) {
+		req_reject(PBSE_IVALREQ, 0, preq);
+		return;
+	}
+	if ((pml->rq_op == JOBLIST_MOVE) &&
+		(server.sv_attr[(int)SVR_ATR_State].at_val.at_long > SV_STATE_RUN)) {
+		req_reject(PBSE_SVRDOWN, 0, preq);
+		return;
+	}
+
+	if (pml->rq_count == 0) {
+		plist = (svrattrl *) GET_NEXT(pml->rq_selattr);
+		if (plist == NULL) {
+			/* acting on every job takes at least one criterion */
+			req_reject(PBSE_IVALREQ, 0, preq);
+			return;
+		}
+		arrayfree(pml->rq_jobids);
+		rc = select_jobids(preq, plist, &pml->rq_jobids, &pml->rq_count, &bad);
+		if (rc != 0) {
+			reply_badattr(rc, bad, plist, preq);
+			return;
+		}
+	}
+
+	snprintf(log_buffer, sizeof(log_buffer), "Manage Job List of %d jobs, type %d, from %s@%s",
+		pml->rq_count, joblist_rqtype(pml->rq_op), preq->rq_user, preq->rq_host);
+	log_event(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_INFO, __func__, log_buffer);
+
+	preq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_Delete;
+	preq->rq_reply.brp_un.brp_deletejoblist.brp_delstatc = NULL;
+	preq->rq_reply.brp_count = 0;
+	pml->rq_next = 0;
+
+	/* hold the reply until every job has been handed out */
+	preq->rq_refct++;
+
+	joblist_batch(preq);
+}
+
+/**
+ * @brief
+ * 		joblist_save_failed - list the jobs of a batch whose changes were
+ *		not saved because the batch's transaction did not commit
+ *
+ *		Jobs already listed with an error of their own keep it.
+ *
+ * @param[in,out]	preq	- Manage Job List Request
+ * @param[in]	start	- index of the first job of the batch
+ * @param[in]	end	- index after the last job of the batch
+ */
+static void
+joblist_save_failed(struct batch_request *preq, int start, int end)
+{
+	struct rq_managejoblist *pml = &preq->rq_ind.rq_managejoblist;
+	struct batch_reply *preply = &preq->rq_reply;
+	struct batch_deljob_status *pdelstat;
+	int i;
+
+	for (i = start; i < end; i++) {
+		for (pdelstat = preply->brp_un.brp_deletejoblist.brp_delstatc; pdelstat; pdelstat = pdelstat->next) {
+			if (strcmp(pdelstat->name, pml->rq_jobids[i]) == 0)
+				break;
+		}
+		if (pdelstat != NULL)
+			continue;
+
+		if ((pdelstat = malloc(sizeof(struct batch_deljob_status))) == NULL)
+			return;
+		if ((pdelstat->name = strdup(pml->rq_jobids[i])) == NULL) {
+			free(pdelstat);
+			return;
+		}
+		pdelstat->code = PBSE_SAVE_ERR;
+		pdelstat->next = preply->brp_un.brp_deletejoblist.brp_delstatc;
+		preply->brp_un.brp_deletejoblist.brp_delstatc = pdelstat;
+		preply->brp_count++;
+	}
+}
+
+/**
+ * @brief
+ * 		joblist_batch - act on the next batch of jobs of a Manage Job List
+ *
+ *		The jobs of a batch are saved in one datastore transaction.  If
+ *		jobs remain, the next batch runs from a work task so that other
+ *		requests are served in between; otherwise the reference taken by
+ *		req_managejoblist() is dropped and the reply is sent once every
+ *		job has replied.  If the transaction does not commit, every job of
+ *		the batch is reported with PBSE_SAVE_ERR.
+ *
+ * @param[in,out]	preq	- Manage Job List Request
+ */
+static void
+joblist_batch(struct batch_request *preq)
+{
+	struct rq_managejoblist *pml = &preq->rq_ind.rq_managejoblist;
+	struct batch_request *pchild;
+	int type = joblist_rqtype(pml->rq_op);
+	char *jid;
+	int in_trx;
+	int start;
+	int end;
+	int rc;
+
+	start = pml->rq_next;
+	end = pml->rq_next + JOBLIST_BATCH;
+	if (end > pml->rq_count)
+		end = pml->rq_count;
+
+	in_trx = (pbs_db_begin_trx(svr_db_conn) == 0);
+
+	for (; pml->rq_next < end; pml->rq_next++) {
+		jid = pml->rq_jobids[pml->rq_next];
+
+		pchild = alloc_br(type);
+		if (pchild == NULL) {
+			/* give up on the rest, the jobs handed out still reply */
+			preq->rq_reply.brp_code = PBSE_SYSTEM;
+			pml->rq_next = pml->rq_count;
+			break;
+		}
+		pchild->rq_perm = preq->rq_perm;
+		pchild->rq_fromsvr = preq->rq_fromsvr;
+		pchild->rq_conn = preq->rq_conn;
+		pchild->rq_orgconn = preq->rq_orgconn;
+		pchild->rq_time = preq->rq_time;
+		pchild->prot = preq->prot;
+		strcpy(pchild->rq_user, preq->rq_user);
+		strcpy(pchild->rq_host, preq->rq_host);
+		pchild->rq_extend = preq->rq_extend;
+
+		rc = 0;
+		switch (type) {
+			case PBS_BATCH_HoldJob:
+				rc = joblist_set_manage(&pchild->rq_ind.rq_hold.rq_orig, jid, &pml->rq_attr);
+				break;
+			case PBS_BATCH_ReleaseJob:
+				rc = joblist_set_manage(&pchild->rq_ind.rq_release, jid, &pml->rq_attr);
+				break;
+			case PBS_BATCH_ModifyJob:
+				rc = joblist_set_manage(&pchild->rq_ind.rq_modify, jid, &pml->rq_attr);
+				break;
+			case PBS_BATCH_SignalJob:
+				snprintf(pchild->rq_ind.rq_signal.rq_jid,
+					sizeof(pchild->rq_ind.rq_signal.rq_jid), "%s", jid);
+				snprintf(pchild->rq_ind.rq_signal.rq_signame,
+					sizeof(pchild->rq_ind.rq_signal.rq_signame), "%s", pml->rq_arg);
+				break;
+			case PBS_BATCH_MoveJob:
+				snprintf(pchild->rq_ind.rq_move.rq_jid,
+					sizeof(pchild->rq_ind.rq_move.rq_jid), "%s", jid);
+				snprintf(pchild->rq_ind.rq_move.rq_destin,
+					sizeof(pchild->rq_ind.rq_move.rq_destin), "%s", pml->rq_arg);
+				break;
+		}
+
+		pchild->rq_parentbr = preq;
+		preq->rq_refct++;
+
+		if (rc != 0) {
+			req_reject(PBSE_SYSTEM, 0, pchild);
+			continue;
+		}
+
+		switch (type) {
+			case PBS_BATCH_HoldJob:
+				req_holdjob(pchild);
+				break;
+			case PBS_BATCH_ReleaseJob:
+				req_releasejob(pchild);
+				break;
+			case PBS_BATCH_ModifyJob:
+				req_modifyjob(pchild);
+				break;
+			case PBS_BATCH_SignalJob:
+				req_signaljob(pchild);
+				break;
+			case PBS_BATCH_MoveJob:
+				req_movejob(pchild);
+				break;
+		}
+	}
+
+	if (in_trx && (pbs_db_end_trx(svr_db_conn, PBS_DB_COMMIT) != 0)) {
+		log_err(PBSE_SAVE_ERR, __func__, "Failed to commit a batch of a Manage Job List");
+		joblist_save_failed(preq, start, pml->rq_next);
+	}
+
+	if (pml->rq_next < pml->rq_count) {
+		if (set_task(WORK_Immed, 0, joblist_next_batch, preq) != NULL)
+			return;
+		/* cannot defer, act on the rest now */
+		joblist_batch(preq);
+		return;
+	}
+
+	if (--preq->rq_refct == 0)
+		reply_send(preq);
+}
+
+/**
+ * @brief
+ * 		joblist_next_batch - work task that acts on the next batch of jobs
+ *		of a Manage Job List
+ *
+ * @param[in]	ptask	- work task, wt_parm1 is the request
+ */
+static void
+joblist_next_batch(struct work_task *ptask)
+{
+	joblist_batch((struct batch_request *)ptask->wt_parm1);
+}
@@ -1370,14 +1370,8 @@ job_obit(ruu *pruu, int stream)
 			 */
 			if (pjob->ji_momhandle != -1) {
 				struct batch_request *prequest;
-				extern pbs_list_head task_list_event;
 
-				ptask = (struct work_task *) GET_NEXT(task_list_event);
-				while (ptask) {
-					if (ptask->wt_type == WORK_Deferred_Reply && ptask->wt_event == pjob->ji_momhandle)
-						break;
-					ptask = (struct work_task *) GET_NEXT(ptask->wt_linkall);
-				}
+				ptask = find_event_task(WORK_Deferred_Reply, pjob->ji_momhandle);
 				if (ptask) {
 					if ((prequest = ptask->wt_parm1) != NULL)
 						free_br(prequest);
@@ -129,6 +129,7 @@ extern char *msg_noattr;
 extern unsigned int pbs_mom_port;
 extern char server_host[];
 extern char *path_hooks;
+extern pbs_list_head svr_management_hooks;
 extern 	int max_concurrent_prov;
 extern char *msg_cannot_set_route_que;
 extern int check_req_aoe_available(struct pbsnode *, char *);
@@ -145,6 +146,7 @@ enum res_op_flag {
 
 extern time_t time_now;
 extern void	*svr_db_conn;
+extern int resc_access_perm;
 struct work_task *rescdef_wt_g = NULL;
 
 
@@ -1113,6 +1115,7 @@ mgr_unset_attr(attribute *pattr, void *pidx, attribute_def *pdef, int limit, svr
 				break;
 		}
 
+		db_writer_barrier();
 		rc = pbs_db_delete_attr_obj(conn, &obj, parent_id, &db_attr_list);
 		free_db_attr_list(&db_attr_list);
 
@@ -1920,6 +1923,102 @@ mgr_queue_unset(struct batch_request *preq)
 	reply_ack(preq);
 }
 
+/**
+ * @brief
+ *		Set or unset a list of attributes on one vnode
+ *
+ * 		On success the vnode is checked for grouping warnings, marked job-busy
+ * 		if it has no free subnodes left and the change is logged.
+ *
+ * @param[in] preq - the batch request, for the permissions
+ * @param[in] pnode - the vnode
+ * @param[in] plist - the attributes
+ * @param[in] unset - non-zero to unset the attributes, zero to set them
+ * @param[out] bad - index of the attribute in error
+ * @param[in,out] warn_nodes - vnodes with grouping warnings
+ * @param[in,out] warn_idx - number of entries in warn_nodes
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	PBS error	- error
+ *
+ * @par MT-safe: No
+ */
+
+static int
+mgr_node_set_list(struct batch_request *preq, struct pbsnode *pnode, svrattrl *plist, int unset,
+		int *bad, struct pbsnode **warn_nodes, int *warn_idx)
+{
+	int rc;
+
+	if (unset)
+		rc = mgr_unset_attr(pnode->nd_attr, node_attr_idx, node_attr_def, ND_ATR_LAST, plist,
+				preq->rq_perm, bad, (void *)pnode, PARENT_TYPE_NODE, INDIRECT_RES_CHECK);
+	else
+		rc = mgr_set_attr(pnode->nd_attr, node_attr_idx, node_attr_def, ND_ATR_LAST, plist,
+			preq->rq_perm | ATR_PERM_ALLOW_INDIRECT, bad, (void *)pnode, ATR_ACTION_ALTER);
+	if (rc != 0)
+		return rc;
+
+	warnings_update(WARN_ngrp, warn_nodes, warn_idx, pnode);
+
+	if ((pnode->nd_nsnfree == 0) && (pnode->nd_state == 0))
+		set_vnode_state(pnode, INUSE_JOB, Nd_State_Or);
+
+	mgr_log_attr(msg_man_set, plist, PBS_EVENTCLASS_NODE, pnode->nd_name, NULL);
+	return 0;
+}
+
+/**
+ * @brief
+ *		Reply to a request to alter one vnode which failed
+ *
+ * @param[in] preq - the batch request
+ * @param[in] pnode - the vnode
+ * @param[in] rc - error returned by mgr_node_set_list()
+ * @param[in] bad - index of the attribute in error
+ * @param[in] plist - the attributes which were being set
+ *
+ * @par MT-safe: No
+ */
+
+static void
+mgr_node_set_reject(struct batch_request *preq, struct pbsnode *pnode, int rc, int bad, svrattrl *plist)
+{
+	extern char *msg_queue_not_in_partition;
+	extern char *msg_partition_not_in_queue;
+
+	switch (rc) {
+		case PBSE_INTERNAL:
+		case PBSE_SYSTEM:
+			req_reject(rc, bad, preq);
+			break;
+
+		case PBSE_NOATTR:
+		case PBSE_ATTRRO:
+		case PBSE_MUTUALEX:
+		case PBSE_BADNDATVAL:
+		case PBSE_UNKRESC:
+			reply_badattr(rc, bad, plist, preq);
+			break;
+		case PBSE_QUE_NOT_IN_PARTITION:
+			(void)snprintf(log_buffer, LOG_BUF_SIZE, msg_queue_not_in_partition,
+				pnode->nd_attr[ND_ATR_Queue].at_val.at_str);
+			log_err(-1, __func__, log_buffer);
+			reply_text(preq, PBSE_QUE_NOT_IN_PARTITION, log_buffer);
+			break;
+		case PBSE_PARTITION_NOT_IN_QUE:
+			(void)snprintf(log_buffer, LOG_BUF_SIZE, msg_partition_not_in_queue,
+				pnode->nd_attr[ND_ATR_partition].at_val.at_str);
+			log_err(-1, __func__, log_buffer);
+			reply_text(preq, PBSE_PARTITION_NOT_IN_QUE, log_buffer);
+			break;
+
+		default:
+			req_reject(rc, 0, preq);
+	}
+}
+
 /**
  * @brief
  *		Set vnode attributes
@@ -1939,8 +2038,6 @@ mgr_queue_unset(struct batch_request *preq)
 static void
 mgr_node_set(struct batch_request *preq)
 {
-	extern char *msg_queue_not_in_partition;
-	extern char *msg_partition_not_in_queue;
 	int bad = 0;
 	char hostname[PBS_MAXHOSTNAME + 1];
 	int numnodes = 1; /* number of vnodes to be operated on */
@@ -2062,16 +2159,11 @@ mgr_node_set(struct batch_request *preq)
 	while (pnode) {
 		if ((pnode->nd_state & INUSE_DELETED) == 0) {
 			for (j = 0; j < 2; j++) {
-				rc = 0;
-				if (j == 0) {
+				if (j == 0)
 					plist = (svrattrl *)GET_NEXT(unsetlist);
-					rc = mgr_unset_attr(pnode->nd_attr, node_attr_idx, node_attr_def, ND_ATR_LAST, plist,
-							preq->rq_perm, &bad, (void *)pnode, PARENT_TYPE_NODE, INDIRECT_RES_CHECK);
-				} else {
+				else
 					plist = (svrattrl *)GET_NEXT(setlist);
-					rc = mgr_set_attr(pnode->nd_attr, node_attr_idx, node_attr_def, ND_ATR_LAST, plist,
-						preq->rq_perm | ATR_PERM_ALLOW_INDIRECT, &bad, (void *)pnode, ATR_ACTION_ALTER);
-				}
+				rc = mgr_node_set_list(preq, pnode, plist, j == 0, &bad, warn_nodes, &warn_idx);
 				if (rc != 0) {
 					if (numnodes > 1) {
 						if (problem_nodes) {
@@ -2083,47 +2175,12 @@ mgr_node_set(struct batch_request *preq)
 							}
 						}
 					} else {/*In the specific node case, reply w/ error and return*/
-						switch (rc) {
-							case PBSE_INTERNAL:
-							case PBSE_SYSTEM:
-								req_reject(rc, bad, preq);
-								break;
-
-							case PBSE_NOATTR:
-							case PBSE_ATTRRO:
-							case PBSE_MUTUALEX:
-							case PBSE_BADNDATVAL:
-							case PBSE_UNKRESC:
-								reply_badattr(rc, bad, plist, preq);
-								break;
-							case PBSE_QUE_NOT_IN_PARTITION:
-								(void)snprintf(log_buffer, LOG_BUF_SIZE, msg_queue_not_in_partition,
-									pnode->nd_attr[ND_ATR_Queue].at_val.at_str);
-								log_err(-1, __func__, log_buffer);
-								reply_text(preq, PBSE_QUE_NOT_IN_PARTITION, log_buffer);
-								break;
-							case PBSE_PARTITION_NOT_IN_QUE:
-								(void)snprintf(log_buffer, LOG_BUF_SIZE, msg_partition_not_in_queue,
-									pnode->nd_attr[ND_ATR_partition].at_val.at_str);
-								log_err(-1, __func__, log_buffer);
-								reply_text(preq, PBSE_PARTITION_NOT_IN_QUE, log_buffer);
-								break;
-
-							default:
-								req_reject(rc, 0, preq);
-						}
+						mgr_node_set_reject(preq, pnode, rc, bad, plist);
 						free(warn_nodes);
 						free_attrlist(&unsetlist);
 						free_attrlist(&setlist);
 						return;
 					}
-				} else {/*modifications succeed for this node*/
-					warnings_update(WARN_ngrp, warn_nodes, &warn_idx, pnode);
-
-					if ((pnode->nd_nsnfree == 0) && (pnode->nd_state == 0))
-						set_vnode_state(pnode, INUSE_JOB, Nd_State_Or);
-
-					mgr_log_attr(msg_man_set, plist, PBS_EVENTCLASS_NODE, pnode->nd_name, NULL);
 				}
 			}
 		}
@@ -2525,6 +2582,581 @@ mgr_node_unset(struct batch_request *preq)
 	free(warn_nodes);
 }
 
+/* longest error text listing the vnodes a Modify Nodes request failed on */
+#define MODIFYNODES_MSG_MAX	4096
+
+/* one criterion of a request to alter many vnodes */
+struct node_sel {
+	int		ns_index;	/* index into node_attr_def */
+	enum batch_op	ns_op;
+	attribute	ns_attr;	/* decoded value, unless state */
+	char		*ns_state;	/* states to look for, if state */
+};
+
+/**
+ * @brief
+ *		Free the criteria built by build_node_sel()
+ *
+ * @param[in] psel - the criteria
+ * @param[in] nsel - number of criteria
+ */
+
+static void
+free_node_sel(struct node_sel *psel, int nsel)
+{
+	int i;
+
+	for (i = 0; i < nsel; i++) {
+		if (psel[i].ns_state == NULL)
+			node_attr_def[psel[i].ns_index].at_free(&psel[i].ns_attr);
+	}
+	free(psel);
+}
+
+/**
+ * @brief
+ *		Decode the criteria vnodes must match to be altered by a Modify Nodes
+ *		request
+ *
+ * 		The state is matched by name: with EQ the vnode must be in all of the
+ * 		comma separated states, with NE in not all of them.  Other attributes
+ * 		and resources are compared as qselect compares job attributes.
+ *
+ * @param[in] plist - the criteria as sent
+ * @param[out] ppsel - the decoded criteria
+ * @param[out] pnsel - number of criteria
+ * @param[out] bad - index of the criterion in error
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	PBS error	- error
+ */
+
+static int
+build_node_sel(svrattrl *plist, struct node_sel **ppsel, int *pnsel, int *bad)
+{
+	struct node_sel *psel;
+	svrattrl *pal;
+	int nsel = 0;
+	int idx;
+	int rc;
+
+	*ppsel = NULL;
+	*pnsel = 0;
+	for (pal = plist; pal; pal = (svrattrl *)GET_NEXT(pal->al_link))
+		nsel++;
+	if (nsel == 0)
+		return 0;
+	if ((psel = calloc(nsel, sizeof(struct node_sel))) == NULL)
+		return PBSE_SYSTEM;
+
+	nsel = 0;
+	for (pal = plist; pal; pal = (svrattrl *)GET_NEXT(pal->al_link)) {
+		*bad = nsel + 1;
+		idx = find_attr(node_attr_idx, node_attr_def, pal->al_name);
+		if (idx < 0) {
+			free_node_sel(psel, nsel);
+			return PBSE_NOATTR;
+		}
+		if ((node_attr_def[idx].at_flags & resc_access_perm & ATR_DFLAG_RDACC) == 0) {
+			free_node_sel(psel, nsel);
+			return PBSE_PERM;
+		}
+		psel[nsel].ns_index = idx;
+		psel[nsel].ns_op = pal->al_op;
+		if (idx == ND_ATR_state) {
+			if (pal->al_op != EQ && pal->al_op != NE) {
+				free_node_sel(psel, nsel);
+				return PBSE_IVALREQ;
+			}
+			psel[nsel++].ns_state = pal->al_value;
+			continue;
+		}
+		clear_attr(&psel[nsel].ns_attr, &node_attr_def[idx]);
+		rc = node_attr_def[idx].at_decode(&psel[nsel].ns_attr, pal->al_name,
+			pal->al_resc, pal->al_value);
+		if (rc != 0) {
+			node_attr_def[idx].at_free(&psel[nsel].ns_attr);
+			free_node_sel(psel, nsel);
+			return rc;
+		}
+		nsel++;
+	}
+	*ppsel = psel;
+	*pnsel = nsel;
+	return 0;
+}
+
+/**
+ * @brief
+ *		Check whether a vnode is in every one of a list of states
+ *
+ * @param[in] pnode - the vnode
+ * @param[in] states - comma separated state names
+ *
+ * @return	int
+ * @retval	1	- it is
+ * @retval	0	- it is not
+ */
+
+static int
+node_in_states(struct pbsnode *pnode, char *states)
+{
+	attribute state;
+	svrattrl *pal = NULL;
+	char *want;
+	char *have;
+	char *p;
+	size_t len;
+	int found = 1;
+
+	clear_attr(&state, &node_attr_def[(int)ND_ATR_state]);
+	state.at_val.at_long = pnode->nd_state;
+	state.at_flags = ATR_VFLAG_SET;
+	if (encode_state(&state, NULL, ATTR_NODE_state, NULL, ATR_ENCODE_CLIENT, &pal) < 0 || pal == NULL)
+		return 0;
+
+	for (want = states; found && *want; want += len) {
+		while (*want == ',' || isspace((int)*want))
+			want++;
+		len = strcspn(want, ", \t");
+		if (len == 0)
+			break;
+		found = 0;
+		for (have = pal->al_value; *have; have = p) {
+			p = have + strcspn(have, ",");
+			if ((size_t)(p - have) == len && strncmp(have, want, len) == 0) {
+				found = 1;
+				break;
+			}
+			if (*p == ',')
+				p++;
+		}
+	}
+	free(pal);
+	return found;
+}
+
+/**
+ * @brief
+ *		Check whether a vnode matches all of the criteria of a Modify Nodes
+ *		request
+ *
+ * @param[in] pnode - the vnode
+ * @param[in] psel - the criteria
+ * @param[in] nsel - number of criteria
+ *
+ * @return	int
+ * @retval	1	- it matches
+ * @retval	0	- it does not
+ */
+
+static int
+node_sel_match(struct pbsnode *pnode, struct node_sel *psel, int nsel)
+{
+	attribute *pattr;
+	resource *rescsel;
+	resource *rescnd;
+	int i;
+	int rc;
+
+	for (i = 0; i < nsel; i++) {
+		if (psel[i].ns_state != NULL) {
+			rc = node_in_states(pnode, psel[i].ns_state);
+			if ((psel[i].ns_op == EQ) != (rc == 1))
+				return 0;
+			continue;
+		}
+
+		pattr = &pnode->nd_attr[psel[i].ns_index];
+		if (psel[i].ns_attr.at_type == ATR_TYPE_RESC) {
+			rescsel = (resource *)GET_NEXT(psel[i].ns_attr.at_val.at_list);
+			if (rescsel == NULL)
+				return 0;
+			rescnd = find_resc_entry(pattr, rescsel->rs_defin);
+			if (rescnd && is_attr_set(&rescnd->rs_value))
+				rc = rescsel->rs_defin->rs_comp(&rescnd->rs_value, &rescsel->rs_value);
+			else
+				rc = -1;
+		} else if (is_attr_set(pattr))
+			rc = node_attr_def[psel[i].ns_index].at_comp(pattr, &psel[i].ns_attr);
+		else
+			rc = -1;
+
+		switch (psel[i].ns_op) {
+			case EQ:
+				if (rc != 0)
+					return 0;
+				break;
+			case NE:
+				if (rc == 0)
+					return 0;
+				break;
+			case LT:
+				if (rc >= 0)
+					return 0;
+				break;
+			case LE:
+				if (rc > 0)
+					return 0;
+				break;
+			case GT:
+				if (rc <= 0)
+					return 0;
+				break;
+			case GE:
+				if (rc < 0)
+					return 0;
+				break;
+			default:
+				return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief
+ *		Add the vnodes of a host to the vnodes to alter
+ *
+ * 		When a host is marked offline, vnodes also reported by another Mom
+ * 		which is up are left alone, as mgr_node_set() does.
+ *
+ * @param[in] hostname - the host
+ * @param[in] offline - the request marks vnodes offline
+ * @param[in,out] vnodes - vnodes to alter
+ * @param[in,out] nvnodes - number of entries in vnodes
+ * @param[in,out] seen - flags of vnodes already in vnodes, by nd_arr_index
+ *
+ * @return	int
+ * @retval	0	- success
+ * @retval	PBSE_UNKNODE	- no such host
+ */
+
+static int
+add_host_vnodes(char *hostname, int offline, struct pbsnode **vnodes, int *nvnodes, char *seen)
+{
+	char fullname[PBS_MAXHOSTNAME + 1];
+	mominfo_t *pmom;
+	mom_svrinfo_t *psvrmom;
+	struct pbsnode *pnode;
+	int momidx;
+	int imom;
+	unsigned long mstate;
+
+	if (get_fullhostname(hostname, fullname, (sizeof(fullname) - 1)) != 0)
+		return PBSE_UNKNODE;
+	if ((pmom = find_mom_entry(fullname, pbs_mom_port)) == NULL)
+		return PBSE_UNKNODE;
+
+	psvrmom = (mom_svrinfo_t *)pmom->mi_data;
+	for (momidx = 0; momidx < psvrmom->msr_numvnds; momidx++) {
+		pnode = psvrmom->msr_children[momidx];
+		if (momidx > 0 && offline && pnode->nd_nummoms > 1) {
+			for (imom = 0; imom < pnode->nd_nummoms; ++imom) {
+				mstate = ((mom_svrinfo_t *)(pnode->nd_moms[imom]->mi_data))->msr_state;
+				if ((mstate & (INUSE_DOWN | INUSE_OFFLINE)) == 0)
+					return 0;
+			}
+		}
+		if (!seen[pnode->nd_arr_index]) {
+			seen[pnode->nd_arr_index] = 1;
+			vnodes[(*nvnodes)++] = pnode;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *		modifynodes_hooks - run the management hooks for the change of one
+ *		vnode by a Modify Nodes request, as if the vnode had been altered
+ *		by a Manager request of its own
+ *
+ * @param[in] preq - the Modify Nodes request
+ * @param[in] pnode - the vnode altered
+ * @param[in] cmd - MGR_CMD_SET or MGR_CMD_UNSET
+ * @param[in] plist - the attributes set or unset
+ * @param[in] rc - outcome of the change, seen by the hooks as the reply code
+ *
+ * @par MT-safe: No
+ */
+static void
+modifynodes_hooks(struct batch_request *preq, struct pbsnode *pnode, int cmd,
+	pbs_list_head *plist, int rc)
+{
+	struct batch_request *hreq;
+	struct rq_manage *pmgr;
+	char hook_msg[HOOK_MSG_SIZE];
+
+	if ((hreq = alloc_br(PBS_BATCH_Manager)) == NULL)
+		return;
+
+	pmgr = &hreq->rq_ind.rq_management.rq_manager;
+	CLEAR_HEAD(pmgr->rq_attr);
+	pmgr->rq_cmd = cmd;
+	pmgr->rq_objtype = MGR_OBJ_NODE;
+	snprintf(pmgr->rq_objname, sizeof(pmgr->rq_objname), "%s", pnode->nd_name);
+	if (copy_svrattrl_list(plist, &pmgr->rq_attr) == -1) {
+		log_err(ENOMEM, __func__, "out of memory");
+		free_br(hreq);
+		return;
+	}
+	strcpy(hreq->rq_user, preq->rq_user);
+	strcpy(hreq->rq_host, preq->rq_host);
+	hreq->rq_perm = preq->rq_perm;
+	hreq->rq_time = preq->rq_time;
+	hreq->rq_reply.brp_code = rc;
+
+	process_hooks(hreq, hook_msg, sizeof(hook_msg), pbs_python_set_interrupt);
+	free_br(hreq);
+}
+
+/**
+ * @brief
+ *		req_modifynodes - service the Modify Nodes Request
+ *
+ * 		Sets and unsets the same attributes on many vnodes in one request:
+ * 		the vnodes named, the vnodes of the hosts named, or all vnodes, of
+ * 		which only those matching the criteria are altered.  The vnodes are
+ * 		written to the database once for the whole request.
+ *
+ * 		If a management hook is enabled, the management hooks are run for
+ * 		each vnode altered, once for the attributes unset and once for
+ * 		those set, as for the Manager requests pbsnodes used to send.
+ *
+ * @param[in] preq - Pointer to a batch request structure
+ *
+ * @par MT-safe: No
+ */
+
+void
+req_modifynodes(struct batch_request *preq)
+{
+	struct rq_modifynodes *prq = &preq->rq_ind.rq_modifynodes;
+	struct node_sel *psel = NULL;
+	int nsel = 0;
+	struct pbsnode **vnodes = NULL;
+	struct pbsnode **warn_nodes = NULL;
+	struct pbsnode *pnode;
+	char *seen = NULL;
+	char *names = NULL;
+	char *name;
+	char *saveptr = NULL;
+	char *unknown = NULL;
+	char *problems = NULL;
+	int unknown_sz = 0;
+	int problems_sz = 0;
+	char *warnmsg;
+	svrattrl *plist;
+	svrattrl *tmp;
+	pbs_list_head unsetlist;
+	pbs_list_head setlist;
+	int nvnodes = 0;
+	int nmatch = 0;
+	int offline = 0;
+	int run_hooks = 0;
+	hook *phook;
+	int problem_cnt = 0;
+	int warn_idx = 0;
+	int bad = 0;
+	int rc = 0;
+	int i, j;
+
+	if ((preq->rq_perm & PERM_OPorMGR) == 0) {
+		req_reject(PBSE_PERM, 0, preq);
+		return;
+	}
+	if (prq->rq_objtype != MGR_OBJ_NODE && prq->rq_objtype != MGR_OBJ_HOST) {
+		req_reject(PBSE_IVALREQ, 0, preq);
+		return;
+	}
+	if (pbsndlist == NULL || svr_totnodes <= 0) {
+		req_reject(PBSE_UNKNODE, 0, preq);
+		return;
+	}
+
+	resc_access_perm = preq->rq_perm;
+	rc = build_node_sel((svrattrl *)GET_NEXT(prq->rq_selattr), &psel, &nsel, &bad);
+	if (rc != 0) {
+		reply_badattr(rc, bad, (svrattrl *)GET_NEXT(prq->rq_selattr), preq);
+		return;
+	}
+
+	for (plist = (svrattrl *)GET_NEXT(prq->rq_attr); plist;
+		plist = (svrattrl *)GET_NEXT(plist->al_link)) {
+		if (strcmp(plist->al_name, ATTR_NODE_state) == 0 && plist->al_op == INCR)
+			offline = 1;
+	}
+
+	vnodes = malloc(svr_totnodes * sizeof(struct pbsnode *));
+	seen = calloc(svr_totnodes, 1);
+	if (vnodes == NULL || seen == NULL) {
+		rc = PBSE_SYSTEM;
+		goto modifynodes_exit;
+	}
+
+	/* the vnodes named, the vnodes of the hosts named, or all */
+	if (prq->rq_nodes == NULL || prq->rq_nodes[0] == '\0') {
+		for (i = 0; i < svr_totnodes; i++) {
+			if ((pbsndlist[i]->nd_state & INUSE_DELETED) == 0)
+				vnodes[nvnodes++] = pbsndlist[i];
+		}
+	} else {
+		if ((names = strdup(prq->rq_nodes)) == NULL) {
+			rc = PBSE_SYSTEM;
+			goto modifynodes_exit;
+		}
+		for (name = strtok_r(names, ",", &saveptr); name; name = strtok_r(NULL, ",", &saveptr)) {
+			while (isspace((int)*name))
+				name++;
+			if (*name == '\0')
+				continue;
+			if (prq->rq_objtype == MGR_OBJ_HOST)
+				rc = add_host_vnodes(name, offline, vnodes, &nvnodes, seen);
+			else if ((pnode = find_nodebyname(name)) == NULL ||
+				(pnode->nd_state & INUSE_DELETED))
+				rc = PBSE_UNKNODE;
+			else {
+				rc = 0;
+				if (!seen[pnode->nd_arr_index]) {
+					seen[pnode->nd_arr_index] = 1;
+					vnodes[nvnodes++] = pnode;
+				}
+			}
+			if (rc != 0) {
+				if (pbs_strcat(&unknown, &unknown_sz, unknown ? ", " : "") == NULL ||
+					pbs_strcat(&unknown, &unknown_sz, name) == NULL) {
+					rc = PBSE_SYSTEM;
+					goto modifynodes_exit;
+				}
+				problem_cnt++;
+			}
+		}
+		rc = 0;
+		if (nvnodes == 0) {
+			rc = PBSE_UNKNODE;
+			goto modifynodes_exit;
+		}
+	}
+
+	for (phook = (hook *)GET_NEXT(svr_management_hooks); phook;
+		phook = (hook *)GET_NEXT(phook->hi_management_hooks)) {
+		if (phook->enabled) {
+			run_hooks = 1;
+			break;
+		}
+	}
+
+	/* keep those matching the criteria */
+	for (i = 0; i < nvnodes; i++) {
+		if (node_sel_match(vnodes[i], psel, nsel))
+			vnodes[nmatch++] = vnodes[i];
+	}
+
+	CLEAR_HEAD(setlist);
+	CLEAR_HEAD(unsetlist);
+	plist = (svrattrl *)GET_NEXT(prq->rq_attr);
+	while (plist) {
+		tmp = (struct svrattrl *)GET_NEXT(plist->al_link);
+
+		delete_link(&plist->al_link);
+		if (plist->al_atopl.value == NULL || plist->al_atopl.value[0] == '\0')
+			append_link(&unsetlist, &plist->al_link, plist);
+		else
+			append_link(&setlist, &plist->al_link, plist);
+
+		plist = tmp;
+	}
+
+	log_eventf(PBSEVENT_ADMIN, PBS_EVENTCLASS_NODE, LOG_INFO,
+		(prq->rq_nodes && prq->rq_nodes[0]) ? prq->rq_nodes : all_nodes,
+		msg_manager, msg_man_set, preq->rq_user, preq->rq_host);
+
+	if (nmatch > 0 && (warn_nodes = malloc(nmatch * sizeof(struct pbsnode *))) == NULL) {
+		free_attrlist(&unsetlist);
+		free_attrlist(&setlist);
+		rc = PBSE_SYSTEM;
+		goto modifynodes_exit;
+	}
+	if (nmatch > 0)
+		warnings_update(WARN_ngrp_init, warn_nodes, &warn_idx, vnodes[0]);
+
+	for (i = 0; i < nmatch; i++) {
+		pnode = vnodes[i];
+		for (j = 0; j < 2; j++) {
+			if (j == 0)
+				plist = (svrattrl *)GET_NEXT(unsetlist);
+			else
+				plist = (svrattrl *)GET_NEXT(setlist);
+			if (plist == NULL)
+				continue;
+			rc = mgr_node_set_list(preq, pnode, plist, j == 0, &bad, warn_nodes, &warn_idx);
+			if (run_hooks)
+				modifynodes_hooks(preq, pnode, (j == 0) ? MGR_CMD_UNSET : MGR_CMD_SET,
+					(j == 0) ? &unsetlist : &setlist, rc);
+			if (rc == 0)
+				continue;
+			if (nmatch == 1 && problem_cnt == 0) {
+				/* just the one vnode, reply as for a Manager request */
+				save_nodes_db(0, NULL);
+				mgr_node_set_reject(preq, pnode, rc, bad, plist);
+				free_attrlist(&unsetlist);
+				free_attrlist(&setlist);
+				rc = 0;
+				goto modifynodes_done;
+			}
+			if (pbs_strcat(&problems, &problems_sz, problems ? ", " : "") == NULL ||
+				pbs_strcat(&problems, &problems_sz, pnode->nd_name) == NULL) {
+				log_err(ENOMEM, __func__, "out of memory");
+			}
+			problem_cnt++;
+			break;
+		}
+	}
+	rc = 0;
+
+	free_attrlist(&unsetlist);
+	free_attrlist(&setlist);
+
+	save_nodes_db(0, NULL);
+
+	warnmsg = warn_msg_build(WARN_ngrp, warn_nodes, warn_idx);
+
+	if (problem_cnt) {
+		char *msg = NULL;
+		int msg_sz = 0;
+
+		if (pbs_strcat(&msg, &msg_sz, pbse_to_txt(PBSE_GMODERR)) != NULL &&
+			(unknown == NULL || pbs_strcat(&msg, &msg_sz, unknown) != NULL) &&
+			(unknown == NULL || problems == NULL || pbs_strcat(&msg, &msg_sz, ", ") != NULL) &&
+			(problems == NULL || pbs_strcat(&msg, &msg_sz, problems) != NULL) &&
+			(warnmsg == NULL || pbs_strcat(&msg, &msg_sz, warnmsg) != NULL)) {
+			if (strlen(msg) >= MODIFYNODES_MSG_MAX)
+				strcpy(msg + MODIFYNODES_MSG_MAX - 4, "...");
+			(void)reply_text(preq, PBSE_GMODERR, msg);
+		} else
+			(void)reply_text(preq, PBSE_GMODERR, pbse_to_txt(PBSE_GMODERR));
+		free(msg);
+	} else if (warnmsg)
+		(void)reply_text(preq, PBSE_NONE, warnmsg);
+	else
+		reply_ack(preq);
+	free(warnmsg);
+
+modifynodes_done:
+	free(warn_nodes);
+modifynodes_exit:
+	if (rc != 0)
+		req_reject(rc, 0, preq);
+	free_node_sel(psel, nsel);
+	free(vnodes);
+	free(seen);
+	free(names);
+	free(unknown);
+	free(problems);
+}
+
 /**
  * @brief
  * 		make_host_addresses_list - return a null terminated list of all of the
@@ -2631,7 +3263,7 @@ make_host_addresses_list(char *phost, u_long **pul)
 	memmove(tpul->pul, *pul, tpul->len);
 
 	if (hostaddr_idx == NULL) {
-		if ((hostaddr_idx = pbs_idx_create(0, 0)) == NULL) {
+		if ((hostaddr_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 			free(tpul->pul);
 			free(tpul);
 			strcat(log_buffer, "out of  memory");
@@ -2785,7 +3417,7 @@ create_pbs_node2(char *objname, svrattrl *plist, int perms, int *bad, struct pbs
 
 		/* create node index if not already done */
 		if (node_idx == NULL) {
-			if ((node_idx = pbs_idx_create(0, 0)) == NULL) {
+			if ((node_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 				svr_totnodes--;
 				free_pnode(pnode);
 				free(pname);
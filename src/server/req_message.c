@@ -234,7 +234,7 @@ req_py_spawn(struct batch_request *preq)
 			req_reject(PBSE_BADSTATE, 0, preq);
 			return;
 		}
-		if ((pjob = pjob->ji_ajtrk->tkm_tbl[offset].trk_psubjob) == NULL) {
+		if ((pjob = get_subjob_ptr(pjob, offset)) == NULL) {
 			req_reject(PBSE_UNKJOBID, 0, preq);
 			return;
 		}
@@ -325,7 +325,7 @@ req_relnodesjob(struct batch_request *preq)
 			req_reject(PBSE_BADSTATE, 0, preq);
 			return;
 		}
-		if ((pjob = pjob->ji_ajtrk->tkm_tbl[offset].trk_psubjob) == NULL) {
+		if ((pjob = get_subjob_ptr(pjob, offset)) == NULL) {
 			req_reject(PBSE_UNKJOBID, 0, preq);
 			return;
 		}
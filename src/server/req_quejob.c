@@ -161,6 +161,7 @@ static	void	handle_qmgr_reply_to_resvQcreate(struct work_task *);
 static	int	get_queue_for_reservation(resc_resv *);
 static	int	ignore_attr(char *);
 static	int	validate_place_req_of_job_in_reservation(job *pj);
+static	int	append_job_script(job *, char *, long);
 
 /* To generate the job/resv id's locally */
 void reset_svr_sequence_window(void);
@@ -1092,6 +1093,27 @@ req_quejob(struct batch_request *preq)
 	if ((is_jattr_set(pj, JOB_ATR_block)) == 0)
 		implicit_commit = ((preq->rq_extend) && (strstr(preq->rq_extend, EXTEND_OPT_IMPLICIT_COMMIT)));
 
+#ifndef PBS_MOM
+	/* a job of a Submit Job List comes with its script and is committed now */
+	if (preq->rq_parentbr && (preq->rq_parentbr->rq_type == PBS_BATCH_SubmitJobList)) {
+		if (is_jattr_set(pj, JOB_ATR_block)) {
+			job_purge(pj);
+			req_reject(PBSE_IVALREQ, 0, preq);
+			return;
+		}
+		if (preq->rq_ind.rq_queuejob.rq_script != NULL) {
+			rc = append_job_script(pj, preq->rq_ind.rq_queuejob.rq_script,
+				(long) preq->rq_ind.rq_queuejob.rq_scriptsz);
+			if (rc != PBSE_NONE) {
+				job_purge(pj);
+				req_reject(rc, 0, preq);
+				return;
+			}
+		}
+		implicit_commit = 1;
+	}
+#endif
+
 	/* acknowledge the request with the job id */
 	if (!implicit_commit) {
 		if (preq->prot == PROT_TCP) {
@@ -1234,6 +1256,43 @@ req_jobcredential(struct batch_request *preq)
 	return;
 }
 
+#ifndef PBS_MOM
+/**
+ * @brief
+ *		Append a piece of job script to the script held with a new job,
+ *		to be saved to the DB when the job is committed.
+ *
+ * @param[in,out]	pj	-	the new job
+ * @param[in]	data	-	script text
+ * @param[in]	size	-	length of data
+ *
+ * @return	int
+ * @retval	PBSE_NONE	-	success
+ * @retval	PBSE_JOBSCRIPTMAXSIZE	-	piece larger than jobscript_max_size
+ * @retval	PBSE_SYSTEM	-	out of memory
+ */
+static int
+append_job_script(job *pj, char *data, long size)
+{
+	char *temp;
+
+	if ((u_Long) size > get_bytes_from_attr(&attr_jobscript_max_size))
+		return PBSE_JOBSCRIPTMAXSIZE;
+
+	temp = realloc(pj->ji_script, pj->ji_qs.ji_un.ji_newt.ji_scriptsz + size + 1);
+	if (!temp)
+		return PBSE_SYSTEM;
+	pj->ji_script = temp;
+	memmove(pj->ji_script + pj->ji_qs.ji_un.ji_newt.ji_scriptsz, data, (size_t) size);
+	pj->ji_qs.ji_un.ji_newt.ji_scriptsz += size;
+	pj->ji_script[pj->ji_qs.ji_un.ji_newt.ji_scriptsz] = '\0';
+
+	pj->ji_qs.ji_svrflags = (pj->ji_qs.ji_svrflags & ~JOB_SVFLG_CHKPT) |
+		JOB_SVFLG_SCRIPT;      /* has a script file */
+	return PBSE_NONE;
+}
+#endif
+
 /**
  * @brief
  *		Receive job script section
@@ -1254,8 +1313,7 @@ req_jobscript(struct batch_request *preq)
 	int	 fds;
 	char namebuf[MAXPATHLEN];
 #else
-	char *temp;
-	u_Long size;
+	int	rc;
 #endif
 
 	pj = locate_new_job(preq, NULL);
@@ -1344,35 +1402,20 @@ req_jobscript(struct batch_request *preq)
 		return;
 	}
 	(void)close(fds);
+	pj->ji_qs.ji_un.ji_newt.ji_scriptsz += preq->rq_ind.rq_jobfile.rq_size;
+	pj->ji_qs.ji_svrflags = (pj->ji_qs.ji_svrflags & ~JOB_SVFLG_CHKPT) |
+		JOB_SVFLG_SCRIPT;      /* has a script file */
 #else /* server - server - server - server */
 	/* add the script to the job */
-	size = get_bytes_from_attr(&attr_jobscript_max_size);
-	if (preq->rq_ind.rq_jobfile.rq_size > size){
-		job_purge(pj);
-		req_reject(PBSE_JOBSCRIPTMAXSIZE, 0, preq);
-		return;
-	}
-	temp = realloc(pj->ji_script, pj->ji_qs.ji_un.ji_newt.ji_scriptsz +
-		preq->rq_ind.rq_jobfile.rq_size + 1);
-	if (!temp) {
+	rc = append_job_script(pj, preq->rq_ind.rq_jobfile.rq_data,
+		preq->rq_ind.rq_jobfile.rq_size);
+	if (rc != PBSE_NONE) {
 		job_purge(pj);
-		req_reject(PBSE_SYSTEM, 0, preq);
+		req_reject(rc, 0, preq);
 		return;
 	}
-	pj->ji_script = temp;
-	memmove(pj->ji_script + pj->ji_qs.ji_un.ji_newt.ji_scriptsz,
-		preq->rq_ind.rq_jobfile.rq_data,
-		(size_t)preq->rq_ind.rq_jobfile.rq_size);
-#endif
-	pj->ji_qs.ji_un.ji_newt.ji_scriptsz += preq->rq_ind.rq_jobfile.rq_size;
-
-#ifndef PBS_MOM
-	pj->ji_script[pj->ji_qs.ji_un.ji_newt.ji_scriptsz] = '\0';
 #endif
 
-	pj->ji_qs.ji_svrflags = (pj->ji_qs.ji_svrflags & ~JOB_SVFLG_CHKPT) |
-		JOB_SVFLG_SCRIPT;      /* has a script file */
-
 	reply_ack(preq);
 }
 
@@ -1734,6 +1777,7 @@ req_commit_now(struct batch_request *preq,  job *pj)
 		obj.pbs_db_obj_type = PBS_DB_JOBSCR;
 		obj.pbs_db_un.pbs_db_jobscr = &jobscr;
 
+		db_writer_barrier();
 		if (pbs_db_save_obj(conn, &obj, OBJ_SAVE_NEW) != 0) {
 			job_purge(pj);
 			req_reject(PBSE_SYSTEM, 0, preq);
@@ -1749,12 +1793,13 @@ req_commit_now(struct batch_request *preq,  job *pj)
 	/*
 	 * if the job went into a Route (push) queue that has been started,
 	 * try once to route it to give immediate feedback as a courtsey
-	 * to the user.
+	 * to the user.  Jobs of a Submit Job List are routed by
+	 * req_quejoblist() once the whole list is in the DB.
 	 */
 
 	pque = pj->ji_qhdr;
 
-	if ((preq->rq_fromsvr == 0) &&
+	if ((preq->rq_fromsvr == 0) && (preq->rq_parentbr == NULL) &&
 		(pque->qu_qs.qu_type == QTYPE_RoutePush) &&
 		(pque->qu_attr[(int)QA_ATR_Started].at_val.at_long != 0)) {
 		if ((rc = job_route(pj)) != 0) {
@@ -1807,6 +1852,132 @@ req_commit(struct batch_request *preq)
 	req_commit_now(preq, pj);
 }
 
+#ifndef PBS_MOM
+/**
+ * @brief
+ *		Queue and commit the jobs of a Submit Job List request.
+ *
+ * @par Functionality:
+ *		Each job goes through req_quejob() as a child Queue Job request
+ *		carrying its script, and is committed right away.  The child's
+ *		reply is kept in the status set aside for the job (see reply_send).
+ *		The DB writes of the whole list go in one transaction; if it does
+ *		not commit, the jobs that were queued are purged and report
+ *		PBSE_SAVE_ERR.  Jobs that went into a started routing queue are
+ *		routed once the list is committed.
+ *
+ * @param[in]	preq	-	the Submit Job List request
+ */
+void
+req_quejoblist(struct batch_request *preq)
+{
+	struct rq_quejoblist *pql = &preq->rq_ind.rq_quejoblist;
+	struct rq_quejoblist_job *pqj;
+	struct batch_request *pchild;
+	struct batch_submit_status *psub;
+	struct batch_submit_status **psubx;
+	conn_t *conn;
+	pbs_queue *pque;
+	job *pj;
+	int in_trx;
+	int rc;
+	int i;
+
+	conn = get_conn(preq->rq_conn);
+	if (!conn) {
+		req_reject(PBSE_SYSTEM, 0, preq);
+		return;
+	}
+	if (conn->cn_authen & PBS_NET_CONN_FORCE_QSUB_UPDATE) {
+		req_reject(PBSE_FORCE_QSUB_UPDATE, 0, preq);
+		conn->cn_authen &= ~PBS_NET_CONN_FORCE_QSUB_UPDATE;
+		return;
+	}
+
+	/* set aside a status for each job, in the order of the request */
+	preq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_SubmitList;
+	preq->rq_reply.brp_un.brp_substatc = NULL;
+	preq->rq_reply.brp_count = pql->rq_count;
+	psubx = &preq->rq_reply.brp_un.brp_substatc;
+	for (i = 0; i < pql->rq_count; i++) {
+		if ((*psubx = calloc(1, sizeof(struct batch_submit_status))) == NULL) {
+			req_reject(PBSE_SYSTEM, 0, preq);
+			return;
+		}
+		(*psubx)->code = PBSE_INTERNAL;	/* until the job replies */
+		psubx = &(*psubx)->next;
+	}
+
+	in_trx = (pbs_db_begin_trx(svr_db_conn) == 0);
+
+	/* hold the reply until every job has been through req_quejob */
+	preq->rq_refct++;
+
+	psub = preq->rq_reply.brp_un.brp_substatc;
+	for (i = 0; i < pql->rq_count; i++, psub = psub->next) {
+		pqj = &pql->rq_jobs[i];
+
+		pchild = alloc_br(PBS_BATCH_QueueJob);
+		if (pchild == NULL) {
+			psub->code = PBSE_SYSTEM;
+			continue;
+		}
+		pchild->rq_perm = preq->rq_perm;
+		pchild->rq_fromsvr = preq->rq_fromsvr;
+		pchild->rq_conn = preq->rq_conn;
+		pchild->rq_orgconn = preq->rq_orgconn;
+		pchild->rq_time = preq->rq_time;
+		pchild->prot = preq->prot;
+		strcpy(pchild->rq_user, preq->rq_user);
+		strcpy(pchild->rq_host, preq->rq_host);
+		pchild->rq_extend = preq->rq_extend;
+
+		strcpy(pchild->rq_ind.rq_queuejob.rq_destin, pqj->rq_destin);
+		list_move(&pqj->rq_attr, &pchild->rq_ind.rq_queuejob.rq_attr);
+		if (pqj->rq_script >= 0) {
+			pchild->rq_ind.rq_queuejob.rq_script = pql->rq_scripts[pqj->rq_script];
+			pchild->rq_ind.rq_queuejob.rq_scriptsz = pql->rq_scriptsz[pqj->rq_script];
+		}
+
+		pchild->rq_extra = psub;
+		pchild->rq_parentbr = preq;
+		preq->rq_refct++;
+
+		req_quejob(pchild);
+	}
+
+	if (in_trx && (pbs_db_end_trx(svr_db_conn, PBS_DB_COMMIT) != 0)) {
+		log_err(PBSE_SAVE_ERR, __func__, "Failed to commit submitted job list, purging its jobs");
+		for (psub = preq->rq_reply.brp_un.brp_substatc; psub; psub = psub->next) {
+			if (psub->jobid == NULL)
+				continue;
+			if ((pj = find_job(psub->jobid)) != NULL)
+				job_purge(pj);
+			free(psub->jobid);
+			psub->jobid = NULL;
+			psub->code = PBSE_SAVE_ERR;
+		}
+	} else if (preq->rq_fromsvr == 0) {
+		for (psub = preq->rq_reply.brp_un.brp_substatc; psub; psub = psub->next) {
+			if ((psub->jobid == NULL) || ((pj = find_job(psub->jobid)) == NULL))
+				continue;
+			pque = pj->ji_qhdr;
+			if ((pque->qu_qs.qu_type == QTYPE_RoutePush) &&
+				(pque->qu_attr[(int)QA_ATR_Started].at_val.at_long != 0) &&
+				((rc = job_route(pj)) != 0)) {
+				job_purge(pj);
+				free(psub->jobid);
+				psub->jobid = NULL;
+				psub->code = rc;
+			}
+		}
+	}
+
+	if (--preq->rq_refct == 0)
+		reply_send(preq);
+}
+#endif /* not PBS_MOM */
+
 /**
  * @brief
  * 		locate_new_job - locate a "new" job which has been set up req_quejob on
@@ -1669,7 +1669,7 @@ encode_depend(const attribute *attr, pbs_list_head *phead, char *atname, char *r
 	} else {
 		/* there are no dependencies, just the base structure,	*/
 		/* so remove this svrattrl from ths list		*/
-		(void)free(pal);
+		attrlist_free(pal);
 		if (rtnl)
 			*rtnl = NULL;
 		return (0);
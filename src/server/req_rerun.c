@@ -255,7 +255,7 @@ req_rerunjob(struct batch_request *preq)
 			req_reject(PBSE_IVALREQ, 0, preq);
 			return;
 		} else if (sjst == JOB_STATE_LTR_RUNNING) {
-			if ((pjob = parent->ji_ajtrk->tkm_tbl[offset].trk_psubjob)) {
+			if ((pjob = get_subjob_ptr(parent, offset))) {
 				req_rerunjob2(preq, pjob);
 			} else {
 				req_reject(PBSE_BADSTATE, 0, preq);
@@ -288,7 +288,7 @@ req_rerunjob(struct batch_request *preq)
 		parent->ji_ajtrk->tkm_dsubjsct = 0;
 
 		for (i=0; i<parent->ji_ajtrk->tkm_ct; i++) {
-			if ((pjob = parent->ji_ajtrk->tkm_tbl[i].trk_psubjob)) {
+			if ((pjob = get_subjob_ptr(parent, i))) {
 				if (check_job_state(pjob, JOB_STATE_LTR_RUNNING))
 					dup_br_for_subjob(preq, pjob, req_rerunjob2);
 				else
@@ -351,7 +351,7 @@ req_rerunjob(struct batch_request *preq)
 			int idx = numindex_to_offset(parent, i);
 			char sjst = get_subjob_state(parent, idx);
 			if (sjst == JOB_STATE_LTR_RUNNING) {
-				if ((pjob = parent->ji_ajtrk->tkm_tbl[idx].trk_psubjob)) {
+				if ((pjob = get_subjob_ptr(parent, idx))) {
 					dup_br_for_subjob(preq, pjob, req_rerunjob2);
 				}
 			}
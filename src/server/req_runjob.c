@@ -497,7 +497,7 @@ req_runjob(struct batch_request *preq)
 		clear_attr(&sub_prev_res, &job_attr_def[JOB_ATR_resource]);
 
 		/* single subjob, if parent qeueud, it can be run */
-		if ((pjobsub = parent->ji_ajtrk->tkm_tbl[offset].trk_psubjob) != NULL) {
+		if ((pjobsub = get_subjob_ptr(parent, offset)) != NULL) {
 			sub_runcount = pjobsub->ji_wattr[JOB_ATR_runcount];
 			sub_run_version = pjobsub->ji_wattr[JOB_ATR_run_version];
 			if (is_jattr_set(pjobsub, JOB_ATR_resource))
@@ -567,7 +567,7 @@ req_runjob(struct batch_request *preq)
 				attribute sub_run_version = {0};
 
 				jid = mk_subjob_id(parent, idx);
-				if ((pjobsub = parent->ji_ajtrk->tkm_tbl[idx].trk_psubjob) != NULL) {
+				if ((pjobsub = get_subjob_ptr(parent, idx)) != NULL) {
 					sub_runcount = pjobsub->ji_wattr[JOB_ATR_runcount];
 					sub_run_version = pjobsub->ji_wattr[JOB_ATR_run_version];
 					job_purge(pjobsub);
@@ -452,6 +452,87 @@ out:
 		reply_send(preq);
 }
 
+/**
+ * @brief
+ * 		select_jobids - collect the ids of the jobs that match selection
+ *		criteria and that the requester may act on, for requests that
+ *		operate on the selected jobs (Manage Job List).
+ *
+ *		Subjobs and history jobs are not selected, an Array Job is
+ *		selected as a whole.
+ *
+ * @param[in]	preq	-	request, for the requester's identity
+ * @param[in]	plist	-	selection criteria
+ * @param[out]	pids	-	NULL terminated array of job ids, malloc-ed
+ * @param[out]	pcount	-	number of job ids
+ * @param[out]	bad	-	index of a bad criterion on error
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	!0	: PBSE error code
+ */
+int
+select_jobids(struct batch_request *preq, svrattrl *plist, char ***pids,
+	int *pcount, int *bad)
+{
+	struct select_list *selistp = NULL;
+	pbs_queue *pque = NULL;
+	char *pstate = NULL;
+	char **ids = NULL;
+	char **tmp;
+	int size = 0;
+	int ct = 0;
+	int rc;
+	job *pjob;
+
+	*pids = NULL;
+	*pcount = 0;
+
+	rc = build_selist(plist, preq->rq_perm, &selistp, &pque, bad, &pstate);
+	if (rc != 0) {
+		free_sellist(selistp);
+		return rc;
+	}
+
+	if (pque)
+		pjob = (job *) GET_NEXT(pque->qu_jobs);
+	else
+		pjob = (job *) GET_NEXT(svr_alljobs);
+	while (pjob) {
+		if (((pjob->ji_qs.ji_svrflags & JOB_SVFLG_SubJob) == 0) &&
+			(svr_authorize_jobreq(preq, pjob) == 0) &&
+			select_job(pjob, selistp, 0, 0)) {
+			if (ct + 1 >= size) {
+				size = size ? size * 2 : 64;
+				tmp = realloc(ids, size * sizeof(char *));
+				if (tmp == NULL) {
+					rc = PBSE_SYSTEM;
+					break;
+				}
+				ids = tmp;
+			}
+			if ((ids[ct] = strdup(pjob->ji_qs.ji_jobid)) == NULL) {
+				rc = PBSE_SYSTEM;
+				break;
+			}
+			ids[++ct] = NULL;
+		}
+		if (pque)
+			pjob = (job *) GET_NEXT(pjob->ji_jobque);
+		else
+			pjob = (job *) GET_NEXT(pjob->ji_alljobs);
+	}
+	free_sellist(selistp);
+
+	if (rc != 0) {
+		arrayfree(ids);
+		return rc;
+	}
+	*pids = ids;
+	*pcount = ct;
+	return 0;
+}
+
 /**
  * @brief
  * 		select_job - determine if a single job matches the selection criteria
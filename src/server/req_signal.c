@@ -168,7 +168,7 @@ req_signaljob(struct batch_request *preq)
 			req_reject(PBSE_IVALREQ, 0, preq);
 			return;
 		} else if (sjst == JOB_STATE_LTR_RUNNING) {
-			if ((pjob = parent->ji_ajtrk->tkm_tbl[offset].trk_psubjob)) {
+			if ((pjob = get_subjob_ptr(parent, offset))) {
 				req_signaljob2(preq, pjob);
 			} else {
 				req_reject(PBSE_BADSTATE, 0, preq);
@@ -195,7 +195,7 @@ req_signaljob(struct batch_request *preq)
 
 		for (i=0; i<parent->ji_ajtrk->tkm_ct; i++) {
 			if (get_subjob_state(parent, i) == JOB_STATE_LTR_RUNNING) {
-				if ((pjob = parent->ji_ajtrk->tkm_tbl[i].trk_psubjob)) {
+				if ((pjob = get_subjob_ptr(parent, i))) {
 					/* if suspending,  skip those already suspended,  */
 					if (suspend && (pjob->ji_qs.ji_svrflags & JOB_SVFLG_Suspend))
 						continue;
@@ -261,7 +261,7 @@ req_signaljob(struct batch_request *preq)
 
 			sjst = get_subjob_state(parent, idx);
 			if (sjst == JOB_STATE_LTR_RUNNING) {
-				if ((pjob = parent->ji_ajtrk->tkm_tbl[idx].trk_psubjob)) {
+				if ((pjob = get_subjob_ptr(parent, idx))) {
 					dup_br_for_subjob(preq, pjob, req_signaljob2);
 				}
 			}
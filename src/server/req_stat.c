@@ -52,6 +52,10 @@
  * 	status_que()
  * 	req_stat_node()
  * 	status_node()
+ * 	summary_add_resc()
+ * 	summary_add_node()
+ * 	summary_add_total()
+ * 	req_stat_node_summary()
  * 	req_stat_svr()
  * 	req_stat_sched()
  * 	update_state_ct()
@@ -69,6 +73,7 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <string.h>
 #include "libpbs.h"
 #include <ctype.h>
 #include "server_limits.h"
@@ -699,6 +704,367 @@ status_node(struct pbsnode *pnode, struct batch_request *preq, pbs_list_head *ps
 	return (rc);
 }
 
+/* resources totalled by a node summary when the client names none */
+static char *summary_default_resc[] = {"ncpus", "mem", "ngpus", NULL};
+
+/* one group of a node summary, the vnodes of a partition */
+struct node_summary {
+	char	*ns_partition;	/* partition name, "" for none */
+	int	 ns_nstates;	/* number of distinct states seen */
+	char	**ns_state;	/* state strings */
+	long	*ns_statect;	/* number of vnodes in each state */
+	Long	*ns_avail;	/* integer totals, one per resource */
+	Long	*ns_assn;
+	double	*ns_favail;	/* float totals, one per resource */
+	double	*ns_fassn;
+};
+
+/**
+ * @brief
+ * 		summary_add_resc - add a vnode's value of a resource to a total
+ *
+ * @param[in]	pattr	-	resources_available or resources_assigned
+ * @param[in]	prd	-	resource to add
+ * @param[in,out]	ptot	-	integer total
+ * @param[in,out]	pftot	-	float total
+ */
+static void
+summary_add_resc(attribute *pattr, resource_def *prd, Long *ptot, double *pftot)
+{
+	resource *presc;
+
+	presc = find_resc_entry(pattr, prd);
+	if (presc == NULL || !(presc->rs_value.at_flags & ATR_VFLAG_SET))
+		return;
+
+	switch (prd->rs_type) {
+		case ATR_TYPE_LONG:
+			*ptot += presc->rs_value.at_val.at_long;
+			break;
+		case ATR_TYPE_LL:
+			*ptot += presc->rs_value.at_val.at_ll;
+			break;
+		case ATR_TYPE_SHORT:
+			*ptot += presc->rs_value.at_val.at_short;
+			break;
+		case ATR_TYPE_SIZE:
+			*ptot += get_kilobytes_from_attr(&presc->rs_value);
+			break;
+		case ATR_TYPE_FLOAT:
+			*pftot += presc->rs_value.at_val.at_float;
+			break;
+	}
+}
+
+/**
+ * @brief
+ * 		summary_add_node - count a vnode in its group of a node summary
+ *
+ * @param[in]	pnode	-	the vnode
+ * @param[in,out]	pns	-	the group
+ * @param[in]	rdefs	-	resources to total
+ * @param[in]	nresc	-	number of resources in rdefs
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	PBSE_SYSTEM	: out of memory
+ */
+static int
+summary_add_node(struct pbsnode *pnode, struct node_summary *pns, resource_def **rdefs, int nresc)
+{
+	attribute	 state;
+	svrattrl	*pal = NULL;
+	unsigned long	 nd_state;
+	char		*statestr;
+	int		 i;
+
+	/* show the state as status_node() would */
+	nd_state = pnode->nd_state;
+	if (nd_state & (INUSE_PROV | INUSE_WAIT_PROV))
+		nd_state &= ~(INUSE_DOWN | INUSE_UNKNOWN | INUSE_JOB |
+			INUSE_JOBEXCL | INUSE_RESVEXCL);
+	clear_attr(&state, &node_attr_def[(int)ND_ATR_state]);
+	state.at_val.at_long = nd_state;
+	state.at_flags = ATR_VFLAG_SET;
+	if (encode_state(&state, NULL, ATTR_NODE_state, NULL, ATR_ENCODE_CLIENT, &pal) < 0 || pal == NULL)
+		return (PBSE_SYSTEM);
+	statestr = pal->al_value;
+
+	for (i = 0; i < pns->ns_nstates; i++) {
+		if (strcmp(pns->ns_state[i], statestr) == 0)
+			break;
+	}
+	if (i == pns->ns_nstates) {
+		char **tstate;
+		long *tct;
+
+		tstate = realloc(pns->ns_state, (i + 1) * sizeof(char *));
+		if (tstate == NULL) {
+			free(pal);
+			return (PBSE_SYSTEM);
+		}
+		pns->ns_state = tstate;
+		tct = realloc(pns->ns_statect, (i + 1) * sizeof(long));
+		if (tct == NULL) {
+			free(pal);
+			return (PBSE_SYSTEM);
+		}
+		pns->ns_statect = tct;
+		if ((pns->ns_state[i] = strdup(statestr)) == NULL) {
+			free(pal);
+			return (PBSE_SYSTEM);
+		}
+		pns->ns_statect[i] = 0;
+		pns->ns_nstates++;
+	}
+	pns->ns_statect[i]++;
+	free(pal);
+
+	for (i = 0; i < nresc; i++) {
+		summary_add_resc(&pnode->nd_attr[(int)ND_ATR_ResourceAvail],
+			rdefs[i], &pns->ns_avail[i], &pns->ns_favail[i]);
+		summary_add_resc(&pnode->nd_attr[(int)ND_ATR_ResourceAssn],
+			rdefs[i], &pns->ns_assn[i], &pns->ns_fassn[i]);
+	}
+	return (0);
+}
+
+/**
+ * @brief
+ * 		summary_add_total - append a resource total to a summary reply
+ *
+ * @param[in,out]	phead	-	attribute list of the group's reply
+ * @param[in]	aname	-	resources_available or resources_assigned
+ * @param[in]	prd	-	the resource
+ * @param[in]	tot	-	integer total
+ * @param[in]	ftot	-	float total
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	PBSE_SYSTEM	: out of memory
+ */
+static int
+summary_add_total(pbs_list_head *phead, char *aname, resource_def *prd, Long tot, double ftot)
+{
+	char	  buf[64];
+	svrattrl *pal;
+
+	if (prd->rs_type == ATR_TYPE_FLOAT)
+		snprintf(buf, sizeof(buf), "%.2f", ftot);
+	else if (prd->rs_type == ATR_TYPE_SIZE)
+		snprintf(buf, sizeof(buf), "%lldkb", (long long)tot);
+	else
+		snprintf(buf, sizeof(buf), "%lld", (long long)tot);
+
+	pal = attrlist_create(aname, prd->rs_name, strlen(buf) + 1);
+	if (pal == NULL)
+		return (PBSE_SYSTEM);
+	strcpy(pal->al_value, buf);
+	pal->al_flags = ATR_VFLAG_SET;
+	append_link(phead, &pal->al_link, pal);
+	return (0);
+}
+
+/**
+ * @brief
+ * 		req_stat_node_summary - service the Status Node Summary Request
+ *
+ *		Instead of the status of each vnode, the reply has one object per
+ *		partition with the number of vnodes in each state and the totals
+ *		of some resources over the vnodes, so a large complex can be
+ *		summarized without sending every vnode to the client.
+ *
+ *		rq_id names the partition to summarize, "" or "@" for all.  The
+ *		resources to total are the resources of the resources_available
+ *		entries of rq_attr; without any, ncpus, mem and ngpus are totalled.
+ *
+ * @param[in]	preq	-	ptr to the decoded request
+ */
+
+void
+req_stat_node_summary(struct batch_request *preq)
+{
+	char			*name;
+	char			*part;
+	struct batch_reply	*preply;
+	struct brp_status	*pstat;
+	svrattrl		*pal;
+	struct pbsnode		*pnode;
+	resource_def		**rdefs = NULL;
+	resource_def		*prd;
+	struct node_summary	*groups = NULL;
+	struct node_summary	*pns;
+	int			 ngroups = 0;
+	int			 nresc = 0;
+	int			 rc = 0;
+	int			 i;
+	int			 j;
+
+	if (pbsndlist == 0  ||  svr_totnodes <= 0) {
+		req_reject(PBSE_NONODES, 0, preq);
+		return;
+	}
+	if ((preq->rq_perm & ATR_DFLAG_RDACC) == 0) {
+		req_reject(PBSE_PERM, 0, preq);
+		return;
+	}
+
+	name = preq->rq_ind.rq_status.rq_id;
+	if (*name == '@')
+		name = "";
+
+	/* the resources to total */
+	rdefs = calloc(svr_resc_size + 1, sizeof(resource_def *));
+	if (rdefs == NULL) {
+		req_reject(PBSE_SYSTEM, 0, preq);
+		return;
+	}
+	pal = (svrattrl *)GET_NEXT(preq->rq_ind.rq_status.rq_attr);
+	if (pal == NULL) {
+		for (i = 0; summary_default_resc[i]; i++) {
+			prd = find_resc_def(svr_resc_def, summary_default_resc[i]);
+			if (prd != NULL)
+				rdefs[nresc++] = prd;
+		}
+	}
+	for (; pal; pal = (svrattrl *)GET_NEXT(pal->al_link)) {
+		if (pal->al_resc == NULL || strcmp(pal->al_name, ATTR_rescavail) != 0) {
+			rc = PBSE_IVALREQ;
+			break;
+		}
+		prd = find_resc_def(svr_resc_def, pal->al_resc);
+		if (prd == NULL || (prd->rs_flags & preq->rq_perm & ATR_DFLAG_RDACC) == 0) {
+			rc = PBSE_UNKRESC;
+			break;
+		}
+		switch (prd->rs_type) {
+			case ATR_TYPE_LONG:
+			case ATR_TYPE_LL:
+			case ATR_TYPE_SHORT:
+			case ATR_TYPE_SIZE:
+			case ATR_TYPE_FLOAT:
+				break;
+			default:
+				rc = PBSE_IVALREQ;
+		}
+		if (rc)
+			break;
+		for (j = 0; j < nresc; j++) {
+			if (rdefs[j] == prd)
+				break;
+		}
+		if (j == nresc && nresc < svr_resc_size)
+			rdefs[nresc++] = prd;
+	}
+	if (rc) {
+		free(rdefs);
+		reply_badattr(rc, 1, pal, preq);
+		return;
+	}
+
+	/* count the vnodes into their partition */
+	for (i = 0; i < svr_totnodes && rc == 0; i++) {
+		pnode = pbsndlist[i];
+		if (pnode->nd_state & INUSE_DELETED)
+			continue;
+		if (pnode->nd_attr[(int)ND_ATR_partition].at_flags & ATR_VFLAG_SET)
+			part = pnode->nd_attr[(int)ND_ATR_partition].at_val.at_str;
+		else
+			part = "";
+		if (*name != '\0' && strcmp(name, part) != 0)
+			continue;
+
+		for (j = 0; j < ngroups; j++) {
+			if (strcmp(groups[j].ns_partition, part) == 0)
+				break;
+		}
+		if (j == ngroups) {
+			pns = realloc(groups, (ngroups + 1) * sizeof(struct node_summary));
+			if (pns == NULL) {
+				rc = PBSE_SYSTEM;
+				break;
+			}
+			groups = pns;
+			pns = &groups[ngroups++];
+			memset(pns, 0, sizeof(struct node_summary));
+			pns->ns_partition = part;
+			pns->ns_avail = calloc(nresc + 1, sizeof(Long));
+			pns->ns_assn = calloc(nresc + 1, sizeof(Long));
+			pns->ns_favail = calloc(nresc + 1, sizeof(double));
+			pns->ns_fassn = calloc(nresc + 1, sizeof(double));
+			if (pns->ns_avail == NULL || pns->ns_assn == NULL ||
+				pns->ns_favail == NULL || pns->ns_fassn == NULL) {
+				rc = PBSE_SYSTEM;
+				break;
+			}
+		}
+		rc = summary_add_node(pnode, &groups[j], rdefs, nresc);
+	}
+
+	if (rc == 0 && *name != '\0' && ngroups == 0)
+		rc = PBSE_UNKNODE;
+
+	/* build the reply, one status object per partition */
+	preply = &preq->rq_reply;
+	preply->brp_choice = BATCH_REPLY_CHOICE_Status;
+	CLEAR_HEAD(preply->brp_un.brp_status);
+	preply->brp_count = 0;
+
+	for (j = 0; j < ngroups && rc == 0; j++) {
+		pns = &groups[j];
+		pstat = (struct brp_status *)malloc(sizeof(struct brp_status));
+		if (pstat == NULL) {
+			rc = PBSE_SYSTEM;
+			break;
+		}
+		pstat->brp_objtype = MGR_OBJ_NODE;
+		snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%s", pns->ns_partition);
+		CLEAR_LINK(pstat->brp_stlink);
+		CLEAR_HEAD(pstat->brp_attr);
+		append_link(&preply->brp_un.brp_status, &pstat->brp_stlink, pstat);
+		preply->brp_count++;
+
+		for (i = 0; i < pns->ns_nstates && rc == 0; i++) {
+			char ct[32];
+
+			snprintf(ct, sizeof(ct), "%ld", pns->ns_statect[i]);
+			pal = attrlist_create(ATTR_NODE_state, pns->ns_state[i], strlen(ct) + 1);
+			if (pal == NULL) {
+				rc = PBSE_SYSTEM;
+				break;
+			}
+			strcpy(pal->al_value, ct);
+			pal->al_flags = ATR_VFLAG_SET;
+			append_link(&pstat->brp_attr, &pal->al_link, pal);
+		}
+		for (i = 0; i < nresc && rc == 0; i++)
+			rc = summary_add_total(&pstat->brp_attr, ATTR_rescavail,
+				rdefs[i], pns->ns_avail[i], pns->ns_favail[i]);
+		for (i = 0; i < nresc && rc == 0; i++)
+			rc = summary_add_total(&pstat->brp_attr, ATTR_rescassn,
+				rdefs[i], pns->ns_assn[i], pns->ns_fassn[i]);
+	}
+
+	for (j = 0; j < ngroups; j++) {
+		pns = &groups[j];
+		for (i = 0; i < pns->ns_nstates; i++)
+			free(pns->ns_state[i]);
+		free(pns->ns_state);
+		free(pns->ns_statect);
+		free(pns->ns_avail);
+		free(pns->ns_assn);
+		free(pns->ns_favail);
+		free(pns->ns_fassn);
+	}
+	free(groups);
+	free(rdefs);
+
+	if (rc)
+		req_reject(rc, 0, preq);
+	else
+		reply_send(preq);
+}
+
 /**
  * @brief
  * 	update_isrunhook - update the value is has_runjob_hook
@@ -536,6 +536,7 @@ sched_delete(pbs_sched *psched)
 	strcpy(dbsched.sched_name, psched->sc_name);
 	obj.pbs_db_obj_type = PBS_DB_SCHED;
 	obj.pbs_db_un.pbs_db_sched = &dbsched;
+	db_writer_barrier();
 	if (pbs_db_delete_obj(conn, &obj) != 0) {
 		snprintf(log_buffer, LOG_BUF_SIZE,
 				"delete of scheduler %s from datastore failed",
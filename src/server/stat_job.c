@@ -198,10 +198,15 @@ status_attrib(svrattrl *pal, void *pidx, attribute_def *padef, attribute *pattr,
 {
 	int   index;
 	int   nth = 0;
+	int   rc = 0;
+	int   pooling;
 
 	priv &= (ATR_DFLAG_RDACC | ATR_DFLAG_SvWR);  /* user-client privilege */
 	resc_access_perm = priv;  /* pass privilege to encode_resc()	*/
 
+	/* the encoded lists are freed with the reply or the attribute cache */
+	pooling = attrlist_pool_enable(1);
+
 	/* for each attribute asked for or for all attributes, add to reply */
 
 	if (pal) {		/* client specified certain attributes */
@@ -210,7 +215,8 @@ status_attrib(svrattrl *pal, void *pidx, attribute_def *padef, attribute *pattr,
 			index = find_attr(pidx, padef, pal->al_name);
 			if (index < 0) {
 				*bad = nth;
-				return (-1);
+				rc = -1;
+				break;
 			}
 			if ((padef+index)->at_flags & priv) {
 				svrcached(pattr+index, phead, padef+index);
@@ -224,7 +230,8 @@ status_attrib(svrattrl *pal, void *pidx, attribute_def *padef, attribute *pattr,
 			}
 		}
 	}
-	return (0);
+	attrlist_pool_enable(pooling);
+	return (rc);
 }
 
 /**
@@ -384,7 +391,7 @@ status_subjob(job *pjob, struct batch_request *preq, svrattrl *pal, int subj, pb
 
 	/* if subjob job obj exists, use real job structure */
 
-	if ((get_subjob_state(pjob, subj) != JOB_STATE_LTR_QUEUED) && (psubjob = pjob->ji_ajtrk->tkm_tbl[subj].trk_psubjob)) {
+	if ((get_subjob_state(pjob, subj) != JOB_STATE_LTR_QUEUED) && (psubjob = get_subjob_ptr(pjob, subj))) {
 
 		status_job(psubjob, preq, pal, pstathd, bad);
 		return 0;
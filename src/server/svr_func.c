@@ -89,6 +89,7 @@
 #include "svrfunc.h"
 #include "pbs_db.h"
 #include "libutil.h"
+#include "pbs_pool.h"
 #include "pbs_ecl.h"
 #include "pbs_sched.h"
 #include "liblicense.h"
@@ -6676,6 +6677,7 @@ svr_load_jobscript(job *pj)
 	obj.pbs_db_obj_type = PBS_DB_JOBSCR;
 	obj.pbs_db_un.pbs_db_jobscr = &jobscr;
 
+	db_writer_barrier();
 	if (pbs_db_load_obj(conn, &obj) != 0) {
 		snprintf(log_buffer, sizeof(log_buffer),
 			"Failed to load job script for job %s from PBS datastore",
@@ -6900,7 +6902,8 @@ enum failover_state are_we_primary(void)
 
 /**
  * @brief
- * 		dumps the memory usage of the heap into server log in every 10 minutes.
+ * 		dumps the memory usage of the heap and of the object pools
+ *		(live and peak objects of each pool) into server log in every 10 minutes.
  *
  * @param[in]	ptask	-	pointer to the work task
  *
@@ -6918,6 +6921,19 @@ void memory_debug_log(struct work_task *ptask) {
 		return;
 	snprintf(log_buffer, LOG_BUF_SIZE, "MEM_DEBUG: sbrk: %zu", (size_t)sbrk(0));
 	log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_SERVER, LOG_DEBUG, msg_daemonname, log_buffer);
+
+	pbs_pool_stats_t pstats[16];
+	int npools;
+	int i;
+
+	npools = pbs_pool_stats(pstats, sizeof(pstats) / sizeof(pstats[0]));
+	for (i = 0; i < npools; i++) {
+		snprintf(log_buffer, LOG_BUF_SIZE,
+			"MEM_DEBUG: pool %s size=%zu live=%ld peak=%ld free=%ld slabs=%ld allocs=%lu",
+			pstats[i].name, pstats[i].objsize, pstats[i].live, pstats[i].peak,
+			pstats[i].nfree, pstats[i].slabs, pstats[i].allocs);
+		log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_SERVER, LOG_DEBUG, msg_daemonname, log_buffer);
+	}
 #ifdef HAVE_MALLOC_INFO
 	char *buf;
 	buf = get_mem_info();
@@ -241,15 +241,8 @@ svr_enquejob(job *pjob)
 			server.sv_qs.sv_numjobs++;
 			if (state_num != -1)
 				server.sv_jobstates[state_num]++;
-			if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_ArrayJob) {
-				struct ajtrkhd *ptbl = pjob->ji_ajtrk;
-				if (ptbl) {
-					int indx;
-
-					for (indx = 0; indx < ptbl->tkm_ct; ++indx)
-						set_subjob_tblstate(pjob, indx, get_job_state(pjob));
-				}
-			}
+			if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_ArrayJob)
+				set_subjob_tblstate_all(pjob, get_job_state(pjob));
 			return (0);
 		} else {
 			return (PBSE_UNKQUE);
@@ -319,16 +312,8 @@ svr_enquejob(job *pjob)
 
 	if ((check_job_state(pjob, JOB_STATE_LTR_MOVED)) ||
 		(check_job_state(pjob, JOB_STATE_LTR_FINISHED))) {
-		if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_ArrayJob) {
-			int indx;
-			struct ajtrkhd *ptbl = pjob->ji_ajtrk;
-			if (ptbl) {
-				for (indx = 0; indx < ptbl->tkm_ct; ++indx)
-					set_subjob_tblstate(pjob,
-						indx,
-						get_job_state(pjob));
-			}
-		}
+		if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_ArrayJob)
+			set_subjob_tblstate_all(pjob, get_job_state(pjob));
 		return (0);
 	}
 
@@ -1545,10 +1530,10 @@ job_set_wait(attribute *pattr, void *pjob, int mode)
 
 	if (((job *)pjob)->ji_qs.ji_svrflags & JOB_SVFLG_HASWAIT) {
 		while (ptask) {
-			if ((ptask->wt_event == WORK_Timed) &&
+			if ((ptask->wt_type == WORK_Timed) &&
 				(ptask->wt_func == job_wait_over) &&
 				(ptask->wt_parm1 == pjob)) {
-				ptask->wt_event = when;
+				set_task_time(ptask, when);
 				return (0);
 			}
 			ptask = (struct work_task *)GET_NEXT(ptask->wt_linkobj);
@@ -4817,7 +4802,7 @@ svr_histjob_update(job * pjob, char newstate, int newsubstate)
 		if (ptbl) {
 			/* update the subjob state table */
 			for (indx = 0; indx < ptbl->tkm_ct; ++indx) {
-				job *psubj = ptbl->tkm_tbl[indx].trk_psubjob;
+				job *psubj = get_subjob_ptr(pjob, indx);
 				if (psubj) {
 					if (!check_job_substate(psubj, JOB_SUBSTATE_TERMINATED) &&
 						!check_job_substate(psubj, JOB_SUBSTATE_FINISHED) &&
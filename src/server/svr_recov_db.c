@@ -230,6 +230,7 @@ svr_recov_db(void)
 	obj.pbs_db_obj_type = PBS_DB_SVR;
 	obj.pbs_db_un.pbs_db_svr = &dbsvr;
 
+	db_writer_barrier();
 	rc = pbs_db_load_obj(conn, &obj);
 	if (rc == -2)
 		return 0; /* no change in server, return 0 */
@@ -278,6 +279,7 @@ svr_save_db(struct server *ps)
 	obj.pbs_db_obj_type = PBS_DB_SVR;
 	obj.pbs_db_un.pbs_db_svr = &dbsvr;
 
+	db_writer_barrier();
 	if ((rc = pbs_db_save_obj(conn, &obj, savetype)) == 0)
 		ps->newobj = 0;
 
@@ -327,6 +329,7 @@ sched_recov_db(char *sname, pbs_sched *ps)
 	/* load sched */
 	snprintf(dbsched.sched_name, sizeof(dbsched.sched_name), "%s", sname);
 
+	db_writer_barrier();
 	rc = pbs_db_load_obj(conn, &obj);
 	if (rc == -2)
 		return ps; /* no change in sched */
@@ -379,6 +382,7 @@ sched_save_db(pbs_sched *ps)
 	obj.pbs_db_obj_type = PBS_DB_SCHED;
 	obj.pbs_db_un.pbs_db_sched = &dbsched;
 
+	db_writer_barrier();
 	if ((rc = pbs_db_save_obj(conn, &obj, savetype)) == 0)
 		ps->newobj = 0;
 
@@ -0,0 +1,580 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_acctread.c
+ *
+ * @brief
+ *	pbs_acctread - print the records of binary accounting files
+ *
+ * @par
+ *	Reads the binary sidecars the server writes next to its accounting
+ *	files with PBS_ACCT_BINARY set (see acct_bin.h).  Prints the records
+ *	as accounting log lines, or only chosen fields of each record, one
+ *	record per line, for loading into other tools.
+ *
+ * Functions included are:
+ *	main()
+ *	get_varint()
+ *	get_str()
+ *	add_key()
+ *	print_value()
+ *	print_csv()
+ *	read_file()
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "pbs_version.h"
+#include "pbs_ifl.h"
+#include "pbs_internal.h"
+#include "acct_bin.h"
+
+#define COL_TIME	-2	/* pseudo fields of -f */
+#define COL_TYPE	-3
+#define COL_ID		-4
+#define COL_DATE	-5
+#define COL_NONE	-1
+
+/* a key of the current section */
+struct key {
+	const char	*name;
+	size_t		len;
+	int		col;	/* column of the key with -f, or COL_NONE */
+};
+
+/* a value of a record */
+struct value {
+	int		type;	/* ACCT_BIN_* */
+	char		quote;
+	const char	*str;
+	size_t		len;
+	long long	num;
+};
+
+static struct key *keys = NULL;	/* keys by index, keys[0] is unused */
+static size_t nkeys = 0;
+static size_t maxkeys = 0;
+
+static char **cols = NULL;	/* fields of -f */
+static int ncols = 0;
+static struct value *colvals = NULL;	/* value of each column in a record */
+static char *types = NULL;	/* record types of -t */
+static char sep = ',';
+
+/**
+ * @brief
+ *	Read a varint.
+ *
+ * @param[in,out]	pp - read position, moved past the varint
+ * @param[in]	end - end of the data
+ * @param[out]	pv - the value
+ *
+ * @return	int
+ * @retval	 0 - success
+ * @retval	-1 - the data ends inside the varint
+ */
+static int
+get_varint(const unsigned char **pp, const unsigned char *end, unsigned long long *pv)
+{
+	const unsigned char *p = *pp;
+	unsigned long long v = 0;
+	int shift = 0;
+
+	while (p < end && shift < 64) {
+		v |= (unsigned long long) (*p & 0x7f) << shift;
+		if ((*p++ & 0x80) == 0) {
+			*pp = p;
+			*pv = v;
+			return 0;
+		}
+		shift += 7;
+	}
+	return -1;
+}
+
+/**
+ * @brief
+ *	Read a string, its length first.
+ *
+ * @param[in,out]	pp - read position, moved past the string
+ * @param[in]	end - end of the data
+ * @param[out]	ps - the string, not null terminated
+ * @param[out]	plen - its length
+ *
+ * @return	int
+ * @retval	 0 - success
+ * @retval	-1 - the data ends inside the string
+ */
+static int
+get_str(const unsigned char **pp, const unsigned char *end, const char **ps, size_t *plen)
+{
+	unsigned long long len;
+
+	if ((get_varint(pp, end, &len) != 0) || (len > (unsigned long long) (end - *pp)))
+		return -1;
+	*ps = (const char *) *pp;
+	*plen = len;
+	*pp += len;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Give the next index of the section to a key.
+ *
+ * @param[in]	name - the key, not null terminated, in the file data
+ * @param[in]	len - its length
+ *
+ * @return	int
+ * @retval	 0 - success
+ * @retval	-1 - out of memory
+ */
+static int
+add_key(const char *name, size_t len)
+{
+	struct key *new;
+	int i;
+
+	if (nkeys + 1 >= maxkeys) {
+		maxkeys = (maxkeys == 0) ? 1024 : maxkeys * 2;
+		if ((new = realloc(keys, maxkeys * sizeof(struct key))) == NULL)
+			return -1;
+		keys = new;
+	}
+	nkeys++;
+	keys[nkeys].name = name;
+	keys[nkeys].len = len;
+	keys[nkeys].col = COL_NONE;
+	for (i = 0; i < ncols; i++) {
+		if ((strlen(cols[i]) == len) && (strncmp(cols[i], name, len) == 0)) {
+			keys[nkeys].col = i;
+			break;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Print a value as it is in the accounting log.
+ *
+ * @param[in]	pv - the value
+ *
+ * @return	void
+ */
+static void
+print_value(struct value *pv)
+{
+	switch (pv->type) {
+		case ACCT_BIN_INT:
+			printf("%lld", pv->num);
+			break;
+		case ACCT_BIN_DUR:
+			printf("%02lld:%02d:%02d", pv->num / 3600,
+				(int) (pv->num % 3600 / 60), (int) (pv->num % 60));
+			break;
+		case ACCT_BIN_QSTR:
+			printf("%c%.*s%c", pv->quote, (int) pv->len, pv->str, pv->quote);
+			break;
+		default:
+			fwrite(pv->str, 1, pv->len, stdout);
+			break;
+	}
+}
+
+/**
+ * @brief
+ *	Print a string as a field of a -f line, quoted as in CSV if it
+ *	holds the separator, a quote or a newline.
+ *
+ * @param[in]	str - the string, not null terminated
+ * @param[in]	len - its length
+ *
+ * @return	void
+ */
+static void
+print_csv(const char *str, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if ((str[i] == sep) || (str[i] == '"') || (str[i] == '\n'))
+			break;
+	}
+	if (i == len) {
+		fwrite(str, 1, len, stdout);
+		return;
+	}
+	putchar('"');
+	for (i = 0; i < len; i++) {
+		if (str[i] == '"')
+			putchar('"');
+		putchar(str[i]);
+	}
+	putchar('"');
+}
+
+/**
+ * @brief
+ *	Print the records of a binary accounting file.
+ *
+ * @param[in]	path - the file
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - the file could not be read, or is damaged
+ */
+static int
+read_file(char *path)
+{
+	int fd;
+	struct stat sb;
+	const unsigned char *data;
+	const unsigned char *p;
+	const unsigned char *end;
+	const unsigned char *rend;
+	unsigned long long v;
+	unsigned long long nf;
+	unsigned long long reclen;
+	const char *id;
+	const char *name;
+	size_t idlen;
+	size_t len;
+	time_t t;
+	time_t tcache = -1;
+	struct tm ltm;
+	char ts[24];
+	char type;
+	struct value val;
+	struct key *pk;
+	int col;
+	int i;
+	int rc = 0;
+
+	if ((fd = open(path, O_RDONLY)) == -1) {
+		fprintf(stderr, "pbs_acctread: cannot open %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+	if (fstat(fd, &sb) == -1) {
+		fprintf(stderr, "pbs_acctread: cannot stat %s: %s\n", path, strerror(errno));
+		close(fd);
+		return 1;
+	}
+	if (sb.st_size == 0) {
+		close(fd);
+		return 0;
+	}
+	data = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		fprintf(stderr, "pbs_acctread: cannot read %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+#ifdef MADV_SEQUENTIAL
+	(void)madvise((void *) data, sb.st_size, MADV_SEQUENTIAL);
+#endif
+
+	p = data;
+	end = data + sb.st_size;
+	if ((end - p < ACCT_BIN_MAGIC_LEN) || (memcmp(p, ACCT_BIN_MAGIC, ACCT_BIN_MAGIC_LEN) != 0)) {
+		fprintf(stderr, "pbs_acctread: %s is not a binary accounting file\n", path);
+		munmap((void *) data, sb.st_size);
+		return 1;
+	}
+
+	while (p < end) {
+		/* a new section, with keys of its own */
+		if (*p != ACCT_BIN_REC) {
+			if ((end - p < ACCT_BIN_MAGIC_LEN) || (memcmp(p, ACCT_BIN_MAGIC, ACCT_BIN_MAGIC_LEN) != 0))
+				goto damaged;
+			p += ACCT_BIN_MAGIC_LEN;
+			nkeys = 0;
+			continue;
+		}
+
+		p++;
+		if ((get_varint(&p, end, &reclen) != 0) || (reclen > (unsigned long long) (end - p)))
+			goto damaged;
+		rend = p + reclen;
+		if ((get_varint(&p, rend, &v) != 0) || (p >= rend))
+			goto damaged;
+		t = (time_t) v;
+		type = (char) *p++;
+		if ((get_str(&p, rend, &id, &idlen) != 0) || (get_varint(&p, rend, &nf) != 0))
+			goto damaged;
+
+		/* new keys must be learned even from records that are not printed */
+		if ((types != NULL) && (strchr(types, type) == NULL)) {
+			for (; nf > 0; nf--) {
+				if (get_varint(&p, rend, &v) != 0)
+					goto damaged;
+				if (v == 0) {
+					if ((get_str(&p, rend, &name, &len) != 0) || (add_key(name, len) != 0))
+						goto damaged;
+				}
+				if ((p >= rend) || (*p > ACCT_BIN_QSTR))
+					goto damaged;
+				switch (*p++) {
+					case ACCT_BIN_INT:
+					case ACCT_BIN_DUR:
+						if (get_varint(&p, rend, &v) != 0)
+							goto damaged;
+						break;
+					case ACCT_BIN_QSTR:
+						if (p++ >= rend)
+							goto damaged;
+						/* fall through */
+					default:
+						if (get_str(&p, rend, &name, &len) != 0)
+							goto damaged;
+						break;
+				}
+			}
+			p = rend;
+			continue;
+		}
+
+		if (t != tcache) {
+			localtime_r(&t, &ltm);
+			snprintf(ts, sizeof(ts), "%02d/%02d/%04d %02d:%02d:%02d",
+				ltm.tm_mon + 1, ltm.tm_mday, ltm.tm_year + 1900,
+				ltm.tm_hour, ltm.tm_min, ltm.tm_sec);
+			tcache = t;
+		}
+		if (ncols == 0)
+			printf("%s;%c;%.*s;", ts, type, (int) idlen, id);
+		else
+			for (i = 0; i < ncols; i++)
+				colvals[i].type = -1;
+
+		for (i = 0; nf > 0; nf--, i++) {
+			if (get_varint(&p, rend, &v) != 0)
+				goto damaged;
+			if (v == 0) {
+				if ((get_str(&p, rend, &name, &len) != 0) || (add_key(name, len) != 0))
+					goto damaged;
+				v = nkeys;
+			}
+			if ((v > nkeys) || (p >= rend) || (*p > ACCT_BIN_QSTR))
+				goto damaged;
+			pk = &keys[v];
+
+			val.type = *p++;
+			switch (val.type) {
+				case ACCT_BIN_INT:
+					if (get_varint(&p, rend, &v) != 0)
+						goto damaged;
+					val.num = (long long) (v >> 1) ^ -(long long) (v & 1);
+					break;
+				case ACCT_BIN_DUR:
+					if (get_varint(&p, rend, &v) != 0)
+						goto damaged;
+					val.num = (long long) v;
+					break;
+				case ACCT_BIN_QSTR:
+					if (p >= rend)
+						goto damaged;
+					val.quote = (char) *p++;
+					/* fall through */
+				default:
+					if (get_str(&p, rend, &val.str, &val.len) != 0)
+						goto damaged;
+					break;
+			}
+
+			if (ncols == 0) {
+				if (i > 0)
+					putchar(' ');
+				if (pk->len > 0)
+					printf("%.*s=", (int) pk->len, pk->name);
+				print_value(&val);
+			} else if (pk->col >= 0)
+				colvals[pk->col] = val;
+		}
+
+		if (ncols == 0) {
+			putchar('\n');
+		} else {
+			for (i = 0; i < ncols; i++) {
+				if (i > 0)
+					putchar(sep);
+				if (strcmp(cols[i], "time") == 0)
+					printf("%lld", (long long) t);
+				else if (strcmp(cols[i], "date") == 0)
+					fputs(ts, stdout);
+				else if (strcmp(cols[i], "type") == 0)
+					putchar(type);
+				else if (strcmp(cols[i], "id") == 0)
+					print_csv(id, idlen);
+				else if ((colvals[i].type == ACCT_BIN_INT) || (colvals[i].type == ACCT_BIN_DUR))
+					printf("%lld", colvals[i].num);	/* durations in seconds */
+				else if (colvals[i].type >= 0)
+					print_csv(colvals[i].str, colvals[i].len);
+			}
+			putchar('\n');
+		}
+		p = rend;
+	}
+	goto done;
+
+damaged:
+	/* the server may be writing the end of the file right now */
+	fprintf(stderr, "pbs_acctread: %s: damaged or incomplete record at offset %lld\n",
+		path, (long long) (p - data));
+	rc = 1;
+done:
+	munmap((void *) data, sb.st_size);
+	return rc;
+}
+
+/**
+ * @brief
+ *	main - the entry point of pbs_acctread
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - a file could not be read
+ * @retval	2 - usage error
+ */
+int
+main(int argc, char *argv[])
+{
+	int c;
+	int i;
+	int rc = 0;
+	int errflg = 0;
+	int header = 0;
+	char *fields = NULL;
+	char *tok;
+	char *save;
+	char today[MAXPATHLEN + 1];
+	time_t now;
+	struct tm ltm;
+	static char obuf[1 << 20];
+
+	/*the real deal or output pbs_version and exit?*/
+	PRINT_VERSION_AND_EXIT(argc, argv);
+
+	while ((c = getopt(argc, argv, "f:Hs:t:")) != EOF) {
+		switch (c) {
+			case 'f':
+				fields = optarg;
+				break;
+			case 'H':
+				header = 1;
+				break;
+			case 's':
+				if (strlen(optarg) != 1) {
+					fprintf(stderr, "pbs_acctread: separator must be one character\n");
+					errflg++;
+				}
+				sep = *optarg;
+				break;
+			case 't':
+				types = optarg;
+				break;
+			default:
+				errflg++;
+				break;
+		}
+	}
+	if (errflg || (header && (fields == NULL))) {
+		fprintf(stderr, "usage: pbs_acctread [-t types] [-f field[,field...] [-H] [-s separator]] [file...]\n");
+		fprintf(stderr, "       pbs_acctread --version\n");
+		exit(2);
+	}
+
+	if (fields != NULL) {
+		for (tok = strtok_r(fields, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+			if ((cols = realloc(cols, (ncols + 1) * sizeof(char *))) == NULL) {
+				fprintf(stderr, "pbs_acctread: out of memory\n");
+				exit(1);
+			}
+			cols[ncols++] = tok;
+		}
+		if ((ncols == 0) || ((colvals = calloc(ncols, sizeof(struct value))) == NULL)) {
+			fprintf(stderr, "pbs_acctread: %s\n", ncols ? "out of memory" : "no fields given");
+			exit(ncols ? 1 : 2);
+		}
+	}
+
+	setvbuf(stdout, obuf, _IOFBF, sizeof(obuf));
+	if (header) {
+		for (i = 0; i < ncols; i++) {
+			if (i > 0)
+				putchar(sep);
+			print_csv(cols[i], strlen(cols[i]));
+		}
+		putchar('\n');
+	}
+
+	if (optind < argc) {
+		for (; optind < argc; optind++)
+			rc |= read_file(argv[optind]);
+	} else {
+		/* the binary file of today's accounting file */
+		if (pbs_loadconf(0) == 0) {
+			fprintf(stderr, "pbs_acctread: cannot read the PBS configuration\n");
+			exit(1);
+		}
+		now = time(NULL);
+		localtime_r(&now, &ltm);
+		snprintf(today, sizeof(today), "%s/server_priv/accounting/%04d%02d%02d%s",
+			pbs_conf.pbs_home_path, ltm.tm_year + 1900, ltm.tm_mon + 1,
+			ltm.tm_mday, ACCT_BIN_SUFFIX);
+		rc = read_file(today);
+	}
+
+	if (fflush(stdout) != 0) {
+		fprintf(stderr, "pbs_acctread: cannot write output: %s\n", strerror(errno));
+		rc = 1;
+	}
+	return rc;
+}
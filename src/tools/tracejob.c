@@ -46,7 +46,9 @@
  * Functions included are:
  * 	get_cols()
  * 	main()
- * 	parse_log()
+ * 	parse_log_line()
+ * 	scan_log_files()
+ * 	build_log_index()
  * 	sort_by_date()
  * 	sort_by_message()
  * 	strip_path()
@@ -60,15 +62,28 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <termios.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 #if defined(HAVE_SYS_IOCTL_H)
 #include <sys/ioctl.h>
 #endif
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#include <zlib.h>
+#ifdef PBS_COMPRESSION_ZSTD
+#include <zstd.h>
+#endif
 #include "cmds.h"
 #include "pbs_version.h"
 #include "pbs_ifl.h"
@@ -127,9 +142,14 @@ int
 main(int argc, char *argv[])
 {
 	/* Array for the log entries for the specified job */
-	FILE *fp;
-	int i, j;
+	int i, j, k;
 	char *filename;		/* full path of logfile to read */
+	struct log_file *files;	/* log files to read */
+	int nfiles = 0;
+	int nthreads = 1;	/* most log files to read at once */
+	char build_index = 0;
+	char *line;
+	char *next;
 	struct tm *tm_ptr;
 	int    month, day, year;
 	time_t t, t_save;
@@ -164,7 +184,12 @@ main(int argc, char *argv[])
 
 	pbs_loadconf(0);
 
-	while ((c = getopt(argc, argv, "zvamslw:p:n:f:c:-:")) != EOF) {
+#ifdef _SC_NPROCESSORS_ONLN
+	if ((nthreads = sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+		nthreads = 1;
+#endif
+
+	while ((c = getopt(argc, argv, "zvamslxw:p:n:f:c:t:-:")) != EOF) {
 		switch (c) {
 			case 'v':
 				verbose = 1;
@@ -190,6 +215,16 @@ main(int argc, char *argv[])
 				filter_excessive = filter_excessive ? 0 : 1;
 				break;
 
+			case 'x':
+				build_index = 1;
+				break;
+
+			case 't':
+				nthreads = strtol(optarg, &endp, 10);
+				if (*endp != '\0' || nthreads < 1)
+					error = 1;
+				break;
+
 			case 'c':
 				excessive_count = strtol(optarg, &endp, 10);
 				if (*endp != '\0')
@@ -255,9 +290,12 @@ main(int argc, char *argv[])
 
 
 	/* no jobs */
-	if (error || argc == optind) {
+	if (error || (argc == optind && !build_index)) {
 		printf(
-			"USAGE: %s [-a|s|l|m|v] [-w size] [-p path] [-n days] [-f filter_type] job_identifier...\n",
+			"USAGE: %s [-a|s|l|m|v] [-w size] [-p path] [-n days] [-f filter_type] [-t threads] job_identifier...\n",
+			strip_path(argv[0]));
+		printf(
+			"       %s -x [-a|s|l|m|v] [-p path] [-n days]\n",
 			strip_path(argv[0]));
 
 		printf(
@@ -273,6 +311,8 @@ main(int argc, char *argv[])
 			"   -s : don't use server log files\n"
 			"   -l : don't use scheduler log files\n"
 			"   -m : don't use mom log files\n"
+			"   -t : number of log files to read at once [default number of cpus]\n"
+			"   -x : index the job ids of the log files of the days before today\n"
 			"   -v : verbose mode - show more error messages\n");
 
 		printf("\n       %s --version\n", strip_path(argv[0]));
@@ -293,37 +333,83 @@ main(int argc, char *argv[])
 	time(&t);
 	t_save = t;
 
-	for (opt = optind; opt < argc; opt++) {
-		ll_cur_amm = 0;	/* reset line count to zero */
-		for (i = 0, t = t_save; i < number_of_days; i++, t -= SECONDS_IN_DAY) {
+	/* index the logs of the days before today, which are no longer written */
+	if (build_index) {
+		for (i = 1, t = t_save - SECONDS_IN_DAY; i <= number_of_days; i++, t -= SECONDS_IN_DAY) {
 			tm_ptr = localtime(&t);
-			month = tm_ptr->tm_mon;
-			day = tm_ptr->tm_mday;
-			year = tm_ptr->tm_year;
-
 			for (j = 0; j < 4; j++) {
 				if ((j == IND_ACCT && no_acct) || (j == IND_SERVER && no_svr) ||
 					(j == IND_MOM && no_mom)   || (j == IND_SCHED && no_schd))
 					continue;
-
 #ifdef NAS /* localmod 022 */
-				filename = log_path(prefix_path, j, 1, month, day, year);
-				if (stat(filename, &sbuf) == -1) {
-					filename = log_path(prefix_path, j, 0, month, day, year);
+				filename = log_path(prefix_path, j, 0, tm_ptr->tm_mon, tm_ptr->tm_mday, tm_ptr->tm_year);
+#else
+				filename = log_path(prefix_path, j, tm_ptr->tm_mon, tm_ptr->tm_mday, tm_ptr->tm_year);
+#endif /* localmod 022 */
+				if (build_log_index(filename, j) != 0 && (verbose || errno != ENOENT)) {
+					perror(filename);
+					if (errno != ENOENT)
+						error = 1;
 				}
+			}
+		}
+		return error;
+	}
+
+	if ((files = calloc(number_of_days * 4, sizeof(struct log_file))) == NULL) {
+		perror("Error allocating memory");
+		exit(1);
+	}
+	for (i = 0; i < number_of_days; i++, t -= SECONDS_IN_DAY) {
+		tm_ptr = localtime(&t);
+		month = tm_ptr->tm_mon;
+		day = tm_ptr->tm_mday;
+		year = tm_ptr->tm_year;
+
+		for (j = 0; j < 4; j++) {
+			if ((j == IND_ACCT && no_acct) || (j == IND_SERVER && no_svr) ||
+				(j == IND_MOM && no_mom)   || (j == IND_SCHED && no_schd))
+				continue;
+
+#ifdef NAS /* localmod 022 */
+			filename = log_path(prefix_path, j, 1, month, day, year);
+			if (stat(filename, &sbuf) == -1) {
+				filename = log_path(prefix_path, j, 0, month, day, year);
+			}
 #else
-				filename = log_path(prefix_path, j, month, day, year);
+			filename = log_path(prefix_path, j, month, day, year);
 #endif /* localmod 022 */
 
-				if ((fp = fopen(filename, "r")) == NULL) {
-					if (verbose)
-						perror(filename);
-					continue;
-				}
+			files[nfiles].path = strdup(filename);
+			files[nfiles].ind = j;
+			files[nfiles].hits = calloc(argc - optind, sizeof(struct log_hits));
+			if (files[nfiles].path == NULL || files[nfiles].hits == NULL) {
+				perror("Error allocating memory");
+				exit(1);
+			}
+			nfiles++;
+		}
+	}
+
+	/* read each log file once for all of the jobs, several files at once */
+	scan_log_files(files, nfiles, argv + optind, argc - optind, nthreads);
+	if (verbose) {
+		for (i = 0; i < nfiles; i++) {
+			if (files[i].err) {
+				errno = files[i].err;
+				perror(files[i].path);
+			}
+		}
+	}
 
-				parse_log(fp, argv[opt], j);
+	for (opt = optind; opt < argc; opt++) {
+		ll_cur_amm = 0;	/* reset line count to zero */
+		for (i = 0; i < nfiles; i++) {
+			struct log_hits *h = &files[i].hits[opt - optind];
 
-				fclose(fp);
+			for (k = 0, line = h->lines; k < h->nlines; k++, line = next) {
+				next = line + strlen(line) + 1;
+				parse_log_line(line, argv[opt], files[i].ind, h->offsets[k]);
 			}
 		}
 
@@ -375,12 +461,13 @@ main(int argc, char *argv[])
 
 /**
  * @brief
- *		parse_log - parse out entires of a log file for a specific job
- *		    and return them in log_entry structures
+ *		parse_log_line - parse out the entry of a log line for a specific job
+ *		    and return it in a log_entry structure
  *
- * @param[in]	fp	-	the log file
+ * @param[in]	line	-	the log line, without its newline; modified
  * @param[in]	job	-	the name of the job
  * @param[in]	ind	-	which log file - index in enum index
+ * @param[in]	offset	-	where the line starts in the log file
  *
  *	@return	nothing
  *	@note
@@ -389,187 +476,845 @@ main(int argc, char *argv[])
  * @par MT-safe: No
  */
 void
-parse_log(FILE *fp, char *job, int ind)
+parse_log_line(char *line, char *job, int ind, off_t offset)
 {
 	struct log_entry tmp;	/* temporary log entry */
-	char *buf;		/* buffer to read in from file */
-	char *tbuf;		/* temporarily hold realloc's for main buffer */
 	char job_buf[128];	/* hold the jobid and the . */
 	char *p;		/* pointer to use for strtok */
 	int field_count;	/* which field in log entry */
-	int j = 0;
 	struct tm tms;		/* used to convert date to unix date */
-	int lineno = 0;
 	int slen;
 	char *pdot;
-	int buf_size = 16384;	/* initial buffer size */
-	int break_fl = 0;
-
-	buf = (char*)calloc(buf_size, sizeof(char));
-	if (!buf)
-		return;
 
 	tms.tm_isdst = -1;	/* mktime() will attempt to figure it out */
 
-	strcpy(job_buf, job);
+	snprintf(job_buf, sizeof(job_buf), "%s", job);
 
-	while (fgets(buf, buf_size, fp) != NULL) {
-		while (buf_size == (strlen(buf) + 1)) {
-			buf_size *= 2;
-			tbuf = (char*)realloc(buf, (buf_size + 1) * sizeof(char));
-			if (!tbuf) {
-				break_fl = 1;
+	p = strtok(line, ";");
+	field_count = 0;
+	memset(&tmp, 0, sizeof(struct log_entry));
+
+	for (field_count = 0; field_count < 6 && p != NULL; field_count++) {
+		switch (field_count) {
+			case FLD_DATE:
+				tmp.date = p;
+				if (ind == IND_ACCT)
+					field_count = 2;
 				break;
-			}
-			buf = tbuf;
-			if(fgets(buf + strlen(buf), buf_size/2 + 1, fp) == NULL) {
-				break_fl = 1;
+
+			case FLD_EVENT:
+				tmp.event = p;
+				break;
+
+			case FLD_OBJ:
+				tmp.obj = p;
 				break;
+
+			case FLD_TYPE:
+				tmp.type = p;
+				break;
+
+			case FLD_NAME:
+				tmp.name = p;
+				break;
+
+			case FLD_MSG:
+				tmp.msg = p;
+				break;
+
+			default:
+				printf("Field count too big!\n");
+				printf("%s\n", p);
+		}
+
+		p = strtok(NULL, ";");
+	}
+
+	pdot = strchr(job_buf, (int)'.');
+	if (pdot == NULL && tmp.name != NULL) {
+		int	tlen = strlen(job_buf);
+
+		slen = strcspn(tmp.name, ".");
+		if (tlen > slen)
+			slen = tlen;
+	} else
+		slen = strlen(job_buf);
+
+	if (tmp.name != NULL && strncmp(job_buf, tmp.name, slen) == 0) {
+		if (ll_cur_amm >= ll_max_amm)
+			alloc_more_space();
+
+		free_log_entry(&log_lines[ll_cur_amm]);
+
+		if (tmp.date != NULL) {
+			/*
+			 * We need to parse the time string.
+			 * The string will either have high res logging or not.
+			 * The high res logging is after the dot after the seconds field.
+			 */
+			log_lines[ll_cur_amm].date = strdup(tmp.date);
+			if ((ind != IND_ACCT) && (strchr(tmp.date, '.'))) {
+				/* Parse time string looking for high res logging.  If we don't parse 7 fields, we have a invalid log time. */
+				if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d.%ld", &tms.tm_mon,
+				    &tms.tm_mday, &tms.tm_year, &tms.tm_hour, &tms.tm_min,
+				    &tms.tm_sec, &(log_lines[ll_cur_amm].highres)) != 7) {
+					log_lines[ll_cur_amm].date_time = -1;	/* error in date field */
+					log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
+				} else { /* We found all 7 fields, correctly formed time string */
+					has_high_res_timestamp = 1;
+					if (tms.tm_year > 1900)
+						tms.tm_year -= 1900;
+					/* The number of months since January,
+ 						 * in the range 0 to 11 for mktime()
+ 						 */
+					tms.tm_mon--;
+					log_lines[ll_cur_amm].date_time = mktime(&tms);
+				}
+			} else { /* Normal time string */
+				if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d", &tms.tm_mon, &tms.tm_mday,
+				    &tms.tm_year, &tms.tm_hour, &tms.tm_min, &tms.tm_sec) != 6) {
+					log_lines[ll_cur_amm].date_time = -1;	/* error in date field */
+				} else { /* We found all 6 fields, correctly formed time string */
+					if (tms.tm_year > 1900)
+						tms.tm_year -= 1900;
+					tms.tm_mon--;         /* The number of months since January, in the range 0 to 11 for mktime */
+					log_lines[ll_cur_amm].date_time = mktime(&tms);
+				}
+				log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
+
 			}
 		}
-		if (break_fl)
-			break;
-		lineno++;
-		j++;
-		buf[strlen(buf)-1] = '\0';
-		p = strtok(buf, ";");
-		field_count = 0;
-		memset(&tmp, 0, sizeof(struct log_entry));
-
-		for (field_count = 0; field_count < 6 && p != NULL; field_count++) {
-			switch (field_count) {
-				case FLD_DATE:
-					tmp.date = p;
-					if (ind == IND_ACCT)
-						field_count = 2;
-					break;
+		if (tmp.event != NULL)
+			log_lines[ll_cur_amm].event = strdup(tmp.event);
+		else
+			log_lines[ll_cur_amm].event = none;
+		if (tmp.obj != NULL)
+			log_lines[ll_cur_amm].obj = strdup(tmp.obj);
+		else
+			log_lines[ll_cur_amm].obj = none;
+		if (tmp.type != NULL)
+			log_lines[ll_cur_amm].type = strdup(tmp.type);
+		else
+			log_lines[ll_cur_amm].type = none;
+		if (tmp.name != NULL)
+			log_lines[ll_cur_amm].name = strdup(tmp.name);
+		else
+			log_lines[ll_cur_amm].name = none;
+		if (tmp.msg != NULL)
+			log_lines[ll_cur_amm].msg = strdup(tmp.msg);
+		else
+			log_lines[ll_cur_amm].msg = none;
+		switch (ind) {
+			case IND_SERVER:
+				log_lines[ll_cur_amm].log_file = 'S';
+				break;
 
-				case FLD_EVENT:
-					tmp.event = p;
-					break;
+			case IND_SCHED:
+				log_lines[ll_cur_amm].log_file = 'L';
+				break;
 
-				case FLD_OBJ:
-					tmp.obj = p;
-					break;
+			case IND_ACCT:
+				log_lines[ll_cur_amm].log_file = 'A';
+				break;
 
-				case FLD_TYPE:
-					tmp.type = p;
-					break;
+			case IND_MOM:
+				log_lines[ll_cur_amm].log_file = 'M';
+				break;
+			default:
+				log_lines[ll_cur_amm].log_file = 'U';	/* undefined */
+		}
+		log_lines[ll_cur_amm].offset = offset;
+		ll_cur_amm++;
+	}
+}
 
-				case FLD_NAME:
-					tmp.name = p;
-					break;
+/**
+ * @brief
+ *		find_str - find the first occurrence of a string in a buffer
+ *
+ * @param[in]	hay	-	the buffer
+ * @param[in]	hlen	-	length of the buffer
+ * @param[in]	needle	-	the string to find
+ * @param[in]	nlen	-	length of the string
+ *
+ * @return	pointer to the occurrence, NULL if there is none
+ */
+static const char *
+find_str(const char *hay, size_t hlen, const char *needle, size_t nlen)
+{
+#ifdef HAVE_MEMMEM
+	return memmem(hay, hlen, needle, nlen);
+#else
+	const char *end = hay + hlen;
+	const char *p = hay;
+
+	if (nlen == 0)
+		return hay;
+	while (end - p >= (ptrdiff_t) nlen && (p = memchr(p, needle[0], end - p - nlen + 1)) != NULL) {
+		if (memcmp(p, needle, nlen) == 0)
+			return p;
+		p++;
+	}
+	return NULL;
+#endif
+}
 
-				case FLD_MSG:
-					tmp.msg = p;
-					break;
+/**
+ * @brief
+ *		add_hit - keep a copy of a log line that mentions a job
+ *
+ * @param[in,out]	h	-	the lines kept for the job
+ * @param[in]	line	-	the line, without its newline
+ * @param[in]	len	-	length of the line
+ * @param[in]	offset	-	where the line starts in the log file
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+add_hit(struct log_hits *h, const char *line, size_t len, off_t offset)
+{
+	if (h->len + len + 1 > h->size) {
+		size_t sz = h->size ? h->size * 2 : 4096;
+		char *p;
+
+		while (sz < h->len + len + 1)
+			sz *= 2;
+		if ((p = realloc(h->lines, sz)) == NULL)
+			return -1;
+		h->lines = p;
+		h->size = sz;
+	}
+	if (h->nlines >= h->maxlines) {
+		int n = h->maxlines ? h->maxlines * 2 : 64;
+		off_t *p;
+
+		if ((p = realloc(h->offsets, n * sizeof(off_t))) == NULL)
+			return -1;
+		h->offsets = p;
+		h->maxlines = n;
+	}
+	memcpy(h->lines + h->len, line, len);
+	h->lines[h->len + len] = '\0';
+	h->len += len + 1;
+	h->offsets[h->nlines++] = offset;
+	return 0;
+}
+
+/**
+ * @brief
+ *		scan_lines - keep the lines of a buffer that mention any of the jobs.
+ *		    Only lines containing a job id as is can name the job, so the
+ *		    buffer is searched for the ids rather than split into lines.
+ *
+ * @param[in,out]	lf	-	the log file the buffer is from
+ * @param[in]	buf	-	whole lines of the log file
+ * @param[in]	len	-	length of buf
+ * @param[in]	base	-	where buf starts in the log file
+ * @param[in]	jobs	-	ids of the jobs
+ * @param[in]	njobs	-	number of jobs
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+scan_lines(struct log_file *lf, const char *buf, size_t len, off_t base, char **jobs, int njobs)
+{
+	const char *end = buf + len;
+	const char *p;
+	const char *ls;
+	const char *le;
+	int j;
+
+	for (j = 0; j < njobs; j++) {
+		size_t jlen = strlen(jobs[j]);
+
+		p = buf;
+		while ((p = find_str(p, end - p, jobs[j], jlen)) != NULL) {
+			for (ls = p; ls > buf && ls[-1] != '\n'; ls--)
+				;
+			if ((le = memchr(p, '\n', end - p)) == NULL)
+				le = end;
+			if (add_hit(&lf->hits[j], ls, le - ls, base + (ls - buf)) != 0)
+				return -1;
+			if (le == end)
+				break;
+			p = le + 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *		scan_stream - scan a log file read through a buffer, for logs that
+ *		    have to be decompressed or cannot be mapped
+ *
+ * @param[in,out]	lf	-	the log file
+ * @param[in]	rd	-	reads up to n bytes into buf, returns the number
+ *				read, 0 at the end, -1 on error
+ * @param[in]	h	-	handle passed to rd
+ * @param[in]	jobs	-	ids of the jobs
+ * @param[in]	njobs	-	number of jobs
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: error
+ */
+static int
+scan_stream(struct log_file *lf, int (*rd)(void *h, char *buf, size_t n), void *h, char **jobs, int njobs)
+{
+	size_t size = SCAN_CHUNK;
+	size_t have = 0;
+	size_t used;
+	off_t base = 0;
+	char *buf;
+	char *p;
+	int r;
+	int rc = 0;
 
-				default:
-					printf("Field count too big!\n");
-					printf("%s\n", p);
+	if ((buf = malloc(size)) == NULL)
+		return -1;
+
+	for (;;) {
+		if ((r = rd(h, buf + have, size - have)) < 0) {
+			rc = -1;
+			break;
+		}
+		have += r;
+
+		/* scan whole lines only, the rest is scanned with the next read */
+		if (r == 0)
+			used = have;
+		else {
+			for (used = have; used > 0 && buf[used - 1] != '\n'; used--)
+				;
+		}
+		if (used > 0 && scan_lines(lf, buf, used, base, jobs, njobs) != 0) {
+			rc = -1;
+			break;
+		}
+		if (r == 0)
+			break;
+		memmove(buf, buf + used, have - used);
+		have -= used;
+		base += used;
+
+		/* a line longer than the buffer */
+		if (have == size) {
+			if ((p = realloc(buf, size * 2)) == NULL) {
+				rc = -1;
+				break;
 			}
+			buf = p;
+			size *= 2;
+		}
+	}
+	free(buf);
+	return rc;
+}
+
+/**
+ * @brief
+ *		read_fd - read from a plain log file, for scan_stream()
+ */
+static int
+read_fd(void *h, char *buf, size_t n)
+{
+	int r;
+
+	while ((r = read(*(int *) h, buf, n)) == -1 && errno == EINTR)
+		;
+	return r;
+}
 
-			p = strtok(NULL, ";");
+/**
+ * @brief
+ *		read_gz - read from a gzip compressed log file, for scan_stream()
+ */
+static int
+read_gz(void *h, char *buf, size_t n)
+{
+	return gzread((gzFile) h, buf, n);
+}
+
+#ifdef PBS_COMPRESSION_ZSTD
+/* state of reading a zstd compressed log file */
+struct zstd_reader {
+	int fd;
+	ZSTD_DStream *ds;
+	char *in;
+	ZSTD_inBuffer ib;
+	int eof;
+};
+
+/**
+ * @brief
+ *		read_zstd - read from a zstd compressed log file, for scan_stream()
+ */
+static int
+read_zstd(void *h, char *buf, size_t n)
+{
+	struct zstd_reader *zr = h;
+	ZSTD_outBuffer ob = {buf, n, 0};
+	size_t ret;
+	int r;
+
+	while (ob.pos == 0) {
+		if (zr->ib.pos == zr->ib.size && !zr->eof) {
+			if ((r = read_fd(&zr->fd, zr->in, ZSTD_DStreamInSize())) < 0)
+				return -1;
+			if (r == 0)
+				zr->eof = 1;
+			zr->ib.src = zr->in;
+			zr->ib.size = r;
+			zr->ib.pos = 0;
 		}
+		ret = ZSTD_decompressStream(zr->ds, &ob, &zr->ib);
+		if (ZSTD_isError(ret))
+			return -1;
+		if (ob.pos == 0 && zr->eof && zr->ib.pos == zr->ib.size)
+			break;
+	}
+	return ob.pos;
+}
 
-		pdot = strchr(job_buf, (int)'.');
-		if (pdot == NULL && tmp.name != NULL) {
-			int	tlen = strlen(job_buf);
+/**
+ * @brief
+ *		scan_zstd - scan a zstd compressed log file
+ *
+ * @param[in,out]	lf	-	the log file
+ * @param[in]	fd	-	the open compressed file
+ * @param[in]	jobs	-	ids of the jobs
+ * @param[in]	njobs	-	number of jobs
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: error
+ */
+static int
+scan_zstd(struct log_file *lf, int fd, char **jobs, int njobs)
+{
+	struct zstd_reader zr;
+	int rc = -1;
+
+	memset(&zr, 0, sizeof(zr));
+	zr.fd = fd;
+	if ((zr.ds = ZSTD_createDStream()) != NULL &&
+		!ZSTD_isError(ZSTD_initDStream(zr.ds)) &&
+		(zr.in = malloc(ZSTD_DStreamInSize())) != NULL)
+		rc = scan_stream(lf, read_zstd, &zr, jobs, njobs);
+	free(zr.in);
+	if (zr.ds != NULL)
+		ZSTD_freeDStream(zr.ds);
+	return rc;
+}
+#endif
 
-			slen = strcspn(tmp.name, ".");
-			if (tlen > slen)
-				slen = tlen;
-		} else
-			slen = strlen(job_buf);
-
-		if (tmp.name != NULL && strncmp(job_buf, tmp.name, slen) == 0) {
-			if (ll_cur_amm >= ll_max_amm)
-				alloc_more_space();
-
-			free_log_entry(&log_lines[ll_cur_amm]);
-
-			if (tmp.date != NULL) {
-				/*
-				 * We need to parse the time string.
-				 * The string will either have high res logging or not.
-				 * The high res logging is after the dot after the seconds field.
-				 */
-				log_lines[ll_cur_amm].date = strdup(tmp.date);
-				if ((ind != IND_ACCT) && (strchr(tmp.date, '.'))) {
-					/* Parse time string looking for high res logging.  If we don't parse 7 fields, we have a invalid log time. */
-					if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d.%ld", &tms.tm_mon,
-					    &tms.tm_mday, &tms.tm_year, &tms.tm_hour, &tms.tm_min,
-					    &tms.tm_sec, &(log_lines[ll_cur_amm].highres)) != 7) {
-						log_lines[ll_cur_amm].date_time = -1;	/* error in date field */
-						log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
-					} else { /* We found all 7 fields, correctly formed time string */
-						has_high_res_timestamp = 1;
-						if (tms.tm_year > 1900)
-							tms.tm_year -= 1900;
-						/* The number of months since January,
- 						 * in the range 0 to 11 for mktime()
- 						 */
-						tms.tm_mon--;
-						log_lines[ll_cur_amm].date_time = mktime(&tms);
-					}
-				} else { /* Normal time string */
-					if (sscanf(tmp.date, "%d/%d/%d %d:%d:%d", &tms.tm_mon, &tms.tm_mday,
-					    &tms.tm_year, &tms.tm_hour, &tms.tm_min, &tms.tm_sec) != 6) {
-						log_lines[ll_cur_amm].date_time = -1;	/* error in date field */
-					} else { /* We found all 6 fields, correctly formed time string */
-						if (tms.tm_year > 1900)
-							tms.tm_year -= 1900;
-						tms.tm_mon--;         /* The number of months since January, in the range 0 to 11 for mktime */
-						log_lines[ll_cur_amm].date_time = mktime(&tms);
-					}
-					log_lines[ll_cur_amm].highres = NO_HIGH_RES_TIMESTAMP;
+/**
+ * @brief
+ *		map_file - map a whole file into memory for reading
+ *
+ * @param[in]	fd	-	the open file
+ * @param[out]	len	-	length of the file
+ *
+ * @return	the mapping, NULL if the file is empty or cannot be mapped
+ */
+static char *
+map_file(int fd, size_t *len)
+{
+#ifdef HAVE_MMAP
+	struct stat sb;
+	void *p;
+
+	if (fstat(fd, &sb) == -1 || sb.st_size == 0)
+		return NULL;
+	p = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED)
+		return NULL;
+#ifdef MADV_SEQUENTIAL
+	(void) madvise(p, sb.st_size, MADV_SEQUENTIAL);
+#endif
+	*len = sb.st_size;
+	return p;
+#else
+	return NULL;
+#endif
+}
 
-				}
+/**
+ * @brief
+ *		unmap_file - undo map_file()
+ */
+static void
+unmap_file(char *data, size_t len)
+{
+#ifdef HAVE_MMAP
+	if (data != NULL)
+		munmap(data, len);
+#endif
+}
+
+/**
+ * @brief
+ *		scan_indexed - take the lines of the jobs from a mapped log file
+ *		    through the job id index written by build_log_index(), if
+ *		    there is one and it is up to date
+ *
+ * @param[in,out]	lf	-	the log file
+ * @param[in]	data	-	the mapped log file
+ * @param[in]	len	-	length of the log file
+ * @param[in]	jobs	-	ids of the jobs
+ * @param[in]	njobs	-	number of jobs
+ *
+ * @return	int
+ * @retval	1	: the lines were taken through the index
+ * @retval	0	: there is no usable index
+ * @retval	-1	: out of memory
+ */
+static int
+scan_indexed(struct log_file *lf, const char *data, size_t len, char **jobs, int njobs)
+{
+	char path[MAXPATHLEN + 1];
+	char *idx;
+	size_t ilen = 0;
+	const char *p;
+	const char *le;
+	const char *iend;
+	char *endp;
+	char *key;
+	int fd;
+	int j;
+	int rc = 1;
+
+	snprintf(path, sizeof(path), "%s%s", lf->path, LOG_INDEX_SUFFIX);
+	if ((fd = open(path, O_RDONLY)) == -1)
+		return 0;
+	idx = map_file(fd, &ilen);
+	close(fd);
+	if (idx == NULL)
+		return 0;
+	iend = idx + ilen;
+
+	/* the index covers the log as it was when indexed */
+	if (ilen < sizeof(LOG_INDEX_MAGIC) || idx[ilen - 1] != '\n' || strncmp(idx, LOG_INDEX_MAGIC " ", sizeof(LOG_INDEX_MAGIC)) != 0 ||
+		strtoll(idx + sizeof(LOG_INDEX_MAGIC), &endp, 10) != (long long) len || *endp != '\n') {
+		unmap_file(idx, ilen);
+		return 0;
+	}
+
+	/* each line is "<name> <offset>,<offset>...", names sorted */
+	for (j = 0; j < njobs && rc == 1; j++) {
+		size_t klen = strlen(jobs[j]) + 1;
+
+		if ((key = malloc(klen + 1)) == NULL) {
+			rc = -1;
+			break;
+		}
+		key[0] = '\n';
+		strcpy(key + 1, jobs[j]);
+		p = idx;
+		while (rc == 1 && (p = find_str(p, iend - p, key, klen)) != NULL) {
+			p++;
+			le = memchr(p, '\n', iend - p);
+			if ((p = memchr(p, ' ', le - p)) == NULL) {
+				p = le;
+				continue;
 			}
-			if (tmp.event != NULL)
-				log_lines[ll_cur_amm].event = strdup(tmp.event);
-			else
-				log_lines[ll_cur_amm].event = none;
-			if (tmp.obj != NULL)
-				log_lines[ll_cur_amm].obj = strdup(tmp.obj);
-			else
-				log_lines[ll_cur_amm].obj = none;
-			if (tmp.type != NULL)
-				log_lines[ll_cur_amm].type = strdup(tmp.type);
-			else
-				log_lines[ll_cur_amm].type = none;
-			if (tmp.name != NULL)
-				log_lines[ll_cur_amm].name = strdup(tmp.name);
-			else
-				log_lines[ll_cur_amm].name = none;
-			if (tmp.msg != NULL)
-				log_lines[ll_cur_amm].msg = strdup(tmp.msg);
-			else
-				log_lines[ll_cur_amm].msg = none;
-			switch (ind) {
-				case IND_SERVER:
-					log_lines[ll_cur_amm].log_file = 'S';
-					break;
+			for (p++; rc == 1; p = endp + 1) {
+				long long off = strtoll(p, &endp, 10);
+				const char *ls;
+				const char *lend;
 
-				case IND_SCHED:
-					log_lines[ll_cur_amm].log_file = 'L';
+				if (endp == p || off < 0 || (size_t) off >= len)
 					break;
-
-				case IND_ACCT:
-					log_lines[ll_cur_amm].log_file = 'A';
+				ls = data + off;
+				if ((lend = memchr(ls, '\n', len - off)) == NULL)
+					lend = data + len;
+				if (add_hit(&lf->hits[j], ls, lend - ls, off) != 0)
+					rc = -1;
+				if (*endp != ',')
 					break;
+			}
+			p = le;
+		}
+		free(key);
+	}
+	unmap_file(idx, ilen);
+	return rc;
+}
 
-				case IND_MOM:
-					log_lines[ll_cur_amm].log_file = 'M';
-					break;
-				default:
-					log_lines[ll_cur_amm].log_file = 'U';	/* undefined */
+/**
+ * @brief
+ *		scan_log_file - collect the lines of a log file that mention the jobs.
+ *		    A plain log is mapped and searched, or looked up in its index.
+ *		    If there is no plain log, a gzip or zstd compressed one of the
+ *		    same name is searched as it is decompressed.
+ *
+ * @param[in,out]	lf	-	the log file
+ * @param[in]	jobs	-	ids of the jobs
+ * @param[in]	njobs	-	number of jobs
+ *
+ * @return	nothing
+ * @note
+ *		sets lf->err
+ */
+static void
+scan_log_file(struct log_file *lf, char **jobs, int njobs)
+{
+	char path[MAXPATHLEN + 1];
+	char *data;
+	size_t len = 0;
+	gzFile gz;
+	int fd;
+	int rc;
+
+	if ((fd = open(lf->path, O_RDONLY)) != -1) {
+		if ((data = map_file(fd, &len)) != NULL) {
+			if ((rc = scan_indexed(lf, data, len, jobs, njobs)) == 0)
+				rc = scan_lines(lf, data, len, 0, jobs, njobs);
+			unmap_file(data, len);
+		} else
+			rc = scan_stream(lf, read_fd, &fd, jobs, njobs);
+		close(fd);
+		lf->err = (rc < 0) ? EIO : 0;
+		return;
+	}
+	lf->err = errno;
+
+	snprintf(path, sizeof(path), "%s.gz", lf->path);
+	if ((fd = open(path, O_RDONLY)) != -1) {
+		if ((gz = gzdopen(fd, "rb")) == NULL) {
+			close(fd);
+			lf->err = EIO;
+			return;
+		}
+		(void) gzbuffer(gz, SCAN_CHUNK / 4);
+		rc = scan_stream(lf, read_gz, gz, jobs, njobs);
+		gzclose(gz);
+		lf->err = (rc < 0) ? EIO : 0;
+		return;
+	}
+
+#ifdef PBS_COMPRESSION_ZSTD
+	snprintf(path, sizeof(path), "%s.zst", lf->path);
+	if ((fd = open(path, O_RDONLY)) != -1) {
+		rc = scan_zstd(lf, fd, jobs, njobs);
+		close(fd);
+		lf->err = (rc < 0) ? EIO : 0;
+	}
+#endif
+}
+
+/* work shared by the scanning threads */
+static struct log_file *scan_files;
+static int scan_nfiles;
+static int scan_next;
+static char **scan_jobs;
+static int scan_njobs;
+static pthread_mutex_t scan_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief
+ *		scan_worker - scan log files until there are none left
+ *
+ * @return	NULL
+ */
+static void *
+scan_worker(void *arg)
+{
+	int i;
+
+	for (;;) {
+		pthread_mutex_lock(&scan_mutex);
+		i = scan_next++;
+		pthread_mutex_unlock(&scan_mutex);
+		if (i >= scan_nfiles)
+			break;
+		scan_log_file(&scan_files[i], scan_jobs, scan_njobs);
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *		scan_log_files - collect the lines of the log files that mention
+ *		    the jobs, scanning several files at once
+ *
+ * @param[in,out]	files	-	the log files, each with njobs hits allocated
+ * @param[in]	nfiles	-	number of log files
+ * @param[in]	jobs	-	ids of the jobs
+ * @param[in]	njobs	-	number of jobs
+ * @param[in]	nthreads	-	most files to scan at once
+ *
+ * @return	nothing
+ */
+void
+scan_log_files(struct log_file *files, int nfiles, char **jobs, int njobs, int nthreads)
+{
+	pthread_t tids[MAX_SCAN_THREADS];
+	int nstarted = 0;
+	int i;
+
+	scan_files = files;
+	scan_nfiles = nfiles;
+	scan_next = 0;
+	scan_jobs = jobs;
+	scan_njobs = njobs;
+
+	if (nthreads > MAX_SCAN_THREADS)
+		nthreads = MAX_SCAN_THREADS;
+	if (nthreads > nfiles)
+		nthreads = nfiles;
+	for (i = 1; i < nthreads; i++) {
+		if (pthread_create(&tids[nstarted], NULL, scan_worker, NULL) != 0)
+			break;
+		nstarted++;
+	}
+	scan_worker(NULL);
+	for (i = 0; i < nstarted; i++)
+		pthread_join(tids[i], NULL);
+}
+
+/* a line of a log file to index, see build_log_index() */
+struct index_entry {
+	const char *name;	/* object name of the line */
+	int namelen;
+	off_t offset;		/* where the line starts */
+};
+
+/**
+ * @brief
+ *		cmp_index_entry - compare function for qsort.  Orders index entries
+ *		    by name, then by offset.
+ */
+static int
+cmp_index_entry(const void *v1, const void *v2)
+{
+	const struct index_entry *e1 = v1;
+	const struct index_entry *e2 = v2;
+	int n = e1->namelen < e2->namelen ? e1->namelen : e2->namelen;
+	int rc;
+
+	if ((rc = memcmp(e1->name, e2->name, n)) != 0)
+		return rc;
+	if (e1->namelen != e2->namelen)
+		return e1->namelen < e2->namelen ? -1 : 1;
+	if (e1->offset != e2->offset)
+		return e1->offset < e2->offset ? -1 : 1;
+	return 0;
+}
+
+/**
+ * @brief
+ *		build_log_index - write the job id index of a log file.  The index
+ *		    maps the id of each job or reservation in the log to where its
+ *		    lines start, so tracejob reads only those lines.  It is meant
+ *		    for logs that are no longer written to, and is ignored once the
+ *		    size of the log changes.
+ *
+ * @param[in]	path	-	path of the log file
+ * @param[in]	ind	-	which log file - index in enum index
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: error, errno is set
+ */
+int
+build_log_index(char *path, int ind)
+{
+	char ipath[MAXPATHLEN + 1];
+	char tpath[MAXPATHLEN + 1];
+	struct index_entry *ents = NULL;
+	struct index_entry *e;
+	size_t nents = 0;
+	size_t maxents = 0;
+	size_t len = 0;
+	size_t i;
+	const char *data;
+	const char *p;
+	const char *end;
+	const char *le;
+	int skip = (ind == IND_ACCT) ? 2 : 4;	/* fields before the name */
+	int fd;
+	int k;
+	FILE *fp;
+	int rc = 0;
+
+	if ((fd = open(path, O_RDONLY)) == -1)
+		return -1;
+	data = map_file(fd, &len);
+	close(fd);
+	if (data == NULL)
+		return -1;
+	end = data + len;
+
+	for (p = data; p < end; p = le + 1) {
+		const char *name;
+
+		if ((le = memchr(p, '\n', end - p)) == NULL)
+			le = end;
+		name = p;
+		for (k = 0; k < skip && name != NULL; k++) {
+			name = memchr(name, ';', le - name);
+			if (name != NULL)
+				name++;
+		}
+		if (name == NULL)
+			continue;
+		for (k = 0; name + k < le && name[k] != ';'; k++)
+			;
+		/* job and reservation ids start with a digit, or a letter and a digit */
+		if (k == 0 || !(isdigit(name[0]) || (k > 1 && isdigit(name[1]))))
+			continue;
+		if (nents >= maxents) {
+			size_t n = maxents ? maxents * 2 : 4096;
+
+			if ((e = realloc(ents, n * sizeof(struct index_entry))) == NULL) {
+				rc = -1;
+				break;
 			}
-			log_lines[ll_cur_amm].lineno = lineno;
-			ll_cur_amm++;
+			ents = e;
+			maxents = n;
 		}
+		ents[nents].name = name;
+		ents[nents].namelen = k;
+		ents[nents].offset = p - data;
+		nents++;
 	}
-	free(buf);
+
+	if (rc == 0) {
+		qsort(ents, nents, sizeof(struct index_entry), cmp_index_entry);
+
+		snprintf(ipath, sizeof(ipath), "%s%s", path, LOG_INDEX_SUFFIX);
+		snprintf(tpath, sizeof(tpath), "%s.tmp", ipath);
+		if ((fp = fopen(tpath, "w")) == NULL)
+			rc = -1;
+		else {
+			fprintf(fp, "%s %lld\n", LOG_INDEX_MAGIC, (long long) len);
+			for (i = 0; i < nents; i++) {
+				if (i == 0 || ents[i - 1].namelen != ents[i].namelen ||
+					memcmp(ents[i - 1].name, ents[i].name, ents[i].namelen) != 0) {
+					if (i > 0)
+						fputc('\n', fp);
+					fprintf(fp, "%.*s %lld", ents[i].namelen, ents[i].name, (long long) ents[i].offset);
+				} else
+					fprintf(fp, ",%lld", (long long) ents[i].offset);
+			}
+			if (nents > 0)
+				fputc('\n', fp);
+			if (fclose(fp) != 0 || rename(tpath, ipath) != 0) {
+				rc = -1;
+				(void) unlink(tpath);
+			}
+		}
+	}
+
+	free(ents);
+	unmap_file((char *) data, len);
+	return rc;
 }
 
 /**
@@ -607,9 +1352,9 @@ sort_by_date(const void *v1, const void *v2)
 		}
 
 		if (l1->log_file == l2->log_file) {
-			if (l1->lineno < l2->lineno)
+			if (l1->offset < l2->offset)
 				return -1;
-			else if (l1->lineno > l2->lineno)
+			else if (l1->offset > l2->offset)
 				return 1;
 		}
 		return 0;
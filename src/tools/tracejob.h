@@ -71,6 +71,18 @@ extern "C" {
 
 #define SECONDS_IN_DAY 86400
 
+/* most threads to scan log files with */
+#ifndef MAX_SCAN_THREADS
+#define MAX_SCAN_THREADS 16
+#endif
+
+/* size of the buffer compressed logs are scanned through */
+#define SCAN_CHUNK (4 * 1024 * 1024)
+
+/* suffix of the job id index of a log file, see build_log_index() */
+#define LOG_INDEX_SUFFIX ".idx"
+#define LOG_INDEX_MAGIC "PBS_LOGIDX 1"
+
 /* indicies into the mid_path array */
 enum index
 {
@@ -103,14 +115,36 @@ struct log_entry
 	char *name;		/* name of object */
 	char *msg;		/* log message */
 	char log_file;		/* What log file */
-	int lineno;		/* what line in the file.  used to stabilize the sort */
+	off_t offset;		/* where in the file.  used to stabilize the sort */
 	unsigned no_print:1;	/* whether or not to print the message */
 	/* A=accounting S=server M=Mom L=Scheduler */
 };
 
+/* lines of a log file that mention a job */
+struct log_hits
+{
+	char *lines;		/* the lines, each null terminated */
+	size_t len;		/* bytes used in lines */
+	size_t size;		/* bytes allocated for lines */
+	off_t *offsets;		/* where each line starts in the file */
+	int nlines;
+	int maxlines;
+};
+
+/* a log file to scan */
+struct log_file
+{
+	char *path;		/* path of the uncompressed log */
+	int ind;		/* which log file - index in enum index */
+	int err;		/* errno of opening the log, 0 if it was read */
+	struct log_hits *hits;	/* one per job being traced */
+};
+
 /* prototypes */
 int sort_by_date(const void *v1, const void *v2);
-void parse_log(FILE *fp, char *job, int act);
+void parse_log_line(char *line, char *job, int ind, off_t offset);
+void scan_log_files(struct log_file *files, int nfiles, char **jobs, int njobs, int nthreads);
+int build_log_index(char *path, int ind);
 char *strip_path(char *path);
 void free_log_entry(struct log_entry *lg);
 void line_wrap(char *line, int start, int end);
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_disbench.c
+ *
+ * @brief
+ *	Microbenchmark for the DIS encodings.
+ *
+ * @par Functionality:
+ *	Builds a status reply like the one pbs_server sends for "qstat -f"
+ *	of many jobs, then times encoding it and decoding it into the
+ *	batch_status form the commands use, once with the ASCII encoding
+ *	(DIS version 1) and once with the binary one (DIS version 2).  The
+ *	bytes go through a memory buffer instead of a socket, so only the
+ *	cost of DIS itself is measured.  The decoded reply is compared with
+ *	the one that was sent.
+ *
+ *	Usage: pbs_disbench [-n jobs]
+ */
+
+#include <pbs_config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "libpbs.h"
+#include "dis.h"
+#include "list_link.h"
+#include "attribute.h"
+#include "batch_request.h"
+#include "pbs_client_thread.h"
+
+#define BENCH_DFLT_JOBS		20000
+#define BENCH_FD		3	/* any number, no socket is used */
+
+/* attributes of every job: name, resource, value ("%d" is the job number) */
+static char *bench_attrs[][3] = {
+	{ATTR_N, NULL, "job%d"},
+	{ATTR_owner, NULL, "user%d@host.example.com"},
+	{"resources_used", "cpupercent", "%d"},
+	{"resources_used", "cput", "00:00:%02d"},
+	{"resources_used", "mem", "%dkb"},
+	{"resources_used", "ncpus", "1"},
+	{"resources_used", "vmem", "%dkb"},
+	{"resources_used", "walltime", "00:01:%02d"},
+	{ATTR_state, NULL, "R"},
+	{ATTR_queue, NULL, "workq"},
+	{ATTR_server, NULL, "pbsserver"},
+	{ATTR_ctime, NULL, "16%08d"},
+	{ATTR_exechost, NULL, "node%d/0"},
+	{ATTR_l, "ncpus", "1"},
+	{ATTR_l, "nodect", "1"},
+	{ATTR_l, "place", "pack"},
+	{ATTR_l, "select", "1:ncpus=1"},
+	{ATTR_l, "walltime", "01:00:00"},
+	{ATTR_stime, NULL, "16%08d"},
+	{ATTR_session, NULL, "%d"},
+};
+#define BENCH_NATTRS	(sizeof(bench_attrs) / sizeof(bench_attrs[0]))
+
+static pbs_tcp_chan_t *bench_chan;
+
+/* the "wire", what is sent is appended and read back from the front */
+static char *wire_data;
+static size_t wire_size;
+static size_t wire_len;
+static size_t wire_pos;
+
+/**
+ * @brief
+ *	Return the current time in seconds as a double
+ *
+ * @return - current time
+ */
+static double
+now_secs(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/**
+ * @brief
+ *	Transport functions for DIS, backed by the wire buffer
+ */
+static pbs_tcp_chan_t *
+bench_get_chan(int fd)
+{
+	return bench_chan;
+}
+
+static int
+bench_set_chan(int fd, pbs_tcp_chan_t *chan)
+{
+	bench_chan = chan;
+	return 0;
+}
+
+static int
+bench_send(int fd, void *data, int len)
+{
+	if (wire_len + len > wire_size) {
+		size_t size = (wire_len + len) * 2;
+		char *p = realloc(wire_data, size);
+
+		if (p == NULL)
+			return -1;
+		wire_data = p;
+		wire_size = size;
+	}
+	memcpy(wire_data + wire_len, data, len);
+	wire_len += len;
+	return len;
+}
+
+static int
+bench_recv(int fd, void *data, int len)
+{
+	if (wire_pos >= wire_len)
+		return -2;
+	if (len > wire_len - wire_pos)
+		len = wire_len - wire_pos;
+	memcpy(data, wire_data + wire_pos, len);
+	wire_pos += len;
+	return len;
+}
+
+/**
+ * @brief
+ *	Build the status reply for njobs jobs
+ *
+ * @param[out] reply - the reply
+ * @param[in] njobs - number of jobs
+ *
+ * @return	Error code
+ * @retval	 0 - Success
+ * @retval	 1 - Failure
+ */
+static int
+build_reply(struct batch_reply *reply, int njobs)
+{
+	struct brp_status *pstat;
+	svrattrl *psvrl;
+	char value[64];
+	int i;
+	int j;
+
+	memset(reply, 0, sizeof(*reply));
+	reply->brp_choice = BATCH_REPLY_CHOICE_Status;
+	CLEAR_HEAD(reply->brp_un.brp_status);
+	for (i = 0; i < njobs; i++) {
+		if ((pstat = calloc(1, sizeof(struct brp_status))) == NULL)
+			return 1;
+		CLEAR_LINK(pstat->brp_stlink);
+		CLEAR_HEAD(pstat->brp_attr);
+		pstat->brp_objtype = MGR_OBJ_JOB;
+		snprintf(pstat->brp_objname, sizeof(pstat->brp_objname), "%d.pbsserver", i);
+		for (j = 0; j < BENCH_NATTRS; j++) {
+			if ((psvrl = calloc(1, sizeof(svrattrl))) == NULL)
+				return 1;
+			CLEAR_LINK(psvrl->al_link);
+			snprintf(value, sizeof(value), bench_attrs[j][2], i % 100000);
+			psvrl->al_atopl.name = bench_attrs[j][0];
+			psvrl->al_atopl.resource = bench_attrs[j][1];
+			psvrl->al_atopl.value = strdup(value);
+			psvrl->al_rescln = bench_attrs[j][1] ? strlen(bench_attrs[j][1]) + 1 : 0;
+			if (psvrl->al_atopl.value == NULL)
+				return 1;
+			append_link(&pstat->brp_attr, &psvrl->al_link, psvrl);
+		}
+		append_link(&reply->brp_un.brp_status, &pstat->brp_stlink, pstat);
+		reply->brp_count++;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Check a decoded reply against the one that was sent
+ *
+ * @param[in] sent - the reply that was encoded
+ * @param[in] got - the reply that was decoded
+ *
+ * @return	Error code
+ * @retval	 0 - Same
+ * @retval	 1 - Different
+ */
+static int
+check_reply(struct batch_reply *sent, struct batch_reply *got)
+{
+	struct brp_status *pstat;
+	struct batch_status *bs;
+	struct attrl *pal;
+	svrattrl *psvrl;
+
+	if (got->brp_choice != BATCH_REPLY_CHOICE_Status || got->brp_count != sent->brp_count)
+		return 1;
+	pstat = (struct brp_status *) GET_NEXT(sent->brp_un.brp_status);
+	for (bs = got->brp_un.brp_statc; bs != NULL; bs = bs->next) {
+		if (pstat == NULL || strcmp(bs->name, pstat->brp_objname) != 0)
+			return 1;
+		psvrl = (svrattrl *) GET_NEXT(pstat->brp_attr);
+		for (pal = bs->attribs; pal != NULL; pal = pal->next) {
+			if (psvrl == NULL ||
+				strcmp(pal->name, psvrl->al_atopl.name) != 0 ||
+				strcmp(pal->value, psvrl->al_atopl.value) != 0 ||
+				strcmp(pal->resource ? pal->resource : "",
+				psvrl->al_atopl.resource ? psvrl->al_atopl.resource : "") != 0)
+				return 1;
+			psvrl = (svrattrl *) GET_NEXT(psvrl->al_link);
+		}
+		if (psvrl != NULL)
+			return 1;
+		pstat = (struct brp_status *) GET_NEXT(pstat->brp_stlink);
+	}
+	return (pstat != NULL);
+}
+
+/**
+ * @brief
+ *	Encode and decode the reply with one DIS version
+ *
+ * @param[in] version - DIS_VERSION_1 or DIS_VERSION_2
+ * @param[in] reply - the reply
+ *
+ * @return	Error code
+ * @retval	 0 - Success
+ * @retval	 1 - Failure
+ */
+static int
+run_version(int version, struct batch_reply *reply)
+{
+	struct batch_reply got;
+	double start;
+	double enc;
+	double dec;
+	int rc;
+
+	dis_set_version(BENCH_FD, version);
+	wire_len = 0;
+	wire_pos = 0;
+
+	start = now_secs();
+	if ((rc = encode_DIS_reply(BENCH_FD, reply)) != 0 || (rc = dis_flush(BENCH_FD)) != 0) {
+		fprintf(stderr, "v%d: encode failed (%d)\n", version, rc);
+		return 1;
+	}
+	enc = now_secs() - start;
+
+	memset(&got, 0, sizeof(got));
+	start = now_secs();
+	if ((rc = decode_DIS_replyCmd(BENCH_FD, &got)) != 0) {
+		fprintf(stderr, "v%d: decode failed (%d)\n", version, rc);
+		return 1;
+	}
+	dec = now_secs() - start;
+
+	printf("v%d %10lu bytes  encode %8.3fs  decode %8.3fs  %6.1f ns/attr\n",
+		version, (unsigned long) wire_len, enc, dec,
+		(enc + dec) * 1e9 / ((double) reply->brp_count * BENCH_NATTRS));
+
+	rc = check_reply(reply, &got);
+	if (rc)
+		fprintf(stderr, "v%d: decoded reply differs from the one sent\n", version);
+	pbs_statfree(got.brp_un.brp_statc);
+	return rc;
+}
+
+int
+main(int argc, char *argv[])
+{
+	struct batch_reply reply;
+	int njobs = BENCH_DFLT_JOBS;
+	int i, rc = 0;
+
+	while ((i = getopt(argc, argv, "n:")) != EOF) {
+		switch (i) {
+			case 'n':
+				njobs = atoi(optarg);
+				break;
+			default:
+				rc = 1;
+		}
+	}
+
+	if (rc || optind != argc || njobs < 1) {
+		fprintf(stderr, "Error in usage: pbs_disbench [-n jobs]\n");
+		return 1;
+	}
+
+	if (pbs_client_thread_init_thread_context() != 0) {
+		fprintf(stderr, "Unable to initialize thread context\n");
+		return 1;
+	}
+	pfn_transport_get_chan = bench_get_chan;
+	pfn_transport_set_chan = bench_set_chan;
+	pfn_transport_recv = bench_recv;
+	pfn_transport_send = bench_send;
+	errno = 0;
+	dis_setup_chan(BENCH_FD, bench_get_chan);
+
+	if (build_reply(&reply, njobs) != 0) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	rc = run_version(DIS_VERSION_1, &reply);
+	rc |= run_version(DIS_VERSION_2, &reply);
+
+	dis_destroy_chan(BENCH_FD);
+	return rc;
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_idxbench.c
+ *
+ * @brief
+ *	Microbenchmark for the pbs_idx backends.
+ *
+ * @par Functionality:
+ *	Builds an index of job-id like string keys ("<n>.<server>") with the
+ *	tree backend and with the hash backend (PBS_IDX_HASH), then times
+ *	inserting every key, looking every key up, looking up as many absent
+ *	keys and deleting every key, and reports the cost per operation.
+ *
+ *	Usage: pbs_idxbench [-n keys] [-s server name]
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "pbs_idx.h"
+
+#define BENCH_DFLT_KEYS		1000000
+#define BENCH_DFLT_SERVER	"pbsserver"
+#define BENCH_KEYLEN		64
+
+/**
+ * @brief
+ *	Return the current time in seconds as a double
+ *
+ * @return - current time
+ */
+static double
+now_secs(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/**
+ * @brief
+ *	Print the cost of one phase
+ *
+ * @param[in] backend - name of the backend
+ * @param[in] phase - name of the phase
+ * @param[in] nops - number of operations done
+ * @param[in] start - time the phase started
+ */
+static void
+report(const char *backend, const char *phase, int nops, double start)
+{
+	double elapsed = now_secs() - start;
+
+	printf("%-5s %-8s %8d ops %8.3fs %8.1f ns/op\n", backend, phase, nops,
+		elapsed, (nops > 0) ? elapsed * 1e9 / nops : 0.0);
+}
+
+/**
+ * @brief
+ *	Run all the phases against one backend
+ *
+ * @param[in] backend - name of the backend
+ * @param[in] flags - flags for pbs_idx_create()
+ * @param[in] keys - the keys, nkeys of BENCH_KEYLEN bytes each
+ * @param[in] misses - absent keys, nkeys of BENCH_KEYLEN bytes each
+ * @param[in] nkeys - number of keys
+ *
+ * @return	Error code
+ * @retval	 0 - Success
+ * @retval	 1 - Failure
+ */
+static int
+run_backend(const char *backend, int flags, char *keys, char *misses, int nkeys)
+{
+	void *idx;
+	void *key;
+	void *data;
+	double start;
+	int i;
+	int found = 0;
+
+	if ((idx = pbs_idx_create(flags, 0)) == NULL) {
+		fprintf(stderr, "%s: pbs_idx_create failed\n", backend);
+		return 1;
+	}
+
+	start = now_secs();
+	for (i = 0; i < nkeys; i++) {
+		if (pbs_idx_insert(idx, keys + (size_t) i * BENCH_KEYLEN, keys + (size_t) i * BENCH_KEYLEN) != PBS_IDX_RET_OK) {
+			fprintf(stderr, "%s: insert failed at key %d\n", backend, i);
+			pbs_idx_destroy(idx);
+			return 1;
+		}
+	}
+	report(backend, "insert", nkeys, start);
+
+	start = now_secs();
+	for (i = 0; i < nkeys; i++) {
+		key = keys + (size_t) i * BENCH_KEYLEN;
+		if (pbs_idx_find(idx, &key, &data, NULL) == PBS_IDX_RET_OK && data == key)
+			found++;
+	}
+	report(backend, "find", nkeys, start);
+
+	start = now_secs();
+	for (i = 0; i < nkeys; i++) {
+		key = misses + (size_t) i * BENCH_KEYLEN;
+		if (pbs_idx_find(idx, &key, &data, NULL) == PBS_IDX_RET_OK)
+			found = -1;
+	}
+	report(backend, "miss", nkeys, start);
+
+	start = now_secs();
+	for (i = 0; i < nkeys; i++)
+		pbs_idx_delete(idx, keys + (size_t) i * BENCH_KEYLEN);
+	report(backend, "delete", nkeys, start);
+
+	pbs_idx_destroy(idx);
+
+	if (found != nkeys) {
+		fprintf(stderr, "%s: lookups returned wrong entries\n", backend);
+		return 1;
+	}
+	return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	int nkeys = BENCH_DFLT_KEYS;
+	char *server = BENCH_DFLT_SERVER;
+	char *keys;
+	char *misses;
+	int i, rc = 0;
+
+	while ((i = getopt(argc, argv, "n:s:")) != EOF) {
+		switch (i) {
+			case 'n':
+				nkeys = atoi(optarg);
+				break;
+			case 's':
+				server = optarg;
+				break;
+			default:
+				rc = 1;
+		}
+	}
+
+	if (rc || optind != argc || nkeys < 1 || strlen(server) > BENCH_KEYLEN - 16) {
+		fprintf(stderr, "Error in usage: pbs_idxbench [-n keys] [-s server name]\n");
+		return 1;
+	}
+
+	keys = malloc((size_t) nkeys * BENCH_KEYLEN);
+	misses = malloc((size_t) nkeys * BENCH_KEYLEN);
+	if (keys == NULL || misses == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < nkeys; i++) {
+		snprintf(keys + (size_t) i * BENCH_KEYLEN, BENCH_KEYLEN, "%d.%s", i, server);
+		snprintf(misses + (size_t) i * BENCH_KEYLEN, BENCH_KEYLEN, "%d.%s", nkeys + i, server);
+	}
+
+	rc = run_backend("tree", 0, keys, misses, nkeys);
+	rc |= run_backend("hash", PBS_IDX_HASH, keys, misses, nkeys);
+
+	free(keys);
+	free(misses);
+	return rc;
+}
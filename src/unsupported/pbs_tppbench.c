@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_tppbench.c
+ *
+ * @brief
+ *	Benchmark for the pbs_comm routing path.
+ *
+ * @par Functionality:
+ *	Forks a number of synthetic TPP leaves, all on this host but each on
+ *	its own port, and connects them to the pbs_comm(s) from pbs.conf.
+ *	The leaves form a ring, each leaf sending messages to the next one
+ *	while receiving from the previous one, so every message is routed by
+ *	pbs_comm. Once all the leaves are done, the aggregate number of routed
+ *	packets per second is reported.
+ *
+ *	Usage: pbs_tppbench [-n leaves] [-m messages] [-s size] [-p base port]
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "pbs_ifl.h"
+#include "pbs_internal.h"
+#include "dis.h"
+#include "tpp.h"
+#include "log.h"
+
+#define BENCH_DFLT_LEAVES	8
+#define BENCH_DFLT_MSGS		10000
+#define BENCH_DFLT_SIZE		256
+#define BENCH_DFLT_PORT		17100
+#define BENCH_TIMEOUT		60	/* seconds to wait for messages */
+
+/* result reported by each leaf to the parent */
+typedef struct {
+	int leaf;
+	int sent;
+	int recvd;
+	double elapsed;
+} bench_result_t;
+
+static void
+log_tppmsg(int level, const char *objname, char *mess)
+{
+	if (level <= LOG_ERR)
+		fprintf(stderr, "tpp error: %s\n", mess);
+}
+
+/**
+ * @brief
+ *	Return the current time in seconds as a double
+ *
+ * @return - current time
+ */
+static double
+now_secs(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+/**
+ * @brief
+ *	Wait for a tpp notification and read all pending messages
+ *
+ * @param[in] wait_ms - milliseconds to wait for a notification
+ * @param[in,out] recvd - count of messages received, incremented
+ *
+ * @return	Error code
+ * @retval	 0 - Success
+ * @retval	-1 - Failure
+ */
+static int
+drain_msgs(int wait_ms, int *recvd)
+{
+	fd_set selset;
+	struct timeval tv;
+	int stream;
+	int rc;
+	char *buf;
+	size_t len;
+
+	FD_ZERO(&selset);
+	FD_SET(tpp_fd, &selset);
+	tv.tv_sec = wait_ms / 1000;
+	tv.tv_usec = (wait_ms % 1000) * 1000;
+	if (select(tpp_fd + 1, &selset, NULL, NULL, &tv) == -1 && errno != EINTR)
+		return -1;
+
+	while ((stream = tpp_poll()) >= 0) {
+		(void) disrui(stream, &rc);
+		if (rc == DIS_SUCCESS) {
+			buf = disrcs(stream, &len, &rc);
+			free(buf);
+			if (rc == DIS_SUCCESS)
+				(*recvd)++;
+		}
+		tpp_eom(stream);
+	}
+	if (stream == -1)
+		return -1;
+
+	return 0;
+}
+
+/**
+ * @brief
+ *	Body of one synthetic leaf
+ *
+ * @param[in] leaf - index of this leaf
+ * @param[in] nleaves - total number of leaves in the ring
+ * @param[in] nmsgs - messages to send (and expect)
+ * @param[in] size - payload size of each message
+ * @param[in] port - base port, this leaf listens on port + leaf
+ * @param[in] host - host name used by all the leaves
+ * @param[in] ready_fd - pipe to tell the parent this leaf is connected
+ * @param[in] go_fd - pipe from which the parent starts the run
+ * @param[in] res_fd - pipe to report the result to the parent
+ *
+ * @return	exit code for the leaf process
+ */
+static int
+run_leaf(int leaf, int nleaves, int nmsgs, int size, int port, char *host,
+	int ready_fd, int go_fd, int res_fd)
+{
+	struct tpp_config tpp_conf;
+	bench_result_t res;
+	char *payload;
+	char c = 0;
+	int sd;
+	int i;
+	double start;
+
+	memset(&res, 0, sizeof(res));
+	res.leaf = leaf;
+
+	if (set_tpp_config(log_tppmsg, &pbs_conf, &tpp_conf, host, port + leaf, pbs_conf.pbs_leaf_routers) == -1) {
+		fprintf(stderr, "leaf %d: Error setting TPP config\n", leaf);
+		return 1;
+	}
+
+	if ((tpp_fd = tpp_init(&tpp_conf)) == -1) {
+		fprintf(stderr, "leaf %d: tpp_init failed\n", leaf);
+		return 1;
+	}
+	DIS_tpp_funcs();
+
+	/* wait for the connection to pbs_comm, then report ready */
+	drain_msgs(5000, &res.recvd);
+	res.recvd = 0;
+	if (write(ready_fd, &c, 1) != 1 || read(go_fd, &c, 1) != 1)
+		return 1;
+
+	if ((payload = malloc(size + 1)) == NULL) {
+		fprintf(stderr, "leaf %d: Out of memory\n", leaf);
+		return 1;
+	}
+	memset(payload, 'x', size);
+	payload[size] = '\0';
+
+	if ((sd = tpp_open(host, port + ((leaf + 1) % nleaves))) < 0) {
+		fprintf(stderr, "leaf %d: tpp_open failed\n", leaf);
+		free(payload);
+		return 1;
+	}
+
+	start = now_secs();
+	for (i = 0; i < nmsgs; i++) {
+		if (diswui(sd, i) != DIS_SUCCESS ||
+			diswcs(sd, payload, size) != DIS_SUCCESS ||
+			dis_flush(sd) != 0) {
+			fprintf(stderr, "leaf %d: send failed at message %d\n", leaf, i);
+			break;
+		}
+		res.sent++;
+		if ((i % 64) == 0)
+			drain_msgs(0, &res.recvd);
+	}
+
+	while (res.recvd < nmsgs && (now_secs() - start) < BENCH_TIMEOUT) {
+		if (drain_msgs(100, &res.recvd) == -1)
+			break;
+	}
+	res.elapsed = now_secs() - start;
+
+	if (write(res_fd, &res, sizeof(res)) != sizeof(res))
+		fprintf(stderr, "leaf %d: failed to report result\n", leaf);
+
+	/* give the peer time to drain before the stream goes away */
+	sleep(1);
+	tpp_close(sd);
+	tpp_shutdown();
+	free(payload);
+
+	return (res.recvd == nmsgs) ? 0 : 1;
+}
+
+int
+main(int argc, char *argv[])
+{
+	int nleaves = BENCH_DFLT_LEAVES;
+	int nmsgs = BENCH_DFLT_MSGS;
+	int size = BENCH_DFLT_SIZE;
+	int port = BENCH_DFLT_PORT;
+	int ready_pipe[2];
+	int go_pipe[2];
+	int res_pipe[2];
+	char host[PBS_MAXHOSTNAME + 1];
+	char c = 0;
+	int i, rc = 0;
+	long total_recvd = 0;
+	double elapsed = 0;
+	bench_result_t res;
+	pid_t pid;
+
+	while ((i = getopt(argc, argv, "n:m:s:p:")) != EOF) {
+		switch (i) {
+			case 'n':
+				nleaves = atoi(optarg);
+				break;
+			case 'm':
+				nmsgs = atoi(optarg);
+				break;
+			case 's':
+				size = atoi(optarg);
+				break;
+			case 'p':
+				port = atoi(optarg);
+				break;
+			default:
+				rc = 1;
+		}
+	}
+
+	if (rc || optind != argc || nleaves < 2 || nmsgs < 1 || size < 0 || port <= 0) {
+		fprintf(stderr,
+			"Error in usage: pbs_tppbench [-n leaves] [-m messages] [-s size] [-p base port]\n");
+		return 1;
+	}
+
+	if (set_msgdaemonname("pbs_tppbench")) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	if (pbs_loadconf(0) == 0) {
+		fprintf(stderr, "%s: Configuration error\n", argv[0]);
+		return 1;
+	}
+
+	if (gethostname(host, (sizeof(host) - 1)) < 0 ||
+		get_fullhostname(host, host, (sizeof(host) - 1)) == -1) {
+		fprintf(stderr, "Failed to get hostname\n");
+		return 1;
+	}
+
+	if (pipe(ready_pipe) == -1 || pipe(go_pipe) == -1 || pipe(res_pipe) == -1) {
+		perror("pipe");
+		return 1;
+	}
+
+	for (i = 0; i < nleaves; i++) {
+		pid = fork();
+		if (pid == -1) {
+			perror("fork");
+			return 1;
+		}
+		if (pid == 0) {
+			close(ready_pipe[0]);
+			close(go_pipe[1]);
+			close(res_pipe[0]);
+			exit(run_leaf(i, nleaves, nmsgs, size, port, host,
+				ready_pipe[1], go_pipe[0], res_pipe[1]));
+		}
+	}
+	close(ready_pipe[1]);
+	close(go_pipe[0]);
+	close(res_pipe[1]);
+
+	/* start all the leaves together, once every one has joined */
+	for (i = 0; i < nleaves; i++) {
+		if (read(ready_pipe[0], &c, 1) != 1) {
+			fprintf(stderr, "Leaf failed to start\n");
+			kill(0, SIGTERM);
+			return 1;
+		}
+	}
+	for (i = 0; i < nleaves; i++) {
+		if (write(go_pipe[1], &c, 1) != 1) {
+			perror("write");
+			return 1;
+		}
+	}
+
+	while (read(res_pipe[0], &res, sizeof(res)) == sizeof(res)) {
+		printf("leaf %d: sent=%d recvd=%d elapsed=%.3fs\n",
+			res.leaf, res.sent, res.recvd, res.elapsed);
+		total_recvd += res.recvd;
+		if (res.elapsed > elapsed)
+			elapsed = res.elapsed;
+	}
+
+	rc = 0;
+	while ((pid = wait(&i)) > 0) {
+		if (!WIFEXITED(i) || WEXITSTATUS(i) != 0)
+			rc = 1;
+	}
+
+	printf("leaves=%d messages=%d size=%d routed=%ld elapsed=%.3fs rate=%.0f pkts/sec\n",
+		nleaves, nmsgs, size, total_recvd, elapsed,
+		(elapsed > 0) ? total_recvd / elapsed : 0.0);
+
+	return rc;
+}
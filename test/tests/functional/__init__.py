@@ -46,3 +46,97 @@ class TestFunctional(PBSTestSuite):
     Base test suite for Functional tests
     """
     pass
+
+
+class JobSaveFault(object):
+    """
+    Mixin for functional suites which make the datastore fail to commit
+    job saves.  It goes before TestFunctional in the bases of the suite;
+    a fault still set at the end of a test is cleared in tearDown().
+    """
+
+    db_script = """#!/bin/bash
+. %s
+. ${PBS_EXEC}/libexec/pbs_db_env
+
+DATA_PORT=${PBS_DATA_SERVICE_PORT}
+if [ -z ${DATA_PORT} ]; then
+    DATA_PORT=15007
+fi
+DATA_USER=`sudo cat ${PBS_HOME}/server_priv/db_user 2>/dev/null`
+if [ -z "${DATA_USER}" ]; then
+    DATA_USER=postgres
+fi
+
+if [ "%s" = "stopped" ]; then
+    sudo ${PBS_EXEC}/sbin/pbs_dataservice status >/dev/null
+    if [ $? -eq 0 ]; then
+        sudo ${PBS_EXEC}/sbin/pbs_dataservice stop >/dev/null || exit 1
+    fi
+    sudo ${PBS_EXEC}/sbin/pbs_ds_password test || exit 1
+    sudo ${PBS_EXEC}/sbin/pbs_dataservice start >/dev/null || exit 1
+fi
+
+args="-A -t -U ${DATA_USER} -p ${DATA_PORT} -d pbs_datastore"
+PGPASSWORD=test ${PGSQL_BIN}/psql ${args} -v ON_ERROR_STOP=1 <<-EOF
+%s
+EOF
+ret=$?
+
+if [ "%s" = "stopped" ]; then
+    sudo ${PBS_EXEC}/sbin/pbs_dataservice stop >/dev/null || exit 1
+fi
+exit $ret
+"""
+
+    def run_sql(self, sql, running=False):
+        """
+        Run the given sql against the datastore.  Unless running, the
+        server is stopped first and the datastore password is set for
+        later runs; with running, the server must have been started
+        after such a run.
+        """
+        state = 'running' if running else 'stopped'
+        if not running and self.server.isUp():
+            self.server.stop()
+            self.assertFalse(self.server.isUp(), 'Failed to stop server')
+        conf_path = self.du.get_pbs_conf_file()
+        fn = self.du.create_temp_file(
+            body=self.db_script % (conf_path, state, sql, state))
+        self.du.chmod(path=fn, mode=0o755)
+        ret = self.du.run_cmd(cmd=fn)
+        self.assertEqual(ret['rc'], 0, 'Failed to run sql: %s' % ret['err'])
+
+    def fail_job_saves(self, op, jobids=None):
+        """
+        Stop the server and make the commit of every transaction which
+        does op ('insert' or 'update') on a job fail, or only on the
+        given jobs.  The caller starts the server again.
+        """
+        when = ''
+        if jobids:
+            ids = ', '.join(["'%s'" % j for j in jobids])
+            when = 'when (NEW.ji_jobid in (%s))' % ids
+        sql = """
+    create or replace function pbs.ptl_fail() returns trigger as
+        'begin raise exception ''ptl injected failure''; end;'
+        language plpgsql;
+    create constraint trigger ptl_fail after %s on pbs.job
+        deferrable initially deferred for each row %s
+        execute procedure pbs.ptl_fail();
+""" % (op, when)
+        self.job_save_fault = True
+        self.run_sql(sql)
+
+    def clear_job_save_fault(self):
+        """
+        Let job saves commit again, with the server running
+        """
+        self.run_sql('drop trigger if exists ptl_fail on pbs.job;',
+                     running=True)
+        self.job_save_fault = False
+
+    def tearDown(self):
+        if getattr(self, 'job_save_fault', False):
+            self.clear_job_save_fault()
+        super(JobSaveFault, self).tearDown()
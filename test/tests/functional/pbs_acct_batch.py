@@ -0,0 +1,164 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestAcctBatch(TestFunctional):
+    """
+    Tests for accounting records written in batches by a background
+    thread (PBS_ACCT_ASYNC), their binary copy (PBS_ACCT_BINARY) and
+    pbs_acctread
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.du.set_pbs_config(self.server.hostname,
+                               confs={'PBS_ACCT_ASYNC': '1',
+                                      'PBS_ACCT_BINARY': '1'})
+        self.server.restart()
+        self.acctread = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                     'bin', 'pbs_acctread')
+        self.acctfile = os.path.join(self.server.pbs_conf['PBS_HOME'],
+                                     'server_priv', 'accounting',
+                                     time.strftime('%Y%m%d'))
+
+    def tearDown(self):
+        self.du.unset_pbs_config(self.server.hostname,
+                                 confs=['PBS_ACCT_ASYNC',
+                                        'PBS_ACCT_BINARY'])
+        self.server.restart()
+        TestFunctional.tearDown(self)
+
+    def run_jobs(self, num):
+        """
+        Run num short jobs to their end and return their ids
+        """
+        jids = []
+        for i in range(num):
+            j = Job(TEST_USER, {ATTR_N: 'acct%d' % i})
+            j.set_sleep_time(1)
+            jids.append(self.server.submit(j))
+        for jid in jids:
+            self.server.expect(JOB, 'queue', op=UNSET, id=jid, offset=1)
+        for jid in jids:
+            self.server.accounting_match(';E;%s;' % jid, max_attempts=10)
+        return jids
+
+    def read_bin(self, args=None):
+        """
+        Run pbs_acctread on today's binary accounting file
+        """
+        cmd = [self.acctread]
+        if args:
+            cmd += args
+        ret = self.du.run_cmd(self.server.hostname, cmd=cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        return ret['out']
+
+    def text_lines(self):
+        """
+        Return the lines of today's accounting file
+        """
+        ret = self.du.cat(self.server.hostname, self.acctfile, sudo=True)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        return [l for l in ret['out'] if l]
+
+    def test_binary_matches_text(self):
+        """
+        pbs_acctread prints the records of the binary file as they are
+        in the accounting file
+        """
+        self.run_jobs(5)
+        self.assertTrue(self.du.isfile(self.server.hostname,
+                                       path=self.acctfile + '.bin',
+                                       sudo=True))
+        binlines = self.read_bin()
+        text = self.text_lines()
+        self.assertGreater(len(binlines), 0)
+        self.assertEqual(binlines, text[-len(binlines):])
+
+    def test_fields(self):
+        """
+        -t and -f print the chosen fields of the chosen records, with
+        durations in seconds
+        """
+        jids = self.run_jobs(3)
+        out = self.read_bin(['-t', 'E', '-H', '-f',
+                             'type,id,user,Exit_status,'
+                             'resources_used.walltime'])
+        self.assertEqual(out[0],
+                         'type,id,user,Exit_status,resources_used.walltime')
+        rows = [l.split(',') for l in out[1:]]
+        self.assertEqual([r[1] for r in rows][-3:], jids)
+        for r in rows[-3:]:
+            self.assertEqual(r[0], 'E')
+            self.assertEqual(r[2], str(TEST_USER))
+            self.assertEqual(r[3], '0')
+            self.assertTrue(r[4].isdigit(), r[4])
+
+        out = self.read_bin(['-t', 'Q', '-s', ';', '-f', 'id,queue'])
+        self.assertEqual(out[-3:], ['%s;workq' % jid for jid in jids])
+
+    def test_records_kept_on_shutdown_and_hup(self):
+        """
+        Records queued for the writer reach the file when the server
+        shuts down, and after a SIGHUP
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        jids = []
+        for _ in range(20):
+            j = Job(TEST_USER, {ATTR_h: None})
+            jids.append(self.server.submit(j))
+        self.server.delete(jids)
+        self.server.qterm(manner='immediate')
+        text = '\n'.join(self.text_lines())
+        for jid in jids:
+            self.assertIn(';D;%s;' % jid, text)
+        self.server.start()
+        self.assertTrue(self.server.isUp(), 'Failed to start PBS server')
+
+        self.server.signal('-HUP')
+        jids = self.run_jobs(2)
+        text = '\n'.join(self.text_lines())
+        binlines = '\n'.join(self.read_bin())
+        for jid in jids:
+            self.assertIn(';E;%s;' % jid, text)
+            self.assertIn(';E;%s;' % jid, binlines)
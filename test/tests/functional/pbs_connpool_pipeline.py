@@ -0,0 +1,199 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+test_code = '''
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <pbs_error.h>
+#include <pbs_ifl.h>
+
+static struct pbs_connpool *pool;
+static char *jobid;
+static int failed;
+
+static void *
+worker(void *arg)
+{
+    int i;
+    int c;
+    struct batch_status *bs;
+
+    for (i = 0; i < 25; i++) {
+        if ((c = pbs_connpool_get(pool)) < 0) {
+            failed = 1;
+            break;
+        }
+        bs = pbs_statjob(c, jobid, NULL, NULL);
+        if (bs == NULL || strcmp(bs->name, jobid) != 0)
+            failed = 1;
+        pbs_statfree(bs);
+        pbs_connpool_put(pool, c);
+    }
+    return NULL;
+}
+
+static void
+print_reply(char *what, struct batch_status *bs)
+{
+    struct batch_status *p;
+
+    if (bs == NULL) {
+        printf("%s error %d\\n", what, pbs_errno);
+        return;
+    }
+    for (p = bs; p != NULL; p = p->next)
+        printf("%s %s\\n", what, p->name);
+    pbs_statfree(bs);
+}
+
+int
+main(int argc, char **argv)
+{
+    int c1, c2, c;
+    int s1, s2, s3, s4, s5;
+    struct attropl crit = {NULL, ATTR_N, NULL, "pipesel", EQ};
+    pthread_t tid[4];
+    int i;
+
+    if (argc < 3)
+        return 1;
+    jobid = argv[1];
+    if ((pool = pbs_connpool_create(NULL, 2, 0)) == NULL)
+        return 1;
+    c1 = pbs_connpool_get(pool);
+    c2 = pbs_connpool_get(pool);
+    if (c1 < 0 || c2 < 0)
+        return 1;
+    pbs_connpool_put(pool, c1);
+    c = pbs_connpool_get(pool);
+    printf("reused %d\\n", c == c1);
+
+    s1 = pbs_pipe_stat(c, MGR_OBJ_JOB, argv[1], NULL, NULL);
+    s2 = pbs_pipe_stat(c, MGR_OBJ_SERVER, NULL, NULL, NULL);
+    s3 = pbs_pipe_stat(c, MGR_OBJ_JOB, argv[2], NULL, NULL);
+    s4 = pbs_pipe_stat(c, MGR_OBJ_JOB, "999999", NULL, NULL);
+    s5 = pbs_pipe_selstat(c, &crit, NULL, NULL);
+    printf("pending %d\\n", pbs_pipe_pending(c));
+    print_reply("third", pbs_pipe_recv(c, s3));
+    print_reply("first", pbs_pipe_recv(c, s1));
+    print_reply("fourth", pbs_pipe_recv(c, s4));
+    print_reply("fifth", pbs_pipe_recv(c, s5));
+    print_reply("second", pbs_pipe_recv(c, s2));
+    printf("pending %d\\n", pbs_pipe_pending(c));
+    print_reply("again", pbs_pipe_recv(c, s1));
+
+    /* the connection still serves plain requests */
+    print_reply("plain", pbs_statjob(c, argv[2], NULL, NULL));
+    pbs_connpool_put(pool, c);
+    pbs_connpool_put(pool, c2);
+
+    for (i = 0; i < 4; i++)
+        pthread_create(&tid[i], NULL, worker, NULL);
+    for (i = 0; i < 4; i++)
+        pthread_join(tid[i], NULL);
+    printf("threads %s\\n", failed ? "failed" : "ok");
+    pbs_connpool_destroy(pool);
+    return 0;
+}
+'''
+
+
+class TestConnPoolPipeline(TestFunctional):
+    """
+    Tests for the client connection pool (pbs_connpool_*) and pipelined
+    status requests (pbs_pipe_*) of libpbs, through a program built
+    against it
+    """
+
+    def build(self):
+        """
+        Build the test program against the installed libpbs and return
+        the command that runs it
+        """
+        if self.du.get_platform().lower() != 'linux':
+            self.skipTest("This test is only supported on Linux!")
+        _gcc = self.du.which(exe='gcc')
+        if _gcc == 'gcc':
+            self.skipTest("Couldn't find gcc!")
+        _exec = self.server.pbs_conf['PBS_EXEC']
+        _id = os.path.join(_exec, 'include')
+        _ld = os.path.join(_exec, 'lib')
+        if not self.du.isfile(path=os.path.join(_id, 'pbs_ifl.h')):
+            self.skipTest("Couldn't find pbs_ifl.h in %s" % _id)
+        _fn = self.du.create_temp_file(body=test_code, suffix='.c')
+        _en = self.du.create_temp_file()
+        self.du.rm(path=_en)
+        cmd = ['gcc', '-g', '-O2', '-Wall', '-o', _en, '-I%s' % _id, _fn,
+               '-L%s' % _ld, '-lpbs', '-lz', '-lpthread']
+        _res = self.du.run_cmd(cmd=cmd)
+        self.assertEqual(_res['rc'], 0, "\n".join(_res['err']))
+        return 'LD_LIBRARY_PATH=%s %s' % (_ld, _en)
+
+    def test_pool_and_pipeline(self):
+        """
+        A connection put back in the pool is handed out again, replies
+        to pipelined requests are returned whichever order they are
+        asked for in, and threads share a pool of two connections
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        j = Job(TEST_USER, {ATTR_h: None})
+        jid1 = self.server.submit(j)
+        j = Job(TEST_USER, {ATTR_h: None, ATTR_N: 'pipesel'})
+        jid2 = self.server.submit(j)
+        svr = self.server.status(SERVER)[0]['id']
+        prog = self.build()
+        _res = self.du.run_cmd(cmd=['%s %s %s' % (prog, jid1, jid2)],
+                               as_script=True)
+        self.assertEqual(_res['rc'], 0, "\n".join(_res['err']))
+        exp = ['reused 1',
+               'pending 5',
+               'third %s' % jid2,
+               'first %s' % jid1,
+               'fourth error 15001',
+               'fifth %s' % jid2,
+               'second %s' % svr,
+               'pending 0',
+               'again error 15004',
+               'plain %s' % jid2,
+               'threads ok']
+        self.assertEqual(_res['out'], exp)
@@ -0,0 +1,269 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestDbAttrsBin(TestFunctional):
+    """
+    Tests for the binary attribute records (attrs_bin) of jobs, nodes and
+    reservations in the datastore
+    """
+
+    db_script = """#!/bin/bash
+. %s
+. ${PBS_EXEC}/libexec/pbs_db_env
+
+DATA_PORT=${PBS_DATA_SERVICE_PORT}
+if [ -z ${DATA_PORT} ]; then
+    DATA_PORT=15007
+fi
+DATA_USER=`sudo cat ${PBS_HOME}/server_priv/db_user 2>/dev/null`
+if [ -z "${DATA_USER}" ]; then
+    DATA_USER=postgres
+fi
+
+sudo ${PBS_EXEC}/sbin/pbs_dataservice status >/dev/null
+if [ $? -eq 0 ]; then
+    sudo ${PBS_EXEC}/sbin/pbs_dataservice stop >/dev/null || exit 1
+fi
+sudo ${PBS_EXEC}/sbin/pbs_ds_password test || exit 1
+sudo ${PBS_EXEC}/sbin/pbs_dataservice start >/dev/null || exit 1
+
+export PGPASSWORD=test
+args="-A -t -U ${DATA_USER} -p ${DATA_PORT} -d pbs_datastore"
+${PGSQL_BIN}/psql ${args} -v ON_ERROR_STOP=1 <<-EOF
+%s
+EOF
+ret=$?
+
+if [ $ret -eq 0 -a "%s" = "upgrade" ]; then
+    sudo PGPASSWORD=test ${PBS_EXEC}/libexec/pbs_schema_upgrade
+    ret=$?
+    ${PGSQL_BIN}/psql ${args} -c "select pbs_schema_version from pbs.info"
+fi
+
+sudo ${PBS_EXEC}/sbin/pbs_dataservice stop >/dev/null || exit 1
+exit $ret
+"""
+
+    def run_sql(self, sql, upgrade=False):
+        """
+        Stop the server and run the given sql against the datastore.
+        With upgrade, run pbs_schema_upgrade after it.
+        Returns the output lines of psql.
+        """
+        if self.server.isUp():
+            self.server.stop()
+        self.assertFalse(self.server.isUp(), 'Failed to stop PBS server')
+        conf_path = self.du.get_pbs_conf_file()
+        fn = self.du.create_temp_file(
+            body=self.db_script % (conf_path, sql,
+                                   'upgrade' if upgrade else ''))
+        self.du.chmod(path=fn, mode=0o755)
+        ret = self.du.run_cmd(cmd=fn)
+        self.assertEqual(ret['rc'], 0, 'Failed to run sql: %s' % ret['err'])
+        return [l.strip() for l in ret['out'] if l.strip()]
+
+    def start_server(self):
+        """
+        Start the server and wait for it to come up
+        """
+        self.server.start()
+        self.assertTrue(self.server.isUp(), 'Failed to start PBS server')
+
+    def set_comment_times(self, vnode, num):
+        """
+        Set the comment of a vnode num times, one save each
+        """
+        for i in range(num):
+            self.server.manager(MGR_CMD_SET, NODE,
+                                {'comment': 'update %d' % i}, id=vnode)
+
+    def test_restart_recovery(self):
+        """
+        Jobs, nodes and reservations changed through appended records
+        come back with their latest attributes after a restart, both
+        after a clean shutdown and after a kill
+        """
+        j = Job(TEST_USER, {ATTR_N: 'binjob', ATTR_h: None,
+                            'Resource_List.ncpus': 1})
+        jid = self.server.submit(j)
+        self.server.alterjob(jid, {ATTR_N: 'binjob2'})
+        self.server.alterjob(jid, {'Resource_List.walltime': '01:00:00'})
+
+        vn = self.mom.shortname
+        self.server.manager(MGR_CMD_CREATE, RSC,
+                            {'type': 'string', 'flag': 'h'}, id='foo_str')
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'comment': 'first',
+                             'resources_available.foo_str': 'bar'}, id=vn)
+        self.server.manager(MGR_CMD_SET, NODE, {'comment': 'second'}, id=vn)
+        self.server.manager(MGR_CMD_UNSET, NODE,
+                            'resources_available.foo_str', id=vn)
+
+        start = int(time.time()) + 3600
+        r = Reservation(TEST_USER, {'reserve_start': start,
+                                    'reserve_end': start + 600,
+                                    ATTR_resv_name: 'binresv'})
+        rid = self.server.submit(r)
+        self.server.expect(RESV, {'reserve_state':
+                                  (MATCH_RE, 'RESV_CONFIRMED|2')}, id=rid)
+        self.server.alterresv(rid, {ATTR_resv_name: 'binresv2'})
+        self.server.expect(RESV, {ATTR_resv_name: 'binresv2'}, id=rid)
+
+        out = self.run_sql(
+            "select length(attrs_bin) > 0, attributes = '' from pbs.job "
+            "where ji_jobid = '%s';" % jid)
+        self.assertEqual(out, ['t|t'])
+        self.start_server()
+
+        for sig in ('-KILL', None):
+            self.server.stop(sig)
+            self.start_server()
+            self.server.expect(JOB, {ATTR_N: 'binjob2',
+                                     'Resource_List.walltime': '01:00:00',
+                                     'job_state': 'H'}, id=jid)
+            self.server.expect(NODE, {'comment': 'second'}, id=vn)
+            self.server.expect(NODE, 'resources_available.foo_str',
+                               op=UNSET, id=vn)
+            self.server.expect(RESV, {ATTR_resv_name: 'binresv2'}, id=rid)
+
+    def test_fold_after_appends(self):
+        """
+        After 64 appends a row is folded into one record per attribute,
+        and the folded row loads the same attributes
+        """
+        vn = self.mom.shortname
+        self.set_comment_times(vn, 70)
+        self.server.expect(NODE, {'comment': 'update 69'}, id=vn)
+        out = self.run_sql(
+            "select attr_nupd < 64, length(attrs_bin) < 70 * 20 "
+            "from pbs.node where nd_name = '%s';" % vn)
+        self.assertEqual(out, ['t|t'])
+        self.start_server()
+        self.server.expect(NODE, {'comment': 'update 69',
+                                  'state': 'free'}, id=vn)
+
+    def test_unset_record_shadows_hstore(self):
+        """
+        An unset record removes the value an unconverted row still holds
+        in its hstore attributes, and a set record replaces it
+        """
+        vn = self.mom.shortname
+        self.server.manager(MGR_CMD_SET, NODE, {'comment': 'bin'}, id=vn)
+        self.server.manager(MGR_CMD_UNSET, NODE, 'comment', id=vn)
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.ncpus': 5}, id=vn)
+        self.run_sql(
+            "update pbs.node set attributes = attributes || "
+            "hstore(ARRAY['comment', '1.stale hstore', "
+            "'resources_available.ncpus', '1.9']) "
+            "where nd_name = '%s';" % vn)
+        self.start_server()
+        self.server.expect(NODE, 'comment', op=UNSET, id=vn)
+        self.server.expect(NODE, {'resources_available.ncpus': 5}, id=vn)
+
+        # the first fold moves what is left in hstore over
+        self.set_comment_times(vn, 64)
+        out = self.run_sql(
+            "select attributes = '' from pbs.node "
+            "where nd_name = '%s';" % vn)
+        self.assertEqual(out, ['t'])
+        self.start_server()
+        self.server.expect(NODE, {'resources_available.ncpus': 5,
+                                  'comment': 'update 63'}, id=vn)
+
+    def test_upgrade_from_1_5_0(self):
+        """
+        pbs_schema_upgrade adds the binary columns to a 1.5.0 datastore,
+        rows written by 1.5.0 load from hstore and are converted by the
+        first fold
+        """
+        vn = self.mom.shortname
+        self.server.manager(MGR_CMD_DELETE, NODE, id="")
+        self.server.manager(MGR_CMD_CREATE, NODE, id=vn)
+        self.server.expect(NODE, {'state': 'free'}, id=vn)
+        port = self.server.status(NODE, 'Port', id=vn)[0]['Port']
+        sql = """
+    delete from pbs.job;
+    delete from pbs.resv;
+    update pbs.node set attributes = hstore(ARRAY[
+        'Mom', '1.%s',
+        'Port', '1.%s',
+        'resources_available.host', '1.%s',
+        'resources_available.vnode', '1.%s',
+        'resources_available.ncpus', '1.7',
+        'comment', '1.written by 1.5.0'])
+        where nd_name = '%s';
+    alter table pbs.job drop column attrs_bin, drop column attr_nupd;
+    alter table pbs.node drop column attrs_bin, drop column attr_nupd;
+    alter table pbs.resv drop column attrs_bin, drop column attr_nupd;
+    update pbs.info set pbs_schema_version = '1.5.0';
+""" % (self.mom.hostname, port, vn, vn, vn)
+        out = self.run_sql(sql, upgrade=True)
+        self.assertEqual(out[-1], '1.6.0')
+
+        self.start_server()
+        self.server.expect(NODE, {'resources_available.ncpus': 7,
+                                  'comment': 'written by 1.5.0'}, id=vn)
+        self.server.manager(MGR_CMD_SET, NODE, {'comment': 'after upgrade'},
+                            id=vn)
+        out = self.run_sql(
+            "select attributes != '', length(attrs_bin) > 0 "
+            "from pbs.node where nd_name = '%s';" % vn)
+        self.assertEqual(out, ['t|t'])
+        self.start_server()
+        self.server.expect(NODE, {'resources_available.ncpus': 7,
+                                  'comment': 'after upgrade'}, id=vn)
+
+        self.set_comment_times(vn, 64)
+        out = self.run_sql(
+            "select attributes = '' from pbs.node "
+            "where nd_name = '%s';" % vn)
+        self.assertEqual(out, ['t'])
+        self.start_server()
+        self.server.expect(NODE, {'resources_available.ncpus': 7,
+                                  'comment': 'update 63'}, id=vn)
+
+        j = Job(TEST_USER, {ATTR_h: None})
+        jid = self.server.submit(j)
+        self.server.restart()
+        self.server.expect(JOB, {'job_state': 'H'}, id=jid)
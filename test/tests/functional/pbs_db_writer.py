@@ -0,0 +1,115 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestDbWriter(TestFunctional):
+    """
+    Tests that saves handed to the datastore writer of the server are
+    durable once the request that made them is acknowledged
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+    def kill_and_start(self):
+        """
+        Kill the server so that nothing is flushed on shutdown, then
+        start it again
+        """
+        self.server.stop('-KILL')
+        self.server.start()
+        self.assertTrue(self.server.isUp(), 'Failed to start PBS server')
+
+    def test_writer_started(self):
+        """
+        The server starts its datastore writer once it is running
+        """
+        start = time.time()
+        self.server.restart()
+        self.server.log_match('Datastore writer started', starttime=start)
+
+    def test_acknowledged_saves_survive_kill(self):
+        """
+        Repeated changes of the same objects are coalesced by the writer,
+        and the last acknowledged value of each is recovered after the
+        server is killed
+        """
+        jids = []
+        for i in range(10):
+            j = Job(TEST_USER, {ATTR_N: 'dbw%d' % i, ATTR_h: None})
+            jids.append(self.server.submit(j))
+        for n in range(20):
+            for jid in jids:
+                self.server.alterjob(jid, {'Resource_List.walltime': 100 + n})
+        vn = self.mom.shortname
+        for n in range(20):
+            self.server.manager(MGR_CMD_SET, NODE,
+                                {'comment': 'writer %d' % n}, id=vn)
+        self.server.manager(MGR_CMD_SET, QUEUE, {'priority': 42},
+                            id='workq')
+
+        self.kill_and_start()
+        for i, jid in enumerate(jids):
+            self.server.expect(JOB, {ATTR_N: 'dbw%d' % i,
+                                     'Resource_List.walltime': '00:01:59',
+                                     'job_state': 'H'}, id=jid)
+        self.server.expect(NODE, {'comment': 'writer 19'}, id=vn)
+        self.server.expect(QUEUE, {'priority': 42}, id='workq')
+
+    def test_acknowledged_purge_survives_kill(self):
+        """
+        A job deleted right after a change is not recovered after the
+        server is killed
+        """
+        jids = []
+        for i in range(10):
+            j = Job(TEST_USER, {ATTR_h: None})
+            jids.append(self.server.submit(j))
+        for jid in jids[:5]:
+            self.server.alterjob(jid, {ATTR_N: 'gone'})
+            self.server.delete(jid)
+        self.kill_and_start()
+        for jid in jids[:5]:
+            self.server.expect(JOB, 'queue', op=UNSET, id=jid)
+        for jid in jids[5:]:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
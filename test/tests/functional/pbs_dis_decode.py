@@ -0,0 +1,118 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+import json
+
+from tests.functional import *
+
+
+class TestDisIntegerDecode(TestFunctional):
+    """
+    Tests that integers of every size and sign, and strings of every
+    length, go through the text DIS encoding unchanged in requests and
+    replies
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.pbs_exec = self.server.pbs_conf['PBS_EXEC']
+        # the text encoding is the one decoded in place
+        self.du.set_pbs_config(self.server.hostname,
+                               confs={'PBS_DIS_VERSION': '1'})
+        self.server.restart()
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.server.manager(MGR_CMD_CREATE, RSC, {'type': 'long'},
+                            id='dis_long')
+        self.server.manager(MGR_CMD_CREATE, RSC, {'type': 'size'},
+                            id='dis_size')
+
+    def tearDown(self):
+        self.du.unset_pbs_config(self.server.hostname,
+                                 confs=['PBS_DIS_VERSION'])
+        self.server.restart()
+        TestFunctional.tearDown(self)
+
+    def qstat_f(self, jid):
+        """
+        Return the attributes of a job as a text client gets them
+        """
+        cmd = ['env', 'PBS_DIS_VERSION=1',
+               os.path.join(self.pbs_exec, 'bin', 'qstat'), '-f', '-F',
+               'json', jid]
+        ret = self.du.run_cmd(self.server.hostname, cmd=cmd,
+                              runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        return json.loads('\n'.join(ret['out']))['Jobs'][jid]
+
+    def test_integer_values(self):
+        """
+        Long and size resources and the job priority keep their values
+        at the limits of their types and around the eight digit blocks
+        the decoder converts at once
+        """
+        values = ['0', '7', '-7', '99999999', '100000000', '-100000000',
+                  '12345678901234567', '4294967296', '-4294967297',
+                  '9223372036854775807', '-9223372036854775807']
+        j = Job(TEST_USER, {ATTR_h: None})
+        jid = self.server.submit(j)
+        for v in values:
+            self.server.alterjob(jid, {'Resource_List.dis_long': v})
+            out = self.qstat_f(jid)
+            self.assertEqual(str(out['Resource_List']['dis_long']), v)
+        for v in ('1kb', '123456789kb', '4294967296kb', '1099511627776kb'):
+            self.server.alterjob(jid, {'Resource_List.dis_size': v})
+            self.server.expect(JOB, {'Resource_List.dis_size': v}, id=jid)
+        for v in ('-1024', '-1', '0', '1023'):
+            self.server.alterjob(jid, {ATTR_p: v})
+            out = self.qstat_f(jid)
+            self.assertEqual(str(out['Priority']), v)
+
+    def test_string_lengths(self):
+        """
+        Strings whose length counts take one to several digits decode
+        to the same text
+        """
+        j = Job(TEST_USER, {ATTR_h: None})
+        jid = self.server.submit(j)
+        for n in (1, 9, 10, 99, 100, 999, 1000, 4095, 12345):
+            comment = ('%d-' % n + 'c' * n)[:n]
+            self.server.alterjob(jid, {ATTR_comment: comment})
+            out = self.qstat_f(jid)
+            self.assertEqual(out['comment'], comment)
@@ -0,0 +1,172 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestDisVersion2(TestFunctional):
+    """
+    Tests that clients and the server give the same results whether they
+    talk with the binary DIS encoding (version 2) or the text one
+    (version 1), and that either end set to version 1 falls back to it
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.pbs_exec = self.server.pbs_conf['PBS_EXEC']
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.server.manager(MGR_CMD_CREATE, RSC,
+                            {'type': 'string', 'flag': 'h'}, id='dis_str')
+        self.server.manager(MGR_CMD_CREATE, RSC,
+                            {'type': 'float'}, id='dis_float')
+        self.jids = []
+        for i in range(20):
+            a = {ATTR_N: 'disjob%d' % i,
+                 ATTR_h: None,
+                 'Resource_List.ncpus': 1,
+                 'Resource_List.dis_float': '%d.25' % i,
+                 'Resource_List.walltime': 3600 + i,
+                 ATTR_v: 'DIS_A=%s,DIS_B=x y z' % ('v' * i),
+                 ATTR_A: 'acct_%d' % i}
+            j = Job(TEST_USER, a)
+            self.jids.append(self.server.submit(j))
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.dis_str': 'abc' * 100,
+                             'comment': 'long ' * 50},
+                            id=self.mom.shortname)
+
+    def tearDown(self):
+        self.du.unset_pbs_config(self.server.hostname,
+                                 confs=['PBS_DIS_VERSION'])
+        self.server.restart()
+        TestFunctional.tearDown(self)
+
+    def run_client(self, cmd, version=None):
+        """
+        Run a client command, with PBS_DIS_VERSION set to version in
+        its environment if given, and return its output lines
+        """
+        path = os.path.join(self.pbs_exec, 'bin', cmd[0])
+        args = [path] + cmd[1:]
+        if version is not None:
+            args = ['env', 'PBS_DIS_VERSION=%d' % version] + args
+        ret = self.du.run_cmd(self.server.hostname, cmd=args,
+                              runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        return ret['out']
+
+    def outputs(self, version=None):
+        """
+        Collect the output of status commands for a client version
+        """
+        out = {}
+        out['qstat_f'] = self.run_client(['qstat', '-f'] + self.jids,
+                                         version)
+        out['qstat_fx'] = self.run_client(['qstat', '-fx', '-F', 'json'] +
+                                          self.jids[:3], version)
+        out['qstat_t'] = self.run_client(['qstat', '-t'], version)
+        out['qstat_Qf'] = self.run_client(['qstat', '-Qf'], version)
+        out['pbsnodes'] = self.run_client(['pbsnodes', '-av'], version)
+        out['qmgr'] = self.run_client(['qmgr', '-c', 'list node @default'],
+                                      version)
+        # json output carries the time it was made
+        out['qstat_fx'] = [l for l in out['qstat_fx']
+                           if '"timestamp"' not in l]
+        return out
+
+    def check_requests(self, version=None):
+        """
+        Alter a job and change it back with the given client version
+        """
+        jid = self.jids[-1]
+        self.run_client(['qalter', '-N', 'altered', '-l',
+                         'dis_float=-1.5', jid], version)
+        self.server.expect(JOB, {ATTR_N: 'altered',
+                                 'Resource_List.dis_float': -1.5}, id=jid)
+        self.run_client(['qalter', '-N', 'disjob19', '-l',
+                         'dis_float=19.25', jid], version)
+
+    def test_v2_matches_v1(self):
+        """
+        The status output of a version 2 client against a version 2
+        server is the same as with a version 1 client
+        """
+        v2 = self.outputs()
+        v1 = self.outputs(version=1)
+        for k in v2:
+            self.assertEqual(v2[k], v1[k], 'output of %s differs' % k)
+        self.check_requests()
+        self.check_requests(version=1)
+
+    def test_v2_server_v1_client(self):
+        """
+        A client with PBS_DIS_VERSION=1 does not offer version 2 and
+        still works against a version 2 server
+        """
+        out = self.run_client(['qstat', '-f', self.jids[0]], version=1)
+        self.assertIn('Job_Name = disjob0', '\n'.join(out))
+        self.check_requests(version=1)
+        j = Job(TEST_USER, {ATTR_h: None})
+        jid = self.server.submit(j)
+        self.run_client(['qdel', jid], version=1)
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid)
+
+    def test_v1_server(self):
+        """
+        A server with PBS_DIS_VERSION=1 ignores the offer of a version 2
+        client, and the output is the same as from a version 2 server
+        """
+        v2 = self.outputs()
+        self.du.set_pbs_config(self.server.hostname,
+                               confs={'PBS_DIS_VERSION': '1'})
+        self.server.restart()
+        self.assertTrue(self.server.isUp())
+        offered = self.outputs(version=2)
+        plain = self.outputs(version=1)
+        for k in offered:
+            self.assertEqual(offered[k], plain[k], 'output of %s differs' % k)
+        # the server was restarted in between, skip what it changes
+        skip = ('mtime', 'Last_Used_Time', 'last_state_change_time')
+        for k in ('qstat_f', 'qstat_t'):
+            self.assertEqual(
+                [l for l in v2[k] if not l.strip().startswith(skip)],
+                [l for l in offered[k] if not l.strip().startswith(skip)],
+                'output of %s differs across versions' % k)
+        self.check_requests(version=2)
@@ -0,0 +1,142 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestIdxHash(TestFunctional):
+    """
+    Tests for the server and MoM indexes kept in hash tables: objects are
+    found by id through many inserts and deletes, and deleted ones are
+    no longer found
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+
+    def submit_held(self, num, attrs=None):
+        """
+        Submit num held jobs and return their ids
+        """
+        a = {ATTR_h: None}
+        if attrs:
+            a.update(attrs)
+        jids = []
+        for _ in range(num):
+            j = Job(TEST_USER, a)
+            jids.append(self.server.submit(j))
+        return jids
+
+    def test_job_churn(self):
+        """
+        Jobs are found by id after half of them were deleted and more
+        were added, also after a restart
+        """
+        jids = self.submit_held(200)
+        gone = jids[::2]
+        kept = jids[1::2]
+        self.server.delete(gone)
+        kept += self.submit_held(150)
+        for jid in gone:
+            self.server.expect(JOB, 'queue', op=UNSET, id=jid)
+        for jid in kept:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+        self.server.restart()
+        for jid in gone:
+            self.server.expect(JOB, 'queue', op=UNSET, id=jid)
+        for jid in kept:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+
+    def test_queue_churn(self):
+        """
+        Queues are found by name after others were deleted and created
+        again under the same names
+        """
+        a = {'queue_type': 'execution', 'enabled': 'True',
+             'started': 'True'}
+        names = ['idxq%d' % i for i in range(40)]
+        for name in names:
+            self.server.manager(MGR_CMD_CREATE, QUEUE, a, id=name)
+        for name in names[::2]:
+            self.server.manager(MGR_CMD_DELETE, QUEUE, id=name)
+        for name in names[:10:2]:
+            self.server.manager(MGR_CMD_CREATE, QUEUE, a, id=name)
+        for name in names[1::2] + names[:10:2]:
+            jid = self.submit_held(1, {ATTR_queue: name})[0]
+            self.server.expect(JOB, {ATTR_queue: name}, id=jid)
+        for name in names[10::2]:
+            j = Job(TEST_USER, {ATTR_queue: name})
+            with self.assertRaises(PbsSubmitError):
+                self.server.submit(j)
+
+    def test_vnode_churn(self):
+        """
+        Vnodes are found by name, and jobs run on them, after the vnode
+        set was replaced by a smaller one
+        """
+        a = {'resources_available.ncpus': 1}
+        self.mom.create_vnodes(a, 100)
+        self.server.expect(NODE, {'state=free': (GE, 100)},
+                           count=True)
+        self.mom.create_vnodes(a, 30)
+        self.server.expect(NODE, {'state=free': (GE, 30)},
+                           count=True)
+        vn = self.mom.shortname
+        for i in range(30):
+            self.server.expect(NODE, {'state': 'free'},
+                               id='%s[%d]' % (vn, i))
+        for i in range(30, 100):
+            with self.assertRaises(PbsStatusError):
+                self.server.status(NODE, id='%s[%d]' % (vn, i))
+
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        jids = []
+        for _ in range(30):
+            j = Job(TEST_USER)
+            jids.append(self.server.submit(j))
+        self.server.expect(JOB, {'job_state=R': 30}, count=True)
+        self.server.expect(NODE, {'state=job-busy': 30}, count=True)
+
+        # the MoM finds each of its jobs by id
+        for jid in jids[:10]:
+            self.server.sigjob(jid, 'suspend')
+            self.server.expect(JOB, {'job_state': 'S'}, id=jid)
+        self.server.delete(jids, wait=True)
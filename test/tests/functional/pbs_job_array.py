@@ -1002,3 +1002,55 @@ e.accept()
         self.assertNotEqual(rv['rc'], 0, 'qsub must fail')
         msg = "qsub: multiple max_run_subjobs values found"
         self.assertEqual(rv['err'][0], msg)
+
+    def test_large_array_tracking(self):
+        """
+        Test that the remaining indices and the subjob state counts of a
+        large array job follow deletes of single subjobs and of ranges,
+        running subjobs and a server kill and restart
+        """
+        a = {ATTR_maxarraysize: 100000, 'scheduling': 'False'}
+        self.server.manager(MGR_CMD_SET, SERVER, a)
+        a = {'resources_available.ncpus': 4}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+        j = Job(TEST_USER, attrs={ATTR_J: '1-100000'})
+        j.set_sleep_time(1000)
+        j_id = self.server.submit(j)
+        self.server.expect(JOB, {'array_indices_remaining': '1-100000',
+                                 'array_state_count':
+                                 'Queued:100000 Running:0 Exiting:0 '
+                                 'Expired:0'}, id=j_id)
+
+        self.server.delete(j.create_subjob_id(j_id, 5))
+        self.server.delete(j.create_subjob_id(j_id, '10-20'))
+        self.server.delete(j.create_subjob_id(j_id, 100000))
+        self.server.expect(JOB, {'array_indices_remaining':
+                                 '1-4,6-9,21-99999',
+                                 'array_state_count':
+                                 'Queued:99987 Running:0 Exiting:0 '
+                                 'Expired:13'}, id=j_id)
+
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        self.server.expect(JOB, {'job_state=R': 4}, extend='t')
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        remaining = {'array_indices_remaining': '6-9,21-99999',
+                     'array_state_count':
+                     'Queued:99983 Running:4 Exiting:0 Expired:13'}
+        self.server.expect(JOB, remaining, id=j_id)
+        for i in range(1, 5):
+            self.server.expect(JOB, {'job_state': 'R'},
+                               id=j.create_subjob_id(j_id, i))
+
+        self.kill_and_restart_svr()
+        self.server.expect(JOB, remaining, id=j_id)
+        self.server.expect(JOB, {'job_state': 'X'},
+                           id=j.create_subjob_id(j_id, 15))
+        self.server.expect(JOB, {'job_state': 'Q'},
+                           id=j.create_subjob_id(j_id, 50000))
+
+        self.server.delete(j.create_subjob_id(j_id, 2))
+        self.server.expect(JOB, {'array_indices_remaining': '6-9,21-99999',
+                                 'array_state_count':
+                                 'Queued:99983 Running:3 Exiting:0 '
+                                 'Expired:14'}, id=j_id)
+        self.server.delete(j_id, wait=True)
@@ -0,0 +1,114 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestLogAsync(TestFunctional):
+    """
+    Tests for PBS_LOG_ASYNC, which has the daemons write their log
+    records from a background thread
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        # a small ring, so that producers have to wait for the writer
+        self.du.set_pbs_config(self.server.hostname,
+                               confs={'PBS_LOG_ASYNC': '16'})
+        self.server.restart()
+        self.scheduler.restart()
+        self.mom.restart()
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+
+    def tearDown(self):
+        self.du.unset_pbs_config(self.server.hostname,
+                                 confs=['PBS_LOG_ASYNC'])
+        self.server.restart()
+        self.scheduler.restart()
+        self.mom.restart()
+        TestFunctional.tearDown(self)
+
+    def test_no_record_lost(self):
+        """
+        Every record reaches the log file, in the order it was logged,
+        even when the ring fills up
+        """
+        start = time.time()
+        jids = []
+        for _ in range(100):
+            j = Job(TEST_USER, {ATTR_h: None})
+            jids.append(self.server.submit(j))
+        self.server.delete(jids)
+        lines = self.server.log_match('Job Queued at request of',
+                                      allmatch=True, n='ALL',
+                                      starttime=start, max_attempts=10)
+        queued = [l[1].split(';')[4] for l in lines]
+        self.assertEqual(queued, jids)
+
+    def test_jobs_run(self):
+        """
+        The server, scheduler and MoM keep logging the life of a job
+        """
+        start = time.time()
+        j = Job(TEST_USER)
+        j.set_sleep_time(1)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid, offset=1)
+        self.scheduler.log_match(jid + ';Job run', starttime=start)
+        self.mom.log_match('Job;%s;Started' % jid, starttime=start)
+        self.server.log_match(jid + ';Exit_status=0', starttime=start)
+
+    def test_shutdown_drains(self):
+        """
+        Records queued when the server shuts down are written before it
+        exits
+        """
+        start = time.time()
+        for _ in range(20):
+            j = Job(TEST_USER, {ATTR_h: None})
+            self.server.submit(j)
+        self.server.qterm(manner='immediate')
+        self.assertFalse(self.server.isUp())
+        self.server.log_match('Server shutdown completed', starttime=start)
+        self.server.log_match('Log;Log closed', starttime=start)
+        self.server.start()
+        self.assertTrue(self.server.isUp(), 'Failed to start PBS server')
+        self.server.log_match('Server@.*;Log;Log opened', regexp=True,
+                              starttime=start)
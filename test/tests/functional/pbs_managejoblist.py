@@ -0,0 +1,229 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestManageJobList(JobSaveFault, TestFunctional):
+    """
+    Tests for qhold, qrls, qsig, qalter and qmove acting on many jobs with
+    one Manage Job List request
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.pbs_exec = self.server.pbs_conf['PBS_EXEC']
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.ncpus': 8},
+                            id=self.mom.shortname)
+        a = {'queue_type': 'execution', 'enabled': 'True',
+             'started': 'True'}
+        self.server.manager(MGR_CMD_CREATE, QUEUE, a, id='workq2')
+
+    def run_cmd(self, cmd, runas=TEST_USER):
+        """
+        Run a PBS command and return its result
+        """
+        cmd[0] = os.path.join(self.pbs_exec, 'bin', cmd[0])
+        return self.du.run_cmd(self.server.hostname, cmd=cmd, runas=runas)
+
+    def submit_jobs(self, user, num, attrs=None):
+        """
+        Submit num jobs as user, return their ids
+        """
+        jids = []
+        for _ in range(num):
+            j = Job(user, attrs)
+            jids.append(self.server.submit(j))
+        return jids
+
+    def test_mixed_list(self):
+        """
+        A list with unknown jobs and jobs in the wrong state acts on the
+        others and reports each failure
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        jids = self.submit_jobs(TEST_USER, 4)
+        bad = '9999999.' + self.server.hostname
+        ret = self.run_cmd(['qhold', jids[0], bad, jids[1], jids[2]])
+        self.assertNotEqual(ret['rc'], 0)
+        err = '\n'.join(ret['err'])
+        self.assertIn('Unknown Job Id', err)
+        self.assertIn(bad, err)
+        for jid in jids[:3]:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+        self.server.expect(JOB, {'job_state': 'Q'}, id=jids[3])
+
+        ret = self.run_cmd(['qrls', bad] + jids)
+        self.assertNotEqual(ret['rc'], 0)
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+
+        ret = self.run_cmd(['qmove', 'nosuchq'] + jids[:2])
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertEqual(len(ret['err']), 2)
+        ret = self.run_cmd(['qmove', 'workq2', jids[0], bad, jids[1]])
+        self.assertNotEqual(ret['rc'], 0)
+        for jid in jids[:2]:
+            self.server.expect(JOB, {'queue': 'workq2'}, id=jid)
+
+        ret = self.run_cmd(['qalter', '-N', 'listed', jids[2], bad, jids[3]])
+        self.assertNotEqual(ret['rc'], 0)
+        for jid in jids[2:]:
+            self.server.expect(JOB, {ATTR_N: 'listed'}, id=jid)
+
+    def test_select_expression(self):
+        """
+        -E acts on the jobs the server selects
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        mine = self.submit_jobs(TEST_USER, 3, {ATTR_N: 'sel'})
+        other = self.submit_jobs(TEST_USER, 2, {ATTR_N: 'nosel'})
+        ret = self.run_cmd(['qhold', '-E', 'Job_Name=sel'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for jid in mine:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+        for jid in other:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+        ret = self.run_cmd(['qalter', '-E', 'job_state=H', '-N', 'held'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for jid in mine:
+            self.server.expect(JOB, {ATTR_N: 'held'}, id=jid)
+        ret = self.run_cmd(['qrls', '-E', 'Job_Name=held'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for jid in mine:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+
+    def check_perm(self, ret, mine, others):
+        """
+        Check that a command by TEST_USER failed with a permission error
+        for every job of others and for none of mine
+        """
+        self.assertNotEqual(ret['rc'], 0)
+        err = '\n'.join(ret['err'])
+        for jid in others:
+            self.assertIn('Unauthorized Request  %s' % jid, err)
+        for jid in mine:
+            self.assertNotIn(jid, err)
+
+    def test_permissions(self):
+        """
+        Each job of a list gets the permission check of its single job
+        request: a user acts on their own jobs only, in every operation
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        mine = self.submit_jobs(TEST_USER, 2)
+        others = self.submit_jobs(TEST_USER1, 2)
+        jids = [mine[0], others[0], mine[1], others[1]]
+
+        ret = self.run_cmd(['qhold'] + jids)
+        self.check_perm(ret, mine, others)
+        for jid in mine:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+        for jid in others:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+
+        self.run_cmd(['qhold'] + others, runas=TEST_USER1)
+        ret = self.run_cmd(['qrls'] + jids)
+        self.check_perm(ret, mine, others)
+        for jid in mine:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+        for jid in others:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+        self.run_cmd(['qrls'] + others, runas=TEST_USER1)
+
+        ret = self.run_cmd(['qalter', '-N', 'permjob'] + jids)
+        self.check_perm(ret, mine, others)
+        for jid in mine:
+            self.server.expect(JOB, {ATTR_N: 'permjob'}, id=jid)
+        for jid in others:
+            self.server.expect(JOB, {ATTR_N: 'permjob'}, op=NE, id=jid)
+
+        ret = self.run_cmd(['qmove', 'workq2'] + jids)
+        self.check_perm(ret, mine, others)
+        for jid in mine:
+            self.server.expect(JOB, {'queue': 'workq2'}, id=jid)
+        for jid in others:
+            self.server.expect(JOB, {'queue': 'workq'}, id=jid)
+
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        ret = self.run_cmd(['qsig', '-s', 'SIGCONT'] + jids)
+        self.check_perm(ret, mine, others)
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+
+        # a manager may act on every job
+        ret = self.run_cmd(['qsig', '-s', 'suspend'] + jids, runas=ROOT_USER)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'S'}, id=jid)
+
+    def test_save_error(self):
+        """
+        If the transaction of a batch does not commit, every job of the
+        batch is reported with PBSE_SAVE_ERR and the server keeps running
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        jids = self.submit_jobs(TEST_USER, 5)
+        self.fail_job_saves('update', jids)
+        self.server.start()
+        self.assertTrue(self.server.isUp())
+
+        start = time.time()
+        ret = self.run_cmd(['qhold'] + jids)
+        self.assertNotEqual(ret['rc'], 0)
+        err = '\n'.join(ret['err'])
+        for jid in jids:
+            self.assertIn('Failed to save job/resv, refer server logs for '
+                          'details %s' % jid, err)
+        self.server.log_match('Failed to commit a batch of a Manage Job List',
+                              starttime=start)
+        self.assertTrue(self.server.isUp())
+
+        # the jobs are held in the server, but not in the datastore
+        self.clear_job_save_fault()
+        ret = self.run_cmd(['qrls'] + jids)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        ret = self.run_cmd(['qhold'] + jids)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
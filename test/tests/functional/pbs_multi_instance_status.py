@@ -0,0 +1,149 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+import socket
+
+from tests.functional import *
+
+
+class TestMultiInstanceStatus(TestFunctional):
+    """
+    Tests for status requests answered by several server instances,
+    whose replies the client reads concurrently.  The instances are the
+    one server reached under two names, so each job is reported twice
+    and counts are added up.
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.pbs_exec = self.server.pbs_conf['PBS_EXEC']
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.port = int(self.server.pbs_conf.get('PBS_BATCH_SERVICE_PORT',
+                                                 15001))
+        self.addr = socket.gethostbyname(self.server.hostname)
+        self.jids = []
+        for i in range(6):
+            j = Job(TEST_USER, {ATTR_h: None, ATTR_N: 'multi%d' % i})
+            self.jids.append(self.server.submit(j))
+
+    def client_conf(self, instances, timeout=None):
+        """
+        Write a client pbs.conf listing the given instances and return
+        its path
+        """
+        conf = self.du.parse_pbs_config(self.server.hostname)
+        conf['PBS_SERVER_INSTANCES'] = ','.join(instances)
+        if timeout is not None:
+            conf['PBS_STAT_INSTANCE_TIMEOUT'] = str(timeout)
+        body = ''.join('%s=%s\n' % (k, v) for k, v in conf.items())
+        return self.du.create_temp_file(asuser=TEST_USER, body=body)
+
+    def run_client(self, cmd, conf=None):
+        """
+        Run a client command, with the given pbs.conf if any
+        """
+        args = [os.path.join(self.pbs_exec, 'bin', cmd[0])] + cmd[1:]
+        if conf:
+            args = ['env', 'PBS_CONF_FILE=%s' % conf] + args
+        return self.du.run_cmd(self.server.hostname, cmd=args,
+                               runas=TEST_USER)
+
+    def job_lines(self, out):
+        """
+        Return the job lines of plain qstat output
+        """
+        return [l for l in out if l.split('.')[0].isdigit()]
+
+    def attr_value(self, out, name):
+        """
+        Return the value of an attribute in qstat -f style output
+        """
+        for l in out:
+            if l.strip().startswith(name + ' = '):
+                return l.split(' = ', 1)[1].strip()
+        return None
+
+    def test_replies_merged_in_order(self):
+        """
+        The jobs of each instance are listed in instance order, and the
+        job counts of the server and queues are added up
+        """
+        single = self.run_client(['qstat'])
+        self.assertEqual(single['rc'], 0, single['err'])
+        jobs = self.job_lines(single['out'])
+        self.assertEqual(len(jobs), len(self.jids))
+
+        for timeout in (None, 5):
+            conf = self.client_conf(['%s:%d' % (self.server.hostname,
+                                                self.port),
+                                     '%s:%d' % (self.addr, self.port)],
+                                    timeout)
+            ret = self.run_client(['qstat'], conf)
+            self.assertEqual(ret['rc'], 0, ret['err'])
+            self.assertEqual(self.job_lines(ret['out']), jobs + jobs)
+
+            ret = self.run_client(['qstat', '-Bf'], conf)
+            self.assertEqual(ret['rc'], 0, ret['err'])
+            self.assertEqual(self.attr_value(ret['out'], 'total_jobs'),
+                             str(2 * len(self.jids)))
+            ret = self.run_client(['qstat', '-Qf', 'workq'], conf)
+            self.assertEqual(ret['rc'], 0, ret['err'])
+            self.assertEqual(self.attr_value(ret['out'], 'total_jobs'),
+                             str(2 * len(self.jids)))
+
+    def test_instance_down(self):
+        """
+        An instance that cannot be reached is left out, and the replies
+        of the others are still reported
+        """
+        # nothing listens on a port that was just closed
+        s = socket.socket()
+        s.bind(('', 0))
+        dead = s.getsockname()[1]
+        s.close()
+        conf = self.client_conf(['%s:%d' % (self.server.hostname,
+                                            self.port),
+                                 '%s:%d' % (self.addr, dead)], 5)
+        start = time.time()
+        ret = self.run_client(['qstat'], conf)
+        self.assertLess(time.time() - start, 30)
+        out = '\n'.join(ret['out'])
+        for jid in self.jids:
+            self.assertIn(jid.split('.')[0], out)
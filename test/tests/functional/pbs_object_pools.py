@@ -0,0 +1,136 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestObjectPools(TestFunctional):
+    """
+    Tests for the object pools jobs, reservations, batch requests and
+    status attribute lists are allocated from
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        # PBSEVENT_DEBUG4 carries the pool statistics
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 4095})
+
+    def submit_held(self, num):
+        """
+        Submit num held jobs and return their ids
+        """
+        jids = []
+        for i in range(num):
+            j = Job(TEST_USER, {ATTR_h: None, ATTR_N: 'pool%d' % i})
+            jids.append(self.server.submit(j))
+        return jids
+
+    def check_pool(self, name, live, start):
+        """
+        Check the statistics the server logged at startup for a pool
+        """
+        msg = ('MEM_DEBUG: pool %s size=[0-9]+ live=%d peak=[0-9]+ '
+               'free=[0-9]+ slabs=[0-9]+ allocs=[0-9]+' % (name, live))
+        self.server.log_match(msg, regexp=True, starttime=start)
+
+    def test_pool_stats(self):
+        """
+        The server logs the live objects of its pools, which match the
+        jobs and reservations it recovered
+        """
+        jids = self.submit_held(30)
+        self.server.delete(jids[:10])
+        now = int(time.time())
+        r = Reservation(TEST_USER, {'reserve_start': now + 3600,
+                                    'reserve_end': now + 4200})
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        rid = self.server.submit(r)
+        self.server.expect(RESV, {'reserve_state':
+                                  (MATCH_RE, 'RESV_CONFIRMED|2')}, id=rid)
+        start = time.time()
+        self.server.restart()
+        self.check_pool('job', 20, start)
+        self.check_pool('resv', 1, start)
+        self.server.log_match('MEM_DEBUG: pool batch_request',
+                              starttime=start)
+
+    def test_reuse(self):
+        """
+        Objects given back to the pools are reused without carrying
+        anything over: jobs, reservations and status replies stay right
+        through many allocations and frees
+        """
+        keep = self.submit_held(5)
+        before = self.server.status(JOB, id=keep[0])
+        for _ in range(5):
+            jids = self.submit_held(50)
+            for jid in jids[::7]:
+                self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+            self.server.status(JOB)
+            self.server.status(NODE)
+            self.server.delete(jids)
+
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        now = int(time.time())
+        kept = []
+        for i in range(10):
+            r = Reservation(TEST_USER,
+                            {'reserve_start': now + 3600 + i * 600,
+                             'reserve_end': now + 3900 + i * 600,
+                             ATTR_resv_name: 'poolresv%d' % i})
+            rid = self.server.submit(r)
+            self.server.expect(RESV, {'reserve_state':
+                                      (MATCH_RE, 'RESV_CONFIRMED|2')},
+                               id=rid)
+            if i % 2:
+                self.server.delete(rid)
+            else:
+                kept.append((rid, i))
+        for rid, i in kept:
+            self.server.expect(RESV, {ATTR_resv_name: 'poolresv%d' % i},
+                               id=rid)
+
+        after = self.server.status(JOB, id=keep[0])
+        self.assertEqual(before, after)
+        for i, jid in enumerate(keep):
+            self.server.expect(JOB, {ATTR_N: 'pool%d' % i,
+                                     'job_state': 'H'}, id=jid)
+        self.assertTrue(self.server.isUp())
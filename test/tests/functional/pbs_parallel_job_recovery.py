@@ -0,0 +1,105 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestParallelJobRecovery(TestFunctional):
+    """
+    Tests for the recovery of jobs with their rows decoded by a pool of
+    threads
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.server.manager(MGR_CMD_CREATE, RSC, {'type': 'string'},
+                            id='recov_str')
+
+    def test_recovery_order_and_attributes(self):
+        """
+        Jobs come back after a restart in the order they had, with their
+        attributes, and the server logs the recovery times
+        """
+        num = 300
+        for i in range(num):
+            a = {ATTR_N: 'recov%d' % i,
+                 'Resource_List.recov_str': 'val%d' % i,
+                 ATTR_v: 'RECOV=%s' % ('x' * (i % 50))}
+            if i % 3 == 0:
+                a[ATTR_h] = None
+            j = Job(TEST_USER, a)
+            self.server.submit(j)
+        a = {ATTR_J: '1-10', ATTR_N: 'recovarr'}
+        j = Job(TEST_USER, a)
+        ajid = self.server.submit(j)
+
+        before = self.server.status(JOB)
+        start = time.time()
+        self.server.restart()
+        msg = ('Job recovery: %d jobs, query .*, waiting for decode .*, '
+               'enqueue .*, [0-9]+ decode threads' % (num + 1))
+        self.server.log_match(msg, regexp=True, starttime=start)
+
+        after = self.server.status(JOB)
+        self.assertEqual([j['id'] for j in before], [j['id'] for j in after])
+        for b, a in zip(before, after):
+            for k in (ATTR_N, 'job_state', 'Resource_List.recov_str',
+                      'Variable_List', 'queue_rank'):
+                if k in b:
+                    self.assertEqual(b[k], a.get(k),
+                                     '%s of %s differs' % (k, b['id']))
+        self.server.expect(JOB, {'job_state': 'Q'}, id=ajid)
+        self.server.expect(JOB, {'job_state=H': num // 3}, count=True)
+
+    def test_recovery_after_kill(self):
+        """
+        Jobs are recovered the same way after the server is killed
+        """
+        jids = []
+        for i in range(50):
+            j = Job(TEST_USER, {ATTR_N: 'killed%d' % i})
+            jids.append(self.server.submit(j))
+        self.server.stop('-KILL')
+        self.server.start()
+        self.assertTrue(self.server.isUp(), 'Failed to start PBS server')
+        for i, jid in enumerate(jids):
+            self.server.expect(JOB, {ATTR_N: 'killed%d' % i,
+                                     'job_state': 'Q'}, id=jid)
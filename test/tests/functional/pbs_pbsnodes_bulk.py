@@ -0,0 +1,230 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+import textwrap
+
+from tests.functional import *
+
+
+def get_hook_body():
+    hook_body = """
+    import pbs
+    e = pbs.event()
+    m = e.management
+    if m.objtype == pbs.MGR_OBJ_NODE:
+        if m.cmd == pbs.MGR_CMD_SET:
+            cmd = 'set'
+        else:
+            cmd = 'unset'
+        pbs.logmsg(pbs.LOG_DEBUG, 'bulk_mgmt: %s %s reply=%s' %
+                   (m.objname, cmd, m.reply_code))
+    """
+    return textwrap.dedent(hook_body)
+
+
+@tags('commands')
+class TestPbsnodesBulk(TestFunctional):
+
+    """
+    Tests for the bulk vnode changes (pbsnodes -o/-r/-C with -E) and
+    the per-partition summary (pbsnodes -t) computed by the server.
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.pbsnodes = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                     'bin', 'pbsnodes')
+        a = {'resources_available.ncpus': 2}
+        self.mom.create_vnodes(a, 3)
+        self.vn = ['%s[%d]' % (self.mom.shortname, i) for i in range(3)]
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.ncpus': 8},
+                            id=self.vn[2])
+
+    def run_pbsnodes(self, args, runas=ROOT_USER):
+        """
+        Run pbsnodes with the given arguments and return the result
+        """
+        cmd = [self.pbsnodes, '-s', self.server.hostname] + args
+        return self.du.run_cmd(self.server.hostname, cmd=cmd, runas=runas)
+
+    def test_offline_clear_all_vnodes(self):
+        """
+        Mark every vnode of a host offline with a comment in one request,
+        then clear the state and the comment again
+        """
+        ret = self.run_pbsnodes(['-o', '-C', 'bulk maint',
+                                 self.mom.shortname])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for vn in self.vn:
+            self.server.expect(NODE, {'state': 'offline',
+                                      'comment': 'bulk maint'}, id=vn)
+        ret = self.run_pbsnodes(['-r', '-C', '', self.mom.shortname])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for vn in self.vn:
+            self.server.expect(NODE, {'state': 'free'}, id=vn)
+            self.server.expect(NODE, 'comment', op=UNSET, id=vn)
+
+    def test_select_expression(self):
+        """
+        Only the vnodes matching every -E expression are changed
+        """
+        ret = self.run_pbsnodes(['-o', '-E', 'state=free',
+                                 '-E', 'resources_available.ncpus>=8'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.server.expect(NODE, {'state': 'offline'}, id=self.vn[2])
+        for vn in self.vn[:2]:
+            self.server.expect(NODE, {'state': 'free'}, id=vn)
+        ret = self.run_pbsnodes(['-r', '-E', 'state=offline'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for vn in self.vn:
+            self.server.expect(NODE, {'state': 'free'}, id=vn)
+
+    def test_bad_select_expression(self):
+        """
+        A malformed -E expression is rejected and changes nothing
+        """
+        ret = self.run_pbsnodes(['-o', '-E', 'state>free',
+                                 self.mom.shortname])
+        self.assertNotEqual(ret['rc'], 0)
+        for vn in self.vn:
+            self.server.expect(NODE, {'state': 'free'}, id=vn)
+
+    def test_non_manager_rejected(self):
+        """
+        A bulk change by an unprivileged user is refused
+        """
+        ret = self.run_pbsnodes(['-o', self.mom.shortname], runas=TEST_USER)
+        self.assertNotEqual(ret['rc'], 0)
+        for vn in self.vn:
+            self.server.expect(NODE, {'state': 'free'}, id=vn)
+
+    def test_management_hook_per_vnode(self):
+        """
+        A management hook runs once for each vnode altered by a bulk
+        change, with the node name and the reply code of the change
+        """
+        hook_name = 'bulk_mgmt'
+        attrs = {'event': 'management', 'enabled': 'True'}
+        self.server.create_import_hook(hook_name, attrs, get_hook_body())
+        start = time.time()
+        ret = self.run_pbsnodes(['-o', '-E',
+                                 'resources_available.ncpus>=8'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.server.expect(NODE, {'state': 'offline'}, id=self.vn[2])
+        self.server.log_match('bulk_mgmt: %s set reply=0' % self.vn[2],
+                              starttime=start)
+        for vn in self.vn[:2]:
+            self.server.log_match('bulk_mgmt: %s ' % vn, starttime=start,
+                                  existence=False, max_attempts=2)
+        start = time.time()
+        ret = self.run_pbsnodes(['-r', self.mom.shortname])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for vn in self.vn:
+            self.server.log_match('bulk_mgmt: %s ' % vn, starttime=start)
+
+    def get_summary(self, args=None):
+        """
+        Return the (none) partition of pbsnodes -t as a dictionary
+        """
+        cmd = ['-t', '-F', 'dsv']
+        if args:
+            cmd += args
+        ret = self.run_pbsnodes(cmd)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        for line in ret['out']:
+            fields = line.split('|')
+            if fields[0] == 'Name=(none)':
+                return dict(f.split('=', 1) for f in fields[1:])
+        self.fail('no (none) partition in pbsnodes -t output')
+
+    def test_partition_summary(self):
+        """
+        pbsnodes -t reports the state counts and the resource totals of
+        the vnodes as computed by the server
+        """
+        nodes = self.server.status(NODE)
+        ncpus = sum(int(n.get('resources_available.ncpus', 0))
+                    for n in nodes)
+        summ = self.get_summary()
+        self.assertEqual(int(summ['state.free']), len(nodes))
+        self.assertEqual(int(summ['resources_available.ncpus']), ncpus)
+
+        self.server.manager(MGR_CMD_SET, NODE, {'state': 'offline'},
+                            id=self.vn[0])
+        summ = self.get_summary()
+        self.assertEqual(int(summ['state.free']), len(nodes) - 1)
+        self.assertEqual(int(summ['state.offline']), 1)
+        self.assertEqual(int(summ['resources_available.ncpus']), ncpus)
+
+        j = Job(TEST_USER, {'Resource_List.select': '1:ncpus=8'})
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        summ = self.get_summary()
+        self.assertEqual(int(summ['resources_assigned.ncpus']), 8)
+
+    def test_old_server_fallback(self):
+        """
+        Against a server without bulk node changes, pbsnodes falls back
+        to one request per host, and refuses -E and -t.
+        Needs -p old_server=<host> naming a host running an older server,
+        and optionally old_node=<vnode> naming a vnode of that server.
+        """
+        if 'old_server' not in self.conf:
+            self.skipTest('needs old_server=<host> running an older server')
+        old = self.conf['old_server']
+        node = self.conf.get('old_node', old)
+        cmd = [self.pbsnodes, '-s', old, '-o', node]
+        ret = self.du.run_cmd(self.server.hostname, cmd=cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        cmd = [self.pbsnodes, '-s', old, '-v', node]
+        ret = self.du.run_cmd(self.server.hostname, cmd=cmd)
+        self.assertIn('offline', '\n'.join(ret['out']))
+        cmd = [self.pbsnodes, '-s', old, '-r', node]
+        ret = self.du.run_cmd(self.server.hostname, cmd=cmd, sudo=True)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+
+        cmd = [self.pbsnodes, '-s', old, '-o', '-E', 'state=free']
+        ret = self.du.run_cmd(self.server.hostname, cmd=cmd, sudo=True)
+        self.assertNotEqual(ret['rc'], 0)
+        cmd = [self.pbsnodes, '-s', old, '-t']
+        ret = self.du.run_cmd(self.server.hostname, cmd=cmd)
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertIn('server does not support -t', '\n'.join(ret['err']))
@@ -0,0 +1,165 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestQstatCache(TestFunctional):
+    """
+    Tests for qstat asking the server only for the attributes it shows,
+    and for the job listing cache enabled by PBS_QSTAT_CACHE_TTL
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.qstat = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                                  'qstat')
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.ncpus': 1},
+                            id=self.mom.shortname)
+        j = Job(TEST_USER, {ATTR_N: 'running'})
+        self.rjid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=self.rjid)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.jids = []
+        for i in range(3):
+            j = Job(TEST_USER, {ATTR_N: 'held%d' % i, ATTR_h: None})
+            self.jids.append(self.server.submit(j))
+        self.tmpdir = self.du.create_temp_dir(asuser=TEST_USER, mode=0o700)
+
+    def run_qstat(self, args, ttl=None):
+        """
+        Run qstat as TEST_USER, with the job listing cache enabled for
+        ttl seconds if given
+        """
+        cmd = ['env', 'TMPDIR=%s' % self.tmpdir]
+        if ttl is not None:
+            cmd.append('PBS_QSTAT_CACHE_TTL=%d' % ttl)
+        cmd += [self.qstat] + args
+        return self.du.run_cmd(self.server.hostname, cmd=cmd,
+                               runas=TEST_USER)
+
+    def short_ids(self, out):
+        """
+        Return the numeric part of the job ids listed in qstat output
+        """
+        ids = []
+        for l in out:
+            first = l.split(' ')[0].split('.')[0]
+            if first.isdigit():
+                ids.append(first)
+        return ids
+
+    def test_limited_attributes(self):
+        """
+        Selections and display options show what they showed when every
+        attribute was requested
+        """
+        rid = self.rjid.split('.')[0]
+        held = [j.split('.')[0] for j in self.jids]
+
+        ret = self.run_qstat(['-u', TEST_USER])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertEqual(sorted(self.short_ids(ret['out'])),
+                         sorted([rid] + held))
+
+        ret = self.run_qstat(['-i'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertEqual(sorted(self.short_ids(ret['out'])), sorted(held))
+
+        ret = self.run_qstat(['-r', '-n'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertEqual(self.short_ids(ret['out']), [rid])
+        self.assertIn(self.mom.shortname, '\n'.join(ret['out']))
+
+        self.server.alterjob(self.jids[0], {ATTR_comment: 'held comment'})
+        ret = self.run_qstat(['-s', '-i'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertIn('held comment', '\n'.join(ret['out']))
+
+        ret = self.run_qstat(['-u', TEST_USER, '-f'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        out = '\n'.join(ret['out'])
+        for name in ('Job_Name = running', 'Job_Name = held2',
+                     'Variable_List', 'Resource_List.ncpus = 1'):
+            self.assertIn(name, out)
+
+    def test_cached_listing(self):
+        """
+        A listing is shown from the cache until it is older than the
+        TTL, while status of given jobs is always fetched
+        """
+        first = self.run_qstat([], ttl=20)
+        self.assertEqual(first['rc'], 0, first['err'])
+        start = time.time()
+        j = Job(TEST_USER, {ATTR_N: 'late', ATTR_h: None})
+        late = self.server.submit(j)
+        lid = late.split('.')[0]
+
+        ret = self.run_qstat([], ttl=20)
+        self.assertEqual(ret['out'], first['out'])
+        self.assertNotIn(lid, self.short_ids(ret['out']))
+
+        # never cached: job ids, other options, no TTL
+        ret = self.run_qstat([late], ttl=20)
+        self.assertEqual(self.short_ids(ret['out']), [lid])
+        ret = self.run_qstat(['-a'], ttl=20)
+        self.assertIn(lid, self.short_ids(ret['out']))
+        ret = self.run_qstat([])
+        self.assertIn(lid, self.short_ids(ret['out']))
+
+        time.sleep(max(0, 21 - (time.time() - start)))
+        ret = self.run_qstat([], ttl=20)
+        self.assertIn(lid, self.short_ids(ret['out']))
+
+    def test_errors_not_cached(self):
+        """
+        A listing that failed is fetched again the next time
+        """
+        ret = self.run_qstat(['cacheq'], ttl=60)
+        self.assertNotEqual(ret['rc'], 0)
+        a = {'queue_type': 'execution', 'enabled': 'True',
+             'started': 'True'}
+        self.server.manager(MGR_CMD_CREATE, QUEUE, a, id='cacheq')
+        j = Job(TEST_USER, {ATTR_queue: 'cacheq', ATTR_h: None})
+        jid = self.server.submit(j)
+        ret = self.run_qstat(['cacheq'], ttl=60)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertEqual(self.short_ids(ret['out']), [jid.split('.')[0]])
@@ -0,0 +1,122 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+import socket
+import struct
+
+from tests.functional import *
+
+
+class TestRequestFairness(TestFunctional):
+    """
+    Tests that the server keeps serving other clients while a client
+    sends a request slowly or in pieces, and that it logs request
+    latency statistics on SIGUSR2
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.socks = []
+
+    def tearDown(self):
+        for s in self.socks:
+            s.close()
+        TestFunctional.tearDown(self)
+
+    def open_partial(self, nbytes):
+        """
+        Connect to the server and send the first nbytes of a packet
+        that announces 1000 bytes of data, and nothing more
+        """
+        port = int(self.server.pbs_conf.get('PBS_BATCH_SERVICE_PORT',
+                                            15001))
+        pkt = b'PKTV1\x00' + b'\x01' + struct.pack('!i', 1000)
+        pkt += b'+' * 1000
+        s = socket.create_connection((self.server.hostname, port))
+        s.sendall(pkt[:nbytes])
+        self.socks.append(s)
+        return s, pkt[nbytes:]
+
+    def timed(self, func, *args, **kwargs):
+        """
+        Call func and return how long it took
+        """
+        start = time.time()
+        func(*args, **kwargs)
+        return time.time() - start
+
+    def test_partial_requests_do_not_block(self):
+        """
+        Clients holding back the rest of a request, inside the header or
+        inside the data, do not delay the requests of others
+        """
+        rest = []
+        for nbytes in (3, 8, 11, 200, 900):
+            rest.append(self.open_partial(nbytes))
+        j = Job(TEST_USER, {ATTR_h: None})
+        self.assertLess(self.timed(self.server.submit, j), 5)
+        self.assertLess(self.timed(self.server.status, JOB), 5)
+        self.assertLess(self.timed(self.server.status, NODE), 5)
+        self.assertLess(
+            self.timed(self.server.manager, MGR_CMD_SET, SERVER,
+                       {'comment': 'partial'}), 5)
+
+        # the rest of a request, sent in pieces, does not stall others
+        s, data = rest[3]
+        for i in range(0, len(data), 200):
+            s.sendall(data[i:i + 200])
+            self.assertLess(self.timed(self.server.status, SERVER), 5)
+        self.assertTrue(self.server.isUp())
+        self.server.expect(SERVER, {'comment': 'partial'})
+
+    def test_request_stats(self):
+        """
+        SIGUSR2 makes the server log count and latency of each request
+        type it has served
+        """
+        for _ in range(5):
+            self.server.status(JOB)
+        start = time.time()
+        self.server.signal('-USR2')
+        msg = ('request type 19: count=[0-9]+ avg=[0-9]+us max=[0-9]+us '
+               'hist\\(ms\\) <1:')
+        self.server.log_match(msg, regexp=True, starttime=start)
+        self.assertTrue(self.server.isUp())
@@ -0,0 +1,164 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestSchedStreamQuery(TestFunctional):
+    """
+    Tests that the scheduler, which reads the job status reply as a
+    stream, sees every job with its attributes, with and without worker
+    threads
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.ncpus': 4},
+                            id=self.mom.shortname)
+        self.script = self.du.create_temp_file(asuser=TEST_USER,
+                                               body='sleep 300\n')
+
+    def tearDown(self):
+        self.du.unset_pbs_config(self.server.hostname,
+                                 confs=['PBS_SCHED_THREADS'])
+        self.scheduler.restart()
+        TestFunctional.tearDown(self)
+
+    def submit_many(self, num):
+        """
+        Submit num jobs with one job list, every tenth one held, and
+        return their ids
+        """
+        lines = []
+        for i in range(num):
+            line = '%s Job_Name=sq%d' % (self.script, i)
+            if i % 10 == 0:
+                line += ' Hold_Types=u'
+            lines.append(line)
+        fn = self.du.create_temp_file(asuser=TEST_USER,
+                                      body='\n'.join(lines) + '\n')
+        qsub = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin', 'qsub')
+        ret = self.du.run_cmd(self.server.hostname,
+                              cmd=[qsub, '--joblist=%s' % fn],
+                              runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        jids = [j.strip() for j in ret['out']]
+        self.assertEqual(len(jids), num)
+        return jids
+
+    def run_cycle(self, nthreads):
+        """
+        Run the scheduler with nthreads threads over more jobs than fit
+        in a few worker chunks, and check it runs the first jobs that
+        are not held
+        """
+        self.du.set_pbs_config(self.server.hostname,
+                               confs={'PBS_SCHED_THREADS': str(nthreads)})
+        self.scheduler.restart()
+        jids = self.submit_many(2600)
+        start = time.time()
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        for jid in (jids[1], jids[2], jids[3], jids[4]):
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.server.expect(JOB, {'job_state': 'H'}, id=jids[0])
+        self.server.expect(JOB, {'job_state=R': 4}, count=True)
+        # the last job of the reply was seen too
+        self.scheduler.log_match(jids[-1] + ';Considering job to run',
+                                 starttime=start, n='ALL')
+        self.scheduler.log_match('pbs_selstat failed', starttime=start,
+                                 n='ALL', existence=False, max_attempts=1)
+
+    def test_single_thread(self):
+        """
+        One thread converts jobs while the reply is read
+        """
+        self.run_cycle(1)
+
+    def test_worker_threads(self):
+        """
+        Worker threads convert chunks of jobs while the rest of the
+        reply is read
+        """
+        self.run_cycle(4)
+
+    def zero_shares_cycle(self, nthreads):
+        """
+        Run the scheduler with nthreads threads over jobs of an entity
+        with no fairshare shares, so that each job is found unable to
+        run while the reply is read, and check each gets its comment
+        without the cycle waiting on the server
+        """
+        self.scheduler.set_sched_config({'fair_share': 'true ALL',
+                                         'unknown_shares': 0,
+                                         'enforce_no_shares': 'True'})
+        self.du.set_pbs_config(self.server.hostname,
+                               confs={'PBS_SCHED_THREADS': str(nthreads)})
+        self.scheduler.restart()
+        jids = self.submit_many(2600)
+        start = time.time()
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        comment = 'Can Never Run: Job has zero shares for fairshare'
+        for jid in (jids[1], jids[-1]):
+            self.server.expect(JOB, {'comment': comment}, id=jid)
+        self.scheduler.log_match('Leaving Scheduling Cycle',
+                                 starttime=start)
+        self.assertLess(time.time() - start, 60)
+        stat = self.server.status(JOB, 'comment')
+        self.assertEqual(len([j for j in stat
+                              if j.get('comment') == comment]), len(jids))
+        self.server.expect(JOB, {'job_state=R': 0}, count=True)
+        self.scheduler.log_match('pbs_selstat failed', starttime=start,
+                                 n='ALL', existence=False, max_attempts=1)
+
+    def test_updates_after_reply_single_thread(self):
+        """
+        Jobs found unable to run by the only thread are updated after
+        the reply has been read
+        """
+        self.zero_shares_cycle(1)
+
+    def test_updates_after_reply_worker_threads(self):
+        """
+        Jobs found unable to run by worker threads are updated after
+        the reply has been read
+        """
+        self.zero_shares_cycle(4)
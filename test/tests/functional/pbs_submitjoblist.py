@@ -0,0 +1,147 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestSubmitJobList(JobSaveFault, TestFunctional):
+    """
+    Tests for qsub --joblist, which queues many jobs with one Submit Job
+    List request
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.qsub = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                 'bin', 'qsub')
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.script1 = self.du.create_temp_file(prefix='listjob1',
+                                                asuser=TEST_USER,
+                                                body='sleep 1\n')
+        self.script2 = self.du.create_temp_file(prefix='listjob2',
+                                                asuser=TEST_USER,
+                                                body='sleep 2\n')
+
+    def submit_list(self, lines, args=None):
+        """
+        Submit the jobs of a job list file made of lines, as TEST_USER
+        """
+        fn = self.du.create_temp_file(asuser=TEST_USER,
+                                      body='\n'.join(lines) + '\n')
+        cmd = [self.qsub]
+        if args:
+            cmd += args
+        cmd.append('--joblist=%s' % fn)
+        return self.du.run_cmd(self.server.hostname, cmd=cmd,
+                               runas=TEST_USER)
+
+    def test_mixed_list(self):
+        """
+        Jobs of a list are accepted or rejected on their own, the ids are
+        printed in the order of the list and the exit status tells that
+        a job was rejected
+        """
+        lines = ['# comment', self.script1,
+                 '%s Resource_List.nosuchresc=1' % self.script2,
+                 '',
+                 '%s Job_Name=renamed Resource_List.walltime=100'
+                 % self.script1,
+                 self.script2]
+        ret = self.submit_list(lines, ['-h'])
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertEqual(len(ret['out']), 3, ret['out'])
+        self.assertEqual(len(ret['err']), 1, ret['err'])
+        self.assertIn(self.script2, ret['err'][0])
+        self.assertIn('Unknown resource', ret['err'][0])
+
+        jids = [j.strip() for j in ret['out']]
+        name1 = os.path.basename(self.script1)
+        name2 = os.path.basename(self.script2)
+        self.server.expect(JOB, {ATTR_N: name1, 'job_state': 'H'},
+                           id=jids[0])
+        self.server.expect(JOB, {ATTR_N: 'renamed',
+                                 'Resource_List.walltime': '00:01:40'},
+                           id=jids[1])
+        self.server.expect(JOB, {ATTR_N: name2}, id=jids[2])
+        self.server.expect(JOB, {'job_state=H': 3}, count=True)
+
+        # the jobs run their own scripts, also when a script is shared
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        self.server.rlsjob(jids, USER_HOLD, runas=TEST_USER)
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'F'}, id=jid,
+                               extend='x', offset=2, max_attempts=30)
+
+    def test_list_restart(self):
+        """
+        The jobs of a list are recovered after a restart
+        """
+        ret = self.submit_list([self.script1] * 5, ['-h'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        jids = [j.strip() for j in ret['out']]
+        self.server.restart()
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+
+    def test_save_error(self):
+        """
+        If the jobs of a list cannot be committed, every job reports
+        PBSE_SAVE_ERR, none is left queued and the server keeps running
+        """
+        self.fail_job_saves('insert')
+        self.server.start()
+        self.assertTrue(self.server.isUp())
+
+        start = time.time()
+        ret = self.submit_list([self.script1, self.script2, self.script1])
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertEqual(ret['out'], [])
+        self.assertEqual(len(ret['err']), 3, ret['err'])
+        for line in ret['err']:
+            self.assertIn('Failed to save job/resv', line)
+        self.server.log_match('Failed to commit submitted job list, '
+                              'purging its jobs', starttime=start)
+        self.assertTrue(self.server.isUp())
+        self.server.expect(JOB, {'job_state=Q': 0}, count=True)
+
+        self.clear_job_save_fault()
+        ret = self.submit_list([self.script1, self.script2])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertEqual(len(ret['out']), 2)
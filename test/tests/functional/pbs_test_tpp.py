@@ -937,6 +937,38 @@ class TestTPP(TestFunctional):
             for msg in exp_msg:
                 self.comm.log_match(msg, existence=existence, n=30)
 
+    def test_comm_compression(self):
+        """
+        Test the TPP compression settings PBS_COMPRESSION_ALGORITHM,
+        PBS_COMPRESSION_MIN_SIZE and PBS_COMPRESSION_DICTIONARY
+        """
+        self.node_list = [self.server.shortname]
+        a = {'PBS_COMPRESSION_ALGORITHM': 'zlib',
+             'PBS_COMPRESSION_MIN_SIZE': 0,
+             'PBS_COMPRESSION_DICTIONARY': 1}
+        self.set_pbs_conf(host_name=self.server.shortname, conf_param=a)
+        msg = "TPP compression = zlib, min size = 0 bytes, preset dictionary"
+        self.server.log_match(msg)
+        set_attr = {ATTR_l + '.select': '1:ncpus=1', ATTR_k: 'oe'}
+        jid = self.submit_job(set_attr=set_attr)
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid, offset=1)
+        self.server.log_match("%s;Exit_status=0" % jid)
+
+        a = {'PBS_COMPRESSION_ALGORITHM': 'bogus'}
+        self.set_pbs_conf(host_name=self.server.shortname, conf_param=a)
+        msg = "Compression algorithm bogus is not supported, using zlib"
+        self.server.log_match(msg)
+
+    def test_comm_stats_dump(self):
+        """
+        Test that pbs_comm logs its transport statistics on SIGUSR2
+        """
+        set_attr = {ATTR_l + '.select': '1:ncpus=1', ATTR_k: 'oe'}
+        jid = self.submit_job(set_attr=set_attr)
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid, offset=1)
+        self.assertTrue(self.comm.signal('-USR2'))
+        self.comm.log_match("Connection tfd=.* pkts_sent=", regexp=True)
+
     def common_steps_for_mom_pool_tests(self):
         """
         This function submit different jobs as required by test
@@ -1095,7 +1127,9 @@ class TestTPP(TestFunctional):
         os.environ['PBS_CONF_FILE'] = self.pbs_conf_path
         self.logger.info("Successfully exported PBS_CONF_FILE variable")
         conf_param = ['PBS_LEAF_ROUTERS', 'PBS_COMM_ROUTERS',
-                      'PBS_COMM_THREADS', 'PBS_COMM_LOG_EVENTS']
+                      'PBS_COMM_THREADS', 'PBS_COMM_LOG_EVENTS',
+                      'PBS_COMPRESSION_ALGORITHM', 'PBS_COMPRESSION_MIN_SIZE',
+                      'PBS_COMPRESSION_DICTIONARY']
         for host in self.node_list:
             self.unset_pbs_conf(host, conf_param)
         self.node_list.clear()
@@ -0,0 +1,140 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestTracejobLogs(TestFunctional):
+    """
+    Tests for tracejob reading several job ids in one pass, with several
+    threads, from compressed logs and through log indexes
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.tracejob = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                     'bin', 'tracejob')
+        self.jids = []
+        for i in range(3):
+            j = Job(TEST_USER, {ATTR_N: 'trace%d' % i})
+            j.set_sleep_time(1)
+            self.jids.append(self.server.submit(j))
+        for jid in self.jids:
+            self.server.expect(JOB, 'queue', op=UNSET, id=jid, offset=1)
+
+        # yesterday's server log, in a log tree of its own
+        self.logdir = self.du.create_temp_dir()
+        svrlogs = os.path.join(self.logdir, 'server_logs')
+        self.du.mkdir(path=svrlogs, mode=0o755)
+        today = time.strftime('%Y%m%d', time.localtime())
+        yday = time.strftime('%Y%m%d', time.localtime(time.time() - 86400))
+        src = os.path.join(self.server.pbs_conf['PBS_HOME'], 'server_logs',
+                           today)
+        self.log = os.path.join(svrlogs, yday)
+        ret = self.du.run_cmd(cmd=['cp', src, self.log], sudo=True)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.du.chmod(path=self.log, mode=0o644, sudo=True)
+
+    def trace(self, args):
+        """
+        Run tracejob over the server log of the test log tree only
+        """
+        cmd = [self.tracejob, '-p', self.logdir, '-n', '2', '-a', '-l',
+               '-m', '-w', '200'] + args
+        ret = self.du.run_cmd(cmd=cmd, sudo=True)
+        return ret
+
+    def test_many_jobs_one_pass(self):
+        """
+        Tracing several jobs at once gives each job's lines as tracing
+        them one at a time does, whatever the number of threads
+        """
+        single = []
+        for jid in self.jids:
+            ret = self.trace([jid])
+            self.assertEqual(ret['rc'], 0, ret['err'])
+            self.assertIn('Job: %s' % jid, ret['out'])
+            single += ret['out']
+        for threads in ('1', '4'):
+            ret = self.trace(['-t', threads] + self.jids)
+            self.assertEqual(ret['rc'], 0, ret['err'])
+            self.assertEqual(ret['out'], single)
+
+        ret = self.trace([self.jids[0], '999999.nosuchhost'])
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertIn("Couldn't find Job Id 999999.nosuchhost",
+                      '\n'.join(ret['err']))
+
+    def test_compressed_log(self):
+        """
+        A gzip compressed log is read as the plain one was
+        """
+        plain = self.trace(self.jids)
+        self.assertEqual(plain['rc'], 0, plain['err'])
+        ret = self.du.run_cmd(cmd=['gzip', self.log], sudo=True)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertTrue(self.du.isfile(path=self.log + '.gz', sudo=True))
+        gz = self.trace(self.jids)
+        self.assertEqual(gz['rc'], 0, gz['err'])
+        self.assertEqual(gz['out'], plain['out'])
+
+    def test_log_index(self):
+        """
+        tracejob -x indexes yesterday's log, the index gives the same
+        result, and it is ignored once the log changes
+        """
+        plain = self.trace(self.jids)
+        self.assertEqual(plain['rc'], 0, plain['err'])
+        ret = self.trace(['-x'])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertTrue(self.du.isfile(path=self.log + '.idx', sudo=True))
+        indexed = self.trace(self.jids)
+        self.assertEqual(indexed['rc'], 0, indexed['err'])
+        self.assertEqual(indexed['out'], plain['out'])
+
+        # a line added after indexing is still found
+        line = '%s;0100;Server@x;Job;%s;appended after indexing' % (
+            time.strftime('%m/%d/%Y %H:%M:%S'), self.jids[0])
+        ret = self.du.run_cmd(cmd=['echo "%s" >> %s' % (line, self.log)],
+                              sudo=True, as_script=True)
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        ret = self.trace([self.jids[0]])
+        self.assertEqual(ret['rc'], 0, ret['err'])
+        self.assertIn('appended after indexing', '\n'.join(ret['out']))
@@ -0,0 +1,155 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+from tests.functional import *
+
+
+class TestWorkTasks(TestFunctional):
+    """
+    Tests for the timed and event work tasks of the server: timed tasks
+    fire in due order, a rescheduled task fires once at its new time, and
+    deferred replies find their event tasks
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {'resources_available.ncpus': 8},
+                            id=self.mom.shortname)
+
+    def exec_time(self, delta):
+        """
+        Return an execution time delta seconds from now
+        """
+        return BatchUtils().convert_seconds_to_datetime(
+            int(time.time()) + delta)
+
+    def test_timed_tasks_in_due_order(self):
+        """
+        Jobs submitted with execution times in reverse order leave the
+        W state in the order of their times
+        """
+        jids = []
+        for delta in (40, 32, 24, 16, 8):
+            j = Job(TEST_USER, {ATTR_a: self.exec_time(delta)})
+            jids.insert(0, self.server.submit(j))
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'W'}, id=jid)
+        for i, jid in enumerate(jids):
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid,
+                               max_attempts=30, interval=1)
+            for later in jids[i + 1:]:
+                self.server.expect(JOB, {'job_state': 'W'}, id=later,
+                                   max_attempts=1)
+
+    def test_rescheduled_task(self):
+        """
+        Altering the execution time of a waiting job moves its task:
+        the job leaves W at the new time, neither earlier nor later
+        """
+        j = Job(TEST_USER, {ATTR_a: self.exec_time(300)})
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'W'}, id=jid)
+        self.server.alterjob(jid, {ATTR_a: self.exec_time(600)})
+        self.server.alterjob(jid, {ATTR_a: self.exec_time(15)})
+        self.server.expect(JOB, {'job_state': 'W'}, id=jid, offset=5,
+                           max_attempts=1)
+        self.server.expect(JOB, {'job_state': 'Q'}, id=jid,
+                           max_attempts=30, interval=1)
+
+        j = Job(TEST_USER, {ATTR_a: self.exec_time(10)})
+        jid2 = self.server.submit(j)
+        self.server.alterjob(jid2, {ATTR_a: self.exec_time(3600)})
+        self.server.expect(JOB, {'job_state': 'W'}, id=jid2, offset=20,
+                           max_attempts=1)
+
+    def test_reservations_start_in_order(self):
+        """
+        Reservations start at their times whatever the order they were
+        made in
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        now = int(time.time())
+        rids = []
+        for delta in (60, 40, 20):
+            r = Reservation(TEST_USER, {'reserve_start': now + delta,
+                                        'reserve_end': now + delta + 600,
+                                        'Resource_List.ncpus': 1})
+            rid = self.server.submit(r)
+            self.server.expect(RESV, {'reserve_state':
+                                      (MATCH_RE, 'RESV_CONFIRMED|2')},
+                               id=rid)
+            rids.insert(0, rid)
+        for i, rid in enumerate(rids):
+            self.server.expect(RESV, {'reserve_state':
+                                      (MATCH_RE, 'RESV_RUNNING|5')},
+                               id=rid, max_attempts=30, interval=2)
+            for later in rids[i + 1:]:
+                self.server.expect(RESV, {'reserve_state':
+                                          (MATCH_RE, 'RESV_CONFIRMED|2')},
+                                   id=later, max_attempts=1)
+
+    def test_event_tasks(self):
+        """
+        Requests that wait on a reply from the MoM complete for many
+        jobs at once
+        """
+        jids = []
+        for _ in range(8):
+            j = Job(TEST_USER)
+            jids.append(self.server.submit(j))
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'True'})
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        for jid in jids:
+            self.server.sigjob(jid, 'suspend')
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'S'}, id=jid)
+        for jid in jids:
+            self.server.sigjob(jid, 'resume')
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        for jid in jids[:4]:
+            self.server.rerunjob(jid)
+        for jid in jids[:4]:
+            self.server.expect(JOB, {'job_state': 'Q'}, id=jid)
+        self.server.delete(jids, wait=True)